@@ -0,0 +1,191 @@
+//
+//  GHAttributeTable.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief the SVG attributes that are known ahead of time. Each element's attributes are indexed by these once, as the element is created, so that rendering doesn't have to hash and compare attribute names.
+*/
+typedef NS_ENUM(uint8_t, GHAttributeAtom)
+{
+    kGHAttributeUnknown = 0,
+    kGHAttributeID,
+    kGHAttributeXMLID,
+    kGHAttributeClass,
+    kGHAttributeStyle,
+    kGHAttributeTransform,
+    kGHAttributeD,
+    kGHAttributePoints,
+    kGHAttributeX,
+    kGHAttributeY,
+    kGHAttributeWidth,
+    kGHAttributeHeight,
+    kGHAttributeX1,
+    kGHAttributeY1,
+    kGHAttributeX2,
+    kGHAttributeY2,
+    kGHAttributeCX,
+    kGHAttributeCY,
+    kGHAttributeR,
+    kGHAttributeRX,
+    kGHAttributeRY,
+    kGHAttributeFX,
+    kGHAttributeFY,
+    kGHAttributeDX,
+    kGHAttributeDY,
+    kGHAttributeRotate,
+    kGHAttributeOffset,
+    kGHAttributeViewBox,
+    kGHAttributePreserveAspectRatio,
+    kGHAttributeXLinkHRef,
+    kGHAttributeHRef,
+    kGHAttributeXMLBase,
+    kGHAttributeXMLSpace,
+    kGHAttributeDisplay,
+    kGHAttributeVisibility,
+    kGHAttributeOpacity,
+    kGHAttributeColor,
+    kGHAttributeFill,
+    kGHAttributeFillOpacity,
+    kGHAttributeFillRule,
+    kGHAttributeStroke,
+    kGHAttributeStrokeWidth,
+    kGHAttributeStrokeOpacity,
+    kGHAttributeStrokeLineCap,
+    kGHAttributeStrokeLineJoin,
+    kGHAttributeStrokeMiterLimit,
+    kGHAttributeStrokeDashArray,
+    kGHAttributeStrokeDashOffset,
+    kGHAttributeVectorEffect,
+    kGHAttributeMixBlendMode,
+    kGHAttributeClipPath,
+    kGHAttributeClipRule,
+    kGHAttributeMask,
+    kGHAttributeClipPathUnits,
+    kGHAttributeMaskContentUnits,
+    kGHAttributeGradientUnits,
+    kGHAttributeGradientTransform,
+    kGHAttributeSpreadMethod,
+    kGHAttributeStopColor,
+    kGHAttributeStopOpacity,
+    kGHAttributeSolidColor,
+    kGHAttributeSolidOpacity,
+    kGHAttributeViewportFill,
+    kGHAttributeViewportFillOpacity,
+    kGHAttributeFontFamily,
+    kGHAttributeFontSize,
+    kGHAttributeFontWeight,
+    kGHAttributeFontStyle,
+    kGHAttributeTextAnchor,
+    kGHAttributeTextDecoration,
+    kGHAttributeTextAlign,
+    kGHAttributeDisplayAlign,
+    kGHAttributeLineIncrement,
+    kGHAttributeSystemLanguage,
+    kGHAttributeRequiredFeatures,
+    kGHAttributeRequiredExtensions,
+    kGHAttributeRequiredFormats,
+    kGHAttributeType,
+    kGHAttributeUnicodeRange,
+    
+    kGHAttributeAtomCount
+};
+
+/*! @brief find the atom for an attribute name
+* @param attributeName such as 'stroke-width'
+* @return the matching atom or kGHAttributeUnknown
+*/
+GHAttributeAtom GHAttributeAtomForName(NSString* attributeName);
+
+/*! @brief the attribute name an atom stands for
+* @param atom a known atom
+* @return the name such as 'stroke-width', nil for kGHAttributeUnknown
+*/
+NSString* __nullable GHAttributeNameForAtom(GHAttributeAtom atom);
+
+/*! @brief an immutable dictionary of attributes whose known attributes are stored in a compact table indexed by GHAttributeAtom. Anything else goes into a side dictionary.
+* It is a full NSDictionary, so code using attribute names continues to work. The 'style' attribute is split into its declarations once, as the table is made, and those are kept alongside the attributes.
+* A table can point at the attributes its element inherits from its group. Those are shared by all the group's children rather than copied into each, and are found by lookups which miss the element's own attributes.
+*/
+@interface GHAttributeTable : NSDictionary
+/*! @brief convert a dictionary of attributes into an attribute table
+* @param attributes attributes as they come from the parser, or a table already
+* @return attributes itself if it is already a table, otherwise a new table with the same contents
+*/
++(nullable NSDictionary*) attributeTableWithDictionary:(nullable NSDictionary*)attributes;
+
+/*! @brief make a table which falls back to inherited attributes for anything it doesn't set itself. An attribute whose value is 'inherit' counts as not set
+* @param attributes the element's own attributes
+* @param inheritedAttributes what the element's group passes down, shared with the group's other children. nil for nothing
+* @return a table holding only the element's own attributes, and a reference to inheritedAttributes
+*/
++(nullable NSDictionary*) attributeTableWithDictionary:(nullable NSDictionary*)attributes inheritedAttributes:(nullable NSDictionary*)inheritedAttributes;
+@end
+
+@interface NSDictionary (GHAttributeAtoms)
+/*! @brief look up an attribute by atom. An array index for a GHAttributeTable, the attribute's name for any other dictionary
+* @param atom which attribute
+* @return its value if present
+*/
+-(nullable id) objectForAtom:(GHAttributeAtom)atom;
+
+/*! @brief the value given to a property in the 'style' attribute, already split out for a GHAttributeTable, found by splitting the style string for any other dictionary
+* @param atom which property
+* @return the value of the property's last declaration in 'style' if any, it takes precedence over a presentation attribute of the same name
+*/
+-(nullable NSString*) styleValueForAtom:(GHAttributeAtom)atom;
+
+/*! @brief as styleValueForAtom: but by property name, for properties which don't have an atom
+* @param propertyName such as 'stroke-width'
+* @return the value of the property's last declaration in 'style' if any
+*/
+-(nullable NSString*) styleValueForName:(NSString*)propertyName;
+
+/*! @brief the names in the 'class' attribute, split on whitespace once for a GHAttributeTable, each time for any other dictionary
+* @return the class names in document order, nil if there are none
+*/
+-(nullable NSArray<NSString*>*) cssClassNames;
+
+/*! @brief look up an attribute the element sets itself, ignoring what it inherits
+* @param aKey the attribute's name
+* @return the element's own value, for a dictionary which isn't a GHAttributeTable the same as objectForKey:
+*/
+-(nullable id) ownObjectForKey:(id)aKey;
+
+/*! @brief the shared attributes a GHAttributeTable falls back to
+* @return nil for a table without a parent, or any other dictionary
+*/
+-(nullable NSDictionary*) inheritedAttributes;
+@end
+
+NS_ASSUME_NONNULL_END
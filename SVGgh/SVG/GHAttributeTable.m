@@ -0,0 +1,516 @@
+//
+//  GHAttributeTable.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#import "GHAttributeTable.h"
+
+static NSString* const kAtomNames[kGHAttributeAtomCount] =
+{
+    [kGHAttributeUnknown] = nil,
+    [kGHAttributeID] = @"id",
+    [kGHAttributeXMLID] = @"xml:id",
+    [kGHAttributeClass] = @"class",
+    [kGHAttributeStyle] = @"style",
+    [kGHAttributeTransform] = @"transform",
+    [kGHAttributeD] = @"d",
+    [kGHAttributePoints] = @"points",
+    [kGHAttributeX] = @"x",
+    [kGHAttributeY] = @"y",
+    [kGHAttributeWidth] = @"width",
+    [kGHAttributeHeight] = @"height",
+    [kGHAttributeX1] = @"x1",
+    [kGHAttributeY1] = @"y1",
+    [kGHAttributeX2] = @"x2",
+    [kGHAttributeY2] = @"y2",
+    [kGHAttributeCX] = @"cx",
+    [kGHAttributeCY] = @"cy",
+    [kGHAttributeR] = @"r",
+    [kGHAttributeRX] = @"rx",
+    [kGHAttributeRY] = @"ry",
+    [kGHAttributeFX] = @"fx",
+    [kGHAttributeFY] = @"fy",
+    [kGHAttributeDX] = @"dx",
+    [kGHAttributeDY] = @"dy",
+    [kGHAttributeRotate] = @"rotate",
+    [kGHAttributeOffset] = @"offset",
+    [kGHAttributeViewBox] = @"viewBox",
+    [kGHAttributePreserveAspectRatio] = @"preserveAspectRatio",
+    [kGHAttributeXLinkHRef] = @"xlink:href",
+    [kGHAttributeHRef] = @"href",
+    [kGHAttributeXMLBase] = @"xml:base",
+    [kGHAttributeXMLSpace] = @"xml:space",
+    [kGHAttributeDisplay] = @"display",
+    [kGHAttributeVisibility] = @"visibility",
+    [kGHAttributeOpacity] = @"opacity",
+    [kGHAttributeColor] = @"color",
+    [kGHAttributeFill] = @"fill",
+    [kGHAttributeFillOpacity] = @"fill-opacity",
+    [kGHAttributeFillRule] = @"fill-rule",
+    [kGHAttributeStroke] = @"stroke",
+    [kGHAttributeStrokeWidth] = @"stroke-width",
+    [kGHAttributeStrokeOpacity] = @"stroke-opacity",
+    [kGHAttributeStrokeLineCap] = @"stroke-linecap",
+    [kGHAttributeStrokeLineJoin] = @"stroke-linejoin",
+    [kGHAttributeStrokeMiterLimit] = @"stroke-miterlimit",
+    [kGHAttributeStrokeDashArray] = @"stroke-dasharray",
+    [kGHAttributeStrokeDashOffset] = @"stroke-dashoffset",
+    [kGHAttributeVectorEffect] = @"vector-effect",
+    [kGHAttributeMixBlendMode] = @"mix-blend-mode",
+    [kGHAttributeClipPath] = @"clip-path",
+    [kGHAttributeClipRule] = @"clip-rule",
+    [kGHAttributeMask] = @"mask",
+    [kGHAttributeClipPathUnits] = @"clipPathUnits",
+    [kGHAttributeMaskContentUnits] = @"maskContentUnits",
+    [kGHAttributeGradientUnits] = @"gradientUnits",
+    [kGHAttributeGradientTransform] = @"gradientTransform",
+    [kGHAttributeSpreadMethod] = @"spreadMethod",
+    [kGHAttributeStopColor] = @"stop-color",
+    [kGHAttributeStopOpacity] = @"stop-opacity",
+    [kGHAttributeSolidColor] = @"solid-color",
+    [kGHAttributeSolidOpacity] = @"solid-opacity",
+    [kGHAttributeViewportFill] = @"viewport-fill",
+    [kGHAttributeViewportFillOpacity] = @"viewport-fill-opacity",
+    [kGHAttributeFontFamily] = @"font-family",
+    [kGHAttributeFontSize] = @"font-size",
+    [kGHAttributeFontWeight] = @"font-weight",
+    [kGHAttributeFontStyle] = @"font-style",
+    [kGHAttributeTextAnchor] = @"text-anchor",
+    [kGHAttributeTextDecoration] = @"text-decoration",
+    [kGHAttributeTextAlign] = @"text-align",
+    [kGHAttributeDisplayAlign] = @"display-align",
+    [kGHAttributeLineIncrement] = @"line-increment",
+    [kGHAttributeSystemLanguage] = @"systemLanguage",
+    [kGHAttributeRequiredFeatures] = @"requiredFeatures",
+    [kGHAttributeRequiredExtensions] = @"requiredExtensions",
+    [kGHAttributeRequiredFormats] = @"requiredFormats",
+    [kGHAttributeType] = @"type",
+    [kGHAttributeUnicodeRange] = @"unicode-range",
+};
+
+static NSDictionary* AtomsByName(void)
+{
+    static NSDictionary* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        NSMutableDictionary* mutableResult = [[NSMutableDictionary alloc] initWithCapacity:kGHAttributeAtomCount];
+        for(NSUInteger atom = kGHAttributeUnknown+1; atom < kGHAttributeAtomCount; atom++)
+        {
+            [mutableResult setObject:@(atom) forKey:kAtomNames[atom]];
+        }
+        sResult = [mutableResult copy];
+    });
+    return sResult;
+}
+
+GHAttributeAtom GHAttributeAtomForName(NSString* attributeName)
+{
+    NSNumber* atomNumber = [AtomsByName() objectForKey:attributeName];
+    GHAttributeAtom result = (atomNumber == nil) ? kGHAttributeUnknown : (GHAttributeAtom)atomNumber.unsignedIntegerValue;
+    return result;
+}
+
+NSString* GHAttributeNameForAtom(GHAttributeAtom atom)
+{
+    NSString* result = (atom < kGHAttributeAtomCount) ? kAtomNames[atom] : nil;
+    return result;
+}
+
+static void EnumerateStyleDeclarations(NSString* styleString, void (^block)(NSString* propertyName, NSString* value))
+{// 'fill:red; stroke : blue;' name and value trimmed, declarations missing either skipped
+    if(styleString.length)
+    {
+        NSCharacterSet* whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+        for(NSString* aDeclaration in [styleString componentsSeparatedByString:@";"])
+        {
+            NSRange colonRange = [aDeclaration rangeOfString:@":"];
+            if(colonRange.location != NSNotFound)
+            {
+                NSString* propertyName = [[aDeclaration substringToIndex:colonRange.location] stringByTrimmingCharactersInSet:whitespace];
+                NSString* value = [[aDeclaration substringFromIndex:NSMaxRange(colonRange)] stringByTrimmingCharactersInSet:whitespace];
+                if(propertyName.length && value.length)
+                {
+                    block(propertyName, value);
+                }
+            }
+        }
+    }
+}
+
+static NSString* LastStyleValue(NSString* styleString, NSString* propertyName)
+{
+    __block NSString* result = nil;
+    EnumerateStyleDeclarations(styleString, ^(NSString* aName, NSString* value) {
+        if([aName isEqualToString:propertyName])
+        {
+            result = value;
+        }
+    });
+    return result;
+}
+
+static NSArray<NSString*>* ClassNamesFromString(NSString* classString)
+{// 'a  b' -> @[@"a", @"b"], nil if there are none
+    NSArray<NSString*>* result = nil;
+    if([classString isKindOfClass:[NSString class]] && classString.length)
+    {
+        NSMutableArray<NSString*>* mutableResult = nil;
+        for(NSString* aName in [classString componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]])
+        {
+            if(aName.length)
+            {
+                if(mutableResult == nil)
+                {
+                    mutableResult = [[NSMutableArray alloc] initWithCapacity:2];
+                }
+                [mutableResult addObject:aName];
+            }
+        }
+        result = [mutableResult copy];
+    }
+    return result;
+}
+
+@interface GHAttributeTable ()
+{
+    uint8_t         _slots[kGHAttributeAtomCount]; // 0 for absent, otherwise 1 + index into _knownValues
+    __strong id*    _knownValues;
+    NSUInteger      _knownCount;
+    NSDictionary*   _otherAttributes;
+    uint8_t         _styleSlots[kGHAttributeAtomCount]; // as _slots, but into _styleValues, for the declarations in 'style'
+    __strong NSString** _styleValues;
+    NSUInteger      _styleCount;
+    NSDictionary*   _otherStyleValues;
+    NSArray<NSString*>* _classNames; // the 'class' attribute, split once
+    NSDictionary*   _inheritedAttributes; // shared with the other children of the same group
+    NSUInteger      _inheritedOnlyCount; // keys found only in _inheritedAttributes
+}
+@end
+
+@implementation GHAttributeTable
+
++(NSDictionary*) attributeTableWithDictionary:(NSDictionary*)attributes
+{
+    NSDictionary* result = attributes;
+    if(attributes != nil && ![attributes isKindOfClass:[GHAttributeTable class]])
+    {
+        result = [[GHAttributeTable alloc] initWithDictionary:attributes];
+    }
+    return result;
+}
+
++(NSDictionary*) attributeTableWithDictionary:(NSDictionary*)attributes inheritedAttributes:(NSDictionary*)inheritedAttributes
+{
+    if(inheritedAttributes.count == 0)
+    {
+        return [self attributeTableWithDictionary:attributes];
+    }
+    NSMutableDictionary* explicitAttributes = nil;
+    for(id aKey in attributes)
+    {
+        id aValue = [attributes objectForKey:aKey];
+        if([aValue isKindOfClass:[NSString class]] && [aValue isEqualToString:@"inherit"])
+        {// leave it out so the lookup finds the inherited value, or nothing
+            if(explicitAttributes == nil)
+            {
+                explicitAttributes = [attributes mutableCopy];
+            }
+            [explicitAttributes removeObjectForKey:aKey];
+        }
+    }
+    GHAttributeTable* result = [[GHAttributeTable alloc] initWithDictionary:explicitAttributes ?: attributes ?: @{}];
+    result->_inheritedAttributes = [self attributeTableWithDictionary:inheritedAttributes];
+    for(id aKey in result->_inheritedAttributes)
+    {
+        if([result ownObjectForKey:aKey] == nil)
+        {
+            result->_inheritedOnlyCount++;
+        }
+    }
+    return result;
+}
+
+-(instancetype) init
+{
+    return [self initWithObjects:NULL forKeys:NULL count:0];
+}
+
+-(instancetype) initWithObjects:(const id  _Nonnull [])objects forKeys:(const id<NSCopying>  _Nonnull [])keys count:(NSUInteger)count
+{
+    if(nil != (self = [super init]))
+    {
+        NSMutableDictionary* otherAttributes = nil;
+        for(NSUInteger index = 0; index < count; index++)
+        {
+            id aKey = keys[index];
+            id aValue = objects[index];
+            GHAttributeAtom atom = [aKey isKindOfClass:[NSString class]] ? GHAttributeAtomForName(aKey) : kGHAttributeUnknown;
+            if(atom == kGHAttributeUnknown)
+            {
+                if(otherAttributes == nil)
+                {
+                    otherAttributes = [[NSMutableDictionary alloc] init];
+                }
+                [otherAttributes setObject:aValue forKey:aKey];
+            }
+            else if(_slots[atom] != 0)
+            {// repeated key, last one wins as with NSDictionary
+                _knownValues[_slots[atom]-1] = aValue;
+            }
+            else
+            {
+                if(_knownValues == NULL)
+                {
+                    _knownValues = (__strong id*)calloc(count, sizeof(id));
+                }
+                _knownValues[_knownCount] = aValue;
+                _slots[atom] = (uint8_t)(++_knownCount);
+            }
+        }
+        _otherAttributes = [otherAttributes copy];
+        [self splitStyle];
+        _classNames = ClassNamesFromString([self objectForAtom:kGHAttributeClass]);
+    }
+    return self;
+}
+
+-(void) splitStyle
+{// once, so that rendering never has to tokenize the style string again
+    NSString* styleString = [self objectForAtom:kGHAttributeStyle];
+    if(![styleString isKindOfClass:[NSString class]] || styleString.length == 0)
+    {
+        return;
+    }
+    __block NSMutableDictionary* otherStyleValues = nil;
+    EnumerateStyleDeclarations(styleString, ^(NSString* propertyName, NSString* value) {
+        GHAttributeAtom atom = GHAttributeAtomForName(propertyName);
+        if(atom == kGHAttributeUnknown)
+        {
+            if(otherStyleValues == nil)
+            {
+                otherStyleValues = [[NSMutableDictionary alloc] init];
+            }
+            [otherStyleValues setObject:value forKey:propertyName];
+        }
+        else if(self->_styleSlots[atom] != 0)
+        {// last declaration wins, as in CSS
+            self->_styleValues[self->_styleSlots[atom]-1] = value;
+        }
+        else
+        {
+            if(self->_styleValues == NULL)
+            {
+                self->_styleValues = (__strong NSString**)calloc(kGHAttributeAtomCount, sizeof(NSString*));
+            }
+            self->_styleValues[self->_styleCount] = value;
+            self->_styleSlots[atom] = (uint8_t)(++self->_styleCount);
+        }
+    });
+    _otherStyleValues = [otherStyleValues copy];
+}
+
+-(instancetype) initWithCoder:(NSCoder *)aDecoder
+{
+    NSDictionary* decoded = [[NSDictionary alloc] initWithCoder:aDecoder];
+    return [self initWithDictionary:decoded];
+}
+
+-(void) dealloc
+{
+    for(NSUInteger index = 0; index < _knownCount; index++)
+    {
+        _knownValues[index] = nil;
+    }
+    free(_knownValues);
+    for(NSUInteger index = 0; index < _styleCount; index++)
+    {
+        _styleValues[index] = nil;
+    }
+    free(_styleValues);
+}
+
+-(Class) classForCoder
+{
+    return [NSDictionary class];
+}
+
+-(id) copyWithZone:(NSZone *)zone
+{// immutable
+    return self;
+}
+
+-(NSUInteger) count
+{
+    return _knownCount + _otherAttributes.count + _inheritedOnlyCount;
+}
+
+-(id) objectForAtom:(GHAttributeAtom)atom
+{
+    id result = nil;
+    if(atom < kGHAttributeAtomCount && _slots[atom] != 0)
+    {
+        result = _knownValues[_slots[atom]-1];
+    }
+    else if(_inheritedAttributes != nil)
+    {// one step, the group's set is already complete
+        result = [_inheritedAttributes objectForAtom:atom];
+    }
+    return result;
+}
+
+-(NSDictionary*) inheritedAttributes
+{
+    return _inheritedAttributes;
+}
+
+-(NSString*) styleValueForAtom:(GHAttributeAtom)atom
+{
+    NSString* result = nil;
+    if(atom < kGHAttributeAtomCount && _styleSlots[atom] != 0)
+    {
+        result = _styleValues[_styleSlots[atom]-1];
+    }
+    return result;
+}
+
+-(NSString*) styleValueForName:(NSString*)propertyName
+{
+    NSString* result = nil;
+    GHAttributeAtom atom = GHAttributeAtomForName(propertyName);
+    if(atom != kGHAttributeUnknown)
+    {
+        result = [self styleValueForAtom:atom];
+    }
+    else
+    {
+        result = [_otherStyleValues objectForKey:propertyName];
+    }
+    return result;
+}
+
+-(NSArray<NSString*>*) cssClassNames
+{
+    return _classNames;
+}
+
+-(id) ownObjectForKey:(id)aKey
+{
+    id result = nil;
+    GHAttributeAtom atom = [aKey isKindOfClass:[NSString class]] ? GHAttributeAtomForName(aKey) : kGHAttributeUnknown;
+    if(atom != kGHAttributeUnknown)
+    {
+        result = (_slots[atom] != 0) ? _knownValues[_slots[atom]-1] : nil;
+    }
+    else
+    {
+        result = [_otherAttributes objectForKey:aKey];
+    }
+    return result;
+}
+
+-(id) objectForKey:(id)aKey
+{
+    id result = nil;
+    GHAttributeAtom atom = [aKey isKindOfClass:[NSString class]] ? GHAttributeAtomForName(aKey) : kGHAttributeUnknown;
+    if(atom != kGHAttributeUnknown)
+    {
+        result = [self objectForAtom:atom];
+    }
+    else
+    {
+        result = [_otherAttributes objectForKey:aKey] ?: [_inheritedAttributes objectForKey:aKey];
+    }
+    return result;
+}
+
+-(NSEnumerator*) keyEnumerator
+{
+    NSMutableArray* keys = [[NSMutableArray alloc] initWithCapacity:self.count];
+    for(NSUInteger atom = kGHAttributeUnknown+1; atom < kGHAttributeAtomCount; atom++)
+    {
+        if(_slots[atom] != 0)
+        {
+            [keys addObject:kAtomNames[atom]];
+        }
+    }
+    if(_otherAttributes.count)
+    {
+        [keys addObjectsFromArray:_otherAttributes.allKeys];
+    }
+    if(_inheritedOnlyCount)
+    {
+        for(id aKey in _inheritedAttributes)
+        {
+            if([self ownObjectForKey:aKey] == nil)
+            {
+                [keys addObject:aKey];
+            }
+        }
+    }
+    return [keys objectEnumerator];
+}
+
+@end
+
+@implementation NSDictionary (GHAttributeAtoms)
+
+-(id) objectForAtom:(GHAttributeAtom)atom
+{
+    NSString* attributeName = GHAttributeNameForAtom(atom);
+    id result = (attributeName == nil) ? nil : [self objectForKey:attributeName];
+    return result;
+}
+
+-(NSString*) styleValueForAtom:(GHAttributeAtom)atom
+{
+    NSString* propertyName = GHAttributeNameForAtom(atom);
+    NSString* result = (propertyName == nil) ? nil : [self styleValueForName:propertyName];
+    return result;
+}
+
+-(NSString*) styleValueForName:(NSString*)propertyName
+{
+    NSString* styleString = [self objectForKey:@"style"];
+    NSString* result = [styleString isKindOfClass:[NSString class]] ? LastStyleValue(styleString, propertyName) : nil;
+    return result;
+}
+
+-(NSArray<NSString*>*) cssClassNames
+{
+    return ClassNamesFromString([self objectForKey:@"class"]);
+}
+
+-(id) ownObjectForKey:(id)aKey
+{
+    return [self objectForKey:aKey];
+}
+
+-(NSDictionary*) inheritedAttributes
+{
+    return nil;
+}
+
+@end
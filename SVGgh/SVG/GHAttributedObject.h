@@ -44,6 +44,14 @@ NS_ASSUME_NONNULL_BEGIN
 @property (copy, nonatomic, readonly) NSDictionary*  	attributes;
 @property (readonly, nonatomic)  NSString* __nullable entityName;
 
+/*! @brief the declarations a document's style sheet gives this object, matched once by the renderer rather than on every lookup. nil when no style sheet applies
+*/
+@property (atomic, strong, nullable) NSDictionary* cascadedStyle;
+
+/*! @brief the part of cascadedStyle the style sheet marked !important, which beats even the object's 'style' attribute. nil when there is none
+*/
+@property (atomic, strong, nullable) NSDictionary* importantStyle;
+
 -(instancetype) initWithDictionary:(NSDictionary*)theAttributes;
 -(instancetype) initWithAttributes:(NSDictionary*)theAttributes NS_DESIGNATED_INITIALIZER;
 -(instancetype) init NS_UNAVAILABLE;
@@ -64,6 +72,8 @@ extern  NSString*  	const kElementName;
 extern  NSString*  	const kElementText;
 extern  NSString*  	const kElementData;
 extern  NSString*  	const kLengthIntoParentsContents;
+extern  NSString*  	const kResolvedTransformElementName; // NSValue wrapping a CGAffineTransform calculated ahead of time, e.g. from a precompiled .svgb
+extern  NSString*  	const kResolvedPathElementName; // CGPathRef parsed ahead of time, e.g. from a precompiled .svgb
 
 
 NS_ASSUME_NONNULL_END
@@ -27,6 +27,7 @@
 //
 
 #import "GHAttributedObject.h"
+#import "GHAttributeTable.h"
 
 
 
@@ -36,6 +37,8 @@ NSString*	const kElementName		=	@"name";
 NSString*	const kElementText		= @"text";
 NSString*	const kElementData		= @"data";
 NSString*	const kLengthIntoParentsContents = @"parentContentLocation"; // for objects that modify another object's text
+NSString*	const kResolvedTransformElementName = @"resolvedTransform";
+NSString*	const kResolvedPathElementName = @"resolvedPath";
 
 @interface GHAttributedObject()
 @property(nonatomic, assign)NSUInteger calculatedHash;
@@ -47,7 +50,8 @@ NSString*	const kLengthIntoParentsContents = @"parentContentLocation"; // for ob
 {
     if(nil != (self = [super init]))
 	{
-		_attributes = theAttributes;
+		_attributes = [GHAttributeTable attributeTableWithDictionary:theAttributes]; // index the known attributes once, here
+        _calculatedHash = NSNotFound;
 	}
 	return self;
 }
@@ -57,7 +61,6 @@ NSString*	const kLengthIntoParentsContents = @"parentContentLocation"; // for ob
     NSDictionary* theAttributes = [theDefinition objectForKey:kAttributesElementName];
 	if(nil != (self = [self initWithAttributes:theAttributes]))
 	{
-        _calculatedHash = NSNotFound;
 	}
 	return self;
 }
@@ -51,6 +51,19 @@ typedef NS_OPTIONS(NSUInteger, CSSPseudoClassFlags) {
 @property(nonatomic, readonly) NSDictionary<NSString*, GHCSSStyle*>* __nullable subClasses;
 
 
+/*! @brief make a style, as GHCSSStyleSheet does for its simple rules
+* @param cssClass the class or element name the style applies to
+* @param pseudoClassFlags the interaction state the style requires, kPseudoClassNone for always
+* @param attributes the declarations
+* @param subClasses for an element name, the styles of 'name.class' rules keyed by class
+*/
+-(instancetype) initWithCSSClass:(NSString*)cssClass pseudoClassFlags:(CSSPseudoClassFlags)pseudoClassFlags attributes:(nullable NSDictionary<NSString*, NSString*>*)attributes subClasses:(nullable NSDictionary<NSString*, GHCSSStyle*>*)subClasses;
+
+/*! @brief parse a style sheet and keep the rules made of one element name and/or class. For the full set of selectors use GHCSSStyleSheet
+* @param css contents of a <style> element
+* @return styles keyed by class or element name
+* @see GHCSSStyleSheet
+*/
 +(NSDictionary<NSString*, GHCSSStyle*>*) stylesForString:(NSString*)css;
 +( NSString* _Nullable ) attributeNamed:(NSString*)attributeName classes:(nullable NSArray<NSString*>*)listOfClasses entityName:(nullable NSString*)entityName pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags forStyles:(NSDictionary<NSString*, GHCSSStyle*>*) cssStyles;
 
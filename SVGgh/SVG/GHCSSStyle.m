@@ -28,14 +28,25 @@
 //  Created by Glenn Howes on 3/19/16.
 
 #import "GHCSSStyle.h"
+#import "GHCSSStyleSheet.h"
 
 @implementation GHCSSStyle
+
+-(instancetype) initWithCSSClass:(NSString*)cssClass pseudoClassFlags:(CSSPseudoClassFlags)pseudoClassFlags attributes:(NSDictionary<NSString*, NSString*>*)attributes subClasses:(NSDictionary<NSString*, GHCSSStyle*>*)subClasses
+{
+    if(nil != (self = [super init]))
+    {
+        _cssClass = [cssClass copy];
+        _pseudoClassFlags = pseudoClassFlags;
+        _attributes = [attributes copy];
+        _subClasses = [subClasses copy];
+    }
+    return self;
+}
+
 +(NSDictionary<NSString*, GHCSSStyle*>*) stylesForString:(NSString*)css
 {
-    NSDictionary<NSString*, GHCSSStyle*>* result = [NSDictionary  new];
-    
-    
-    
+    NSDictionary<NSString*, GHCSSStyle*>* result = [[[GHCSSStyleSheet alloc] initWithString:css] simpleStyles];
     return result;
 }
 +(NSString*) attributeNamed:(NSString*)attributeName classes:(nullable NSArray<NSString*>*)listOfClasses entityName:(nullable NSString*)entityName pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags forStyles:(NSDictionary<NSString*, GHCSSStyle*>*) cssStyles
@@ -50,7 +61,7 @@
             for(NSString* aClass in listOfClasses)
             {
                 GHCSSStyle* classEntityStyle = [entityStyle.subClasses valueForKey:aClass];
-                if(classEntityStyle != nil && classEntityStyle.pseudoClassFlags & pseudoClassFlags) // should this be & or == ?
+                if(classEntityStyle != nil && (classEntityStyle.pseudoClassFlags & ~pseudoClassFlags) == 0) // every pseudo-class the style asks for must be in effect
                 {
                     result = [classEntityStyle.attributes valueForKey:attributeName];
                 }
@@ -63,7 +74,7 @@
         for(NSString* aClass in listOfClasses)
         {
             GHCSSStyle* classStyle = [cssStyles valueForKey:aClass];
-            if(classStyle && classStyle.pseudoClassFlags & pseudoClassFlags)  // should this be & or == ?
+            if(classStyle && (classStyle.pseudoClassFlags & ~pseudoClassFlags) == 0)
             {
                 result = [classStyle.attributes valueForKey:attributeName];
             }
@@ -72,7 +83,7 @@
     
     if(result == nil)
     {
-        result = [entityStyle valueForKey:attributeName];
+        result = [entityStyle.attributes valueForKey:attributeName];
     }
     
     return result;
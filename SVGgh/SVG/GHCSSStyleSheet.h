@@ -0,0 +1,99 @@
+//
+//  GHCSSStyleSheet.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+#import "GHCSSStyle.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief what a selector can test about one element: its name, id and classes, linked to its parent so that descendant selectors can look up the tree
+*/
+@interface GHCSSElementDescription : NSObject
+@property(nonatomic, readonly) NSString* elementName;
+@property(nonatomic, readonly, nullable) NSString* elementID;
+@property(nonatomic, readonly, nullable) NSArray<NSString*>* classNames;
+@property(nonatomic, readonly, nullable) GHCSSElementDescription* parent;
+
+/*! @brief describe an element
+* @param elementName the element's entity name such as 'rect'
+* @param elementID its 'id' attribute if any
+* @param classNames the names in its 'class' attribute if any
+* @param parent the description of the element containing it, nil for the root
+*/
+-(instancetype) initWithElementName:(NSString*)elementName elementID:(nullable NSString*)elementID classNames:(nullable NSArray<NSString*>*)classNames parent:(nullable GHCSSElementDescription*)parent NS_DESIGNATED_INITIALIZER;
+-(instancetype) init NS_UNAVAILABLE;
+@end
+
+/*! @brief a parsed CSS style sheet, limited to what SVG documents use: type, class, id and universal selectors, descendant and child combinators, and the :active, :focus and :hover pseudo-classes.
+* Rules are filed under the id, class or type of their rightmost selector, so matching an element only looks at rules which could apply to it. Rules using anything else are dropped, as CSS drops rules it doesn't understand.
+*/
+@interface GHCSSStyleSheet : NSObject
+/*! @brief parse the contents of a <style> element
+* @param css the style sheet's text
+*/
+-(instancetype) initWithString:(nullable NSString*)css;
+
+/*! @brief combine several sheets, such as every <style> element in a document, as if their text were concatenated
+* @param styleSheets the sheets in document order
+*/
+-(instancetype) initWithStyleSheets:(NSArray<GHCSSStyleSheet*>*)styleSheets;
+
+@property(nonatomic, readonly) NSUInteger ruleCount;
+
+/*! @brief YES if any rule depends on the :active, :focus or :hover state, so a change of state requires matching again
+*/
+@property(nonatomic, readonly) BOOL usesPseudoClasses;
+
+/*! @brief the cascade for one element: every matching rule's declarations applied in order of importance, specificity and position in the sheet
+* @param element the element with its ancestors
+* @param pseudoClassFlags the document's current interaction state
+* @return property name to value, nil if no rule matches
+*/
+-(nullable NSDictionary<NSString*, NSString*>*) declarationsForElement:(GHCSSElementDescription*)element pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags;
+
+/*! @brief as declarationsForElement:pseudoClass: but also says which of the winning declarations were marked !important, as those beat an element's inline style
+* @param element the element with its ancestors
+* @param pseudoClassFlags the document's current interaction state
+* @param importantDeclarationsPtr optional, receives the !important subset of the result, nil if there is none
+* @return property name to value, nil if no rule matches
+*/
+-(nullable NSDictionary<NSString*, NSString*>*) declarationsForElement:(GHCSSElementDescription*)element pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags
+                                                  importantDeclarations:(NSDictionary<NSString*, NSString*>* __nullable * __nullable)importantDeclarationsPtr;
+
+/*! @brief the rules consisting of a single type and/or class selector, in the form GHCSSStyle has always offered
+* @return styles keyed by class or type name, with 'type.class' rules in the type's subClasses
+*/
+-(NSDictionary<NSString*, GHCSSStyle*>*) simpleStyles;
+@end
+
+NS_ASSUME_NONNULL_END
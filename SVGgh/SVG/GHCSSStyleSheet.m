@@ -0,0 +1,832 @@
+//
+//  GHCSSStyleSheet.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#import "GHCSSStyleSheet.h"
+#include <strings.h>
+
+typedef NS_ENUM(uint8_t, GHCSSCombinator)
+{
+    kGHCSSCombinatorNone = 0, // the leftmost compound selector
+    kGHCSSCombinatorDescendant,
+    kGHCSSCombinatorChild
+};
+
+/*! @brief a run of type, #id, .class and :pseudo-class selectors with nothing between them, such as 'rect.warning:hover'
+*/
+@interface GHCSSCompoundSelector : NSObject
+@property(nonatomic, copy) NSString* elementName; // nil matches any element
+@property(nonatomic, copy) NSString* elementID;
+@property(nonatomic, copy) NSArray<NSString*>* classNames;
+@property(nonatomic, assign) CSSPseudoClassFlags pseudoClassFlags;
+@property(nonatomic, assign) GHCSSCombinator combinator; // how this element must relate to the one matching the compound to its left
+@end
+
+@implementation GHCSSCompoundSelector
+@end
+
+@interface GHCSSRule : NSObject
+@property(nonatomic, copy) NSArray<GHCSSCompoundSelector*>* compounds; // rightmost first, the order they are matched in
+@property(nonatomic, copy) NSDictionary<NSString*, NSString*>* declarations;
+@property(nonatomic, assign) uint32_t specificity; // ids << 16 | (classes + pseudo-classes) << 8 | types
+@property(nonatomic, assign) NSUInteger order;
+@property(nonatomic, assign) BOOL important;
+@end
+
+@implementation GHCSSRule
+-(GHCSSRule*) ruleWithOrder:(NSUInteger)order
+{
+    GHCSSRule* result = [GHCSSRule new];
+    result.compounds = self.compounds;
+    result.declarations = self.declarations;
+    result.specificity = self.specificity;
+    result.important = self.important;
+    result.order = order;
+    return result;
+}
+@end
+
+@implementation GHCSSElementDescription
+
+-(instancetype) initWithElementName:(NSString*)elementName elementID:(NSString*)elementID classNames:(NSArray<NSString*>*)classNames parent:(GHCSSElementDescription*)parent
+{
+    if(nil != (self = [super init]))
+    {
+        _elementName = [elementName copy];
+        _elementID = [elementID copy];
+        _classNames = [classNames copy];
+        _parent = parent;
+    }
+    return self;
+}
+
+-(instancetype) init
+{
+    [self doesNotRecognizeSelector:_cmd];
+    return nil;
+}
+
+@end
+
+#pragma mark parsing
+
+static BOOL IsCSSWhitespace(char aChar)
+{
+    return aChar == ' ' || aChar == '\t' || aChar == '\n' || aChar == '\r' || aChar == '\f';
+}
+
+static BOOL IsCSSNameByte(char aChar)
+{// ASCII letters, digits, '-' and '_', and any byte of a non-ASCII UTF-8 character
+    unsigned char byte = (unsigned char)aChar;
+    return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9')
+            || byte == '-' || byte == '_' || byte >= 0x80;
+}
+
+static size_t SkipCSSWhitespace(const char* text, size_t index, size_t end)
+{
+    while(index < end && IsCSSWhitespace(text[index]))
+    {
+        index++;
+    }
+    return index;
+}
+
+static NSString* NewCSSString(const char* text, size_t start, size_t end)
+{// trimmed, nil if empty or not UTF-8
+    start = SkipCSSWhitespace(text, start, end);
+    while(end > start && IsCSSWhitespace(text[end-1]))
+    {
+        end--;
+    }
+    NSString* result = nil;
+    if(end > start)
+    {
+        result = [[NSString alloc] initWithBytes:text+start length:end-start encoding:NSUTF8StringEncoding];
+    }
+    return result;
+}
+
+static NSData* CSSWithoutComments(NSString* css)
+{
+    NSData* source = [css dataUsingEncoding:NSUTF8StringEncoding];
+    const char* text = source.bytes;
+    size_t length = source.length;
+    NSMutableData* result = [[NSMutableData alloc] initWithCapacity:length];
+    size_t runStart = 0;
+    size_t index = 0;
+    char quote = 0;
+    while(index < length)
+    {
+        char aChar = text[index];
+        if(quote != 0)
+        {
+            if(aChar == '\\' && index+1 < length)
+            {
+                index++;
+            }
+            else if(aChar == quote)
+            {
+                quote = 0;
+            }
+            index++;
+        }
+        else if(aChar == '"' || aChar == '\'')
+        {
+            quote = aChar;
+            index++;
+        }
+        else if(aChar == '/' && index+1 < length && text[index+1] == '*')
+        {
+            [result appendBytes:text+runStart length:index-runStart];
+            [result appendBytes:" " length:1]; // a comment separates tokens like whitespace
+            index += 2;
+            while(index < length && !(text[index] == '*' && index+1 < length && text[index+1] == '/'))
+            {
+                index++;
+            }
+            index = MIN(index+2, length);
+            runStart = index;
+        }
+        else
+        {
+            index++;
+        }
+    }
+    [result appendBytes:text+runStart length:length-runStart];
+    return result;
+}
+
+static size_t SkipCSSBlock(const char* text, size_t index, size_t end, size_t* blockEnd)
+{// index is just past a '{', returns the index just past its matching '}' and where the block's contents end
+    NSUInteger depth = 1;
+    char quote = 0;
+    while(index < end)
+    {
+        char aChar = text[index];
+        if(quote != 0)
+        {
+            if(aChar == '\\')
+            {
+                index++;
+            }
+            else if(aChar == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if(aChar == '"' || aChar == '\'')
+        {
+            quote = aChar;
+        }
+        else if(aChar == '{')
+        {
+            depth++;
+        }
+        else if(aChar == '}' && --depth == 0)
+        {
+            *blockEnd = index;
+            return index+1;
+        }
+        index++;
+    }
+    *blockEnd = end; // unterminated, the sheet ends the block
+    return end;
+}
+
+static size_t SkipCSSAtRule(const char* text, size_t index, size_t end)
+{// @import ...; or @media ... { ... }, neither of which applies to a rendered SVG
+    while(index < end)
+    {
+        char aChar = text[index];
+        if(aChar == ';')
+        {
+            return index+1;
+        }
+        else if(aChar == '{')
+        {
+            size_t blockEnd = 0;
+            return SkipCSSBlock(text, index+1, end, &blockEnd);
+        }
+        index++;
+    }
+    return end;
+}
+
+static NSString* NewCSSName(const char* text, size_t* index, size_t end)
+{
+    size_t start = *index;
+    while(*index < end && IsCSSNameByte(text[*index]))
+    {
+        (*index)++;
+    }
+    NSString* result = (*index > start) ? [[NSString alloc] initWithBytes:text+start length:*index-start encoding:NSUTF8StringEncoding] : nil;
+    return result;
+}
+
+static CSSPseudoClassFlags PseudoClassForName(NSString* name)
+{
+    static NSDictionary<NSString*, NSNumber*>* sFlags = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sFlags = @{@"active":@(kPseudoClassActive), @"focus":@(kPseudoClassFocused), @"hover":@(kPseudoClassHovering)};
+    });
+    NSNumber* result = [sFlags objectForKey:name.lowercaseString];
+    return (CSSPseudoClassFlags)result.unsignedIntegerValue;
+}
+
+static NSArray<GHCSSCompoundSelector*>* NewSelector(const char* text, size_t index, size_t end, uint32_t* specificity)
+{// one complex selector such as 'g.legend > text:hover', nil if it uses anything unsupported
+    NSMutableArray<GHCSSCompoundSelector*>* leftToRight = [[NSMutableArray alloc] initWithCapacity:2];
+    GHCSSCombinator pendingCombinator = kGHCSSCombinatorNone;
+    uint32_t ids = 0, classes = 0, types = 0;
+    index = SkipCSSWhitespace(text, index, end);
+    while(index < end)
+    {
+        GHCSSCompoundSelector* compound = [GHCSSCompoundSelector new];
+        NSMutableArray<NSString*>* classNames = nil;
+        BOOL hasSimpleSelector = NO;
+        if(text[index] == '*')
+        {
+            index++;
+            hasSimpleSelector = YES;
+        }
+        else if(IsCSSNameByte(text[index]) && !(text[index] >= '0' && text[index] <= '9'))
+        {
+            compound.elementName = NewCSSName(text, &index, end);
+            hasSimpleSelector = YES;
+            types++;
+        }
+        while(index < end)
+        {
+            char aChar = text[index];
+            if(aChar != '#' && aChar != '.' && aChar != ':')
+            {
+                break;
+            }
+            index++;
+            NSString* name = NewCSSName(text, &index, end);
+            if(name == nil)
+            {// includes '::' pseudo-elements
+                return nil;
+            }
+            if(aChar == '#')
+            {
+                compound.elementID = name;
+                ids++;
+            }
+            else if(aChar == '.')
+            {
+                if(classNames == nil)
+                {
+                    classNames = [[NSMutableArray alloc] initWithCapacity:1];
+                }
+                [classNames addObject:name];
+                classes++;
+            }
+            else
+            {
+                CSSPseudoClassFlags flag = PseudoClassForName(name);
+                if(flag == kPseudoClassNone)
+                {// :first-child and the like can't be matched here
+                    return nil;
+                }
+                compound.pseudoClassFlags |= flag;
+                classes++;
+            }
+            hasSimpleSelector = YES;
+        }
+        if(!hasSimpleSelector)
+        {// '[', '+', '~' or garbage
+            return nil;
+        }
+        compound.classNames = classNames;
+        compound.combinator = pendingCombinator;
+        [leftToRight addObject:compound];
+        
+        size_t afterCompound = index;
+        index = SkipCSSWhitespace(text, index, end);
+        if(index < end && text[index] == '>')
+        {
+            pendingCombinator = kGHCSSCombinatorChild;
+            index = SkipCSSWhitespace(text, index+1, end);
+            if(index == end)
+            {
+                return nil;
+            }
+        }
+        else if(index > afterCompound)
+        {
+            pendingCombinator = kGHCSSCombinatorDescendant;
+        }
+        else if(index < end)
+        {
+            return nil;
+        }
+    }
+    if(leftToRight.count == 0)
+    {
+        return nil;
+    }
+    
+    NSArray<GHCSSCompoundSelector*>* result = leftToRight.reverseObjectEnumerator.allObjects; // matching runs right to left
+    *specificity = (MIN(ids, 0xFFU) << 16) | (MIN(classes, 0xFFU) << 8) | MIN(types, 0xFFU);
+    return result;
+}
+
+static void ParseCSSDeclarations(const char* text, size_t index, size_t end, NSMutableDictionary* normal, NSMutableDictionary* important)
+{// 'fill: red; stroke: blue !important' semicolons inside quotes or parentheses, as in url(), don't end a declaration
+    while(index < end)
+    {
+        size_t start = index;
+        size_t colon = 0;
+        NSUInteger depth = 0;
+        char quote = 0;
+        while(index < end)
+        {
+            char aChar = text[index];
+            if(quote != 0)
+            {
+                if(aChar == '\\')
+                {
+                    index++;
+                }
+                else if(aChar == quote)
+                {
+                    quote = 0;
+                }
+            }
+            else if(aChar == '"' || aChar == '\'')
+            {
+                quote = aChar;
+            }
+            else if(aChar == '(')
+            {
+                depth++;
+            }
+            else if(aChar == ')' && depth > 0)
+            {
+                depth--;
+            }
+            else if(aChar == ':' && colon == 0)
+            {
+                colon = index;
+            }
+            else if(aChar == ';' && depth == 0)
+            {
+                break;
+            }
+            index++;
+        }
+        size_t declarationEnd = MIN(index, end);
+        index = declarationEnd+1;
+        if(colon == 0)
+        {
+            continue;
+        }
+        
+        size_t valueEnd = declarationEnd;
+        BOOL isImportant = NO;
+        size_t trimmedEnd = valueEnd;
+        while(trimmedEnd > colon && IsCSSWhitespace(text[trimmedEnd-1]))
+        {
+            trimmedEnd--;
+        }
+        const size_t importantLength = sizeof("important")-1;
+        if(trimmedEnd > colon+importantLength && strncasecmp(text+trimmedEnd-importantLength, "important", importantLength) == 0)
+        {
+            size_t bang = trimmedEnd-importantLength;
+            while(bang > colon && IsCSSWhitespace(text[bang-1]))
+            {
+                bang--;
+            }
+            if(bang > colon && text[bang-1] == '!')
+            {
+                isImportant = YES;
+                valueEnd = bang-1;
+            }
+        }
+        
+        NSString* propertyName = NewCSSString(text, start, colon).lowercaseString;
+        NSString* value = NewCSSString(text, colon+1, valueEnd);
+        if(propertyName.length && value.length)
+        {
+            NSMutableDictionary* declarations = isImportant ? important : normal;
+            [declarations setObject:value forKey:propertyName];
+        }
+    }
+}
+
+static NSArray<GHCSSRule*>* NewCSSRules(NSString* css)
+{
+    NSMutableArray<GHCSSRule*>* result = [[NSMutableArray alloc] init];
+    NSData* strippedCSS = CSSWithoutComments(css);
+    const char* text = strippedCSS.bytes;
+    size_t end = strippedCSS.length;
+    size_t index = 0;
+    while(index < end)
+    {
+        index = SkipCSSWhitespace(text, index, end);
+        if(index >= end)
+        {
+            break;
+        }
+        if(text[index] == '@')
+        {
+            index = SkipCSSAtRule(text, index, end);
+            continue;
+        }
+        size_t preludeStart = index;
+        while(index < end && text[index] != '{' && text[index] != '}')
+        {
+            index++;
+        }
+        if(index >= end)
+        {
+            break;
+        }
+        if(text[index] == '}')
+        {// stray
+            index++;
+            continue;
+        }
+        size_t preludeEnd = index;
+        size_t blockEnd = 0;
+        size_t blockStart = index+1;
+        index = SkipCSSBlock(text, blockStart, end, &blockEnd);
+        
+        NSMutableArray<NSArray<GHCSSCompoundSelector*>*>* selectors = [[NSMutableArray alloc] initWithCapacity:1];
+        NSMutableArray<NSNumber*>* specificities = [[NSMutableArray alloc] initWithCapacity:1];
+        BOOL valid = YES;
+        size_t selectorStart = preludeStart;
+        for(size_t preludeIndex = preludeStart; preludeIndex <= preludeEnd && valid; preludeIndex++)
+        {
+            if(preludeIndex == preludeEnd || text[preludeIndex] == ',')
+            {
+                uint32_t specificity = 0;
+                NSArray<GHCSSCompoundSelector*>* aSelector = NewSelector(text, selectorStart, preludeIndex, &specificity);
+                if(aSelector == nil)
+                {// as in CSS, one bad selector drops the whole rule
+                    valid = NO;
+                }
+                else
+                {
+                    [selectors addObject:aSelector];
+                    [specificities addObject:@(specificity)];
+                }
+                selectorStart = preludeIndex+1;
+            }
+        }
+        if(!valid)
+        {
+            continue;
+        }
+        
+        NSMutableDictionary* normal = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary* important = [[NSMutableDictionary alloc] init];
+        ParseCSSDeclarations(text, blockStart, blockEnd, normal, important);
+        for(NSDictionary* declarations in @[normal, important])
+        {
+            if(declarations.count == 0)
+            {
+                continue;
+            }
+            NSDictionary* immutableDeclarations = [declarations copy];
+            [selectors enumerateObjectsUsingBlock:^(NSArray<GHCSSCompoundSelector*>* aSelector, NSUInteger selectorIndex, BOOL *stop) {
+                GHCSSRule* aRule = [GHCSSRule new];
+                aRule.compounds = aSelector;
+                aRule.declarations = immutableDeclarations;
+                aRule.specificity = (uint32_t)specificities[selectorIndex].unsignedIntValue;
+                aRule.important = (declarations == important);
+                aRule.order = result.count;
+                [result addObject:aRule];
+            }];
+        }
+    }
+    return result;
+}
+
+#pragma mark matching
+
+static BOOL CompoundMatchesElement(GHCSSCompoundSelector* compound, GHCSSElementDescription* element, CSSPseudoClassFlags pseudoClassFlags)
+{
+    if((compound.pseudoClassFlags & ~pseudoClassFlags) != 0)
+    {
+        return NO;
+    }
+    if(compound.elementName != nil && ![compound.elementName isEqualToString:element.elementName])
+    {
+        return NO;
+    }
+    if(compound.elementID != nil && ![compound.elementID isEqualToString:element.elementID])
+    {
+        return NO;
+    }
+    for(NSString* aClassName in compound.classNames)
+    {
+        if(![element.classNames containsObject:aClassName])
+        {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+static BOOL AncestorsMatch(NSArray<GHCSSCompoundSelector*>* compounds, NSUInteger matchedIndex, GHCSSElementDescription* element, CSSPseudoClassFlags pseudoClassFlags)
+{// compounds[matchedIndex] matched element, try the rest against its ancestors, backing up if a closer ancestor leads nowhere
+    if(matchedIndex+1 >= compounds.count)
+    {
+        return YES;
+    }
+    GHCSSCombinator combinator = compounds[matchedIndex].combinator;
+    GHCSSCompoundSelector* nextCompound = compounds[matchedIndex+1];
+    for(GHCSSElementDescription* anAncestor = element.parent; anAncestor != nil; anAncestor = anAncestor.parent)
+    {
+        if(CompoundMatchesElement(nextCompound, anAncestor, pseudoClassFlags)
+           && AncestorsMatch(compounds, matchedIndex+1, anAncestor, pseudoClassFlags))
+        {
+            return YES;
+        }
+        if(combinator == kGHCSSCombinatorChild)
+        {
+            break;
+        }
+    }
+    return NO;
+}
+
+static void AddMatchingRules(NSArray<GHCSSRule*>* candidates, GHCSSElementDescription* element, CSSPseudoClassFlags pseudoClassFlags, NSMutableArray<GHCSSRule*>* __strong * matches)
+{
+    for(GHCSSRule* aRule in candidates)
+    {
+        NSArray<GHCSSCompoundSelector*>* compounds = aRule.compounds;
+        if(CompoundMatchesElement(compounds[0], element, pseudoClassFlags)
+           && AncestorsMatch(compounds, 0, element, pseudoClassFlags))
+        {
+            if(*matches == nil)
+            {
+                *matches = [[NSMutableArray alloc] initWithCapacity:4];
+            }
+            [*matches addObject:aRule];
+        }
+    }
+}
+
+@interface GHCSSStyleSheet ()
+@property(nonatomic, readonly) NSArray<GHCSSRule*>* rules;
+@property(nonatomic, readonly) NSDictionary<NSString*, NSArray<GHCSSRule*>*>* rulesByID;
+@property(nonatomic, readonly) NSDictionary<NSString*, NSArray<GHCSSRule*>*>* rulesByClass;
+@property(nonatomic, readonly) NSDictionary<NSString*, NSArray<GHCSSRule*>*>* rulesByType;
+@property(nonatomic, readonly) NSArray<GHCSSRule*>* universalRules;
+@end
+
+@implementation GHCSSStyleSheet
+
+-(instancetype) initWithRules:(NSArray<GHCSSRule*>*)rules
+{
+    if(nil != (self = [super init]))
+    {
+        _rules = [rules copy];
+        NSMutableDictionary<NSString*, NSMutableArray<GHCSSRule*>*>* byID = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSMutableArray<GHCSSRule*>*>* byClass = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSMutableArray<GHCSSRule*>*>* byType = [[NSMutableDictionary alloc] init];
+        NSMutableArray<GHCSSRule*>* universal = [[NSMutableArray alloc] init];
+        for(GHCSSRule* aRule in rules)
+        {// filed by the most selective part of the rightmost compound, which every match has to satisfy
+            GHCSSCompoundSelector* rightmost = aRule.compounds[0];
+            NSMutableDictionary<NSString*, NSMutableArray<GHCSSRule*>*>* buckets = nil;
+            NSString* key = nil;
+            if(rightmost.elementID != nil)
+            {
+                buckets = byID;
+                key = rightmost.elementID;
+            }
+            else if(rightmost.classNames.count)
+            {
+                buckets = byClass;
+                key = rightmost.classNames[0];
+            }
+            else if(rightmost.elementName != nil)
+            {
+                buckets = byType;
+                key = rightmost.elementName;
+            }
+            
+            if(buckets == nil)
+            {
+                [universal addObject:aRule];
+            }
+            else
+            {
+                NSMutableArray<GHCSSRule*>* bucket = [buckets objectForKey:key];
+                if(bucket == nil)
+                {
+                    bucket = [[NSMutableArray alloc] initWithCapacity:1];
+                    [buckets setObject:bucket forKey:key];
+                }
+                [bucket addObject:aRule];
+            }
+            
+            for(GHCSSCompoundSelector* aCompound in aRule.compounds)
+            {
+                if(aCompound.pseudoClassFlags != kPseudoClassNone)
+                {
+                    _usesPseudoClasses = YES;
+                }
+            }
+        }
+        _rulesByID = [byID copy];
+        _rulesByClass = [byClass copy];
+        _rulesByType = [byType copy];
+        _universalRules = [universal copy];
+    }
+    return self;
+}
+
+-(instancetype) init
+{
+    return [self initWithRules:@[]];
+}
+
+-(instancetype) initWithString:(NSString*)css
+{
+    return [self initWithRules:css.length ? NewCSSRules(css) : @[]];
+}
+
+-(instancetype) initWithStyleSheets:(NSArray<GHCSSStyleSheet*>*)styleSheets
+{
+    NSMutableArray<GHCSSRule*>* rules = [[NSMutableArray alloc] init];
+    for(GHCSSStyleSheet* aSheet in styleSheets)
+    {
+        for(GHCSSRule* aRule in aSheet.rules)
+        {// later sheets come later in the cascade
+            [rules addObject:[aRule ruleWithOrder:rules.count]];
+        }
+    }
+    return [self initWithRules:rules];
+}
+
+-(NSUInteger) ruleCount
+{
+    return self.rules.count;
+}
+
+-(NSDictionary<NSString*, NSString*>*) declarationsForElement:(GHCSSElementDescription*)element pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags
+{
+    return [self declarationsForElement:element pseudoClass:pseudoClassFlags importantDeclarations:NULL];
+}
+
+-(NSDictionary<NSString*, NSString*>*) declarationsForElement:(GHCSSElementDescription*)element pseudoClass:(CSSPseudoClassFlags)pseudoClassFlags
+                                        importantDeclarations:(NSDictionary<NSString*, NSString*>* __nullable * __nullable)importantDeclarationsPtr
+{
+    NSMutableArray<GHCSSRule*>* matches = nil;
+    if(element.elementID.length)
+    {
+        AddMatchingRules([self.rulesByID objectForKey:element.elementID], element, pseudoClassFlags, &matches);
+    }
+    for(NSString* aClassName in element.classNames)
+    {
+        AddMatchingRules([self.rulesByClass objectForKey:aClassName], element, pseudoClassFlags, &matches);
+    }
+    AddMatchingRules([self.rulesByType objectForKey:element.elementName], element, pseudoClassFlags, &matches);
+    AddMatchingRules(self.universalRules, element, pseudoClassFlags, &matches);
+    
+    NSDictionary<NSString*, NSString*>* result = nil;
+    NSDictionary<NSString*, NSString*>* importantResult = nil;
+    if(matches.count == 1)
+    {
+        result = matches[0].declarations;
+        importantResult = matches[0].important ? result : nil;
+    }
+    else if(matches.count > 1)
+    {
+        [matches sortUsingComparator:^NSComparisonResult(GHCSSRule* rule1, GHCSSRule* rule2) {
+            if(rule1.important != rule2.important)
+            {
+                return rule1.important ? NSOrderedDescending : NSOrderedAscending;
+            }
+            if(rule1.specificity != rule2.specificity)
+            {
+                return (rule1.specificity < rule2.specificity) ? NSOrderedAscending : NSOrderedDescending;
+            }
+            if(rule1.order != rule2.order)
+            {
+                return (rule1.order < rule2.order) ? NSOrderedAscending : NSOrderedDescending;
+            }
+            return NSOrderedSame;
+        }];
+        NSMutableDictionary<NSString*, NSString*>* mutableResult = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSString*>* mutableImportant = nil;
+        for(GHCSSRule* aRule in matches)
+        {// least important first, so the winners overwrite
+            [mutableResult addEntriesFromDictionary:aRule.declarations];
+            if(aRule.important)
+            {// sorted after every normal rule, so nothing overwrites these in mutableResult
+                if(mutableImportant == nil)
+                {
+                    mutableImportant = [[NSMutableDictionary alloc] initWithCapacity:aRule.declarations.count];
+                }
+                [mutableImportant addEntriesFromDictionary:aRule.declarations];
+            }
+        }
+        result = [mutableResult copy];
+        importantResult = [mutableImportant copy];
+    }
+    if(importantDeclarationsPtr != NULL)
+    {
+        *importantDeclarationsPtr = importantResult;
+    }
+    return result;
+}
+
+-(NSDictionary<NSString*, GHCSSStyle*>*) simpleStyles
+{
+    NSMutableDictionary<NSString*, NSMutableDictionary*>* attributesByName = [[NSMutableDictionary alloc] init];
+    NSMutableDictionary<NSString*, NSMutableDictionary<NSString*, NSMutableDictionary*>*>* subClassAttributes = [[NSMutableDictionary alloc] init];
+    for(GHCSSRule* aRule in self.rules)
+    {
+        GHCSSCompoundSelector* onlyCompound = aRule.compounds[0];
+        if(aRule.compounds.count != 1 || onlyCompound.elementID != nil
+           || onlyCompound.pseudoClassFlags != kPseudoClassNone || onlyCompound.classNames.count > 1)
+        {
+            continue;
+        }
+        NSString* className = onlyCompound.classNames.firstObject;
+        NSString* elementName = onlyCompound.elementName;
+        NSMutableDictionary* attributes = nil;
+        if(elementName != nil && className != nil)
+        {
+            NSMutableDictionary<NSString*, NSMutableDictionary*>* subClasses = [subClassAttributes objectForKey:elementName];
+            if(subClasses == nil)
+            {
+                subClasses = [[NSMutableDictionary alloc] init];
+                [subClassAttributes setObject:subClasses forKey:elementName];
+            }
+            attributes = [subClasses objectForKey:className];
+            if(attributes == nil)
+            {
+                attributes = [[NSMutableDictionary alloc] init];
+                [subClasses setObject:attributes forKey:className];
+            }
+        }
+        else if(elementName != nil || className != nil)
+        {
+            NSString* key = elementName ?: className;
+            attributes = [attributesByName objectForKey:key];
+            if(attributes == nil)
+            {
+                attributes = [[NSMutableDictionary alloc] init];
+                [attributesByName setObject:attributes forKey:key];
+            }
+        }
+        [attributes addEntriesFromDictionary:aRule.declarations];
+    }
+    
+    NSMutableSet<NSString*>* names = [NSMutableSet setWithArray:attributesByName.allKeys];
+    [names addObjectsFromArray:subClassAttributes.allKeys];
+    NSMutableDictionary<NSString*, GHCSSStyle*>* result = [[NSMutableDictionary alloc] initWithCapacity:names.count];
+    for(NSString* aName in names)
+    {
+        NSMutableDictionary<NSString*, GHCSSStyle*>* subClasses = nil;
+        NSDictionary<NSString*, NSMutableDictionary*>* subClassesAttributes = [subClassAttributes objectForKey:aName];
+        for(NSString* aClassName in subClassesAttributes)
+        {
+            if(subClasses == nil)
+            {
+                subClasses = [[NSMutableDictionary alloc] initWithCapacity:subClassesAttributes.count];
+            }
+            [subClasses setObject:[[GHCSSStyle alloc] initWithCSSClass:aClassName pseudoClassFlags:kPseudoClassNone
+                                                            attributes:[subClassesAttributes objectForKey:aClassName] subClasses:nil]
+                           forKey:aClassName];
+        }
+        [result setObject:[[GHCSSStyle alloc] initWithCSSClass:aName pseudoClassFlags:kPseudoClassNone
+                                                    attributes:[attributesByName objectForKey:aName] subClasses:subClasses]
+                   forKey:aName];
+    }
+    return [result copy];
+}
+
+@end
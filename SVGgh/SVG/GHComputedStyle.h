@@ -0,0 +1,148 @@
+//
+//  GHComputedStyle.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+@import CoreGraphics;
+#else
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#endif
+
+#import "SVGContext.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class GHRenderableObject;
+@class GHDisplayList;
+
+/*! @brief how a fill or stroke is to be painted
+*/
+typedef NS_ENUM(uint8_t, GHPaintType)
+{
+    kGHPaintNone = 0,       // not painted
+    kGHPaintColor,          // a UIColor, opacity already applied
+    kGHPaintCurrentColor,   // the SVGContext's currentColor at the time of drawing
+    kGHPaintSolidColor,     // a GHSolidColor, asked for its color at the time of drawing
+    kGHPaintGradient,       // a GHGradient
+    kGHPaintContextColor    // painted with whatever color the context already has, as when a color couldn't be resolved
+};
+
+/*! @brief a resolved fill or stroke
+*/
+typedef struct GHPaint
+{
+    GHPaintType                         type;
+    __unsafe_unretained id __nullable   object; // the UIColor, GHSolidColor or GHGradient, kept alive by the GHComputedStyle
+} GHPaint;
+
+/*! @brief which of the optional properties of GHResolvedStyle were given, the rest leave the context alone
+*/
+typedef NS_OPTIONS(uint16_t, GHResolvedStyleFlags)
+{
+    kGHStyleHasStrokeWidth      = (1 << 0),
+    kGHStyleNonScalingStroke    = (1 << 1),
+    kGHStyleHasMiterLimit       = (1 << 2),
+    kGHStyleHasLineJoin         = (1 << 3),
+    kGHStyleHasLineCap          = (1 << 4),
+    kGHStyleHasDashes           = (1 << 5), // dashCount 0 means a solid line
+    kGHStyleHasBlendMode        = (1 << 6),
+    kGHStyleHasOpacity          = (1 << 7),
+    kGHStyleInheritsOpacity     = (1 << 8),
+    kGHStyleEvenOddFill         = (1 << 9), // fill-rule or, inside a clip path, clip-rule is evenodd
+    kGHStyleEvenOddClip         = (1 << 10) // clip-rule is evenodd
+};
+
+/*! @brief everything a renderable needs to set up its paint state, with no strings left to parse
+*/
+typedef struct GHResolvedStyle
+{
+    GHPaint                 fill;
+    GHPaint                 stroke;
+    GHPaint                 color;          // the 'color' attribute, sets currentColor and the context's colors
+    CGFloat                 fillOpacity;    // 0 to 1
+    CGFloat                 strokeOpacity;  // 0 to 1
+    CGFloat                 opacity;
+    CGFloat                 strokeWidth;
+    CGFloat                 miterLimit;
+    CGLineJoin              lineJoin;
+    CGLineCap               lineCap;
+    CGBlendMode             blendMode;
+    const CGFloat* __nullable dashes;       // always an even count
+    size_t                  dashCount;
+    CGFloat                 dashPhase;
+    GHResolvedStyleFlags    flags;
+    __unsafe_unretained id __nullable clip; // a clip path or mask to add, kept alive by the GHComputedStyle
+} GHResolvedStyle;
+
+/*! @brief the computed style of one renderable object, resolved once from its attributes for a given SVGContext styleGeneration, rather than every time it is drawn
+* @note immutable once made, so it can be shared between threads rendering the same document
+*/
+@interface GHComputedStyle : NSObject
+
+/*! @brief resolve an object's style
+* @param anObject whose style attributes are to be resolved
+* @param fillable NO for objects, like lines, which are only filled if they say so explicitly
+* @param svgContext the context supplying colors, referenced objects and the styleGeneration
+*/
+-(instancetype) initWithRenderableObject:(GHRenderableObject*)anObject fillable:(BOOL)fillable withSVGContext:(id<SVGContext>)svgContext NS_DESIGNATED_INITIALIZER;
+
+-(instancetype) init NS_UNAVAILABLE;
+
+/*! @brief the resolved properties, valid as long as this object is
+*/
+-(const GHResolvedStyle*) resolvedStyle NS_RETURNS_INNER_POINTER;
+
+/*! @property generation the svgContext's styleGeneration when this was resolved
+*/
+@property(nonatomic, readonly) NSUInteger generation;
+
+/*! @brief set up line width, joins, caps, dashes, colors, opacity and blend mode, the equivalent of +[GHRenderableObject setupContext:withAttributes:withSVGContext:]
+* @param quartzContext context to set up
+* @param svgContext supplies currentColor and the inherited opacity, and is told about changes to them
+*/
+-(void) applyToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext;
+
+/*! @brief record what applyToContext:withSVGContext: would do
+* @param displayList the list being compiled
+* @param svgContext supplies currentColor and the inherited opacity, and is told about changes to them just as when drawing
+*/
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext;
+
+/*! @brief the color of a paint as of now
+* @param paint the fill or stroke of resolvedStyle
+* @param opacity applied to colors which weren't known until drawing
+* @param svgContext supplies currentColor
+* @return nil for gradients, none or kGHPaintContextColor
+*/
+-(nullable UIColor*) colorForPaint:(const GHPaint*)paint opacity:(CGFloat)opacity withSVGContext:(id<SVGContext>)svgContext;
+@end
+
+NS_ASSUME_NONNULL_END
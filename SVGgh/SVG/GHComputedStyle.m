@@ -0,0 +1,377 @@
+//
+//  GHComputedStyle.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#import "GHComputedStyle.h"
+#import "SVGAttributedObject.h"
+#import "SVGUtilities.h"
+#import "SVGNumberScanner.h"
+#import "GHGradient.h"
+#import "GHDisplayList.h"
+
+@implementation GHComputedStyle
+{
+    GHResolvedStyle     _resolved;
+    CGFloat*            _dashes;
+    // the objects _resolved points to
+    id                  _fillObject;
+    id                  _strokeObject;
+    id                  _colorObject;
+    id                  _clipObject;
+}
+
+static GHPaint PaintForString(NSString* paintString, CGFloat opacity, id<SVGContext> svgContext, id __strong * retainedObject)
+{// the caller has already decided the paint isn't 'none'
+    GHPaint result = {kGHPaintContextColor, nil};
+    id paintObject = nil;
+    if(IsStringURL(paintString))
+    {
+        id referencedObject = [svgContext objectAtURL:paintString];
+        if([referencedObject isKindOfClass:[GHSolidColor class]])
+        {
+            result.type = kGHPaintSolidColor;
+            paintObject = referencedObject;
+        }
+        else if([referencedObject isKindOfClass:[GHGradient class]])
+        {
+            result.type = kGHPaintGradient;
+            paintObject = referencedObject;
+        }
+    }
+    else if([paintString isEqualToString:@"currentColor"])
+    {
+        result.type = kGHPaintCurrentColor;
+    }
+    else if(paintString.length)
+    {
+        UIColor* color = [svgContext colorForSVGColorString:paintString];
+        if(color != nil)
+        {
+            result.type = kGHPaintColor;
+            paintObject = (opacity < 1.0) ? [color colorWithAlphaComponent:opacity] : color;
+        }
+    }
+    *retainedObject = paintObject;
+    result.object = paintObject;
+    return result;
+}
+
+static CGFloat ClampedOpacity(NSString* opacityString)
+{
+    CGFloat result = 1.0;
+    if(opacityString.length)
+    {
+        result = opacityString.floatValue;
+        if(result < 0.0) result = 0.0;
+        if(result > 1.0) result = 1.0;
+    }
+    return result;
+}
+
+-(instancetype) initWithRenderableObject:(GHRenderableObject*)anObject fillable:(BOOL)fillable withSVGContext:(id<SVGContext>)svgContext
+{
+    if(nil != (self = [super init]))
+    {
+        _generation = svgContext.styleGeneration;
+        _resolved.fillOpacity = ClampedOpacity([anObject valueForStyleAtom:kGHAttributeFillOpacity withSVGContext:svgContext]);
+        _resolved.strokeOpacity = ClampedOpacity([anObject valueForStyleAtom:kGHAttributeStrokeOpacity withSVGContext:svgContext]);
+        
+        NSString* fillString = [anObject valueForStyleAtom:kGHAttributeFill withSVGContext:svgContext];
+        BOOL fillIt = _resolved.fillOpacity > 0.0 && ![fillString isEqualToString:@"none"] && (fillable || fillString.length > 0);
+        if(fillIt)
+        {
+            _resolved.fill = PaintForString(fillString.length ? fillString : kBlackInHex, _resolved.fillOpacity, svgContext, &_fillObject);
+        }
+        NSString* strokeString = [anObject valueForStyleAtom:kGHAttributeStroke withSVGContext:svgContext];
+        if(_resolved.strokeOpacity > 0.0 && strokeString != nil && ![strokeString isEqualToString:@"none"])
+        {
+            _resolved.stroke = PaintForString(strokeString, _resolved.strokeOpacity, svgContext, &_strokeObject);
+        }
+        NSString* colorString = [anObject.attributes objectForAtom:kGHAttributeColor];
+        if([colorString isKindOfClass:[NSString class]] && colorString.length)
+        {
+            _resolved.color = PaintForString(colorString, 1.0, svgContext, &_colorObject);
+            if(_resolved.color.type == kGHPaintContextColor || _resolved.color.type == kGHPaintGradient)
+            {// nothing to set
+                _resolved.color.type = kGHPaintNone;
+            }
+        }
+        
+        GHResolvedStyleFlags flags = 0;
+        NSString* strokeWidthString = [anObject valueForStyleAtom:kGHAttributeStrokeWidth withSVGContext:svgContext];
+        if(strokeWidthString != nil)
+        {
+            flags |= kGHStyleHasStrokeWidth;
+            _resolved.strokeWidth = strokeWidthString.floatValue;
+            if([[anObject valueForStyleAtom:kGHAttributeVectorEffect withSVGContext:svgContext] isEqualToString:@"non-scaling-stroke"])
+            {
+                flags |= kGHStyleNonScalingStroke;
+            }
+        }
+        NSString* miterLimitString = [anObject valueForStyleAtom:kGHAttributeStrokeMiterLimit withSVGContext:svgContext];
+        if(miterLimitString != nil)
+        {
+            flags |= kGHStyleHasMiterLimit;
+            _resolved.miterLimit = miterLimitString.floatValue;
+        }
+        NSString* lineJoinString = [anObject valueForStyleAtom:kGHAttributeStrokeLineJoin withSVGContext:svgContext];
+        if(lineJoinString.length)
+        {
+            flags |= kGHStyleHasLineJoin;
+            _resolved.lineJoin = [lineJoinString isEqualToString:@"round"] ? kCGLineJoinRound
+                                    : ([lineJoinString isEqualToString:@"bevel"] ? kCGLineJoinBevel : kCGLineJoinMiter);
+        }
+        NSString* lineCapString = [anObject valueForStyleAtom:kGHAttributeStrokeLineCap withSVGContext:svgContext];
+        if(lineCapString != nil)
+        {
+            flags |= kGHStyleHasLineCap;
+            _resolved.lineCap = [lineCapString isEqualToString:@"round"] ? kCGLineCapRound
+                                    : ([lineCapString isEqualToString:@"square"] ? kCGLineCapSquare : kCGLineCapButt);
+        }
+        NSString* dashString = [[anObject valueForStyleAtom:kGHAttributeStrokeDashArray withSVGContext:svgContext]
+                                stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        if(dashString != nil)
+        {
+            flags |= kGHStyleHasDashes;
+            if(![dashString isEqualToString:@"none"] && ![dashString isEqualToString:@"0"])
+            {
+                [self parseDashes:dashString];
+                _resolved.dashPhase = [[anObject valueForStyleAtom:kGHAttributeStrokeDashOffset withSVGContext:svgContext] floatValue];
+            }
+        }
+        NSString* opacityString = [anObject valueForStyleAtom:kGHAttributeOpacity withSVGContext:svgContext];
+        if(opacityString.length && ![opacityString isEqualToString:@"none"])
+        {
+            if([opacityString isEqualToString:@"inherit"])
+            {
+                flags |= kGHStyleInheritsOpacity;
+            }
+            else
+            {
+                flags |= kGHStyleHasOpacity;
+                _resolved.opacity = opacityString.floatValue;
+            }
+        }
+        NSString* blendString = [anObject valueForStyleAtom:kGHAttributeMixBlendMode withSVGContext:svgContext];
+        NSNumber* blendModeNumber = (blendString == nil) ? nil : stringToBlendMode()[blendString];
+        if(blendModeNumber != nil)
+        {
+            flags |= kGHStyleHasBlendMode;
+            _resolved.blendMode = (CGBlendMode)blendModeNumber.intValue;
+        }
+        BOOL evenOddClip = [[anObject valueForStyleAtom:kGHAttributeClipRule withSVGContext:svgContext] isEqualToString:@"evenodd"];
+        if(evenOddClip)
+        {
+            flags |= kGHStyleEvenOddClip|kGHStyleEvenOddFill;
+        }
+        else if([[anObject valueForStyleAtom:kGHAttributeFillRule withSVGContext:svgContext] isEqualToString:@"evenodd"])
+        {
+            flags |= kGHStyleEvenOddFill;
+        }
+        _resolved.flags = flags;
+        
+        _clipObject = [GHClipGroup clipObjectForAttributes:anObject.attributes withSVGContext:svgContext];
+        _resolved.clip = _clipObject;
+    }
+    return self;
+}
+
+-(void) parseDashes:(NSString*)dashString
+{// an odd number of dashes is repeated to make it even
+    const char* cursor = dashString.UTF8String;
+    const char* end = cursor+strlen(cursor);
+    size_t capacity = 8;
+    size_t count = 0;
+    _dashes = malloc(capacity*sizeof(CGFloat));
+    double value = 0.0;
+    for(cursor = SVGSkipNumberSeparators(cursor, end); (cursor = SVGScanNumber(cursor, end, &value)) != NULL; cursor = SVGSkipNumberSeparators(cursor, end))
+    {
+        if(count+1 > capacity/2)
+        {
+            capacity *= 2;
+            _dashes = realloc(_dashes, capacity*sizeof(CGFloat));
+        }
+        _dashes[count++] = (CGFloat)value;
+    }
+    if(count & 1)
+    {
+        memcpy(_dashes+count, _dashes, count*sizeof(CGFloat));
+        count *= 2;
+    }
+    _resolved.dashes = _dashes;
+    _resolved.dashCount = count;
+}
+
+-(void) dealloc
+{
+    free(_dashes);
+}
+
+-(const GHResolvedStyle*) resolvedStyle
+{
+    return &_resolved;
+}
+
+-(UIColor*) colorForPaint:(const GHPaint*)paint opacity:(CGFloat)opacity withSVGContext:(id<SVGContext>)svgContext
+{
+    UIColor* result = nil;
+    switch(paint->type)
+    {
+        case kGHPaintColor:
+            return paint->object;
+        case kGHPaintCurrentColor:
+            result = svgContext.currentColor;
+        break;
+        case kGHPaintSolidColor:
+            result = [(GHSolidColor*)paint->object asColorWithSVGContext:svgContext];
+        break;
+        default:
+        break;
+    }
+    if(result != nil && opacity < 1.0)
+    {
+        result = [result colorWithAlphaComponent:opacity];
+    }
+    return result;
+}
+
+-(void) applyToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
+{
+    GHResolvedStyleFlags flags = _resolved.flags;
+    if(flags & kGHStyleHasStrokeWidth)
+    {
+        CGFloat strokeWidth = _resolved.strokeWidth;
+        if(flags & kGHStyleNonScalingStroke)
+        {
+            CGSize convertedSize = CGContextConvertSizeToUserSpace(quartzContext, CGSizeMake(strokeWidth, strokeWidth));
+            strokeWidth = (fabs(convertedSize.width)+fabs(convertedSize.height))/2.0;
+            strokeWidth *= svgContext.explicitLineScaling;
+        }
+        CGContextSetLineWidth(quartzContext, strokeWidth);
+    }
+    if(flags & kGHStyleHasMiterLimit)
+    {
+        CGContextSetMiterLimit(quartzContext, _resolved.miterLimit);
+    }
+    if(flags & kGHStyleHasLineJoin)
+    {
+        CGContextSetLineJoin(quartzContext, _resolved.lineJoin);
+    }
+    if(flags & kGHStyleHasLineCap)
+    {
+        CGContextSetLineCap(quartzContext, _resolved.lineCap);
+    }
+    if(flags & kGHStyleHasDashes)
+    {
+        CGContextSetLineDash(quartzContext, _resolved.dashPhase, _resolved.dashes, _resolved.dashCount);
+    }
+    if(_resolved.color.type != kGHPaintNone)
+    {
+        UIColor* color = [self colorForPaint:&_resolved.color opacity:1.0 withSVGContext:svgContext];
+        if(color != nil)
+        {
+            if(_resolved.color.type == kGHPaintColor)
+            {
+                [svgContext setCurrentColor:color];
+            }
+            CGContextSetFillColorWithColor(quartzContext, color.CGColor);
+            CGContextSetStrokeColorWithColor(quartzContext, color.CGColor);
+        }
+    }
+    if(flags & (kGHStyleHasOpacity|kGHStyleInheritsOpacity))
+    {
+        CGFloat opacity = (flags & kGHStyleInheritsOpacity) ? svgContext.opacity : _resolved.opacity;
+        if(opacity >= 0 && opacity < 1.0)
+        {
+            CGContextSetAlpha(quartzContext, opacity);
+            svgContext.opacity = opacity;
+        }
+    }
+    if(flags & kGHStyleHasBlendMode)
+    {
+        CGContextSetBlendMode(quartzContext, _resolved.blendMode);
+    }
+}
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{
+    GHResolvedStyleFlags flags = _resolved.flags;
+    if(flags & kGHStyleHasStrokeWidth)
+    {
+        if(flags & kGHStyleNonScalingStroke)
+        {
+            [displayList setNonScalingLineWidth:_resolved.strokeWidth];
+        }
+        else
+        {
+            [displayList setLineWidth:_resolved.strokeWidth];
+        }
+    }
+    if(flags & kGHStyleHasMiterLimit)
+    {
+        [displayList setMiterLimit:_resolved.miterLimit];
+    }
+    if(flags & kGHStyleHasLineJoin)
+    {
+        [displayList setLineJoin:_resolved.lineJoin];
+    }
+    if(flags & kGHStyleHasLineCap)
+    {
+        [displayList setLineCap:_resolved.lineCap];
+    }
+    if(flags & kGHStyleHasDashes)
+    {
+        [displayList setLineDashPhase:_resolved.dashPhase lengths:_resolved.dashes count:_resolved.dashCount];
+    }
+    if(_resolved.color.type != kGHPaintNone)
+    {
+        UIColor* color = [self colorForPaint:&_resolved.color opacity:1.0 withSVGContext:svgContext];
+        if(color != nil)
+        {
+            if(_resolved.color.type == kGHPaintColor)
+            {
+                [svgContext setCurrentColor:color];
+            }
+            [displayList setFillColor:color.CGColor];
+            [displayList setStrokeColor:color.CGColor];
+        }
+    }
+    if(flags & (kGHStyleHasOpacity|kGHStyleInheritsOpacity))
+    {
+        CGFloat opacity = (flags & kGHStyleInheritsOpacity) ? svgContext.opacity : _resolved.opacity;
+        if(opacity >= 0 && opacity < 1.0)
+        {
+            [displayList setAlpha:opacity];
+            svgContext.opacity = opacity;
+        }
+    }
+    if(flags & kGHStyleHasBlendMode)
+    {
+        [displayList setBlendMode:_resolved.blendMode];
+    }
+}
+
+@end
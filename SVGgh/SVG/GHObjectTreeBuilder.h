@@ -0,0 +1,99 @@
+//
+//  GHObjectTreeBuilder.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class GHShapeGroup;
+
+/*! @brief builds the tree of SVGAttributedObjects directly from XML parsing events, without first creating the intermediate dictionary form of the whole document.
+* Groups are instantiated with their finished children, unsupported elements (metadata, title, etc.) are skipped, and only elements which need their contents (text, gradients, style) keep a dictionary definition.
+*/
+@interface GHObjectTreeBuilder : NSObject
+/*! @property rootObject the group made from the root 'svg' element, nil until that element has ended
+*/
+@property(nonatomic, readonly) GHShapeGroup* __nullable rootObject;
+/*! @property rootDefinition the name and attributes of the root 'svg' element without its contents
+*/
+@property(nonatomic, readonly) NSDictionary* __nullable rootDefinition;
+
+/*! @brief called as each XML element starts
+* @param elementName the element's name, such as 'path'
+* @param attributes the element's attributes as provided by the XML parser
+*/
+-(void) startElementNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes;
+
+/*! @brief called as each element starts when some of its values were calculated ahead of time
+* @param elementName the element's name, such as 'path'
+* @param attributes the element's attributes
+* @param resolvedValues optional kResolvedTransformElementName and kResolvedPathElementName entries, which spare the objects from parsing them
+*/
+-(void) startElementNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes resolvedValues:(nullable NSDictionary*)resolvedValues;
+
+/*! @brief called as each XML element ends
+*/
+-(void) endElement;
+
+/*! @brief called with text found inside the current element
+*/
+-(void) foundCharacters:(NSString*)string;
+
+/*! @brief called with a CDATA block found inside the current element
+*/
+-(void) foundCDATA:(NSData*)CDATABlock;
+
+/*! @brief tokenize a UTF-8 document in place and feed it to this builder, without going through NSXMLParser.
+* Element and attribute names are interned for the length of the parse, and elements which will be skipped never have their attributes converted to NSStrings.
+* @param bytes the UTF-8 encoded document, which must remain valid during the call (a memory mapped NSData is fine)
+* @param length number of bytes in the document
+* @param error set to an NSXMLParserErrorDomain error if the document is malformed
+* @return YES if the document was read to its end and the root element was closed
+*/
+-(BOOL) buildFromUTF8Bytes:(const char*)bytes length:(size_t)length error:(NSError* __autoreleasing __nullable * __nullable)error;
+
+/*! @brief create the intermediate dictionary form of an element and append it to its parent's contents
+* @param elementName name of the element
+* @param attributes attributes of the element
+* @param parentDefinition the definition of the containing element, if any
+* @return a mutable definition which will receive the element's contents
+*/
++(NSMutableDictionary*) newDefinitionNamed:(NSString*)elementName withAttributes:(nullable NSDictionary*)attributes
+                        inParentDefinition:(nullable NSMutableDictionary*)parentDefinition;
+
+/*! @brief append text to the intermediate dictionary form of an element
+* @param string text found by the XML parser
+* @param definition the definition of the element the text was found in
+*/
++(void) appendCharacters:(NSString*)string toDefinition:(NSMutableDictionary*)definition;
+@end
+
+NS_ASSUME_NONNULL_END
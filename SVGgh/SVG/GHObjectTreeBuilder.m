@@ -0,0 +1,507 @@
+//
+//  GHObjectTreeBuilder.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+#import "GHObjectTreeBuilder.h"
+#import "SVGAttributedObject.h"
+#import "GHXMLTokenizer.h"
+
+/*! @brief an entry in the table of names seen during one parse, bytes point into the document being parsed
+*/
+typedef struct GHInternedName
+{
+    const char* bytes;
+    size_t length;
+    uint32_t hash;
+    __unsafe_unretained NSString* string;
+} GHInternedName;
+
+typedef struct GHNameTable
+{
+    GHInternedName* entries;
+    size_t capacity; // always a power of 2
+    size_t count;
+} GHNameTable;
+
+static uint32_t HashOfBytes(const char* bytes, size_t length)
+{// FNV-1a
+    uint32_t result = 2166136261u;
+    for(size_t index = 0; index < length; index++)
+    {
+        result ^= (uint8_t)bytes[index];
+        result *= 16777619u;
+    }
+    return result;
+}
+
+static void InsertIntoNameTable(GHNameTable* table, GHInternedName entry)
+{
+    size_t mask = table->capacity - 1;
+    size_t slot = entry.hash & mask;
+    while(table->entries[slot].bytes != NULL)
+    {
+        slot = (slot + 1) & mask;
+    }
+    table->entries[slot] = entry;
+    table->count++;
+}
+
+static size_t DecodeSpan(const GHXMLTokenizer* tokenizer, GHXMLSpan span, int isAttributeValue, char** decodeBuffer, size_t* decodeCapacity)
+{// the document's own entities can lengthen a span, in which case the buffer grows and it's decoded again
+    size_t result = GHXMLTokenizerDecodeSpan(tokenizer, span, isAttributeValue, *decodeBuffer, *decodeCapacity);
+    if(result > *decodeCapacity)
+    {
+        *decodeCapacity = result;
+        *decodeBuffer = (char*)realloc(*decodeBuffer, result);
+        result = GHXMLTokenizerDecodeSpan(tokenizer, span, isAttributeValue, *decodeBuffer, *decodeCapacity);
+    }
+    return result;
+}
+
+static NSString* InternedName(GHNameTable* table, GHXMLSpan span, NSMutableArray* keepAlive)
+{
+    uint32_t hash = HashOfBytes(span.start, span.length);
+    size_t mask = table->capacity - 1;
+    size_t slot = hash & mask;
+    GHInternedName* anEntry = &table->entries[slot];
+    while(anEntry->bytes != NULL)
+    {
+        if(anEntry->hash == hash && anEntry->length == span.length && memcmp(anEntry->bytes, span.start, span.length) == 0)
+        {
+            return anEntry->string;
+        }
+        slot = (slot + 1) & mask;
+        anEntry = &table->entries[slot];
+    }
+    
+    NSString* result = [[NSString alloc] initWithBytes:span.start length:span.length encoding:NSUTF8StringEncoding];
+    if(result == nil)
+    {
+        return nil;
+    }
+    [keepAlive addObject:result];
+    
+    if((table->count + 1) * 2 > table->capacity)
+    {// keep the load factor at or below a half
+        GHNameTable oldTable = *table;
+        table->capacity = oldTable.capacity * 2;
+        table->count = 0;
+        table->entries = (GHInternedName*)calloc(table->capacity, sizeof(GHInternedName));
+        for(size_t index = 0; index < oldTable.capacity; index++)
+        {
+            if(oldTable.entries[index].bytes != NULL)
+            {
+                InsertIntoNameTable(table, oldTable.entries[index]);
+            }
+        }
+        free(oldTable.entries);
+    }
+    GHInternedName newEntry = {span.start, span.length, hash, result};
+    InsertIntoNameTable(table, newEntry);
+    return result;
+}
+
+/*! @brief a group whose children are still being parsed
+*/
+@interface GHGroupUnderConstruction : NSObject
+@property(nonatomic, strong) Class groupClass;
+@property(nonatomic, strong) NSDictionary* __nullable attributes;
+@property(nonatomic, strong) NSDictionary* __nullable inheritedAttributes; // shared by all the children
+@property(nonatomic, strong) NSDictionary* __nullable inheritedFontAttributes;
+@property(nonatomic, strong) NSMutableArray* children;
+@property(nonatomic, strong) NSValue* __nullable resolvedTransform;
+
+-(instancetype) initWithClass:(Class)groupClass attributes:(nullable NSDictionary*)attributes;
+-(GHShapeGroup*) newGroup;
+@end
+
+@implementation GHGroupUnderConstruction
+
+-(instancetype) initWithClass:(Class)groupClass attributes:(NSDictionary*)attributes
+{
+    if(nil != (self = [super init]))
+    {
+        _groupClass = groupClass;
+        _attributes = attributes;
+        NSDictionary* inheritedFontAttributes = nil;
+        _inheritedAttributes = [GHShapeGroup inheritedAttributesOfGroupWithAttributes:attributes fontAttributes:&inheritedFontAttributes];
+        _inheritedFontAttributes = inheritedFontAttributes;
+        _children = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+-(GHShapeGroup*) newGroup
+{
+    GHShapeGroup* result = [(GHShapeGroup*)[self.groupClass alloc] initWithAttributes:self.attributes children:self.children
+                                                                                 resolvedTransform:self.resolvedTransform];
+    return result;
+}
+@end
+
+@interface GHObjectTreeBuilder ()
+@property(nonatomic, strong) NSMutableArray*   stack; // GHGroupUnderConstruction, NSMutableDictionary or NSNull for skipped elements
+@property(nonatomic, strong) GHShapeGroup* __nullable rootObject;
+@property(nonatomic, copy) NSDictionary* __nullable rootDefinition;
+@end
+
+@implementation GHObjectTreeBuilder
+
+-(instancetype) init
+{
+    if(nil != (self = [super init]))
+    {
+        _stack = [[NSMutableArray alloc] initWithCapacity:32];
+    }
+    return self;
+}
+
++(NSMutableDictionary*) newDefinitionNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes
+                        inParentDefinition:(NSMutableDictionary*)parentDefinition
+{
+    NSString* parentsText = [parentDefinition objectForKey:kElementText];
+    NSNumber*   indexIntoParentNumber = nil;
+    if([parentsText length])
+    {
+        indexIntoParentNumber = [[NSNumber alloc] initWithUnsignedInteger:[parentsText length]];
+    }
+    
+    NSMutableDictionary* result = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+                                    elementName, kElementName,
+                                    attributes, kAttributesElementName,
+                                    indexIntoParentNumber, kLengthIntoParentsContents, //note use of probably nil indexIntoParentNumber
+                                    nil];
+    if(parentDefinition != nil)
+    {
+        NSMutableArray*	parentsContent = [parentDefinition objectForKey:kContentsElementName];
+        if(parentsContent == nil)
+        {
+            parentsContent = [[NSMutableArray alloc] initWithObjects:result, nil];
+            [parentDefinition setObject:parentsContent forKey:kContentsElementName];
+        }
+        else
+        {
+            [parentsContent addObject:result];
+        }
+    }
+    return result;
+}
+
++(void) appendCharacters:(NSString*)string toDefinition:(NSMutableDictionary*)definition
+{
+    NSString*	currentObjectString = [definition objectForKey:kElementText];
+    if(currentObjectString != nil)
+    {
+        currentObjectString = [currentObjectString stringByAppendingString:string];
+    }
+    else
+    {
+        currentObjectString = string;
+    }
+    [definition setObject:currentObjectString forKey:kElementText];
+    
+    NSMutableArray*	currentObjectContent = [definition objectForKey:kContentsElementName];
+    if(currentObjectContent == nil)
+    {
+        currentObjectContent = [[NSMutableArray alloc] initWithObjects:string, nil];
+        [definition setObject:currentObjectContent forKey:kContentsElementName];
+    }
+    else
+    {
+        id lastObject = [currentObjectContent lastObject];
+        if([lastObject isKindOfClass:[NSString class]])
+        {
+            NSString*	newLastObject = [lastObject stringByAppendingString:string];
+            [currentObjectContent removeLastObject];
+            [currentObjectContent addObject:newLastObject];
+        }
+        else
+        {
+            [currentObjectContent addObject:string];
+        }
+    }
+}
+
+-(void) startElementNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes
+{
+    [self startElementNamed:elementName withAttributes:attributes resolvedValues:nil];
+}
+
+-(void) startElementNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes resolvedValues:(NSDictionary*)resolvedValues
+{
+    id currentFrame = [self.stack lastObject];
+    if(currentFrame == nil)
+    {
+        if(self.rootDefinition == nil && [elementName isEqualToString:@"svg"])
+        {
+            self.rootDefinition = @{kElementName:elementName, kAttributesElementName:attributes};
+            GHGroupUnderConstruction* rootFrame = [[GHGroupUnderConstruction alloc] initWithClass:[GHShapeGroup class] attributes:attributes];
+            [self.stack addObject:rootFrame];
+        }
+    }
+    else if([currentFrame isKindOfClass:[GHGroupUnderConstruction class]])
+    {
+        GHGroupUnderConstruction* parentGroup = (GHGroupUnderConstruction*)currentFrame;
+        Class theClass = [[GHShapeGroup nameToClassMap] valueForKey:elementName];
+        if(theClass == nil && ![elementName isEqualToString:@"image"])
+        {// nothing will be made of this element or anything inside it
+            [self.stack addObject:[NSNull null]];
+        }
+        else
+        {
+            NSDictionary* childsAttributes = [GHShapeGroup attributesForChildNamed:elementName withAttributes:attributes
+                                                               inheritedAttributes:parentGroup.inheritedAttributes
+                                                           inheritedFontAttributes:parentGroup.inheritedFontAttributes];
+            if([theClass isSubclassOfClass:[GHShapeGroup class]])
+            {
+                GHGroupUnderConstruction* aGroup = [[GHGroupUnderConstruction alloc] initWithClass:theClass attributes:childsAttributes];
+                aGroup.resolvedTransform = [resolvedValues objectForKey:kResolvedTransformElementName];
+                [self.stack addObject:aGroup];
+            }
+            else
+            {// the element may need its contents (text, gradient stops, css) so collect them in the usual form
+                NSMutableDictionary* aDefinition = [GHObjectTreeBuilder newDefinitionNamed:elementName withAttributes:childsAttributes
+                                                                        inParentDefinition:nil];
+                if(resolvedValues.count)
+                {
+                    [aDefinition addEntriesFromDictionary:resolvedValues];
+                }
+                [self.stack addObject:aDefinition];
+            }
+        }
+    }
+    else if([currentFrame isKindOfClass:[NSMutableDictionary class]])
+    {
+        NSMutableDictionary* aDefinition = [GHObjectTreeBuilder newDefinitionNamed:elementName withAttributes:attributes
+                                                                inParentDefinition:currentFrame];
+        [self.stack addObject:aDefinition];
+    }
+    else
+    {
+        [self.stack addObject:[NSNull null]];
+    }
+}
+
+-(void) endElement
+{
+    id finishedFrame = [self.stack lastObject];
+    if(finishedFrame == nil)
+    {
+        return;
+    }
+    [self.stack removeLastObject];
+    id parentFrame = [self.stack lastObject];
+    
+    id newObject = nil;
+    if([finishedFrame isKindOfClass:[GHGroupUnderConstruction class]])
+    {
+        newObject = [(GHGroupUnderConstruction*)finishedFrame newGroup];
+        if(parentFrame == nil)
+        {
+            self.rootObject = newObject;
+        }
+    }
+    else if([finishedFrame isKindOfClass:[NSMutableDictionary class]]
+            && [parentFrame isKindOfClass:[GHGroupUnderConstruction class]])
+    {
+        NSString* elementName = [finishedFrame objectForKey:kElementName];
+        newObject = [GHShapeGroup newChildNamed:elementName withDefinition:finishedFrame];
+    }
+    
+    if(newObject != nil && [parentFrame isKindOfClass:[GHGroupUnderConstruction class]])
+    {
+        [((GHGroupUnderConstruction*)parentFrame).children addObject:newObject];
+    }
+}
+
+-(void) foundCharacters:(NSString*)string
+{
+    id currentFrame = [self.stack lastObject];
+    if([currentFrame isKindOfClass:[NSMutableDictionary class]])
+    {// groups have no use for their text
+        [GHObjectTreeBuilder appendCharacters:string toDefinition:currentFrame];
+    }
+}
+
+-(void) foundCDATA:(NSData*)CDATABlock
+{
+    id currentFrame = [self.stack lastObject];
+    if([currentFrame isKindOfClass:[NSMutableDictionary class]])
+    {
+        [currentFrame setObject:CDATABlock forKey:kElementData];
+    }
+}
+
+-(BOOL) usesAttributesOfElementNamed:(NSString*)elementName
+{
+    BOOL result = YES;
+    id currentFrame = [self.stack lastObject];
+    if(currentFrame == nil)
+    {
+        result = self.rootDefinition == nil && [elementName isEqualToString:@"svg"];
+    }
+    else if([currentFrame isKindOfClass:[NSNull class]])
+    {
+        result = NO;
+    }
+    else if([currentFrame isKindOfClass:[GHGroupUnderConstruction class]])
+    {
+        result = [[GHShapeGroup nameToClassMap] valueForKey:elementName] != nil || [elementName isEqualToString:@"image"];
+    }
+    return result;
+}
+
+-(BOOL) buildFromUTF8Bytes:(const char*)bytes length:(size_t)length error:(NSError**)error
+{
+    GHXMLTokenizer* tokenizer = (GHXMLTokenizer*)malloc(sizeof(GHXMLTokenizer));
+    GHXMLTokenizerInit(tokenizer, bytes, length);
+    
+    GHNameTable names = {(GHInternedName*)calloc(256, sizeof(GHInternedName)), 256, 0};
+    NSMutableArray* internedStrings = [[NSMutableArray alloc] initWithCapacity:128];
+    
+    size_t decodeCapacity = 256;
+    char* decodeBuffer = (char*)malloc(decodeCapacity);
+    
+    NSInteger errorCode = 0;
+    size_t depth = 0;
+    GHXMLToken token;
+    BOOL done = NO;
+    while(!done)
+    {
+        @autoreleasepool
+        {
+            switch(GHXMLTokenizerNext(tokenizer, &token))
+            {
+                case kGHXMLTokenEndOfDocument:
+                {
+                    done = YES;
+                }
+                break;
+                case kGHXMLTokenError:
+                {
+                    errorCode = NSXMLParserInternalError;
+                    done = YES;
+                }
+                break;
+                case kGHXMLTokenStartElement:
+                {
+                    NSString* elementName = InternedName(&names, token.name, internedStrings);
+                    if(elementName == nil)
+                    {
+                        errorCode = NSXMLParserInvalidCharacterError;
+                        done = YES;
+                        break;
+                    }
+                    depth++;
+                    if(![self usesAttributesOfElementNamed:elementName])
+                    {// this pushes the same placeholder it would have with the real attributes
+                        [self startElementNamed:elementName withAttributes:@{}];
+                        break;
+                    }
+                    NSMutableDictionary* attributes = [[NSMutableDictionary alloc] initWithCapacity:token.attributeCount];
+                    for(size_t index = 0; index < token.attributeCount; index++)
+                    {
+                        const GHXMLAttribute* anAttribute = &token.attributes[index];
+                        NSString* attributeName = InternedName(&names, anAttribute->name, internedStrings);
+                        NSString* attributeValue = nil;
+                        if(anAttribute->value.flags == 0)
+                        {
+                            attributeValue = [[NSString alloc] initWithBytes:anAttribute->value.start length:anAttribute->value.length
+                                                                    encoding:NSUTF8StringEncoding];
+                        }
+                        else
+                        {
+                            size_t decodedLength = DecodeSpan(tokenizer, anAttribute->value, 1, &decodeBuffer, &decodeCapacity);
+                            attributeValue = [[NSString alloc] initWithBytes:decodeBuffer length:decodedLength encoding:NSUTF8StringEncoding];
+                        }
+                        if(attributeName != nil && attributeValue != nil)
+                        {
+                            [attributes setObject:attributeValue forKey:attributeName];
+                        }
+                    }
+                    [self startElementNamed:elementName withAttributes:attributes];
+                }
+                break;
+                case kGHXMLTokenEndElement:
+                {
+                    if(depth > 0)
+                    {
+                        depth--;
+                        [self endElement];
+                    }
+                }
+                break;
+                case kGHXMLTokenText:
+                {
+                    if([[self.stack lastObject] isKindOfClass:[NSMutableDictionary class]])
+                    {// groups have no use for their text, so don't bother making strings for them
+                        NSString* text = nil;
+                        if(token.text.flags == 0)
+                        {
+                            text = [[NSString alloc] initWithBytes:token.text.start length:token.text.length encoding:NSUTF8StringEncoding];
+                        }
+                        else
+                        {
+                            size_t decodedLength = DecodeSpan(tokenizer, token.text, 0, &decodeBuffer, &decodeCapacity);
+                            text = [[NSString alloc] initWithBytes:decodeBuffer length:decodedLength encoding:NSUTF8StringEncoding];
+                        }
+                        if(text.length)
+                        {
+                            [self foundCharacters:text];
+                        }
+                    }
+                }
+                break;
+                case kGHXMLTokenCDATA:
+                {
+                    NSData* data = [[NSData alloc] initWithBytes:token.text.start length:token.text.length];
+                    [self foundCDATA:data];
+                }
+                break;
+            }
+        }
+    }
+    
+    size_t errorOffset = tokenizer->errorOffset;
+    free(decodeBuffer);
+    free(names.entries);
+    GHXMLTokenizerFinish(tokenizer);
+    free(tokenizer);
+    
+    if(errorCode == 0 && (depth > 0 || self.rootObject == nil))
+    {
+        errorCode = NSXMLParserPrematureDocumentEndError;
+        errorOffset = length;
+    }
+    if(errorCode != 0 && error != nil)
+    {
+        *error = [NSError errorWithDomain:NSXMLParserErrorDomain code:errorCode
+                                 userInfo:@{@"offset":@(errorOffset)}];
+    }
+    return errorCode == 0;
+}
+
+@end
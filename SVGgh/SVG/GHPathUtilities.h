@@ -48,6 +48,49 @@ typedef void (^pointAndVectorCallback_t)(CGPoint point, CGPoint vector);
 
 void CGPathApplyCallbackFunction(void*   aVisitor, const CGPathElement *  element);
 
+/*! @brief a Core Graphics path flattened once by adaptive subdivision into a table of running lengths, so that any distance along it can be found by binary search instead of walking the path again
+*/
+@interface GHPathMeasure : NSObject
+/*! @property length the total length of the path, including closing segments but not the jumps made by move to
+*/
+@property(nonatomic, readonly) CGFloat length;
+
+/*! @property tolerance how far the flattened path may stray from the curves it replaces
+*/
+@property(nonatomic, readonly) CGFloat tolerance;
+
+/*! @brief measure a path with the default tolerance. Not cached, so anything asking repeatedly about the same path should keep the result, as GHShape does with its pathMeasure.
+* @param aPath path to measure
+* @return a new measure with the default tolerance
+*/
++(GHPathMeasure*) pathMeasureForCGPath:(CGPathRef)aPath;
+
+/*! @brief measure a path
+* @param aPath path to measure
+* @param tolerance most distance in user units the flattened path can be from the real one, 0 for the default
+*/
+-(instancetype) initWithCGPath:(CGPathRef)aPath tolerance:(CGFloat)tolerance NS_DESIGNATED_INITIALIZER;
+-(instancetype) init NS_UNAVAILABLE;
+
+/*! @brief find where on the path a distance lands
+* @param distance how far along the path
+* @param pointPtr optional, receives the point on the path (or extrapolated off its ends)
+* @param tangentPtr optional, receives the unit direction of travel at that point
+* @return NO if the distance was off either end of the path or the path had no length
+*/
+-(BOOL) getPoint:(nullable CGPoint*)pointPtr tangent:(nullable CGPoint*)tangentPtr atDistance:(CGFloat)distance;
+
+/*! @brief find where many distances land in one forward sweep of the table, as when laying out a run of glyphs
+* @param points receives count points
+* @param tangents receives count unit directions of travel
+* @param onPath optional, receives count flags saying which distances were on the path
+* @param distances how far along the path, cheapest when increasing
+* @param count number of distances
+* @return how many of the distances were on the path
+*/
+-(NSUInteger) getPoints:(CGPoint*)points tangents:(CGPoint*)tangents onPath:(nullable BOOL*)onPath atDistances:(const CGFloat*)distances count:(NSUInteger)count;
+@end
+
 @interface GHPathUtilities : NSObject
 
 /*! @brief approximate the distance along the given quadratic spline section from the start to the end point
@@ -90,13 +133,13 @@ void CGPathApplyCallbackFunction(void*   aVisitor, const CGPathElement *  elemen
                          withControlPoint2:(CGPoint)controlPoint2 andStep:(CGFloat)step;
 
 
-/*! @brief get the total length of a Core Graphics path (somewhat of an approximation, does not include jumps via move to)
+/*! @brief get the total length of a Core Graphics path (somewhat of an approximation, includes closing segments but not jumps via move to). Measures the path each call, use a kept GHPathMeasure for repeated queries.
  * @param aPath a Core Graphics path to find the lengh of
  * @return a length
  */
 +(CGFloat) totalLengthOfCGPath:(CGPathRef)aPath;
 
-/*! @brief go a given distance along a path and find out the location of the point at that distance and the direction vector at that point
+/*! @brief go a given distance along a path and find out the location of the point at that distance and the direction vector at that point. Measures the path each call, use a kept GHPathMeasure for repeated queries.
  * @param length a distance along the path to go
  * @param aPath a Core Graphics path to test
  * @param callback the block to call when you retrieve this information
@@ -27,6 +27,7 @@
 //
 
 #import "GHPathUtilities.h"
+#import "SVGPathMeasure.h"
 
 void CGPathApplyCallbackFunction(void* aVisitor, const CGPathElement *element)
 {
@@ -35,6 +36,93 @@ void CGPathApplyCallbackFunction(void* aVisitor, const CGPathElement *element)
 }
 
 
+@interface GHPathMeasure()
+{
+    SVGPathMeasure  _measure;
+}
+@end
+
+@implementation GHPathMeasure
+
++(GHPathMeasure*) pathMeasureForCGPath:(CGPathRef)aPath
+{// not cached, looking a path up by its contents costs about as much as measuring it; owners of a fixed path keep their measure instead
+    return [[GHPathMeasure alloc] initWithCGPath:aPath tolerance:0.0];
+}
+
+-(instancetype) initWithCGPath:(CGPathRef)aPath tolerance:(CGFloat)tolerance
+{
+    if(nil != (self = [super init]))
+    {
+        SVGPathMeasureInit(&_measure, tolerance);
+        SVGPathMeasureAppendCGPath(&_measure, aPath);
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    SVGPathMeasureFree(&_measure);
+}
+
+-(CGFloat) length
+{
+    return SVGPathMeasureGetLength(&_measure);
+}
+
+-(CGFloat) tolerance
+{
+    return _measure.tolerance;
+}
+
+-(BOOL) getPoint:(CGPoint*)pointPtr tangent:(CGPoint*)tangentPtr atDistance:(CGFloat)distance
+{
+    SVGPathMeasurePosition position;
+    memset(&position, 0, sizeof(position));
+    BOOL result = SVGPathMeasureGetPosition(&_measure, distance, &position);
+    if(pointPtr != NULL)
+    {
+        *pointPtr = CGPointMake(position.x, position.y);
+    }
+    if(tangentPtr != NULL)
+    {
+        *tangentPtr = CGPointMake(position.tangentX, position.tangentY);
+    }
+    return result;
+}
+
+-(NSUInteger) getPoints:(CGPoint*)points tangents:(CGPoint*)tangents onPath:(BOOL*)onPath atDistances:(const CGFloat*)distances count:(NSUInteger)count
+{
+    NSUInteger result = 0;
+    if(count > 0)
+    {
+        double* distanceList = malloc(count*sizeof(double));
+        SVGPathMeasurePosition* positions = calloc(count, sizeof(SVGPathMeasurePosition));
+        int* onPathList = malloc(count*sizeof(int));
+        if(distanceList != NULL && positions != NULL && onPathList != NULL)
+        {
+            for(NSUInteger index = 0; index < count; index++)
+            {
+                distanceList[index] = distances[index];
+            }
+            result = SVGPathMeasureGetPositions(&_measure, distanceList, count, positions, onPathList);
+            for(NSUInteger index = 0; index < count; index++)
+            {
+                points[index] = CGPointMake(positions[index].x, positions[index].y);
+                tangents[index] = CGPointMake(positions[index].tangentX, positions[index].tangentY);
+                if(onPath != NULL)
+                {
+                    onPath[index] = (onPathList[index] != 0);
+                }
+            }
+        }
+        free(distanceList);
+        free(positions);
+        free(onPathList);
+    }
+    return result;
+}
+@end
+
 @implementation GHPathUtilities
 // from http://stackoverflow.com/questions/12024674/get-cgpath-total-length
 + (CGFloat) quadraticBezierLengthFromStartPoint: (CGPoint) start toEndPoint: (CGPoint) end withControlPoint: (CGPoint) control andStep:(CGFloat)step
@@ -163,274 +251,28 @@ void CGPathApplyCallbackFunction(void* aVisitor, const CGPathElement *element)
 
 +(CGFloat) totalLengthOfCGPath:(CGPathRef)pathRef
 {
-    __block  CGPoint currentPoint = CGPointZero;
-    __block  CGFloat runningLength = 0;
-    
-    __block pathVisitor_t     callback =  ^(const CGPathElement* aPathElement){
-        
-        __block pathVisitor_t lineToCallback = ^(const CGPathElement* lineSegmentElement){
-            CGPoint nextPoint = lineSegmentElement->points[0];
-            CGFloat deltaX = nextPoint.x-currentPoint.x;
-            CGFloat deltaY = nextPoint.y-currentPoint.y;
-            if(fabs(deltaX)>0.004 || fabs(deltaY) > 0.004)
-            {
-                CGFloat segmentLength = sqrtf(deltaX*deltaX+deltaY*deltaY);
-                CGFloat lengthLeft = segmentLength;
-                
-                runningLength += lengthLeft;
-            }
-            currentPoint = nextPoint;
-            
-        };
-        
-        switch (aPathElement->type)
-        {
-            case kCGPathElementMoveToPoint:
-            {
-                currentPoint = aPathElement->points[0];
-            }
-                break;
-            case kCGPathElementAddLineToPoint:
-            {
-                lineToCallback(aPathElement);
-            }
-                break;
-            case kCGPathElementAddQuadCurveToPoint:
-            {
-                CGPoint startPoint = currentPoint;
-                CGPoint controlPoint = aPathElement->points[0];
-                CGPoint nextPoint = aPathElement->points[1];
-                CGFloat approximationStep = [GHPathUtilities calculateQuadraticSplineStepFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint:controlPoint];
-                CGFloat t =  approximationStep;
-                
-                while(t <= 1.0)
-                {
-                    CGFloat x = (1.0f - t)*(1.0f - t)*startPoint.x + 2.0f*(1.0f - t)*t*controlPoint.x + t*t*nextPoint.x;
-                    CGFloat y = (1.0f - t)*(1.0f - t)*startPoint.y + 2.0f*(1.0f - t)*t*controlPoint.y + t*t*nextPoint.y;
-                    CGPoint linePoint = CGPointMake(x, y);
-                    CGPathElement   approximationElement;
-                    approximationElement.type = kCGPathElementAddLineToPoint;
-                    approximationElement.points = &linePoint;
-                    lineToCallback(&approximationElement);
-                    if(t < 1.0)
-                    {
-                        t += approximationStep;
-                        if(t > 1.0)
-                        {
-                            t = 1.0;
-                        }
-                    }
-                    else
-                    {
-                        t += approximationStep;
-                    }
-                }
-                currentPoint = nextPoint;
-                
-            }
-                break;
-            case kCGPathElementAddCurveToPoint:
-            {
-                CGPoint controlPoint1 = aPathElement->points[0];
-                CGPoint controlPoint2 = aPathElement->points[1];
-                CGPoint nextPoint = aPathElement->points[2];
-                CGPoint startPoint = currentPoint;
-                
-                CGFloat A = nextPoint.x-3.0f*controlPoint2.x+3.0f*controlPoint1.x-startPoint.x;
-                CGFloat B = 3.0f*controlPoint2.x-6.0f*controlPoint1.x+3.0f*startPoint.x;
-                CGFloat C = 3.0f*controlPoint1.x-3.0f*startPoint.x;
-                CGFloat D = startPoint.x;
-                CGFloat E = nextPoint.y-3.0f*controlPoint2.y+3.0f*controlPoint1.y-startPoint.y;
-                CGFloat F = 3.0f*controlPoint2.y-6.0f*controlPoint1.y+3.0f*startPoint.y;
-                CGFloat G = 3.0f*controlPoint1.y-3.0f*startPoint.y;
-                CGFloat H = startPoint.y;
-                
-                CGFloat approximationStep = [GHPathUtilities calculateCubicSplineStepFromFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint1:controlPoint1 withControlPoint2:(CGPoint)controlPoint2];
-                CGFloat t =  approximationStep;
-                while(t <= 1.0)
-                {
-                    CGFloat x = (((A*t) + B)*t + C)*t + D;
-                    CGFloat y = (((E*t) + F)*t + G)*t + H;
-                    CGPoint linePoint = CGPointMake(x, y);
-                    CGPathElement   approximationElement;
-                    approximationElement.type = kCGPathElementAddLineToPoint;
-                    approximationElement.points = &linePoint;
-                    lineToCallback(&approximationElement);
-                    if(t < 1.0)
-                    {
-                        t += approximationStep;
-                        if(t > 1.0)
-                        {
-                            t = 1.0;
-                        }
-                    }
-                    else
-                    {
-                        t += approximationStep;
-                    }
-                }
-                currentPoint = nextPoint;
-            }
-                break;
-            case kCGPathElementCloseSubpath:
-                break;
-            default:
-            {
-            }
-                break;
-        }
-    };
-    
-    CGPathApply(pathRef, (__bridge void *)callback, CGPathApplyCallbackFunction);
-    return runningLength;
+    CGFloat result = 0.0;
+    if(pathRef != 0)
+    {
+        result = [GHPathMeasure pathMeasureForCGPath:pathRef].length;
+    }
+    return result;
 }
 
 +(void) findPointAndVectorAtDistance:(CGFloat)length intoPath:(CGPathRef)pathRef intoCallback:(pointAndVectorCallback_t)callback
 {
-    __block CGPoint point = CGPointZero;
-    __block CGPoint vector = CGPointMake(1, 0);
+    CGPoint point = CGPointZero;
+    CGPoint vector = CGPointMake(1, 0);
     if(pathRef != 0)
     {
-        __block CGFloat nextOffset = length;
-        __block  CGPoint currentPoint = CGPointZero;
-        __block  CGFloat runningLength = 0;
-        __block  BOOL foundIt = NO;
-        __block pathVisitor_t     callback =  ^(const CGPathElement* aPathElement){
-            
-            if(!foundIt)
-            {
-                __block pathVisitor_t lineToCallback = ^(const CGPathElement* lineSegmentElement){
-                    CGPoint nextPoint = lineSegmentElement->points[0];
-                    CGFloat deltaX = nextPoint.x-currentPoint.x;
-                    CGFloat deltaY = nextPoint.y-currentPoint.y;
-                    if(fabs(deltaX)>0.004 || fabs(deltaY) > 0.004)
-                    {
-                        CGFloat segmentLength = sqrtf(deltaX*deltaX+deltaY*deltaY);
-                        CGFloat lengthLeft = segmentLength;
-                        while(lengthLeft > 0 && !foundIt)
-                        {
-                            if(nextOffset > (runningLength+lengthLeft))
-                            {
-                                runningLength += lengthLeft;
-                                lengthLeft = 0.0;
-                                currentPoint = nextPoint;
-                            }
-                            else
-                            {
-                                foundIt = YES;
-                                CGFloat distanceIntoSegment = nextOffset-runningLength;
-                                CGPoint thePoint = CGPointMake((distanceIntoSegment/segmentLength)*deltaX+currentPoint.x, (distanceIntoSegment/segmentLength)*deltaY+currentPoint.y);
-                                
-                                vector = CalculateNormal(currentPoint, nextPoint);
-                                point = thePoint;
-                                currentPoint = thePoint;
-                            }
-                        }
-                    }
-                    currentPoint = nextPoint;
-                    
-                };
-                
-                switch (aPathElement->type)
-                {
-                    case kCGPathElementMoveToPoint:
-                    {
-                        currentPoint = aPathElement->points[0];
-                    }
-                        break;
-                    case kCGPathElementAddLineToPoint:
-                    {
-                        lineToCallback(aPathElement);
-                    }
-                        break;
-                    case kCGPathElementAddQuadCurveToPoint:
-                    {
-                        CGPoint startPoint = currentPoint;
-                        CGPoint controlPoint = aPathElement->points[0];
-                        CGPoint nextPoint = aPathElement->points[1];
-                        CGFloat approximationStep = [GHPathUtilities calculateQuadraticSplineStepFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint:controlPoint];
-                        CGFloat t =  approximationStep;
-                        
-                        while(t <= 1.0)
-                        {
-                            CGFloat x = (1.0f - t)*(1.0f - t)*startPoint.x + 2.0f*(1.0f - t)*t*controlPoint.x + t*t*nextPoint.x;
-                            CGFloat y = (1.0f - t)*(1.0f - t)*startPoint.y + 2.0f*(1.0f - t)*t*controlPoint.y + t*t*nextPoint.y;
-                            CGPoint linePoint = CGPointMake(x, y);
-                            CGPathElement   approximationElement;
-                            approximationElement.type = kCGPathElementAddLineToPoint;
-                            approximationElement.points = &linePoint;
-                            lineToCallback(&approximationElement);
-                            if(t < 1.0)
-                            {
-                                t += approximationStep;
-                                if(t > 1.0)
-                                {
-                                    t = 1.0;
-                                }
-                            }
-                            else
-                            {
-                                t += approximationStep;
-                            }
-                        }
-                        currentPoint = nextPoint;
-                        
-                    }
-                        break;
-                    case kCGPathElementAddCurveToPoint:
-                    {
-                        CGPoint controlPoint1 = aPathElement->points[0];
-                        CGPoint controlPoint2 = aPathElement->points[1];
-                        CGPoint nextPoint = aPathElement->points[2];
-                        CGPoint startPoint = currentPoint;
-                        
-                        CGFloat A = nextPoint.x-3.0f*controlPoint2.x+3.0f*controlPoint1.x-startPoint.x;
-                        CGFloat B = 3.0f*controlPoint2.x-6.0f*controlPoint1.x+3.0f*startPoint.x;
-                        CGFloat C = 3.0f*controlPoint1.x-3.0f*startPoint.x;
-                        CGFloat D = startPoint.x;
-                        CGFloat E = nextPoint.y-3.0f*controlPoint2.y+3.0f*controlPoint1.y-startPoint.y;
-                        CGFloat F = 3.0f*controlPoint2.y-6.0f*controlPoint1.y+3.0f*startPoint.y;
-                        CGFloat G = 3.0f*controlPoint1.y-3.0f*startPoint.y;
-                        CGFloat H = startPoint.y;
-                        
-                        CGFloat approximationStep = [GHPathUtilities calculateCubicSplineStepFromFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint1:controlPoint1 withControlPoint2:(CGPoint)controlPoint2];
-                        CGFloat t =  approximationStep;
-                        while(t <= 1.0)
-                        {
-                            CGFloat x = (((A*t) + B)*t + C)*t + D;
-                            CGFloat y = (((E*t) + F)*t + G)*t + H;
-                            CGPoint linePoint = CGPointMake(x, y);
-                            CGPathElement   approximationElement;
-                            approximationElement.type = kCGPathElementAddLineToPoint;
-                            approximationElement.points = &linePoint;
-                            lineToCallback(&approximationElement);
-                            if(t < 1.0)
-                            {
-                                t += approximationStep;
-                                if(t > 1.0)
-                                {
-                                    t = 1.0;
-                                }
-                            }
-                            else
-                            {
-                                t += approximationStep;
-                            }
-                        }
-                        currentPoint = nextPoint;
-                    }
-                        break;
-                    case kCGPathElementCloseSubpath:
-                        break;
-                    default:
-                    {
-                    }
-                        break;
-                }
-            }
-        };
-        
-        CGPathApply(pathRef, (__bridge void *)callback, CGPathApplyCallbackFunction);
+        CGPoint pointOnPath = CGPointZero;
+        CGPoint tangent = CGPointZero;
+        BOOL onPath = [[GHPathMeasure pathMeasureForCGPath:pathRef] getPoint:&pointOnPath tangent:&tangent atDistance:length];
+        if(onPath || (length < 0.0 && (tangent.x != 0.0 || tangent.y != 0.0)))
+        {// as always, running off the end finds nothing, but a negative distance is extended back from the first segment
+            point = pointOnPath;
+            vector = CGPointMake(-1.0*tangent.y, tangent.x);
+        }
     }
     callback(point, vector);
 }
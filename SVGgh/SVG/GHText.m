@@ -48,7 +48,8 @@
 
 
 @interface TextPath : GHText
-
+// the glyphs as last laid out, and the measure of the path they were laid out along, swapped together so a concurrent render sees one or the other
+@property(atomic, strong) NSArray* glyphPlacement;
 @end
 
 
@@ -133,12 +134,12 @@
                                                                                 baseFont:myFontRef
                                                                                 baseFontDescriptor:myFontDescription
                                                                                includeParagraphStyle:NO];
-						if([tspanAttributes objectForKey:@"transform"] != nil
-						   || [tspanAttributes objectForKey:@"x"] != nil
-						   || [tspanAttributes objectForKey:@"dx"] != nil
-						   || [tspanAttributes objectForKey:@"y"] != nil
-						   || [tspanAttributes objectForKey:@"dy"] != nil
-						   || [tspanAttributes objectForKey:@"rotate"] != nil)
+						if([tspanAttributes objectForAtom:kGHAttributeTransform] != nil
+						   || [tspanAttributes objectForAtom:kGHAttributeX] != nil
+						   || [tspanAttributes objectForAtom:kGHAttributeDX] != nil
+						   || [tspanAttributes objectForAtom:kGHAttributeY] != nil
+						   || [tspanAttributes objectForAtom:kGHAttributeDY] != nil
+						   || [tspanAttributes objectForAtom:kGHAttributeRotate] != nil)
 						{ // need a new line
 							if([currentString length])
 							{
@@ -204,12 +205,12 @@
                     
                     NSDictionary* lastAttributes = [lastDefinition objectForKey:kAttributesElementName];
                     if(lastDefinition != defaultDefinition
-                       && ([lastAttributes objectForKey:@"transform"] != nil
-                           || [lastAttributes objectForKey:@"x"] != nil
-                           || [lastAttributes objectForKey:@"dx"] != nil
-                           || [lastAttributes objectForKey:@"y"] != nil
-                           || [lastAttributes objectForKey:@"dy"] != nil
-                           || [lastAttributes objectForKey:@"rotate"] != nil))
+                       && ([lastAttributes objectForAtom:kGHAttributeTransform] != nil
+                           || [lastAttributes objectForAtom:kGHAttributeX] != nil
+                           || [lastAttributes objectForAtom:kGHAttributeDX] != nil
+                           || [lastAttributes objectForAtom:kGHAttributeY] != nil
+                           || [lastAttributes objectForAtom:kGHAttributeDY] != nil
+                           || [lastAttributes objectForAtom:kGHAttributeRotate] != nil))
                     {// need a new line
                         if([currentString length])
                         {
@@ -330,7 +331,7 @@
 -(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
 {
     CGRect myBox = [self getBoundingBoxWithSVGContext:svgContext];
-    NSString* fillString = [self.attributes objectForKey:@"fill"];
+    NSString* fillString = [self.attributes objectForAtom:kGHAttributeFill];
     GHGradient* defaultGradientFillToUse = nil;
     UIColor*  defaultFillColorToUse = [svgContext currentColor];
     GHGradient* defaultGradientStrokeToUse = nil;
@@ -362,7 +363,7 @@
         defaultFillColorToUse = [UIColor blackColor];
     }
     
-    NSString* strokeString = [self.attributes objectForKey:@"stroke"];
+    NSString* strokeString = [self.attributes objectForAtom:kGHAttributeStroke];
     if([strokeString isEqualToString:@"none"])
     {
     }
@@ -383,7 +384,7 @@
         defaultStrokeColorToUse = [svgContext colorForSVGColorString:strokeString];
     }
     
-    NSString* strokeWidthDescripion = [self.attributes objectForKey:@"stroke-width"];
+    NSString* strokeWidthDescripion = [self.attributes objectForAtom:kGHAttributeStrokeWidth];
     if([strokeWidthDescripion length])
     {
         defaultStrokeWidthToUse = [strokeWidthDescripion floatValue];
@@ -567,7 +568,7 @@
 -(void) setupFontDescriptorWithBaseDescriptor:(CTFontDescriptorRef)baseDescriptor andBaseFont:(CTFontRef)baseFont
 {
 	NSDictionary* myAttributes = self.attributes;
-	NSString*	styleString = [myAttributes objectForKey:@"style"];
+	NSString*	styleString = [myAttributes objectForAtom:kGHAttributeStyle];
 	if([styleString length] || baseDescriptor == 0)
 	{
 		_fontDescriptor = [SVGTextUtilities newFontDescriptorFromAttributes:myAttributes baseDescriptor:baseDescriptor];
@@ -808,7 +809,7 @@
 -(BOOL) cleanLineEndings
 {
     NSDictionary* myAttributes = self.attributes;
-    NSString* linePreservation = [myAttributes objectForKey:@"xml:space"];
+    NSString* linePreservation = [myAttributes objectForAtom:kGHAttributeXMLSpace];
     
     BOOL result = ![linePreservation isEqualToString:@"preserve"];
     return result;
@@ -851,13 +852,13 @@
     CGFloat height = CGFLOAT_MAX;
     CGFloat width = CGFLOAT_MAX;
     
-    NSString* heightAttribute = [self.attributes objectForKey:@"height"];
+    NSString* heightAttribute = [self.attributes objectForAtom:kGHAttributeHeight];
     if(heightAttribute.length && ![heightAttribute isEqualToString:@"auto"])
     {
         height = heightAttribute.floatValue;
     }
     
-    NSString* widthAttribute = [self.attributes objectForKey:@"width"];
+    NSString* widthAttribute = [self.attributes objectForAtom:kGHAttributeWidth];
     if(widthAttribute.length && ![widthAttribute isEqualToString:@"auto"])
     {
         width = widthAttribute.floatValue;
@@ -925,7 +926,7 @@
         CGContextScaleCTM(quartzContext, 1.0, -1.0);
         
         CGSize mySize = self.size;
-        NSString* verticalAlignement = [self.attributes objectForKey:@"display-align"];
+        NSString* verticalAlignement = [self.attributes objectForAtom:kGHAttributeDisplayAlign];
         if([verticalAlignement length] && ![verticalAlignement isEqualToString:@"auto"] && ![verticalAlignement isEqualToString:@"before"])
         {
             CFRange stringThatFitsRange;
@@ -955,8 +956,8 @@
 -(CGRect) box
 {
     CGRect result = CGRectZero;
-    NSString* xAttribute = [self.attributes objectForKey:@"x"];
-    NSString* yAttribute = [self.attributes objectForKey:@"y"];
+    NSString* xAttribute = [self.attributes objectForAtom:kGHAttributeX];
+    NSString* yAttribute = [self.attributes objectForAtom:kGHAttributeY];
     CGFloat x = [xAttribute floatValue];
     CGFloat y = [yAttribute floatValue];
     CGSize mySize = self.size;
@@ -1026,9 +1027,28 @@
     }
 }
 
+-(NSArray*) glyphsPlacedAlongShape:(GHShape*)aShape withSVGContext:(id<SVGContext>)svgContext
+{
+    GHPathMeasure* pathMeasure = aShape.pathMeasure;
+    NSArray* placement = self.glyphPlacement;
+    NSArray* result = placement.lastObject;
+    if(placement == nil || placement.firstObject != pathMeasure)
+    {// the text is fixed, so the glyphs only need to be laid out again when followed along a different shape
+        NSMutableArray* listOfGlyphs = [[NSMutableArray alloc] initWithCapacity:1024];
+        [self addGlyphsToArray:listOfGlyphs  withSVGContext:svgContext];
+        if(listOfGlyphs.count)
+        {
+            [GHGlyph positionGlyphs:listOfGlyphs alongPathMeasure:pathMeasure];
+        }
+        result = [listOfGlyphs copy];
+        self.glyphPlacement = @[pathMeasure, result];
+    }
+    return result;
+}
+
 -(void)addGlyphsToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
 {
-    id  xlinkValue = [self.attributes objectForKey:@"xlink:href"];
+    id  xlinkValue = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
     if([xlinkValue isKindOfClass:[NSString class]] && [xlinkValue hasPrefix:@"#"])
     {
         NSString* pathName = [xlinkValue substringFromIndex:1];
@@ -1038,11 +1058,9 @@
             CGPathRef pathRef = [aShape quartzPath];
             if(pathRef)
             {
-                __block NSMutableArray* listOfGlyphs = [[NSMutableArray alloc] initWithCapacity:1024];
-                [self addGlyphsToArray:listOfGlyphs  withSVGContext:svgContext];
+                NSArray* listOfGlyphs = [self glyphsPlacedAlongShape:aShape withSVGContext:svgContext];
                 if(listOfGlyphs.count)
                 {
-                    [GHGlyph positionGlyphs:listOfGlyphs alongCGPath:pathRef];
                     [self renderGlyphs:listOfGlyphs intoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext];
                 }
             }
@@ -29,6 +29,7 @@
 #import "GHTextLine.h"
 #import "GHGlyph.h"
 #import "GHRenderable.h"
+#import "GHAttributeTable.h"
 
 @interface GHTextLine()
 @property(nonatomic, readonly) CTLineRef	lineRef;
@@ -48,9 +49,9 @@
         {
             CFRetain(_lineRef);
         }
-		NSString*	transformAttribute = [self.attributes objectForKey:@"transform"];
+		NSString*	transformAttribute = [self.attributes objectForAtom:kGHAttributeTransform];
 		_transform = SVGTransformToCGAffineTransform(transformAttribute);
-        NSString* strokeWidthString = [self.attributes objectForKey:@"stroke-width"];
+        NSString* strokeWidthString = [self.attributes objectForAtom:kGHAttributeStrokeWidth];
         if(strokeWidthString.length)
         {
             strokeWidth = strokeWidthString.doubleValue;
@@ -91,7 +92,7 @@
     CGRect result = CGRectZero;
     if(self.lineRef)
     {
-		NSString*	textAnchorString = [self.attributes objectForKey:@"text-anchor"];
+		NSString*	textAnchorString = [self.attributes objectForAtom:kGHAttributeTextAnchor];
         CGFloat ascent = 0.0;
         CGFloat descent = 0.0;
         CGFloat leading = 0.0;
@@ -148,11 +149,11 @@
     
     NSDictionary* myAttributes = self.attributes;
     
-    NSNumber*	xOffset = [myAttributes objectForKey:@"x"];
-    NSNumber*	yOffset = [myAttributes objectForKey:@"y"];
-    NSNumber*	deltaX = [myAttributes objectForKey:@"dx"];
-    NSNumber*	deltaY = [myAttributes objectForKey:@"dy"];
-    NSNumber*	rotation = [myAttributes objectForKey:@"rotate"];
+    NSNumber*	xOffset = [myAttributes objectForAtom:kGHAttributeX];
+    NSNumber*	yOffset = [myAttributes objectForAtom:kGHAttributeY];
+    NSNumber*	deltaX = [myAttributes objectForAtom:kGHAttributeDX];
+    NSNumber*	deltaY = [myAttributes objectForAtom:kGHAttributeDY];
+    NSNumber*	rotation = [myAttributes objectForAtom:kGHAttributeRotate];
     CGAffineTransform	affineTransform = CGAffineTransformMakeScale(1.0, -1.0);
     
     affineTransform = CGAffineTransformTranslate(affineTransform, [xOffset floatValue], -[yOffset floatValue]);
@@ -172,11 +173,11 @@
 {
     NSDictionary* myAttributes = self.attributes;
     
-    NSNumber*	xOffset = [myAttributes objectForKey:@"x"];
-    NSNumber*	yOffset = [myAttributes objectForKey:@"y"];
-    NSNumber*	deltaX = [myAttributes objectForKey:@"dx"];
-    NSNumber*	deltaY = [myAttributes objectForKey:@"dy"];
-    NSNumber*	rotation = [myAttributes objectForKey:@"rotate"];
+    NSNumber*	xOffset = [myAttributes objectForAtom:kGHAttributeX];
+    NSNumber*	yOffset = [myAttributes objectForAtom:kGHAttributeY];
+    NSNumber*	deltaX = [myAttributes objectForAtom:kGHAttributeDX];
+    NSNumber*	deltaY = [myAttributes objectForAtom:kGHAttributeDY];
+    NSNumber*	rotation = [myAttributes objectForAtom:kGHAttributeRotate];
     
     
     CGAffineTransform result = self.transform;
@@ -185,7 +186,7 @@
     
     CGFloat	textPositionX = [xOffset floatValue];
     CGFloat	textPositionY = [yOffset floatValue];
-    NSString*	textAnchorString = [myAttributes objectForKey:@"text-anchor"];
+    NSString*	textAnchorString = [myAttributes objectForAtom:kGHAttributeTextAnchor];
     if([textAnchorString length])
     {
         
@@ -226,8 +227,8 @@
             startOffset.x += previousGlyph.width;
         }
         
-        NSNumber* deltaY = [self.attributes objectForKey:@"dy"];
-        NSNumber* deltaX = [self.attributes objectForKey:@"dx"];
+        NSNumber* deltaY = [self.attributes objectForAtom:kGHAttributeDY];
+        NSNumber* deltaX = [self.attributes objectForAtom:kGHAttributeDX];
         
         CGPoint manualOffset = CGPointZero;
         if(deltaX != nil || deltaY != nil)
@@ -328,11 +329,11 @@
 	{
         NSDictionary* myAttributes = self.attributes;
         
-		NSNumber*	xOffset = [myAttributes objectForKey:@"x"];
-		NSNumber*	yOffset = [myAttributes objectForKey:@"y"];
-		NSNumber*	deltaX = [myAttributes objectForKey:@"dx"];
-		NSNumber*	deltaY = [myAttributes objectForKey:@"dy"];
-		NSNumber*	rotation = [myAttributes objectForKey:@"rotate"];
+		NSNumber*	xOffset = [myAttributes objectForAtom:kGHAttributeX];
+		NSNumber*	yOffset = [myAttributes objectForAtom:kGHAttributeY];
+		NSNumber*	deltaX = [myAttributes objectForAtom:kGHAttributeDX];
+		NSNumber*	deltaY = [myAttributes objectForAtom:kGHAttributeDY];
+		NSNumber*	rotation = [myAttributes objectForAtom:kGHAttributeRotate];
 		
 		CGAffineTransform	affineTransform = CGAffineTransformMakeScale(1.0, -1.0);
 		
@@ -345,7 +346,7 @@
 		CGFloat	textPositionX = [xOffset floatValue];
 		CGFloat	textPositionY = [yOffset floatValue];
         
-		NSString*	textAnchorString = [myAttributes objectForKey:@"text-anchor"];
+		NSString*	textAnchorString = [myAttributes objectForAtom:kGHAttributeTextAnchor];
 		if([textAnchorString length])
 		{
 			
@@ -0,0 +1,649 @@
+//
+//  GHXMLTokenizer.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+#include "GHXMLTokenizer.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int IsXMLWhitespace(char aCharacter)
+{
+    return aCharacter == ' ' || aCharacter == '\n' || aCharacter == '\t' || aCharacter == '\r';
+}
+
+static int IsNameTerminator(char aCharacter)
+{
+    return IsXMLWhitespace(aCharacter) || aCharacter == '>' || aCharacter == '/' || aCharacter == '=';
+}
+
+static const char* FindSequence(const char* start, const char* end, const char* sequence, size_t sequenceLength)
+{// memchr to the first character then compare the rest
+    const char* result = NULL;
+    const char* cursor = start;
+    while(cursor + sequenceLength <= end)
+    {
+        cursor = (const char*)memchr(cursor, sequence[0], (size_t)(end - cursor) - sequenceLength + 1);
+        if(cursor == NULL)
+        {
+            break;
+        }
+        if(memcmp(cursor, sequence, sequenceLength) == 0)
+        {
+            result = cursor;
+            break;
+        }
+        cursor++;
+    }
+    return result;
+}
+
+static int HasPrefix(const char* start, const char* end, const char* prefix, size_t prefixLength)
+{
+    return (size_t)(end - start) >= prefixLength && memcmp(start, prefix, prefixLength) == 0;
+}
+
+static uint32_t FlagsForSpan(const char* start, size_t length, int isAttributeValue)
+{
+    uint32_t result = 0;
+    if(memchr(start, '&', length) != NULL)
+    {
+        result |= kGHXMLSpanHasEntities;
+    }
+    if(isAttributeValue)
+    {
+        for(size_t index = 0; index < length; index++)
+        {
+            char aCharacter = start[index];
+            if(aCharacter == '\n' || aCharacter == '\t' || aCharacter == '\r')
+            {
+                result |= kGHXMLSpanHasLineBreaks;
+                break;
+            }
+        }
+    }
+    else if(memchr(start, '\r', length) != NULL)
+    {
+        result |= kGHXMLSpanHasLineBreaks;
+    }
+    return result;
+}
+
+static GHXMLTokenType FailAt(GHXMLTokenizer* tokenizer, GHXMLToken* token, const char* location)
+{
+    tokenizer->errorOffset = (size_t)(location - tokenizer->buffer);
+    tokenizer->offset = tokenizer->length;
+    token->type = kGHXMLTokenError;
+    return token->type;
+}
+
+void GHXMLTokenizerInit(GHXMLTokenizer* tokenizer, const char* buffer, size_t length)
+{
+    tokenizer->buffer = buffer;
+    tokenizer->length = length;
+    tokenizer->offset = 0;
+    tokenizer->errorOffset = 0;
+    tokenizer->pendingEndElement = 0;
+    tokenizer->pendingEndName.start = NULL;
+    tokenizer->pendingEndName.length = 0;
+    tokenizer->pendingEndName.flags = 0;
+    tokenizer->attributes = tokenizer->inlineAttributes;
+    tokenizer->attributeCapacity = kGHXMLInlineAttributes;
+    tokenizer->entities = NULL;
+    tokenizer->entityCount = 0;
+    tokenizer->entityCapacity = 0;
+    if(length >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0)
+    {
+        tokenizer->offset = 3;
+    }
+}
+
+void GHXMLTokenizerFinish(GHXMLTokenizer* tokenizer)
+{
+    if(tokenizer->attributes != tokenizer->inlineAttributes)
+    {
+        free(tokenizer->attributes);
+    }
+    tokenizer->attributes = tokenizer->inlineAttributes;
+    tokenizer->attributeCapacity = kGHXMLInlineAttributes;
+    free(tokenizer->entities);
+    tokenizer->entities = NULL;
+    tokenizer->entityCount = 0;
+    tokenizer->entityCapacity = 0;
+}
+
+static int AddEntity(GHXMLTokenizer* tokenizer, const char* nameStart, size_t nameLength, const char* valueStart, size_t valueLength)
+{
+    if(tokenizer->entityCount == tokenizer->entityCapacity)
+    {
+        size_t newCapacity = (tokenizer->entityCapacity == 0) ? 8 : 2*tokenizer->entityCapacity;
+        GHXMLEntity* newEntities = (GHXMLEntity*)realloc(tokenizer->entities, newCapacity*sizeof(GHXMLEntity));
+        if(newEntities == NULL)
+        {
+            return 0;
+        }
+        tokenizer->entities = newEntities;
+        tokenizer->entityCapacity = newCapacity;
+    }
+    GHXMLEntity* anEntity = &tokenizer->entities[tokenizer->entityCount++];
+    anEntity->name.start = nameStart;
+    anEntity->name.length = nameLength;
+    anEntity->name.flags = 0;
+    anEntity->value.start = valueStart;
+    anEntity->value.length = valueLength;
+    anEntity->value.flags = FlagsForSpan(valueStart, valueLength, 1);
+    return 1;
+}
+
+static void ReadInternalEntities(GHXMLTokenizer* tokenizer, const char* cursor, const char* end)
+{// <!ENTITY name "value"> in the internal subset, parameter and external entities are left alone
+    while((cursor = FindSequence(cursor, end, "<!ENTITY", 8)) != NULL)
+    {
+        cursor += 8;
+        if(cursor >= end || !IsXMLWhitespace(*cursor))
+        {
+            continue;
+        }
+        while(cursor < end && IsXMLWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(cursor >= end || *cursor == '%')
+        {
+            continue;
+        }
+        const char* nameStart = cursor;
+        while(cursor < end && !IsNameTerminator(*cursor))
+        {
+            cursor++;
+        }
+        const char* nameEnd = cursor;
+        while(cursor < end && IsXMLWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(nameEnd == nameStart || cursor >= end || (*cursor != '"' && *cursor != '\''))
+        {
+            continue;
+        }
+        char quote = *cursor++;
+        const char* valueEnd = (const char*)memchr(cursor, quote, (size_t)(end - cursor));
+        if(valueEnd == NULL)
+        {
+            break;
+        }
+        if(!AddEntity(tokenizer, nameStart, (size_t)(nameEnd - nameStart), cursor, (size_t)(valueEnd - cursor)))
+        {
+            break;
+        }
+        cursor = valueEnd + 1;
+    }
+}
+
+static const char* SkipDeclaration(const char* cursor, const char* end)
+{// <!DOCTYPE ... [ internal subset ] >, returns the location after the closing '>'
+    int bracketDepth = 0;
+    char quote = 0;
+    for(; cursor < end; cursor++)
+    {
+        char aCharacter = *cursor;
+        if(quote != 0)
+        {
+            if(aCharacter == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if(aCharacter == '"' || aCharacter == '\'')
+        {
+            quote = aCharacter;
+        }
+        else if(aCharacter == '[')
+        {
+            bracketDepth++;
+        }
+        else if(aCharacter == ']')
+        {
+            bracketDepth--;
+        }
+        else if(aCharacter == '>' && bracketDepth <= 0)
+        {
+            return cursor + 1;
+        }
+    }
+    return NULL;
+}
+
+static GHXMLTokenType ReadStartElement(GHXMLTokenizer* tokenizer, GHXMLToken* token, const char* cursor, const char* end)
+{
+    const char* nameStart = cursor;
+    while(cursor < end && !IsNameTerminator(*cursor))
+    {
+        cursor++;
+    }
+    if(cursor == nameStart || cursor >= end)
+    {
+        return FailAt(tokenizer, token, nameStart);
+    }
+    token->name.start = nameStart;
+    token->name.length = (size_t)(cursor - nameStart);
+    token->name.flags = 0;
+    
+    size_t attributeCount = 0;
+    for(;;)
+    {
+        while(cursor < end && IsXMLWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(cursor >= end)
+        {
+            return FailAt(tokenizer, token, cursor);
+        }
+        if(*cursor == '>')
+        {
+            cursor++;
+            break;
+        }
+        if(*cursor == '/')
+        {
+            if(cursor + 1 >= end || cursor[1] != '>')
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            token->isEmptyElement = 1;
+            tokenizer->pendingEndElement = 1;
+            tokenizer->pendingEndName = token->name;
+            cursor += 2;
+            break;
+        }
+        
+        const char* attributeNameStart = cursor;
+        while(cursor < end && !IsNameTerminator(*cursor))
+        {
+            cursor++;
+        }
+        const char* attributeNameEnd = cursor;
+        while(cursor < end && IsXMLWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(attributeNameEnd == attributeNameStart || cursor >= end || *cursor != '=')
+        {
+            return FailAt(tokenizer, token, cursor);
+        }
+        cursor++;
+        while(cursor < end && IsXMLWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(cursor >= end || (*cursor != '"' && *cursor != '\''))
+        {
+            return FailAt(tokenizer, token, cursor);
+        }
+        char quote = *cursor++;
+        const char* valueEnd = (const char*)memchr(cursor, quote, (size_t)(end - cursor));
+        if(valueEnd == NULL)
+        {
+            return FailAt(tokenizer, token, attributeNameStart);
+        }
+        if(attributeCount == tokenizer->attributeCapacity)
+        {
+            size_t newCapacity = 2*tokenizer->attributeCapacity;
+            GHXMLAttribute* newAttributes = NULL;
+            if(tokenizer->attributes == tokenizer->inlineAttributes)
+            {
+                newAttributes = (GHXMLAttribute*)malloc(newCapacity*sizeof(GHXMLAttribute));
+                if(newAttributes != NULL)
+                {
+                    memcpy(newAttributes, tokenizer->inlineAttributes, attributeCount*sizeof(GHXMLAttribute));
+                }
+            }
+            else
+            {
+                newAttributes = (GHXMLAttribute*)realloc(tokenizer->attributes, newCapacity*sizeof(GHXMLAttribute));
+            }
+            if(newAttributes == NULL)
+            {
+                return FailAt(tokenizer, token, attributeNameStart);
+            }
+            tokenizer->attributes = newAttributes;
+            tokenizer->attributeCapacity = newCapacity;
+        }
+        
+        GHXMLAttribute* anAttribute = &tokenizer->attributes[attributeCount++];
+        anAttribute->name.start = attributeNameStart;
+        anAttribute->name.length = (size_t)(attributeNameEnd - attributeNameStart);
+        anAttribute->name.flags = 0;
+        anAttribute->value.start = cursor;
+        anAttribute->value.length = (size_t)(valueEnd - cursor);
+        anAttribute->value.flags = FlagsForSpan(cursor, anAttribute->value.length, 1);
+        cursor = valueEnd + 1;
+    }
+    token->type = kGHXMLTokenStartElement;
+    token->attributes = tokenizer->attributes;
+    token->attributeCount = attributeCount;
+    tokenizer->offset = (size_t)(cursor - tokenizer->buffer);
+    return token->type;
+}
+
+GHXMLTokenType GHXMLTokenizerNext(GHXMLTokenizer* tokenizer, GHXMLToken* token)
+{
+    memset(token, 0, sizeof(*token));
+    if(tokenizer->pendingEndElement)
+    {
+        tokenizer->pendingEndElement = 0;
+        token->type = kGHXMLTokenEndElement;
+        token->name = tokenizer->pendingEndName;
+        return token->type;
+    }
+    
+    const char* end = tokenizer->buffer + tokenizer->length;
+    for(;;)
+    {
+        const char* cursor = tokenizer->buffer + tokenizer->offset;
+        if(cursor >= end)
+        {
+            token->type = kGHXMLTokenEndOfDocument;
+            return token->type;
+        }
+        
+        if(*cursor != '<')
+        {
+            const char* textEnd = (const char*)memchr(cursor, '<', (size_t)(end - cursor));
+            if(textEnd == NULL)
+            {
+                textEnd = end;
+            }
+            token->type = kGHXMLTokenText;
+            token->text.start = cursor;
+            token->text.length = (size_t)(textEnd - cursor);
+            token->text.flags = FlagsForSpan(cursor, token->text.length, 0);
+            tokenizer->offset = (size_t)(textEnd - tokenizer->buffer);
+            return token->type;
+        }
+        
+        if(HasPrefix(cursor, end, "<!--", 4))
+        {
+            const char* commentEnd = FindSequence(cursor + 4, end, "-->", 3);
+            if(commentEnd == NULL)
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            tokenizer->offset = (size_t)(commentEnd + 3 - tokenizer->buffer);
+        }
+        else if(HasPrefix(cursor, end, "<![CDATA[", 9))
+        {
+            const char* dataStart = cursor + 9;
+            const char* dataEnd = FindSequence(dataStart, end, "]]>", 3);
+            if(dataEnd == NULL)
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            token->type = kGHXMLTokenCDATA;
+            token->text.start = dataStart;
+            token->text.length = (size_t)(dataEnd - dataStart);
+            tokenizer->offset = (size_t)(dataEnd + 3 - tokenizer->buffer);
+            return token->type;
+        }
+        else if(HasPrefix(cursor, end, "<?", 2))
+        {
+            const char* instructionEnd = FindSequence(cursor + 2, end, "?>", 2);
+            if(instructionEnd == NULL)
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            tokenizer->offset = (size_t)(instructionEnd + 2 - tokenizer->buffer);
+        }
+        else if(HasPrefix(cursor, end, "<!", 2))
+        {
+            const char* declarationEnd = SkipDeclaration(cursor + 2, end);
+            if(declarationEnd == NULL)
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            if(HasPrefix(cursor, declarationEnd, "<!DOCTYPE", 9))
+            {
+                const char* subsetStart = (const char*)memchr(cursor, '[', (size_t)(declarationEnd - cursor));
+                if(subsetStart != NULL)
+                {
+                    ReadInternalEntities(tokenizer, subsetStart + 1, declarationEnd);
+                }
+            }
+            tokenizer->offset = (size_t)(declarationEnd - tokenizer->buffer);
+        }
+        else if(HasPrefix(cursor, end, "</", 2))
+        {
+            const char* nameStart = cursor + 2;
+            const char* nameEnd = nameStart;
+            while(nameEnd < end && !IsNameTerminator(*nameEnd))
+            {
+                nameEnd++;
+            }
+            const char* tagEnd = (nameEnd < end) ? (const char*)memchr(nameEnd, '>', (size_t)(end - nameEnd)) : NULL;
+            if(tagEnd == NULL || nameEnd == nameStart)
+            {
+                return FailAt(tokenizer, token, cursor);
+            }
+            token->type = kGHXMLTokenEndElement;
+            token->name.start = nameStart;
+            token->name.length = (size_t)(nameEnd - nameStart);
+            tokenizer->offset = (size_t)(tagEnd + 1 - tokenizer->buffer);
+            return token->type;
+        }
+        else
+        {
+            return ReadStartElement(tokenizer, token, cursor + 1, end);
+        }
+    }
+}
+
+static size_t AppendUTF8(uint32_t codePoint, char* destination)
+{
+    size_t result = 0;
+    if(codePoint < 0x80)
+    {
+        destination[result++] = (char)codePoint;
+    }
+    else if(codePoint < 0x800)
+    {
+        destination[result++] = (char)(0xC0 | (codePoint >> 6));
+        destination[result++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else if(codePoint < 0x10000)
+    {
+        destination[result++] = (char)(0xE0 | (codePoint >> 12));
+        destination[result++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        destination[result++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        destination[result++] = (char)(0xF0 | (codePoint >> 18));
+        destination[result++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        destination[result++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        destination[result++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+    return result;
+}
+
+static size_t DecodeEntity(const char* start, const char* end, char* destination, size_t* bytesConsumed)
+{// start points just past the '&', returns 0 if not a recognized reference
+    size_t result = 0;
+    const char* semicolon = (const char*)memchr(start, ';', (size_t)(end - start));
+    if(semicolon == NULL || semicolon - start > 10)
+    {
+        return 0;
+    }
+    size_t nameLength = (size_t)(semicolon - start);
+    if(nameLength >= 2 && start[0] == '#')
+    {
+        uint32_t codePoint = 0;
+        int isHex = (start[1] == 'x' || start[1] == 'X');
+        const char* digit = start + (isHex ? 2 : 1);
+        if(digit == semicolon)
+        {
+            return 0;
+        }
+        for(; digit < semicolon; digit++)
+        {
+            char aCharacter = *digit;
+            uint32_t value;
+            if(aCharacter >= '0' && aCharacter <= '9')
+            {
+                value = (uint32_t)(aCharacter - '0');
+            }
+            else if(isHex && aCharacter >= 'a' && aCharacter <= 'f')
+            {
+                value = (uint32_t)(aCharacter - 'a' + 10);
+            }
+            else if(isHex && aCharacter >= 'A' && aCharacter <= 'F')
+            {
+                value = (uint32_t)(aCharacter - 'A' + 10);
+            }
+            else
+            {
+                return 0;
+            }
+            codePoint = codePoint * (isHex ? 16 : 10) + value;
+        }
+        if(codePoint == 0 || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            return 0;
+        }
+        result = AppendUTF8(codePoint, destination);
+    }
+    else if(nameLength == 2 && memcmp(start, "lt", 2) == 0)
+    {
+        destination[result++] = '<';
+    }
+    else if(nameLength == 2 && memcmp(start, "gt", 2) == 0)
+    {
+        destination[result++] = '>';
+    }
+    else if(nameLength == 3 && memcmp(start, "amp", 3) == 0)
+    {
+        destination[result++] = '&';
+    }
+    else if(nameLength == 4 && memcmp(start, "quot", 4) == 0)
+    {
+        destination[result++] = '"';
+    }
+    else if(nameLength == 4 && memcmp(start, "apos", 4) == 0)
+    {
+        destination[result++] = '\'';
+    }
+    if(result)
+    {
+        *bytesConsumed = nameLength + 1;
+    }
+    return result;
+}
+
+static const GHXMLEntity* FindEntity(const GHXMLTokenizer* tokenizer, const char* start, const char* end, size_t* bytesConsumed)
+{// start points just past the '&'
+    const GHXMLEntity* result = NULL;
+    if(tokenizer != NULL && tokenizer->entityCount > 0)
+    {
+        const char* semicolon = (const char*)memchr(start, ';', (size_t)(end - start));
+        if(semicolon != NULL)
+        {
+            size_t nameLength = (size_t)(semicolon - start);
+            for(size_t index = 0; index < tokenizer->entityCount; index++)
+            {
+                const GHXMLEntity* anEntity = &tokenizer->entities[index];
+                if(anEntity->name.length == nameLength && memcmp(anEntity->name.start, start, nameLength) == 0)
+                {
+                    result = anEntity;
+                    *bytesConsumed = nameLength + 1;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static size_t DecodeInto(const GHXMLTokenizer* tokenizer, GHXMLSpan span, int isAttributeValue, char* destination, size_t capacity)
+{// counts every byte but only writes those that fit
+    size_t result = 0;
+    const char* cursor = span.start;
+    const char* end = span.start + span.length;
+    while(cursor < end)
+    {
+        char aCharacter = *cursor++;
+        char decoded[4];
+        size_t decodedLength = 1;
+        decoded[0] = aCharacter;
+        if(aCharacter == '&')
+        {
+            size_t bytesConsumed = 0;
+            size_t bytesWritten = DecodeEntity(cursor, end, decoded, &bytesConsumed);
+            const GHXMLEntity* anEntity = NULL;
+            if(bytesWritten)
+            {
+                decodedLength = bytesWritten;
+                cursor += bytesConsumed;
+            }
+            else if((anEntity = FindEntity(tokenizer, cursor, end, &bytesConsumed)) != NULL)
+            {// declared entities are only expanded one level deep, which rules out runaway expansion
+                size_t offset = (result < capacity) ? result : capacity;
+                result += DecodeInto(NULL, anEntity->value, isAttributeValue, destination + offset, capacity - offset);
+                cursor += bytesConsumed;
+                continue;
+            }
+            // otherwise not a reference we know, leave it be
+        }
+        else if(aCharacter == '\r')
+        {
+            if(cursor < end && *cursor == '\n')
+            {
+                cursor++;
+            }
+            decoded[0] = isAttributeValue ? ' ' : '\n';
+        }
+        else if(isAttributeValue && (aCharacter == '\n' || aCharacter == '\t'))
+        {
+            decoded[0] = ' ';
+        }
+        for(size_t index = 0; index < decodedLength; index++, result++)
+        {
+            if(result < capacity)
+            {
+                destination[result] = decoded[index];
+            }
+        }
+    }
+    return result;
+}
+
+size_t GHXMLDecodeSpan(GHXMLSpan span, int isAttributeValue, char* destination)
+{
+    return DecodeInto(NULL, span, isAttributeValue, destination, span.length);
+}
+
+size_t GHXMLTokenizerDecodeSpan(const GHXMLTokenizer* tokenizer, GHXMLSpan span, int isAttributeValue, char* destination, size_t capacity)
+{
+    return DecodeInto(tokenizer, span, isAttributeValue, destination, capacity);
+}
@@ -0,0 +1,158 @@
+//
+//  GHXMLTokenizer.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+// A small pull tokenizer for XML held in memory, written in plain C so it can be fuzzed and benchmarked without Foundation.
+// Tokens refer to spans of the original buffer, nothing is allocated or copied while tokenizing.
+
+#ifndef GHXMLTokenizer_h
+#define GHXMLTokenizer_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief how many attributes an element can have before the tokenizer has to allocate room for more
+*/
+#define kGHXMLInlineAttributes 32
+
+/*! @brief span flags, set when a span needs to be passed through GHXMLDecodeSpan before use
+*/
+enum
+{
+    kGHXMLSpanHasEntities = 1 << 0, // contains '&'
+    kGHXMLSpanHasLineBreaks = 1 << 1, // contains '\r', or for attributes '\t', '\n', '\r' which normalize to spaces
+};
+
+typedef enum GHXMLTokenType
+{
+    kGHXMLTokenEndOfDocument = 0,
+    kGHXMLTokenStartElement,
+    kGHXMLTokenEndElement,
+    kGHXMLTokenText,
+    kGHXMLTokenCDATA,
+    kGHXMLTokenError
+} GHXMLTokenType;
+
+/*! @brief a range of bytes inside the tokenizer's buffer
+*/
+typedef struct GHXMLSpan
+{
+    const char* start;
+    size_t      length;
+    uint32_t    flags;
+} GHXMLSpan;
+
+typedef struct GHXMLAttribute
+{
+    GHXMLSpan   name;
+    GHXMLSpan   value;
+} GHXMLAttribute;
+
+/*! @brief a general entity declared in the DOCTYPE's internal subset, as in <!ENTITY ns_svg "http://www.w3.org/2000/svg">
+*/
+typedef struct GHXMLEntity
+{
+    GHXMLSpan   name;
+    GHXMLSpan   value;
+} GHXMLEntity;
+
+/*! @brief the result of GHXMLTokenizerNext. name is set for start and end elements, text for text and CDATA.
+* attributes points into the tokenizer and is only valid until the next call.
+*/
+typedef struct GHXMLToken
+{
+    GHXMLTokenType          type;
+    GHXMLSpan               name;
+    GHXMLSpan               text;
+    const GHXMLAttribute*   attributes;
+    size_t                  attributeCount;
+    int                     isEmptyElement; // <path/>, an end element token will follow
+} GHXMLToken;
+
+/*! @brief tokenizer state, set up by GHXMLTokenizerInit and released by GHXMLTokenizerFinish. Not to be copied, attributes may point into it.
+*/
+typedef struct GHXMLTokenizer
+{
+    const char*     buffer;
+    size_t          length;
+    size_t          offset;
+    size_t          errorOffset;
+    int             pendingEndElement;
+    GHXMLSpan       pendingEndName;
+    GHXMLAttribute* attributes; // inlineAttributes until an element has more
+    size_t          attributeCapacity;
+    GHXMLEntity*    entities;
+    size_t          entityCount;
+    size_t          entityCapacity;
+    GHXMLAttribute  inlineAttributes[kGHXMLInlineAttributes];
+} GHXMLTokenizer;
+
+/*! @brief prepare to tokenize a buffer, which must stay valid while tokens are in use. A UTF-8 byte order mark is skipped.
+* @param tokenizer the tokenizer to setup
+* @param buffer UTF-8 encoded XML, need not be NUL terminated
+* @param length number of bytes in buffer
+*/
+void GHXMLTokenizerInit(GHXMLTokenizer* tokenizer, const char* buffer, size_t length);
+
+/*! @brief release whatever the tokenizer allocated for elements with many attributes, or for entity declarations
+* @param tokenizer a tokenizer setup by GHXMLTokenizerInit
+*/
+void GHXMLTokenizerFinish(GHXMLTokenizer* tokenizer);
+
+/*! @brief advance to the next token. Comments, processing instructions and DOCTYPE declarations are skipped, after noting the general entities declared in the DOCTYPE's internal subset.
+* @param tokenizer the tokenizer
+* @param token filled in with the next token
+* @return the type of the token, kGHXMLTokenError if the markup is malformed, in which case errorOffset is set
+*/
+GHXMLTokenType GHXMLTokenizerNext(GHXMLTokenizer* tokenizer, GHXMLToken* token);
+
+/*! @brief decode the character and predefined entity references in a span, and normalize its line breaks
+* @param span a span with kGHXMLSpanHasEntities or kGHXMLSpanHasLineBreaks set
+* @param isAttributeValue attribute values have tabs and line breaks turned into spaces, text only has "\r\n" and "\r" turned into "\n"
+* @param destination receives the decoded bytes, must have room for span.length bytes (decoding never lengthens a span)
+* @return the number of bytes written to destination
+*/
+size_t GHXMLDecodeSpan(GHXMLSpan span, int isAttributeValue, char* destination);
+
+/*! @brief like GHXMLDecodeSpan but also expands the entities declared in the document's internal subset, which can lengthen the span. Their replacement text is treated as character data.
+* @param tokenizer the tokenizer the span came from
+* @param span a span with kGHXMLSpanHasEntities or kGHXMLSpanHasLineBreaks set
+* @param isAttributeValue as for GHXMLDecodeSpan
+* @param destination receives up to capacity decoded bytes
+* @param capacity the room in destination
+* @return the decoded length, if more than capacity the caller should make more room and decode again
+*/
+size_t GHXMLTokenizerDecodeSpan(const GHXMLTokenizer* tokenizer, GHXMLSpan span, int isAttributeValue, char* destination, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GHXMLTokenizer_h */
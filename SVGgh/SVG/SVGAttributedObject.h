@@ -36,9 +36,15 @@
 #import "GHAttributedObject.h"
 #import "GHRenderable.h"
 #import "GHCSSStyle.h"
+#import "GHCSSStyleSheet.h"
+
+@class GHPathMeasure;
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class GHComputedStyle;
+@class GHDisplayList;
+
 /*! @brief base object for objects defined in an SVG document
 */
 @interface SVGAttributedObject : GHAttributedObject
@@ -76,6 +82,11 @@ NS_ASSUME_NONNULL_BEGIN
 -(nullable UIColor*) asColorWithSVGContext:(id<SVGContext>)svgContext;
 @end
 
+/*! @brief a count bumped whenever a renderable object's transform or fillColor is set after parsing
+* @return compare against an earlier value to know whether display lists and hit testing built from a document need rebuilding
+*/
+NSUInteger GHRenderableObjectMutationGeneration(void);
+
 /*! @brief an abstract object which implements the GHRenderable protocol
 * @see GHRenderable
 */
@@ -99,6 +110,13 @@ NS_ASSUME_NONNULL_BEGIN
 */
 +(void) setupContext:(CGContextRef)quartzContext withAttributes:(nullable NSDictionary*)attributes withSVGContext:(id<SVGContext>)svgContext;
 
+/*! @brief record what setupContext:withAttributes:withSVGContext: would do
+* @param attributes a collection of attributes
+* @param displayList the list being compiled
+* @param svgContext a state object needed to retrieve some properties not explicitly set in the provided attributes
+*/
++(void) compileSetupWithAttributes:(nullable NSDictionary*)attributes intoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext;
+
 /*! @brief retrieve a bounding box for an object. As sometimes an objects bounds are given in terms of its parent, provided the parent bounds
 * @param anObject object to test
 * @param svgContext a state object needed to retrieve some properties not explicitly set in the provided attributes
@@ -112,12 +130,30 @@ NS_ASSUME_NONNULL_BEGIN
 */
 -(BOOL)	hitTest:(CGPoint) testPoint;
 
-/*! @brief a style attribute might have to be extracted from a 'style' attribute which can and usually will contain multiple attributes bundled together
+/*! @brief a style attribute might have to be extracted from a 'style' attribute which can and usually will contain multiple attributes bundled together. The 'style' attribute wins over the style sheet's cascadedStyle, which wins over a presentation attribute
 * @param attributeName attribute to search for in this object's attributes
 * @return the value of the attribute if it exists
 */
 -(nullable NSString*) valueForStyleAttribute:(NSString*)attributeName   withSVGContext:(nullable id<SVGContext> )svgContext;
 
+/*! @brief as valueForStyleAttribute:withSVGContext: but looked up by atom rather than by name
+* @param atom attribute to search for in this object's attributes
+* @return the value of the attribute if it exists
+*/
+-(nullable NSString*) valueForStyleAtom:(GHAttributeAtom)atom withSVGContext:(nullable id<SVGContext> )svgContext;
+
+/*! @brief this object's style resolved into typed values, made the first time it's asked for and again only when the svgContext's styleGeneration changes
+* @param svgContext supplies colors, referenced gradients and clip paths, and the styleGeneration
+* @return the computed style, which is immutable
+*/
+-(GHComputedStyle*) computedStyleWithSVGContext:(id<SVGContext>)svgContext;
+
+/*! @brief record this object's drawing into a display list, by default as a deferred call to renderIntoContext:withSVGContext:. Subclasses which can be drawn with plain Quartz operations record those instead
+* @param displayList the list being compiled
+* @param svgContext the state this object would be rendered with
+*/
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext;
+
 /*! @brief sometimes objects are referenced internally in a document by name, this adds them to a map to keep track of
 * @param namedObjectsMap a collection of objects to add
 */
@@ -141,6 +177,12 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly)         BOOL			isClosed;
 @property (nonatomic, readonly)         BOOL            isFillable;
 @property (nonatomic, readonly)          CGPathRef	__nullable	quartzPath;
+/*! @property pathBoundingBox the tight bounds of quartzPath in the shape's own coordinates, curve extrema rather than control points. Calculated once and kept.
+*/
+@property (nonatomic, readonly)          CGRect          pathBoundingBox;
+/*! @property pathMeasure the arc-length table of quartzPath, for finding points a distance along it. Measured on first use and kept with the shape.
+*/
+@property (nonatomic, readonly)          GHPathMeasure* __nullable pathMeasure;
 @end
 
 /*! @brief manifestation of an SVG 'ellipse' entity
@@ -191,6 +233,68 @@ NS_ASSUME_NONNULL_BEGIN
 */
 @property (copy, nonatomic)  NSArray* __nullable  childDefinitions;
 
+/*! @brief init method for a group whose children have already been created, as when built directly by the parser
+* @param theAttributes the group's own attributes
+* @param children already instantiated children, with any inherited attributes already applied
+*/
+-(instancetype) initWithAttributes:(NSDictionary*)theAttributes children:(NSArray*)children;
+
+/*! @brief init method for a group whose children have already been created and whose transform has been calculated ahead of time
+* @param theAttributes the group's own attributes
+* @param children already instantiated children, with any inherited attributes already applied
+* @param resolvedTransform an NSValue wrapping the group's CGAffineTransform, if nil it will be calculated from the attributes
+*/
+-(instancetype) initWithAttributes:(NSDictionary*)theAttributes children:(NSArray*)children resolvedTransform:(nullable NSValue*)resolvedTransform;
+
+/*! @brief what a group passes down to its children, made once per group and shared by every child rather than merged into each. A group which sets nothing inheritable passes on what it was given
+* @param groupAttributes the attributes of the group
+* @param inheritedFontAttributes if not NULL, gets the same plus the group's font attributes, for children which are themselves groups or text
+* @return the inherited attributes, nil if there are none
+*/
++(nullable NSDictionary*) inheritedAttributesOfGroupWithAttributes:(nullable NSDictionary*)groupAttributes fontAttributes:(NSDictionary* __nullable * __nullable)inheritedFontAttributes;
+
+/*! @brief the attributes of a child entity, looking up through to what it inherits from its group
+* @param elementName the child's entity name ('g', 'text', 'switch' inherit font attributes)
+* @param childsAttributes the attributes given in the child's definition
+* @param inheritedAttributes from inheritedAttributesOfGroupWithAttributes:fontAttributes:
+* @param inheritedFontAttributes the font attributes from the same call
+* @return an attribute table holding only childsAttributes and a reference to the inherited set, or childsAttributes itself if nothing is inherited
+*/
++(nullable NSDictionary*) attributesForChildNamed:(nullable NSString*)elementName withAttributes:(nullable NSDictionary*)childsAttributes
+                              inheritedAttributes:(nullable NSDictionary*)inheritedAttributes inheritedFontAttributes:(nullable NSDictionary*)inheritedFontAttributes;
+
+/*! @brief the attributes of a child entity once the attributes it inherits from its group have been applied
+* @param elementName the child's entity name ('g', 'text', 'switch' also inherit font attributes)
+* @param childsAttributes the attributes given in the child's definition
+* @param groupsSharedAttributes the inheritable attributes of the parent group
+* @param groupsFontAttributes the font attributes of the parent group
+* @return the child's effective attributes, which may be childsAttributes itself if nothing was inherited
+*/
++(nullable NSDictionary*) attributesForChildNamed:(nullable NSString*)elementName withAttributes:(nullable NSDictionary*)childsAttributes
+                                 sharedAttributes:(NSDictionary*)groupsSharedAttributes fontAttributes:(NSDictionary*)groupsFontAttributes;
+
+/*! @brief factory for the child objects of a group
+* @param elementName the name of the XML element, which is looked up in nameToClassMap
+* @param aDefinition the intermediate dictionary definition of the element
+* @return a new SVGAttributedObject or nil if the element is not supported
+*/
++(nullable id) newChildNamed:(NSString*)elementName withDefinition:(NSDictionary*)aDefinition;
+
+/*! @brief the mapping from XML element names to the classes which implement them
+*/
++(NSDictionary*) nameToClassMap;
+
+/*! @brief the attributes of a group that its children inherit (fill, stroke, color, opacities...)
+* @param groupAttributes the attributes of the group
+*/
++(NSDictionary*) attributesSharedWithChildrenOfGroupWithAttributes:(nullable NSDictionary*)groupAttributes;
+
+/*! @brief record the group and its visible children into a display list, the equivalent of renderIntoContext:withSVGContext:
+* @param displayList the list being compiled
+* @param svgContext the state the group would be rendered with
+*/
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext;
+
 -(void) addNamedObjects:(NSMutableDictionary*)namedObjectsMap;
 @end
 
@@ -211,6 +315,7 @@ NS_ASSUME_NONNULL_BEGIN
 @interface GHStyle : SVGAttributedObject
 @property (nonatomic, readonly)  StyleElementType styleType;
 @property(nonatomic, readonly) NSDictionary<NSString*, GHCSSStyle*>* classes;
+@property(nonatomic, readonly) GHCSSStyleSheet* styleSheet;
 @end
 
 /*! @brief manifestation of an SVG 'clipPath' entity
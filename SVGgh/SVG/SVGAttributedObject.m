@@ -32,9 +32,15 @@
 #import "SVGRenderer.h"
 #import "GHGradient.h"
 #import "SVGPathGenerator.h"
+#import "GHPathCache.h"
+#import "SVGPathBuffer.h"
 #import "GHText.h"
 #import "SVGTextUtilities.h"
 #import "CrossPlatformImage.h"
+#import "GHComputedStyle.h"
+#import "GHDisplayList.h"
+#import "GHPathUtilities.h"
+#include <stdatomic.h>
 
 @interface GHAttributedObject(SVGRenderer)
 
@@ -46,8 +52,20 @@
 @private
     CGAffineTransform	transform;
 }
+@property(atomic, strong) GHComputedStyle* computedStyle; // atomic as several threads might be rendering the same document
 @end
 
+static BOOL GetResolvedTransform(NSDictionary* theDefinition, CGAffineTransform* transformPtr)
+{// precompiled documents carry their transforms already parsed
+    NSValue* resolvedTransform = [theDefinition objectForKey:kResolvedTransformElementName];
+    BOOL result = resolvedTransform != nil;
+    if(result)
+    {
+        [resolvedTransform getValue:transformPtr];
+    }
+    return result;
+}
+
 
 @implementation GHAttributedObject(Prototyping)
 +(NSDictionary*) overideObjectsForPrototype:(id<GHAttributedObjectProtocol>)prototype withDictionary:(NSDictionary*)deltaDictionary
@@ -57,7 +75,7 @@
     {
         NSDictionary* oldAttributes = (NSDictionary*)[prototype attributes];
         NSMutableDictionary* newAttributesMutable = [[NSMutableDictionary alloc] initWithCapacity:[deltaDictionary count]+[oldAttributes count]];
-        NSString* oldXLink = [oldAttributes objectForKey:@"xlink:href"];
+        NSString* oldXLink = [oldAttributes objectForAtom:kGHAttributeXLinkHRef];
         if([oldAttributes count])
         {
             [newAttributesMutable addEntriesFromDictionary:oldAttributes];
@@ -89,7 +107,7 @@
                 }
             }
         }
-        NSString* oldStyleString = [oldAttributes objectForKey:@"style"];
+        NSString* oldStyleString = [oldAttributes objectForAtom:kGHAttributeStyle];
         NSString* newStyleString = [deltaDictionary objectForKey:@"style"];
         
         if([oldStyleString length] && [newStyleString length])
@@ -124,59 +142,185 @@
 {
     NSDictionary* newDefinition = [[self class] overideObjectsForPrototype:self withDictionary:overrideAttributes];
     id result = [[[self class] alloc] initWithDictionary:newDefinition];
+    [result setCascadedStyle:self.cascadedStyle]; // style sheet selectors match the prototype where it sits in the document
+    [result setImportantStyle:self.importantStyle];
     
     return result;
 }
 
 @end
 
+static atomic_ulong sRenderableObjectMutationGeneration = 0;
+
+NSUInteger GHRenderableObjectMutationGeneration(void)
+{
+    return (NSUInteger)atomic_load(&sRenderableObjectMutationGeneration);
+}
+
 @implementation GHRenderableObject
 @synthesize transform, fillColor=_fillColor;
 
+-(void) setTransform:(CGAffineTransform)newTransform
+{// display lists copy the transform when compiled, so tell them to compile again
+    transform = newTransform;
+    atomic_fetch_add(&sRenderableObjectMutationGeneration, 1);
+}
+
+-(void) setFillColor:(UIColor *)fillColor
+{
+    _fillColor = [fillColor copy];
+    atomic_fetch_add(&sRenderableObjectMutationGeneration, 1);
+}
+
 +(void) setupContext:(CGContextRef)quartzContext withAttributes:(NSDictionary*)attributes withSVGContext:(id<SVGContext>)svgContext
 {
-    NSString*	strokeString = [SVGToQuartz valueForStyleAttribute:@"stroke-width" fromDefinition:attributes];
-    NSString* vectorEffect = [SVGToQuartz valueForStyleAttribute:@"vector-effect" fromDefinition:attributes];
+    NSString*	strokeString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeWidth fromDefinition:attributes];
+    NSString* vectorEffect = [SVGToQuartz valueForStyleAtom:kGHAttributeVectorEffect fromDefinition:attributes];
     
     [SVGToQuartz setupLineWidthForQuartzContext:quartzContext withSVGStrokeString:strokeString withVectorEffect:vectorEffect withSVGContext:svgContext];
     
-    NSString*	miterLimitString = [SVGToQuartz valueForStyleAttribute:@"stroke-miterlimit" fromDefinition:attributes];
+    NSString*	miterLimitString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeMiterLimit fromDefinition:attributes];
     [SVGToQuartz setupMiterLimitForQuartzContext:quartzContext withSVGMiterLimitString:miterLimitString];
     
-    NSString*	lineJoinString = [SVGToQuartz valueForStyleAttribute:@"stroke-linejoin" fromDefinition:attributes];
+    NSString*	lineJoinString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeLineJoin fromDefinition:attributes];
     [SVGToQuartz setupMiterForQuartzContext:quartzContext withSVGMiterString:lineJoinString];
     
     
-    NSString*	lineCapString = [SVGToQuartz valueForStyleAttribute:@"stroke-linecap" fromDefinition:attributes];
+    NSString*	lineCapString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeLineCap fromDefinition:attributes];
     [SVGToQuartz setupLineEndForQuartzContext:quartzContext withSVGLineEndString:lineCapString];
     
-    NSString*	strokeDashString = [[SVGToQuartz valueForStyleAttribute:@"stroke-dasharray" fromDefinition:attributes]
+    NSString*	strokeDashString = [[SVGToQuartz valueForStyleAtom:kGHAttributeStrokeDashArray fromDefinition:attributes]
                                     stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
     
-    NSString*	phaseString = [SVGToQuartz valueForStyleAttribute:@"stroke-dashoffset" fromDefinition:attributes];
+    NSString*	phaseString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeDashOffset fromDefinition:attributes];
     [SVGToQuartz setupLineDashForQuartzContext:quartzContext withSVGDashArray:(NSString*)strokeDashString andPhase:phaseString];
     
-    NSString* colorString = [attributes objectForKey:@"color"];
+    NSString* colorString = [attributes objectForAtom:kGHAttributeColor];
     [SVGToQuartz setupColorForQuartzContext:quartzContext withColorString:colorString withSVGContext:svgContext];
     
-    NSString* opacityString = [SVGToQuartz valueForStyleAttribute:@"opacity" fromDefinition:attributes];
+    NSString* opacityString = [SVGToQuartz valueForStyleAtom:kGHAttributeOpacity fromDefinition:attributes];
     if(opacityString.length)
     {
         [SVGToQuartz setupOpacityForQuartzContext:quartzContext withSVGOpacity:opacityString withSVGContext:svgContext];
     }
 
-    NSString* blendString = [SVGToQuartz valueForStyleAttribute:@"mix-blend-mode" fromDefinition:attributes];
+    NSString* blendString = [SVGToQuartz valueForStyleAtom:kGHAttributeMixBlendMode fromDefinition:attributes];
     [SVGToQuartz setupBlendModeForQuartzContext:quartzContext withBlendModeString:blendString];
 }
 
++(void) compileSetupWithAttributes:(NSDictionary*)attributes intoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{// the strings are parsed just as setupContext:withAttributes:withSVGContext: parses them
+    NSString*	strokeString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeWidth fromDefinition:attributes];
+    if(strokeString != nil)
+    {
+        NSString* vectorEffect = [SVGToQuartz valueForStyleAtom:kGHAttributeVectorEffect fromDefinition:attributes];
+        if([vectorEffect isEqualToString:@"non-scaling-stroke"])
+        {
+            [displayList setNonScalingLineWidth:[strokeString floatValue]];
+        }
+        else
+        {
+            [displayList setLineWidth:[strokeString floatValue]];
+        }
+    }
+    
+    NSString*	miterLimitString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeMiterLimit fromDefinition:attributes];
+    if(miterLimitString != nil)
+    {
+        [displayList setMiterLimit:[miterLimitString floatValue]];
+    }
+    
+    NSString*	lineJoinString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeLineJoin fromDefinition:attributes];
+    if(lineJoinString.length)
+    {
+        [displayList setLineJoin:[lineJoinString isEqualToString:@"round"] ? kCGLineJoinRound
+                                    : ([lineJoinString isEqualToString:@"bevel"] ? kCGLineJoinBevel : kCGLineJoinMiter)];
+    }
+    
+    NSString*	lineCapString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeLineCap fromDefinition:attributes];
+    if(lineCapString != nil)
+    {
+        [displayList setLineCap:[lineCapString isEqualToString:@"round"] ? kCGLineCapRound
+                                    : ([lineCapString isEqualToString:@"square"] ? kCGLineCapSquare : kCGLineCapButt)];
+    }
+    
+    NSString*	strokeDashString = [[SVGToQuartz valueForStyleAtom:kGHAttributeStrokeDashArray fromDefinition:attributes]
+                                    stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    if(strokeDashString != nil)
+    {
+        if([strokeDashString isEqualToString:@"none"] || [strokeDashString isEqualToString:@"0"])
+        {
+            [displayList setLineDashPhase:0.0 lengths:NULL count:0];
+        }
+        else
+        {
+            NSArray* dashElements = [strokeDashString componentsSeparatedByString:@","];
+            if(dashElements.count & 1)
+            { // double it to make it even
+                dashElements = [dashElements arrayByAddingObjectsFromArray:dashElements];
+            }
+            NSUInteger countOfElements = dashElements.count;
+            CGFloat* dashes = malloc(sizeof(CGFloat)*countOfElements);
+            for(NSUInteger index = 0; index < countOfElements; index++)
+            {
+                dashes[index] = [[dashElements[index] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] floatValue];
+            }
+            NSString* phaseString = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeDashOffset fromDefinition:attributes];
+            [displayList setLineDashPhase:[phaseString floatValue] lengths:dashes count:countOfElements];
+            free(dashes);
+        }
+    }
+    
+    NSString* colorString = [attributes objectForAtom:kGHAttributeColor];
+    if([colorString length])
+    {
+        UIColor* colorToUse = nil;
+        if(IsStringURL(colorString))
+        {
+            id aColor = [svgContext objectAtURL:colorString];
+            if([aColor isKindOfClass:[GHSolidColor class]])
+            {
+                colorToUse = [(GHSolidColor*)aColor asColorWithSVGContext:svgContext];
+            }
+        }
+        else
+        {
+            colorToUse = [svgContext colorForSVGColorString:colorString];
+        }
+        if(colorToUse != nil)
+        {
+            [displayList setFillColor:colorToUse.CGColor];
+            [displayList setStrokeColor:colorToUse.CGColor];
+        }
+    }
+    
+    NSString* opacityString = [SVGToQuartz valueForStyleAtom:kGHAttributeOpacity fromDefinition:attributes];
+    if(opacityString.length && ![opacityString isEqualToString:@"none"])
+    {
+        CGFloat	opacity = [opacityString isEqualToString:@"inherit"] ? svgContext.opacity : [opacityString floatValue];
+        if(opacity >= 0 && opacity < 1.0)
+        {
+            [displayList setAlpha:opacity];
+            svgContext.opacity = opacity;
+        }
+    }
+    
+    NSString* blendString = [SVGToQuartz valueForStyleAtom:kGHAttributeMixBlendMode fromDefinition:attributes];
+    NSNumber* blendModeNumber = (blendString == nil) ? nil : stringToBlendMode()[blendString];
+    if(blendModeNumber != nil)
+    {
+        [displayList setBlendMode:(CGBlendMode)blendModeNumber.intValue];
+    }
+}
+
 
 +(CGRect) boundingBoxForRenderableObject:(id<GHRenderable>)anObject withSVGContext:(id<SVGContext>) svgContext givenParentObjectsBounds:(CGRect)parentBounds
 {
     CGRect result = [anObject getBoundingBoxWithSVGContext:svgContext];
     if(!CGRectIsEmpty(parentBounds))
     {
-        if([[[anObject attributes] objectForKey:@"clipPathUnits"] isEqualToString:@"objectBoundingBox"]
-           || [[[anObject attributes] objectForKey:@"maskContentUnits"] isEqualToString:@"objectBoundingBox"])
+        if([[[anObject attributes] objectForAtom:kGHAttributeClipPathUnits] isEqualToString:@"objectBoundingBox"]
+           || [[[anObject attributes] objectForAtom:kGHAttributeMaskContentUnits] isEqualToString:@"objectBoundingBox"])
         {
             CGAffineTransform mappingTransform = CGAffineTransformMakeTranslation(parentBounds.origin.x,
                                                                                   parentBounds.origin.y);
@@ -187,9 +331,42 @@
     return result;
 }
 
+-(BOOL) isFilledByDefault
+{
+    return YES;
+}
+
+-(GHComputedStyle*) computedStyleWithSVGContext:(id<SVGContext>)svgContext
+{
+    GHComputedStyle* result = self.computedStyle;
+    if(result == nil || result.generation != svgContext.styleGeneration)
+    {
+        result = [[GHComputedStyle alloc] initWithRenderableObject:self fillable:[self isFilledByDefault] withSVGContext:svgContext];
+        self.computedStyle = result;
+    }
+    return result;
+}
+
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{// text and the like still draw themselves, when the list is replayed
+    [displayList renderObject:self withSVGContext:svgContext];
+}
+
 -(void) setupContext:(CGContextRef)quartzContext withAttributes:(NSDictionary*)attributes withSVGContext:(id<SVGContext>)svgContext
 {
-    id newDefaultColor = [attributes objectForKey:@"color"];
+    if(attributes == self.attributes)
+    {// the usual case, where no strings need to be parsed
+        GHComputedStyle* computedStyle = [self computedStyleWithSVGContext:svgContext];
+        [computedStyle applyToContext:quartzContext withSVGContext:svgContext];
+        id clippingObject = computedStyle.resolvedStyle->clip;
+        if(clippingObject != nil)
+        {
+            CGRect myBoundingBox = [self getBoundingBoxWithSVGContext:svgContext];
+            [clippingObject addToClipForContext:quartzContext  withSVGContext:svgContext objectBoundingBox:myBoundingBox];
+        }
+        return;
+    }
+    id newDefaultColor = [attributes objectForAtom:kGHAttributeColor];
     
     if([newDefaultColor isKindOfClass:[NSString class]])
     {
@@ -222,14 +399,14 @@
 
 -(void) addNamedObjects:(NSMutableDictionary*)namedObjectsMap
 {
-    NSString* myName = [self.attributes objectForKey:@"id"];
+    NSString* myName = [self.attributes objectForAtom:kGHAttributeID];
     if([myName isKindOfClass:[NSString class]] && [myName length])
     {
         [namedObjectsMap  setValue:self forKey:myName];
     }
     else
     {
-        myName = [self.attributes objectForKey:@"xml:id"];
+        myName = [self.attributes objectForAtom:kGHAttributeXMLID];
         if([myName isKindOfClass:[NSString class]] && [myName length])
         {
             [namedObjectsMap  setValue:self forKey:myName];
@@ -239,13 +416,45 @@
 
 -(NSString*) valueForStyleAttribute:(NSString*)attributeName   withSVGContext:(id<SVGContext>)svgContext
 {
-    NSString* result = [SVGToQuartz valueForStyleAttribute:attributeName fromDefinition:self.attributes];
+    NSString* result = [self.importantStyle objectForKey:attributeName];
+    NSDictionary* cascadedStyle = self.cascadedStyle;
+    if(result == nil && cascadedStyle.count)
+    {
+        result = [self.attributes styleValueForName:attributeName];
+        if(result == nil || [result isEqualToString:@"inherit"])
+        {
+            result = [cascadedStyle objectForKey:attributeName] ?: result;
+        }
+    }
+    if(result == nil || [result isEqualToString:@"inherit"])
+    {
+        result = [SVGToQuartz valueForStyleAttribute:attributeName fromDefinition:self.attributes];
+    }
+    return result;
+}
+
+-(NSString*) valueForStyleAtom:(GHAttributeAtom)atom withSVGContext:(id<SVGContext>)svgContext
+{
+    NSString* result = [self.importantStyle objectForAtom:atom];
+    NSDictionary* cascadedStyle = self.cascadedStyle;
+    if(result == nil && cascadedStyle.count)
+    {// !important style sheet declarations, then inline style, then the style sheet, then presentation attributes
+        result = [self.attributes styleValueForAtom:atom];
+        if(result == nil || [result isEqualToString:@"inherit"])
+        {
+            result = [cascadedStyle objectForAtom:atom] ?: result;
+        }
+    }
+    if(result == nil || [result isEqualToString:@"inherit"])
+    {
+        result = [SVGToQuartz valueForStyleAtom:atom fromDefinition:self.attributes];
+    }
     return result;
 }
 
 -(NSString*) defaultFillColor
 {
-    NSString* result = [self valueForStyleAttribute:@"fill" withSVGContext:nil];
+    NSString* result = [self valueForStyleAtom:kGHAttributeFill withSVGContext:nil];
     if([result length] == 0)
     {
         result = kBlackInHex;
@@ -257,8 +466,11 @@
 {
     if(nil != (self = [super initWithDictionary:theDefinition]))
     {
-        NSString*	transformAttribute = [self.attributes objectForKey:@"transform"];
-        transform = SVGTransformToCGAffineTransform(transformAttribute);
+        if(!GetResolvedTransform(theDefinition, &transform))
+        {
+            NSString*	transformAttribute = [self.attributes objectForAtom:kGHAttributeTransform];
+            transform = SVGTransformToCGAffineTransform(transformAttribute);
+        }
     }
     return self;
 }
@@ -325,8 +537,8 @@
     if(result == nil && !loaded)
     {
         loaded = YES;
-        NSString* reference = [self.attributes objectForKey:@"xlink:href"];
-        NSString* basePath = [self.attributes objectForKey:@"xml:base"];
+        NSString* reference = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
+        NSString* basePath = [self.attributes objectForAtom:kGHAttributeXMLBase];
         if([basePath length])
         {
             reference = [basePath stringByAppendingPathComponent:reference];
@@ -385,7 +597,7 @@
 {
     id result = nil;
     NSDictionary* attributes  = [aDefinition objectForKey:kAttributesElementName];
-    NSString* reference = [attributes objectForKey:@"xlink:href"];
+    NSString* reference = [attributes objectForAtom:kGHAttributeXLinkHRef];
     if([reference hasSuffix:@".svg"])
     {
         result = [[SVGDocumentImage alloc] initWithDictionary:aDefinition];
@@ -400,10 +612,10 @@
 
 -(CGRect) boundsBox
 {
-    CGFloat	xLocation = [[self.attributes objectForKey:@"x"] floatValue];
-    CGFloat yLocation = [[self.attributes objectForKey:@"y"] floatValue];
-    CGFloat width = [[self.attributes objectForKey:@"width"] floatValue];
-    CGFloat height = [[self.attributes objectForKey:@"height"] floatValue];
+    CGFloat	xLocation = [[self.attributes objectForAtom:kGHAttributeX] floatValue];
+    CGFloat yLocation = [[self.attributes objectForAtom:kGHAttributeY] floatValue];
+    CGFloat width = [[self.attributes objectForAtom:kGHAttributeWidth] floatValue];
+    CGFloat height = [[self.attributes objectForAtom:kGHAttributeHeight] floatValue];
     
     CGRect result = CGRectMake(xLocation, yLocation, width, height);
     return result;
@@ -417,8 +629,8 @@
 -(GHImageWrapper*) newNativeImageWithSVGContext:(id<SVGContext>)svgContext
 {
     __block GHImageWrapper* result = nil;
-    NSString* subPath = [self.attributes objectForKey:@"xlink:href"];
-    NSString* basePath = [self.attributes objectForKey:@"xml:base"];
+    NSString* subPath = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
+    NSString* basePath = [self.attributes objectForAtom:kGHAttributeXMLBase];
     
     [SVGToQuartz imageAtXLinkPath:subPath orAtRelativeFilePath:basePath withSVGContext:svgContext
                      intoCallback:^(GHImageWrapper* anImage, NSURL *location) {
@@ -450,91 +662,79 @@
 }
 
 -(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
+{// an image draws with only a handful of operations, so it records them and plays them back rather than having two paths to keep in step
+    GHDisplayList* displayList = [[GHDisplayList alloc] init];
+    [self compileIntoDisplayList:displayList withSVGContext:svgContext];
+    [displayList replayIntoContext:quartzContext withSVGContext:svgContext];
+}
+
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
 {
     CGRect myRect = [self boundsBox];
-    NSString* subPath = [self.attributes objectForKey:@"xlink:href"];
+    NSString* subPath = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
     if([subPath length] && !CGRectIsEmpty(myRect))
     {
         GHImageWrapper* myImage = [self newNativeImageWithSVGContext:svgContext];
-        if(myImage != nil)
-        {
-            CGContextSaveGState(quartzContext);
-            CGContextConcatCTM(quartzContext, self.transform);
-            CGContextTranslateCTM(quartzContext, myRect.origin.x, myRect.origin.y);
+        CGImageRef   quartzImage =  myImage.cgImage;
+        if(quartzImage != 0)
+        {// the decoded image is retained by the list, so replaying doesn't decode it again
+            [displayList saveGState];
+            [displayList concatCTM:self.transform];
+            [displayList concatCTM:CGAffineTransformMakeTranslation(myRect.origin.x, myRect.origin.y)];
             
             id clippingObject = [GHClipGroup clipObjectForAttributes:self.attributes withSVGContext:svgContext];
             if(clippingObject)
             {
-                [clippingObject addToClipForContext:quartzContext  withSVGContext:svgContext objectBoundingBox:CGRectZero];
+                [displayList clipToObject:clippingObject objectBoundingBox:CGRectZero];
             }
             
             myRect.origin.x = 0.0;
             myRect.origin.y = 0.0;
-            CGContextTranslateCTM(quartzContext, 0, myRect.size.height); // now flip the context upside down to render the image.
-            CGContextScaleCTM(quartzContext, 1.0, -1);
+            // now flip the context upside down to render the image.
+            [displayList concatCTM:CGAffineTransformMake(1.0, 0.0, 0.0, -1.0, 0.0, myRect.size.height)];
             
-            CGImageRef   quartzImage =  myImage.cgImage;
-            if(quartzImage != 0)
+            NSString*	viewPortColorString = [self.attributes objectForAtom:kGHAttributeViewportFill];
+            if(viewPortColorString != nil && ![viewPortColorString isEqualToString:@"none"]
+               && ![viewPortColorString isEqualToString:@"inherit"])
             {
-                NSString*	viewPortColorString = [self.attributes objectForKey:@"viewport-fill"];
-                if(viewPortColorString != nil && ![viewPortColorString isEqualToString:@"none"]
-                   && ![viewPortColorString isEqualToString:@"inherit"])
+                if(![viewPortColorString isEqualToString:@"currentColor"])
                 {
-                    if(![viewPortColorString isEqualToString:@"currentColor"])
+                    UIColor* aColor = [svgContext colorForSVGColorString:viewPortColorString];
+                    if(aColor.CGColor != 0)
                     {
-                        UIColor* aColor = [svgContext colorForSVGColorString:viewPortColorString];
-                        if(aColor.CGColor != 0)
-                        {
-                            CGContextSetFillColorWithColor(quartzContext, aColor.CGColor);
-                            CGContextAddRect(quartzContext, myRect);
-                            CGContextFillPath(quartzContext);
-                        }
+                        [displayList setFillColor:aColor.CGColor];
+                        [displayList fillRect:myRect];
                     }
                 }
-                
-                CGRect	drawRect = myRect;
-                NSString* preserveAspectRatioString = [self.attributes objectForKey:@"preserveAspectRatio"];
-                if(preserveAspectRatioString != nil && ![preserveAspectRatioString isEqualToString:@"none"])
+            }
+            
+            CGRect	drawRect = myRect;
+            NSString* preserveAspectRatioString = [self.attributes objectForAtom:kGHAttributePreserveAspectRatio];
+            if(preserveAspectRatioString != nil && ![preserveAspectRatioString isEqualToString:@"none"])
+            {
+                CGFloat	naturalWidth = CGImageGetWidth(quartzImage);
+                CGFloat	naturalHeight = CGImageGetHeight(quartzImage);
+                CGSize	naturalSize = CGSizeMake(naturalWidth, naturalHeight);
+                drawRect = [SVGToQuartz aspectRatioDrawRectFromString:preserveAspectRatioString givenBounds:drawRect naturalSize:naturalSize];
+                if(drawRect.size.width > myRect.size.width || drawRect.size.height > myRect.size.height)
                 {
-                    CGFloat	naturalWidth = CGImageGetWidth(quartzImage);
-                    CGFloat	naturalHeight = CGImageGetHeight(quartzImage);
-                    CGSize	naturalSize = CGSizeMake(naturalWidth, naturalHeight);
-                    drawRect = [SVGToQuartz aspectRatioDrawRectFromString:preserveAspectRatioString givenBounds:drawRect naturalSize:naturalSize];
-                    if(drawRect.size.width > myRect.size.width || drawRect.size.height > myRect.size.height)
-                    {
-                        CGContextClipToRect(quartzContext, myRect);
-                    }
+                    [displayList clipToRect:myRect];
                 }
-                if(!CGRectIsEmpty(drawRect))
+            }
+            if(!CGRectIsEmpty(drawRect))
+            {
+                NSString*   opacityString = [self.attributes objectForAtom:kGHAttributeOpacity];
+                if(opacityString.length && ![opacityString isEqualToString:@"none"])
                 {
-                    
-                    NSString*   opacityString = [self.attributes objectForKey:@"opacity"];
-                    if(opacityString.length)
+                    CGFloat     alpha = [opacityString isEqualToString:@"inherit"] ? svgContext.opacity : [opacityString floatValue];
+                    if(alpha >= 0 && alpha < 1.0)
                     {
-                        if([opacityString isEqualToString:@"none"])
-                        {
-                        }
-                        else
-                        {
-                            CGFloat     alpha = 1.0;
-                            if([opacityString isEqualToString:@"inherit"])
-                            {
-                                alpha = svgContext.opacity;
-                            }
-                            else
-                            {
-                                alpha = [opacityString floatValue];
-                            }
-                            if(alpha >= 0 && alpha < 1.0)
-                            {
-                                CGContextSetAlpha(quartzContext, alpha);
-                            }
-                        }
+                        [displayList setAlpha:alpha];
                     }
-                    CGContextDrawImage(quartzContext, drawRect, quartzImage);
                 }
+                [displayList drawImage:quartzImage inRect:drawRect];
             }
-            CGContextRestoreGState(quartzContext);
+            [displayList restoreGState];
         }
     }
 }
@@ -542,7 +742,7 @@
 -(void) addToClipForContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect) objectBox
 {
     CGRect myRect = [self boundsBox];
-    NSString* subPath = [self.attributes objectForKey:@"xlink:href"];
+    NSString* subPath = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
     if([subPath length] && !CGRectIsEmpty(myRect))
     {
         GHImageWrapper* myImage = [self newNativeImageWithSVGContext:svgContext];
@@ -559,7 +759,7 @@
             CGImageRef   quartzImage =  myImage.cgImage;
             
             CGRect	drawRect = myRect;
-            NSString* preserveAspectRatioString = [self.attributes objectForKey:@"preserveAspectRatio"];
+            NSString* preserveAspectRatioString = [self.attributes objectForAtom:kGHAttributePreserveAspectRatio];
             if(preserveAspectRatioString != nil && ![preserveAspectRatioString isEqualToString:@"none"])
             {
                 CGFloat	naturalWidth = CGImageGetWidth(quartzImage);
@@ -592,6 +792,9 @@
 
 @end
 
+@interface GHShape() <GHDrawingBackendRendering>
+@end
+
 @interface GHShape(Private)
 -(CGPathRef) newQuartzPath;
 -(void) setupContext:(CGContextRef)quartzContext withAttributes:(NSDictionary*)attributes withSVGContext:(id<SVGContext>)svgContext;
@@ -625,8 +828,33 @@
 
 @end
 
+@interface GHShape()
+{
+@private
+    CGRect              _pathBoundingBox;
+    BOOL                _pathBoundingBoxValid;
+    CGRect              _transformedBoundingBox;
+    CGAffineTransform   _transformedBoundingBoxTransform;
+    BOOL                _transformedBoundingBoxValid;
+    GHPathMeasure*      _pathMeasure;
+}
+@end
+
 @implementation GHShape
 @synthesize	isClosed, isFillable,  quartzPath=_quartzPath;
+
+-(instancetype) initWithDictionary:(NSDictionary*)theDefinition
+{
+    if(nil != (self = [super initWithDictionary:theDefinition]))
+    {
+        id resolvedPath = [theDefinition objectForKey:kResolvedPathElementName];
+        if(resolvedPath != nil)
+        {
+            _quartzPath = CGPathRetain((__bridge CGPathRef)resolvedPath);
+        }
+    }
+    return self;
+}
 -(CGPathRef) quartzPath
 {
     if(_quartzPath == 0)
@@ -667,128 +895,89 @@
     return result;
 }
 
--(CGRect) getBoundingBoxWithSVGContext:(id<SVGContext>)svgContext
+-(CGRect) pathBoundingBox
 {
-    CGRect result = CGRectNull;
-    CGPathRef basePath = self.quartzPath;
-    if(basePath)
+    if(!_pathBoundingBoxValid)
     {
-        if(CGAffineTransformIsIdentity(self.transform))
-        {
-            result =  CGPathGetPathBoundingBox(basePath);
-        }
-        else
-        {
-            CGAffineTransform myTransform = self.transform;
-            CGPathRef transformedPath = CGPathCreateCopyByTransformingPath(basePath, &myTransform);
-            result = CGPathGetPathBoundingBox(transformedPath);
-            CGPathRelease(transformedPath);
-        }
+        _pathBoundingBox = SVGPathBoundsOfCGPath(self.quartzPath, NULL);
+        _pathBoundingBoxValid = YES;
     }
-    return result;
+    return _pathBoundingBox;
 }
 
--(void) renderIntoContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext
+-(GHPathMeasure*) pathMeasure
 {
-    CGContextSaveGState(quartzContext);
-    CGContextConcatCTM(quartzContext, self.transform);
-    [self setupContext:quartzContext withAttributes:self.attributes withSVGContext:svgContext];
-    UIColor* strokeColorUI = nil;
-    NSString* strokeColorString = [self valueForStyleAttribute:@"stroke" withSVGContext:svgContext];
-    
-    GHGradient* gradientToStroke = nil;
-    
-    if(IsStringURL(strokeColorString))
-    {
-        id aColor = [svgContext objectAtURL:strokeColorString];
-        if([aColor isKindOfClass:[GHSolidColor class]])
+    GHPathMeasure* result = nil;
+    @synchronized(self)
+    {// several threads may be laying out text along the same shape
+        if(_pathMeasure == nil && self.quartzPath != 0)
         {
-            strokeColorUI = [aColor asColorWithSVGContext:svgContext];
+            _pathMeasure = [[GHPathMeasure alloc] initWithCGPath:self.quartzPath tolerance:0.0];
         }
-        else if([aColor isKindOfClass:[GHGradient class]])
-        {
-            gradientToStroke = aColor;
-        }
-    }
-    
-    NSString* fillString = [self valueForStyleAttribute:@"fill" withSVGContext:svgContext];
-    CGPathDrawingMode drawingMode = kCGPathStroke;
-    
-    
-    NSString* fillRuleString = [self valueForStyleAttribute:@"fill-rule" withSVGContext:svgContext];
-    BOOL	evenOddFill = [fillRuleString isEqualToString:@"evenodd"];
-    if(!evenOddFill)
-    {// we might be in a clip path
-        fillRuleString = [self valueForStyleAttribute:@"clip-rule" withSVGContext:svgContext];
-        evenOddFill = [fillRuleString isEqualToString:@"evenodd"];
+        result = _pathMeasure;
     }
-    
-    
-    NSString* fillOpacityString = [self valueForStyleAttribute:@"fill-opacity" withSVGContext:svgContext];
-    CGFloat	fillOpacity = 1.0;
-    if([fillOpacityString length])
-    {
-        fillOpacity = [fillOpacityString floatValue];
-        if(fillOpacity < 0.0) fillOpacity = 0.0;
-        if(fillOpacity > 1.0) fillOpacity = 1.0;
-    }
-    NSString* strokeOpacityString = [self valueForStyleAttribute:@"stroke-opacity" withSVGContext:svgContext];
-    CGFloat strokeOpacity = 1.0;
-    
-    if([strokeOpacityString length])
-    {
-        strokeOpacity = [strokeOpacityString floatValue];
-        if(strokeOpacity < 0.0) strokeOpacity = 0.0;
-        if(strokeOpacity > 1.0) strokeOpacity = 1.0;
-    }
-    
-    BOOL	fillIt = (fillOpacity > 0.0 && ![fillString isEqualToString:@"none"]);
-    
-    if(fillIt && self.isFillable)
+    return result;
+}
+
+-(CGRect) transformedPathBoundingBox
+{
+    CGAffineTransform myTransform = self.transform;
+    if(CGAffineTransformIsIdentity(myTransform))
     {
+        return self.pathBoundingBox;
     }
-    else if(fillIt)
-    {
-        fillIt = fillString.length > 0;
+    if(!_transformedBoundingBoxValid || !CGAffineTransformEqualToTransform(myTransform, _transformedBoundingBoxTransform))
+    {// the extrema are solved after transforming, so a rotated curve still gets a tight box
+        _transformedBoundingBox = SVGPathBoundsOfCGPath(self.quartzPath, &myTransform);
+        _transformedBoundingBoxTransform = myTransform;
+        _transformedBoundingBoxValid = YES;
     }
+    return _transformedBoundingBox;
+}
 
+-(CGRect) getBoundingBoxWithSVGContext:(id<SVGContext>)svgContext
+{
+    return [self transformedPathBoundingBox];
+}
 
-    BOOL strokeIt = (strokeOpacity > 0.0 && (strokeColorString != nil && ![strokeColorString isEqualToString:@"none"]));
+-(BOOL) isFilledByDefault
+{
+    return self.isFillable;
+}
+
+-(void) renderIntoContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext
+{
+    CGContextSaveGState(quartzContext);
+    CGContextConcatCTM(quartzContext, self.transform);
+    GHComputedStyle* computedStyle = [self computedStyleWithSVGContext:svgContext];
+    const GHResolvedStyle* style = computedStyle.resolvedStyle;
+    [self setupContext:quartzContext withAttributes:self.attributes withSVGContext:svgContext];
     
+    CGPathDrawingMode drawingMode = kCGPathStroke;
+    BOOL	evenOddFill = (style->flags & kGHStyleEvenOddFill) != 0;
+    CGFloat	fillOpacity = style->fillOpacity;
+    BOOL	fillIt = style->fill.type != kGHPaintNone;
+    BOOL strokeIt = style->stroke.type != kGHPaintNone;
+    GHGradient* gradientToStroke = (style->stroke.type == kGHPaintGradient) ? style->stroke.object : nil;
     GHGradient* gradientToFill = nil;
+    
     if(fillIt)
     {
         UIColor* colorToFill = self.fillColor;
-        
-        if(colorToFill == nil)
-        {
-            NSString*	colorToUse = [self defaultFillColor];
-            if(IsStringURL(fillString))
-            {
-                id aColor = [svgContext objectAtURL:fillString];
-                if([aColor isKindOfClass:[GHSolidColor class]])
-                {
-                    colorToFill = [aColor asColorWithSVGContext:svgContext];
-                }
-                else if([aColor isKindOfClass:[GHGradient class]])
-                {
-                    gradientToFill = aColor;
-                }
-                
-            }
-            if(colorToFill == nil && colorToUse != nil)
-            {
-                colorToFill = [svgContext colorForSVGColorString:colorToUse];
-            }
-            if(![fillString isEqualToString:@"currentColor"] && ![fillString isEqualToString:@"inherit"])
+        if(colorToFill != nil)
+        {// explicitly set, overrides the document
+            if(fillOpacity != 1.0)
             {
-                self.fillColor = colorToFill;
+                colorToFill = [colorToFill colorWithAlphaComponent:fillOpacity];
             }
-            
         }
-        if(fillOpacity != 1.0)
+        else if(style->fill.type == kGHPaintGradient)
         {
-            colorToFill = [colorToFill colorWithAlphaComponent:fillOpacity];
+            gradientToFill = style->fill.object;
+        }
+        else
+        {
+            colorToFill = [computedStyle colorForPaint:&style->fill opacity:fillOpacity withSVGContext:svgContext];
         }
         if(colorToFill != nil)
         {
@@ -805,17 +994,9 @@
     }
     if(strokeIt)
     {
-        NSString* strokeColor = [self valueForStyleAttribute:@"stroke" withSVGContext:svgContext];
-        if(strokeColorUI == nil && strokeColor != nil)
-        {
-            strokeColorUI = [svgContext colorForSVGColorString:strokeColor];
-        }
+        UIColor* strokeColorUI = [computedStyle colorForPaint:&style->stroke opacity:style->strokeOpacity withSVGContext:svgContext];
         if(strokeColorUI != nil)
         {
-            if(strokeOpacity < 1.0)
-            {
-                strokeColorUI = [strokeColorUI colorWithAlphaComponent:strokeOpacity];
-            }
             CGContextSetStrokeColorWithColor(quartzContext, strokeColorUI.CGColor);
         }
     }
@@ -881,20 +1062,188 @@
             }
             else
             {
-                fillIt = strokeIt = false;
+                fillIt = strokeIt = false;
+            }
+        }
+    }
+    
+    if(fillIt || strokeIt)
+    {
+        if ([self addPathToQuartzContext:quartzContext])
+        {
+            CGContextDrawPath(quartzContext, drawingMode);
+        }
+        
+    }
+    CGContextRestoreGState(quartzContext);
+}
+
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{
+    GHComputedStyle* computedStyle = [self computedStyleWithSVGContext:svgContext];
+    const GHResolvedStyle* style = computedStyle.resolvedStyle;
+    if((style->fill.type == kGHPaintGradient && self.fillColor == nil) || style->stroke.type == kGHPaintGradient)
+    {// gradients draw themselves
+        [super compileIntoDisplayList:displayList withSVGContext:svgContext];
+        return;
+    }
+    [displayList saveGState];
+    [displayList concatCTM:self.transform];
+    [computedStyle compileIntoDisplayList:displayList withSVGContext:svgContext];
+    id clippingObject = style->clip;
+    if(clippingObject != nil)
+    {
+        [displayList clipToObject:clippingObject objectBoundingBox:[self getBoundingBoxWithSVGContext:svgContext]];
+    }
+    
+    CGPathDrawingMode drawingMode = kCGPathStroke;
+    BOOL	fillIt = style->fill.type != kGHPaintNone;
+    BOOL strokeIt = style->stroke.type != kGHPaintNone;
+    if(fillIt)
+    {
+        UIColor* colorToFill = self.fillColor;
+        if(colorToFill != nil)
+        {// explicitly set, overrides the document
+            if(style->fillOpacity != 1.0)
+            {
+                colorToFill = [colorToFill colorWithAlphaComponent:style->fillOpacity];
+            }
+        }
+        else
+        {
+            colorToFill = [computedStyle colorForPaint:&style->fill opacity:style->fillOpacity withSVGContext:svgContext];
+        }
+        if(colorToFill != nil)
+        {
+            [displayList setFillColor:colorToFill.CGColor];
+        }
+        if(style->flags & kGHStyleEvenOddFill)
+        {
+            drawingMode = strokeIt?kCGPathEOFillStroke:kCGPathEOFill;
+        }
+        else
+        {
+            drawingMode = strokeIt?kCGPathFillStroke:kCGPathFill;
+        }
+    }
+    if(strokeIt)
+    {
+        UIColor* strokeColorUI = [computedStyle colorForPaint:&style->stroke opacity:style->strokeOpacity withSVGContext:svgContext];
+        if(strokeColorUI != nil)
+        {
+            [displayList setStrokeColor:strokeColorUI.CGColor];
+        }
+    }
+    CGPathRef myPath = self.quartzPath;
+    if((fillIt || strokeIt) && myPath != 0)
+    {
+        [displayList drawPath:myPath mode:drawingMode];
+    }
+    [displayList restoreGState];
+}
+
+-(void) drawWithDrawingBackend:(const SVGDrawingBackend*)backend context:(void*)context withSVGContext:(id<SVGContext>)svgContext
+{// only reached for gradients, which compileIntoDisplayList:withSVGContext: leaves to be drawn at replay
+    CGPathRef myPath = self.quartzPath;
+    if(myPath == 0)
+    {
+        return;
+    }
+    GHComputedStyle* computedStyle = [self computedStyleWithSVGContext:svgContext];
+    const GHResolvedStyle* style = computedStyle.resolvedStyle;
+    GHDisplayList* setupList = [[GHDisplayList alloc] init];
+    [setupList concatCTM:self.transform];
+    [computedStyle compileIntoDisplayList:setupList withSVGContext:svgContext];
+    id clippingObject = style->clip;
+    if(clippingObject != nil)
+    {
+        [setupList clipToObject:clippingObject objectBoundingBox:[self getBoundingBoxWithSVGContext:svgContext]];
+    }
+    
+    BOOL	evenOddFill = (style->flags & kGHStyleEvenOddFill) != 0;
+    CGFloat	fillOpacity = style->fillOpacity;
+    BOOL	fillIt = style->fill.type != kGHPaintNone;
+    BOOL strokeIt = style->stroke.type != kGHPaintNone;
+    GHGradient* gradientToStroke = (style->stroke.type == kGHPaintGradient) ? style->stroke.object : nil;
+    GHGradient* gradientToFill = nil;
+    if(fillIt)
+    {
+        UIColor* colorToFill = self.fillColor;
+        if(colorToFill != nil)
+        {// explicitly set, overrides the document
+            if(fillOpacity != 1.0)
+            {
+                colorToFill = [colorToFill colorWithAlphaComponent:fillOpacity];
+            }
+        }
+        else if(style->fill.type == kGHPaintGradient)
+        {
+            gradientToFill = style->fill.object;
+        }
+        else
+        {
+            colorToFill = [computedStyle colorForPaint:&style->fill opacity:fillOpacity withSVGContext:svgContext];
+        }
+        if(colorToFill != nil)
+        {
+            [setupList setFillColor:colorToFill.CGColor];
+        }
+    }
+    if(strokeIt && gradientToStroke == nil)
+    {
+        UIColor* strokeColorUI = [computedStyle colorForPaint:&style->stroke opacity:style->strokeOpacity withSVGContext:svgContext];
+        if(strokeColorUI != nil)
+        {
+            [setupList setStrokeColor:strokeColorUI.CGColor];
+        }
+    }
+    
+    backend->saveState(context);
+    [setupList replayWithDrawingBackend:backend context:context withSVGContext:svgContext];
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    SVGPathBufferAppendCGPath(&pathBuffer, myPath);
+    CGRect myBox  =  CGPathGetPathBoundingBox(myPath);
+    if(gradientToFill != nil)
+    {
+        SVGDrawingPaint paint;
+        NSData* stopStorage = CGRectIsEmpty(myBox) ? nil : [gradientToFill describeDrawingPaint:&paint withSVGContext:svgContext objectBoundingBox:myBox];
+        if(stopStorage != nil)
+        {
+            backend->saveState(context);
+            if(fillOpacity < 1.0)
+            {
+                backend->setAlpha(context, fillOpacity*svgContext.opacity);
             }
+            backend->setFillPaint(context, &paint);
+            backend->drawPath(context, &pathBuffer, evenOddFill ? kSVGDrawingEOFill : kSVGDrawingFill);
+            backend->restoreState(context);
         }
+        fillIt = NO;
+    }
+    if(gradientToStroke != nil)
+    {
+        CGRect strokeBox = CGRectApplyAffineTransform(myBox, self.transform);
+        SVGDrawingPaint paint;
+        NSData* stopStorage = CGRectIsEmpty(strokeBox) ? nil : [gradientToStroke describeDrawingPaint:&paint withSVGContext:svgContext objectBoundingBox:strokeBox];
+        if(stopStorage != nil)
+        {
+            backend->setStrokePaint(context, &paint);
+            backend->drawPath(context, &pathBuffer, kSVGDrawingStroke);
+        }
+        strokeIt = NO;
     }
-    
     if(fillIt || strokeIt)
     {
-        if ([self addPathToQuartzContext:quartzContext])
+        SVGDrawingMode drawingMode = strokeIt ? kSVGDrawingStroke : (evenOddFill ? kSVGDrawingEOFill : kSVGDrawingFill);
+        if(fillIt && strokeIt)
         {
-            CGContextDrawPath(quartzContext, drawingMode);
+            drawingMode = evenOddFill ? kSVGDrawingEOFillStroke : kSVGDrawingFillStroke;
         }
-        
+        backend->drawPath(context, &pathBuffer, drawingMode);
     }
-    CGContextRestoreGState(quartzContext);
+    SVGPathBufferFree(&pathBuffer);
+    backend->restoreState(context);
 }
 
 -(void) addToClipForContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect) objectBox
@@ -903,8 +1252,7 @@
     CGContextConcatCTM(quartzContext, self.transform);
     [self addPathToQuartzContext:quartzContext];
     CGContextRestoreGState(quartzContext);
-    NSString* fillRuleString = [self valueForStyleAttribute:@"clip-rule" withSVGContext:svgContext];
-    BOOL	evenOddFill = [fillRuleString isEqualToString:@"evenodd"];
+    BOOL	evenOddFill = ([self computedStyleWithSVGContext:svgContext].resolvedStyle->flags & kGHStyleEvenOddClip) != 0;
     if(evenOddFill)
     {
         CGContextEOClip(quartzContext);
@@ -928,9 +1276,7 @@
 {
     ClippingType result = kPathClippingType;
     
-    NSString* fillRuleString = [self valueForStyleAttribute:@"clip-rule" withSVGContext:svgContext];
-    BOOL	evenOddFill = [fillRuleString isEqualToString:@"evenodd"];
-    if(evenOddFill)
+    if([self computedStyleWithSVGContext:svgContext].resolvedStyle->flags & kGHStyleEvenOddClip)
     {
         result = kEvenOddPathClippingType;
     }
@@ -948,9 +1294,9 @@
 -(CGPathRef) newQuartzPath
 {
     CGMutablePathRef	mutableResult = CGPathCreateMutable();
-    CGFloat		centerX = [[self.attributes objectForKey:@"cx"] floatValue];
-    CGFloat		centerY = [[self.attributes objectForKey:@"cy"] floatValue];
-    CGFloat		radiusX = [[self.attributes objectForKey:@"r"] floatValue];
+    CGFloat		centerX = [[self.attributes objectForAtom:kGHAttributeCX] floatValue];
+    CGFloat		centerY = [[self.attributes objectForAtom:kGHAttributeCY] floatValue];
+    CGFloat		radiusX = [[self.attributes objectForAtom:kGHAttributeR] floatValue];
     CGFloat		radiusY = radiusX;
     
     CGRect		ellipseBox = CGRectMake(centerX-radiusX, centerY-radiusY, 2.0f*radiusX, 2.0f*radiusY);
@@ -992,10 +1338,10 @@
 -(CGPathRef) newQuartzPath
 {
     CGMutablePathRef	mutableResult = CGPathCreateMutable();
-    CGFloat		startX = [[self.attributes objectForKey:@"x1"] floatValue];
-    CGFloat		startY = [[self.attributes objectForKey:@"y1"] floatValue];
-    CGFloat		endX = [[self.attributes objectForKey:@"x2"] floatValue];
-    CGFloat		endY = [[self.attributes objectForKey:@"y2"] floatValue];
+    CGFloat		startX = [[self.attributes objectForAtom:kGHAttributeX1] floatValue];
+    CGFloat		startY = [[self.attributes objectForAtom:kGHAttributeY1] floatValue];
+    CGFloat		endX = [[self.attributes objectForAtom:kGHAttributeX2] floatValue];
+    CGFloat		endY = [[self.attributes objectForAtom:kGHAttributeY2] floatValue];
     
     
     CGPathMoveToPoint(mutableResult, NULL, startX, startY);
@@ -1031,7 +1377,7 @@
 
 -(NSString*) renderingPath // Path will take our points and treat them like a M operation followed by a series of implied Line tos
 {
-    NSString* result = [self.attributes objectForKey:@"points"];
+    NSString* result = [self.attributes objectForAtom:kGHAttributePoints];
     NSArray* testComponent = [result componentsSeparatedByCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@", "]];
     
     NSMutableArray* mutableTestComponent = [testComponent mutableCopy];
@@ -1048,6 +1394,13 @@
     }
     return result;
 }
+
+-(CGPathRef) newQuartzPath
+{// straight from the points, no need to go through a path string
+    CGPathRef result = [[GHPathCache sharedPathCache] newPathFromSVGPoints:[self.attributes objectForAtom:kGHAttributePoints] closed:NO whileApplyingTransform:CGAffineTransformIdentity];
+    return result;
+}
+
 @end
 
 @implementation GHPolygon
@@ -1072,7 +1425,7 @@
 
 -(NSString*) renderingPath // Path will take our points and treat them like a M operation followed by a series of implied Line tos
 {		// followed by a close
-    NSString* result = [self.attributes objectForKey:@"points"];
+    NSString* result = [self.attributes objectForAtom:kGHAttributePoints];
     NSArray* testComponent = [result componentsSeparatedByCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@", "]];
     NSMutableArray* mutableTestComponent = [testComponent mutableCopy];
     [mutableTestComponent removeObject:@""];// what if there was both a space and a ,
@@ -1089,6 +1442,12 @@
     return result;
 }
 
+-(CGPathRef) newQuartzPath
+{// straight from the points, no need to go through a path string
+    CGPathRef result = [[GHPathCache sharedPathCache] newPathFromSVGPoints:[self.attributes objectForAtom:kGHAttributePoints] closed:YES whileApplyingTransform:CGAffineTransformIdentity];
+    return result;
+}
+
 @end
 
 @implementation GHEllipse
@@ -1114,10 +1473,10 @@
 -(CGPathRef) newQuartzPath
 {
     CGPathRef result = 0;
-    CGFloat		centerX = [[self.attributes objectForKey:@"cx"] floatValue];
-    CGFloat		centerY = [[self.attributes objectForKey:@"cy"] floatValue];
-    CGFloat		radiusX = [[self.attributes objectForKey:@"rx"] floatValue];
-    CGFloat		radiusY = [[self.attributes objectForKey:@"ry"] floatValue];
+    CGFloat		centerX = [[self.attributes objectForAtom:kGHAttributeCX] floatValue];
+    CGFloat		centerY = [[self.attributes objectForAtom:kGHAttributeCY] floatValue];
+    CGFloat		radiusX = [[self.attributes objectForAtom:kGHAttributeRX] floatValue];
+    CGFloat		radiusY = [[self.attributes objectForAtom:kGHAttributeRY] floatValue];
     
     CGRect		ellipseBox = CGRectMake(centerX-radiusX, centerY-radiusY, 2.0f*radiusX, 2.0f*radiusY);
     if(!CGRectIsEmpty(ellipseBox))
@@ -1138,10 +1497,10 @@
 
 -(CGRect) asCGRect
 {
-    CGFloat		originX = [[self.attributes objectForKey:@"x"] floatValue];
-    CGFloat		originY = [[self.attributes objectForKey:@"y"] floatValue];
-    CGFloat		width = [[self.attributes objectForKey:@"width"] floatValue];
-    CGFloat		height = [[self.attributes objectForKey:@"height"] floatValue];
+    CGFloat		originX = [[self.attributes objectForAtom:kGHAttributeX] floatValue];
+    CGFloat		originY = [[self.attributes objectForAtom:kGHAttributeY] floatValue];
+    CGFloat		width = [[self.attributes objectForAtom:kGHAttributeWidth] floatValue];
+    CGFloat		height = [[self.attributes objectForAtom:kGHAttributeHeight] floatValue];
     
     CGRect		result = CGRectMake(originX, originY, width, height);
     return result;
@@ -1182,8 +1541,8 @@
     {
         CGMutablePathRef	mutableResult = CGPathCreateMutable();
         
-        NSString* radiusXString = [self.attributes objectForKey:@"rx"];
-        NSString* radiusYString = [self.attributes objectForKey:@"ry"];
+        NSString* radiusXString = [self.attributes objectForAtom:kGHAttributeRX];
+        NSString* radiusYString = [self.attributes objectForAtom:kGHAttributeRY];
         
         if(radiusXString == nil) radiusXString = radiusYString;
         if(radiusYString == nil) radiusYString = radiusXString;
@@ -1276,7 +1635,7 @@
 @implementation GHPath
 -(NSString*) renderingPath
 {
-    NSString* result = [self.attributes objectForKey:@"d"];
+    NSString* result = [self.attributes objectForAtom:kGHAttributeD];
     return result;
 }
 
@@ -1296,14 +1655,14 @@
 -(CGPathRef) newQuartzPath
 {
     CGAffineTransform offsetTransform = CGAffineTransformIdentity;
-    id xValue = [self.attributes objectForKey:@"x"];
-    id yValue = [self.attributes objectForKey:@"y"];
+    id xValue = [self.attributes objectForAtom:kGHAttributeX];
+    id yValue = [self.attributes objectForAtom:kGHAttributeY];
     
     if(xValue != nil || yValue != nil)
     {
         offsetTransform =  CGAffineTransformMakeTranslation([xValue floatValue], [yValue floatValue]);
     }
-    CGPathRef result = [SVGPathGenerator newCGPathFromSVGPath:self.renderingPath whileApplyingTransform:offsetTransform];
+    CGPathRef result = [[GHPathCache sharedPathCache] newPathFromSVGPath:self.renderingPath whileApplyingTransform:offsetTransform];
     return result;
 }
 
@@ -1355,8 +1714,15 @@
 }
 -(BOOL) usesParentsCoordinates;
 -(void)setCloneTransform:(CGAffineTransform)newTransform;
+-(void) adoptChildrenOfPrototype:(GHShapeGroup*)prototype;
+-(NSDictionary*) styledAttributes;
 @end
 
+static BOOL ChildInheritsFontAttributes(NSString* elementName)
+{
+    return [elementName isEqualToString:@"g"] || [elementName isEqualToString:@"text"] || [elementName isEqualToString:@"switch"];
+}
+
 @implementation GHShapeGroup
 @synthesize children=_children, transform, childDefinitions = _childDefinitions;
 
@@ -1374,13 +1740,13 @@
 -(CGAffineTransform) calculateTransform
 {
     CGAffineTransform   result = CGAffineTransformIdentity;
-    NSString*	transformAttribute = [self.attributes objectForKey:@"transform"];
+    NSString*	transformAttribute = [self.attributes objectForAtom:kGHAttributeTransform];
     if(transformAttribute != nil)
     {
         result = SVGTransformToCGAffineTransform(transformAttribute);
     }
     
-    NSString* xString = [self.attributes objectForKey:@"x"];
+    NSString* xString = [self.attributes objectForAtom:kGHAttributeX];
     CGFloat xOffset = [xString floatValue];
     if(xOffset != 0 && xOffset == xOffset)
     {
@@ -1388,7 +1754,7 @@
     }
     
     
-    NSString* yString = [self.attributes objectForKey:@"y"];
+    NSString* yString = [self.attributes objectForAtom:kGHAttributeY];
     CGFloat yOffset = [yString floatValue];
     if(yOffset != 0 && yOffset == yOffset)
     {
@@ -1401,7 +1767,14 @@
 -(instancetype) cloneWithOverridingDictionary:(NSDictionary*)overrideAttributes
 {
     GHShapeGroup* result = [super cloneWithOverridingDictionary:overrideAttributes];
-    result.childDefinitions = self.childDefinitions;
+    if(self.childDefinitions != nil && self.cascadedStyle == nil)
+    {
+        result.childDefinitions = self.childDefinitions;
+    }
+    else
+    {// built directly by the parser, there are no definitions to rebuild from, or rebuilt children would lose what the style sheet matched
+        [result adoptChildrenOfPrototype:self];
+    }
     
     
     CGAffineTransform newTransform = [result calculateTransform];
@@ -1415,6 +1788,45 @@
     transform = newTransform;
 }
 
+-(void) adoptChildrenOfPrototype:(GHShapeGroup*)prototype
+{// children of the prototype already have its inherited attributes baked in, only fill in what the clone adds
+    NSDictionary* inheritedFontAttributes = nil;
+    NSDictionary* inheritedAttributes = [GHShapeGroup inheritedAttributesOfGroupWithAttributes:self.attributes fontAttributes:&inheritedFontAttributes];
+    NSArray* prototypeChildren = prototype.children;
+    NSMutableArray* mutableChildren = [[NSMutableArray alloc] initWithCapacity:prototypeChildren.count];
+    for(id aChild in prototypeChildren)
+    {
+        id childToAdd = aChild;
+        if([aChild isKindOfClass:[GHAttributedObject class]])
+        {
+            NSDictionary* childsAttributes = [(GHAttributedObject*)aChild attributes];
+            NSString* elementName = [aChild isKindOfClass:[GHText class]] ? @"text" : [(GHAttributedObject*)aChild entityName];
+            NSDictionary* childsInheritance = ChildInheritsFontAttributes(elementName) ? inheritedFontAttributes : inheritedAttributes;
+            NSMutableDictionary* missingAttributes = nil;
+            for(NSString* aKey in childsInheritance)
+            {
+                if([childsAttributes objectForKey:aKey] == nil)
+                {
+                    if(missingAttributes == nil)
+                    {
+                        missingAttributes = [[NSMutableDictionary alloc] initWithCapacity:childsInheritance.count];
+                    }
+                    [missingAttributes setObject:[childsInheritance objectForKey:aKey] forKey:aKey];
+                }
+            }
+            if(missingAttributes.count && [aChild respondsToSelector:@selector(cloneWithOverridingDictionary:)])
+            {
+                childToAdd = [aChild cloneWithOverridingDictionary:missingAttributes];
+            }
+        }
+        if(childToAdd != nil)
+        {
+            [mutableChildren addObject:childToAdd];
+        }
+    }
+    _children = [mutableChildren copy];
+}
+
 +(NSDictionary*) nameToClassMap
 {
     static NSDictionary* sResult = nil;
@@ -1447,117 +1859,173 @@
     
 }
 
--(NSArray*) children
++(NSDictionary*) attributesSharedWithChildrenOfGroupWithAttributes:(nullable NSDictionary*)groupAttributes
 {
-    NSArray* result = _children;
-    if(result == nil)
+    NSMutableDictionary* groupsSharedAttributes = [NSMutableDictionary dictionary];
+    
+    NSString* fillSetting = [SVGToQuartz valueForStyleAtom:kGHAttributeFill fromDefinition:groupAttributes];
+    if([fillSetting length])
     {
-        NSMutableArray* mutableChildren = [[NSMutableArray alloc] initWithCapacity:[self.childDefinitions count]];
-        
-        NSDictionary* groupsFontAttributes = [SVGTextUtilities fontAttributesFromSVGAttributes:self.attributes];
-        NSMutableDictionary* groupsSharedAttributes = [NSMutableDictionary dictionary];
-        
-        NSString* fillSetting = [self.attributes objectForKey:@"fill"];
-        if([fillSetting length])
-        {
-            [groupsSharedAttributes setObject:fillSetting forKey:@"fill"];
-        }
-        
-        NSString* strokeSetting = [self.attributes objectForKey:@"stroke"];
-        if([strokeSetting length])
-        {
-            [groupsSharedAttributes setObject:strokeSetting forKey:@"stroke"];
-        }
-        
-        NSString* colorSetting = [self.attributes objectForKey:@"color"];
-        if([colorSetting length] && ![colorSetting isEqualToString:@"inherit"])
-        {
-            [groupsSharedAttributes setObject:colorSetting forKey:@"color"];
-        }
-        
-        NSString* fillOpacitySetting = [self.attributes objectForKey:@"fill-opacity"];
-        if([fillOpacitySetting length] && ![fillOpacitySetting isEqualToString:@"inherit"])
-        {
-            [groupsSharedAttributes setObject:fillOpacitySetting forKey:@"fill-opacity"];
-        }
-        
-        NSString* xmlBaseString = [self.attributes objectForKey:@"xml:base"];
-        if([xmlBaseString length] && ![xmlBaseString isEqualToString:@"inherit"])
-        {
-            [groupsSharedAttributes setObject:xmlBaseString forKey:@"xml:base"];
-        }
-        
-        NSString* strokeOpacitySetting = [self.attributes objectForKey:@"stroke-opacity"];
-        if([strokeOpacitySetting length] && ![strokeOpacitySetting isEqualToString:@"inherit"])
+        [groupsSharedAttributes setObject:fillSetting forKey:@"fill"];
+    }
+    
+    NSString* strokeSetting = [SVGToQuartz valueForStyleAtom:kGHAttributeStroke fromDefinition:groupAttributes];
+    if([strokeSetting length])
+    {
+        [groupsSharedAttributes setObject:strokeSetting forKey:@"stroke"];
+    }
+    
+    NSString* colorSetting = [SVGToQuartz valueForStyleAtom:kGHAttributeColor fromDefinition:groupAttributes];
+    if([colorSetting length] && ![colorSetting isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:colorSetting forKey:@"color"];
+    }
+    
+    NSString* fillOpacitySetting = [SVGToQuartz valueForStyleAtom:kGHAttributeFillOpacity fromDefinition:groupAttributes];
+    if([fillOpacitySetting length] && ![fillOpacitySetting isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:fillOpacitySetting forKey:@"fill-opacity"];
+    }
+    
+    NSString* xmlBaseString = [groupAttributes objectForAtom:kGHAttributeXMLBase];
+    if([xmlBaseString length] && ![xmlBaseString isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:xmlBaseString forKey:@"xml:base"];
+    }
+    
+    NSString* strokeOpacitySetting = [SVGToQuartz valueForStyleAtom:kGHAttributeStrokeOpacity fromDefinition:groupAttributes];
+    if([strokeOpacitySetting length] && ![strokeOpacitySetting isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:strokeOpacitySetting forKey:@"stroke-opacity"];
+    }
+    
+    NSString* stopColorSetting = [SVGToQuartz valueForStyleAtom:kGHAttributeStopColor fromDefinition:groupAttributes];
+    if([stopColorSetting length] && ![stopColorSetting isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:stopColorSetting forKey:@"stop-color"];
+    }
+    
+    NSString* stopOpacitySetting = [SVGToQuartz valueForStyleAtom:kGHAttributeStopOpacity fromDefinition:groupAttributes];
+    if([stopOpacitySetting length] && ![stopOpacitySetting isEqualToString:@"inherit"])
+    {
+        [groupsSharedAttributes setObject:stopOpacitySetting forKey:@"stop-opacity"];
+    }
+    return groupsSharedAttributes;
+}
+
+static BOOL GroupSetsInheritedAttributes(NSDictionary* groupAttributes)
+{// does the group set anything of its own that its children would inherit
+    static NSSet<NSString*>* sInheritedNames = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sInheritedNames = [[NSSet alloc] initWithObjects:@"fill", @"stroke", @"color", @"fill-opacity", @"stroke-opacity",
+                           @"stop-color", @"stop-opacity", @"xml:base", @"style", nil];
+    });
+    for(NSString* aKey in groupAttributes)
+    {
+        if(([sInheritedNames containsObject:aKey] || [aKey hasPrefix:@"font"] || [aKey hasPrefix:@"text-"])
+           && [groupAttributes ownObjectForKey:aKey] != nil)
         {
-            [groupsSharedAttributes setObject:strokeOpacitySetting forKey:@"stroke-opacity"];
+            return YES;
         }
-        
-        NSString* stopColorSetting = [self.attributes objectForKey:@"stop-color"];
-        if([stopColorSetting length] && ![stopColorSetting isEqualToString:@"inherit"])
-        {
-            [groupsSharedAttributes setObject:stopColorSetting forKey:@"stop-color"];
+    }
+    return NO;
+}
+
++(nullable NSDictionary*) inheritedAttributesOfGroupWithAttributes:(nullable NSDictionary*)groupAttributes fontAttributes:(NSDictionary* __nullable * __nullable)inheritedFontAttributes
+{
+    NSDictionary* result = nil;
+    NSDictionary* fontResult = nil;
+    NSDictionary* groupsInheritance = [groupAttributes inheritedAttributes];
+    if(groupsInheritance != nil && !GroupSetsInheritedAttributes(groupAttributes))
+    {// nothing new to pass on, so hand down the very set this group was given
+        result = fontResult = groupsInheritance;
+    }
+    else
+    {
+        NSDictionary* sharedAttributes = [self attributesSharedWithChildrenOfGroupWithAttributes:groupAttributes];
+        result = sharedAttributes.count ? [GHAttributeTable attributeTableWithDictionary:sharedAttributes] : nil;
+        fontResult = result;
+        NSDictionary* fontAttributes = [SVGTextUtilities fontAttributesFromSVGAttributes:groupAttributes];
+        if(fontAttributes.count)
+        {// the inheritable paint settings win over anything of the same name in the font attributes
+            NSMutableDictionary* mutableFontResult = [fontAttributes mutableCopy];
+            [mutableFontResult addEntriesFromDictionary:sharedAttributes];
+            fontResult = [GHAttributeTable attributeTableWithDictionary:mutableFontResult];
         }
-        
-        NSString* stopOpacitySetting = [self.attributes objectForKey:@"stop-opacity"];
-        if([stopOpacitySetting length] && ![stopOpacitySetting isEqualToString:@"inherit"])
+    }
+    if(inheritedFontAttributes != NULL)
+    {
+        *inheritedFontAttributes = fontResult;
+    }
+    return result;
+}
+
++(nullable NSDictionary*) attributesForChildNamed:(nullable NSString*)elementName withAttributes:(nullable NSDictionary*)childsAttributes
+                              inheritedAttributes:(nullable NSDictionary*)inheritedAttributes inheritedFontAttributes:(nullable NSDictionary*)inheritedFontAttributes
+{
+    NSDictionary* result = childsAttributes;
+    NSDictionary* inherited = ChildInheritsFontAttributes(elementName) ? inheritedFontAttributes : inheritedAttributes;
+    if(inherited.count)
+    {// the child keeps only its own attributes and a reference to the group's
+        result = [GHAttributeTable attributeTableWithDictionary:childsAttributes inheritedAttributes:inherited];
+    }
+    return result;
+}
+
++(nullable NSDictionary*) attributesForChildNamed:(nullable NSString*)elementName withAttributes:(nullable NSDictionary*)childsAttributes
+                                 sharedAttributes:(NSDictionary*)groupsSharedAttributes fontAttributes:(NSDictionary*)groupsFontAttributes
+{
+    NSDictionary* inheritedFontAttributes = groupsSharedAttributes;
+    if([groupsFontAttributes count])
+    {
+        NSMutableDictionary* mutableFontAttributes = [groupsFontAttributes mutableCopy];
+        [mutableFontAttributes addEntriesFromDictionary:groupsSharedAttributes];
+        inheritedFontAttributes = mutableFontAttributes;
+    }
+    NSDictionary* result = [self attributesForChildNamed:elementName withAttributes:childsAttributes
+                                     inheritedAttributes:groupsSharedAttributes inheritedFontAttributes:inheritedFontAttributes];
+    return result;
+}
+
++(nullable id) newChildNamed:(NSString*)elementName withDefinition:(NSDictionary*)aDefinition
+{
+    id result = nil;
+    if([elementName isEqualToString:@"image"]) // images are created differently from other SVGAttributedObjects, it might be either a bitmap or an SVG.
+    {
+        result = [GHImage newImageWithDictionary:aDefinition];
+    }
+    else
+    {
+        Class theClass = [[GHShapeGroup nameToClassMap] valueForKey:elementName];
+        if(theClass != nil)
         {
-            [groupsSharedAttributes setObject:stopOpacitySetting forKey:@"stop-opacity"];
+            result = [[theClass alloc] initWithDictionary:aDefinition];
         }
+    }
+    return result;
+}
+
+-(NSArray*) children
+{
+    NSArray* result = _children;
+    if(result == nil)
+    {
+        NSMutableArray* mutableChildren = [[NSMutableArray alloc] initWithCapacity:[self.childDefinitions count]];
         
-        NSDictionary* nameToClassMap = [GHShapeGroup nameToClassMap];
+        NSDictionary* inheritedFontAttributes = nil;
+        NSDictionary* inheritedAttributes = [GHShapeGroup inheritedAttributesOfGroupWithAttributes:self.attributes fontAttributes:&inheritedFontAttributes];
         
         for(id aChild in self.childDefinitions)
         {
             if([aChild isKindOfClass:[NSDictionary class]])
             {
                 NSDictionary* aDefinition = (NSDictionary*)aChild;
-                
-                NSDictionary* childsAttributes = [aDefinition objectForKey:kAttributesElementName];
-                if([childsAttributes count] && [groupsSharedAttributes count])
-                {
-                    NSMutableDictionary* mutableChildAttributes = [groupsSharedAttributes mutableCopy];
-                    
-                    NSArray* keys = [childsAttributes allKeys];
-                    for(id aKey in keys)
-                    {
-                        NSString* aValue = [childsAttributes objectForKey:aKey];
-                        if(![aValue isEqualToString:@"inherit"])
-                        {
-                            [mutableChildAttributes setObject:aValue forKey:aKey];
-                        }
-                    }
-                    keys = [mutableChildAttributes allKeys];
-                    for(id aKey in keys)
-                    {
-                        NSString* aValue = [mutableChildAttributes objectForKey:aKey];
-                        if([aValue isEqualToString:@"inherit"])
-                        {// didn't actually find any inherited property
-                            [mutableChildAttributes removeObjectForKey:aKey];
-                        }
-                    }
-                    childsAttributes = mutableChildAttributes;
-                }
-                else if([groupsSharedAttributes count])
-                {
-                    childsAttributes = groupsSharedAttributes;
-                }
-                
                 NSString*	elementName = [aDefinition objectForKey:kElementName];
-                if(([elementName isEqualToString:@"g"] || [elementName isEqualToString:@"text"] || [elementName isEqualToString:@"switch"])
-                   && [groupsFontAttributes count])
-                {
-                    if([childsAttributes count])
-                    {
-                        NSMutableDictionary* mutableChildAttributes = [groupsFontAttributes mutableCopy];
-                        [mutableChildAttributes addEntriesFromDictionary:childsAttributes];
-                        childsAttributes = mutableChildAttributes;
-                    }
-                    else
-                    {
-                        childsAttributes = groupsFontAttributes;
-                    }
-                }
+                NSDictionary* childsAttributes = [GHShapeGroup attributesForChildNamed:elementName
+                                                                        withAttributes:[aDefinition objectForKey:kAttributesElementName]
+                                                                   inheritedAttributes:inheritedAttributes
+                                                               inheritedFontAttributes:inheritedFontAttributes];
                 
                 if(childsAttributes != [aDefinition objectForKey:kAttributesElementName]
                    && [childsAttributes count])
@@ -1567,25 +2035,10 @@
                     aDefinition = [mutableDefinition copy];
                 }
                 
-                if([elementName isEqualToString:@"image"]) // images are created differently from other SVGAttributedObjects, it might be either a bitmap or an SVG.
-                {
-                    id  anImage = [GHImage newImageWithDictionary:aDefinition];
-                    if(anImage != nil)
-                    {
-                        [mutableChildren addObject:anImage];
-                    }
-                }
-                else
+                id aNewChild = [GHShapeGroup newChildNamed:elementName withDefinition:aDefinition];
+                if(aNewChild != nil)
                 {
-                    Class theClass = [nameToClassMap valueForKey:elementName];
-                    if(theClass != nil)
-                    {
-                        GHAttributedObject* aChild = [[theClass alloc] initWithDictionary:aDefinition];
-                        if(aChild != nil)
-                        {
-                            [mutableChildren addObject:aChild];
-                        }
-                    }
+                    [mutableChildren addObject:aNewChild];
                 }
             }
         }
@@ -1595,11 +2048,37 @@
     return result;
 }
 
+-(instancetype) initWithAttributes:(NSDictionary*)theAttributes children:(NSArray*)children
+{
+    self = [self initWithAttributes:theAttributes children:children resolvedTransform:nil];
+    return self;
+}
+
+-(instancetype) initWithAttributes:(NSDictionary*)theAttributes children:(NSArray*)children resolvedTransform:(nullable NSValue*)resolvedTransform
+{
+    if(nil != (self = [super initWithAttributes:theAttributes]))
+    {
+        if(resolvedTransform != nil)
+        {
+            [resolvedTransform getValue:&transform];
+        }
+        else
+        {
+            transform = [self calculateTransform];
+        }
+        _children = [children copy];
+    }
+    return self;
+}
+
 -(instancetype) initWithDictionary:(NSDictionary*)theDefinition
 {
     if(nil != (self = [super initWithDictionary:theDefinition]))
     {
-        transform = [self calculateTransform];
+        if(!GetResolvedTransform(theDefinition, &transform))
+        {
+            transform = [self calculateTransform];
+        }
         _childDefinitions = [theDefinition objectForKey:kContentsElementName];
         
     }
@@ -1609,7 +2088,14 @@
 -(NSUInteger)calculatedHash
 {
     NSUInteger result = [super calculatedHash];
-    result += [_childDefinitions hash];
+    if(_childDefinitions != nil)
+    {
+        result += [_childDefinitions hash];
+    }
+    else
+    {
+        result += [_children hash];
+    }
     
     return result;
 }
@@ -1631,11 +2117,11 @@
 -(BOOL) usesParentsCoordinates
 {
     BOOL result = NO;
-    if([[self.attributes objectForKey:@"clipPathUnits"] isEqualToString:@"objectBoundingBox"])
+    if([[self.attributes objectForAtom:kGHAttributeClipPathUnits] isEqualToString:@"objectBoundingBox"])
     {
         result = YES;
     }
-    else  if([[self.attributes objectForKey:@"maskContentUnits"] isEqualToString:@"objectBoundingBox"])
+    else  if([[self.attributes objectForAtom:kGHAttributeMaskContentUnits] isEqualToString:@"objectBoundingBox"])
     {
         result = YES;
     }
@@ -1664,35 +2150,69 @@
     return result;
 }
 
+-(NSDictionary*) styledAttributes
+{// presentation attributes with the style sheet's declarations laid over them, a 'style' attribute still beats both unless the sheet said !important
+    NSDictionary* result = self.attributes;
+    NSDictionary* cascadedStyle = self.cascadedStyle;
+    if(cascadedStyle.count)
+    {
+        NSMutableDictionary* mutableResult = [[NSMutableDictionary alloc] initWithDictionary:result];
+        [mutableResult addEntriesFromDictionary:cascadedStyle];
+        NSDictionary* importantStyle = self.importantStyle;
+        if(importantStyle.count)
+        {// the last declaration in 'style' is the one read, so appending puts these ahead of the inline ones
+            NSMutableString* styleString = [[NSMutableString alloc] init];
+            NSString* inlineStyle = [result objectForAtom:kGHAttributeStyle];
+            if([inlineStyle isKindOfClass:[NSString class]])
+            {
+                [styleString appendString:inlineStyle];
+            }
+            for(NSString* aName in importantStyle)
+            {
+                [styleString appendFormat:@";%@:%@", aName, [importantStyle objectForKey:aName]];
+            }
+            [mutableResult setObject:styleString forKey:@"style"];
+        }
+        result = [GHAttributeTable attributeTableWithDictionary:mutableResult];
+    }
+    return result;
+}
+
+-(UIColor*) childrensCurrentColorWithSVGContext:(id<SVGContext>)svgContext
+{
+    UIColor* result = nil;
+    NSString* colorString = [self.attributes objectForAtom:kGHAttributeColor];
+    if([colorString isEqualToString:@"inherit"] || [colorString length] == 0)
+    {
+        result = [svgContext currentColor];
+    }
+    else
+    {
+        result = [svgContext colorForSVGColorString:colorString];
+    }
+    return result;
+}
+
 -(void) renderChildrenIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
 {
     CGContextSaveGState(quartzContext);
     CGAffineTransform   myTransform = self.transform;
     CGContextConcatCTM(quartzContext, myTransform);
-    [GHRenderableObject	setupContext:quartzContext withAttributes:self.attributes  withSVGContext:svgContext];
+    NSDictionary* styledAttributes = [self styledAttributes];
+    [GHRenderableObject	setupContext:quartzContext withAttributes:styledAttributes  withSVGContext:svgContext];
     CGFloat myOpacity = svgContext.opacity;
     if(myOpacity != 1.0)
     {
         CGContextBeginTransparencyLayer(quartzContext, NULL);
         CGContextSetAlpha(quartzContext, 1.0);
     }
-    id clippingObject = [GHClipGroup clipObjectForAttributes:self.attributes withSVGContext:svgContext];
+    id clippingObject = [GHClipGroup clipObjectForAttributes:styledAttributes withSVGContext:svgContext];
     if(clippingObject)
     {
         [clippingObject addToClipForContext:quartzContext  withSVGContext:svgContext objectBoundingBox:CGRectZero];
     }
     UIColor* savedColor = [svgContext currentColor];
-    UIColor* colorToDefaultTo = nil;
-    NSString* colorString = [self.attributes objectForKey:@"color"];
-    if([colorString isEqualToString:@"inherit"] || [colorString length] == 0)
-    {
-        colorToDefaultTo = savedColor;
-    }
-    else if([colorString length])
-    {
-        colorToDefaultTo = [svgContext colorForSVGColorString:colorString];
-    }
-    
+    UIColor* colorToDefaultTo = [self childrensCurrentColorWithSVGContext:svgContext];
     
     NSArray* myChildren = self.children;
     for(id aChild in myChildren)
@@ -1757,7 +2277,7 @@
     else
     {
         
-        NSString* clipPathName = [SVGToQuartz valueForStyleAttribute:@"clip-path" fromDefinition:self.attributes];
+        NSString* clipPathName = [SVGToQuartz valueForStyleAtom:kGHAttributeClipPath fromDefinition:self.attributes];
         if([clipPathName length])
         {
             id  aClipGroup = [svgContext objectAtURL:clipPathName];
@@ -1773,8 +2293,8 @@
         {
             CGContextSaveGState(quartzContext);
             
-            id widthValue = [self.attributes objectForKey:@"width"];
-            id heightValue = [self.attributes objectForKey:@"height"];
+            id widthValue = [self.attributes objectForAtom:kGHAttributeWidth];
+            id heightValue = [self.attributes objectForAtom:kGHAttributeHeight];
             CGFloat width = widthValue?[widthValue floatValue]:1.0f;
             CGFloat height = heightValue?[heightValue floatValue]:1.0f;
             
@@ -1870,6 +2390,43 @@
     [self renderChildrenIntoContext:quartzContext withSVGContext:svgContext];
 }
 
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{// mirrors renderChildrenIntoContext:withSVGContext:
+    [displayList saveGState];
+    [displayList concatCTM:self.transform];
+    NSDictionary* styledAttributes = [self styledAttributes];
+    [GHRenderableObject compileSetupWithAttributes:styledAttributes intoDisplayList:displayList withSVGContext:svgContext];
+    CGFloat myOpacity = svgContext.opacity;
+    if(myOpacity != 1.0)
+    {
+        [displayList beginTransparencyLayer];
+        [displayList setAlpha:1.0];
+    }
+    id clippingObject = [GHClipGroup clipObjectForAttributes:styledAttributes withSVGContext:svgContext];
+    if(clippingObject)
+    {
+        [displayList clipToObject:clippingObject objectBoundingBox:CGRectZero];
+    }
+    UIColor* savedColor = [svgContext currentColor];
+    UIColor* colorToDefaultTo = [self childrensCurrentColorWithSVGContext:svgContext];
+    
+    for(id aChild in self.children)
+    {
+        if([aChild environmentOKWithSVGContext:svgContext])
+        {
+            [svgContext setCurrentColor:colorToDefaultTo];
+            [displayList addRenderable:aChild withSVGContext:svgContext];
+            svgContext.opacity = myOpacity;
+        }
+    }
+    [svgContext setCurrentColor:savedColor];
+    if(myOpacity != 1.0)
+    {
+        [displayList endTransparencyLayer];
+    }
+    [displayList restoreGState];
+}
+
 -(id<GHRenderable>) findRenderableObject:(CGPoint)testPoint withSVGContext:(id<SVGContext>)svgContext
 {
     id<GHRenderable> result = nil;
@@ -1892,14 +2449,14 @@
 }
 -(void) addNamedObjects:(NSMutableDictionary*)namedObjectsMap
 {
-    NSString* myName = [self.attributes objectForKey:@"id"];
+    NSString* myName = [self.attributes objectForAtom:kGHAttributeID];
     if([myName isKindOfClass:[NSString class]] && [myName length])
     {
         [namedObjectsMap  setValue:self forKey:myName];
     }
     else
     {
-        myName = [self.attributes objectForKey:@"xml:id"];
+        myName = [self.attributes objectForAtom:kGHAttributeXMLID];
         if([myName isKindOfClass:[NSString class]] && [myName length])
         {
             [namedObjectsMap  setValue:self forKey:myName];
@@ -1929,13 +2486,16 @@
 -(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
 {
     
+}
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{
 }
 
 @end
 
 @interface GHStyle()
 @property(nonatomic, copy) NSDictionary<NSString*, GHCSSStyle*>* classes;
-
+@property(nonatomic, strong) GHCSSStyleSheet* styleSheet;
 @end
 
 @implementation GHStyle
@@ -1944,8 +2504,15 @@
 {
     if(nil != (self = [super initWithDictionary:theDefinition]))
     {
-        NSString* contents = [theDefinition objectForKey:kContentsElementName];
-        _classes = [GHCSSStyle stylesForString:contents];
+        NSString* css = [theDefinition objectForKey:kElementText];
+        NSData* cdata = [theDefinition objectForKey:kElementData];
+        if(cdata.length)
+        {// style sheets are usually wrapped in <![CDATA[ ]]> so that '>' can appear in selectors
+            NSString* cdataString = [[NSString alloc] initWithData:cdata encoding:NSUTF8StringEncoding];
+            css = css.length ? [css stringByAppendingFormat:@"\n%@", cdataString ?: @""] : cdataString;
+        }
+        _styleSheet = [[GHCSSStyleSheet alloc] initWithString:css];
+        _classes = [_styleSheet simpleStyles];
     }
     return self;
 }
@@ -1973,7 +2540,7 @@
 {
     id result = nil;
     
-    NSString* clipPathName = [SVGToQuartz valueForStyleAttribute:@"clip-path" fromDefinition:attributes];
+    NSString* clipPathName = [SVGToQuartz valueForStyleAtom:kGHAttributeClipPath fromDefinition:attributes];
     if([clipPathName length])
     {
         id  aClipGroup = [svgContext objectAtURL:clipPathName];
@@ -1985,7 +2552,7 @@
     }
     if(result == nil)
     {
-        NSString* maskString = [attributes objectForKey:@"mask"];
+        NSString* maskString = [attributes objectForAtom:kGHAttributeMask];
         if(IsStringURL(maskString))
         {
             id  maskObject = [svgContext objectAtURL:maskString];
@@ -2007,6 +2574,9 @@
 -(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
 {
     
+}
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{
 }
 
 -(void) addToClipForContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect) objectBox;
@@ -2052,8 +2622,8 @@
         CGContextSetFillColorWithColor(bitmapContext, [UIColor blackColor].CGColor);
         CGContextSetStrokeColorWithColor(bitmapContext, [UIColor blackColor].CGColor);
         
-        CGFloat width =    [[self.attributes objectForKey:@"width"] floatValue];
-        CGFloat height = [[self.attributes objectForKey:@"height"] floatValue];
+        CGFloat width =    [[self.attributes objectForAtom:kGHAttributeWidth] floatValue];
+        CGFloat height = [[self.attributes objectForAtom:kGHAttributeHeight] floatValue];
         
         if([self usesParentsCoordinates]
            && width > 0 && height > 0)
@@ -2134,10 +2704,10 @@
     if([self usesParentsCoordinates])
     {
         
-        CGFloat originX = [[self.attributes objectForKey:@"x"] floatValue];
-        CGFloat originY = [[self.attributes objectForKey:@"y"] floatValue];
-        CGFloat width =    [[self.attributes objectForKey:@"width"] floatValue];
-        CGFloat height = [[self.attributes objectForKey:@"height"] floatValue];
+        CGFloat originX = [[self.attributes objectForAtom:kGHAttributeX] floatValue];
+        CGFloat originY = [[self.attributes objectForAtom:kGHAttributeY] floatValue];
+        CGFloat width =    [[self.attributes objectForAtom:kGHAttributeWidth] floatValue];
+        CGFloat height = [[self.attributes objectForAtom:kGHAttributeHeight] floatValue];
         
         if(width <= 0) width = 1.0;
         if(height <= 0) height = 1.0;
@@ -2158,7 +2728,7 @@
 -(NSString*) prototypesName
 {
     NSString* result  = @"";
-    id  xlinkValue = [self.attributes objectForKey:@"xlink:href"];
+    id  xlinkValue = [self.attributes objectForAtom:kGHAttributeXLinkHRef];
     if([xlinkValue isKindOfClass:[NSString class]] && [xlinkValue hasPrefix:@"#"])
     {
         result = [xlinkValue substringFromIndex:1];
@@ -2222,6 +2792,16 @@
     }
 }
 
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext
+{// the concrete object is found once, when compiling
+    NSMutableSet*   exclusionSet = nil;
+    id<GHRenderable> myConcrete = [self concreteObjectForSVGContext:svgContext excludingPrevious:exclusionSet];
+    if(myConcrete != self && !myConcrete.hidden)
+    {
+        [displayList addRenderable:myConcrete withSVGContext:svgContext];
+    }
+}
+
 -(CGRect) getBoundingBoxWithSVGContext:(id<SVGContext>)svgContext
 {// base class doesn't know how to do this.
     CGRect result = CGRectNull;
@@ -2265,7 +2845,7 @@
 -(BOOL)environmentOKWithISOCode:(NSString*)isoLanguage
 {
     BOOL result = YES;
-    NSArray* validLanguageCodes = [(NSString*)[self.attributes objectForKey:@"systemLanguage"] componentsSeparatedByString:@","];
+    NSArray* validLanguageCodes = [(NSString*)[self.attributes objectForAtom:kGHAttributeSystemLanguage] componentsSeparatedByString:@","];
     if([validLanguageCodes count])
     {
         result = NO;
@@ -2282,7 +2862,7 @@
     }
     if(result == YES)
     {
-        NSArray* requiredExtensions = [(NSString*)[self.attributes objectForKey:@"requiredExtensions"] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        NSArray* requiredExtensions = [(NSString*)[self.attributes objectForAtom:kGHAttributeRequiredExtensions] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
         for(NSString* anExtension in requiredExtensions)
         {
             if([anExtension length])
@@ -2295,7 +2875,7 @@
     
     if(result == YES)
     {
-        NSArray* requiredFormats = [(NSString*)[self.attributes objectForKey:@"requiredFormats"] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        NSArray* requiredFormats = [(NSString*)[self.attributes objectForAtom:kGHAttributeRequiredFormats] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
         for(NSString* aFormat in requiredFormats)
         {
             if([aFormat hasPrefix:@"image"])
@@ -2325,7 +2905,7 @@
     
     if(result == YES)
     {
-        NSArray* requiredFeatures = [(NSString*)[self.attributes objectForKey:@"requiredFeatures"] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        NSArray* requiredFeatures = [(NSString*)[self.attributes objectForAtom:kGHAttributeRequiredFeatures] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
         for(NSString* aFeature in requiredFeatures)
         {
             static NSSet* supportedFeatures = nil;
@@ -2391,14 +2971,14 @@
 
 -(void) addNamedObjects:(NSMutableDictionary*)namedObjectsMap
 {
-    NSString* myName = [self.attributes objectForKey:@"id"];
+    NSString* myName = [self.attributes objectForAtom:kGHAttributeID];
     if([myName isKindOfClass:[NSString class]] && [myName length])
     {
         [namedObjectsMap  setValue:self forKey:myName];
     }
     else
     {
-        myName = [self.attributes objectForKey:@"xml:id"];
+        myName = [self.attributes objectForAtom:kGHAttributeXMLID];
         if([myName isKindOfClass:[NSString class]] && [myName length])
         {
             [namedObjectsMap  setValue:self forKey:myName];
@@ -2413,7 +2993,7 @@
 -(UIColor*) asColorWithSVGContext:(id<SVGContext>)svgContext
 {
     UIColor* result = nil;
-    NSString* fillString = [self.attributes objectForKey:@"solid-color"];
+    NSString* fillString = [self.attributes objectForAtom:kGHAttributeSolidColor];
     if([fillString length])
     {
         result = [svgContext colorForSVGColorString:fillString];
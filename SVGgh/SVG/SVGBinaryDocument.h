@@ -0,0 +1,75 @@
+//
+//  SVGBinaryDocument.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SVGParser;
+@class GHObjectTreeBuilder;
+
+/*! @brief reads and writes precompiled SVG documents, by convention with the extension 'svgb'.
+* The format is a table of interned strings followed by the document's elements as a stream of start/text/end records, with
+* path geometry and transforms already parsed. Loading one skips XML parsing and all number parsing of paths and transforms,
+* so asset pipelines can precompile their artwork at build time.
+*/
+@interface SVGBinaryDocument : NSObject
+
+/*! @brief serialize an already parsed document
+* @param parser any SVGParser or SVGRenderer parsed from SVG source. An SVGRenderer rebuilds root from its retained source here.
+* @return the precompiled document or nil if the parser failed or was itself loaded from a precompiled document
+*/
++(nullable NSData*) binaryDataFromParser:(SVGParser*)parser;
+
+/*! @brief convenience method to precompile an .svg or .svgz file
+* @param svgURL source SVG document
+* @param binaryURL where to write the precompiled document
+* @param error set if the document couldn't be parsed or written
+* @return YES on success
+*/
++(BOOL) writeBinaryDocumentFromSVGAtURL:(NSURL*)svgURL toURL:(NSURL*)binaryURL error:(NSError**)error;
+
+/*! @brief quick check of the format signature
+* @param data possibly a precompiled document
+* @return YES if the data starts with the expected signature and version
+*/
++(BOOL) isBinaryDocumentData:(NSData*)data;
+
+/*! @brief replay a precompiled document into an object tree builder
+* @param data the precompiled document, typically memory mapped
+* @param builder the builder which will create the renderable objects
+* @param error set if the data is not a valid precompiled document
+* @return YES on success
+*/
++(BOOL) loadBinaryData:(NSData*)data intoBuilder:(GHObjectTreeBuilder*)builder error:(NSError**)error;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,611 @@
+//
+//  SVGBinaryDocument.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+#import "SVGBinaryDocument.h"
+#import "SVGParser.h"
+#import "GHObjectTreeBuilder.h"
+#import "SVGAttributedObject.h"
+#import "GHPathUtilities.h"
+
+// Layout, all integers and floats little endian:
+//  'S' 'V' 'G' 'B', uint32 version, uint32 string count, then for each string a uint32 byte length and its UTF-8 bytes
+//  followed by records, each starting with a uint8 record type:
+//      start element: uint32 name index, uint32 attribute count, (uint32 key index, uint32 value index) per attribute,
+//                     uint8 flags, [6 float64 transform], [uint32 verb count, uint8 verbs, uint32 point count, float32 x,y per point]
+//      end element, text: uint32 string index, CDATA: uint32 length and bytes, end of document
+
+enum
+{
+    kSVGBinaryRecordEndOfDocument = 0,
+    kSVGBinaryRecordStartElement = 1,
+    kSVGBinaryRecordEndElement = 2,
+    kSVGBinaryRecordText = 3,
+    kSVGBinaryRecordCDATA = 4
+};
+
+enum
+{
+    kSVGBinaryHasTransform = 1 << 0,
+    kSVGBinaryHasPath = 1 << 1
+};
+
+static const char kSVGBinarySignature[4] = {'S', 'V', 'G', 'B'};
+static const uint32_t kSVGBinaryVersion = 1;
+
+#pragma mark writing
+
+static void AppendUInt8(NSMutableData* data, uint8_t value)
+{
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void AppendUInt32(NSMutableData* data, uint32_t value)
+{
+    uint32_t littleEndian = CFSwapInt32HostToLittle(value);
+    [data appendBytes:&littleEndian length:sizeof(littleEndian)];
+}
+
+static void AppendFloat32(NSMutableData* data, float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    AppendUInt32(data, bits);
+}
+
+static void AppendFloat64(NSMutableData* data, double value)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = CFSwapInt64HostToLittle(bits);
+    [data appendBytes:&bits length:sizeof(bits)];
+}
+
+static NSUInteger PointCountForPathElementType(CGPathElementType type)
+{
+    NSUInteger result = 0;
+    switch(type)
+    {
+        case kCGPathElementMoveToPoint:
+        case kCGPathElementAddLineToPoint:
+            result = 1;
+        break;
+        case kCGPathElementAddQuadCurveToPoint:
+            result = 2;
+        break;
+        case kCGPathElementAddCurveToPoint:
+            result = 3;
+        break;
+        case kCGPathElementCloseSubpath:
+            result = 0;
+        break;
+    }
+    return result;
+}
+
+@interface SVGBinaryWriter : NSObject
+@property(nonatomic, strong) NSMutableData* body;
+@property(nonatomic, strong) NSMutableArray<NSString*>* strings;
+@property(nonatomic, strong) NSMutableDictionary<NSString*, NSNumber*>* stringIndices;
+-(NSData*) dataForRootDefinition:(NSDictionary*)rootDefinition;
+@end
+
+@implementation SVGBinaryWriter
+
+-(instancetype) init
+{
+    if(nil != (self = [super init]))
+    {
+        _body = [[NSMutableData alloc] init];
+        _strings = [[NSMutableArray alloc] init];
+        _stringIndices = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+-(uint32_t) indexForString:(NSString*)aString
+{
+    NSNumber* result = [self.stringIndices objectForKey:aString];
+    if(result == nil)
+    {
+        result = [[NSNumber alloc] initWithUnsignedInteger:self.strings.count];
+        [self.strings addObject:aString];
+        [self.stringIndices setObject:result forKey:aString];
+    }
+    return (uint32_t)result.unsignedIntegerValue;
+}
+
+-(void) appendPath:(CGPathRef)aPath
+{
+    NSMutableData* verbs = [[NSMutableData alloc] init];
+    NSMutableData* points = [[NSMutableData alloc] init];
+    __block uint32_t pointCount = 0;
+    __block pathVisitor_t   callback =  ^(const CGPathElement* aPathElement)
+    {
+        AppendUInt8(verbs, (uint8_t)aPathElement->type);
+        NSUInteger elementPointCount = PointCountForPathElementType(aPathElement->type);
+        for(NSUInteger pointIndex = 0; pointIndex < elementPointCount; pointIndex++)
+        {
+            AppendFloat32(points, (float)aPathElement->points[pointIndex].x);
+            AppendFloat32(points, (float)aPathElement->points[pointIndex].y);
+        }
+        pointCount += elementPointCount;
+    };
+    CGPathApply(aPath, (__bridge void *)callback, CGPathApplyCallbackFunction);
+    
+    AppendUInt32(self.body, (uint32_t)verbs.length);
+    [self.body appendData:verbs];
+    AppendUInt32(self.body, pointCount);
+    [self.body appendData:points];
+}
+
+-(void) appendResolvedValuesForElementNamed:(NSString*)elementName withAttributes:(NSDictionary*)attributes
+{
+    Class theClass = [[GHShapeGroup nameToClassMap] objectForKey:elementName];
+    BOOL isImage = [elementName isEqualToString:@"image"];
+    BOOL wantsTransform = (theClass != nil || isImage) && [attributes objectForKey:@"transform"] != nil;
+    BOOL wantsPath = [theClass isSubclassOfClass:[GHPath class]];
+    
+    id anObject = nil;
+    if(wantsTransform || wantsPath)
+    {// let the objects themselves do the parsing, so what's stored is exactly what they would have calculated
+        NSDictionary* aDefinition = @{kElementName:elementName, kAttributesElementName:attributes};
+        anObject = [GHShapeGroup newChildNamed:elementName withDefinition:aDefinition];
+    }
+    wantsTransform = wantsTransform && [anObject respondsToSelector:@selector(transform)];
+    CGPathRef aPath = wantsPath ? [(GHShape*)anObject quartzPath] : NULL;
+    
+    uint8_t flags = 0;
+    if(wantsTransform)
+    {
+        flags |= kSVGBinaryHasTransform;
+    }
+    if(aPath != NULL)
+    {
+        flags |= kSVGBinaryHasPath;
+    }
+    AppendUInt8(self.body, flags);
+    if(wantsTransform)
+    {
+        CGAffineTransform aTransform = [(id<GHRenderable>)anObject transform];
+        AppendFloat64(self.body, aTransform.a);
+        AppendFloat64(self.body, aTransform.b);
+        AppendFloat64(self.body, aTransform.c);
+        AppendFloat64(self.body, aTransform.d);
+        AppendFloat64(self.body, aTransform.tx);
+        AppendFloat64(self.body, aTransform.ty);
+    }
+    if(aPath != NULL)
+    {
+        [self appendPath:aPath];
+    }
+}
+
+-(void) appendDefinition:(NSDictionary*)aDefinition
+{
+    NSString* elementName = [aDefinition objectForKey:kElementName];
+    NSDictionary* attributes = [aDefinition objectForKey:kAttributesElementName];
+    
+    AppendUInt8(self.body, kSVGBinaryRecordStartElement);
+    AppendUInt32(self.body, [self indexForString:elementName]);
+    AppendUInt32(self.body, (uint32_t)attributes.count);
+    [attributes enumerateKeysAndObjectsUsingBlock:^(NSString* aKey, id aValue, BOOL * _Nonnull stop) {
+        AppendUInt32(self.body, [self indexForString:aKey]);
+        AppendUInt32(self.body, [self indexForString:[aValue description]]);
+    }];
+    [self appendResolvedValuesForElementNamed:elementName withAttributes:attributes];
+    
+    for(id aChild in [aDefinition objectForKey:kContentsElementName])
+    {
+        if([aChild isKindOfClass:[NSString class]])
+        {
+            AppendUInt8(self.body, kSVGBinaryRecordText);
+            AppendUInt32(self.body, [self indexForString:aChild]);
+        }
+        else if([aChild isKindOfClass:[NSDictionary class]])
+        {
+            [self appendDefinition:aChild];
+        }
+    }
+    
+    NSData* CDATABlock = [aDefinition objectForKey:kElementData];
+    if(CDATABlock != nil)
+    {
+        AppendUInt8(self.body, kSVGBinaryRecordCDATA);
+        AppendUInt32(self.body, (uint32_t)CDATABlock.length);
+        [self.body appendData:CDATABlock];
+    }
+    AppendUInt8(self.body, kSVGBinaryRecordEndElement);
+}
+
+-(NSData*) dataForRootDefinition:(NSDictionary*)rootDefinition
+{
+    [self appendDefinition:rootDefinition];
+    AppendUInt8(self.body, kSVGBinaryRecordEndOfDocument);
+    
+    NSMutableData* result = [[NSMutableData alloc] initWithCapacity:self.body.length+1024];
+    [result appendBytes:kSVGBinarySignature length:sizeof(kSVGBinarySignature)];
+    AppendUInt32(result, kSVGBinaryVersion);
+    AppendUInt32(result, (uint32_t)self.strings.count);
+    for(NSString* aString in self.strings)
+    {
+        NSData* utf8 = [aString dataUsingEncoding:NSUTF8StringEncoding];
+        AppendUInt32(result, (uint32_t)utf8.length);
+        [result appendData:utf8];
+    }
+    [result appendData:self.body];
+    return result;
+}
+
+@end
+
+#pragma mark reading
+
+typedef struct SVGBinaryCursor
+{
+    const uint8_t*  bytes;
+    size_t          length;
+    size_t          offset;
+    BOOL            failed;
+} SVGBinaryCursor;
+
+static const uint8_t* ReadBytes(SVGBinaryCursor* cursor, size_t count)
+{
+    const uint8_t* result = NULL;
+    if(!cursor->failed && count <= cursor->length - cursor->offset)
+    {
+        result = cursor->bytes + cursor->offset;
+        cursor->offset += count;
+    }
+    else
+    {
+        cursor->failed = YES;
+    }
+    return result;
+}
+
+static uint8_t ReadUInt8(SVGBinaryCursor* cursor)
+{
+    const uint8_t* bytes = ReadBytes(cursor, 1);
+    uint8_t result = (bytes != NULL) ? *bytes : 0;
+    return result;
+}
+
+static uint32_t ReadUInt32(SVGBinaryCursor* cursor)
+{
+    uint32_t result = 0;
+    const uint8_t* bytes = ReadBytes(cursor, sizeof(result));
+    if(bytes != NULL)
+    {
+        memcpy(&result, bytes, sizeof(result));
+        result = CFSwapInt32LittleToHost(result);
+    }
+    return result;
+}
+
+static float ReadFloat32(SVGBinaryCursor* cursor)
+{
+    uint32_t bits = ReadUInt32(cursor);
+    float result = 0;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static double ReadFloat64(SVGBinaryCursor* cursor)
+{
+    uint64_t bits = 0;
+    const uint8_t* bytes = ReadBytes(cursor, sizeof(bits));
+    if(bytes != NULL)
+    {
+        memcpy(&bits, bytes, sizeof(bits));
+        bits = CFSwapInt64LittleToHost(bits);
+    }
+    double result = 0;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static NSString* ReadString(SVGBinaryCursor* cursor, NSArray<NSString*>* strings)
+{
+    NSString* result = nil;
+    uint32_t index = ReadUInt32(cursor);
+    if(!cursor->failed && index < strings.count)
+    {
+        result = [strings objectAtIndex:index];
+    }
+    else
+    {
+        cursor->failed = YES;
+    }
+    return result;
+}
+
+static CGPathRef NewPathFromCursor(SVGBinaryCursor* cursor)
+{
+    uint32_t verbCount = ReadUInt32(cursor);
+    const uint8_t* verbs = ReadBytes(cursor, verbCount);
+    uint32_t pointCount = ReadUInt32(cursor);
+    if(cursor->failed || pointCount > (cursor->length - cursor->offset)/(2*sizeof(float)))
+    {
+        cursor->failed = YES;
+        return NULL;
+    }
+    
+    CGMutablePathRef mutableResult = CGPathCreateMutable();
+    uint32_t pointsUsed = 0;
+    for(uint32_t verbIndex = 0; verbIndex < verbCount && !cursor->failed; verbIndex++)
+    {
+        CGPathElementType type = (CGPathElementType)verbs[verbIndex];
+        NSUInteger elementPointCount = PointCountForPathElementType(type);
+        CGPoint points[3];
+        if(type > kCGPathElementCloseSubpath || pointsUsed + elementPointCount > pointCount)
+        {
+            cursor->failed = YES;
+            break;
+        }
+        for(NSUInteger pointIndex = 0; pointIndex < elementPointCount; pointIndex++)
+        {
+            points[pointIndex].x = ReadFloat32(cursor);
+            points[pointIndex].y = ReadFloat32(cursor);
+        }
+        pointsUsed += elementPointCount;
+        switch(type)
+        {
+            case kCGPathElementMoveToPoint:
+                CGPathMoveToPoint(mutableResult, NULL, points[0].x, points[0].y);
+            break;
+            case kCGPathElementAddLineToPoint:
+                CGPathAddLineToPoint(mutableResult, NULL, points[0].x, points[0].y);
+            break;
+            case kCGPathElementAddQuadCurveToPoint:
+                CGPathAddQuadCurveToPoint(mutableResult, NULL, points[0].x, points[0].y, points[1].x, points[1].y);
+            break;
+            case kCGPathElementAddCurveToPoint:
+                CGPathAddCurveToPoint(mutableResult, NULL, points[0].x, points[0].y, points[1].x, points[1].y, points[2].x, points[2].y);
+            break;
+            case kCGPathElementCloseSubpath:
+                CGPathCloseSubpath(mutableResult);
+            break;
+        }
+    }
+    if(pointsUsed != pointCount)
+    {
+        cursor->failed = YES;
+    }
+    
+    CGPathRef result = NULL;
+    if(!cursor->failed)
+    {
+        result = CGPathCreateCopy(mutableResult);
+    }
+    CGPathRelease(mutableResult);
+    return result;
+}
+
+@implementation SVGBinaryDocument
+
++(nullable NSData*) binaryDataFromParser:(SVGParser*)parser
+{
+    NSData* result = nil;
+    NSDictionary* rootDefinition = parser.root;
+    if(parser.parserError == nil && !parser.loadedFromBinaryData
+       && [rootDefinition objectForKey:kElementName] != nil)
+    {
+        SVGBinaryWriter* writer = [[SVGBinaryWriter alloc] init];
+        result = [writer dataForRootDefinition:rootDefinition];
+    }
+    return result;
+}
+
++(BOOL) writeBinaryDocumentFromSVGAtURL:(NSURL*)svgURL toURL:(NSURL*)binaryURL error:(NSError**)error
+{
+    BOOL result = NO;
+    SVGParser* parser = [[SVGParser alloc] initWithContentsOfURL:svgURL];
+    NSData* binaryData = [SVGBinaryDocument binaryDataFromParser:parser];
+    if(binaryData != nil)
+    {
+        result = [binaryData writeToURL:binaryURL options:NSDataWritingAtomic error:error];
+    }
+    else if(error != NULL)
+    {
+        *error = parser.parserError ?: [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError
+                                                       userInfo:@{NSURLErrorKey:svgURL}];
+    }
+    return result;
+}
+
++(BOOL) isBinaryDocumentData:(NSData*)data
+{
+    SVGBinaryCursor cursor = {data.bytes, data.length, 0, NO};
+    const uint8_t* signature = ReadBytes(&cursor, sizeof(kSVGBinarySignature));
+    uint32_t version = ReadUInt32(&cursor);
+    BOOL result = !cursor.failed && memcmp(signature, kSVGBinarySignature, sizeof(kSVGBinarySignature)) == 0
+                    && version == kSVGBinaryVersion;
+    return result;
+}
+
++(BOOL) loadBinaryData:(NSData*)data intoBuilder:(GHObjectTreeBuilder*)builder error:(NSError**)error
+{
+    BOOL result = NO;
+    if([SVGBinaryDocument isBinaryDocumentData:data])
+    {
+        SVGBinaryCursor cursor = {data.bytes, data.length, sizeof(kSVGBinarySignature)+sizeof(kSVGBinaryVersion), NO};
+        uint32_t stringCount = ReadUInt32(&cursor);
+        if(stringCount > (cursor.length-cursor.offset)/sizeof(uint32_t))
+        {
+            cursor.failed = YES;
+        }
+        // every string is created once and shared by all the attributes which use it
+        NSMutableArray<NSString*>* strings = [[NSMutableArray alloc] initWithCapacity:cursor.failed ? 0 : stringCount];
+        for(uint32_t stringIndex = 0; stringIndex < stringCount && !cursor.failed; stringIndex++)
+        {
+            uint32_t byteCount = ReadUInt32(&cursor);
+            const uint8_t* utf8 = ReadBytes(&cursor, byteCount);
+            NSString* aString = (utf8 != NULL) ? [[NSString alloc] initWithBytes:utf8 length:byteCount encoding:NSUTF8StringEncoding] : nil;
+            if(aString == nil)
+            {
+                cursor.failed = YES;
+            }
+            else
+            {
+                [strings addObject:aString];
+            }
+        }
+        
+        NSDictionary* emptyAttributes = [NSDictionary dictionary];
+        NSUInteger scratchCapacity = 0;
+        __unsafe_unretained id* keys = NULL;
+        __unsafe_unretained id* values = NULL;
+        NSInteger depth = 0;
+        BOOL finished = NO;
+        while(!cursor.failed && !finished)
+        {
+            uint8_t recordType = ReadUInt8(&cursor);
+            switch(recordType)
+            {
+                case kSVGBinaryRecordEndOfDocument:
+                {
+                    finished = YES;
+                }
+                break;
+                case kSVGBinaryRecordStartElement:
+                {
+                    NSString* elementName = ReadString(&cursor, strings);
+                    uint32_t attributeCount = ReadUInt32(&cursor);
+                    if(cursor.failed || attributeCount > (cursor.length-cursor.offset)/(2*sizeof(uint32_t)))
+                    {
+                        cursor.failed = YES;
+                        break;
+                    }
+                    if(attributeCount > scratchCapacity)
+                    {
+                        scratchCapacity = attributeCount;
+                        keys = (__unsafe_unretained id*)realloc(keys, scratchCapacity*sizeof(id));
+                        values = (__unsafe_unretained id*)realloc(values, scratchCapacity*sizeof(id));
+                    }
+                    for(uint32_t attributeIndex = 0; attributeIndex < attributeCount && !cursor.failed; attributeIndex++)
+                    {
+                        keys[attributeIndex] = ReadString(&cursor, strings);
+                        values[attributeIndex] = ReadString(&cursor, strings);
+                    }
+                    uint8_t flags = ReadUInt8(&cursor);
+                    if(cursor.failed)
+                    {
+                        break;
+                    }
+                    NSDictionary* attributes = attributeCount ? [NSDictionary dictionaryWithObjects:values forKeys:keys count:attributeCount] : emptyAttributes;
+                    
+                    NSDictionary* resolvedValues = nil;
+                    NSValue* resolvedTransform = nil;
+                    CGPathRef resolvedPath = NULL;
+                    if(flags & kSVGBinaryHasTransform)
+                    {
+                        CGAffineTransform aTransform;
+                        aTransform.a = ReadFloat64(&cursor);
+                        aTransform.b = ReadFloat64(&cursor);
+                        aTransform.c = ReadFloat64(&cursor);
+                        aTransform.d = ReadFloat64(&cursor);
+                        aTransform.tx = ReadFloat64(&cursor);
+                        aTransform.ty = ReadFloat64(&cursor);
+                        resolvedTransform = [NSValue valueWithBytes:&aTransform objCType:@encode(CGAffineTransform)];
+                    }
+                    if(flags & kSVGBinaryHasPath)
+                    {
+                        resolvedPath = NewPathFromCursor(&cursor);
+                    }
+                    if(cursor.failed)
+                    {
+                        CGPathRelease(resolvedPath);
+                        break;
+                    }
+                    if(resolvedTransform != nil && resolvedPath != NULL)
+                    {
+                        resolvedValues = @{kResolvedTransformElementName:resolvedTransform, kResolvedPathElementName:(__bridge id)resolvedPath};
+                    }
+                    else if(resolvedTransform != nil)
+                    {
+                        resolvedValues = @{kResolvedTransformElementName:resolvedTransform};
+                    }
+                    else if(resolvedPath != NULL)
+                    {
+                        resolvedValues = @{kResolvedPathElementName:(__bridge id)resolvedPath};
+                    }
+                    CGPathRelease(resolvedPath);
+                    
+                    depth++;
+                    [builder startElementNamed:elementName withAttributes:attributes resolvedValues:resolvedValues];
+                }
+                break;
+                case kSVGBinaryRecordEndElement:
+                {
+                    if(--depth < 0)
+                    {
+                        cursor.failed = YES;
+                    }
+                    else
+                    {
+                        [builder endElement];
+                    }
+                }
+                break;
+                case kSVGBinaryRecordText:
+                {
+                    NSString* text = ReadString(&cursor, strings);
+                    if(text != nil)
+                    {
+                        [builder foundCharacters:text];
+                    }
+                }
+                break;
+                case kSVGBinaryRecordCDATA:
+                {
+                    uint32_t byteCount = ReadUInt32(&cursor);
+                    const uint8_t* bytes = ReadBytes(&cursor, byteCount);
+                    if(bytes != NULL)
+                    {
+                        [builder foundCDATA:[NSData dataWithBytes:bytes length:byteCount]];
+                    }
+                }
+                break;
+                default:
+                {
+                    cursor.failed = YES;
+                }
+                break;
+            }
+        }
+        free((void*)keys);
+        free((void*)values);
+        result = finished && !cursor.failed && depth == 0;
+    }
+    if(!result && error != NULL)
+    {
+        *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:nil];
+    }
+    return result;
+}
+
+@end
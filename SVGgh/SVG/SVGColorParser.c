@@ -0,0 +1,535 @@
+//
+//  SVGColorParser.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#include "SVGColorParser.h"
+#include "SVGNumberScanner.h"
+
+#define kNamedColorSlots 256
+#define kNamedColorBuckets 64
+#define kLongestColorName 20 // lightgoldenrodyellow
+
+typedef struct SVGNamedColor
+{
+    const char* name; // lower case
+    uint32_t    rgb;
+} SVGNamedColor;
+
+// Generated offline: every name is hashed into one of the buckets, and each bucket has the seed which sends
+// all of its names to distinct slots of kNamedColors, so a lookup is two hashes and one compare.
+// The system colors at the end of the old list resolve to what the old if/else chain gave them.
+static const uint16_t kNamedColorDisplacements[kNamedColorBuckets] = {
+    0, 2, 1, 9, 1, 1, 4, 2, 2, 6, 3, 0, 3, 1, 1, 1,
+    3, 2, 2, 1, 11, 1, 1, 4, 11, 15, 2, 2, 3, 4, 8, 2,
+    3, 0, 1, 0, 5, 0, 2, 1, 2, 17, 2, 1, 1, 3, 2, 2,
+    2, 4, 11, 1, 9, 7, 20, 6, 8, 5, 1, 12, 1, 1, 5, 9,
+};
+
+static const SVGNamedColor kNamedColors[kNamedColorSlots] = {
+    {NULL, 0},
+    {"chartreuse", 0x7fff00},
+    {"ivory", 0xfffff0},
+    {NULL, 0},
+    {NULL, 0},
+    {"whitesmoke", 0xf5f5f5},
+    {"burlywood", 0xdeb887},
+    {"mistyrose", 0xffe4e1},
+    {"gray", 0x808080},
+    {"menu", 0xaaaaaa},
+    {"chocolate", 0xd2691e},
+    {NULL, 0},
+    {"white", 0xffffff},
+    {NULL, 0},
+    {NULL, 0},
+    {"mediumspringgreen", 0x00fa9a},
+    {"pink", 0xffc0cb},
+    {"darkorchid", 0x9932cc},
+    {"lightgreen", 0x90ee90},
+    {"blueviolet", 0x8a2be2},
+    {NULL, 0},
+    {"black", 0x000000},
+    {"cadetblue", 0x5f9ea0},
+    {NULL, 0},
+    {"maroon", 0x800000},
+    {NULL, 0},
+    {NULL, 0},
+    {"mediumpurple", 0x9370db},
+    {"darkgrey", 0xa9a9a9},
+    {NULL, 0},
+    {"limegreen", 0x32cd32},
+    {"violet", 0xee82ee},
+    {"tomato", 0xff6347},
+    {"buttonhighlight", 0x555555},
+    {"steelblue", 0x4682b4},
+    {NULL, 0},
+    {"mediumorchid", 0xba55d3},
+    {"silver", 0xc0c0c0},
+    {"captiontext", 0x000000},
+    {"windowframe", 0x000000},
+    {"darkgray", 0xa9a9a9},
+    {"deeppink", 0xff1493},
+    {"darkblue", 0x00008b},
+    {NULL, 0},
+    {NULL, 0},
+    {"mediumaquamarine", 0x66cdaa},
+    {NULL, 0},
+    {"powderblue", 0xb0e0e6},
+    {"buttonface", 0xaaaaaa},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {"indianred", 0xcd5c5c},
+    {"honeydew", 0xf0fff0},
+    {"linen", 0xfaf0e6},
+    {"palevioletred", 0xdb7093},
+    {"olivedrab", 0x6b8e23},
+    {"peachpuff", 0xffdab9},
+    {"windowtext", 0x000000},
+    {NULL, 0},
+    {"darkkhaki", 0xbdb76b},
+    {"lightcoral", 0xf08080},
+    {"rebeccapurple", 0x663399},
+    {"gainsboro", 0xdcdcdc},
+    {"lemonchiffon", 0xfffacd},
+    {NULL, 0},
+    {"mediumturquoise", 0x48d1cc},
+    {NULL, 0},
+    {"saddlebrown", 0x8b4513},
+    {"mintcream", 0xf5fffa},
+    {NULL, 0},
+    {"lime", 0x00ff00},
+    {"peru", 0xcd853f},
+    {"infotext", 0x000000},
+    {NULL, 0},
+    {"darkviolet", 0x9400d3},
+    {NULL, 0},
+    {"darkgreen", 0x006400},
+    {"activeborder", 0x00ff00},
+    {"lightblue", 0xadd8e6},
+    {"rosybrown", 0xbc8f8f},
+    {"floralwhite", 0xfffaf0},
+    {NULL, 0},
+    {"highlighttext", 0xffffff},
+    {"dimgrey", 0x696969},
+    {"brown", 0xa52a2a},
+    {NULL, 0},
+    {"snow", 0xfffafa},
+    {"turquoise", 0x40e0d0},
+    {NULL, 0},
+    {"darkslateblue", 0x483d8b},
+    {"aquamarine", 0x7fffd4},
+    {NULL, 0},
+    {"blanchedalmond", 0xffebcd},
+    {"mediumvioletred", 0xc71585},
+    {"lightcyan", 0xe0ffff},
+    {"dimgray", 0x696969},
+    {NULL, 0},
+    {NULL, 0},
+    {"threedlightshadow", 0x555555},
+    {"inactivecaption", 0xaaaaaa},
+    {"royalblue", 0x4169e1},
+    {"seashell", 0xfff5ee},
+    {"darkred", 0x8b0000},
+    {NULL, 0},
+    {"seagreen", 0x2e8b57},
+    {NULL, 0},
+    {NULL, 0},
+    {"scrollbar", 0x000000},
+    {"activecaption", 0x00ff00},
+    {"blue", 0x0000ff},
+    {"palegreen", 0x98fb98},
+    {"plum", 0xdda0dd},
+    {"darkseagreen", 0x8fbc8f},
+    {"slateblue", 0x6a5acd},
+    {"yellow", 0xffff00},
+    {"lightslategray", 0x778899},
+    {"mediumseagreen", 0x3cb371},
+    {"lightskyblue", 0x87cefa},
+    {"hotpink", 0xff69b4},
+    {"lightgoldenrodyellow", 0xfafad2},
+    {"window", 0xffffff},
+    {"darkmagenta", 0x8b008b},
+    {"midnightblue", 0x191970},
+    {NULL, 0},
+    {"teal", 0x008080},
+    {"ghostwhite", 0xf8f8ff},
+    {"threedface", 0xaaaaaa},
+    {"lightslategrey", 0x778899},
+    {NULL, 0},
+    {NULL, 0},
+    {"lavenderblush", 0xfff0f5},
+    {NULL, 0},
+    {"darkolivegreen", 0x556b2f},
+    {NULL, 0},
+    {"tan", 0xd2b48c},
+    {NULL, 0},
+    {"lightgray", 0xd3d3d3},
+    {"lightyellow", 0xffffe0},
+    {"darkgoldenrod", 0xb8860b},
+    {"lightsalmon", 0xffa07a},
+    {"orchid", 0xda70d6},
+    {"yellowgreen", 0x9acd32},
+    {"threeddarkshadow", 0x555555},
+    {"oldlace", 0xfdf5e6},
+    {"infobackground", 0xaaaaaa},
+    {"cornflowerblue", 0x6495ed},
+    {NULL, 0},
+    {"crimson", 0xdc143c},
+    {"lightsteelblue", 0xb0c4de},
+    {"slategrey", 0x708090},
+    {NULL, 0},
+    {"slategray", 0x708090},
+    {"salmon", 0xfa8072},
+    {NULL, 0},
+    {"red", 0xff0000},
+    {NULL, 0},
+    {"lightseagreen", 0x20b2aa},
+    {"aliceblue", 0xf0f8ff},
+    {"navy", 0x000080},
+    {NULL, 0},
+    {"darkcyan", 0x008b8b},
+    {"darkslategrey", 0x2f4f4f},
+    {"lawngreen", 0x7cfc00},
+    {NULL, 0},
+    {NULL, 0},
+    {"deepskyblue", 0x00bfff},
+    {"threedshadow", 0x555555},
+    {"indigo", 0x4b0082},
+    {NULL, 0},
+    {"highlight", 0x000000},
+    {NULL, 0},
+    {NULL, 0},
+    {"greenyellow", 0xadff2f},
+    {NULL, 0},
+    {"wheat", 0xf5deb3},
+    {NULL, 0},
+    {"lightpink", 0xffb6c1},
+    {"firebrick", 0xb22222},
+    {"inactivecaptiontext", 0x000000},
+    {"darkorange", 0xff8c00},
+    {"cyan", 0x00ffff},
+    {NULL, 0},
+    {NULL, 0},
+    {"orangered", 0xff4500},
+    {"darksalmon", 0xe9967a},
+    {NULL, 0},
+    {NULL, 0},
+    {"antiquewhite", 0xfaebd7},
+    {"menutext", 0x000000},
+    {"mediumslateblue", 0x7b68ee},
+    {"fuchsia", 0xff00ff},
+    {"cornsilk", 0xfff8dc},
+    {"bisque", 0xffe4c4},
+    {NULL, 0},
+    {"springgreen", 0x00ff7f},
+    {"sienna", 0xa0522d},
+    {NULL, 0},
+    {"navajowhite", 0xffdead},
+    {NULL, 0},
+    {"coral", 0xff7f50},
+    {NULL, 0},
+    {NULL, 0},
+    {"skyblue", 0x87ceeb},
+    {"sandybrown", 0xf4a460},
+    {NULL, 0},
+    {"aqua", 0x00ffff},
+    {"graytext", 0x555555},
+    {"buttonshadow", 0x000000},
+    {NULL, 0},
+    {"inactiveborder", 0xaaaaaa},
+    {NULL, 0},
+    {NULL, 0},
+    {"paleturquoise", 0xafeeee},
+    {"forestgreen", 0x228b22},
+    {"moccasin", 0xffe4b5},
+    {"khaki", 0xf0e68c},
+    {NULL, 0},
+    {"magenta", 0xff00ff},
+    {NULL, 0},
+    {NULL, 0},
+    {"dodgerblue", 0x1e90ff},
+    {NULL, 0},
+    {"thistle", 0xd8bfd8},
+    {"lavender", 0xe6e6fa},
+    {"green", 0x008000},
+    {"papayawhip", 0xffefd5},
+    {"goldenrod", 0xdaa520},
+    {"darkslategray", 0x2f4f4f},
+    {"buttontext", 0x000000},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {"azure", 0xf0ffff},
+    {"purple", 0x800080},
+    {NULL, 0},
+    {"palegoldenrod", 0xeee8aa},
+    {NULL, 0},
+    {"orange", 0xffa500},
+    {NULL, 0},
+    {"beige", 0xf5f5dc},
+    {NULL, 0},
+    {"gold", 0xffd700},
+    {"mediumblue", 0x0000cd},
+    {NULL, 0},
+    {NULL, 0},
+    {"darkturquoise", 0x00ced1},
+    {NULL, 0},
+    {NULL, 0},
+    {"olive", 0x808000},
+    {"grey", 0x808080},
+    {"threedhighlight", 0x555555},
+    {"lightgrey", 0xd3d3d3},
+    {NULL, 0},
+};
+
+static inline char LowerCase(char aChar)
+{
+    return (aChar >= 'A' && aChar <= 'Z') ? (char)(aChar-'A'+'a') : aChar;
+}
+
+static uint32_t HashColorName(const char* name, size_t length, uint32_t seed)
+{// FNV-1a of the lower case name
+    uint32_t result = 2166136261u ^ (seed*16777619u);
+    for(size_t index = 0; index < length; index++)
+    {
+        result ^= (uint8_t)LowerCase(name[index]);
+        result *= 16777619u;
+    }
+    return result;
+}
+
+int SVGLookupNamedColor(const char* name, size_t length, uint32_t* rgb)
+{
+    if(length == 0 || length > kLongestColorName)
+    {
+        return 0;
+    }
+    uint32_t seed = kNamedColorDisplacements[HashColorName(name, length, 0) % kNamedColorBuckets];
+    const SVGNamedColor* candidate = &kNamedColors[HashColorName(name, length, seed) % kNamedColorSlots];
+    if(candidate->name == NULL)
+    {
+        return 0;
+    }
+    for(size_t index = 0; index < length; index++)
+    {
+        if(candidate->name[index] != LowerCase(name[index]))
+        {
+            return 0;
+        }
+    }
+    if(candidate->name[length] != 0)
+    {
+        return 0;
+    }
+    *rgb = candidate->rgb;
+    return 1;
+}
+
+static int IsColorWhitespace(char aChar)
+{
+    return aChar == ' ' || aChar == '\t' || aChar == '\n' || aChar == '\r' || aChar == '\f';
+}
+
+static int HexDigitValue(char aChar)
+{
+    if(aChar >= '0' && aChar <= '9') return aChar-'0';
+    if(aChar >= 'a' && aChar <= 'f') return aChar-'a'+10;
+    if(aChar >= 'A' && aChar <= 'F') return aChar-'A'+10;
+    return -1;
+}
+
+static float HexPairValue(char high, char low)
+{// like scanning for a hex int, a bad digit ends the number
+    int highValue = HexDigitValue(high);
+    if(highValue < 0)
+    {
+        return 0.0f;
+    }
+    int lowValue = HexDigitValue(low);
+    int value = (lowValue < 0) ? highValue : highValue*16+lowValue;
+    return (float)value/255.0f;
+}
+
+static void ParseHexColor(const char* digits, size_t count, SVGColorRGBA* color)
+{
+    color->alpha = 1.0f;
+    switch(count)
+    {
+        case 3: // #RGB
+        case 4: // #RGBA
+            color->red = HexPairValue(digits[0], digits[0]);
+            color->green = HexPairValue(digits[1], digits[1]);
+            color->blue = HexPairValue(digits[2], digits[2]);
+            if(count == 4)
+            {
+                color->alpha = HexPairValue(digits[3], digits[3]);
+            }
+        break;
+        default:
+            if(count < 2)
+            {
+                color->red = color->green = color->blue = 0.0f;
+            }
+            else
+            {// #RRGGBB, #RRGGBBAA, and for odd lengths the channels given, the missing ones copying the one before
+                color->red = HexPairValue(digits[0], digits[1]);
+                color->green = (count >= 4) ? HexPairValue(digits[2], digits[3]) : color->red;
+                color->blue = (count >= 6) ? HexPairValue(digits[4], digits[5]) : color->green;
+                if(count == 8)
+                {
+                    color->alpha = HexPairValue(digits[6], digits[7]);
+                }
+            }
+        break;
+    }
+}
+
+static float ClampUnit(double value)
+{
+    return (value < 0.0) ? 0.0f : ((value > 1.0) ? 1.0f : (float)value);
+}
+
+static void ParseFunctionalColor(const char* cursor, const char* end, SVGColorRGBA* color)
+{// the inside of rgb( or rgba(, separated by commas or, in the newer syntax, spaces with a / before the alpha
+    double values[4] = {0.0, 0.0, 0.0, 1.0};
+    int isPercent[4] = {0, 0, 0, 0};
+    size_t count = 0;
+    while(count < 4)
+    {
+        cursor = SVGSkipNumberSeparators(cursor, end);
+        if(count == 3 && cursor < end && *cursor == '/')
+        {
+            cursor = SVGSkipNumberSeparators(cursor+1, end);
+        }
+        const char* numberEnd = SVGScanNumber(cursor, end, &values[count]);
+        if(numberEnd == NULL)
+        {
+            break;
+        }
+        cursor = numberEnd;
+        if(cursor < end && *cursor == '%')
+        {
+            isPercent[count] = 1;
+            cursor++;
+        }
+        count++;
+    }
+    // as it always has, a short list repeats the last channel given
+    for(size_t index = (count == 0) ? 1 : count; index < 3; index++)
+    {
+        values[index] = values[index-1];
+        isPercent[index] = isPercent[index-1];
+    }
+    float* channels[3] = {&color->red, &color->green, &color->blue};
+    for(size_t index = 0; index < 3; index++)
+    {
+        *channels[index] = ClampUnit(isPercent[index] ? values[index]/100.0 : values[index]/255.0);
+    }
+    color->alpha = (count == 4) ? ClampUnit(isPercent[3] ? values[3]/100.0 : values[3]) : 1.0f;
+}
+
+static int MatchesLowerCase(const char* cursor, const char* end, const char* lowerCaseWord, size_t wordLength)
+{
+    if((size_t)(end-cursor) < wordLength)
+    {
+        return 0;
+    }
+    for(size_t index = 0; index < wordLength; index++)
+    {
+        if(LowerCase(cursor[index]) != lowerCaseWord[index])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+SVGColorParseResult SVGParseColor(const char* text, size_t length, SVGColorRGBA* color)
+{
+    const char* cursor = text;
+    const char* end = text+length;
+    while(cursor < end && IsColorWhitespace(*cursor))
+    {
+        cursor++;
+    }
+    while(end > cursor && IsColorWhitespace(end[-1]))
+    {
+        end--;
+    }
+    size_t trimmedLength = (size_t)(end-cursor);
+    if(trimmedLength == 0)
+    {
+        return kSVGColorParseInvalid;
+    }
+    
+    if(*cursor == '#')
+    {
+        ParseHexColor(cursor+1, trimmedLength-1, color);
+        return kSVGColorParseRGBA;
+    }
+    if(MatchesLowerCase(cursor, end, "rgb", 3))
+    {
+        const char* inside = cursor+3;
+        if(inside < end && LowerCase(*inside) == 'a')
+        {
+            inside++;
+        }
+        while(inside < end && IsColorWhitespace(*inside))
+        {
+            inside++;
+        }
+        if(inside < end && *inside == '(')
+        {
+            inside++;
+        }
+        const char* insideEnd = end;
+        if(insideEnd > inside && insideEnd[-1] == ')')
+        {
+            insideEnd--;
+        }
+        ParseFunctionalColor(inside, insideEnd, color);
+        return kSVGColorParseRGBA;
+    }
+    if((trimmedLength == 4 && MatchesLowerCase(cursor, end, "none", 4))
+       || (trimmedLength == 11 && MatchesLowerCase(cursor, end, "transparent", 11)))
+    {// web developers sometimes say 'transparent' where 'none' is meant
+        return kSVGColorParseNone;
+    }
+    
+    uint32_t rgb = 0;
+    if(SVGLookupNamedColor(cursor, trimmedLength, &rgb))
+    {
+        color->red = (float)((rgb >> 16) & 0xFF)/255.0f;
+        color->green = (float)((rgb >> 8) & 0xFF)/255.0f;
+        color->blue = (float)(rgb & 0xFF)/255.0f;
+        color->alpha = 1.0f;
+        return kSVGColorParseRGBA;
+    }
+    return kSVGColorParseInvalid;
+}
@@ -0,0 +1,76 @@
+//
+//  SVGColorParser.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGColorParser_h
+#define SVGColorParser_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief a parsed color, each component from 0 to 1
+*/
+typedef struct SVGColorRGBA
+{
+    float red, green, blue, alpha;
+} SVGColorRGBA;
+
+/*! @brief what SVGParseColor found
+*/
+typedef enum SVGColorParseResult
+{
+    kSVGColorParseInvalid = 0,  // not a color this parser knows
+    kSVGColorParseRGBA,         // a color, as hex, rgb(), rgba() or a name
+    kSVGColorParseNone          // 'none' or 'transparent'
+} SVGColorParseResult;
+
+/*! @brief parse a CSS/SVG color in one pass over its bytes without allocating
+* @param text such as '#A7A', '#FF77C0', '#FF77C080', 'rgb(0,255,127)', 'rgba(0, 100%, 50%, 0.5)', 'rgb(0 255 127 / 50%)', 'LemonChiffon'. Surrounding whitespace is ignored.
+* @param length number of bytes in text, which need not be NUL terminated
+* @param color receives the components when the result is kSVGColorParseRGBA
+* @return what kind of color was found
+*/
+SVGColorParseResult SVGParseColor(const char* text, size_t length, SVGColorRGBA* color);
+
+/*! @brief look up one of the CSS named colors, or one of the old CSS system colors, with a compile time perfect hash
+* @param name the name in any case, need not be NUL terminated
+* @param length number of bytes in name
+* @param rgb receives the color as 0xRRGGBB
+* @return 1 if the name was found
+*/
+int SVGLookupNamedColor(const char* name, size_t length, uint32_t* rgb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGColorParser_h */
@@ -105,6 +105,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 -(nullable NSString*) attributeNamed:(NSString*)attributeName classes:(nullable NSArray<NSString*>*)listOfClasses entityName:(nullable NSString*)entityName;
 
+/*! @brief  a number which changes whenever the computed style of the objects being visited might have, as when the CSS pseudo class changes. Different contexts give different numbers.
+ * @see GHComputedStyle
+ */
+-(NSUInteger) styleGeneration;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,327 @@
+//
+//  SVGNumberScanner.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#include "SVGNumberScanner.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// every power of ten up to 10^22 is exactly representable as a double, and so is every integer up to 10^15,
+// so a mantissa of 15 or fewer digits combined with one of these is correctly rounded by a single multiply or divide
+static const double kExactPowersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define kMaxExactPowerOfTen 22
+#define kMaxExactDigits 15
+#define kMaxExponentDigits 5
+
+static inline int IsNumberWhitespace(char aCharacter)
+{
+    return aCharacter == ' ' || aCharacter == '\t' || aCharacter == '\n' || aCharacter == '\r' || aCharacter == '\f';
+}
+
+static inline unsigned DigitValue(char aCharacter)
+{// anything which isn't a digit comes out > 9
+    return (unsigned)(unsigned char)aCharacter - (unsigned)'0';
+}
+
+const char* SVGSkipNumberSeparators(const char* cursor, const char* end)
+{
+    while(cursor < end && IsNumberWhitespace(*cursor))
+    {
+        cursor++;
+    }
+    if(cursor < end && *cursor == ',')
+    {
+        cursor++;
+        while(cursor < end && IsNumberWhitespace(*cursor))
+        {
+            cursor++;
+        }
+    }
+    return cursor;
+}
+
+static double SlowScan(const char* start, const char* numberEnd)
+{// long mantissas and big exponents, let the C library do the correctly rounded conversion
+    size_t numberLength = (size_t)(numberEnd-start);
+    char stackCopy[64];
+    char* copy = (numberLength < sizeof(stackCopy)) ? stackCopy : (char*)malloc(numberLength+1);
+    double result = 0.0;
+    if(copy != NULL)
+    {
+        memcpy(copy, start, numberLength);
+        copy[numberLength] = 0;
+        result = strtod(copy, NULL);
+        if(copy != stackCopy)
+        {
+            free(copy);
+        }
+    }
+    return result;
+}
+
+const char* SVGScanNumber(const char* cursor, const char* end, double* value)
+{
+    const char* start = cursor;
+    int negative = 0;
+    if(cursor < end && (*cursor == '-' || *cursor == '+'))
+    {
+        negative = (*cursor == '-');
+        cursor++;
+    }
+    
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int fractionDigits = 0;
+    int digitsSeen = 0;
+    unsigned digit;
+    
+    while(cursor < end && (digit = DigitValue(*cursor)) <= 9)
+    {
+        if(significantDigits < 19)
+        {
+            mantissa = mantissa*10+digit;
+            significantDigits += (mantissa != 0);
+        }
+        else
+        {
+            significantDigits++; // too long to be exact, flags the slow path
+        }
+        cursor++;
+        digitsSeen = 1;
+    }
+    if(cursor < end && *cursor == '.')
+    {
+        cursor++;
+        while(cursor < end && (digit = DigitValue(*cursor)) <= 9)
+        {
+            if(significantDigits < 19)
+            {
+                mantissa = mantissa*10+digit;
+                significantDigits += (mantissa != 0);
+                fractionDigits++;
+            }
+            else
+            {
+                significantDigits++;
+            }
+            cursor++;
+            digitsSeen = 1;
+        }
+    }
+    if(!digitsSeen)
+    {
+        return NULL;
+    }
+    
+    int exponent = 0;
+    int hugeExponent = 0;
+    if(cursor < end && (*cursor == 'e' || *cursor == 'E'))
+    {// only an exponent if digits follow, so '1em' or a following command isn't swallowed
+        const char* exponentCursor = cursor+1;
+        int negativeExponent = 0;
+        if(exponentCursor < end && (*exponentCursor == '-' || *exponentCursor == '+'))
+        {
+            negativeExponent = (*exponentCursor == '-');
+            exponentCursor++;
+        }
+        if(exponentCursor < end && DigitValue(*exponentCursor) <= 9)
+        {
+            int exponentDigits = 0;
+            while(exponentCursor < end && (digit = DigitValue(*exponentCursor)) <= 9)
+            {
+                if(exponentDigits++ < kMaxExponentDigits)
+                {
+                    exponent = exponent*10+(int)digit;
+                }
+                else
+                {
+                    hugeExponent = 1;
+                }
+                exponentCursor++;
+            }
+            if(negativeExponent)
+            {
+                exponent = -exponent;
+            }
+            cursor = exponentCursor;
+        }
+    }
+    
+    int decimalExponent = exponent-fractionDigits;
+    double result;
+    if(mantissa == 0 && significantDigits == 0)
+    {
+        result = 0.0;
+    }
+    else if(significantDigits <= kMaxExactDigits && !hugeExponent
+            && decimalExponent >= -kMaxExactPowerOfTen && decimalExponent <= kMaxExactPowerOfTen)
+    {
+        result = (double)mantissa;
+        if(decimalExponent < 0)
+        {
+            result /= kExactPowersOfTen[-decimalExponent];
+        }
+        else
+        {
+            result *= kExactPowersOfTen[decimalExponent];
+        }
+    }
+    else
+    {
+        *value = SlowScan(start, cursor);
+        return cursor;
+    }
+    *value = negative ? -result : result;
+    return cursor;
+}
+
+size_t SVGScanNumbers(const char** cursorPtr, const char* end, double* values, size_t maxCount)
+{
+    const char* cursor = *cursorPtr;
+    size_t result = 0;
+    while(result < maxCount)
+    {
+        const char* numberStart = SVGSkipNumberSeparators(cursor, end);
+        const char* numberEnd = SVGScanNumber(numberStart, end, &values[result]);
+        if(numberEnd == NULL)
+        {
+            break;
+        }
+        cursor = numberEnd;
+        result++;
+    }
+    *cursorPtr = cursor;
+    return result;
+}
+
+static const char* SkipWhitespace(const char* cursor, const char* end)
+{
+    while(cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r' || *cursor == '\f'))
+    {
+        cursor++;
+    }
+    return cursor;
+}
+
+static int MatchesName(const char* cursor, const char* end, const char* name, size_t nameLength)
+{
+    return (size_t)(end-cursor) >= nameLength && memcmp(cursor, name, nameLength) == 0;
+}
+
+int SVGScanTransformFunction(const char** cursorPtr, const char* end, SVGTransformFunction* function, double* values, size_t* count)
+{
+    const char* cursor = *cursorPtr;
+    while(cursor < end && (*cursor == ',' || *cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r' || *cursor == '\f'))
+    {
+        cursor++;
+    }
+    *cursorPtr = cursor;
+    if(cursor >= end)
+    {
+        return 0;
+    }
+    
+    size_t minCount = 1, maxCount = 1;
+    size_t nameLength = 0;
+    switch(*cursor)
+    {
+        case 'm':
+            if(MatchesName(cursor, end, "matrix", 6))
+            {
+                *function = kSVGTransformMatrix;
+                nameLength = 6;
+                minCount = maxCount = 6;
+            }
+        break;
+        case 't':
+            if(MatchesName(cursor, end, "translate", 9))
+            {
+                *function = kSVGTransformTranslate;
+                nameLength = 9;
+                maxCount = 2;
+            }
+        break;
+        case 's':
+            if(MatchesName(cursor, end, "scale", 5))
+            {
+                *function = kSVGTransformScale;
+                nameLength = 5;
+                maxCount = 2;
+            }
+            else if(MatchesName(cursor, end, "skewX", 5))
+            {
+                *function = kSVGTransformSkewX;
+                nameLength = 5;
+            }
+            else if(MatchesName(cursor, end, "skewY", 5))
+            {
+                *function = kSVGTransformSkewY;
+                nameLength = 5;
+            }
+        break;
+        case 'r':
+            if(MatchesName(cursor, end, "rotate", 6))
+            {
+                *function = kSVGTransformRotate;
+                nameLength = 6;
+                maxCount = 3;
+            }
+        break;
+        default:
+        break;
+    }
+    if(nameLength == 0)
+    {
+        return -1;
+    }
+    
+    cursor = SkipWhitespace(cursor+nameLength, end);
+    if(cursor >= end || *cursor != '(')
+    {
+        return -1;
+    }
+    cursor = SkipWhitespace(cursor+1, end);
+    // one more than allowed so too many arguments are caught
+    double arguments[7];
+    size_t argumentCount = SVGScanNumbers(&cursor, end, arguments, maxCount+1);
+    cursor = SkipWhitespace(cursor, end);
+    if(cursor >= end || *cursor != ')' || argumentCount < minCount || argumentCount > maxCount
+       || (*function == kSVGTransformRotate && argumentCount == 2))
+    {
+        return -1;
+    }
+    memcpy(values, arguments, argumentCount*sizeof(double));
+    *count = argumentCount;
+    *cursorPtr = cursor+1;
+    return 1;
+}
@@ -0,0 +1,89 @@
+//
+//  SVGNumberScanner.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#ifndef SVGNumberScanner_h
+#define SVGNumberScanner_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief skip the separators allowed between SVG numbers: whitespace with at most one comma
+* @param cursor where to start
+* @param end one past the last byte available
+* @return the first byte which isn't a separator
+*/
+const char* SVGSkipNumberSeparators(const char* cursor, const char* end);
+
+/*! @brief parse a single SVG number ('-12', '.5', '3e-2') directly out of the source text without copying it.
+* @discussion integers and decimals of up to 15 significant digits are converted with a single multiply or divide, which is exact. Longer mantissas and large exponents fall back to strtod. An 'e' is only taken as an exponent when digits follow it, so '1em' or a following path command are left alone.
+* @param cursor where the number starts, leading separators are not skipped
+* @param end one past the last byte available, the text need not be NUL terminated
+* @param value receives the number
+* @return the byte after the number, or NULL if there was no number at cursor
+*/
+const char* SVGScanNumber(const char* cursor, const char* end, double* value);
+
+/*! @brief parse a run of separated numbers, as in a 'points', 'viewBox' or transform argument list
+* @param cursorPtr in: where to start, out: the byte after the last number scanned (separators after it are not consumed)
+* @param end one past the last byte available
+* @param values receives the numbers
+* @param maxCount capacity of values
+* @return how many numbers were scanned, scanning stops at the first thing which isn't a number or when values is full
+*/
+size_t SVGScanNumbers(const char** cursorPtr, const char* end, double* values, size_t maxCount);
+
+/*! @brief the functions which can appear in an SVG 'transform' attribute
+*/
+typedef enum SVGTransformFunction
+{
+    kSVGTransformMatrix = 1,    // a b c d e f
+    kSVGTransformTranslate,     // tx [ty]
+    kSVGTransformScale,         // sx [sy]
+    kSVGTransformRotate,        // angle [cx cy]
+    kSVGTransformSkewX,         // angle
+    kSVGTransformSkewY          // angle
+} SVGTransformFunction;
+
+/*! @brief scan the next function out of a transform list such as 'translate(10,20) rotate(45 5 5)'. There is no limit on the length of the list and nothing is copied.
+* @param cursorPtr in: where to start, leading whitespace and commas are skipped. out: the byte after the closing parenthesis
+* @param end one past the last byte available
+* @param function receives which function was found
+* @param values receives up to 6 arguments
+* @param count receives the number of arguments, already checked to be a valid count for the function
+* @return 1 if a function was scanned, 0 if only whitespace and commas were left, -1 for anything which isn't part of the transform grammar
+*/
+int SVGScanTransformFunction(const char** cursorPtr, const char* end, SVGTransformFunction* function, double* values, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGNumberScanner_h */
@@ -34,18 +34,38 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class GHShapeGroup;
+
 /*! @brief object capable of reading in an SVG document in XML form
 */
 @interface SVGParser : NSObject 
 @property(nonatomic, readonly)           NSError* __nullable 	parserError;
 @property(nonatomic, readonly)           NSDictionary* __nullable  root;
 @property(copy, nonatomic, readonly) NSURL* __nullable 	svgURL;
+/*! @property rootObject when buildsObjectTree is YES, the object tree built while parsing. root is then only parsed from the retained source the first time it is asked for.
+* @note so until root is asked for, such a parser keeps the whole source NSData alive as well as the object tree. The parse is guarded, root may be asked for from any thread.
+*/
+@property(nonatomic, readonly)           GHShapeGroup* __nullable rootObject;
+/*! @property loadedFromBinaryData YES when the document came from a precompiled document, in which case root only holds the svg element's attributes
+*/
+@property(nonatomic, readonly)           BOOL loadedFromBinaryData;
+
+/*! @brief should parsing build the tree of SVGAttributedObjects directly rather than the intermediate NSDictionary tree in root
+* @return NO for SVGParser, subclasses which only need the object tree (SVGRenderer) override to return YES
+*/
++(BOOL) buildsObjectTree;
 
 /*! @brief init method which takes a URL reference to a .svg file
-* @param url a reference to a standard .svg or .svgz file
+* @param url a reference to a standard .svg or .svgz file, or a precompiled .svgb file
 */
 -(instancetype)initWithContentsOfURL:(NSURL *)url;
 
+/*! @brief init method which takes a precompiled document as written by SVGBinaryDocument. The object tree is built directly, so root will only hold the svg element's attributes.
+* @param binaryData the precompiled document, ideally memory mapped. initWithContentsOfURL: will map files with the 'svgb' extension.
+* @see SVGBinaryDocument
+*/
+-(instancetype)initWithBinaryData:(NSData*)binaryData;
+
 /*! @brief init method which takes a input stream from a SVG source
  * @param inputStream a reference to a standard .svg or .svgz file
  */
@@ -37,6 +37,8 @@
 #endif
 #import "SVGParser.h"
 #import "GHAttributedObject.h"
+#import "GHObjectTreeBuilder.h"
+#import "SVGBinaryDocument.h"
 #import "GzipInputStream.h"
 #import "NSData+IDZGunzip.h"
 
@@ -45,7 +47,10 @@
 @property(nonatomic, copy) NSError* __nullable 	parserError;
 @property(nonatomic, copy) NSDictionary*          __nullable root;
 @property(nonatomic, assign) BOOL					insideSVG;
+@property(nonatomic, assign) BOOL					loadedFromBinaryData;
 @property(nonatomic, strong) NSMutableArray*		__nullable groupStack;
+@property(nonatomic, strong) GHObjectTreeBuilder*  __nullable objectBuilder;
+@property(nonatomic, strong) NSData*              __nullable sourceData; // kept while only the object tree has been built, so root can be made on demand
 @end
 
 @interface SVGParser (Private)<NSXMLParserDelegate>
@@ -58,48 +63,27 @@
 
 - (void)parser:(NSXMLParser *)parser foundCDATA:(NSData *)CDATABlock
 {
+    if(self.objectBuilder != nil)
+    {
+        [self.objectBuilder foundCDATA:CDATABlock];
+        return;
+    }
 	NSMutableDictionary*	currentObject = [self.groupStack lastObject];
 	[currentObject setObject:CDATABlock forKey:kElementData];
 }
 
 - (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
 {
+    if(self.objectBuilder != nil)
+    {
+        [self.objectBuilder foundCharacters:string];
+        return;
+    }
 	NSMutableDictionary*	currentObject = [self.groupStack lastObject];
-	NSString*	currentObjectString = [currentObject objectForKey:kElementText];
-	if(currentObjectString != nil)
-	{
-		currentObjectString = [currentObjectString stringByAppendingString:string];
-	}
-	else 
-	{
-		currentObjectString = string;
-	}
-	[currentObject setObject:currentObjectString forKey:kElementText];
-	
-	
-	
-	NSMutableArray*	currentObjectContent = [currentObject objectForKey:kContentsElementName];
-	if(currentObjectContent == nil)
-	{
-		currentObjectContent = [[NSMutableArray alloc] initWithObjects:string, nil];
-		[currentObject setObject:currentObjectContent forKey:kContentsElementName];
-	}
-	else
-	{
-		id lastObject = [currentObjectContent lastObject];
-		if([lastObject isKindOfClass:[NSString class]])
-		{
-			NSString*	newLastObject = [lastObject stringByAppendingString:string];
-			[currentObjectContent removeLastObject];
-			[currentObjectContent addObject:newLastObject];
-			
-		}
-		else
-		{
-			[currentObjectContent addObject:string];
-		}
-	}
-
+    if(currentObject != nil)
+    {
+        [GHObjectTreeBuilder appendCharacters:string toDefinition:currentObject];
+    }
 }
 
 - (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName 
@@ -107,50 +91,34 @@
 				qualifiedName:(NSString *)qName 
 				attributes:(NSDictionary *)attributeDict
 {
-	if([elementName isEqualToString:@"svg"] && self.mutableRoot == nil)
+    if(self.objectBuilder != nil)
+    {
+        [self.objectBuilder startElementNamed:elementName withAttributes:attributeDict];
+    }
+	else if([elementName isEqualToString:@"svg"] && self.mutableRoot == nil)
 	{
 		self.insideSVG = YES;
-        NSMutableDictionary* newRoot = [NSMutableDictionary dictionary];
+        NSMutableDictionary* newRoot = [GHObjectTreeBuilder newDefinitionNamed:elementName withAttributes:attributeDict
+                                                            inParentDefinition:nil];
 		self.mutableRoot = newRoot;
 		self.groupStack	= [[NSMutableArray alloc] initWithObjects:newRoot, nil];
-		[newRoot setObject:attributeDict forKey:kAttributesElementName];
-		[newRoot setObject:elementName forKey:kElementName];
 	}
 	else if (self.insideSVG)
 	{
 		NSMutableDictionary*	currentObject = [self.groupStack lastObject];
-		
-        NSString* currentObjectsText = [currentObject objectForKey:kElementText];
-        NSNumber*   indexIntoParentNumber = nil;
-        if([currentObjectsText length])
-        {
-            indexIntoParentNumber = [[NSNumber alloc] initWithUnsignedInteger:[currentObjectsText length]];
-        }
-		
-        
-		NSMutableDictionary* anElement = [NSMutableDictionary dictionaryWithObjectsAndKeys:
-                                    elementName, kElementName, 
-                                    attributeDict, kAttributesElementName,
-                                    indexIntoParentNumber, kLengthIntoParentsContents, //note use of probably nil indexIntoParentNumber
-											nil];
-		
-		NSMutableArray*	currentObjectContent = [currentObject objectForKey:kContentsElementName];
-		if(currentObjectContent == nil)
-		{
-			currentObjectContent = [[NSMutableArray alloc] initWithObjects:anElement, nil];
-			[currentObject setObject:currentObjectContent forKey:kContentsElementName];
-		}
-		else
-		{
-			[currentObjectContent addObject:anElement];
-		}
+		NSMutableDictionary* anElement = [GHObjectTreeBuilder newDefinitionNamed:elementName withAttributes:attributeDict
+                                                              inParentDefinition:currentObject];
 		[self.groupStack addObject:anElement];
 	}
 }
 
 - (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName
 {
-	if (self.insideSVG)
+    if(self.objectBuilder != nil)
+    {
+        [self.objectBuilder endElement];
+    }
+	else if (self.insideSVG)
 	{
 		[self.groupStack removeLastObject];
 	}
@@ -159,36 +127,162 @@
 @end
 
 
+static BOOL DataIsUTF8XML(NSData* data)
+{// the tokenizer only understands UTF-8 (and therefore ASCII), leave anything else to NSXMLParser
+    const char* bytes = (const char*)data.bytes;
+    NSUInteger length = data.length;
+    if(length < 2)
+    {
+        return NO;
+    }
+    if(((uint8_t)bytes[0] == 0xFE && (uint8_t)bytes[1] == 0xFF) || ((uint8_t)bytes[0] == 0xFF && (uint8_t)bytes[1] == 0xFE)
+       || bytes[0] == 0 || bytes[1] == 0)
+    {// UTF-16 or UTF-32
+        return NO;
+    }
+    NSUInteger offset = (length >= 3 && memcmp(bytes, "\xEF\xBB\xBF", 3) == 0) ? 3 : 0;
+    if(length - offset < 5 || memcmp(bytes + offset, "<?xml", 5) != 0)
+    {
+        return YES;
+    }
+    const char* declarationEnd = (const char*)memchr(bytes + offset, '>', MIN(length - offset, (NSUInteger)256));
+    if(declarationEnd == NULL)
+    {
+        return NO;
+    }
+    NSString* declaration = [[NSString alloc] initWithBytes:bytes + offset length:(NSUInteger)(declarationEnd - bytes) - offset
+                                                    encoding:NSASCIIStringEncoding];
+    if(declaration == nil)
+    {
+        return NO;
+    }
+    NSRange encodingRange = [declaration rangeOfString:@"encoding"];
+    if(encodingRange.location == NSNotFound)
+    {
+        return YES;
+    }
+    NSString* encodingClause = [[declaration substringFromIndex:NSMaxRange(encodingRange)] lowercaseString];
+    return [encodingClause rangeOfString:@"utf-8"].location != NSNotFound
+            || [encodingClause rangeOfString:@"utf8"].location != NSNotFound
+            || [encodingClause rangeOfString:@"ascii"].location != NSNotFound;
+}
+
 @implementation SVGParser
 
++(BOOL) buildsObjectTree
+{
+    return NO;
+}
+
+-(void) parseWithXMLParser:(NSXMLParser*)theParser sourceData:(nullable NSData*)sourceData
+{
+    if([[self class] buildsObjectTree] && sourceData != nil)
+    {// a stream can't be read twice, so without the source the dictionary tree has to be built now
+        self.objectBuilder = [[GHObjectTreeBuilder alloc] init];
+    }
+    [theParser setDelegate:self];
+    [theParser parse];
+    self.parserError = [theParser parserError];
+    if(self.objectBuilder != nil)
+    {
+        _rootObject = self.objectBuilder.rootObject;
+        self.sourceData = sourceData;
+        self.objectBuilder = nil;
+    }
+    else
+    {
+        self.root = [self.mutableRoot copy];
+        self.mutableRoot = nil;
+        self.groupStack = nil;
+    }
+}
+
+-(void) parseWithXMLParser:(NSXMLParser*)theParser
+{
+    [self parseWithXMLParser:theParser sourceData:nil];
+}
+
+-(void) parseData:(NSData*)data
+{
+    if([[self class] buildsObjectTree] && DataIsUTF8XML(data))
+    {
+        GHObjectTreeBuilder* builder = [[GHObjectTreeBuilder alloc] init];
+        if([builder buildFromUTF8Bytes:(const char*)data.bytes length:data.length error:nil])
+        {
+            _rootObject = builder.rootObject;
+            self.sourceData = data;
+            self.parserError = nil;
+            return;
+        }
+        // malformed, let NSXMLParser have a go so the error (and any partial result) is the same as it ever was
+    }
+    NSXMLParser* theParser = [[NSXMLParser alloc] initWithData:data];
+    [self parseWithXMLParser:theParser sourceData:data];
+}
+
 -(instancetype)initWithString:(NSString*)utf8String
 {
     if(nil != (self = [super init]))
 	{
         NSData* stringAsData = [utf8String dataUsingEncoding:NSUTF8StringEncoding];
-		NSXMLParser* theParser = [[NSXMLParser alloc] initWithData:stringAsData];
-		[theParser setDelegate:self];
-		[theParser parse];
-        self.parserError = [theParser parserError];
-        self.root = [self.mutableRoot copy];
+		[self parseData:stringAsData];
 	}
 	return self;
 }
 
+-(instancetype) initWithBinaryData:(NSData*)binaryData
+{
+    if(nil != (self = [super init]))
+    {
+        _loadedFromBinaryData = YES;
+        GHObjectTreeBuilder* builder = [[GHObjectTreeBuilder alloc] init];
+        NSError* loadError = nil;
+        if([SVGBinaryDocument loadBinaryData:binaryData intoBuilder:builder error:&loadError])
+        {
+            _rootObject = builder.rootObject;
+            self.root = builder.rootDefinition;
+        }
+        else
+        {
+            self.parserError = loadError;
+        }
+    }
+    return self;
+}
+
 - (instancetype)initWithContentsOfURL:(NSURL *)url
 {
-    if ([url.pathExtension isEqualToString:@"svgz"]) {
+    if ([url.pathExtension isEqualToString:@"svgb"]) {
+        NSError* readError = nil;
+        NSData* binaryData = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:&readError];
+        
+        self = [self initWithBinaryData:(binaryData != nil) ? binaryData : [NSData data]];
+        _svgURL = url;
+        if(binaryData == nil)
+        {
+            self.parserError = readError;
+        }
+    } else if ([url.pathExtension isEqualToString:@"svgz"]) {
         NSInputStream* inputStream = [[GzipInputStream alloc] initWithURL:url];
         
         self = [self initWithInputStream:inputStream];
     } else if(nil != (self = [super init]))
     {
-        NSXMLParser* theParser = [[NSXMLParser alloc] initWithContentsOfURL:url];
-        [theParser setDelegate:self];
         _svgURL = url;
-        [theParser parse];
-        self.parserError = [theParser parserError];
-        self.root = [self.mutableRoot copy];
+        NSData* documentData = nil;
+        if(url.isFileURL)
+        {
+            documentData = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:nil];
+        }
+        if(documentData != nil)
+        {
+            [self parseData:documentData];
+        }
+        else
+        {
+            NSXMLParser* theParser = [[NSXMLParser alloc] initWithContentsOfURL:url];
+            [self parseWithXMLParser:theParser];
+        }
     }
     
 	return self;
@@ -199,10 +293,7 @@
     if(nil != (self = [super init]))
     {
         NSXMLParser* theParser = [[NSXMLParser alloc] initWithStream:inputStream];
-        [theParser setDelegate:self];
-        [theParser parse];
-        self.parserError = [theParser parserError];
-        self.root = [self.mutableRoot copy];
+        [self parseWithXMLParser:theParser];
     }
     return self;
 }
@@ -253,24 +344,21 @@
         }
         else  if(nil != (self = [super init]))
         {
-            NSXMLParser* theParser;
+            NSData* documentData = nil;
             
             if ([asset.typeIdentifier isEqualToString:(NSString *)kUTTypeScalableVectorGraphics] && !pathIsZip) {// Uncompressed SVG data
-                theParser = [[NSXMLParser alloc] initWithData:asset.data];
+                documentData = asset.data;
             } else {
                 NSError *error;
                 NSData *decompressed = [asset.data gunzip:&error];
                 
                 if (error == nil) {
-                    theParser = [[NSXMLParser alloc] initWithData:decompressed];
+                    documentData = decompressed;
                 }
             }
             
-            if (theParser != nil) {
-                [theParser setDelegate:self];
-                [theParser parse];
-                self.parserError = [theParser parserError];
-                self.root = [self.mutableRoot copy];
+            if (documentData != nil) {
+                [self parseData:documentData];
                 if(self.parserError != nil)
                 {
                     self = nil;
@@ -290,10 +378,25 @@
 
 -(nullable NSDictionary*) root
 {
-    NSDictionary* result = _root;
-    if(result == nil)
-    {
-        result = [self.mutableRoot copy];
+    NSDictionary* result = nil;
+    @synchronized(self)
+    {// renderers are shared between threads, and the re-parse builds the tree through mutableRoot and groupStack
+        result = _root;
+        if(result == nil && self.sourceData != nil)
+        {// only the object tree was built while parsing, the dictionary tree is made the first time it's asked for
+            NSXMLParser* theParser = [[NSXMLParser alloc] initWithData:self.sourceData];
+            [theParser setDelegate:self];
+            [theParser parse];
+            result = [self.mutableRoot copy];
+            self.root = result;
+            self.mutableRoot = nil;
+            self.groupStack = nil;
+            self.sourceData = nil;
+        }
+        else if(result == nil)
+        {
+            result = [self.mutableRoot copy];
+        }
     }
     return result;
 }
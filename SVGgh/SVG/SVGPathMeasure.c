@@ -0,0 +1,306 @@
+//
+//  SVGPathMeasure.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#include "SVGPathMeasure.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kMaxSubdivisionDepth 16 // at most 65536 segments for one curve, even for nonsense coordinates
+
+static void PushVertex(SVGPathMeasure* measure, double x, double y, double distance)
+{
+    if(measure->failed)
+    {
+        return;
+    }
+    if(measure->vertexCount == measure->vertexCapacity)
+    {
+        size_t newCapacity = measure->vertexCapacity ? measure->vertexCapacity*2 : 64;
+        SVGPathMeasureVertex* newVertices = (SVGPathMeasureVertex*)realloc(measure->vertices, newCapacity*sizeof(SVGPathMeasureVertex));
+        if(newVertices == NULL)
+        {
+            measure->failed = 1;
+            return;
+        }
+        measure->vertices = newVertices;
+        measure->vertexCapacity = newCapacity;
+    }
+    SVGPathMeasureVertex* vertex = measure->vertices+measure->vertexCount++;
+    vertex->x = x;
+    vertex->y = y;
+    vertex->distance = distance;
+}
+
+static void AddSegmentTo(SVGPathMeasure* measure, double x, double y)
+{
+    if(measure->vertexCount == 0)
+    {// drawing without a move starts at the origin
+        PushVertex(measure, measure->currentX, measure->currentY, 0.0);
+    }
+    double deltaX = x-measure->currentX;
+    double deltaY = y-measure->currentY;
+    if(deltaX != 0.0 || deltaY != 0.0)
+    {
+        double distance = measure->vertices[measure->vertexCount-1].distance+sqrt(deltaX*deltaX+deltaY*deltaY);
+        PushVertex(measure, x, y, distance);
+        measure->lastWasMove = 0;
+    }
+    measure->currentX = x;
+    measure->currentY = y;
+}
+
+void SVGPathMeasureInit(SVGPathMeasure* measure, double tolerance)
+{
+    memset(measure, 0, sizeof(SVGPathMeasure));
+    measure->tolerance = (tolerance > 0.0) ? tolerance : kSVGPathMeasureDefaultTolerance;
+}
+
+void SVGPathMeasureFree(SVGPathMeasure* measure)
+{
+    free(measure->vertices);
+    SVGPathMeasureInit(measure, measure->tolerance);
+}
+
+void SVGPathMeasureMoveTo(SVGPathMeasure* measure, double x, double y)
+{
+    if(measure->lastWasMove && measure->vertexCount > 0)
+    {// a move followed by a move, only the last one matters
+        measure->vertexCount--;
+    }
+    double distance = (measure->vertexCount > 0) ? measure->vertices[measure->vertexCount-1].distance : 0.0;
+    PushVertex(measure, x, y, distance); // a jump of no length, a distance never lands inside it
+    measure->lastWasMove = 1;
+    measure->currentX = measure->subpathStartX = x;
+    measure->currentY = measure->subpathStartY = y;
+}
+
+void SVGPathMeasureLineTo(SVGPathMeasure* measure, double x, double y)
+{
+    AddSegmentTo(measure, x, y);
+}
+
+static void FlattenCubic(SVGPathMeasure* measure, double x0, double y0, double x1, double y1,
+                         double x2, double y2, double x3, double y3, int depth)
+{
+    // how far the control points are from where a straight line would put them, bounds the distance of the curve from its chord
+    double ux = 3.0*x1-2.0*x0-x3, uy = 3.0*y1-2.0*y0-y3;
+    double vx = 3.0*x2-2.0*x3-x0, vy = 3.0*y2-2.0*y3-y0;
+    ux *= ux; uy *= uy; vx *= vx; vy *= vy;
+    if(ux < vx) ux = vx;
+    if(uy < vy) uy = vy;
+    if(depth >= kMaxSubdivisionDepth || !(ux+uy > 16.0*measure->tolerance*measure->tolerance))
+    {
+        AddSegmentTo(measure, x3, y3);
+        return;
+    }
+    // de Casteljau at the halfway point
+    double x01 = (x0+x1)*0.5, y01 = (y0+y1)*0.5;
+    double x12 = (x1+x2)*0.5, y12 = (y1+y2)*0.5;
+    double x23 = (x2+x3)*0.5, y23 = (y2+y3)*0.5;
+    double x012 = (x01+x12)*0.5, y012 = (y01+y12)*0.5;
+    double x123 = (x12+x23)*0.5, y123 = (y12+y23)*0.5;
+    double xMid = (x012+x123)*0.5, yMid = (y012+y123)*0.5;
+    FlattenCubic(measure, x0, y0, x01, y01, x012, y012, xMid, yMid, depth+1);
+    FlattenCubic(measure, xMid, yMid, x123, y123, x23, y23, x3, y3, depth+1);
+}
+
+static void FlattenQuad(SVGPathMeasure* measure, double x0, double y0, double x1, double y1, double x2, double y2, int depth)
+{
+    // the curve is at most a quarter of this from its chord
+    double dx = x0-2.0*x1+x2, dy = y0-2.0*y1+y2;
+    if(depth >= kMaxSubdivisionDepth || !(dx*dx+dy*dy > 16.0*measure->tolerance*measure->tolerance))
+    {
+        AddSegmentTo(measure, x2, y2);
+        return;
+    }
+    double x01 = (x0+x1)*0.5, y01 = (y0+y1)*0.5;
+    double x12 = (x1+x2)*0.5, y12 = (y1+y2)*0.5;
+    double xMid = (x01+x12)*0.5, yMid = (y01+y12)*0.5;
+    FlattenQuad(measure, x0, y0, x01, y01, xMid, yMid, depth+1);
+    FlattenQuad(measure, xMid, yMid, x12, y12, x2, y2, depth+1);
+}
+
+void SVGPathMeasureQuadTo(SVGPathMeasure* measure, double controlX, double controlY, double x, double y)
+{
+    FlattenQuad(measure, measure->currentX, measure->currentY, controlX, controlY, x, y, 0);
+}
+
+void SVGPathMeasureCubicTo(SVGPathMeasure* measure, double control1X, double control1Y, double control2X, double control2Y, double x, double y)
+{
+    FlattenCubic(measure, measure->currentX, measure->currentY, control1X, control1Y, control2X, control2Y, x, y, 0);
+}
+
+void SVGPathMeasureClose(SVGPathMeasure* measure)
+{
+    AddSegmentTo(measure, measure->subpathStartX, measure->subpathStartY);
+}
+
+double SVGPathMeasureGetLength(const SVGPathMeasure* measure)
+{
+    return (measure->vertexCount > 0) ? measure->vertices[measure->vertexCount-1].distance : 0.0;
+}
+
+static void PositionOnSegment(const SVGPathMeasure* measure, size_t endIndex, double distance, SVGPathMeasurePosition* position)
+{
+    const SVGPathMeasureVertex* start = measure->vertices+endIndex-1;
+    const SVGPathMeasureVertex* end = start+1;
+    double segmentLength = end->distance-start->distance;
+    double deltaX = end->x-start->x;
+    double deltaY = end->y-start->y;
+    double fraction = (distance-start->distance)/segmentLength;
+    position->x = start->x+fraction*deltaX;
+    position->y = start->y+fraction*deltaY;
+    position->tangentX = deltaX/segmentLength;
+    position->tangentY = deltaY/segmentLength;
+    position->segmentIndex = endIndex;
+}
+
+static int PositionOffEnds(const SVGPathMeasure* measure, double distance, SVGPathMeasurePosition* position)
+{// 1 if distance is off the path, with position extrapolated along the nearest segment
+    const SVGPathMeasureVertex* vertices = measure->vertices;
+    if(distance < 0.0)
+    {// the second vertex always ends a real segment as moves never follow moves
+        PositionOnSegment(measure, 1, distance, position);
+        return 1;
+    }
+    if(distance > SVGPathMeasureGetLength(measure))
+    {
+        size_t endIndex = measure->vertexCount-1;
+        while(vertices[endIndex].distance == vertices[endIndex-1].distance)
+        {// skip a trailing move
+            endIndex--;
+        }
+        PositionOnSegment(measure, endIndex, distance, position);
+        return 1;
+    }
+    return 0;
+}
+
+static size_t FindSegmentEnd(const SVGPathMeasure* measure, double distance)
+{// the first vertex whose distance reaches the target, a zero length jump can't be it as the vertex before it would have matched first
+    const SVGPathMeasureVertex* vertices = measure->vertices;
+    size_t low = 1, high = measure->vertexCount-1;
+    while(low < high)
+    {
+        size_t middle = low+(high-low)/2;
+        if(vertices[middle].distance < distance)
+        {
+            low = middle+1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+int SVGPathMeasureGetPosition(const SVGPathMeasure* measure, double distance, SVGPathMeasurePosition* position)
+{
+    if(measure->vertexCount < 2 || !(SVGPathMeasureGetLength(measure) > 0.0))
+    {
+        return 0;
+    }
+    if(PositionOffEnds(measure, distance, position))
+    {
+        return 0;
+    }
+    PositionOnSegment(measure, FindSegmentEnd(measure, distance), distance, position);
+    return 1;
+}
+
+size_t SVGPathMeasureGetPositions(const SVGPathMeasure* measure, const double* distances, size_t count,
+                                  SVGPathMeasurePosition* positions, int* onPathOrNULL)
+{
+    size_t result = 0;
+    int hasLength = measure->vertexCount >= 2 && SVGPathMeasureGetLength(measure) > 0.0;
+    const SVGPathMeasureVertex* vertices = measure->vertices;
+    size_t segmentEnd = 1;
+    for(size_t index = 0; index < count; index++)
+    {
+        double distance = distances[index];
+        int onPath = hasLength && !PositionOffEnds(measure, distance, positions+index);
+        if(onPath)
+        {
+            if(segmentEnd == 1 || vertices[segmentEnd-1].distance < distance)
+            {// still moving forward, walk on from the last segment
+                while(vertices[segmentEnd].distance < distance)
+                {
+                    segmentEnd++;
+                }
+            }
+            else
+            {// went backwards
+                segmentEnd = FindSegmentEnd(measure, distance);
+            }
+            PositionOnSegment(measure, segmentEnd, distance, positions+index);
+            result++;
+        }
+        if(onPathOrNULL != NULL)
+        {
+            onPathOrNULL[index] = onPath;
+        }
+    }
+    return result;
+}
+
+#if defined(__APPLE__)
+static void AppendCGPathElementToMeasure(void* info, const CGPathElement* element)
+{
+    SVGPathMeasure* measure = (SVGPathMeasure*)info;
+    const CGPoint* points = element->points;
+    switch(element->type)
+    {
+        case kCGPathElementMoveToPoint:
+            SVGPathMeasureMoveTo(measure, points[0].x, points[0].y);
+        break;
+        case kCGPathElementAddLineToPoint:
+            SVGPathMeasureLineTo(measure, points[0].x, points[0].y);
+        break;
+        case kCGPathElementAddQuadCurveToPoint:
+            SVGPathMeasureQuadTo(measure, points[0].x, points[0].y, points[1].x, points[1].y);
+        break;
+        case kCGPathElementAddCurveToPoint:
+            SVGPathMeasureCubicTo(measure, points[0].x, points[0].y, points[1].x, points[1].y, points[2].x, points[2].y);
+        break;
+        case kCGPathElementCloseSubpath:
+            SVGPathMeasureClose(measure);
+        break;
+    }
+}
+
+int SVGPathMeasureAppendCGPath(SVGPathMeasure* measure, CGPathRef aPath)
+{
+    if(aPath != NULL)
+    {
+        CGPathApply(aPath, measure, AppendCGPathElementToMeasure);
+    }
+    return !measure->failed;
+}
+#endif
@@ -0,0 +1,133 @@
+//
+//  SVGPathMeasure.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGPathMeasure_h
+#define SVGPathMeasure_h
+
+#include <stddef.h>
+
+#if defined(__APPLE__)
+#include <CoreGraphics/CoreGraphics.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief how far, in user units, a flattened curve may stray from the true curve when no tolerance is given
+*/
+#define kSVGPathMeasureDefaultTolerance 0.02
+
+/*! @brief one corner of a flattened path along with how far along the path it is
+*/
+typedef struct SVGPathMeasureVertex
+{
+    double x, y;
+    double distance;
+} SVGPathMeasureVertex;
+
+/*! @brief a path flattened into line segments by adaptive subdivision, with the running length at every vertex. Built once, after which any distance along the path is found with a binary search.
+*/
+typedef struct SVGPathMeasure
+{
+    SVGPathMeasureVertex*   vertices;
+    size_t                  vertexCount;
+    size_t                  vertexCapacity;
+    double                  tolerance;
+    
+    // state used while building
+    double                  currentX, currentY;
+    double                  subpathStartX, subpathStartY;
+    int                     lastWasMove;
+    int                     failed;
+} SVGPathMeasure;
+
+/*! @brief where on a path a given distance lands
+*/
+typedef struct SVGPathMeasurePosition
+{
+    double x, y;
+    double tangentX, tangentY;  // unit vector in the direction of travel
+    size_t segmentIndex;        // the segment ends at vertices[segmentIndex]
+} SVGPathMeasurePosition;
+
+/*! @brief prepare an empty measure
+* @param tolerance the most a flattened curve may be off from the real one, zero or less for kSVGPathMeasureDefaultTolerance
+*/
+void SVGPathMeasureInit(SVGPathMeasure* measure, double tolerance);
+
+/*! @brief release the vertex table
+*/
+void SVGPathMeasureFree(SVGPathMeasure* measure);
+
+/*! @brief build the table. Moves start a new subpath without adding to the length, a close adds the segment back to the start of the subpath.
+*/
+void SVGPathMeasureMoveTo(SVGPathMeasure* measure, double x, double y);
+void SVGPathMeasureLineTo(SVGPathMeasure* measure, double x, double y);
+void SVGPathMeasureQuadTo(SVGPathMeasure* measure, double controlX, double controlY, double x, double y);
+void SVGPathMeasureCubicTo(SVGPathMeasure* measure, double control1X, double control1Y, double control2X, double control2Y, double x, double y);
+void SVGPathMeasureClose(SVGPathMeasure* measure);
+
+/*! @brief total length of every subpath
+*/
+double SVGPathMeasureGetLength(const SVGPathMeasure* measure);
+
+/*! @brief find the point at a distance along the path in O(log n)
+* @param measure a built measure
+* @param distance how far along the path
+* @param position receives the point and direction. A distance before the start or past the end is extrapolated along the first or last segment.
+* @return 1 if distance was on the path, 0 if it was off either end or the path has no length (position is still filled in if there is any segment)
+*/
+int SVGPathMeasureGetPosition(const SVGPathMeasure* measure, double distance, SVGPathMeasurePosition* position);
+
+/*! @brief find the points at many distances along the path in one sweep. Increasing distances, like the midpoints of a run of glyphs, walk forward through the table together for O(n + count), a distance which goes backwards falls back to a binary search.
+* @param measure a built measure
+* @param distances how far along the path for each point
+* @param count number of distances
+* @param positions receives count positions, filled in as SVGPathMeasureGetPosition would
+* @param onPathOrNULL optional, receives count flags, 1 for each distance which was on the path
+* @return how many of the distances were on the path
+*/
+size_t SVGPathMeasureGetPositions(const SVGPathMeasure* measure, const double* distances, size_t count,
+                                  SVGPathMeasurePosition* positions, int* onPathOrNULL);
+
+#if defined(__APPLE__)
+/*! @brief flatten a Core Graphics path into the measure
+* @param measure an initialized measure
+* @param aPath path to measure
+* @return 0 if memory ran out
+*/
+int SVGPathMeasureAppendCGPath(SVGPathMeasure* measure, CGPathRef aPath);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGPathMeasure_h */
@@ -125,7 +125,7 @@ const double kStandardSVGFontScale = 1.2;
 +(NSDictionary*) fontAttributesFromSVGAttributes:(NSDictionary*)SVGattributes
 {
 	NSDictionary* result = nil;
-	NSString*	styleString = [SVGattributes objectForKey:@"style"];
+	NSString*	styleString = [SVGattributes objectForAtom:kGHAttributeStyle];
 	if([styleString length])
 	{
 		result = AttributesFromSVGCompactAttributes(styleString);
@@ -35,6 +35,7 @@
 
 #import "GHImageCache.h"
 #import "SVGContext.h"
+#import "GHAttributeTable.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -53,8 +54,8 @@ CGRect SVGStringToRect( NSString*  serializedRect);
 CGRect SVGStringToRectSlow( NSString*  serializedRect);
 
 /*! \brief utility routine which takes a string and converts it to a UIColor
-* \param stringToConvert such as @"blue", 3 char hex like @"#A7A", 6 char hex like @"#FF77C0", or rgb like @"rgb(0,255,127)"
-* \return a color with an RGB color space
+* \param stringToConvert such as @"blue", 3 char hex like @"#A7A", 6 char hex like @"#FF77C0", 8 char hex with alpha, rgb like @"rgb(0,255,127)" or rgba like @"rgba(0,100%,50%,0.5)"
+* \return a color with an RGB color space, clearColor for 'none', nil if not a color
 */
  UIColor* __nullable  UIColorFromSVGColorString ( NSString *  stringToConvert);
 
@@ -68,8 +69,9 @@ CGRect SVGStringToRectSlow( NSString*  serializedRect);
  NSString*  MorphColorString( NSString*  oldSVGColorString,  NSString*  newSVGColorString, CGFloat fractionThere);
 
 /*! \brief utitlity routine to convert an SVG string representing a set of affine transform operations to the resulting CGAffineTransform
+ * \discussion parsed in one pass with no limit on length. Recently seen strings are remembered in a small lock free cache, as exporters tend to repeat the same 'matrix(...)' many times over.
  * \param transformAttribute a string like 'scale(10,20), translate(22, 0), rotate(.5)'
- * \return an affine transform
+ * \return an affine transform, if the string has an error it is the transform of the functions before it
  * \see CGAffineTransform
  */
 CGAffineTransform SVGTransformToCGAffineTransform( NSString*  transformAttribute);
@@ -141,6 +143,11 @@ BOOL IsStringURL( NSString*  aString); // has URL prefix
 */
  NSString* __nullable  ExtractURLContents( NSString*  aString);
 
+/*! \brief the mapping from 'mix-blend-mode' values to Quartz blend modes
+* \return a dictionary from names such as 'multiply' to NSNumbers wrapping CGBlendMode
+*/
+NSDictionary<NSString*, NSNumber*>* stringToBlendMode(void);
+
 /*! \brief sometimes instead of having attributes in individual XML attributes, they are bundled up in 1 single attribute as in the 'style' attribute
 * \param compactedAttributes a string of colon and semi-colon separated components such as 'stroke-width:8;fill:black;stroke-linecap:round;stroke:purple' 
 *\return dictionary with these extracted into individual attributes
@@ -208,13 +215,20 @@ extern const CGColorRenderingIntent	kColoringRenderingIntent;
 */
 +(BOOL)attributeHasDisplaySetToNone:(NSDictionary*)attributes;
 
-/*! @brief try to find the value for a style attribute inside a dictionary of attributes. Might be free-standing or in a 'style' attribute
+/*! @brief try to find the value for a style attribute inside a dictionary of attributes. Might be free-standing or in a 'style' attribute, the 'style' attribute wins if it's in both
 * @param attributeName which style type attribute are we looking for?
-* @param elementAttributes attributes to look inside
+* @param elementAttributes attributes to look inside, a GHAttributeTable has already split its 'style' attribute
 * @return the value if it is found
 */
 +(nullable NSString*) valueForStyleAttribute:(NSString*)attributeName fromDefinition:(NSDictionary*)elementAttributes;
 
+/*! @brief as valueForStyleAttribute:fromDefinition: but by atom, which is an array index if the attributes are a GHAttributeTable
+* @param atom which style type attribute are we looking for?
+* @param elementAttributes attributes to look inside
+* @return the value if it is found
+*/
++(nullable NSString*) valueForStyleAtom:(GHAttributeAtom)atom fromDefinition:(NSDictionary*)elementAttributes;
+
 /*! @brief try to find the value for a style attribute inside a dictionary of attributes. Might be free-standing or in a 'style' attribute
  * @param attributeName which style type attribute are we looking for?
  * @param elementAttributes attributes to look inside
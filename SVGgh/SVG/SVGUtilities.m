@@ -32,9 +32,10 @@
 #import "GHImageCache.h"
 #import "SVGUtilities.h"
 #import "CrossPlatformImage.h"
+#import "SVGNumberScanner.h"
+#import "GHColorTable.h"
+#include <stdatomic.h>
 
-NSDictionary<NSString*, NSString*>* WebNameMapping(void);
-NSDictionary<NSString*, NSNumber*>* stringToBlendMode(void);
 
 const CGFloat kDegreesToRadiansConstant = (CGFloat)(M_PI/180.0);
 
@@ -164,8 +165,8 @@ NSDictionary* SVGMorphStyleAttributes(NSDictionary*oldAttributes, NSDictionary*
     }
     else if(fractionThere < 1.0)
     {
-        NSDictionary* oldStyles = [SVGToQuartz dictionaryForStyleAttributeString:[oldAttributes objectForKey:@"style"]];
-        NSDictionary* newStyles = [SVGToQuartz dictionaryForStyleAttributeString:[newAttributes objectForKey:@"style"]];
+        NSDictionary* oldStyles = [SVGToQuartz dictionaryForStyleAttributeString:[oldAttributes objectForAtom:kGHAttributeStyle]];
+        NSDictionary* newStyles = [SVGToQuartz dictionaryForStyleAttributeString:[newAttributes objectForAtom:kGHAttributeStyle]];
         NSMutableDictionary* morphedStyles = [newStyles mutableCopy];
         NSMutableDictionary* mutableResult = [newAttributes mutableCopy];
         
@@ -263,7 +264,7 @@ NSDictionary* SVGMorphStyleAttributes(NSDictionary*oldAttributes, NSDictionary*
 
 NSDictionary* SVGMergeStyleAttributes(NSDictionary* parentAttributes, NSDictionary* attributesToMergeIn, attribute_replacement_filter_t filter)
 {
-    NSDictionary* parentStyleAttributes = [SVGToQuartz dictionaryForStyleAttributeString:[parentAttributes objectForKey:@"style"]];
+    NSDictionary* parentStyleAttributes = [SVGToQuartz dictionaryForStyleAttributeString:[parentAttributes objectForAtom:kGHAttributeStyle]];
     NSDictionary* mergeInStyleAttributes = [SVGToQuartz dictionaryForStyleAttributeString:[attributesToMergeIn objectForKey:@"style"]];
                                            
     NSMutableDictionary* mutableResult = (parentAttributes==nil)?[[NSMutableDictionary alloc]initWithCapacity:32]:[parentAttributes mutableCopy];
@@ -442,383 +443,171 @@ NSString* SVGTransformMorph(NSString* oldtransform, NSString* newTransform, CGFl
     
 }
 
-typedef enum  TransformOperationsEnum{
-    kUnknownTransformOperation = 0,
-    kMatrixOperation = 1,
-    kTranslateOperation = 2,
-    kRotateOperation,
-    kScaleOperation,
-    kSkewXOperation,
-    kSkewYOperation,
-    
-}TransformOperationsEnum;
+#define kTransformCacheSlots 256 // power of 2
+#define kMaxCachedTransformLength 120
 
-CGAffineTransform SVGTransformToCGAffineTransformSlow(NSString* transformAttribute);
+// exporters repeat the same transform strings over and over, so remember recent ones. Each slot is a seqlock:
+// readers never block, a writer makes the sequence odd while it fills the slot and a reader that sees it change retries by parsing.
+typedef struct TransformCacheEntry
+{
+    atomic_uint         sequence; // 0 empty, odd while being written
+    uint32_t            length;
+    uint64_t            hash;
+    CGAffineTransform   transform;
+    char                text[kMaxCachedTransformLength];
+} TransformCacheEntry;
+
+static TransformCacheEntry sTransformCache[kTransformCacheSlots];
+
+static uint64_t HashTransformText(const char* text, size_t length)
+{// FNV-1a
+    uint64_t result = 14695981039346656037ULL;
+    for(size_t index = 0; index < length; index++)
+    {
+        result ^= (uint8_t)text[index];
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
 
-CGAffineTransform SVGTransformToCGAffineTransform(NSString* transformAttribute)
+static BOOL LookupCachedTransform(const char* text, size_t length, uint64_t hash, CGAffineTransform* transform)
+{
+    TransformCacheEntry* entry = &sTransformCache[hash & (kTransformCacheSlots-1)];
+    unsigned int sequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+    if(sequence == 0 || (sequence & 1))
+    {
+        return NO;
+    }
+    BOOL result = entry->hash == hash && entry->length == length && memcmp(entry->text, text, length) == 0;
+    CGAffineTransform found = entry->transform;
+    atomic_thread_fence(memory_order_acquire);
+    if(atomic_load_explicit(&entry->sequence, memory_order_relaxed) != sequence)
+    {// overwritten while we looked
+        return NO;
+    }
+    if(result)
+    {
+        *transform = found;
+    }
+    return result;
+}
+
+static void StoreCachedTransform(const char* text, size_t length, uint64_t hash, CGAffineTransform transform)
+{
+    TransformCacheEntry* entry = &sTransformCache[hash & (kTransformCacheSlots-1)];
+    unsigned int sequence = atomic_load_explicit(&entry->sequence, memory_order_relaxed);
+    if((sequence & 1) || !atomic_compare_exchange_strong_explicit(&entry->sequence, &sequence, sequence+1,
+                                                                   memory_order_acquire, memory_order_relaxed))
+    {// somebody else is writing this slot, let them
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    entry->length = (uint32_t)length;
+    entry->hash = hash;
+    entry->transform = transform;
+    memcpy(entry->text, text, length);
+    atomic_store_explicit(&entry->sequence, sequence+2, memory_order_release);
+}
+
+static CGAffineTransform ParseTransform(const char* text, size_t length)
 {
 	CGAffineTransform	result = CGAffineTransformIdentity;
-    NSUInteger stringLength = transformAttribute.length;
-    if(stringLength > 8 && stringLength < 255)
+    const char* cursor = text;
+    const char* end = text+length;
+    SVGTransformFunction function = kSVGTransformMatrix;
+    double values[6];
+    size_t count = 0;
+    // a syntax error ends the list, keeping what came before it
+    while(SVGScanTransformFunction(&cursor, end, &function, values, &count) == 1)
     {
-        NSUInteger stringIndex = 0;
-        char stringBuffer[256]; // YES. I should learn Regular Expressions.
-        char numberBuffer[256];
-        if([transformAttribute  getCString:stringBuffer maxLength:255 encoding:NSASCIIStringEncoding])
+        float parameters[6]; // as precise as the rest of the document's coordinates
+        for(size_t index = 0; index < count; index++)
+        {
+            parameters[index] = (float)values[index];
+        }
+        switch(function)
         {
-            while(stringIndex < stringLength)
+            case kSVGTransformMatrix:
             {
-                BOOL	failed = NO;
-                NSUInteger stringLeft = stringLength-stringIndex;
-                char aChar = stringBuffer[stringIndex];
-                NSUInteger maxParameters = 0;
-                
-                TransformOperationsEnum activeOperation = kUnknownTransformOperation;
-                switch (aChar) {
-                    case 'm':
-                    {
-                        if(stringLeft >= 18 && (strncmp(&stringBuffer[stringIndex], "matrix", 6) == 0))
-                        {
-                            stringIndex+= 6;
-                            activeOperation = kMatrixOperation;
-                            maxParameters= 6;
-                        }
-                        else
-                        {
-                            failed = YES;
-                        }
-                    }
-                    break;
-                    case 't':
-                    {
-                        if(stringLeft >= 12 && (strncmp(&stringBuffer[stringIndex], "translate", 9) == 0))
-                        {
-                            maxParameters= 2;
-                            stringIndex+= 9;
-                            activeOperation = kTranslateOperation;
-                        }
-                        else
-                        {
-                            failed = YES;
-                        }
-                    }
-                    break;
-                    case 'r':
-                    {
-                        if(stringLeft >= 9 && (strncmp(&stringBuffer[stringIndex], "rotate", 6) == 0))
-                        {
-                            stringIndex+= 6;
-                            activeOperation = kRotateOperation;
-                            maxParameters= 3;
-                        }
-                        else
-                        {
-                            failed = YES;
-                        }
-                    }
-                    break;
-                    case 's':
-                    {
-                        if(stringLeft >= 8 && (strncmp(&stringBuffer[stringIndex], "scale", 5) == 0))
-                        {
-                            activeOperation = kScaleOperation;
-                            maxParameters= 2;
-                            stringIndex+= 5;
-                        }
-                        else if(stringLeft >= 8 && (strncmp(&stringBuffer[stringIndex], "skewY", 5) == 0))
-                        {
-                            activeOperation = kSkewYOperation;
-                            maxParameters= 1;
-                            stringIndex+= 5;
-                        }
-                        else if(stringLeft >= 8 && (strncmp(&stringBuffer[stringIndex], "skewX", 5) == 0))
-                        {
-                            activeOperation = kSkewXOperation;
-                            maxParameters= 1;
-                            stringIndex+= 5;
-                        }
-                        else
-                        {
-                            failed = YES;
-                        }
-                    }
-                    break;
-                        
-                    default:
-                        stringIndex+=1;
-                    break;
+                CGAffineTransform specificTransform = CGAffineTransformMake(parameters[0], parameters[1], parameters[2], parameters[3], parameters[4], parameters[5]);
+                result = CGAffineTransformConcat(specificTransform, result);
+            }
+            break;
+            case kSVGTransformTranslate:
+            {
+                CGFloat yTrans = (count == 2) ? parameters[1] : 0.0;
+                result = CGAffineTransformTranslate(result, parameters[0], yTrans);
+            }
+            break;
+            case kSVGTransformScale:
+            {
+                CGFloat yScale = (count == 2) ? parameters[1] : parameters[0];
+                result = CGAffineTransformScale(result, parameters[0], yScale);
+            }
+            break;
+            case kSVGTransformRotate:
+            {
+                CGFloat rotationAngle = parameters[0]*kDegreesToRadiansConstant;
+                if(count == 3)
+                {
+                    CGFloat centerX = parameters[1];
+                    CGFloat centerY = parameters[2];
+                    result = CGAffineTransformTranslate(result,centerX, centerY);
+                    result = CGAffineTransformRotate(result, rotationAngle);
+                    result = CGAffineTransformTranslate(result,-1.0f*centerX, -1.0f*centerY);
                 }
-                
-                
-                
-                if(activeOperation != kUnknownTransformOperation)
+                else
                 {
-                    float parameters[6];
-                    NSUInteger parameterIndex = 0;
-                    BOOL foundParenthesis = NO;
-                    while(stringIndex < stringLength)
-                    {
-                        aChar = stringBuffer[stringIndex++];
-                        if(aChar == '(')
-                        {
-                            foundParenthesis = YES;
-                            break;
-                        }
-                    }
-                    
-                    if(foundParenthesis)
-                    {
-                        BOOL foundEndParenthesis = NO;
-                        while(stringIndex < stringLength && !foundEndParenthesis && !failed)
-                        {
-                            aChar = stringBuffer[stringIndex];
-                            
-                            NSUInteger beginNumberIndex = 0;
-                            BOOL numberSeen = NO;
-                            BOOL periodSeen = NO;
-                            while(beginNumberIndex == 0 && foundEndParenthesis == NO && stringIndex < stringLength)
-                            {
-                                if(aChar == '-')
-                                {
-                                    beginNumberIndex = stringIndex++;
-                                }
-                                else if(aChar == '.')
-                                {
-                                    beginNumberIndex = stringIndex++;
-                                    periodSeen = YES;
-                                }
-                                else if(aChar >= '0' && aChar <= '9')
-                                {
-                                    beginNumberIndex = stringIndex++;
-                                    numberSeen = YES;
-                                }
-                                else if(aChar == ')')
-                                {
-                                    foundEndParenthesis = YES;
-                                    stringIndex++;
-                                }
-                                else
-                                {
-                                    stringIndex++;
-                                }
-                                aChar = stringBuffer[stringIndex];
-                            }
-                            
-                            if(beginNumberIndex > 0)
-                            {
-                                NSUInteger endNumIndex = beginNumberIndex;
-                                while(stringIndex < stringLength)
-                                {
-                                    aChar = stringBuffer[stringIndex++];
-                                    if(aChar >= '0' && aChar <= '9')
-                                    {
-                                        numberSeen = YES;
-                                        endNumIndex++;
-                                    }
-                                    else if(aChar == '.' && !periodSeen)
-                                    {
-                                        periodSeen = YES;
-                                        endNumIndex++;
-                                    }
-                                    else if(aChar == ')')
-                                    {
-                                        foundEndParenthesis = YES;
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        break;
-                                    }
-                                }
-                                if(numberSeen)
-                                {
-                                    memcpy(numberBuffer, &stringBuffer[beginNumberIndex], endNumIndex-beginNumberIndex+1);
-                                    numberBuffer[endNumIndex-beginNumberIndex+1]= 0;
-                                    if(periodSeen)
-                                    {
-                                        parameters[parameterIndex++]  = atof(numberBuffer);
-                                    }
-                                    else
-                                    {
-                                        parameters[parameterIndex++]  = atoi(numberBuffer);
-                                    }
-                                }
-                                else
-                                {
-                                    failed = YES;
-                                }
-                            }
-                            if(parameterIndex > maxParameters)
-                            {
-                                failed = YES;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        failed = YES;
-                    }
-                    if(!failed)
-                    {
-                        switch (activeOperation) {
-                            case     kMatrixOperation:
-                            {
-                                if(parameterIndex != 6)
-                                {
-                                    failed = YES;
-                                }
-                                else
-                                {
-                                    CGAffineTransform specificTransform = CGAffineTransformMake(parameters[0], parameters[1], parameters[2], parameters[3], parameters[4], parameters[5]);
-                                    result = CGAffineTransformConcat(specificTransform, result);
-                                }
-                            }
-                            break;
-                            case     kTranslateOperation:
-                            {
-                                CGFloat	xTrans = 0.0, yTrans = 0.0;
-                                switch(parameterIndex)
-                                {
-                                    default:
-                                    case 0:
-                                    {
-                                        failed = YES;
-                                    }
-                                    break;
-                                    case 2:
-                                    {
-                                        yTrans = parameters[1];
-                                    }// deliberate fallthrough
-                                    case 1:
-                                    {
-                                        xTrans = parameters[0];
-                                        result = CGAffineTransformTranslate(result, xTrans, yTrans);
-                                    }
-                                    break;
-                                }
-                            }
-                            break;
-                            case    kRotateOperation:
-                            {
-                                CGFloat	rotationAngle = 0.0;
-                                switch(parameterIndex)
-                                {
-                                    default:
-                                    case 0:
-                                    {
-                                        failed = YES;
-                                    }
-                                    break;
-                                    case 3:
-                                    {
-                                        CGFloat centerX = parameters[1];
-                                        CGFloat centerY = parameters[2];
-                                        
-                                        rotationAngle = parameters[0]*kDegreesToRadiansConstant;
-                                        
-                                        result = CGAffineTransformTranslate(result,centerX, centerY);
-                                        result = CGAffineTransformRotate(result, rotationAngle);
-                                        result = CGAffineTransformTranslate(result,-1.0f*centerX, -1.0f*centerY);
-                                    }
-                                        break;
-                                    case 1:
-                                    {
-                                        rotationAngle = parameters[0]*kDegreesToRadiansConstant;
-                                        result = CGAffineTransformRotate(result, rotationAngle);
-                                    }
-                                    break;
-                                }
-                            }
-                            break;
-                            case    kScaleOperation:
-                            {
-                                CGFloat	xScale = 1.0, yScale = 1.0;
-                                switch(parameterIndex)
-                                {
-                                    default:
-                                    case 0:
-                                    {
-                                        failed = YES;
-                                    }
-                                    break;
-                                    case 2:
-                                    {
-                                        yScale = parameters[1];
-                                        xScale = parameters[0];
-                                    }
-                                    break;
-                                    case 1:
-                                    {
-                                        yScale = xScale = parameters[0];
-                                    }
-                                    break;
-                                }
-                                result = CGAffineTransformScale(result, xScale, yScale);
-                            }
-                            break;
-                            case    kSkewXOperation:
-                            {
-                                switch(parameterIndex)
-                                {
-                                    default:
-                                    case 0:
-                                    {
-                                        failed = YES;
-                                    }
-                                    break;
-                                    case 1:
-                                    {
-                                        CGFloat skewAngleDegrees = parameters[0];
-                                        double skewAngle = skewAngleDegrees*M_PI/180.0;
-                                        double	tanSkewAngle = tan(skewAngle);
-                                        CGAffineTransform skewedTransform = CGAffineTransformIdentity;
-                                        skewedTransform.c = (CGFloat)tanSkewAngle;
-                                        
-                                        result = CGAffineTransformConcat(skewedTransform, result);
-                                    }
-                                    break;
-                                }
-                            }
-                            break;
-                            case    kSkewYOperation:
-                            {
-                                switch(parameterIndex)
-                                {
-                                    default:
-                                    case 0:
-                                    {
-                                        failed = YES;
-                                    }
-                                    break;
-                                    case 1:
-                                    {
-                                        CGFloat skewAngleDegrees = parameters[0];
-                                        double skewAngle = skewAngleDegrees*M_PI/180.0;
-                                        double	tanSkewAngle = tan(skewAngle);
-                                        
-                                        CGAffineTransform skewedTransform = CGAffineTransformIdentity;
-                                        skewedTransform.b = tanSkewAngle;
-                                        result = CGAffineTransformConcat(skewedTransform, result);
-                                    }
-                                    break;
-                                }
-                            }
-                            break;
-                                
-                            default:
-                            break;
-                        }
-                    }
-                    
+                    result = CGAffineTransformRotate(result, rotationAngle);
                 }
-                if(failed)
+            }
+            break;
+            case kSVGTransformSkewX:
+            case kSVGTransformSkewY:
+            {
+                CGFloat skewAngleDegrees = parameters[0];
+                double skewAngle = skewAngleDegrees*M_PI/180.0;
+                double	tanSkewAngle = tan(skewAngle);
+                CGAffineTransform skewedTransform = CGAffineTransformIdentity;
+                if(function == kSVGTransformSkewX)
                 {
-                    break;
+                    skewedTransform.c = (CGFloat)tanSkewAngle;
                 }
+                else
+                {
+                    skewedTransform.b = (CGFloat)tanSkewAngle;
+                }
+                result = CGAffineTransformConcat(skewedTransform, result);
             }
+            break;
+        }
+    }
+    return result;
+}
+
+CGAffineTransform SVGTransformToCGAffineTransformSlow(NSString* transformAttribute);
+
+CGAffineTransform SVGTransformToCGAffineTransform(NSString* transformAttribute)
+{
+	CGAffineTransform	result = CGAffineTransformIdentity;
+    const char* text = [transformAttribute UTF8String];
+    size_t length = (text != NULL) ? strlen(text) : 0;
+    if(length > 0)
+    {
+        if(length <= kMaxCachedTransformLength)
+        {
+            uint64_t hash = HashTransformText(text, length);
+            if(!LookupCachedTransform(text, length, hash, &result))
+            {
+                result = ParseTransform(text, length);
+                StoreCachedTransform(text, length, hash, result);
+            }
+        }
+        else
+        {
+            result = ParseTransform(text, length);
         }
     }
-    
     return result;
 }
 
@@ -1077,450 +866,9 @@ NSString* MorphColorString(NSString* oldSVGColorString, NSString* newSVGColorStr
     return result;
 }
 
-NSDictionary<NSString*, NSString*>* WebNameMapping(void)
-{
-    static NSDictionary<NSString*, NSString*>* sResult = nil;
-    static dispatch_once_t  done;
-    dispatch_once(&done, ^{
-        NSDictionary<NSString*, NSString*>* htmlColorMap =
-        @{@"aliceblue":@"#f0f8ff",
-          @"antiquewhite":@"#faebd7",
-          @"aqua":@"#00ffff",
-          @"aquamarine":@"#7fffd4",
-          @"azure":@"#f0ffff",
-          @"beige":@"#f5f5dc",
-          @"bisque":@"#ffe4c4",
-          @"black":@"#000000",
-          @"blanchedalmond":@"#ffebcd",
-          @"blue":@"#0000ff",
-          @"blueviolet":@"#8a2be2",
-          @"brown":@"#a52a2a",
-          @"burlywood":@"#deb887",
-          @"cadetblue":@"#5f9ea0",
-          @"chartreuse":@"#7fff00",
-          @"chocolate":@"#d2691e",
-          @"coral":@"#ff7f50",
-          @"cornflowerblue":@"#6495ed",
-          @"cornsilk":@"#fff8dc",
-          @"crimson":@"#dc143c",
-          @"cyan":@"#00ffff",
-          @"darkblue":@"#00008b",
-          @"darkcyan":@"#008b8b",
-          @"darkgoldenrod":@"#b8860b",
-          @"darkgray":@"#a9a9a9",
-          @"darkgrey":@"#a9a9a9",
-          @"darkgreen":@"#006400",
-          @"darkkhaki":@"#bdb76b",
-          @"darkmagenta":@"#8b008b",
-          @"darkolivegreen":@"#556b2f",
-          @"darkorange":@"#ff8c00",
-          @"darkorchid":@"#9932cc",
-          @"darkred":@"#8b0000",
-          @"darksalmon":@"#e9967a",
-          @"darkseagreen":@"#8fbc8f",
-          @"darkslateblue":@"#483d8b",
-          @"darkslategray":@"#2f4f4f",
-          @"darkslategrey":@"#2f4f4f",
-          @"darkturquoise":@"#00ced1",
-          @"darkviolet":@"#9400d3",
-          @"deeppink":@"#ff1493",
-          @"deepskyblue":@"#00bfff",
-          @"dimgray":@"#696969",
-          @"dimgrey":@"#696969",
-          @"dodgerblue":@"#1e90ff",
-          @"firebrick":@"#b22222",
-          @"floralwhite":@"#fffaf0",
-          @"forestgreen":@"#228b22",
-          @"fuchsia":@"#ff00ff",
-          @"gainsboro":@"#dcdcdc",
-          @"ghostwhite":@"#f8f8ff",
-          @"gold":@"#ffd700",
-          @"goldenrod":@"#daa520",
-          @"gray":@"#808080",
-          @"grey":@"#808080",
-          @"green":@"#008000",
-          @"greenyellow":@"#adff2f",
-          @"honeydew":@"#f0fff0",
-          @"hotpink":@"#ff69b4",
-          @"indianred":@"#cd5c5c",
-          @"indigo":@"#4b0082",
-          @"ivory":@"#fffff0",
-          @"khaki":@"#f0e68c",
-          @"lavender":@"#e6e6fa",
-          @"lavenderblush":@"#fff0f5",
-          @"lawngreen":@"#7cfc00",
-          @"lemonchiffon":@"#fffacd",
-          @"lightblue":@"#add8e6",
-          @"lightcoral":@"#f08080",
-          @"lightcyan":@"#e0ffff",
-          @"lightgoldenrodyellow":@"#fafad2",
-          @"lightgray":@"#d3d3d3",
-          @"lightgrey":@"#d3d3d3",
-          @"lightgreen":@"#90ee90",
-          @"lightpink":@"#ffb6c1",
-          @"lightsalmon":@"#ffa07a",
-          @"lightseagreen":@"#20b2aa",
-          @"lightskyblue":@"#87cefa",
-          @"lightslategray":@"#778899",
-          @"lightslategrey":@"#778899",
-          @"lightsteelblue":@"#b0c4de",
-          @"lightyellow":@"#ffffe0",
-          @"lime":@"#00ff00",
-          @"limegreen":@"#32cd32",
-          @"linen":@"#faf0e6",
-          @"magenta":@"#ff00ff",
-          @"maroon":@"#800000",
-          @"mediumaquamarine":@"#66cdaa",
-          @"mediumblue":@"#0000cd",
-          @"mediumorchid":@"#ba55d3",
-          @"mediumpurple":@"#9370db",
-          @"mediumseagreen":@"#3cb371",
-          @"mediumslateblue":@"#7b68ee",
-          @"mediumspringgreen":@"#00fa9a",
-          @"mediumturquoise":@"#48d1cc",
-          @"mediumvioletred":@"#c71585",
-          @"midnightblue":@"#191970",
-          @"mintcream":@"#f5fffa",
-          @"mistyrose":@"#ffe4e1",
-          @"moccasin":@"#ffe4b5",
-          @"navajowhite":@"#ffdead",
-          @"navy":@"#000080",
-          @"oldlace":@"#fdf5e6",
-          @"olive":@"#808000",
-          @"olivedrab":@"#6b8e23",
-          @"orange":@"#ffa500",
-          @"orangered":@"#ff4500",
-          @"orchid":@"#da70d6",
-          @"palegoldenrod":@"#eee8aa",
-          @"palegreen":@"#98fb98",
-          @"paleturquoise":@"#afeeee",
-          @"palevioletred":@"#db7093",
-          @"papayawhip":@"#ffefd5",
-          @"peachpuff":@"#ffdab9",
-          @"peru":@"#cd853f",
-          @"pink":@"#ffc0cb",
-          @"plum":@"#dda0dd",
-          @"powderblue":@"#b0e0e6",
-          @"purple":@"#800080",
-          @"rebeccapurple":@"#663399",
-          @"red":@"#ff0000",
-          @"rosybrown":@"#bc8f8f",
-          @"royalblue":@"#4169e1",
-          @"saddlebrown":@"#8b4513",
-          @"salmon":@"#fa8072",
-          @"sandybrown":@"#f4a460",
-          @"seagreen":@"#2e8b57",
-          @"seashell":@"#fff5ee",
-          @"sienna":@"#a0522d",
-          @"silver":@"#c0c0c0",
-          @"skyblue":@"#87ceeb",
-          @"slateblue":@"#6a5acd",
-          @"slategray":@"#708090",
-          @"slategrey":@"#708090",
-          @"snow":@"#fffafa",
-          @"springgreen":@"#00ff7f",
-          @"steelblue":@"#4682b4",
-          @"tan":@"#d2b48c",
-          @"teal":@"#008080",
-          @"thistle":@"#d8bfd8",
-          @"tomato":@"#ff6347",
-          @"turquoise":@"#40e0d0",
-          @"violet":@"#ee82ee",
-          @"wheat":@"#f5deb3",
-          @"white":@"#ffffff",
-          @"whitesmoke":@"#f5f5f5",
-          @"yellow":@"#ffff00",
-          @"yellowgreen":@"#9acd32",
-          };
-        sResult = [htmlColorMap copy];
-    });
-    return sResult;
-}
-
-UIColor* UIColorFromWebName(NSString* stringToConvert)
-{
-    NSDictionary<NSString*, NSString*>* colorMap = WebNameMapping();
-    UIColor* result = nil;
-    NSString* colorRGBString = [colorMap valueForKey:stringToConvert.lowercaseString];
-    if(colorRGBString.length)
-    {
-        result = UIColorFromSVGColorString(colorRGBString); // this will be a mild recursion
-    }
-    
-    return result;
-}
-
 UIColor* UIColorFromSVGColorString (NSString * stringToConvert)
 {
-    
-    static NSCache* sCache = nil;
-    static dispatch_once_t  done;
-    dispatch_once(&done, ^{
-        sCache = [[NSCache alloc] init];
-        sCache.name = @"Color Cache";
-    });
-    
-    UIColor* result = [sCache objectForKey:stringToConvert];
-    if(result == nil)
-    {
-        NSString *cString = [stringToConvert stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        // strip 0X if it appears
-        unsigned int r = 0, g = 0, b = 0;
-        CGFloat alpha = 1.0;
-        if ([cString hasPrefix:@"#"])
-        {
-            cString = [cString substringFromIndex:1];
-            
-            // Separate into r, g, b substrings
-            NSRange range;
-            NSString *rString = nil;
-            NSString *gString = nil;
-            NSString *bString = nil;
-            NSUInteger stringLength = [cString length];
-            if(stringLength == 3)
-            {
-                NSMutableString* mutableCString = [NSMutableString stringWithString:cString];
-                [mutableCString insertString:[mutableCString substringWithRange:NSMakeRange(0, 1)] atIndex:1];
-                [mutableCString insertString:[mutableCString substringWithRange:NSMakeRange(2, 1)] atIndex:3];
-                [mutableCString insertString:[mutableCString substringWithRange:NSMakeRange(4, 1)] atIndex:5];
-                cString = mutableCString;
-                stringLength = 6;
-            }
-            if(stringLength >= 2)
-            {
-                range.location = 0;
-                range.length = 2;
-                
-                rString = [cString substringWithRange:range];
-            }
-            
-            if(stringLength >= 4)
-            {
-                range.location = 2;
-                gString = [cString substringWithRange:range];
-            }
-            
-            if(stringLength >= 6)
-            {
-                range.location = 4;
-                bString = [cString substringWithRange:range];
-            }
-            if(gString == nil)
-            {
-                gString = rString;
-            }
-            if(bString == nil)
-            {
-                bString = gString;
-            }
-            if(rString != nil)
-            {
-                // Scan values
-                [[NSScanner scannerWithString:rString] scanHexInt:&r];
-                [[NSScanner scannerWithString:gString] scanHexInt:&g];
-                [[NSScanner scannerWithString:bString] scanHexInt:&b];
-            }
-        }
-        else if([stringToConvert hasPrefix:@"rgb"] || [stringToConvert hasPrefix:@"RGB"])
-        {
-            NSString*	trimmedString = [stringToConvert stringByTrimmingCharactersInSet:[[NSCharacterSet characterSetWithCharactersInString:@"()"] invertedSet]];
-            if([trimmedString length])
-            {
-                trimmedString = [trimmedString stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"()"]];
-                
-                NSArray* components = [trimmedString componentsSeparatedByString:@","];
-                NSString*	redString = nil;
-                NSString*	greenString = nil;
-                NSString*	blueString = nil;
-                NSUInteger	countOfComponents = [components count];
-                if(countOfComponents > 0)
-                {
-                    redString = [[components objectAtIndex:0] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-                }
-                if(countOfComponents > 1)
-                {
-                    greenString = [[components objectAtIndex:1] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-                }
-                if(countOfComponents > 2)
-                {
-                    blueString = [[components objectAtIndex:2] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-                }
-                if(greenString == nil) greenString = redString;
-                if(blueString == nil) blueString = greenString;
-                
-                if([redString hasSuffix:@"%"])
-                {
-                    r = (unsigned int)(2.55*[redString doubleValue]);
-                }
-                else
-                {
-                    r = [redString intValue];
-                }
-                if([greenString hasSuffix:@"%"])
-                {
-                    g = (unsigned int)(2.55*[greenString doubleValue]);
-                }
-                else
-                {
-                    g = [greenString intValue];
-                }
-                if([blueString hasSuffix:@"%"])
-                {
-                    b = (unsigned int)(2.55*[blueString doubleValue]);
-                }
-                else
-                {
-                    b = [blueString intValue];
-                }
-            }
-        }
-        else
-        {
-            if([stringToConvert isEqualToString:@"black"])
-            {
-                r = 0;
-                g = 0;
-                b = 0;
-            }
-            else if([stringToConvert isEqualToString:@"white"])
-            {
-                r = 255;
-                g = 255;
-                b = 255;
-            }
-            else if([stringToConvert isEqualToString:@"none"] || [stringToConvert isEqualToString:@"transparent"])
-            { // I've been told that sometimes web developers will use 'transparent' then the more proper color is 'none'
-                return [UIColor clearColor];
-            }
-            else if([stringToConvert isEqualToString:@"ActiveBorder"])
-            {
-                result = [UIColor greenColor];
-            }
-            else if([stringToConvert isEqualToString:@"ActiveCaption"])
-            {
-                result = [UIColor greenColor];
-            }
-            else if([stringToConvert isEqualToString:@"ButtonFace"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ButtonHighlight"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ButtonShadow"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"ButtonText"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"CaptionText"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"GrayText"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"Highlight"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"HighlightText"])
-            {
-                result = [UIColor whiteColor];
-            }
-            else if([stringToConvert isEqualToString:@"InactiveBorder"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"InactiveCaption"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"InactiveCaptionText"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"InfoBackground"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"InfoText"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"Menu"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"MenuText"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"Scrollbar"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"ThreeDDarkShadow"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ThreeDFace"])
-            {
-                result = [UIColor lightGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ThreeDHighlight"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ThreeDLightShadow"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"ThreeDShadow"])
-            {
-                result = [UIColor darkGrayColor];
-            }
-            else if([stringToConvert isEqualToString:@"Window"])
-            {
-                result = [UIColor whiteColor];
-            }
-            else if([stringToConvert isEqualToString:@"WindowFrame"])
-            {
-            }
-            else if([stringToConvert isEqualToString:@"WindowText"])
-            {
-            }
-            else
-            {
-                NSString* lowerCaseStringToConvert = [stringToConvert lowercaseString];
-                result = UIColorFromWebName(lowerCaseStringToConvert);
-                if(result == nil)
-                {
-                    [sCache setObject:[NSNull null] forKey:stringToConvert cost:4];
-                    return nil;
-                }
-            }
-        }
-        
-        if(result == nil)
-        {
-            CGFloat	redF = (CGFloat) r / 255.0f;
-            CGFloat	greenF =(CGFloat) g / 255.0f;
-            CGFloat	blueF =(CGFloat) b / 255.0f;
-            result = [UIColor colorWithRed:redF
-                                     green:greenF
-                                      blue:blueF
-                                     alpha:alpha];
-        }
-        
-        if(result != nil)
-        {
-            [sCache setObject:result forKey:stringToConvert cost:6];
-        }
-    }
-    else if([result isKindOfClass:[NSNull class]])
-    {
-        result = nil;
-    }
-    
-    
-	return result;
+    return [[GHColorTable sharedColorTable] colorForSVGColorString:stringToConvert];
 }
 
 
@@ -1543,112 +891,14 @@ CGRect SVGStringToRectSlow(NSString* serializedRect)
 CGRect SVGStringToRect(NSString* serializedRect)
 {
     CGRect	result  = CGRectZero;
-    NSInteger stringLength = serializedRect.length;
-    if(stringLength >= 7 && stringLength < 255)
+    const char* rectString = [serializedRect UTF8String];
+    if(rectString != NULL)
     {
-        NSInteger stringIndex = 0;
-        char stringBuffer[256]; // YES. I should learn Regular Expressions.
-        char numberBuffer[256];
-        if([serializedRect  getCString:stringBuffer maxLength:255 encoding:NSASCIIStringEncoding])
+        const char* end = rectString+strlen(rectString);
+        double parameters[4];
+        if(SVGScanNumbers(&rectString, end, parameters, 4) == 4)
         {
-            while(stringIndex < stringLength)
-            {
-                char aChar = stringBuffer[stringIndex];
-                if(aChar == '-' || aChar == '.' || (aChar >= '0' && aChar <= '9'))
-                {
-                    break;
-                }
-                else
-                {
-                    stringIndex++;
-                }
-            }
-            if((stringLength-stringIndex) >= 7)
-            {
-                float parameters[4];
-                NSUInteger parameterIndex = 0;
-                BOOL failed = NO;
-                while(stringIndex < stringLength && !failed && parameterIndex < 4)
-                {
-                    char aChar = stringBuffer[stringIndex];
-                    
-                    NSInteger beginNumberIndex = -1;
-                    BOOL numberSeen = NO;
-                    BOOL periodSeen = NO;
-                    while(beginNumberIndex == -1 && stringIndex < stringLength)
-                    {
-                        if(aChar == '-')
-                        {
-                            beginNumberIndex = stringIndex++;
-                        }
-                        else if(aChar == '.')
-                        {
-                            beginNumberIndex = stringIndex++;
-                            periodSeen = YES;
-                        }
-                        else if(aChar >= '0' && aChar <= '9')
-                        {
-                            beginNumberIndex = stringIndex++;
-                            numberSeen = YES;
-                        }
-                        else
-                        {
-                            stringIndex++;
-                        }
-                        aChar = stringBuffer[stringIndex];
-                    }
-                    
-                    if(beginNumberIndex > -1)
-                    {
-                        NSInteger endNumIndex = beginNumberIndex;
-                        while(stringIndex < stringLength)
-                        {
-                            aChar = stringBuffer[stringIndex++];
-                            if(aChar >= '0' && aChar <= '9')
-                            {
-                                numberSeen = YES;
-                                endNumIndex++;
-                            }
-                            else if(aChar == '.' && !periodSeen)
-                            {
-                                periodSeen = YES;
-                                endNumIndex++;
-                            }
-                            else
-                            {
-                                break;
-                            }
-                        }
-                        if(numberSeen)
-                        {
-                            memcpy(numberBuffer, &stringBuffer[beginNumberIndex], endNumIndex-beginNumberIndex+1);
-                            numberBuffer[endNumIndex-beginNumberIndex+1]= 0;
-                            if(periodSeen)
-                            {
-                                parameters[parameterIndex++]  = atof(numberBuffer);
-                            }
-                            else
-                            {
-                                parameters[parameterIndex++]  = atoi(numberBuffer);
-                            }
-                        }
-                        else
-                        {
-                            failed = YES;
-                        }
-                    }
-                    else
-                    {
-                        failed = YES;
-                    }
-                }
-                
-                if(!failed)
-                {
-                    result = CGRectMake(parameters[0], parameters[1], parameters[2], parameters[3]);
-                }
-                
-            }
+            result = CGRectMake(parameters[0], parameters[1], parameters[2], parameters[3]);
         }
     }
 
@@ -1660,118 +910,20 @@ CGRect SVGStringToRect(NSString* serializedRect)
 CGFloat	GetNextCoordinate(const char* buffer, NSUInteger* indexPtr, NSUInteger bufferLength, BOOL* failed)
 { // retrieve the next value from the d parameter of an SVG path
 	CGFloat	result = 0.0;
-	NSUInteger	srcBufferIndex = *indexPtr;
-	char	theChar = 0;
-    BOOL numberSeen = NO;
-    
-    if(srcBufferIndex < bufferLength)
+    const char* end = buffer+bufferLength;
+    const char* cursor = buffer+MIN(*indexPtr, bufferLength);
+    double value = 0.0;
+    const char* numberEnd = SVGScanNumber(SVGSkipNumberSeparators(cursor, end), end, &value);
+    if(numberEnd == NULL)
     {
-        theChar = buffer[srcBufferIndex];
-        if((theChar >= '0' && theChar <= '9') || theChar == '-' || theChar == '.' || theChar == '+' || theChar == ' ' || theChar == '\n' || theChar == 'e')
-        {
-            srcBufferIndex++;
-        }
-        else
-        {
-            *failed = YES;
-        }
+        *failed = YES;
     }
     else
     {
-        *failed = YES;
+        result = (CGFloat)value;
+        cursor = SVGSkipNumberSeparators(numberEnd, end); // jump to the next operand or number
     }
-	
-	while(*failed == NO && !(theChar == '-' || theChar == '+' || theChar == '.' || (theChar >= '0' && theChar <= '9') || theChar == 'e'))
-	{
-        if(srcBufferIndex < bufferLength)
-        {
-            theChar = buffer[srcBufferIndex];
-            if((theChar >= '0' && theChar <= '9') || theChar == '-' || theChar == '.' || theChar == '+' || theChar == ' ' || theChar == '\n')
-            {
-                srcBufferIndex++;
-            }
-            else
-            {
-                *failed = YES;
-            }
-        }
-        else
-        {
-            *failed = YES;
-        }
-		if(srcBufferIndex >= bufferLength)
-		{
-			break;
-		}
-	}
-	if(*failed == NO)
-    {
-        char	stringBuffer[100];
-        NSUInteger	stringBufferIndex = 0;
-        
-        if(theChar == '-' || theChar == '+' || theChar == '.' || (theChar >= '0' && theChar <= '9') || theChar == 'e')
-        {
-            stringBuffer[stringBufferIndex++] = theChar;
-            numberSeen = (theChar >= '0' && theChar <= '9');
-        }
-        BOOL periodSeen = theChar == '.', expSeen = NO;
-        while(srcBufferIndex < bufferLength)
-        {
-            theChar = buffer[srcBufferIndex];
-            if((theChar == '.' && !periodSeen)
-               || (theChar >= '0' && theChar <= '9') || theChar == 'e' || (expSeen && (theChar == '-' || theChar == '+')))
-            {
-                if(theChar == '.')
-                {
-                    periodSeen = YES;
-                }
-                else if(theChar >= '0' && theChar <= '9')
-                {
-                    numberSeen = YES;
-                }
-                else if(theChar == 'e')
-                {
-                    expSeen = YES;
-                }
-                srcBufferIndex++;
-                stringBuffer[stringBufferIndex++] = theChar;
-                if(stringBufferIndex > 98)
-                {
-                    NSLog(@"Path number way too long:%s", stringBuffer);
-                    break;
-                }
-            }
-            else
-            {
-                break;
-            }
-        }
-        if(stringBufferIndex > 0 && numberSeen)
-        {
-            stringBuffer[stringBufferIndex++] = 0;
-            char* endPtr = &stringBuffer[stringBufferIndex];
-            if(periodSeen || expSeen)
-            {
-                result = strtof(stringBuffer, &endPtr);
-            }
-            else
-            {
-                result = strtol(stringBuffer, &endPtr, 10);
-            }
-        }
-        else if(srcBufferIndex >= bufferLength)
-        {
-            *failed = YES;
-        }
-        
-        while(srcBufferIndex < bufferLength && 
-              !((theChar >= 'a' && theChar <= 'z') || (theChar >= 'A' && theChar <= 'Z')
-                || theChar == '-' || theChar == '+' || theChar == '.' || (theChar >= '0' && theChar <= '9') || theChar == 'e'))
-        { // jump to the next operand or number
-            theChar = buffer[++srcBufferIndex];
-        }
-	}
-	*indexPtr = srcBufferIndex;
+	*indexPtr = (NSUInteger)(cursor-buffer);
 	return result;
 }
 
@@ -2047,7 +1199,7 @@ NSDictionary<NSString*, NSNumber*>* stringToBlendMode(void)
 +(BOOL)attributeHasDisplaySetToNone:(NSDictionary*)attributes
 {
     BOOL result = NO;
-    NSString* displayString = [attributes objectForKey:@"display"];
+    NSString* displayString = [attributes objectForAtom:kGHAttributeDisplay];
     if([displayString isEqualToString:@"none"])
     {
         result = YES;
@@ -2300,41 +1452,32 @@ NSDictionary<NSString*, NSNumber*>* stringToBlendMode(void)
 
 
 +(NSString*) valueForStyleAttribute:(NSString*)attributeName fromDefinition:(NSDictionary*)elementAttributes
-{
-	NSString* result = [elementAttributes objectForKey:attributeName];
-	if(result == nil)
+{// a declaration in 'style' beats a presentation attribute, unless it's 'inherit' and the inherited value has been put in the attribute
+	NSString* result = [elementAttributes styleValueForName:attributeName];
+	if(result == nil || [result isEqualToString:@"inherit"])
 	{
-		NSString*	styleString = [elementAttributes objectForKey:@"style"];
-		if([styleString length])
-		{
-			NSArray* components = [styleString componentsSeparatedByString:@";"];
-			if([components count])
-			{
-				NSString* prefix = [attributeName stringByAppendingString:@":"];
-				for(NSString* aValuePairString in components)
-				{
-                    NSString* trimmedValuePairString = [aValuePairString stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-					if([trimmedValuePairString hasPrefix:prefix] && trimmedValuePairString.length > prefix.length)
-					{
-						result = [aValuePairString substringFromIndex:[prefix length]];
-                        result = [result stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-						break;
-					}
-				}
-			}
-		}
+		result = [elementAttributes objectForKey:attributeName] ?: result;
 	}
 	return result;
 }
 
++(NSString*) valueForStyleAtom:(GHAttributeAtom)atom fromDefinition:(NSDictionary*)elementAttributes
+{
+    NSString* result = [elementAttributes styleValueForAtom:atom];
+    if(result == nil || [result isEqualToString:@"inherit"])
+    {
+        result = [elementAttributes objectForAtom:atom] ?: result;
+    }
+    return result;
+}
+
 +(NSString*) valueForStyleAttribute:(NSString*)attributeName fromDefinition:(NSDictionary*)elementAttributes forEnityName:(NSString*)entityTypeName withSVGContext:(id<SVGContext> __nullable)svgContext
 {
     NSString* result = nil;
     
-    if(svgContext.hasCSSAttributes)
-    {
-        NSArray* classes = [[elementAttributes valueForKey:@"class"] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        result = [svgContext attributeNamed:attributeName classes:classes entityName:entityTypeName];
+    if(svgContext.hasCSSAttributes && [elementAttributes styleValueForName:attributeName] == nil)
+    {// an inline style beats the style sheet. The class list of a GHAttributeTable was split when it was made
+        result = [svgContext attributeNamed:attributeName classes:[elementAttributes cssClassNames] entityName:entityTypeName];
     }
     
     if(result == nil)
@@ -0,0 +1,86 @@
+//
+//  GHColorTable.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+@import UIKit;
+#else
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief pack color components from 0 to 1 into the 0xRRGGBBAA key GHColorTable uses, rounding each to 8 bits
+*/
+uint32_t GHPackColorComponents(CGFloat red, CGFloat green, CGFloat blue, CGFloat alpha);
+
+/*! @brief a process wide table of immutable colors keyed by packed RGBA, so every renderer drawing '#333' shares one color object
+* @note lookups never lock or wait, a color is added once and kept for the life of the table. Once the table is full new colors are still made, just not kept.
+*/
+@interface GHColorTable : NSObject
+
+/*! @brief the table used by UIColorFromSVGColorString and therefore by every SVGRenderer
+*/
++(GHColorTable*) sharedColorTable;
+
+/*! @brief create a table which will keep at most a given number of colors
+* @param capacity rounded up to a power of 2
+*/
+-(instancetype) initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*! @brief the shared color for a packed RGBA value
+* @param packedRGBA as 0xRRGGBBAA
+* @return an immutable color with an RGB color space
+*/
+-(UIColor*) colorForPackedRGBA:(uint32_t)packedRGBA;
+
+/*! @brief the CGColor of colorForPackedRGBA:
+* @param packedRGBA as 0xRRGGBBAA
+* @return a color owned by the table, or autoreleased if the table had no room for it
+*/
+-(CGColorRef) CGColorForPackedRGBA:(uint32_t)packedRGBA CF_RETURNS_NOT_RETAINED;
+
+/*! @brief parse an SVG color and return the shared color for it. Does not know about 'currentColor', that's up to the SVGContext.
+* @param svgColorString such as @"blue", @"#A7A", @"#FF77C080" or @"rgba(0,100%,50%,0.5)"
+* @return the color, clearColor for 'none' or 'transparent', nil if not a color
+*/
+-(nullable UIColor*) colorForSVGColorString:(NSString*)svgColorString;
+
+/*! @property count how many colors the table is holding
+*/
+@property(nonatomic, readonly) NSUInteger count;
+
+/*! @property capacity the most colors the table will hold
+*/
+@property(nonatomic, readonly) NSUInteger capacity;
+@end
+
+NS_ASSUME_NONNULL_END
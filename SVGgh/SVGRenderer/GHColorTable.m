@@ -0,0 +1,200 @@
+//
+//  GHColorTable.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#import "GHColorTable.h"
+#import "SVGColorParser.h"
+#include <stdatomic.h>
+
+static const NSUInteger kDefaultColorTableCapacity = 2048;
+static const NSUInteger kMaximumColorTableProbes = 16;
+
+typedef struct GHColorTableSlot
+{
+    _Atomic(uint64_t)   tag;    // 0 for empty, otherwise the packed RGBA + 1
+    _Atomic(void*)      color;  // a retained UIColor, NULL until the slot's owner has published it
+} GHColorTableSlot;
+
+uint32_t GHPackColorComponents(CGFloat red, CGFloat green, CGFloat blue, CGFloat alpha)
+{
+    CGFloat components[4] = {red, green, blue, alpha};
+    uint32_t result = 0;
+    for(NSUInteger index = 0; index < 4; index++)
+    {
+        CGFloat component = components[index];
+        component = (component < 0.0) ? 0.0 : ((component > 1.0) ? 1.0 : component);
+        result = (result << 8) | (uint32_t)(component*255.0+0.5);
+    }
+    return result;
+}
+
+static UIColor* NewColorForPackedRGBA(uint32_t packedRGBA)
+{
+    return [UIColor colorWithRed:(CGFloat)((packedRGBA >> 24) & 0xFF)/255.0
+                           green:(CGFloat)((packedRGBA >> 16) & 0xFF)/255.0
+                            blue:(CGFloat)((packedRGBA >> 8) & 0xFF)/255.0
+                           alpha:(CGFloat)(packedRGBA & 0xFF)/255.0];
+}
+
+@implementation GHColorTable
+{
+    GHColorTableSlot*   _slots;
+    NSUInteger          _mask;
+    atomic_ulong        _count;
+}
+
++(GHColorTable*) sharedColorTable
+{
+    static GHColorTable* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sResult = [[GHColorTable alloc] init];
+    });
+    return sResult;
+}
+
+-(instancetype) init
+{
+    return [self initWithCapacity:kDefaultColorTableCapacity];
+}
+
+-(instancetype) initWithCapacity:(NSUInteger)capacity
+{
+    if(nil != (self = [super init]))
+    {
+        NSUInteger slotCount = 1;
+        while(slotCount < capacity)
+        {
+            slotCount <<= 1;
+        }
+        _slots = calloc(slotCount, sizeof(GHColorTableSlot));
+        _mask = slotCount-1;
+        atomic_init(&_count, 0);
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    for(NSUInteger index = 0; index <= _mask; index++)
+    {
+        void* color = atomic_load(&_slots[index].color);
+        if(color != NULL)
+        {
+            CFRelease(color);
+        }
+    }
+    free(_slots);
+}
+
+-(NSUInteger) count
+{
+    return atomic_load(&_count);
+}
+
+-(NSUInteger) capacity
+{
+    return _mask+1;
+}
+
+-(UIColor*) sharedColorForPackedRGBA:(uint32_t)packedRGBA
+{// nil if the color isn't in the table and can't be added to it
+    uint64_t tag = (uint64_t)packedRGBA+1;
+    NSUInteger start = (NSUInteger)((packedRGBA*2654435761u) >> 7);
+    for(NSUInteger probe = 0; probe < kMaximumColorTableProbes; probe++)
+    {
+        GHColorTableSlot* slot = &_slots[(start+probe) & _mask];
+        uint64_t foundTag = atomic_load_explicit(&slot->tag, memory_order_acquire);
+        if(foundTag == 0)
+        {
+            if(atomic_compare_exchange_strong_explicit(&slot->tag, &foundTag, tag, memory_order_acq_rel, memory_order_acquire))
+            {
+                UIColor* result = NewColorForPackedRGBA(packedRGBA);
+                atomic_store_explicit(&slot->color, (void*)CFBridgingRetain(result), memory_order_release);
+                atomic_fetch_add_explicit(&_count, 1, memory_order_relaxed);
+                return result;
+            }
+            // otherwise another thread just took the slot, foundTag is now its tag
+        }
+        if(foundTag == tag)
+        {// NULL while the thread which claimed the slot is still making the color, rather than wait just make another
+            return (__bridge UIColor*)atomic_load_explicit(&slot->color, memory_order_acquire);
+        }
+    }
+    return nil;
+}
+
+-(UIColor*) colorForPackedRGBA:(uint32_t)packedRGBA
+{
+    UIColor* result = [self sharedColorForPackedRGBA:packedRGBA];
+    if(result == nil)
+    {
+        result = NewColorForPackedRGBA(packedRGBA);
+    }
+    return result;
+}
+
+-(CGColorRef) CGColorForPackedRGBA:(uint32_t)packedRGBA
+{
+    UIColor* sharedColor = [self sharedColorForPackedRGBA:packedRGBA];
+    if(sharedColor != nil)
+    {
+        return sharedColor.CGColor;
+    }
+    return (CGColorRef)CFAutorelease(CGColorRetain(NewColorForPackedRGBA(packedRGBA).CGColor));
+}
+
+-(UIColor*) colorForSVGColorString:(NSString*)svgColorString
+{
+    char buffer[64];
+    const char* text = CFStringGetCStringPtr((__bridge CFStringRef)svgColorString, kCFStringEncodingUTF8);
+    if(text == NULL)
+    {
+        text = CFStringGetCString((__bridge CFStringRef)svgColorString, buffer, sizeof(buffer), kCFStringEncodingUTF8)
+                    ? buffer : svgColorString.UTF8String;
+    }
+    
+    UIColor* result = nil;
+    SVGColorRGBA components;
+    switch(SVGParseColor(text, (text == NULL) ? 0 : strlen(text), &components))
+    {
+        case kSVGColorParseNone:
+        { // I've been told that sometimes web developers will use 'transparent' then the more proper color is 'none'
+            result = [UIColor clearColor];
+        }
+        break;
+        case kSVGColorParseRGBA:
+        {
+            result = [self colorForPackedRGBA:GHPackColorComponents(components.red, components.green, components.blue, components.alpha)];
+        }
+        break;
+        case kSVGColorParseInvalid:
+        break;
+    }
+    return result;
+}
+@end
@@ -0,0 +1,155 @@
+//
+//  GHDisplayList.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+@import CoreGraphics;
+#else
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#endif
+
+#import "SVGContext.h"
+#import "GHRenderable.h"
+#import "SVGDrawingBackend.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class GHDisplayList;
+
+/*! @brief objects which can record how they draw into a GHDisplayList rather than drawing directly
+*/
+@protocol GHDisplayListCompiling <NSObject>
+/*! @brief append the operations equivalent to renderIntoContext:withSVGContext: to a display list
+* @param displayList the list being recorded
+* @param svgContext state information about the document environment, visited exactly as a render would visit it
+*/
+-(void) compileIntoDisplayList:(GHDisplayList*)displayList withSVGContext:(id<SVGContext>)svgContext;
+@end
+
+/*! @brief objects recorded with renderObject:withSVGContext: which can still draw themselves through a drawing backend, rather than being rendered to an image by Core Graphics when the list is replayed into one
+*/
+@protocol GHDrawingBackendRendering <NSObject>
+/*! @brief draw as renderIntoContext:withSVGContext: would
+* @param backend the drawing backend
+* @param context the backend's own context
+* @param svgContext state information about the document environment
+*/
+-(void) drawWithDrawingBackend:(const SVGDrawingBackend*)backend context:(void*)context withSVGContext:(id<SVGContext>)svgContext;
+@end
+
+/*! @brief a flat, replayable recording of a document's drawing, the result of walking the GHRenderable tree once
+* @note colors, paths and images are resolved when recorded, so a list is only good for the styleGeneration and currentColor it was compiled with. Immutable once compiled, and can be replayed on several threads at once.
+*/
+@interface GHDisplayList : NSObject
+
+/*! @property opCount how many operations have been recorded
+*/
+@property(nonatomic, readonly) NSUInteger opCount;
+
+/*! @brief record an object, letting it compile itself if it knows how or falling back to a deferred renderIntoContext:withSVGContext:
+* @param anObject the renderable to record
+* @param svgContext the context the object would be rendered with
+*/
+-(void) addRenderable:(id<GHRenderable>)anObject withSVGContext:(id<SVGContext>)svgContext;
+
+-(void) saveGState;
+-(void) restoreGState;
+-(void) concatCTM:(CGAffineTransform)transform;
+-(void) setFillColor:(CGColorRef)color;
+-(void) setStrokeColor:(CGColorRef)color;
+-(void) setAlpha:(CGFloat)alpha;
+-(void) setLineWidth:(CGFloat)lineWidth;
+
+/*! @brief a line width given in device space, converted to user space when replayed
+* @param lineWidth the width before conversion and explicitLineScaling
+*/
+-(void) setNonScalingLineWidth:(CGFloat)lineWidth;
+-(void) setMiterLimit:(CGFloat)miterLimit;
+-(void) setLineJoin:(CGLineJoin)lineJoin;
+-(void) setLineCap:(CGLineCap)lineCap;
+
+/*! @brief set or clear the dash pattern
+* @param phase offset into the pattern
+* @param lengths copied, may be NULL if count is 0 to draw solid lines
+* @param count the number of lengths
+*/
+-(void) setLineDashPhase:(CGFloat)phase lengths:(const CGFloat* __nullable)lengths count:(size_t)count;
+-(void) setBlendMode:(CGBlendMode)blendMode;
+
+/*! @brief fill and/or stroke a path
+* @param path retained by the list, typically a GHShape's cached quartzPath
+* @param mode how to draw it
+*/
+-(void) drawPath:(CGPathRef)path mode:(CGPathDrawingMode)mode;
+-(void) drawImage:(CGImageRef)image inRect:(CGRect)rect;
+-(void) fillRect:(CGRect)rect;
+-(void) clipToRect:(CGRect)rect;
+
+/*! @brief clip to a clip path or mask, which are left to add themselves at replay as they may need a rendered mask image
+* @param clipObject something implementing addToClipForContext:withSVGContext:objectBoundingBox:
+* @param objectBox the bounds of the object being clipped
+*/
+-(void) clipToObject:(id<GHRenderable>)clipObject objectBoundingBox:(CGRect)objectBox;
+-(void) beginTransparencyLayer;
+-(void) endTransparencyLayer;
+
+/*! @brief record an object which can't be compiled, it will be rendered at replay time with the svgContext's currentColor and opacity as they are now
+* @param anObject object whose renderIntoContext:withSVGContext: is to be called
+* @param svgContext supplies the currentColor and opacity to restore before rendering
+*/
+-(void) renderObject:(id<GHRenderable>)anObject withSVGContext:(id<SVGContext>)svgContext;
+
+/*! @brief draw the recorded operations
+* @param quartzContext context to draw into
+* @param svgContext needed by objects which could not be compiled and by clip objects, and for non-scaling strokes
+*/
+-(void) replayIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext;
+
+/*! @brief draw the recorded operations, skipping path, rect and image draws which would land wholly outside a rect
+* @param quartzContext context to draw into
+* @param svgContext needed by objects which could not be compiled and by clip objects, and for non-scaling strokes
+* @param cullRect in the coordinates the list was recorded in, typically CGContextGetClipBoundingBox of quartzContext, CGRectInfinite to draw everything
+* @return how many draw operations were skipped
+* @note bounds are worked out as each op is recorded, so objects recorded with renderObject: are never culled. Each saveGState, restoreGState pair also records the bounds of everything drawn between them, so a group or shape lying wholly outside is passed over in one step, its state changes and all
+*/
+-(NSUInteger) replayIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext cullingToRect:(CGRect)cullRect;
+
+/*! @brief draw the recorded operations through a backend other than a CGContext
+* @param backend the drawing backend, such as SVGRasterDrawingBackend()
+* @param context the backend's own context
+* @param svgContext needed by objects which could not be compiled and by clip objects, and for non-scaling strokes
+* @note paths and images are converted for the backend on the first replay and kept. Clip objects, and objects which can neither be compiled nor implement GHDrawingBackendRendering, are rendered by Core Graphics into a device sized bitmap and handed to the backend as a mask or an image. Blend modes are ignored.
+*/
+-(void) replayWithDrawingBackend:(const SVGDrawingBackend*)backend context:(void*)context withSVGContext:(id<SVGContext>)svgContext;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,865 @@
+//
+//  GHDisplayList.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#import "GHDisplayList.h"
+#import "SVGAttributedObject.h"
+
+typedef NS_ENUM(uint8_t, GHDisplayOpType)
+{
+    kGHDisplayOpSave = 0,
+    kGHDisplayOpRestore,
+    kGHDisplayOpConcatCTM,
+    kGHDisplayOpSetFillColor,
+    kGHDisplayOpSetStrokeColor,
+    kGHDisplayOpSetAlpha,
+    kGHDisplayOpSetLineWidth,
+    kGHDisplayOpSetNonScalingLineWidth,
+    kGHDisplayOpSetMiterLimit,
+    kGHDisplayOpSetLineJoin,
+    kGHDisplayOpSetLineCap,
+    kGHDisplayOpSetLineDash,
+    kGHDisplayOpSetBlendMode,
+    kGHDisplayOpDrawPath,
+    kGHDisplayOpDrawImage,
+    kGHDisplayOpFillRect,
+    kGHDisplayOpClipToRect,
+    kGHDisplayOpClipToObject,
+    kGHDisplayOpBeginLayer,
+    kGHDisplayOpEndLayer,
+    kGHDisplayOpRenderObject
+};
+
+/*! @brief one recorded drawing operation, the CF objects are retained by the list, the ObjC ones by its _objects array
+*/
+typedef struct GHDisplayOp
+{
+    GHDisplayOpType type;
+    union
+    {
+        CGAffineTransform   transform;
+        CGColorRef          color;
+        CGFloat             value;
+        int32_t             enumValue;
+        CGRect              rect;
+        struct
+        {
+            CGFloat         phase;
+            CGFloat*        lengths;
+            size_t          count;
+        } dash;
+        struct
+        {
+            CGPathRef           path;
+            CGPathDrawingMode   mode;
+        } path;
+        struct
+        {
+            CGImageRef      image;
+            CGRect          rect;
+        } image;
+        struct
+        {
+            __unsafe_unretained id<GHRenderable>    object;
+            CGRect                                  objectBox;
+        } clip;
+        struct
+        {
+            __unsafe_unretained id<GHRenderable>    object;
+            __unsafe_unretained UIColor*            currentColor;
+            CGFloat                                 opacity;
+        } render;
+        struct
+        {
+            NSUInteger      restoreIndex; // of the matching restore, 0 until it is recorded
+            NSUInteger      drawCount; // draw ops in between
+        } save;
+    };
+} GHDisplayOp;
+
+/*! @brief what a path or image op becomes for a drawing backend, made on the first backend replay
+*/
+typedef struct GHBackendResource
+{
+    SVGPathBuffer   path;
+    SVGDrawingImage image;
+} GHBackendResource;
+
+/*! @brief what the list needs to know while recording to work out where each draw op lands in the list's own coordinates
+*/
+typedef struct GHRecordingState
+{
+    CGAffineTransform   transform;
+    CGFloat             lineWidth;
+    CGFloat             miterLimit;
+    CGLineJoin          lineJoin;
+    BOOL                nonScalingLineWidth;
+} GHRecordingState;
+
+/*! @brief an open saveGState, and what has been drawn since it
+*/
+typedef struct GHSavedRecording
+{
+    GHRecordingState    state;
+    NSUInteger          saveIndex;
+    CGRect              drawnBounds;
+    NSUInteger          drawCount;
+} GHSavedRecording;
+
+static CGRect GHUnionBounds(CGRect bounds, CGRect otherBounds)
+{
+    CGRect result;
+    if(CGRectIsInfinite(bounds) || CGRectIsInfinite(otherBounds))
+    {
+        result = CGRectInfinite;
+    }
+    else
+    {
+        result = CGRectUnion(bounds, otherBounds);
+    }
+    return result;
+}
+
+static GHRecordingState GHDefaultRecordingState(void)
+{
+    GHRecordingState result;
+    result.transform = CGAffineTransformIdentity;
+    result.lineWidth = 1.0;
+    result.miterLimit = 10.0;
+    result.lineJoin = kCGLineJoinMiter;
+    result.nonScalingLineWidth = NO;
+    return result;
+}
+
+static CGColorSpaceRef GHDisplayListRGBColorSpace(void)
+{
+    static CGColorSpaceRef sColorSpace = 0;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sColorSpace = CGColorSpaceCreateDeviceRGB();
+    });
+    return sColorSpace;
+}
+
+/*! @brief a bitmap of premultiplied RGBA, as a drawing backend takes images
+*/
+static CGContextRef GHDisplayListNewBitmapContext(size_t width, size_t height, uint8_t* __nullable * __nonnull pixels)
+{
+    CGContextRef result = 0;
+    *pixels = (width > 0 && height > 0) ? calloc(height, 4*width) : NULL;
+    if(*pixels != NULL)
+    {
+        result = CGBitmapContextCreate(*pixels, width, height, 8, 4*width, GHDisplayListRGBColorSpace(),
+                                       (CGBitmapInfo)kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big);
+        if(result == 0)
+        {
+            free(*pixels);
+            *pixels = NULL;
+        }
+    }
+    return result;
+}
+
+static void GHDisplayListSetColorPaint(const SVGDrawingBackend* backend, void* context, CGColorRef color, BOOL isFill)
+{
+    SVGDrawingPaint paint;
+    memset(&paint, 0, sizeof(paint));
+    paint.type = SVGDrawingGetColorComponents(color, paint.color) ? kSVGDrawingPaintSolid : kSVGDrawingPaintNone;
+    if(isFill)
+    {
+        backend->setFillPaint(context, &paint);
+    }
+    else
+    {
+        backend->setStrokePaint(context, &paint);
+    }
+}
+
+@implementation GHDisplayList
+{
+    GHDisplayOp*        _ops;
+    CGRect*             _opBounds; // one for each op, where it draws in the list's coordinates, CGRectInfinite if not known
+    NSUInteger          _opCount;
+    NSUInteger          _capacity;
+    NSMutableArray*     _objects;
+    BOOL                _rendersObjects; // has kGHDisplayOpRenderObject ops, which change the svgContext's state
+    GHBackendResource*  _backendResources; // one for each op, once replayed through a drawing backend
+    GHRecordingState    _recording;
+    GHSavedRecording*   _savedRecordings;
+    NSUInteger          _savedRecordingCount;
+    NSUInteger          _savedRecordingCapacity;
+}
+
+-(instancetype) init
+{
+    if(nil != (self = [super init]))
+    {
+        _objects = [[NSMutableArray alloc] init];
+        _recording = GHDefaultRecordingState();
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    for(NSUInteger index = 0; index < _opCount; index++)
+    {
+        GHDisplayOp* anOp = _ops+index;
+        switch(anOp->type)
+        {
+            case kGHDisplayOpSetFillColor:
+            case kGHDisplayOpSetStrokeColor:
+                CGColorRelease(anOp->color);
+            break;
+            case kGHDisplayOpSetLineDash:
+                free(anOp->dash.lengths);
+            break;
+            case kGHDisplayOpDrawPath:
+                CGPathRelease(anOp->path.path);
+            break;
+            case kGHDisplayOpDrawImage:
+                CGImageRelease(anOp->image.image);
+            break;
+            default:
+            break;
+        }
+        if(_backendResources != NULL)
+        {
+            SVGPathBufferFree(&_backendResources[index].path);
+            free((void*)_backendResources[index].image.pixels);
+        }
+    }
+    free(_backendResources);
+    free(_savedRecordings);
+    free(_opBounds);
+    free(_ops);
+}
+
+-(GHDisplayOp*) appendOp:(GHDisplayOpType)type
+{
+    if(_opCount == _capacity)
+    {
+        _capacity = (_capacity == 0) ? 64 : _capacity*2;
+        _ops = realloc(_ops, _capacity*sizeof(GHDisplayOp));
+        _opBounds = realloc(_opBounds, _capacity*sizeof(CGRect));
+    }
+    _opBounds[_opCount] = CGRectInfinite;
+    GHDisplayOp* result = _ops+_opCount++;
+    memset(result, 0, sizeof(GHDisplayOp));
+    result->type = type;
+    return result;
+}
+
+-(void) addRenderable:(id<GHRenderable>)anObject withSVGContext:(id<SVGContext>)svgContext
+{
+    if([anObject respondsToSelector:@selector(compileIntoDisplayList:withSVGContext:)])
+    {
+        [(id<GHDisplayListCompiling>)anObject compileIntoDisplayList:self withSVGContext:svgContext];
+    }
+    else
+    {
+        [self renderObject:anObject withSVGContext:svgContext];
+    }
+}
+
+/*! @brief note where the draw op just appended lands, and add it to what the enclosing saveGState has drawn
+* @param bounds the area drawn in the current user space, it is mapped back through the recorded transforms. CGRectInfinite if it isn't known
+*/
+-(void) setBoundsOfLastOp:(CGRect)bounds
+{
+    if(!CGRectIsInfinite(bounds))
+    {
+        bounds = CGRectApplyAffineTransform(bounds, _recording.transform);
+    }
+    _opBounds[_opCount-1] = bounds;
+    if(_savedRecordingCount > 0)
+    {
+        GHSavedRecording* enclosing = _savedRecordings+_savedRecordingCount-1;
+        enclosing->drawnBounds = GHUnionBounds(enclosing->drawnBounds, bounds);
+        enclosing->drawCount++;
+    }
+}
+
+-(void) saveGState
+{
+    if(_savedRecordingCount == _savedRecordingCapacity)
+    {
+        _savedRecordingCapacity = (_savedRecordingCapacity == 0) ? 16 : _savedRecordingCapacity*2;
+        _savedRecordings = realloc(_savedRecordings, _savedRecordingCapacity*sizeof(GHSavedRecording));
+    }
+    [self appendOp:kGHDisplayOpSave];
+    GHSavedRecording* saved = _savedRecordings+_savedRecordingCount++;
+    saved->state = _recording;
+    saved->saveIndex = _opCount-1;
+    saved->drawnBounds = CGRectNull;
+    saved->drawCount = 0;
+}
+
+-(void) restoreGState
+{
+    if(_opCount && _ops[_opCount-1].type == kGHDisplayOpSave)
+    {// nothing was drawn in between
+        _opCount--;
+        if(_savedRecordingCount > 0)
+        {
+            _recording = _savedRecordings[--_savedRecordingCount].state;
+        }
+    }
+    else
+    {
+        [self appendOp:kGHDisplayOpRestore];
+        if(_savedRecordingCount > 0)
+        {// the pair brackets a subtree, which a culling replay can skip in one go
+            GHSavedRecording saved = _savedRecordings[--_savedRecordingCount];
+            _recording = saved.state;
+            _ops[saved.saveIndex].save.restoreIndex = _opCount-1;
+            _ops[saved.saveIndex].save.drawCount = saved.drawCount;
+            _opBounds[saved.saveIndex] = saved.drawnBounds;
+            if(_savedRecordingCount > 0)
+            {
+                GHSavedRecording* enclosing = _savedRecordings+_savedRecordingCount-1;
+                enclosing->drawnBounds = GHUnionBounds(enclosing->drawnBounds, saved.drawnBounds);
+                enclosing->drawCount += saved.drawCount;
+            }
+        }
+    }
+}
+
+-(void) concatCTM:(CGAffineTransform)transform
+{
+    if(!CGAffineTransformIsIdentity(transform))
+    {
+        [self appendOp:kGHDisplayOpConcatCTM]->transform = transform;
+        _recording.transform = CGAffineTransformConcat(transform, _recording.transform);
+    }
+}
+
+-(void) setFillColor:(CGColorRef)color
+{
+    [self appendOp:kGHDisplayOpSetFillColor]->color = CGColorRetain(color);
+}
+
+-(void) setStrokeColor:(CGColorRef)color
+{
+    [self appendOp:kGHDisplayOpSetStrokeColor]->color = CGColorRetain(color);
+}
+
+-(void) setAlpha:(CGFloat)alpha
+{
+    [self appendOp:kGHDisplayOpSetAlpha]->value = alpha;
+}
+
+-(void) setLineWidth:(CGFloat)lineWidth
+{
+    [self appendOp:kGHDisplayOpSetLineWidth]->value = lineWidth;
+    _recording.lineWidth = lineWidth;
+    _recording.nonScalingLineWidth = NO;
+}
+
+-(void) setNonScalingLineWidth:(CGFloat)lineWidth
+{
+    [self appendOp:kGHDisplayOpSetNonScalingLineWidth]->value = lineWidth;
+    _recording.nonScalingLineWidth = YES;
+}
+
+-(void) setMiterLimit:(CGFloat)miterLimit
+{
+    [self appendOp:kGHDisplayOpSetMiterLimit]->value = miterLimit;
+    _recording.miterLimit = miterLimit;
+}
+
+-(void) setLineJoin:(CGLineJoin)lineJoin
+{
+    [self appendOp:kGHDisplayOpSetLineJoin]->enumValue = lineJoin;
+    _recording.lineJoin = lineJoin;
+}
+
+-(void) setLineCap:(CGLineCap)lineCap
+{
+    [self appendOp:kGHDisplayOpSetLineCap]->enumValue = lineCap;
+}
+
+-(void) setLineDashPhase:(CGFloat)phase lengths:(const CGFloat*)lengths count:(size_t)count
+{
+    GHDisplayOp* anOp = [self appendOp:kGHDisplayOpSetLineDash];
+    if(lengths != NULL && count > 0)
+    {
+        anOp->dash.phase = phase;
+        anOp->dash.lengths = malloc(count*sizeof(CGFloat));
+        memcpy(anOp->dash.lengths, lengths, count*sizeof(CGFloat));
+        anOp->dash.count = count;
+    }
+}
+
+-(void) setBlendMode:(CGBlendMode)blendMode
+{
+    [self appendOp:kGHDisplayOpSetBlendMode]->enumValue = blendMode;
+}
+
+-(void) drawPath:(CGPathRef)path mode:(CGPathDrawingMode)mode
+{
+    GHDisplayOp* anOp = [self appendOp:kGHDisplayOpDrawPath];
+    anOp->path.path = CGPathRetain(path);
+    anOp->path.mode = mode;
+    
+    CGRect bounds = CGPathGetPathBoundingBox(path);
+    if(mode == kCGPathStroke || mode == kCGPathFillStroke || mode == kCGPathEOFillStroke)
+    {
+        if(_recording.nonScalingLineWidth)
+        {// the width isn't known until replay
+            bounds = CGRectInfinite;
+        }
+        else if(!CGRectIsNull(bounds))
+        {// far enough out for square caps, and for miters up to the limit
+            CGFloat halfWidth = fabs(_recording.lineWidth)/2.0;
+            CGFloat outset = halfWidth*M_SQRT2;
+            if(_recording.lineJoin == kCGLineJoinMiter)
+            {
+                outset = MAX(outset, halfWidth*_recording.miterLimit);
+            }
+            bounds = CGRectInset(bounds, -outset, -outset);
+        }
+    }
+    [self setBoundsOfLastOp:bounds];
+}
+
+-(void) drawImage:(CGImageRef)image inRect:(CGRect)rect
+{
+    GHDisplayOp* anOp = [self appendOp:kGHDisplayOpDrawImage];
+    anOp->image.image = CGImageRetain(image);
+    anOp->image.rect = rect;
+    [self setBoundsOfLastOp:rect];
+}
+
+-(void) fillRect:(CGRect)rect
+{
+    [self appendOp:kGHDisplayOpFillRect]->rect = rect;
+    [self setBoundsOfLastOp:rect];
+}
+
+-(void) clipToRect:(CGRect)rect
+{
+    [self appendOp:kGHDisplayOpClipToRect]->rect = rect;
+}
+
+-(void) clipToObject:(id<GHRenderable>)clipObject objectBoundingBox:(CGRect)objectBox
+{
+    [_objects addObject:clipObject];
+    GHDisplayOp* anOp = [self appendOp:kGHDisplayOpClipToObject];
+    anOp->clip.object = clipObject;
+    anOp->clip.objectBox = objectBox;
+}
+
+-(void) beginTransparencyLayer
+{
+    [self appendOp:kGHDisplayOpBeginLayer];
+}
+
+-(void) endTransparencyLayer
+{
+    [self appendOp:kGHDisplayOpEndLayer];
+}
+
+-(void) renderObject:(id<GHRenderable>)anObject withSVGContext:(id<SVGContext>)svgContext
+{
+    UIColor* currentColor = svgContext.currentColor;
+    [_objects addObject:anObject];
+    if(currentColor != nil)
+    {
+        [_objects addObject:currentColor];
+    }
+    _rendersObjects = YES;
+    GHDisplayOp* anOp = [self appendOp:kGHDisplayOpRenderObject];
+    anOp->render.object = anObject;
+    anOp->render.currentColor = currentColor;
+    anOp->render.opacity = svgContext.opacity;
+    [self setBoundsOfLastOp:CGRectInfinite];
+}
+
+-(void) replayIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
+{
+    [self replayIntoContext:quartzContext withSVGContext:svgContext cullingToRect:CGRectInfinite];
+}
+
+-(NSUInteger) replayIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext cullingToRect:(CGRect)cullRect
+{
+    NSUInteger result = 0;
+    BOOL culling = !CGRectIsInfinite(cullRect);
+    UIColor* savedColor = nil;
+    CGFloat savedOpacity = 1.0;
+    if(_rendersObjects)
+    {
+        savedColor = svgContext.currentColor;
+        savedOpacity = svgContext.opacity;
+    }
+    for(NSUInteger index = 0; index < _opCount; index++)
+    {
+        const GHDisplayOp* anOp = _ops+index;
+        if(culling && !CGRectIntersectsRect(_opBounds[index], cullRect))
+        {
+            if(anOp->type == kGHDisplayOpSave && anOp->save.restoreIndex != 0)
+            {// nothing between here and the matching restore lands inside, skip the lot
+                result += anOp->save.drawCount;
+                index = anOp->save.restoreIndex;
+                continue;
+            }
+            else if(anOp->type == kGHDisplayOpDrawPath || anOp->type == kGHDisplayOpDrawImage || anOp->type == kGHDisplayOpFillRect)
+            {// state changes still have to be made, but draws which land wholly outside can go
+                result++;
+                continue;
+            }
+        }
+        switch(anOp->type)
+        {
+            case kGHDisplayOpSave:
+                CGContextSaveGState(quartzContext);
+            break;
+            case kGHDisplayOpRestore:
+                CGContextRestoreGState(quartzContext);
+            break;
+            case kGHDisplayOpConcatCTM:
+                CGContextConcatCTM(quartzContext, anOp->transform);
+            break;
+            case kGHDisplayOpSetFillColor:
+                CGContextSetFillColorWithColor(quartzContext, anOp->color);
+            break;
+            case kGHDisplayOpSetStrokeColor:
+                CGContextSetStrokeColorWithColor(quartzContext, anOp->color);
+            break;
+            case kGHDisplayOpSetAlpha:
+                CGContextSetAlpha(quartzContext, anOp->value);
+            break;
+            case kGHDisplayOpSetLineWidth:
+                CGContextSetLineWidth(quartzContext, anOp->value);
+            break;
+            case kGHDisplayOpSetNonScalingLineWidth:
+            {// depends on the CTM at the time of drawing
+                CGSize convertedSize = CGContextConvertSizeToUserSpace(quartzContext, CGSizeMake(anOp->value, anOp->value));
+                CGFloat strokeWidth = (fabs(convertedSize.width)+fabs(convertedSize.height))/2.0;
+                CGContextSetLineWidth(quartzContext, strokeWidth*svgContext.explicitLineScaling);
+            }
+            break;
+            case kGHDisplayOpSetMiterLimit:
+                CGContextSetMiterLimit(quartzContext, anOp->value);
+            break;
+            case kGHDisplayOpSetLineJoin:
+                CGContextSetLineJoin(quartzContext, (CGLineJoin)anOp->enumValue);
+            break;
+            case kGHDisplayOpSetLineCap:
+                CGContextSetLineCap(quartzContext, (CGLineCap)anOp->enumValue);
+            break;
+            case kGHDisplayOpSetLineDash:
+                CGContextSetLineDash(quartzContext, anOp->dash.phase, anOp->dash.lengths, anOp->dash.count);
+            break;
+            case kGHDisplayOpSetBlendMode:
+                CGContextSetBlendMode(quartzContext, (CGBlendMode)anOp->enumValue);
+            break;
+            case kGHDisplayOpDrawPath:
+                CGContextAddPath(quartzContext, anOp->path.path);
+                CGContextDrawPath(quartzContext, anOp->path.mode);
+            break;
+            case kGHDisplayOpDrawImage:
+                CGContextDrawImage(quartzContext, anOp->image.rect, anOp->image.image);
+            break;
+            case kGHDisplayOpFillRect:
+                CGContextFillRect(quartzContext, anOp->rect);
+            break;
+            case kGHDisplayOpClipToRect:
+                CGContextClipToRect(quartzContext, anOp->rect);
+            break;
+            case kGHDisplayOpClipToObject:
+                [anOp->clip.object addToClipForContext:quartzContext withSVGContext:svgContext objectBoundingBox:anOp->clip.objectBox];
+            break;
+            case kGHDisplayOpBeginLayer:
+                CGContextBeginTransparencyLayer(quartzContext, NULL);
+            break;
+            case kGHDisplayOpEndLayer:
+                CGContextEndTransparencyLayer(quartzContext);
+            break;
+            case kGHDisplayOpRenderObject:
+                [svgContext setCurrentColor:anOp->render.currentColor];
+                [svgContext setOpacity:anOp->render.opacity];
+                [anOp->render.object renderIntoContext:quartzContext withSVGContext:svgContext];
+            break;
+        }
+    }
+    if(_rendersObjects)
+    {// leave the svgContext as it was found, as walking the tree would have
+        [svgContext setCurrentColor:savedColor];
+        [svgContext setOpacity:savedOpacity];
+    }
+    return result;
+}
+
+-(const GHBackendResource*) backendResources
+{
+    const GHBackendResource* result = NULL;
+    @synchronized(self)
+    {
+        if(_backendResources == NULL && _opCount > 0)
+        {
+            GHBackendResource* resources = calloc(_opCount, sizeof(GHBackendResource));
+            for(NSUInteger index = 0; resources != NULL && index < _opCount; index++)
+            {
+                const GHDisplayOp* anOp = _ops+index;
+                GHBackendResource* aResource = resources+index;
+                switch(anOp->type)
+                {
+                    case kGHDisplayOpDrawPath:
+                        SVGPathBufferAppendCGPath(&aResource->path, anOp->path.path);
+                    break;
+                    case kGHDisplayOpFillRect:
+                    {
+                        CGRect rect = anOp->rect;
+                        SVGPathBufferMoveTo(&aResource->path, CGRectGetMinX(rect), CGRectGetMinY(rect));
+                        SVGPathBufferLineTo(&aResource->path, CGRectGetMaxX(rect), CGRectGetMinY(rect));
+                        SVGPathBufferLineTo(&aResource->path, CGRectGetMaxX(rect), CGRectGetMaxY(rect));
+                        SVGPathBufferLineTo(&aResource->path, CGRectGetMinX(rect), CGRectGetMaxY(rect));
+                        SVGPathBufferClose(&aResource->path);
+                    }
+                    break;
+                    case kGHDisplayOpDrawImage:
+                    {
+                        size_t width = CGImageGetWidth(anOp->image.image);
+                        size_t height = CGImageGetHeight(anOp->image.image);
+                        uint8_t* pixels = NULL;
+                        CGContextRef bitmapContext = GHDisplayListNewBitmapContext(width, height, &pixels);
+                        if(bitmapContext != 0)
+                        {
+                            CGContextDrawImage(bitmapContext, CGRectMake(0, 0, width, height), anOp->image.image);
+                            CGContextRelease(bitmapContext);
+                            aResource->image.pixels = pixels;
+                            aResource->image.width = width;
+                            aResource->image.height = height;
+                            aResource->image.bytesPerRow = 4*width;
+                        }
+                    }
+                    break;
+                    default:
+                    break;
+                }
+            }
+            _backendResources = resources;
+        }
+        result = _backendResources;
+    }
+    return result;
+}
+
+/*! @brief let Core Graphics render what the backend can't draw itself, into a bitmap covering the backend's clip in device space, and hand that over
+* @param clipObject the clip path or mask to clip to, or nil to draw renderObject
+*/
+-(void) drawOffscreenWithDrawingBackend:(const SVGDrawingBackend*)backend context:(void*)context
+                             clipObject:(nullable id<GHRenderable>)clipObject objectBoundingBox:(CGRect)objectBox
+                           renderObject:(nullable id<GHRenderable>)renderObject withSVGContext:(id<SVGContext>)svgContext
+{
+    double clipBounds[4];
+    double userToDevice[6];
+    double deviceToUser[6];
+    backend->getClipBounds(context, clipBounds);
+    backend->getTransform(context, userToDevice);
+    CGRect deviceBox = CGRectIntegral(CGRectMake(clipBounds[0], clipBounds[1], clipBounds[2], clipBounds[3]));
+    uint8_t* pixels = NULL;
+    CGContextRef bitmapContext = 0;
+    if(!CGRectIsEmpty(deviceBox) && SVGDrawingInvertAffine(userToDevice, deviceToUser))
+    {
+        bitmapContext = GHDisplayListNewBitmapContext((size_t)deviceBox.size.width, (size_t)deviceBox.size.height, &pixels);
+    }
+    if(bitmapContext == 0)
+    {
+        if(clipObject != nil)
+        {// nothing visible is left
+            backend->clipToRect(context, 0.0, 0.0, 0.0, 0.0);
+        }
+        return;
+    }
+    CGContextTranslateCTM(bitmapContext, -deviceBox.origin.x, -deviceBox.origin.y);
+    CGContextConcatCTM(bitmapContext, CGAffineTransformMake(userToDevice[0], userToDevice[1], userToDevice[2],
+                                                            userToDevice[3], userToDevice[4], userToDevice[5]));
+    if(clipObject != nil)
+    {
+        [clipObject addToClipForContext:bitmapContext withSVGContext:svgContext objectBoundingBox:objectBox];
+        CGContextSetGrayFillColor(bitmapContext, 0.0, 1.0);
+        CGContextFillRect(bitmapContext, CGContextGetClipBoundingBox(bitmapContext));
+    }
+    else
+    {
+        CGContextSetRenderingIntent(bitmapContext, kColoringRenderingIntent);
+        CGContextSetInterpolationQuality(bitmapContext, kCGInterpolationHigh);
+        [renderObject renderIntoContext:bitmapContext withSVGContext:svgContext];
+    }
+    CGContextRelease(bitmapContext);
+    
+    SVGDrawingImage image = {pixels, (size_t)deviceBox.size.width, (size_t)deviceBox.size.height, 4*(size_t)deviceBox.size.width};
+    backend->concatTransform(context, deviceToUser);
+    if(clipObject != nil)
+    {
+        backend->clipToMask(context, &image, deviceBox.origin.x, deviceBox.origin.y, deviceBox.size.width, deviceBox.size.height);
+    }
+    else
+    {
+        backend->drawImage(context, &image, deviceBox.origin.x, deviceBox.origin.y, deviceBox.size.width, deviceBox.size.height);
+    }
+    backend->concatTransform(context, userToDevice);
+    free(pixels);
+}
+
+-(void) replayWithDrawingBackend:(const SVGDrawingBackend*)backend context:(void*)context withSVGContext:(id<SVGContext>)svgContext
+{
+    const GHBackendResource* resources = [self backendResources];
+    if(resources == NULL)
+    {
+        return;
+    }
+    UIColor* savedColor = nil;
+    CGFloat savedOpacity = 1.0;
+    if(_rendersObjects)
+    {
+        savedColor = svgContext.currentColor;
+        savedOpacity = svgContext.opacity;
+    }
+    for(NSUInteger index = 0; index < _opCount; index++)
+    {
+        const GHDisplayOp* anOp = _ops+index;
+        switch(anOp->type)
+        {
+            case kGHDisplayOpSave:
+                backend->saveState(context);
+            break;
+            case kGHDisplayOpRestore:
+                backend->restoreState(context);
+            break;
+            case kGHDisplayOpConcatCTM:
+            {
+                CGAffineTransform transform = anOp->transform;
+                double affine[6] = {transform.a, transform.b, transform.c, transform.d, transform.tx, transform.ty};
+                backend->concatTransform(context, affine);
+            }
+            break;
+            case kGHDisplayOpSetFillColor:
+                GHDisplayListSetColorPaint(backend, context, anOp->color, YES);
+            break;
+            case kGHDisplayOpSetStrokeColor:
+                GHDisplayListSetColorPaint(backend, context, anOp->color, NO);
+            break;
+            case kGHDisplayOpSetAlpha:
+                backend->setAlpha(context, anOp->value);
+            break;
+            case kGHDisplayOpSetLineWidth:
+                backend->setLineWidth(context, anOp->value);
+            break;
+            case kGHDisplayOpSetNonScalingLineWidth:
+            {// as CGContextConvertSizeToUserSpace would, from the transform at the time of drawing
+                double userToDevice[6];
+                double deviceToUser[6];
+                backend->getTransform(context, userToDevice);
+                if(SVGDrawingInvertAffine(userToDevice, deviceToUser))
+                {
+                    double width = (deviceToUser[0]+deviceToUser[2])*anOp->value;
+                    double height = (deviceToUser[1]+deviceToUser[3])*anOp->value;
+                    backend->setLineWidth(context, (fabs(width)+fabs(height))/2.0*svgContext.explicitLineScaling);
+                }
+            }
+            break;
+            case kGHDisplayOpSetMiterLimit:
+                backend->setMiterLimit(context, anOp->value);
+            break;
+            case kGHDisplayOpSetLineJoin:
+                backend->setLineJoin(context, (SVGDrawingLineJoin)anOp->enumValue);
+            break;
+            case kGHDisplayOpSetLineCap:
+                backend->setLineCap(context, (SVGDrawingLineCap)anOp->enumValue);
+            break;
+            case kGHDisplayOpSetLineDash:
+            {
+                size_t count = anOp->dash.count;
+                double* lengths = (count > 0) ? malloc(count*sizeof(double)) : NULL;
+                for(size_t dashIndex = 0; lengths != NULL && dashIndex < count; dashIndex++)
+                {
+                    lengths[dashIndex] = anOp->dash.lengths[dashIndex];
+                }
+                backend->setLineDash(context, anOp->dash.phase, lengths, (lengths != NULL) ? count : 0);
+                free(lengths);
+            }
+            break;
+            case kGHDisplayOpSetBlendMode:
+            break;
+            case kGHDisplayOpDrawPath:
+                backend->drawPath(context, &resources[index].path, (SVGDrawingMode)anOp->path.mode);
+            break;
+            case kGHDisplayOpDrawImage:
+                if(resources[index].image.pixels != NULL)
+                {
+                    CGRect rect = anOp->image.rect;
+                    backend->drawImage(context, &resources[index].image, rect.origin.x, rect.origin.y, rect.size.width, rect.size.height);
+                }
+            break;
+            case kGHDisplayOpFillRect:
+                backend->drawPath(context, &resources[index].path, kSVGDrawingFill);
+            break;
+            case kGHDisplayOpClipToRect:
+                backend->clipToRect(context, anOp->rect.origin.x, anOp->rect.origin.y, anOp->rect.size.width, anOp->rect.size.height);
+            break;
+            case kGHDisplayOpClipToObject:
+                [self drawOffscreenWithDrawingBackend:backend context:context
+                                           clipObject:anOp->clip.object objectBoundingBox:anOp->clip.objectBox
+                                         renderObject:nil withSVGContext:svgContext];
+            break;
+            case kGHDisplayOpBeginLayer:
+                backend->beginLayer(context);
+            break;
+            case kGHDisplayOpEndLayer:
+                backend->endLayer(context);
+            break;
+            case kGHDisplayOpRenderObject:
+            {
+                id<GHRenderable> anObject = anOp->render.object;
+                [svgContext setCurrentColor:anOp->render.currentColor];
+                [svgContext setOpacity:anOp->render.opacity];
+                if([anObject respondsToSelector:@selector(drawWithDrawingBackend:context:withSVGContext:)])
+                {
+                    [(id<GHDrawingBackendRendering>)anObject drawWithDrawingBackend:backend context:context withSVGContext:svgContext];
+                }
+                else
+                {
+                    [self drawOffscreenWithDrawingBackend:backend context:context
+                                               clipObject:nil objectBoundingBox:CGRectZero
+                                             renderObject:anObject withSVGContext:svgContext];
+                }
+            }
+            break;
+        }
+    }
+    if(_rendersObjects)
+    {
+        [svgContext setCurrentColor:savedColor];
+        [svgContext setOpacity:savedOpacity];
+    }
+}
+
+@end
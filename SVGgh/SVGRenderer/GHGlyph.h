@@ -39,6 +39,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class GHPathMeasure;
+
 /*! @brief A protocol for an object capable of creating GHGlyphs or adding them to a CGContextRef.
 */
 @protocol GHGlyphMaker <NSObject>
@@ -89,12 +91,17 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic, readonly)      CGRect              boundingBox;
 
 /*! @brief Routine which attempts to take an array of GHGlyphs and place them along a path.
-* @attention algorithm could definitely be improved.
 * @param listOfGlyphs array of GHGlyphs that need to be positioned
 * @param aPath a Core Graphics path along which to position the baselines of the GHGlyphs
 */
 +(void) positionGlyphs:(NSArray*)listOfGlyphs alongCGPath:(CGPathRef)aPath;
 
+/*! @brief Place an array of GHGlyphs along an already measured path, finding every glyph's midpoint in a single sweep of the measure's length table. Glyphs which fall off the end of the path are marked notRendering.
+* @param listOfGlyphs array of GHGlyphs that need to be positioned
+* @param pathMeasure the flattened path along which to position the baselines of the GHGlyphs
+*/
++(void) positionGlyphs:(NSArray*)listOfGlyphs alongPathMeasure:(GHPathMeasure*)pathMeasure;
+
 /*! @brief Given a list of GHGlyphs that have already been positioned. Figure out their bounding box.
 * @param listOfGlyphs pre-positioned GHGlyphs.
 */
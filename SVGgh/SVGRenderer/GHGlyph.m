@@ -45,174 +45,52 @@
 
 +(void) positionGlyphs:(NSArray*)listOfGlyphs alongCGPath:(CGPathRef)pathRef
 {
-    __block NSUInteger      glyphIndex = 0;
-    __block GHGlyph*          currentGlyph = [listOfGlyphs objectAtIndex:glyphIndex++];
-    CGRect runBox = currentGlyph.runRect;
-    __block CGFloat startOffset = -1.0*runBox.origin.x;
-    __block CGFloat nextOffset = runBox.size.width/2.0+startOffset;
-    __block  CGPoint currentPoint = CGPointZero;
-    __block  CGFloat runningLength = 0;
-    
-     __block pathVisitor_t     callback =  ^(const CGPathElement* aPathElement){
-        if(currentGlyph != nil)
-        {
-            __block pathVisitor_t lineToCallback = ^(const CGPathElement* lineSegmentElement){
-                CGPoint nextPoint = lineSegmentElement->points[0];
-                CGFloat deltaX = nextPoint.x-currentPoint.x;
-                CGFloat deltaY = nextPoint.y-currentPoint.y;
-                if(fabs(deltaX)>0.004 || fabs(deltaY) > 0.004)
-                {
-                    CGFloat segmentLength = sqrtf(deltaX*deltaX+deltaY*deltaY);
-                    CGFloat lengthLeft = segmentLength;
-                    CGPoint perpendicularVector = CalculateNormal(currentPoint, nextPoint);
-                    while(lengthLeft > 0 && currentGlyph != nil)
-                    {
-                        if(nextOffset > (runningLength+lengthLeft))
-                        {
-                            runningLength += lengthLeft;
-                            lengthLeft = 0.0;
-                            currentPoint = nextPoint;
-                        }
-                        else
-                        {
-                            CGFloat distanceIntoSegment = nextOffset-runningLength;
-                            CGPoint thePoint = CGPointMake((distanceIntoSegment/segmentLength)*deltaX+currentPoint.x,
-                                                           (distanceIntoSegment/segmentLength)*deltaY+currentPoint.y+currentGlyph.offset.y);
-                            [currentGlyph setMidRenderPoint:thePoint withPerpendicular:perpendicularVector];
-                            lengthLeft -= distanceIntoSegment;
-                            runningLength = nextOffset;
-                            if(glyphIndex < [listOfGlyphs count])
-                            {
-                                currentGlyph = [listOfGlyphs objectAtIndex:glyphIndex++];
-                                CGRect runBox = currentGlyph.runRect;
-                                nextOffset = currentGlyph.offset.x+runBox.size.width/2.0;
-                            }
-                            else
-                            {
-                                currentGlyph = nil;
-                            }
-                            currentPoint = thePoint;
-                        }
-                    }
-                }
-                currentPoint = nextPoint;
-            
-            };
-            
-            switch (aPathElement->type)
-            {
-                case kCGPathElementMoveToPoint:
-                {
-                    currentPoint = aPathElement->points[0];
-                }
-                break;
-                case kCGPathElementAddLineToPoint:
-                {
-                    lineToCallback(aPathElement);
-                }
-                break;
-                case kCGPathElementAddQuadCurveToPoint:
-                {
-                    CGPoint startPoint = currentPoint;
-                    CGPoint controlPoint = aPathElement->points[0];
-                    CGPoint nextPoint = aPathElement->points[1];
-                    CGFloat approximationStep = [GHPathUtilities calculateQuadraticSplineStepFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint:controlPoint];
-                    CGFloat t =  approximationStep;
-                    
-                    while(t <= 1.0)
-                    {
-                        CGFloat x = (1.0f - t)*(1.0f - t)*startPoint.x + 2.0f*(1.0f - t)*t*controlPoint.x + t*t*nextPoint.x;
-                        CGFloat y = (1.0f - t)*(1.0f - t)*startPoint.y + 2.0f*(1.0f - t)*t*controlPoint.y + t*t*nextPoint.y;
-                        CGPoint linePoint = CGPointMake(x, y);
-                        CGPathElement   approximationElement;
-                        approximationElement.type = kCGPathElementAddLineToPoint;
-                        approximationElement.points = &linePoint;
-                        lineToCallback(&approximationElement);
-                        if(t < 1.0)
-                        {
-                            t += approximationStep;
-                            if(t > 1.0)
-                            {
-                                t = 1.0;
-                            }
-                        }
-                        else
-                        {
-                            t += approximationStep;
-                        }
-                    }
-                    currentPoint = nextPoint;
-                    
-                }
-                break;
-                case kCGPathElementAddCurveToPoint:
-                {
-                    CGPoint controlPoint1 = aPathElement->points[0];
-                    CGPoint controlPoint2 = aPathElement->points[1];
-                    CGPoint nextPoint = aPathElement->points[2];
-                    CGPoint startPoint = currentPoint;
-                    
-                    CGFloat A = nextPoint.x-3.0f*controlPoint2.x+3.0f*controlPoint1.x-startPoint.x;
-                    CGFloat B = 3.0f*controlPoint2.x-6.0f*controlPoint1.x+3.0f*startPoint.x;
-                    CGFloat C = 3.0f*controlPoint1.x-3.0f*startPoint.x;
-                    CGFloat D = startPoint.x;
-                    CGFloat E = nextPoint.y-3.0f*controlPoint2.y+3.0f*controlPoint1.y-startPoint.y;
-                    CGFloat F = 3.0f*controlPoint2.y-6.0f*controlPoint1.y+3.0f*startPoint.y;
-                    CGFloat G = 3.0f*controlPoint1.y-3.0f*startPoint.y;
-                    CGFloat H = startPoint.y;
-                    
-                    CGFloat approximationStep = [GHPathUtilities calculateCubicSplineStepFromFromStartPoint:startPoint toEndPoint:nextPoint withControlPoint1:controlPoint1 withControlPoint2:(CGPoint)controlPoint2];
-                    CGFloat t =  approximationStep;
-                    while(t <= 1.0)
-                    {
-                        CGFloat x = (((A*t) + B)*t + C)*t + D;
-                        CGFloat y = (((E*t) + F)*t + G)*t + H;
-                        CGPoint linePoint = CGPointMake(x, y);
-                        CGPathElement   approximationElement;
-                        approximationElement.type = kCGPathElementAddLineToPoint;
-                        approximationElement.points = &linePoint;
-                        lineToCallback(&approximationElement);
-                        if(t < 1.0)
-                        {
-                            t += approximationStep;
-                            if(t > 1.0)
-                            {
-                                t = 1.0;
-                            }
-                        }
-                        else
-                        {
-                            t += approximationStep;
-                        }
-                    }
-                    currentPoint = nextPoint;
-                }
-                break;
-                case kCGPathElementCloseSubpath:
-                break;
-                default:
-                {
-                }
-                break;
-            }
-        }
-    };
-    
-    CGPathApply(pathRef, (__bridge void *)callback, CGPathApplyCallbackFunction);
-    
-    while(currentGlyph != nil)
+    [self positionGlyphs:listOfGlyphs alongPathMeasure:[GHPathMeasure pathMeasureForCGPath:pathRef]];
+}
+
++(void) positionGlyphs:(NSArray*)listOfGlyphs alongPathMeasure:(GHPathMeasure*)pathMeasure
+{
+    NSUInteger glyphCount = listOfGlyphs.count;
+    if(glyphCount == 0)
     {
-        currentGlyph.notRendering = YES;
-        if(glyphIndex < [listOfGlyphs count])
-        {
-            currentGlyph = [listOfGlyphs objectAtIndex:glyphIndex++];
+        return;
+    }
+    CGFloat* midOffsets = malloc(glyphCount*sizeof(CGFloat));
+    CGPoint* midPoints = malloc(glyphCount*sizeof(CGPoint));
+    CGPoint* tangents = malloc(glyphCount*sizeof(CGPoint));
+    BOOL* onPath = calloc(glyphCount, sizeof(BOOL));
+    if(midOffsets != NULL && midPoints != NULL && tangents != NULL && onPath != NULL)
+    {
+        NSUInteger glyphIndex = 0;
+        for(GHGlyph* aGlyph in listOfGlyphs)
+        {// the first glyph is placed by its box within the run, the rest by their offsets
+            CGRect runBox = aGlyph.runRect;
+            CGFloat startOffset = (glyphIndex == 0) ? -1.0*runBox.origin.x : aGlyph.offset.x;
+            midOffsets[glyphIndex++] = startOffset+runBox.size.width/2.0;
         }
-        else
+        
+        [pathMeasure getPoints:midPoints tangents:tangents onPath:onPath atDistances:midOffsets count:glyphCount];
+        
+        glyphIndex = 0;
+        for(GHGlyph* aGlyph in listOfGlyphs)
         {
-            currentGlyph = nil;
+            CGPoint tangent = tangents[glyphIndex];
+            // past the end there's nowhere to put a glyph, but one with a negative offset is pushed back off the start
+            BOOL placed = onPath[glyphIndex] || (midOffsets[glyphIndex] < 0.0 && (tangent.x != 0.0 || tangent.y != 0.0));
+            if(placed)
+            {
+                CGPoint thePoint = midPoints[glyphIndex];
+                thePoint.y += aGlyph.offset.y;
+                [aGlyph setMidRenderPoint:thePoint withPerpendicular:CGPointMake(-1.0*tangent.y, tangent.x)];
+            }
+            aGlyph.notRendering = !placed;
+            glyphIndex++;
         }
     }
-
+    free(midOffsets);
+    free(midPoints);
+    free(tangents);
+    free(onPath);
 }
 
 
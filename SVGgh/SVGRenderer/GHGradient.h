@@ -28,6 +28,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+struct SVGDrawingPaint;
+
 /*! @brief An abstract implementation of a GHFill that will add gradients to a properly setup Core Graphics Context
 */
 @interface GHGradient : GHFill
@@ -37,6 +39,14 @@ NS_ASSUME_NONNULL_BEGIN
 * @param objectBox This is needed to know the extent of the object being filled.
 */
 -(void) fillPathToContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect) objectBox;
+
+/*! @brief describe the gradient fillPathToContext:withSVGContext:objectBoundingBox: would draw, for a drawing backend
+* @param paint receives the gradient, in the user space of the path being filled
+* @param svgContext a context capable of providing additional information
+* @param objectBox This is needed to know the extent of the object being filled.
+* @return storage for the stops the paint points to, to be kept until the paint has been set, or nil if there is nothing to draw
+*/
+-(nullable NSData*) describeDrawingPaint:(struct SVGDrawingPaint*)paint withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox;
 @end
 
 /*! @brief GHGradient concrete class that uses CGContextDrawLinearGradient
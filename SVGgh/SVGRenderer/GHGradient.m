@@ -27,6 +27,7 @@
 
 #import "GHGradient.h"
 #import "SVGGradientUtilities.h"
+#import "SVGDrawingBackend.h"
 
 @interface GHGradientStop : GHAttributedObject
 {
@@ -40,6 +41,7 @@
     NSArray* stops;
 }
 -(CGGradientRef) newGradientRefWithSVGContext:(id<SVGContext>)svgContext;
+-(void) getStopColors:(CFMutableArrayRef)colors locations:(CGFloat*)locations withSVGContext:(id<SVGContext>)svgContext;
 -(BOOL) useUserSpace;
 @end
 
@@ -48,7 +50,7 @@
 
 -(BOOL) useUserSpace
 {
-    BOOL result = [[self.attributes objectForKey:@"gradientUnits"] isEqualToString:@"userSpaceOnUse"];
+    BOOL result = [[self.attributes objectForAtom:kGHAttributeGradientUnits] isEqualToString:@"userSpaceOnUse"];
     return result;
 }
 
@@ -58,8 +60,8 @@
 	{
 		NSArray* contents = [theDefinition objectForKey:kContentsElementName];
 		NSMutableArray* mutableChildren = [[NSMutableArray alloc] initWithCapacity:[contents count]];
-        id      defaultStopColor = [self.attributes objectForKey:@"stop-color"];
-        id      defaultStopOpacity = [self.attributes objectForKey:@"stop-opacity"];
+        id      defaultStopColor = [SVGToQuartz valueForStyleAtom:kGHAttributeStopColor fromDefinition:self.attributes];
+        id      defaultStopOpacity = [SVGToQuartz valueForStyleAtom:kGHAttributeStopOpacity fromDefinition:self.attributes];
         
         for(id aChild in contents)
 		{
@@ -72,22 +74,8 @@
 				{
                     NSDictionary* childAttributes = [aDefinition objectForKey:@"attributes"];
                     NSDictionary* childAttributesToUse = childAttributes;
-                    NSString*  stopColorObject = [childAttributes objectForKey:@"stop-color"];
-                    NSString* stopOpacityObject = [childAttributesToUse objectForKey:@"stop-opacity"];
-                    NSString* styleString = [childAttributes objectForKey:@"style"];
-                    
-                    if(styleString.length)
-                    {
-                        NSDictionary* newStyles =  [SVGToQuartz dictionaryForStyleAttributeString:styleString];
-                        if(stopOpacityObject.length == 0)
-                        {
-                            stopOpacityObject = [newStyles objectForKey:@"stop-opacity"];
-                        }
-                        if(stopColorObject.length == 0)
-                        {
-                            stopColorObject = [newStyles objectForKey:@"stop-color"];
-                        }
-                    }
+                    NSString*  stopColorObject = [SVGToQuartz valueForStyleAtom:kGHAttributeStopColor fromDefinition:childAttributes];
+                    NSString* stopOpacityObject = [SVGToQuartz valueForStyleAtom:kGHAttributeStopOpacity fromDefinition:childAttributes];
                     
                     if(defaultStopColor != nil && [stopColorObject isEqualToString:@"inherit"])
                     {
@@ -120,56 +108,59 @@
 	return self;
 }
 
--(CGGradientRef) newGradientRefWithSVGContext:(id<SVGContext>)svgContext
+-(void) getStopColors:(CFMutableArrayRef)colors locations:(CGFloat*)locations withSVGContext:(id<SVGContext>)svgContext
 {
-    CGGradientRef result = 0;
-    CGFloat* locations = malloc(sizeof(CGFloat)*[stops count]);
-    if (locations != nil)
+    UIColor* savedColor = [svgContext currentColor];
+    NSString* colorString = [self.attributes objectForAtom:kGHAttributeColor];
+    if([colorString isEqualToString:@"inherit"] || [colorString length] == 0)
     {
-        CFMutableArrayRef colors = CFArrayCreateMutable(kCFAllocatorDefault, (CFIndex)[stops count], &kCFTypeArrayCallBacks);
-        
+    }
+    else if([colorString length])
+    {
+        UIColor* colorToDefaultTo = [svgContext colorForSVGColorString:colorString];
+        [svgContext setCurrentColor:colorToDefaultTo];
+    }
+    
+    
+    NSUInteger  index = 0;
+    CGFloat minimumOffset = 0.0;
+    for(GHGradientStop* aStop in stops)
+    {
+        CGColorRef stopColor = [aStop colorWithSVGContext:svgContext].CGColor;
+        if(stopColor == 0) stopColor = [UIColor blackColor].CGColor;
+        CFArrayAppendValue(colors, stopColor);
+        CGFloat nominalOffset = aStop.offset;
         
-        UIColor* savedColor = [svgContext currentColor];
-        NSString* colorString = [self.attributes objectForKey:@"color"];
-        if([colorString isEqualToString:@"inherit"] || [colorString length] == 0)
+        if(nominalOffset > 1.0)
         {
+            nominalOffset = 1.0;
         }
-        else if([colorString length])
+        else if (nominalOffset < 0.0)
         {
-            UIColor* colorToDefaultTo = [svgContext colorForSVGColorString:colorString];
-            [svgContext setCurrentColor:colorToDefaultTo];
+            nominalOffset = 0.0;
         }
-        
-        
-        NSUInteger  index = 0;
-        CGFloat minimumOffset = 0.0;
-        for(GHGradientStop* aStop in stops)
+        if(nominalOffset < minimumOffset)
         {
-            CGColorRef stopColor = [aStop colorWithSVGContext:svgContext].CGColor;
-            if(stopColor == 0) stopColor = [UIColor blackColor].CGColor;
-            CFArrayAppendValue(colors, stopColor);
-            CGFloat nominalOffset = aStop.offset;
-            
-            if(nominalOffset > 1.0)
-            {
-                nominalOffset = 1.0;
-            }
-            else if (nominalOffset < 0.0)
-            {
-                nominalOffset = 0.0;
-            }
-            if(nominalOffset < minimumOffset)
+            nominalOffset = minimumOffset;
+            if(index > 0)
             {
-                nominalOffset = minimumOffset;
-                if(index > 0)
-                {
-                    locations[index-1] -= 0.000000000001;
-                }
+                locations[index-1] -= 0.000000000001;
             }
-            minimumOffset = nominalOffset;
-            locations[index++] = nominalOffset;
         }
-        [svgContext setCurrentColor:savedColor];
+        minimumOffset = nominalOffset;
+        locations[index++] = nominalOffset;
+    }
+    [svgContext setCurrentColor:savedColor];
+}
+
+-(CGGradientRef) newGradientRefWithSVGContext:(id<SVGContext>)svgContext
+{
+    CGGradientRef result = 0;
+    CGFloat* locations = malloc(sizeof(CGFloat)*[stops count]);
+    if (locations != nil)
+    {
+        CFMutableArrayRef colors = CFArrayCreateMutable(kCFAllocatorDefault, (CFIndex)[stops count], &kCFTypeArrayCallBacks);
+        [self getStopColors:colors locations:locations withSVGContext:svgContext];
         
         result = CGGradientCreateWithColors([SVGGradientUtilities colorSpace],
                                                  colors, locations);
@@ -179,6 +170,37 @@
     return result;
 }
 
+-(NSData*) describeDrawingPaint:(struct SVGDrawingPaint*)paint withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+{
+    NSMutableData* result = nil;
+    NSUInteger stopCount = [stops count];
+    CGFloat* locations = (stopCount > 0) ? malloc(sizeof(CGFloat)*stopCount) : NULL;
+    if(locations != NULL)
+    {
+        CFMutableArrayRef colors = CFArrayCreateMutable(kCFAllocatorDefault, (CFIndex)stopCount, &kCFTypeArrayCallBacks);
+        [self getStopColors:colors locations:locations withSVGContext:svgContext];
+        result = [[NSMutableData alloc] initWithLength:stopCount*sizeof(SVGDrawingGradientStop)];
+        SVGDrawingGradientStop* drawingStops = result.mutableBytes;
+        for(NSUInteger index = 0; index < stopCount; index++)
+        {
+            float components[4] = {0.0, 0.0, 0.0, 1.0};
+            SVGDrawingGetColorComponents((CGColorRef)CFArrayGetValueAtIndex(colors, (CFIndex)index), components);
+            drawingStops[index].offset = (float)locations[index];
+            drawingStops[index].red = components[0];
+            drawingStops[index].green = components[1];
+            drawingStops[index].blue = components[2];
+            drawingStops[index].alpha = components[3];
+        }
+        CFRelease(colors);
+        free(locations);
+        
+        memset(paint, 0, sizeof(SVGDrawingPaint));
+        paint->stops = drawingStops;
+        paint->stopCount = stopCount;
+        paint->transform[0] = paint->transform[3] = 1.0;
+    }
+    return result;
+}
 
 -(void) fillPathToContext:(CGContextRef)quartzContext  withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect) objectBox
 {
@@ -187,30 +209,26 @@
 @end
 
 @implementation GHLinearGradient
--(void) fillPathToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+-(void) getStartPoint:(CGPoint*)startPointPtr endPoint:(CGPoint*)endPointPtr options:(CGGradientDrawingOptions*)optionsPtr
+            transform:(CGAffineTransform*)transformPtr objectBoundingBox:(CGRect)objectBox
 {
-    NSString* x1 = [self.attributes objectForKey:@"x1"];
-    NSString* x2 = [self.attributes objectForKey:@"x2"];
-    NSString* y1 = [self.attributes objectForKey:@"y1"];
-    NSString* y2 = [self.attributes objectForKey:@"y2"];
+    NSString* x1 = [self.attributes objectForAtom:kGHAttributeX1];
+    NSString* x2 = [self.attributes objectForAtom:kGHAttributeX2];
+    NSString* y1 = [self.attributes objectForAtom:kGHAttributeY1];
+    NSString* y2 = [self.attributes objectForAtom:kGHAttributeY2];
     CGFloat     x1Float = [SVGGradientUtilities extractFractionFromCoordinateString:x1  givenDefault:0.0];
     CGFloat     x2Float = [SVGGradientUtilities extractFractionFromCoordinateString:x2  givenDefault:1.0];
     CGFloat     y1Float = [SVGGradientUtilities extractFractionFromCoordinateString:y1  givenDefault:0.0];
     CGFloat     y2Float = [SVGGradientUtilities extractFractionFromCoordinateString:y2  givenDefault:0.0];
     
-    CGContextSaveGState(quartzContext);
-    if(!CGContextIsPathEmpty(quartzContext))
-    {
-        CGContextClip(quartzContext);
-    }
-    if(![[self.attributes objectForKey:@"gradientUnits"] isEqualToString:@"userSpaceOnUse"])
+    *transformPtr = CGAffineTransformIdentity;
+    if(![[self.attributes objectForAtom:kGHAttributeGradientUnits] isEqualToString:@"userSpaceOnUse"])
     {
         CGFloat deltaX = x2Float-x1Float;
         CGFloat deltaY  = y2Float-y1Float;
         if(deltaX != 0.0 || deltaY != 0.0)
         {
-            CGContextTranslateCTM(quartzContext, objectBox.origin.x, objectBox.origin.y);
-            CGContextScaleCTM(quartzContext, objectBox.size.width, objectBox.size.height);
+            *transformPtr = CGAffineTransformMake(objectBox.size.width, 0.0, 0.0, objectBox.size.height, objectBox.origin.x, objectBox.origin.y);
         }
         else
         {
@@ -227,7 +245,7 @@
     
     CGGradientDrawingOptions options = 0;
     
-    NSString* gradientTransformString = [self.attributes objectForKey:@"gradientTransform"];
+    NSString* gradientTransformString = [self.attributes objectForAtom:kGHAttributeGradientTransform];
     if(gradientTransformString.length == 0 || [gradientTransformString isEqualToString:@"rotate(0)"])
     {
         if(y2.length == 0)
@@ -243,6 +261,24 @@
         endPoint = CGPointApplyAffineTransform(endPoint, gradientTransform);
         options = kCGGradientDrawsBeforeStartLocation | kCGGradientDrawsAfterEndLocation;
     }
+    *startPointPtr = startPoint;
+    *endPointPtr = endPoint;
+    *optionsPtr = options;
+}
+
+-(void) fillPathToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+{
+    CGPoint startPoint, endPoint;
+    CGGradientDrawingOptions options;
+    CGAffineTransform gradientSpace;
+    [self getStartPoint:&startPoint endPoint:&endPoint options:&options transform:&gradientSpace objectBoundingBox:objectBox];
+    
+    CGContextSaveGState(quartzContext);
+    if(!CGContextIsPathEmpty(quartzContext))
+    {
+        CGContextClip(quartzContext);
+    }
+    CGContextConcatCTM(quartzContext, gradientSpace);
     
     CGGradientRef   gradient = [self newGradientRefWithSVGContext:svgContext];
     if(gradient != 0)
@@ -255,16 +291,37 @@
     CGContextRestoreGState(quartzContext);
 }
 
+-(NSData*) describeDrawingPaint:(struct SVGDrawingPaint*)paint withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+{
+    NSData* result = [super describeDrawingPaint:paint withSVGContext:svgContext objectBoundingBox:objectBox];
+    if(result != nil)
+    {
+        CGPoint startPoint, endPoint;
+        CGGradientDrawingOptions options;
+        CGAffineTransform gradientSpace;
+        [self getStartPoint:&startPoint endPoint:&endPoint options:&options transform:&gradientSpace objectBoundingBox:objectBox];
+        paint->type = kSVGDrawingPaintLinearGradient;
+        paint->start[0] = startPoint.x; paint->start[1] = startPoint.y;
+        paint->end[0] = endPoint.x; paint->end[1] = endPoint.y;
+        paint->extendStart = (options & kCGGradientDrawsBeforeStartLocation) != 0;
+        paint->extendEnd = (options & kCGGradientDrawsAfterEndLocation) != 0;
+        paint->transform[0] = gradientSpace.a; paint->transform[1] = gradientSpace.b; paint->transform[2] = gradientSpace.c;
+        paint->transform[3] = gradientSpace.d; paint->transform[4] = gradientSpace.tx; paint->transform[5] = gradientSpace.ty;
+    }
+    return result;
+}
+
 @end
 
 @implementation GHRadialGradient
--(void) fillPathToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+-(void) getStartPoint:(CGPoint*)startPointPtr endPoint:(CGPoint*)endPointPtr radius:(CGFloat*)radiusPtr
+            transform:(CGAffineTransform*)transformPtr objectBoundingBox:(CGRect)objectBox
 {
-    NSString* cx = [self.attributes objectForKey:@"cx"];
-    NSString* cy = [self.attributes objectForKey:@"cy"];
-    NSString* radius = [self.attributes objectForKey:@"r"];
-    NSString* fx = [self.attributes objectForKey:@"fx"];
-    NSString* fy = [self.attributes objectForKey:@"fy"];
+    NSString* cx = [self.attributes objectForAtom:kGHAttributeCX];
+    NSString* cy = [self.attributes objectForAtom:kGHAttributeCY];
+    NSString* radius = [self.attributes objectForAtom:kGHAttributeR];
+    NSString* fx = [self.attributes objectForAtom:kGHAttributeFX];
+    NSString* fy = [self.attributes objectForAtom:kGHAttributeFY];
     if([fx length] == 0) fx = cx;
     if([fy length] == 0) fy = cy;
     
@@ -273,60 +330,78 @@
     CGFloat     radiusFloat = [SVGGradientUtilities extractFractionFromCoordinateString:radius  givenDefault:0.5];
     CGFloat     fxFloat = [SVGGradientUtilities extractFractionFromCoordinateString:fx   givenDefault:0.5];
     CGFloat     fyFloat = [SVGGradientUtilities extractFractionFromCoordinateString:fy   givenDefault:0.5];
-   
-    CGContextSaveGState(quartzContext);
+    
+    CGAffineTransform transform = CGAffineTransformIdentity;
+    NSString* gradientTransformString = [self.attributes objectForAtom:kGHAttributeGradientTransform];
+    if(gradientTransformString.length)
+    {
+        transform = SVGTransformToCGAffineTransform(gradientTransformString);
+    }
     if(![self useUserSpace])
     {
-        CGContextTranslateCTM(quartzContext, objectBox.origin.x, objectBox.origin.y);
-        CGContextScaleCTM(quartzContext, objectBox.size.width, objectBox.size.height);
+        transform = CGAffineTransformConcat(transform, CGAffineTransformMake(objectBox.size.width, 0.0, 0.0, objectBox.size.height,
+                                                                             objectBox.origin.x, objectBox.origin.y));
     }
-    
+    *startPointPtr = CGPointMake(cxFloat, cyFloat);
+    *endPointPtr = CGPointMake(fxFloat, fyFloat);
+    *radiusPtr = radiusFloat;
+    *transformPtr = transform;
+}
+
+-(void) fillPathToContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+{
+    CGPoint startPoint, endPoint;
+    CGFloat radius;
+    CGAffineTransform gradientSpace;
+    [self getStartPoint:&startPoint endPoint:&endPoint radius:&radius transform:&gradientSpace objectBoundingBox:objectBox];
+   
+    CGContextSaveGState(quartzContext);
     if(!CGContextIsPathEmpty(quartzContext))
     {
         CGContextClip(quartzContext);
     }
-    
-    NSString* gradientTransformString = [self.attributes objectForKey:@"gradientTransform"];
-    if(gradientTransformString.length)
-    {
-        CGAffineTransform gradientTransform = SVGTransformToCGAffineTransform(gradientTransformString);
-        CGContextConcatCTM(quartzContext, gradientTransform);
-    }
+    CGContextConcatCTM(quartzContext, gradientSpace);
     
     CGGradientDrawingOptions options = kCGGradientDrawsBeforeStartLocation | kCGGradientDrawsAfterEndLocation;
     CGGradientRef   gradient = [self newGradientRefWithSVGContext:svgContext];
     if(gradient != 0)
     {
         CGContextDrawRadialGradient(quartzContext,
-                                gradient, CGPointMake(cxFloat, cyFloat), 0.0,
-                                CGPointMake(fxFloat, fyFloat), radiusFloat, options);
+                                gradient, startPoint, 0.0,
+                                endPoint, radius, options);
         CGGradientRelease(gradient);
     }
     CGContextRestoreGState(quartzContext);
 }
+
+-(NSData*) describeDrawingPaint:(struct SVGDrawingPaint*)paint withSVGContext:(id<SVGContext>)svgContext objectBoundingBox:(CGRect)objectBox
+{
+    NSData* result = [super describeDrawingPaint:paint withSVGContext:svgContext objectBoundingBox:objectBox];
+    if(result != nil)
+    {
+        CGPoint startPoint, endPoint;
+        CGFloat radius;
+        CGAffineTransform gradientSpace;
+        [self getStartPoint:&startPoint endPoint:&endPoint radius:&radius transform:&gradientSpace objectBoundingBox:objectBox];
+        paint->type = kSVGDrawingPaintRadialGradient;
+        paint->start[0] = startPoint.x; paint->start[1] = startPoint.y;
+        paint->end[0] = endPoint.x; paint->end[1] = endPoint.y;
+        paint->startRadius = 0.0;
+        paint->endRadius = radius;
+        paint->extendStart = paint->extendEnd = 1;
+        paint->transform[0] = gradientSpace.a; paint->transform[1] = gradientSpace.b; paint->transform[2] = gradientSpace.c;
+        paint->transform[3] = gradientSpace.d; paint->transform[4] = gradientSpace.tx; paint->transform[5] = gradientSpace.ty;
+    }
+    return result;
+}
  
 @end
 
 @implementation GHGradientStop
 -(UIColor*) colorWithSVGContext:(id<SVGContext>)svgContext
 {
-    NSString* opacity = [self.attributes objectForKey:@"stop-opacity"];
-    NSString* stopColor = [self.attributes objectForKey:@"stop-color"];
-    NSString* styleString = [self.attributes objectForKey:@"style"];
-    
-    if(styleString.length)
-    {
-        NSDictionary* newStyles =  [SVGToQuartz dictionaryForStyleAttributeString:styleString];
-        if(opacity.length == 0)
-        {
-            opacity = [newStyles objectForKey:@"stop-opacity"];
-        }
-        if(stopColor.length == 0)
-        {
-            stopColor = [newStyles objectForKey:@"stop-color"];
-        }
-    }
-    
+    NSString* opacity = [SVGToQuartz valueForStyleAtom:kGHAttributeStopOpacity fromDefinition:self.attributes];
+    NSString* stopColor = [SVGToQuartz valueForStyleAtom:kGHAttributeStopColor fromDefinition:self.attributes];
     
     UIColor* result = [svgContext colorForSVGColorString:stopColor];
     if([opacity length] && [opacity floatValue] < 1.0)
@@ -339,7 +414,7 @@
 
 -(CGFloat) offset
 {
-    NSString* offsetString = [self.attributes objectForKey:@"offset"];
+    NSString* offsetString = [self.attributes objectForAtom:kGHAttributeOffset];
     CGFloat result = 0.0;
     if([offsetString hasSuffix:@"%"] && [offsetString length] >=2)
     {
@@ -347,7 +422,7 @@
     }
     else
     {
-        result = [[self.attributes objectForKey:@"offset"] floatValue];
+        result = [[self.attributes objectForAtom:kGHAttributeOffset] floatValue];
     }
     
     return result;
@@ -0,0 +1,90 @@
+//
+//  GHPathCache.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+@import CoreGraphics;
+#else
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief a thread safe cache of parsed, immutable CGPaths keyed by their SVG source text and the transform applied while parsing. Icon sets tend to repeat the same 'd' attribute over and over, via 'use' and across documents, so this lets them be parsed once.
+* @note built on NSCache, so it will also give up its paths under memory pressure
+*/
+@interface GHPathCache : NSObject
+
+/*! @brief the cache shared by GHPath, GHPolyline, GHPolygon and CreatePathFromSVGPathString
+*/
++(GHPathCache*) sharedPathCache;
+
+/*! @brief create a cache bounded by the approximate memory its paths occupy
+* @param byteLimit roughly how many bytes of path data to keep before evicting
+*/
+-(instancetype) initWithByteLimit:(NSUInteger)byteLimit NS_DESIGNATED_INITIALIZER;
+
+/*! @brief return the path for a 'd' attribute, parsing it only if it isn't already cached
+* @param anSVGPath something like 'M33 11 H22 L 100 100 a 20 40 0 1 1 12 14 Z'
+* @param aTransform an affine transform applied to the path at the time of creation, part of the key
+* @return a retained immutable path, which may be shared with other callers
+*/
+-(CGPathRef) newPathFromSVGPath:(nullable NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform CF_RETURNS_RETAINED;
+
+/*! @brief return the path for a polyline or polygon 'points' attribute, parsing it only if it isn't already cached
+* @param svgPoints something like '0,0 10,0 10 10'
+* @param closed YES for a polygon
+* @param aTransform an affine transform applied to the path at the time of creation, part of the key
+* @return a retained immutable path, which may be shared with other callers
+*/
+-(CGPathRef) newPathFromSVGPoints:(nullable NSString*)svgPoints closed:(BOOL)closed whileApplyingTransform:(CGAffineTransform)aTransform CF_RETURNS_RETAINED;
+
+/*! @brief throw away every cached path, the counters are left alone
+*/
+-(void) removeAllPaths;
+
+/*! @brief zero hitCount and missCount
+*/
+-(void) resetStatistics;
+
+/*! @property byteLimit approximately how much path data the cache will hold on to
+*/
+@property(nonatomic, assign) NSUInteger byteLimit;
+
+/*! @property hitCount how many requests were answered from the cache
+*/
+@property(nonatomic, readonly) NSUInteger hitCount;
+
+/*! @property missCount how many requests had to be parsed
+*/
+@property(nonatomic, readonly) NSUInteger missCount;
+@end
+
+NS_ASSUME_NONNULL_END
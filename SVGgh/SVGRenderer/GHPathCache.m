@@ -0,0 +1,223 @@
+//
+//  GHPathCache.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#import "GHPathCache.h"
+#import "SVGPathBuffer.h"
+#include <stdatomic.h>
+
+typedef NS_ENUM(uint8_t, GHPathCacheSourceType)
+{
+    kGHPathCacheSourcePath = 0,
+    kGHPathCacheSourcePolyline,
+    kGHPathCacheSourcePolygon
+};
+
+static const NSUInteger kDefaultPathCacheByteLimit = 4*1024*1024;
+
+/*! @brief key for one parsed path. NSString's own hash only looks at the ends of long strings, which for path data share a lot, so the whole of the source is hashed once up front.
+*/
+@interface GHPathCacheKey : NSObject<NSCopying>
+@property(nonatomic, readonly) NSString* source;
+@property(nonatomic, readonly) CGAffineTransform transform;
+@property(nonatomic, readonly) GHPathCacheSourceType sourceType;
+@end
+
+@implementation GHPathCacheKey
+{
+    NSUInteger  _hash;
+}
+
+-(instancetype) initWithSource:(NSString*)source utf8:(const char*)utf8Source length:(size_t)length
+                     transform:(CGAffineTransform)aTransform sourceType:(GHPathCacheSourceType)sourceType
+{
+    if(nil != (self = [super init]))
+    {
+        _source = [source copy];
+        _transform = aTransform;
+        _sourceType = sourceType;
+        
+        uint64_t hash = 14695981039346656037ULL; // FNV-1a
+        for(size_t index = 0; index < length; index++)
+        {
+            hash = (hash ^ (uint8_t)utf8Source[index]) * 1099511628211ULL;
+        }
+        const uint8_t* transformBytes = (const uint8_t*)&aTransform;
+        for(size_t index = 0; index < sizeof(aTransform); index++)
+        {
+            hash = (hash ^ transformBytes[index]) * 1099511628211ULL;
+        }
+        hash = (hash ^ sourceType) * 1099511628211ULL;
+        _hash = (NSUInteger)hash;
+    }
+    return self;
+}
+
+-(id) copyWithZone:(NSZone *)zone
+{// immutable
+    return self;
+}
+
+-(NSUInteger) hash
+{
+    return _hash;
+}
+
+-(BOOL) isEqual:(id)object
+{
+    BOOL result = NO;
+    if(object == self)
+    {
+        result = YES;
+    }
+    else if([object isKindOfClass:[GHPathCacheKey class]])
+    {
+        GHPathCacheKey* otherKey = object;
+        result = otherKey->_hash == _hash && otherKey.sourceType == self.sourceType
+                && CGAffineTransformEqualToTransform(otherKey.transform, self.transform)
+                && [otherKey.source isEqualToString:self.source];
+    }
+    return result;
+}
+@end
+
+@interface GHPathCache ()
+@property(nonatomic, strong) NSCache* cache;
+@end
+
+@implementation GHPathCache
+{
+    atomic_ulong _hitCount;
+    atomic_ulong _missCount;
+}
+
++(GHPathCache*) sharedPathCache
+{
+    static GHPathCache* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sResult = [[GHPathCache alloc] init];
+    });
+    return sResult;
+}
+
+-(instancetype) init
+{
+    return [self initWithByteLimit:kDefaultPathCacheByteLimit];
+}
+
+-(instancetype) initWithByteLimit:(NSUInteger)byteLimit
+{
+    if(nil != (self = [super init]))
+    {
+        _cache = [[NSCache alloc] init];
+        _cache.name = @"GHPathCache";
+        _cache.totalCostLimit = byteLimit;
+        atomic_init(&_hitCount, 0);
+        atomic_init(&_missCount, 0);
+    }
+    return self;
+}
+
+-(NSUInteger) byteLimit
+{
+    return self.cache.totalCostLimit;
+}
+
+-(void) setByteLimit:(NSUInteger)byteLimit
+{
+    self.cache.totalCostLimit = byteLimit;
+}
+
+-(NSUInteger) hitCount
+{
+    return atomic_load(&_hitCount);
+}
+
+-(NSUInteger) missCount
+{
+    return atomic_load(&_missCount);
+}
+
+-(void) resetStatistics
+{
+    atomic_store(&_hitCount, 0);
+    atomic_store(&_missCount, 0);
+}
+
+-(void) removeAllPaths
+{
+    [self.cache removeAllObjects];
+}
+
+-(CGPathRef) newPathFromSource:(NSString*)source transform:(CGAffineTransform)aTransform sourceType:(GHPathCacheSourceType)sourceType
+{
+    const char* utf8Source = [source UTF8String];
+    if(utf8Source == NULL)
+    {
+        utf8Source = "";
+    }
+    size_t length = strlen(utf8Source);
+    GHPathCacheKey* key = [[GHPathCacheKey alloc] initWithSource:source ?: @"" utf8:utf8Source length:length transform:aTransform sourceType:sourceType];
+    id cachedPath = [self.cache objectForKey:key];
+    if(cachedPath != nil)
+    {
+        atomic_fetch_add(&_hitCount, 1);
+        return CGPathRetain((__bridge CGPathRef)cachedPath);
+    }
+    atomic_fetch_add(&_missCount, 1);
+    
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    if(sourceType == kGHPathCacheSourcePath)
+    {// a malformed path keeps what was drawn before the error
+        SVGPathBufferAppendSVGPath(&pathBuffer, utf8Source, length);
+    }
+    else
+    {
+        SVGPathBufferAppendSVGPoints(&pathBuffer, utf8Source, length, sourceType == kGHPathCacheSourcePolygon);
+    }
+    CGPathRef result = SVGPathBufferCreateCGPath(&pathBuffer, CGAffineTransformIsIdentity(aTransform) ? NULL : &aTransform);
+    // roughly what Core Graphics keeps per element and per point, plus the key
+    NSUInteger cost = pathBuffer.verbCount*sizeof(void*) + pathBuffer.coordinateCount*sizeof(CGFloat) + length;
+    SVGPathBufferFree(&pathBuffer);
+    
+    [self.cache setObject:(__bridge id)result forKey:key cost:cost];
+    return result;
+}
+
+-(CGPathRef) newPathFromSVGPath:(NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform
+{
+    return [self newPathFromSource:anSVGPath transform:aTransform sourceType:kGHPathCacheSourcePath];
+}
+
+-(CGPathRef) newPathFromSVGPoints:(NSString*)svgPoints closed:(BOOL)closed whileApplyingTransform:(CGAffineTransform)aTransform
+{
+    return [self newPathFromSource:svgPoints transform:aTransform sourceType:closed ? kGHPathCacheSourcePolygon : kGHPathCacheSourcePolyline];
+}
+@end
@@ -0,0 +1,243 @@
+//
+//  SVGBoundsTree.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#include "SVGBoundsTree.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum
+{
+    kSVGBoundsTreeLeafSize = 4,
+    kSVGBoundsTreeMaxDepth = 128 // a median split halves every time, far more than enough
+};
+
+typedef struct SVGBoundsTreeNode
+{
+    SVGPathBounds   bounds;
+    size_t          start; // first entry of the tree's order, for a leaf
+    size_t          count; // 0 for an interior node, whose left child follows it
+    size_t          right; // index of the right child of an interior node
+} SVGBoundsTreeNode;
+
+struct SVGBoundsTree
+{
+    SVGBoundsTreeNode*  nodes;
+    size_t              nodeCount;
+    SVGPathBounds*      boxes;
+    size_t*             order; // box indices, grouped by leaf
+    size_t              count;
+};
+
+static void UnionBounds(SVGPathBounds* bounds, const SVGPathBounds* other)
+{
+    if(other->minX < bounds->minX) bounds->minX = other->minX;
+    if(other->minY < bounds->minY) bounds->minY = other->minY;
+    if(other->maxX > bounds->maxX) bounds->maxX = other->maxX;
+    if(other->maxY > bounds->maxY) bounds->maxY = other->maxY;
+}
+
+static int BoundsOverlap(const SVGPathBounds* bounds, const SVGPathBounds* other)
+{
+    return bounds->minX <= other->maxX && other->minX <= bounds->maxX
+        && bounds->minY <= other->maxY && other->minY <= bounds->maxY;
+}
+
+static double BoxCenter(const SVGPathBounds* box, int axis)
+{
+    return (axis == 0) ? (box->minX+box->maxX)*0.5 : (box->minY+box->maxY)*0.5;
+}
+
+/*! @brief partially sort order[start..end) so that the entry at middle has the centre it would have if fully sorted along axis, with no greater ones before it and no lesser ones after
+*/
+static void SelectMedian(const SVGPathBounds* boxes, size_t* order, size_t start, size_t end, size_t middle, int axis)
+{
+    while(end-start > 1)
+    {
+        size_t pivotIndex = start+(end-start)/2;
+        double pivot = BoxCenter(boxes+order[pivotIndex], axis);
+        size_t swap = order[pivotIndex]; order[pivotIndex] = order[end-1]; order[end-1] = swap;
+        size_t store = start;
+        for(size_t index = start; index < end-1; index++)
+        {
+            if(BoxCenter(boxes+order[index], axis) < pivot)
+            {
+                swap = order[index]; order[index] = order[store]; order[store] = swap;
+                store++;
+            }
+        }
+        swap = order[store]; order[store] = order[end-1]; order[end-1] = swap;
+        if(store == middle)
+        {
+            break;
+        }
+        else if(middle < store)
+        {
+            end = store;
+        }
+        else
+        {
+            start = store+1;
+        }
+    }
+}
+
+static size_t BuildNode(SVGBoundsTree* tree, size_t start, size_t end)
+{
+    size_t result = tree->nodeCount++;
+    SVGBoundsTreeNode* aNode = tree->nodes+result;
+    SVGPathBoundsInit(&aNode->bounds);
+    SVGPathBounds centers;
+    SVGPathBoundsInit(&centers);
+    for(size_t index = start; index < end; index++)
+    {
+        const SVGPathBounds* aBox = tree->boxes+tree->order[index];
+        UnionBounds(&aNode->bounds, aBox);
+        SVGPathBoundsAddPoint(&centers, BoxCenter(aBox, 0), BoxCenter(aBox, 1));
+    }
+    
+    if(end-start <= kSVGBoundsTreeLeafSize)
+    {
+        aNode->start = start;
+        aNode->count = end-start;
+        aNode->right = 0;
+    }
+    else
+    {
+        int axis = (centers.maxX-centers.minX >= centers.maxY-centers.minY) ? 0 : 1;
+        size_t middle = start+(end-start)/2;
+        SelectMedian(tree->boxes, tree->order, start, end, middle, axis);
+        aNode->start = start;
+        aNode->count = 0;
+        BuildNode(tree, start, middle); // the left child is always the next node
+        aNode->right = BuildNode(tree, middle, end);
+    }
+    return result;
+}
+
+SVGBoundsTree* SVGBoundsTreeCreate(const SVGPathBounds* boxes, size_t count)
+{
+    SVGBoundsTree* result = (SVGBoundsTree*)calloc(1, sizeof(SVGBoundsTree));
+    if(result == NULL)
+    {
+        return NULL;
+    }
+    if(count > 0)
+    {
+        result->boxes = (SVGPathBounds*)malloc(count*sizeof(SVGPathBounds));
+        result->order = (size_t*)malloc(count*sizeof(size_t));
+        result->nodes = (SVGBoundsTreeNode*)malloc(2*count*sizeof(SVGBoundsTreeNode));
+        if(result->boxes == NULL || result->order == NULL || result->nodes == NULL)
+        {
+            SVGBoundsTreeFree(result);
+            return NULL;
+        }
+        memcpy(result->boxes, boxes, count*sizeof(SVGPathBounds));
+        for(size_t index = 0; index < count; index++)
+        {// written so NaNs count as empty too
+            const SVGPathBounds* aBox = boxes+index;
+            if(aBox->minX <= aBox->maxX && aBox->minY <= aBox->maxY)
+            {
+                result->order[result->count++] = index;
+            }
+        }
+        if(result->count > 0)
+        {
+            BuildNode(result, 0, result->count);
+        }
+    }
+    return result;
+}
+
+void SVGBoundsTreeFree(SVGBoundsTree* tree)
+{
+    if(tree != NULL)
+    {
+        free(tree->nodes);
+        free(tree->boxes);
+        free(tree->order);
+        free(tree);
+    }
+}
+
+size_t SVGBoundsTreeGetCount(const SVGBoundsTree* tree)
+{
+    return tree->count;
+}
+
+void SVGBoundsTreeGetBounds(const SVGBoundsTree* tree, SVGPathBounds* bounds)
+{
+    if(tree->nodeCount > 0)
+    {
+        *bounds = tree->nodes[0].bounds;
+    }
+    else
+    {
+        SVGPathBoundsInit(bounds);
+    }
+}
+
+void SVGBoundsTreeVisitRect(const SVGBoundsTree* tree, const SVGPathBounds* rect, SVGBoundsTreeVisitor visitor, void* info)
+{
+    size_t stack[kSVGBoundsTreeMaxDepth];
+    size_t depth = 0;
+    if(tree->nodeCount > 0)
+    {
+        stack[depth++] = 0;
+    }
+    while(depth > 0)
+    {
+        const SVGBoundsTreeNode* aNode = tree->nodes+stack[--depth];
+        if(!BoundsOverlap(&aNode->bounds, rect))
+        {
+            continue;
+        }
+        if(aNode->count > 0)
+        {
+            for(size_t index = aNode->start; index < aNode->start+aNode->count; index++)
+            {
+                size_t boxIndex = tree->order[index];
+                if(BoundsOverlap(tree->boxes+boxIndex, rect) && visitor(info, boxIndex))
+                {
+                    return;
+                }
+            }
+        }
+        else if(depth+2 <= kSVGBoundsTreeMaxDepth)
+        {
+            stack[depth++] = aNode->right;
+            stack[depth++] = (size_t)(aNode-tree->nodes)+1;
+        }
+    }
+}
+
+void SVGBoundsTreeVisitPoint(const SVGBoundsTree* tree, double x, double y, SVGBoundsTreeVisitor visitor, void* info)
+{
+    SVGPathBounds point = {x, y, x, y};
+    SVGBoundsTreeVisitRect(tree, &point, visitor, info);
+}
@@ -0,0 +1,92 @@
+//
+//  SVGBoundsTree.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGBoundsTree_h
+#define SVGBoundsTree_h
+
+#include <stddef.h>
+#include "SVGPathBuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief a bounding volume hierarchy over a fixed set of boxes, answering which of them might contain a point or touch a rect without looking at all of them
+*/
+typedef struct SVGBoundsTree SVGBoundsTree;
+
+/*! @brief called for each box a query finds, in no particular order
+* @param info whatever was passed to the query
+* @param index the box's index in the array the tree was built from
+* @return non-zero to stop the query
+*/
+typedef int (*SVGBoundsTreeVisitor)(void* info, size_t index);
+
+/*! @brief build a tree, splitting at the median of the longer axis of the boxes' centers
+* @param boxes the boxes to index, copied
+* @param count how many boxes
+* @return a new tree to be freed with SVGBoundsTreeFree, or NULL if memory could not be allocated
+* @note empty boxes are left out, so are never found
+*/
+SVGBoundsTree* SVGBoundsTreeCreate(const SVGPathBounds* boxes, size_t count);
+
+void SVGBoundsTreeFree(SVGBoundsTree* tree);
+
+/*! @brief the number of boxes in the tree, not counting empty ones
+*/
+size_t SVGBoundsTreeGetCount(const SVGBoundsTree* tree);
+
+/*! @brief the box enclosing every box in the tree
+* @param tree the tree
+* @param bounds receives the box, empty if the tree is
+*/
+void SVGBoundsTreeGetBounds(const SVGBoundsTree* tree, SVGPathBounds* bounds);
+
+/*! @brief find the boxes containing a point, edges included
+* @param tree the tree to search
+* @param x horizontal coordinate
+* @param y vertical coordinate
+* @param visitor called with each box found
+* @param info passed to the visitor
+*/
+void SVGBoundsTreeVisitPoint(const SVGBoundsTree* tree, double x, double y, SVGBoundsTreeVisitor visitor, void* info);
+
+/*! @brief find the boxes which overlap a rect, edges included
+* @param tree the tree to search
+* @param rect the area of interest
+* @param visitor called with each box found
+* @param info passed to the visitor
+*/
+void SVGBoundsTreeVisitRect(const SVGBoundsTree* tree, const SVGPathBounds* rect, SVGBoundsTreeVisitor visitor, void* info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGBoundsTree_h */
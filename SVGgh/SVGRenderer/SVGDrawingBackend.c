@@ -0,0 +1,526 @@
+//
+//  SVGDrawingBackend.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#include "SVGDrawingBackend.h"
+#include <stdlib.h>
+#include <string.h>
+
+void SVGDrawingConcatAffine(const double first[6], const double second[6], double result[6])
+{
+    double a = first[0]*second[0] + first[1]*second[2];
+    double b = first[0]*second[1] + first[1]*second[3];
+    double c = first[2]*second[0] + first[3]*second[2];
+    double d = first[2]*second[1] + first[3]*second[3];
+    double tx = first[4]*second[0] + first[5]*second[2] + second[4];
+    double ty = first[4]*second[1] + first[5]*second[3] + second[5];
+    result[0] = a; result[1] = b; result[2] = c; result[3] = d; result[4] = tx; result[5] = ty;
+}
+
+int SVGDrawingInvertAffine(const double affine[6], double result[6])
+{
+    double determinant = affine[0]*affine[3] - affine[1]*affine[2];
+    int invertible = determinant != 0.0 && determinant == determinant;
+    if(invertible)
+    {
+        double a = affine[3]/determinant;
+        double b = -affine[1]/determinant;
+        double c = -affine[2]/determinant;
+        double d = affine[0]/determinant;
+        double tx = -(affine[4]*a + affine[5]*c);
+        double ty = -(affine[4]*b + affine[5]*d);
+        result[0] = a; result[1] = b; result[2] = c; result[3] = d; result[4] = tx; result[5] = ty;
+    }
+    return invertible;
+}
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+
+/*! @brief a paint Core Graphics can't hold in its own graphics state
+*/
+typedef struct SVGQuartzPaint
+{
+    SVGDrawingPaintType type;
+    CGGradientRef       gradient;
+    CGPoint             start;
+    CGPoint             end;
+    CGFloat             startRadius;
+    CGFloat             endRadius;
+    CGGradientDrawingOptions options;
+    CGAffineTransform   transform;
+} SVGQuartzPaint;
+
+typedef struct SVGQuartzPaintState
+{
+    SVGQuartzPaint  fill;
+    SVGQuartzPaint  stroke;
+} SVGQuartzPaintState;
+
+struct SVGQuartzDrawingContext
+{
+    CGContextRef            context;
+    SVGQuartzPaintState*    states; // states[depth] is current, pushed and popped with the CGContext's own
+    size_t                  depth;
+    size_t                  capacity;
+};
+
+static CGColorSpaceRef QuartzSRGBColorSpace(void)
+{
+    static CGColorSpaceRef sColorSpace = NULL;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sColorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    });
+    return sColorSpace;
+}
+
+SVGQuartzDrawingContext* SVGQuartzDrawingContextCreate(CGContextRef quartzContext)
+{
+    SVGQuartzDrawingContext* result = calloc(1, sizeof(SVGQuartzDrawingContext));
+    if(result != NULL)
+    {
+        result->capacity = 8;
+        result->states = calloc(result->capacity, sizeof(SVGQuartzPaintState));
+        if(result->states == NULL)
+        {
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->context = CGContextRetain(quartzContext);
+            result->states[0].fill.type = kSVGDrawingPaintSolid; // whatever color the context already has
+            result->states[0].stroke.type = kSVGDrawingPaintSolid;
+        }
+    }
+    return result;
+}
+
+static void QuartzReleasePaint(SVGQuartzPaint* paint)
+{
+    CGGradientRelease(paint->gradient);
+    paint->gradient = NULL;
+}
+
+void SVGQuartzDrawingContextFree(SVGQuartzDrawingContext* context)
+{
+    if(context != NULL)
+    {
+        for(size_t index = 0; index <= context->depth; index++)
+        {
+            QuartzReleasePaint(&context->states[index].fill);
+            QuartzReleasePaint(&context->states[index].stroke);
+        }
+        free(context->states);
+        CGContextRelease(context->context);
+        free(context);
+    }
+}
+
+int SVGDrawingGetColorComponents(CGColorRef color, float rgba[4])
+{
+    int result = 0;
+    if(color != NULL)
+    {
+        const CGFloat* components = CGColorGetComponents(color);
+        size_t componentCount = CGColorGetNumberOfComponents(color);
+        switch(CGColorSpaceGetModel(CGColorGetColorSpace(color)))
+        {
+            case kCGColorSpaceModelMonochrome:
+                if(componentCount == 2)
+                {
+                    rgba[0] = rgba[1] = rgba[2] = (float)components[0];
+                    rgba[3] = (float)components[1];
+                    result = 1;
+                }
+            break;
+            case kCGColorSpaceModelRGB:
+                if(componentCount == 4)
+                {
+                    for(size_t index = 0; index < 4; index++)
+                    {
+                        rgba[index] = (float)components[index];
+                    }
+                    result = 1;
+                }
+            break;
+            default:
+            break;
+        }
+    }
+    return result;
+}
+
+static void QuartzSaveState(void* context)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    if(quartz->depth+1 == quartz->capacity)
+    {
+        SVGQuartzPaintState* states = realloc(quartz->states, 2*quartz->capacity*sizeof(SVGQuartzPaintState));
+        if(states == NULL)
+        {
+            return;
+        }
+        quartz->states = states;
+        quartz->capacity *= 2;
+    }
+    SVGQuartzPaintState* newState = &quartz->states[quartz->depth+1];
+    *newState = quartz->states[quartz->depth];
+    CGGradientRetain(newState->fill.gradient);
+    CGGradientRetain(newState->stroke.gradient);
+    quartz->depth++;
+    CGContextSaveGState(quartz->context);
+}
+
+static void QuartzRestoreState(void* context)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    if(quartz->depth > 0)
+    {
+        QuartzReleasePaint(&quartz->states[quartz->depth].fill);
+        QuartzReleasePaint(&quartz->states[quartz->depth].stroke);
+        quartz->depth--;
+        CGContextRestoreGState(quartz->context);
+    }
+}
+
+static void QuartzConcatTransform(void* context, const double affine[6])
+{
+    SVGQuartzDrawingContext* quartz = context;
+    CGContextConcatCTM(quartz->context, CGAffineTransformMake(affine[0], affine[1], affine[2], affine[3], affine[4], affine[5]));
+}
+
+static void QuartzGetTransform(void* context, double affine[6])
+{
+    SVGQuartzDrawingContext* quartz = context;
+    CGAffineTransform transform = CGContextGetUserSpaceToDeviceSpaceTransform(quartz->context);
+    affine[0] = transform.a; affine[1] = transform.b; affine[2] = transform.c;
+    affine[3] = transform.d; affine[4] = transform.tx; affine[5] = transform.ty;
+}
+
+static void QuartzGetClipBounds(void* context, double bounds[4])
+{
+    SVGQuartzDrawingContext* quartz = context;
+    CGRect clipBox = CGContextConvertRectToDeviceSpace(quartz->context, CGContextGetClipBoundingBox(quartz->context));
+    bounds[0] = clipBox.origin.x; bounds[1] = clipBox.origin.y;
+    bounds[2] = clipBox.size.width; bounds[3] = clipBox.size.height;
+}
+
+static void QuartzSetAlpha(void* context, double alpha)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    CGContextSetAlpha(quartz->context, alpha);
+}
+
+static void QuartzSetPaint(SVGQuartzDrawingContext* quartz, SVGQuartzPaint* paint, const SVGDrawingPaint* description, int isFill)
+{
+    QuartzReleasePaint(paint);
+    paint->type = description->type;
+    switch(description->type)
+    {
+        case kSVGDrawingPaintSolid:
+        {
+            CGFloat components[4] = {description->color[0], description->color[1], description->color[2], description->color[3]};
+            CGColorRef color = CGColorCreate(QuartzSRGBColorSpace(), components);
+            if(isFill)
+            {
+                CGContextSetFillColorWithColor(quartz->context, color);
+            }
+            else
+            {
+                CGContextSetStrokeColorWithColor(quartz->context, color);
+            }
+            CGColorRelease(color);
+        }
+        break;
+        case kSVGDrawingPaintLinearGradient:
+        case kSVGDrawingPaintRadialGradient:
+        {
+            size_t stopCount = description->stopCount;
+            CGFloat* components = malloc(stopCount*5*sizeof(CGFloat));
+            if(components == NULL || stopCount == 0)
+            {
+                free(components);
+                paint->type = kSVGDrawingPaintNone;
+                break;
+            }
+            CGFloat* locations = components+4*stopCount;
+            for(size_t index = 0; index < stopCount; index++)
+            {
+                const SVGDrawingGradientStop* aStop = &description->stops[index];
+                components[4*index] = aStop->red;
+                components[4*index+1] = aStop->green;
+                components[4*index+2] = aStop->blue;
+                components[4*index+3] = aStop->alpha;
+                locations[index] = aStop->offset;
+            }
+            paint->gradient = CGGradientCreateWithColorComponents(QuartzSRGBColorSpace(), components, locations, stopCount);
+            free(components);
+            paint->start = CGPointMake(description->start[0], description->start[1]);
+            paint->end = CGPointMake(description->end[0], description->end[1]);
+            paint->startRadius = description->startRadius;
+            paint->endRadius = description->endRadius;
+            paint->options = (description->extendStart ? kCGGradientDrawsBeforeStartLocation : 0)
+                                | (description->extendEnd ? kCGGradientDrawsAfterEndLocation : 0);
+            const double* affine = description->transform;
+            paint->transform = CGAffineTransformMake(affine[0], affine[1], affine[2], affine[3], affine[4], affine[5]);
+        }
+        break;
+        default:
+        break;
+    }
+}
+
+static void QuartzSetFillPaint(void* context, const SVGDrawingPaint* paint)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    QuartzSetPaint(quartz, &quartz->states[quartz->depth].fill, paint, 1);
+}
+
+static void QuartzSetStrokePaint(void* context, const SVGDrawingPaint* paint)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    QuartzSetPaint(quartz, &quartz->states[quartz->depth].stroke, paint, 0);
+}
+
+static void QuartzSetLineWidth(void* context, double width)
+{
+    CGContextSetLineWidth(((SVGQuartzDrawingContext*)context)->context, width);
+}
+
+static void QuartzSetLineCap(void* context, SVGDrawingLineCap cap)
+{
+    CGContextSetLineCap(((SVGQuartzDrawingContext*)context)->context, (CGLineCap)cap);
+}
+
+static void QuartzSetLineJoin(void* context, SVGDrawingLineJoin join)
+{
+    CGContextSetLineJoin(((SVGQuartzDrawingContext*)context)->context, (CGLineJoin)join);
+}
+
+static void QuartzSetMiterLimit(void* context, double limit)
+{
+    CGContextSetMiterLimit(((SVGQuartzDrawingContext*)context)->context, limit);
+}
+
+static void QuartzSetLineDash(void* context, double phase, const double* lengths, size_t count)
+{
+    CGFloat* quartzLengths = (count > 0) ? malloc(count*sizeof(CGFloat)) : NULL;
+    for(size_t index = 0; quartzLengths != NULL && index < count; index++)
+    {
+        quartzLengths[index] = lengths[index];
+    }
+    CGContextSetLineDash(((SVGQuartzDrawingContext*)context)->context, phase, quartzLengths, (quartzLengths != NULL) ? count : 0);
+    free(quartzLengths);
+}
+
+static void QuartzDrawGradient(CGContextRef quartzContext, const SVGQuartzPaint* paint)
+{// the path has already been made the clip
+    CGContextConcatCTM(quartzContext, paint->transform);
+    if(paint->type == kSVGDrawingPaintLinearGradient)
+    {
+        CGContextDrawLinearGradient(quartzContext, paint->gradient, paint->start, paint->end, paint->options);
+    }
+    else
+    {
+        CGContextDrawRadialGradient(quartzContext, paint->gradient, paint->start, paint->startRadius, paint->end, paint->endRadius, paint->options);
+    }
+}
+
+static void QuartzDrawPath(void* context, const SVGPathBuffer* path, SVGDrawingMode mode)
+{
+    SVGQuartzDrawingContext* quartz = context;
+    CGContextRef quartzContext = quartz->context;
+    const SVGQuartzPaintState* state = &quartz->states[quartz->depth];
+    CGPathRef quartzPath = SVGPathBufferCreateCGPath(path, NULL);
+    if(quartzPath == NULL)
+    {
+        return;
+    }
+    int evenOdd = mode == kSVGDrawingEOFill || mode == kSVGDrawingEOFillStroke;
+    if(mode != kSVGDrawingStroke && state->fill.type != kSVGDrawingPaintNone)
+    {
+        CGContextAddPath(quartzContext, quartzPath);
+        if(state->fill.type == kSVGDrawingPaintSolid)
+        {
+            CGContextDrawPath(quartzContext, evenOdd ? kCGPathEOFill : kCGPathFill);
+        }
+        else
+        {
+            CGContextSaveGState(quartzContext);
+            if(evenOdd)
+            {
+                CGContextEOClip(quartzContext);
+            }
+            else
+            {
+                CGContextClip(quartzContext);
+            }
+            QuartzDrawGradient(quartzContext, &state->fill);
+            CGContextRestoreGState(quartzContext);
+        }
+    }
+    if(mode >= kSVGDrawingStroke && state->stroke.type != kSVGDrawingPaintNone)
+    {
+        CGContextAddPath(quartzContext, quartzPath);
+        if(state->stroke.type == kSVGDrawingPaintSolid)
+        {
+            CGContextDrawPath(quartzContext, kCGPathStroke);
+        }
+        else
+        {
+            CGContextSaveGState(quartzContext);
+            CGContextReplacePathWithStrokedPath(quartzContext);
+            CGContextClip(quartzContext);
+            QuartzDrawGradient(quartzContext, &state->stroke);
+            CGContextRestoreGState(quartzContext);
+        }
+    }
+    CGPathRelease(quartzPath);
+}
+
+static CGImageRef QuartzCreateImage(const SVGDrawingImage* image, int maskFromAlpha)
+{// copies the pixels, as a PDF context may hold onto the image past the call
+    CGImageRef result = NULL;
+    size_t width = image->width;
+    size_t height = image->height;
+    CFMutableDataRef data = NULL;
+    if(maskFromAlpha)
+    {
+        data = CFDataCreateMutable(kCFAllocatorDefault, (CFIndex)(width*height));
+        if(data != NULL)
+        {
+            CFDataSetLength(data, (CFIndex)(width*height));
+            uint8_t* gray = CFDataGetMutableBytePtr(data);
+            for(size_t row = 0; row < height; row++)
+            {
+                const uint8_t* source = image->pixels+row*image->bytesPerRow;
+                for(size_t column = 0; column < width; column++)
+                {
+                    gray[row*width+column] = source[4*column+3];
+                }
+            }
+        }
+    }
+    else
+    {
+        data = CFDataCreateMutable(kCFAllocatorDefault, (CFIndex)(image->bytesPerRow*height));
+        if(data != NULL)
+        {
+            CFDataAppendBytes(data, image->pixels, (CFIndex)(image->bytesPerRow*height));
+        }
+    }
+    if(data != NULL)
+    {
+        CGDataProviderRef provider = CGDataProviderCreateWithCFData(data);
+        if(maskFromAlpha)
+        {
+            CGColorSpaceRef grayColorSpace = CGColorSpaceCreateDeviceGray();
+            result = CGImageCreate(width, height, 8, 8, width, grayColorSpace, (CGBitmapInfo)kCGImageAlphaNone,
+                                   provider, NULL, false, kCGRenderingIntentDefault);
+            CGColorSpaceRelease(grayColorSpace);
+        }
+        else
+        {
+            result = CGImageCreate(width, height, 8, 32, image->bytesPerRow, QuartzSRGBColorSpace(),
+                                   (CGBitmapInfo)kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big,
+                                   provider, NULL, true, kCGRenderingIntentDefault);
+        }
+        CGDataProviderRelease(provider);
+        CFRelease(data);
+    }
+    return result;
+}
+
+static void QuartzDrawImage(void* context, const SVGDrawingImage* image, double x, double y, double width, double height)
+{
+    CGImageRef quartzImage = QuartzCreateImage(image, 0);
+    if(quartzImage != NULL)
+    {
+        CGContextDrawImage(((SVGQuartzDrawingContext*)context)->context, CGRectMake(x, y, width, height), quartzImage);
+        CGImageRelease(quartzImage);
+    }
+}
+
+static void QuartzClipToPath(void* context, const SVGPathBuffer* path, SVGDrawingFillRule rule)
+{
+    CGContextRef quartzContext = ((SVGQuartzDrawingContext*)context)->context;
+    CGPathRef quartzPath = SVGPathBufferCreateCGPath(path, NULL);
+    if(quartzPath != NULL)
+    {
+        CGContextAddPath(quartzContext, quartzPath);
+        CGPathRelease(quartzPath);
+        if(rule == kSVGDrawingEvenOdd)
+        {
+            CGContextEOClip(quartzContext);
+        }
+        else
+        {
+            CGContextClip(quartzContext);
+        }
+    }
+}
+
+static void QuartzClipToRect(void* context, double x, double y, double width, double height)
+{
+    CGContextClipToRect(((SVGQuartzDrawingContext*)context)->context, CGRectMake(x, y, width, height));
+}
+
+static void QuartzClipToMask(void* context, const SVGDrawingImage* mask, double x, double y, double width, double height)
+{
+    CGImageRef maskImage = QuartzCreateImage(mask, 1);
+    if(maskImage != NULL)
+    {
+        CGContextClipToMask(((SVGQuartzDrawingContext*)context)->context, CGRectMake(x, y, width, height), maskImage);
+        CGImageRelease(maskImage);
+    }
+}
+
+static void QuartzBeginLayer(void* context)
+{
+    CGContextBeginTransparencyLayer(((SVGQuartzDrawingContext*)context)->context, NULL);
+}
+
+static void QuartzEndLayer(void* context)
+{
+    CGContextEndTransparencyLayer(((SVGQuartzDrawingContext*)context)->context);
+}
+
+const SVGDrawingBackend* SVGQuartzDrawingBackend(void)
+{
+    static const SVGDrawingBackend sBackend = {
+        QuartzSaveState, QuartzRestoreState, QuartzConcatTransform, QuartzGetTransform, QuartzGetClipBounds,
+        QuartzSetAlpha, QuartzSetFillPaint, QuartzSetStrokePaint,
+        QuartzSetLineWidth, QuartzSetLineCap, QuartzSetLineJoin, QuartzSetMiterLimit, QuartzSetLineDash,
+        QuartzDrawPath, QuartzDrawImage, QuartzClipToPath, QuartzClipToRect, QuartzClipToMask,
+        QuartzBeginLayer, QuartzEndLayer
+    };
+    return &sBackend;
+}
+#endif
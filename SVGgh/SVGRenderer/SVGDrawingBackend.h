@@ -0,0 +1,181 @@
+//
+//  SVGDrawingBackend.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGDrawingBackend_h
+#define SVGDrawingBackend_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SVGPathBuffer.h"
+
+#if defined(__APPLE__)
+#include <CoreGraphics/CoreGraphics.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief how a path is painted, the same values as CGPathDrawingMode
+*/
+typedef enum SVGDrawingMode
+{
+    kSVGDrawingFill = 0,
+    kSVGDrawingEOFill,
+    kSVGDrawingStroke,
+    kSVGDrawingFillStroke,
+    kSVGDrawingEOFillStroke
+} SVGDrawingMode;
+
+/*! @brief which regions of a path are inside it
+*/
+typedef enum SVGDrawingFillRule
+{
+    kSVGDrawingNonZero = 0,
+    kSVGDrawingEvenOdd
+} SVGDrawingFillRule;
+
+/*! @brief line caps and joins, the same values as CGLineCap and CGLineJoin
+*/
+typedef enum SVGDrawingLineCap
+{
+    kSVGDrawingCapButt = 0,
+    kSVGDrawingCapRound,
+    kSVGDrawingCapSquare
+} SVGDrawingLineCap;
+
+typedef enum SVGDrawingLineJoin
+{
+    kSVGDrawingJoinMiter = 0,
+    kSVGDrawingJoinRound,
+    kSVGDrawingJoinBevel
+} SVGDrawingLineJoin;
+
+typedef enum SVGDrawingPaintType
+{
+    kSVGDrawingPaintNone = 0,
+    kSVGDrawingPaintSolid,
+    kSVGDrawingPaintLinearGradient,
+    kSVGDrawingPaintRadialGradient
+} SVGDrawingPaintType;
+
+/*! @brief one color stop, components are sRGB from 0 to 1 and not premultiplied
+*/
+typedef struct SVGDrawingGradientStop
+{
+    float offset;
+    float red, green, blue, alpha;
+} SVGDrawingGradientStop;
+
+/*! @brief what fills or strokes a path. Gradients are described the way Core Graphics draws them: between two points, or between two circles, in a space mapped to user space by transform.
+*/
+typedef struct SVGDrawingPaint
+{
+    SVGDrawingPaintType             type;
+    float                           color[4];       // a solid paint's red, green, blue, alpha, not premultiplied
+    const SVGDrawingGradientStop*   stops;          // sorted by offset, only needs to live through the set paint call
+    size_t                          stopCount;
+    double                          start[2];       // first point, or the center of the first circle
+    double                          end[2];
+    double                          startRadius;
+    double                          endRadius;
+    int                             extendStart;    // paint before the first stop with its color
+    int                             extendEnd;
+    double                          transform[6];   // {a, b, c, d, tx, ty} from gradient space to the user space in effect when the path is drawn
+} SVGDrawingPaint;
+
+/*! @brief premultiplied RGBA, 8 bits a component, the first row is drawn at the top of its rectangle
+*/
+typedef struct SVGDrawingImage
+{
+    const uint8_t*  pixels;
+    size_t          width;
+    size_t          height;
+    size_t          bytesPerRow;
+} SVGDrawingImage;
+
+/*! @brief a drawing target, a table of functions all taking the backend's own context. State (transform, paints, line style, alpha, clip) is saved and restored as a stack, as with a CGContext. Transforms map user space to a device space whose origin is at the bottom left.
+*/
+typedef struct SVGDrawingBackend
+{
+    void (*saveState)(void* context);
+    void (*restoreState)(void* context);
+    void (*concatTransform)(void* context, const double affine[6]);
+    void (*getTransform)(void* context, double affine[6]);              // user space to device space
+    void (*getClipBounds)(void* context, double bounds[4]);             // x, y, width, height in device space
+    void (*setAlpha)(void* context, double alpha);
+    void (*setFillPaint)(void* context, const SVGDrawingPaint* paint);
+    void (*setStrokePaint)(void* context, const SVGDrawingPaint* paint);
+    void (*setLineWidth)(void* context, double width);
+    void (*setLineCap)(void* context, SVGDrawingLineCap cap);
+    void (*setLineJoin)(void* context, SVGDrawingLineJoin join);
+    void (*setMiterLimit)(void* context, double limit);
+    void (*setLineDash)(void* context, double phase, const double* lengths, size_t count); // count 0 for solid lines
+    void (*drawPath)(void* context, const SVGPathBuffer* path, SVGDrawingMode mode);
+    void (*drawImage)(void* context, const SVGDrawingImage* image, double x, double y, double width, double height);
+    void (*clipToPath)(void* context, const SVGPathBuffer* path, SVGDrawingFillRule rule);
+    void (*clipToRect)(void* context, double x, double y, double width, double height);
+    void (*clipToMask)(void* context, const SVGDrawingImage* mask, double x, double y, double width, double height); // by the mask's alpha
+    void (*beginLayer)(void* context);  // composited with the alpha and clip in effect now, once endLayer is called
+    void (*endLayer)(void* context);
+} SVGDrawingBackend;
+
+/*! @brief make the transform of an affine {a, b, c, d, tx, ty} which applies first, then second
+*/
+void SVGDrawingConcatAffine(const double first[6], const double second[6], double result[6]);
+
+/*! @brief invert an affine transform
+* @return 0 if it wasn't invertible, result is then left alone
+*/
+int SVGDrawingInvertAffine(const double affine[6], double result[6]);
+
+#if defined(__APPLE__)
+/*! @brief the Core Graphics implementation, its context is an SVGQuartzDrawingContext
+*/
+const SVGDrawingBackend* SVGQuartzDrawingBackend(void);
+
+typedef struct SVGQuartzDrawingContext SVGQuartzDrawingContext;
+
+/*! @brief wrap a CGContext so it can be drawn into through SVGQuartzDrawingBackend
+* @param quartzContext retained until the wrapper is freed
+*/
+SVGQuartzDrawingContext* SVGQuartzDrawingContextCreate(CGContextRef quartzContext);
+void SVGQuartzDrawingContextFree(SVGQuartzDrawingContext* context);
+
+/*! @brief the red, green, blue and alpha of a gray or RGB color, as a paint or gradient stop wants them
+* @return 0 for colors of any other kind, such as patterns, rgba is then left alone
+*/
+int SVGDrawingGetColorComponents(CGColorRef color, float rgba[4]);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGDrawingBackend_h */
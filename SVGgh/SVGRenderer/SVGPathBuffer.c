@@ -0,0 +1,944 @@
+//
+//  SVGPathBuffer.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#include "SVGPathBuffer.h"
+#include "SVGNumberScanner.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#endif
+
+#ifndef M_PI // not ISO C, strict -std=c11 leaves them out of math.h
+#define M_PI 3.14159265358979323846
+#endif
+#ifndef M_PI_2
+#define M_PI_2 1.57079632679489661923
+#endif
+
+size_t SVGPathVerbPointCount(SVGPathVerb verb)
+{
+    static const size_t kPointCounts[] = {1, 1, 2, 3, 0};
+    return (verb <= kSVGPathVerbClose) ? kPointCounts[verb] : 0;
+}
+
+void SVGPathBufferInit(SVGPathBuffer* buffer)
+{
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void SVGPathBufferFree(SVGPathBuffer* buffer)
+{
+    free(buffer->verbs);
+    free(buffer->coordinates);
+    SVGPathBufferInit(buffer);
+}
+
+void SVGPathBufferReset(SVGPathBuffer* buffer)
+{
+    buffer->verbCount = 0;
+    buffer->coordinateCount = 0;
+    buffer->currentX = buffer->currentY = 0.0;
+    buffer->subpathStartX = buffer->subpathStartY = 0.0;
+    buffer->subpathOpen = 0;
+}
+
+int SVGPathBufferCopy(SVGPathBuffer* destination, const SVGPathBuffer* source)
+{
+    *destination = *source;
+    destination->verbs = NULL;
+    destination->coordinates = NULL;
+    destination->verbCapacity = source->verbCount;
+    destination->coordinateCapacity = source->coordinateCount;
+    if(source->verbCount)
+    {
+        destination->verbs = (uint8_t*)malloc(source->verbCount);
+        if(destination->verbs != NULL)
+        {
+            memcpy(destination->verbs, source->verbs, source->verbCount);
+        }
+    }
+    if(source->coordinateCount)
+    {
+        destination->coordinates = (float*)malloc(source->coordinateCount*sizeof(float));
+        if(destination->coordinates != NULL)
+        {
+            memcpy(destination->coordinates, source->coordinates, source->coordinateCount*sizeof(float));
+        }
+    }
+    if((source->verbCount && destination->verbs == NULL) || (source->coordinateCount && destination->coordinates == NULL))
+    {
+        SVGPathBufferFree(destination);
+        return 0;
+    }
+    return 1;
+}
+
+static int ReserveSpace(SVGPathBuffer* buffer, size_t verbsNeeded, size_t coordinatesNeeded)
+{
+    if(buffer->verbCount + verbsNeeded > buffer->verbCapacity)
+    {
+        size_t newCapacity = buffer->verbCapacity ? buffer->verbCapacity*2 : 16;
+        while(newCapacity < buffer->verbCount + verbsNeeded)
+        {
+            newCapacity *= 2;
+        }
+        uint8_t* newVerbs = (uint8_t*)realloc(buffer->verbs, newCapacity);
+        if(newVerbs == NULL)
+        {
+            return 0;
+        }
+        buffer->verbs = newVerbs;
+        buffer->verbCapacity = newCapacity;
+    }
+    if(buffer->coordinateCount + coordinatesNeeded > buffer->coordinateCapacity)
+    {
+        size_t newCapacity = buffer->coordinateCapacity ? buffer->coordinateCapacity*2 : 64;
+        while(newCapacity < buffer->coordinateCount + coordinatesNeeded)
+        {
+            newCapacity *= 2;
+        }
+        float* newCoordinates = (float*)realloc(buffer->coordinates, newCapacity*sizeof(float));
+        if(newCoordinates == NULL)
+        {
+            return 0;
+        }
+        buffer->coordinates = newCoordinates;
+        buffer->coordinateCapacity = newCapacity;
+    }
+    return 1;
+}
+
+static void AppendVerb(SVGPathBuffer* buffer, SVGPathVerb verb, const double* points, size_t pointCount)
+{
+    if(ReserveSpace(buffer, 1, pointCount*2))
+    {
+        buffer->verbs[buffer->verbCount++] = (uint8_t)verb;
+        float* destination = buffer->coordinates + buffer->coordinateCount;
+        for(size_t index = 0; index < pointCount*2; index++)
+        {
+            destination[index] = (float)points[index];
+        }
+        buffer->coordinateCount += pointCount*2;
+        if(pointCount)
+        {// the current point is what was actually stored
+            buffer->currentX = destination[pointCount*2-2];
+            buffer->currentY = destination[pointCount*2-1];
+        }
+    }
+}
+
+static void EnsureSubpath(SVGPathBuffer* buffer)
+{// drawing without a moveto, as after a closepath, starts where the last subpath started
+    if(!buffer->subpathOpen)
+    {
+        SVGPathBufferMoveTo(buffer, buffer->currentX, buffer->currentY);
+    }
+}
+
+void SVGPathBufferMoveTo(SVGPathBuffer* buffer, double x, double y)
+{
+    if(buffer->verbCount && buffer->verbs[buffer->verbCount-1] == kSVGPathVerbMove)
+    {// consecutive movetos collapse into the last, as with CGPath
+        buffer->coordinateCount -= 2;
+        buffer->verbCount--;
+    }
+    double point[2] = {x, y};
+    AppendVerb(buffer, kSVGPathVerbMove, point, 1);
+    buffer->subpathStartX = buffer->currentX;
+    buffer->subpathStartY = buffer->currentY;
+    buffer->subpathOpen = 1;
+}
+
+void SVGPathBufferLineTo(SVGPathBuffer* buffer, double x, double y)
+{
+    EnsureSubpath(buffer);
+    double points[2] = {x, y};
+    AppendVerb(buffer, kSVGPathVerbLine, points, 1);
+}
+
+void SVGPathBufferQuadTo(SVGPathBuffer* buffer, double controlX, double controlY, double x, double y)
+{
+    EnsureSubpath(buffer);
+    double points[4] = {controlX, controlY, x, y};
+    AppendVerb(buffer, kSVGPathVerbQuad, points, 2);
+}
+
+void SVGPathBufferCubicTo(SVGPathBuffer* buffer, double control1X, double control1Y, double control2X, double control2Y, double x, double y)
+{
+    EnsureSubpath(buffer);
+    double points[6] = {control1X, control1Y, control2X, control2Y, x, y};
+    AppendVerb(buffer, kSVGPathVerbCubic, points, 3);
+}
+
+void SVGPathBufferClose(SVGPathBuffer* buffer)
+{
+    if(buffer->subpathOpen)
+    {
+        AppendVerb(buffer, kSVGPathVerbClose, NULL, 0);
+        buffer->subpathOpen = 0;
+        buffer->currentX = buffer->subpathStartX;
+        buffer->currentY = buffer->subpathStartY;
+    }
+}
+
+static double VectorMagnitude(double x, double y)
+{
+    return sqrtf(x*x+y*y);
+}
+
+static double VectorRatio(double x1, double y1, double x2, double y2)
+{
+    double result = x1*x2+y1*y2;
+    result /= (VectorMagnitude(x1, y1)*VectorMagnitude(x2, y2));
+    return result;
+}
+
+static double VectorAngle(double x1, double y1, double x2, double y2)
+{
+    double result = acosf(VectorRatio(x1, y1, x2, y2));
+    if((x1*y2) < (y1*x2))
+    {
+        result *= -1.0;
+    }
+    return result;
+}
+
+void SVGPathBufferArcTo(SVGPathBuffer* buffer, double xRadius, double yRadius, double xAxisRotationDegrees,
+                        int largeArcFlag, int sweepFlag, double endPointX, double endPointY)
+{//implementation notes http://www.w3.org/TR/SVG/implnote.html#ArcConversionEndpointToCenter
+    // the arithmetic follows AddSVGArcToPath so the results match what Core Graphics was given
+    double curX = buffer->currentX;
+    double curY = buffer->currentY;
+    if(curX == endPointX && curY == endPointY)
+    { // do nothing
+        return;
+    }
+    if(xRadius == 0.0 || yRadius == 0.0) // not an actual arc, draw a line segment
+    {
+        SVGPathBufferLineTo(buffer, endPointX, endPointY);
+        return;
+    }
+    
+    xRadius = fabs(xRadius);
+    yRadius = fabs(yRadius);
+    xAxisRotationDegrees = fmod(xAxisRotationDegrees, 360.0);
+    double xAxisRotationRadians = xAxisRotationDegrees*(M_PI/180.0);
+    double cosineAxisRotation = cosf((float)xAxisRotationRadians);
+    double sineAxisRotation = sinf((float)xAxisRotationRadians);
+    double deltaX = curX-endPointX;
+    double deltaY = curY-endPointY;
+    
+    // F.6.5  Step 1: Compute (x1′, y1′)
+    double translatedCurX = cosineAxisRotation*deltaX/2.0f+sineAxisRotation*deltaY/2.0f;
+    double translatedCurY = -1.0f*sineAxisRotation*deltaX/2.0f+cosineAxisRotation*deltaY/2.0f;
+    
+    // F.6.6 Step 3: Ensure radii are large enough
+    double shouldBeNoMoreThanOne = translatedCurX*translatedCurX/(xRadius*xRadius) + translatedCurY*translatedCurY/(yRadius*yRadius);
+    if(shouldBeNoMoreThanOne > 1.0)
+    {
+        xRadius *= sqrtf(shouldBeNoMoreThanOne);
+        yRadius *= sqrtf(shouldBeNoMoreThanOne);
+        
+        shouldBeNoMoreThanOne = translatedCurX*translatedCurX/(xRadius*xRadius) + translatedCurY*translatedCurY/(yRadius*yRadius);
+        if(shouldBeNoMoreThanOne > 1.0) // sometimes just a bit north of 1.0000000 after first pass
+        {
+            shouldBeNoMoreThanOne += .000001;
+            xRadius *= sqrtf(shouldBeNoMoreThanOne);
+            yRadius *= sqrtf(shouldBeNoMoreThanOne);
+        }
+    }
+    
+    // F.6.5   Step 2: Compute (cx′, cy′)
+    double centerScalingDivisor = xRadius*xRadius*translatedCurY*translatedCurY + yRadius*yRadius*translatedCurX*translatedCurX;
+    double centerScaling = 0.0;
+    if(centerScalingDivisor != 0.0)
+    {
+        centerScaling = sqrt((xRadius*xRadius*yRadius*yRadius
+                              - xRadius*xRadius*translatedCurY*translatedCurY
+                              - yRadius*yRadius*translatedCurX*translatedCurX)
+                             / centerScalingDivisor);
+        if(centerScaling != centerScaling)
+        {
+            centerScaling = 0.0;
+        }
+        if((largeArcFlag != 0) == (sweepFlag != 0))
+        {
+            centerScaling *= -1.0;
+        }
+    }
+    double translatedCenterX = centerScaling*xRadius*translatedCurY/yRadius;
+    double translatedCenterY = -1.0f*centerScaling*yRadius*translatedCurX/xRadius;
+    
+    // F.6.5  Step 3: Compute (cx, cy) from (cx′, cy′)
+    double centerX = (curX+endPointX)/2.0f+cosineAxisRotation*translatedCenterX-sineAxisRotation*translatedCenterY;
+    double centerY = (curY+endPointY)/2.0f+sineAxisRotation*translatedCenterX+cosineAxisRotation*translatedCenterY;
+    
+    // F.6.5   Step 4: Compute θ1 and Δθ
+    double vectorUX = (translatedCurX-translatedCenterX)/xRadius;
+    double vectorUY = (translatedCurY-translatedCenterY)/yRadius;
+    double vectorVX = (-1.0f*translatedCurX-translatedCenterX)/xRadius;
+    double vectorVY = (-1.0f*translatedCurY-translatedCenterY)/yRadius;
+    
+    double startAngle = VectorAngle(1.0, 0.0, vectorUX, vectorUY);
+    double angleDelta = VectorAngle(vectorUX, vectorUY, vectorVX, vectorVY);
+    double vectorRatio = VectorRatio(vectorUX, vectorUY, vectorVX, vectorVY);
+    if(vectorRatio <= -1)
+    {
+        angleDelta = M_PI;
+    }
+    else if(vectorRatio >= 1.0)
+    {
+        angleDelta = 0.0;
+    }
+    if(sweepFlag == 0 && angleDelta > 0.0)
+    {
+        angleDelta = angleDelta - 2.0 * M_PI;
+    }
+    if(sweepFlag != 0 && angleDelta < 0.0)
+    {
+        angleDelta = angleDelta + 2.0 * M_PI;
+    }
+    
+    // map the unit circle onto the ellipse: translate to the center, rotate, then scale
+    double radius = (xRadius > yRadius) ? xRadius : yRadius;
+    double scaleX = radius*((xRadius > yRadius) ? 1.0 : xRadius / yRadius);
+    double scaleY = radius*((xRadius > yRadius) ? yRadius / xRadius : 1.0);
+    double cosRotation = cos(xAxisRotationRadians);
+    double sinRotation = sin(xAxisRotationRadians);
+    double a = cosRotation*scaleX, b = sinRotation*scaleX;
+    double c = -sinRotation*scaleY, d = cosRotation*scaleY;
+#define MAP_X(ux, uy) (a*(ux) + c*(uy) + centerX)
+#define MAP_Y(ux, uy) (b*(ux) + d*(uy) + centerY)
+    
+    // like CGPathAddArc, join the current point to the start of the arc, then go around in steps of at most a quarter turn
+    double startCos = cos(startAngle), startSin = sin(startAngle);
+    SVGPathBufferLineTo(buffer, MAP_X(startCos, startSin), MAP_Y(startCos, startSin));
+    
+    double remaining = angleDelta;
+    double angle = startAngle;
+    double direction = (angleDelta < 0.0) ? -1.0 : 1.0;
+    while(fabs(remaining) > 0.0)
+    {
+        double step = (fabs(remaining) > M_PI_2+1e-5) ? direction*M_PI_2 : remaining; // no slivers from acosf rounding
+        double nextAngle = (step == remaining) ? startAngle+angleDelta : angle+step;
+        double handle = 4.0/3.0*tan((nextAngle-angle)/4.0);
+        double cos0 = cos(angle), sin0 = sin(angle);
+        double cos1 = cos(nextAngle), sin1 = sin(nextAngle);
+        double control1X = cos0-handle*sin0, control1Y = sin0+handle*cos0;
+        double control2X = cos1+handle*sin1, control2Y = sin1-handle*cos1;
+        SVGPathBufferCubicTo(buffer, MAP_X(control1X, control1Y), MAP_Y(control1X, control1Y),
+                             MAP_X(control2X, control2Y), MAP_Y(control2X, control2Y),
+                             MAP_X(cos1, sin1), MAP_Y(cos1, sin1));
+        remaining -= step;
+        angle = nextAngle;
+    }
+#undef MAP_X
+#undef MAP_Y
+}
+
+static int IsPathWhitespace(char aCharacter)
+{
+    return aCharacter == ' ' || aCharacter == '\t' || aCharacter == '\n' || aCharacter == '\r' || aCharacter == '\f';
+}
+
+static int ScanFlag(const char** cursorPtr, const char* end, int* flag)
+{// arc flags are single characters and may be run together, as in 'a1 1 0 00 1 1'
+    const char* cursor = SVGSkipNumberSeparators(*cursorPtr, end);
+    if(cursor < end && (*cursor == '0' || *cursor == '1'))
+    {
+        *flag = (*cursor == '1');
+        *cursorPtr = cursor+1;
+        return 1;
+    }
+    return 0;
+}
+
+static int ScanNumbers(const char** cursorPtr, const char* end, double* values, size_t count)
+{
+    return SVGScanNumbers(cursorPtr, end, values, count) == count;
+}
+
+int SVGPathBufferAppendSVGPath(SVGPathBuffer* buffer, const char* pathString, size_t length)
+{
+    const char* cursor = pathString;
+    const char* end = pathString + length;
+    char command = 0;
+    int hasCubicControl = 0, hasQuadraticControl = 0;
+    double lastControlX = 0.0, lastControlY = 0.0;
+    
+    for(;;)
+    {
+        while(cursor < end && IsPathWhitespace(*cursor))
+        {
+            cursor++;
+        }
+        if(cursor >= end)
+        {
+            return 1;
+        }
+        char aCharacter = *cursor;
+        if((aCharacter >= 'a' && aCharacter <= 'z') || (aCharacter >= 'A' && aCharacter <= 'Z'))
+        {
+            command = aCharacter;
+            cursor++;
+        }
+        else if(command == 0 || command == 'z' || command == 'Z')
+        {// numbers without a command to apply them to
+            return 0;
+        }
+        
+        int isRelative = (command >= 'a' && command <= 'z');
+        double originX = isRelative ? buffer->currentX : 0.0;
+        double originY = isRelative ? buffer->currentY : 0.0;
+        double values[7];
+        int wasCubic = 0, wasQuadratic = 0;
+        switch(command)
+        {
+            case 'M':
+            case 'm':
+            {
+                if(!ScanNumbers(&cursor, end, values, 2))
+                {
+                    return 0;
+                }
+                SVGPathBufferMoveTo(buffer, values[0]+originX, values[1]+originY);
+                command = isRelative ? 'l' : 'L'; // subsequent implied operations are line tos
+            }
+            break;
+            case 'Z':
+            case 'z':
+            {
+                SVGPathBufferClose(buffer);
+            }
+            break;
+            case 'L':
+            case 'l':
+            {
+                if(!ScanNumbers(&cursor, end, values, 2))
+                {
+                    return 0;
+                }
+                SVGPathBufferLineTo(buffer, values[0]+originX, values[1]+originY);
+            }
+            break;
+            case 'H':
+            case 'h':
+            {
+                if(!ScanNumbers(&cursor, end, values, 1))
+                {
+                    return 0;
+                }
+                SVGPathBufferLineTo(buffer, values[0]+originX, buffer->currentY);
+            }
+            break;
+            case 'V':
+            case 'v':
+            {
+                if(!ScanNumbers(&cursor, end, values, 1))
+                {
+                    return 0;
+                }
+                SVGPathBufferLineTo(buffer, buffer->currentX, values[0]+originY);
+            }
+            break;
+            case 'C':
+            case 'c':
+            {
+                if(!ScanNumbers(&cursor, end, values, 6))
+                {
+                    return 0;
+                }
+                lastControlX = values[2]+originX;
+                lastControlY = values[3]+originY;
+                SVGPathBufferCubicTo(buffer, values[0]+originX, values[1]+originY, lastControlX, lastControlY,
+                                     values[4]+originX, values[5]+originY);
+                wasCubic = 1;
+            }
+            break;
+            case 'S':
+            case 's':
+            {
+                if(!ScanNumbers(&cursor, end, values, 4))
+                {
+                    return 0;
+                }
+                double control1X = buffer->currentX;
+                double control1Y = buffer->currentY;
+                if(hasCubicControl)
+                {// reflection of the last control point
+                    control1X -= (lastControlX-control1X);
+                    control1Y -= (lastControlY-control1Y);
+                }
+                lastControlX = values[0]+originX;
+                lastControlY = values[1]+originY;
+                SVGPathBufferCubicTo(buffer, control1X, control1Y, lastControlX, lastControlY,
+                                     values[2]+originX, values[3]+originY);
+                wasCubic = 1;
+            }
+            break;
+            case 'Q':
+            case 'q':
+            {
+                if(!ScanNumbers(&cursor, end, values, 4))
+                {
+                    return 0;
+                }
+                lastControlX = values[0]+originX;
+                lastControlY = values[1]+originY;
+                SVGPathBufferQuadTo(buffer, lastControlX, lastControlY, values[2]+originX, values[3]+originY);
+                wasQuadratic = 1;
+            }
+            break;
+            case 'T':
+            case 't':
+            {
+                if(!ScanNumbers(&cursor, end, values, 2))
+                {
+                    return 0;
+                }
+                double controlX = buffer->currentX;
+                double controlY = buffer->currentY;
+                if(hasQuadraticControl)
+                {
+                    controlX -= (lastControlX-controlX);
+                    controlY -= (lastControlY-controlY);
+                }
+                lastControlX = controlX;
+                lastControlY = controlY;
+                SVGPathBufferQuadTo(buffer, controlX, controlY, values[0]+originX, values[1]+originY);
+                wasQuadratic = 1;
+            }
+            break;
+            case 'A':
+            case 'a':
+            {
+                int largeArcFlag = 0, sweepFlag = 0;
+                if(!ScanNumbers(&cursor, end, values, 3) || !ScanFlag(&cursor, end, &largeArcFlag)
+                   || !ScanFlag(&cursor, end, &sweepFlag) || !ScanNumbers(&cursor, end, values+3, 2))
+                {
+                    return 0;
+                }
+                SVGPathBufferArcTo(buffer, values[0], values[1], values[2], largeArcFlag, sweepFlag,
+                                   values[3]+originX, values[4]+originY);
+            }
+            break;
+            default:
+            {// don't know where I am, bail
+                return 0;
+            }
+        }
+        hasCubicControl = wasCubic;
+        hasQuadraticControl = wasQuadratic;
+        cursor = SVGSkipNumberSeparators(cursor, end);
+    }
+}
+
+int SVGPathBufferAppendSVGPoints(SVGPathBuffer* buffer, const char* pointsString, size_t length, int closePath)
+{
+    const char* cursor = pointsString;
+    const char* end = pointsString + length;
+    double values[64]; // even, so a chunk never splits a pair
+    size_t pairCount = 0;
+    size_t scanned;
+    do
+    {
+        scanned = SVGScanNumbers(&cursor, end, values, sizeof(values)/sizeof(values[0]));
+        for(size_t index = 0; index+1 < scanned; index += 2)
+        {
+            if(pairCount++ == 0)
+            {
+                SVGPathBufferMoveTo(buffer, values[index], values[index+1]);
+            }
+            else
+            {
+                SVGPathBufferLineTo(buffer, values[index], values[index+1]);
+            }
+        }
+    } while(scanned == sizeof(values)/sizeof(values[0]));
+    
+    if(closePath && pairCount > 0)
+    {
+        SVGPathBufferClose(buffer);
+    }
+    
+    while(cursor < end && IsPathWhitespace(*cursor))
+    {
+        cursor++;
+    }
+    return (scanned & 1) == 0 && cursor == end;
+}
+
+void SVGPathBoundsInit(SVGPathBounds* bounds)
+{
+    bounds->minX = bounds->minY = HUGE_VAL;
+    bounds->maxX = bounds->maxY = -HUGE_VAL;
+}
+
+int SVGPathBoundsIsEmpty(const SVGPathBounds* bounds)
+{
+    return bounds->minX > bounds->maxX;
+}
+
+void SVGPathBoundsAddPoint(SVGPathBounds* bounds, double x, double y)
+{
+    if(x < bounds->minX) bounds->minX = x;
+    if(x > bounds->maxX) bounds->maxX = x;
+    if(y < bounds->minY) bounds->minY = y;
+    if(y > bounds->maxY) bounds->maxY = y;
+}
+
+void SVGPathBoundsAddQuad(SVGPathBounds* bounds, double startX, double startY, double controlX, double controlY, double endX, double endY)
+{
+    SVGPathBoundsAddPoint(bounds, startX, startY);
+    SVGPathBoundsAddPoint(bounds, endX, endY);
+    if(controlX >= bounds->minX && controlX <= bounds->maxX && controlY >= bounds->minY && controlY <= bounds->maxY)
+    {// the curve stays inside the hull of its points, nothing to solve
+        return;
+    }
+    const double starts[2] = {startX, startY};
+    const double controls[2] = {controlX, controlY};
+    const double ends[2] = {endX, endY};
+    for(int axis = 0; axis < 2; axis++)
+    {// B'(t) = 0 where t = (p0-p1)/(p0-2p1+p2)
+        double denominator = starts[axis]-2.0*controls[axis]+ends[axis];
+        if(denominator != 0.0)
+        {
+            double t = (starts[axis]-controls[axis])/denominator;
+            if(t > 0.0 && t < 1.0)
+            {
+                double mt = 1.0-t;
+                SVGPathBoundsAddPoint(bounds, mt*mt*startX+2.0*mt*t*controlX+t*t*endX,
+                                              mt*mt*startY+2.0*mt*t*controlY+t*t*endY);
+            }
+        }
+    }
+}
+
+static int CubicExtremaForAxis(double p0, double p1, double p2, double p3, double* ts)
+{// roots of the derivative divided by 3: a*t^2 + b*t + c
+    double a = -p0+3.0*p1-3.0*p2+p3;
+    double b = 2.0*(p0-2.0*p1+p2);
+    double c = p1-p0;
+    int count = 0;
+    if(a == 0.0)
+    {
+        if(b != 0.0)
+        {
+            ts[count++] = -c/b;
+        }
+    }
+    else
+    {
+        double discriminant = b*b-4.0*a*c;
+        if(discriminant >= 0.0)
+        {// the numerically stable form, a can be tiny when the curve is nearly a quadratic
+            double q = -0.5*(b+copysign(sqrt(discriminant), b));
+            ts[count++] = q/a;
+            if(q != 0.0)
+            {
+                ts[count++] = c/q;
+            }
+        }
+    }
+    return count;
+}
+
+void SVGPathBoundsAddCubic(SVGPathBounds* bounds, double startX, double startY, double control1X, double control1Y,
+                           double control2X, double control2Y, double endX, double endY)
+{
+    SVGPathBoundsAddPoint(bounds, startX, startY);
+    SVGPathBoundsAddPoint(bounds, endX, endY);
+    if(control1X >= bounds->minX && control1X <= bounds->maxX && control1Y >= bounds->minY && control1Y <= bounds->maxY
+       && control2X >= bounds->minX && control2X <= bounds->maxX && control2Y >= bounds->minY && control2Y <= bounds->maxY)
+    {
+        return;
+    }
+    double ts[4];
+    int count = CubicExtremaForAxis(startX, control1X, control2X, endX, ts);
+    count += CubicExtremaForAxis(startY, control1Y, control2Y, endY, ts+count);
+    for(int index = 0; index < count; index++)
+    {
+        double t = ts[index];
+        if(t > 0.0 && t < 1.0)
+        {
+            double mt = 1.0-t;
+            double w0 = mt*mt*mt, w1 = 3.0*mt*mt*t, w2 = 3.0*mt*t*t, w3 = t*t*t;
+            SVGPathBoundsAddPoint(bounds, w0*startX+w1*control1X+w2*control2X+w3*endX,
+                                          w0*startY+w1*control1Y+w2*control2Y+w3*endY);
+        }
+    }
+}
+
+int SVGPathBufferGetBounds(const SVGPathBuffer* buffer, const double* affineOrNULL, SVGPathBounds* bounds)
+{
+    SVGPathBoundsInit(bounds);
+    const float* coordinates = buffer->coordinates;
+    double points[6]; // up to 3 transformed points
+    double lastX = 0.0, lastY = 0.0;
+    for(size_t index = 0; index < buffer->verbCount; index++)
+    {
+        SVGPathVerb verb = (SVGPathVerb)buffer->verbs[index];
+        size_t pointCount = SVGPathVerbPointCount(verb);
+        for(size_t pointIndex = 0; pointIndex < pointCount; pointIndex++)
+        {
+            double x = coordinates[2*pointIndex];
+            double y = coordinates[2*pointIndex+1];
+            if(affineOrNULL != NULL)
+            {
+                points[2*pointIndex] = affineOrNULL[0]*x+affineOrNULL[2]*y+affineOrNULL[4];
+                points[2*pointIndex+1] = affineOrNULL[1]*x+affineOrNULL[3]*y+affineOrNULL[5];
+            }
+            else
+            {
+                points[2*pointIndex] = x;
+                points[2*pointIndex+1] = y;
+            }
+        }
+        coordinates += 2*pointCount;
+        switch(verb)
+        {
+            case kSVGPathVerbMove:
+            case kSVGPathVerbLine:
+                SVGPathBoundsAddPoint(bounds, points[0], points[1]);
+            break;
+            case kSVGPathVerbQuad:
+                SVGPathBoundsAddQuad(bounds, lastX, lastY, points[0], points[1], points[2], points[3]);
+            break;
+            case kSVGPathVerbCubic:
+                SVGPathBoundsAddCubic(bounds, lastX, lastY, points[0], points[1], points[2], points[3], points[4], points[5]);
+            break;
+            case kSVGPathVerbClose:
+            break;
+        }
+        if(pointCount > 0)
+        {
+            lastX = points[2*pointCount-2];
+            lastY = points[2*pointCount-1];
+        }
+    }
+    return !SVGPathBoundsIsEmpty(bounds);
+}
+
+#if defined(__APPLE__)
+CGPathRef SVGPathBufferCreateCGPath(const SVGPathBuffer* buffer, const CGAffineTransform* transformOrNULL)
+{
+    CGMutablePathRef mutableResult = CGPathCreateMutable();
+    const float* points = buffer->coordinates;
+    for(size_t index = 0; index < buffer->verbCount; index++)
+    {
+        switch((SVGPathVerb)buffer->verbs[index])
+        {
+            case kSVGPathVerbMove:
+                CGPathMoveToPoint(mutableResult, transformOrNULL, points[0], points[1]);
+                points += 2;
+            break;
+            case kSVGPathVerbLine:
+                CGPathAddLineToPoint(mutableResult, transformOrNULL, points[0], points[1]);
+                points += 2;
+            break;
+            case kSVGPathVerbQuad:
+                CGPathAddQuadCurveToPoint(mutableResult, transformOrNULL, points[0], points[1], points[2], points[3]);
+                points += 4;
+            break;
+            case kSVGPathVerbCubic:
+                CGPathAddCurveToPoint(mutableResult, transformOrNULL, points[0], points[1], points[2], points[3], points[4], points[5]);
+                points += 6;
+            break;
+            case kSVGPathVerbClose:
+                CGPathCloseSubpath(mutableResult);
+            break;
+        }
+    }
+    CGPathRef result = CGPathCreateCopy(mutableResult);
+    CGPathRelease(mutableResult);
+    return result;
+}
+
+#define kPathsPerConcurrentBatch 32 // small paths are quick, so hand them out in groups to keep the queue overhead down
+
+typedef struct ConcurrentPathsState
+{
+    const char* const*          pathStrings;
+    const size_t*               lengths;
+    size_t                      count;
+    const CGAffineTransform*    transformsOrNULL;
+    CGPathRef*                  results;
+} ConcurrentPathsState;
+
+static void CreateCGPathBatch(void* context, size_t batchIndex)
+{
+    const ConcurrentPathsState* state = (const ConcurrentPathsState*)context;
+    size_t start = batchIndex*kPathsPerConcurrentBatch;
+    size_t end = start+kPathsPerConcurrentBatch;
+    if(end > state->count)
+    {
+        end = state->count;
+    }
+    SVGPathBuffer pathBuffer; // one buffer per batch, reset between paths so its storage is reused
+    SVGPathBufferInit(&pathBuffer);
+    for(size_t index = start; index < end; index++)
+    {
+        SVGPathBufferReset(&pathBuffer);
+        if(state->pathStrings[index] != NULL)
+        {
+            SVGPathBufferAppendSVGPath(&pathBuffer, state->pathStrings[index], state->lengths[index]);
+        }
+        const CGAffineTransform* transform = NULL;
+        if(state->transformsOrNULL != NULL && !CGAffineTransformIsIdentity(state->transformsOrNULL[index]))
+        {
+            transform = &state->transformsOrNULL[index];
+        }
+        state->results[index] = SVGPathBufferCreateCGPath(&pathBuffer, transform);
+    }
+    SVGPathBufferFree(&pathBuffer);
+}
+
+void SVGPathBufferCreateCGPathsConcurrently(const char* const* pathStrings, const size_t* lengths, size_t count,
+                                            const CGAffineTransform* transformsOrNULL, CGPathRef* results)
+{
+    ConcurrentPathsState state = {pathStrings, lengths, count, transformsOrNULL, results};
+    size_t batchCount = (count+kPathsPerConcurrentBatch-1)/kPathsPerConcurrentBatch;
+    if(batchCount == 1)
+    {
+        CreateCGPathBatch(&state, 0);
+    }
+    else if(batchCount > 1)
+    {
+        dispatch_apply_f(batchCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), &state, CreateCGPathBatch);
+    }
+}
+
+typedef struct CGPathBoundsState
+{
+    SVGPathBounds           bounds;
+    const CGAffineTransform* transformOrNULL;
+    CGPoint                 lastPoint;
+    CGPoint                 subpathStart;
+} CGPathBoundsState;
+
+static void AccumulateCGPathElementBounds(void* info, const CGPathElement* element)
+{
+    CGPathBoundsState* state = (CGPathBoundsState*)info;
+    CGPoint points[3];
+    size_t pointCount = 0;
+    switch(element->type)
+    {
+        case kCGPathElementMoveToPoint:
+        case kCGPathElementAddLineToPoint:
+            pointCount = 1;
+        break;
+        case kCGPathElementAddQuadCurveToPoint:
+            pointCount = 2;
+        break;
+        case kCGPathElementAddCurveToPoint:
+            pointCount = 3;
+        break;
+        case kCGPathElementCloseSubpath:
+            state->lastPoint = state->subpathStart;
+            return;
+    }
+    for(size_t index = 0; index < pointCount; index++)
+    {
+        points[index] = (state->transformOrNULL != NULL) ? CGPointApplyAffineTransform(element->points[index], *state->transformOrNULL)
+                                                         : element->points[index];
+    }
+    CGPoint last = state->lastPoint;
+    switch(element->type)
+    {
+        case kCGPathElementMoveToPoint:
+            state->subpathStart = points[0];
+            // fall through
+        case kCGPathElementAddLineToPoint:
+            SVGPathBoundsAddPoint(&state->bounds, points[0].x, points[0].y);
+        break;
+        case kCGPathElementAddQuadCurveToPoint:
+            SVGPathBoundsAddQuad(&state->bounds, last.x, last.y, points[0].x, points[0].y, points[1].x, points[1].y);
+        break;
+        case kCGPathElementAddCurveToPoint:
+            SVGPathBoundsAddCubic(&state->bounds, last.x, last.y, points[0].x, points[0].y, points[1].x, points[1].y, points[2].x, points[2].y);
+        break;
+        default:
+        break;
+    }
+    state->lastPoint = points[pointCount-1];
+}
+
+CGRect SVGPathBoundsOfCGPath(CGPathRef aPath, const CGAffineTransform* transformOrNULL)
+{
+    CGRect result = CGRectNull;
+    if(aPath != NULL)
+    {
+        CGPathBoundsState state;
+        SVGPathBoundsInit(&state.bounds);
+        state.transformOrNULL = transformOrNULL;
+        state.lastPoint = state.subpathStart = CGPointZero;
+        CGPathApply(aPath, &state, AccumulateCGPathElementBounds);
+        if(!SVGPathBoundsIsEmpty(&state.bounds))
+        {
+            result = CGRectMake(state.bounds.minX, state.bounds.minY,
+                                state.bounds.maxX-state.bounds.minX, state.bounds.maxY-state.bounds.minY);
+        }
+    }
+    return result;
+}
+
+static void AppendCGPathElement(void* info, const CGPathElement* element)
+{
+    SVGPathBuffer* buffer = (SVGPathBuffer*)info;
+    const CGPoint* points = element->points;
+    switch(element->type)
+    {
+        case kCGPathElementMoveToPoint:
+            SVGPathBufferMoveTo(buffer, points[0].x, points[0].y);
+        break;
+        case kCGPathElementAddLineToPoint:
+            SVGPathBufferLineTo(buffer, points[0].x, points[0].y);
+        break;
+        case kCGPathElementAddQuadCurveToPoint:
+            SVGPathBufferQuadTo(buffer, points[0].x, points[0].y, points[1].x, points[1].y);
+        break;
+        case kCGPathElementAddCurveToPoint:
+            SVGPathBufferCubicTo(buffer, points[0].x, points[0].y, points[1].x, points[1].y, points[2].x, points[2].y);
+        break;
+        case kCGPathElementCloseSubpath:
+            SVGPathBufferClose(buffer);
+        break;
+    }
+}
+
+void SVGPathBufferAppendCGPath(SVGPathBuffer* buffer, CGPathRef aPath)
+{
+    if(aPath != NULL)
+    {
+        CGPathApply(aPath, buffer, AppendCGPathElement);
+    }
+}
+#endif
@@ -0,0 +1,200 @@
+//
+//  SVGPathBuffer.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#ifndef SVGPathBuffer_h
+#define SVGPathBuffer_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__APPLE__)
+#include <CoreGraphics/CoreGraphics.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief the drawing operations a path buffer holds. Everything SVG can express is reduced to these, arcs become cubics.
+*/
+typedef enum SVGPathVerb
+{
+    kSVGPathVerbMove = 0,   // 1 point
+    kSVGPathVerbLine,       // 1 point
+    kSVGPathVerbQuad,       // 2 points: control, end
+    kSVGPathVerbCubic,      // 3 points: control 1, control 2, end
+    kSVGPathVerbClose       // no points
+} SVGPathVerb;
+
+/*! @brief a parsed path as flat arrays, one of verbs and one of x,y coordinate pairs in absolute coordinates. Free of Foundation and Core Graphics so it can be cached, serialized and measured anywhere.
+*/
+typedef struct SVGPathBuffer
+{
+    uint8_t*    verbs;
+    size_t      verbCount;
+    size_t      verbCapacity;
+    float*      coordinates; // x0, y0, x1, y1...
+    size_t      coordinateCount; // number of floats, twice the number of points
+    size_t      coordinateCapacity;
+    
+    // state used while building
+    double      currentX, currentY;
+    double      subpathStartX, subpathStartY;
+    int         subpathOpen;
+} SVGPathBuffer;
+
+/*! @brief number of points that follow a verb
+*/
+size_t SVGPathVerbPointCount(SVGPathVerb verb);
+
+/*! @brief prepare an empty buffer
+*/
+void SVGPathBufferInit(SVGPathBuffer* buffer);
+
+/*! @brief release the storage of a buffer, it is left empty and can be reused
+*/
+void SVGPathBufferFree(SVGPathBuffer* buffer);
+
+/*! @brief empty the buffer but keep its storage for the next path
+*/
+void SVGPathBufferReset(SVGPathBuffer* buffer);
+
+/*! @brief make an independent copy of a buffer
+* @param destination an uninitialized buffer to copy into
+* @param source buffer to copy
+* @return 1 on success, 0 if memory could not be allocated
+*/
+int SVGPathBufferCopy(SVGPathBuffer* destination, const SVGPathBuffer* source);
+
+void SVGPathBufferMoveTo(SVGPathBuffer* buffer, double x, double y);
+void SVGPathBufferLineTo(SVGPathBuffer* buffer, double x, double y);
+void SVGPathBufferQuadTo(SVGPathBuffer* buffer, double controlX, double controlY, double x, double y);
+void SVGPathBufferCubicTo(SVGPathBuffer* buffer, double control1X, double control1Y, double control2X, double control2Y, double x, double y);
+void SVGPathBufferClose(SVGPathBuffer* buffer);
+
+/*! @brief append an SVG elliptical arc, starting at the current point, as a series of cubic Béziers
+* @param xRadius how wide is the arc
+* @param yRadius how high is the arc
+* @param xAxisRotationDegrees how titled is the x-axis off of the nominal x-axis
+* @param largeArcFlag will this arc follow the longest (1) or the shortest (0) way around the arc to the ending
+* @param sweepFlag does this go clockwise (1)
+* @param endPointX where does this arc terminate x
+* @param endPointY where does this arc terminate y
+*/
+void SVGPathBufferArcTo(SVGPathBuffer* buffer, double xRadius, double yRadius, double xAxisRotationDegrees,
+                        int largeArcFlag, int sweepFlag, double endPointX, double endPointY);
+
+/*! @brief parse the 'd' attribute of an SVG path, appending to the buffer
+* @param buffer destination
+* @param pathString the path data, need not be NUL terminated
+* @param length number of bytes in pathString
+* @return 1 if the whole string was understood, 0 if parsing stopped at an error (what came before the error is kept, as SVG requires)
+*/
+int SVGPathBufferAppendSVGPath(SVGPathBuffer* buffer, const char* pathString, size_t length);
+
+/*! @brief parse the 'points' attribute of an SVG polyline or polygon, a move to the first pair followed by lines to the rest
+* @param buffer destination
+* @param pointsString the coordinate list, need not be NUL terminated
+* @param length number of bytes in pointsString
+* @param closePath non-zero for a polygon
+* @return 1 if the whole list was understood, 0 if it had an odd number of coordinates or something that wasn't a number (the pairs before the error are kept)
+*/
+int SVGPathBufferAppendSVGPoints(SVGPathBuffer* buffer, const char* pointsString, size_t length, int closePath);
+
+/*! @brief an axis aligned box accumulated from path segments. Empty while minX > maxX.
+*/
+typedef struct SVGPathBounds
+{
+    double minX, minY;
+    double maxX, maxY;
+} SVGPathBounds;
+
+/*! @brief start with an empty box
+*/
+void SVGPathBoundsInit(SVGPathBounds* bounds);
+
+/*! @brief has anything been added to the box
+*/
+int SVGPathBoundsIsEmpty(const SVGPathBounds* bounds);
+
+void SVGPathBoundsAddPoint(SVGPathBounds* bounds, double x, double y);
+
+/*! @brief grow the box by a quadratic Bézier, solving for where its derivative is zero rather than including the control point
+*/
+void SVGPathBoundsAddQuad(SVGPathBounds* bounds, double startX, double startY, double controlX, double controlY, double endX, double endY);
+
+/*! @brief grow the box by a cubic Bézier, solving for its extrema rather than including the control points
+*/
+void SVGPathBoundsAddCubic(SVGPathBounds* bounds, double startX, double startY, double control1X, double control1Y,
+                           double control2X, double control2Y, double endX, double endY);
+
+/*! @brief the tight bounds of the path in one pass over the buffer. Arcs are already cubics in the buffer, so their extrema come out of the cubic solve.
+* @param buffer the parsed path
+* @param affineOrNULL optional transform as {a, b, c, d, tx, ty}, applied to the points before the extrema are found so a rotated path gets a tight box too
+* @param bounds receives the box
+* @return 0 if the path had no points
+*/
+int SVGPathBufferGetBounds(const SVGPathBuffer* buffer, const double* affineOrNULL, SVGPathBounds* bounds);
+
+#if defined(__APPLE__)
+/*! @brief make a Core Graphics path out of a buffer
+* @param buffer the parsed path
+* @param transformOrNULL optional transform to apply to every point
+* @return a new immutable path which the caller must release
+*/
+CGPathRef SVGPathBufferCreateCGPath(const SVGPathBuffer* buffer, const CGAffineTransform* transformOrNULL) CF_RETURNS_RETAINED;
+
+/*! @brief parse many 'd' attributes at once, spread across every core with dispatch_apply
+* @param pathStrings the path data, need not be NUL terminated
+* @param lengths the number of bytes in each of pathStrings
+* @param count how many paths
+* @param transformsOrNULL either count transforms, one per path, or NULL
+* @param results preallocated to hold count paths, each is a new immutable path which the caller must release
+*/
+void SVGPathBufferCreateCGPathsConcurrently(const char* const* pathStrings, const size_t* lengths, size_t count,
+                                            const CGAffineTransform* transformsOrNULL, CGPathRef* results);
+
+/*! @brief the tight bounds of an already built Core Graphics path, found the same way as SVGPathBufferGetBounds
+* @param aPath path to measure
+* @param transformOrNULL optional transform to apply to the points first
+* @return the bounds, or CGRectNull if the path was empty
+*/
+CGRect SVGPathBoundsOfCGPath(CGPathRef aPath, const CGAffineTransform* transformOrNULL);
+
+/*! @brief append the elements of a Core Graphics path, as when a path built in code is to be written out as SVG
+* @param buffer destination
+* @param aPath path to copy
+*/
+void SVGPathBufferAppendCGPath(SVGPathBuffer* buffer, CGPathRef aPath);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGPathBuffer_h */
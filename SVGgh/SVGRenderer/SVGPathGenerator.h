@@ -76,24 +76,54 @@ NS_ASSUME_NONNULL_BEGIN
 /*! @brief a bundle of mehtods that deal with the interaction between CGPaths and the text strings to build them
 */
 @interface SVGPathGenerator : NSObject
-/*! @brief given a CGPathRef, convert it to an SVG Path
+/*! @brief given a CGPathRef, convert it to an SVG Path, with absolute coordinates to one decimal place
 * @param aPath a path to be serialized
 * @return a string appropriate for a 'd' attribute of an SVG path entity
+* @see svgPathFromCGPath:precision:minify: for shorter output
 */
 +(nullable NSString*) svgPathFromCGPath:(CGPathRef)aPath;
 
+/*! @brief given a CGPathRef, convert it to an SVG Path, with control over its size
+* @param aPath a path to be serialized
+* @param precision how many digits to keep after the decimal point (at most FLT_DIG, as coordinates are held as floats), or -1 for the fewest digits which read back as exactly the same coordinates
+* @param minify if YES each segment is written in whichever of absolute, relative, implicit, H/V or S/T form is shortest, and unnecessary separators are dropped
+* @return a string appropriate for a 'd' attribute of an SVG path entity
+*/
++(nullable NSString*) svgPathFromCGPath:(CGPathRef)aPath precision:(NSInteger)precision minify:(BOOL)minify;
+
 /*! @brief given a 'd' attribute from an SVG path entity, create a Core Graphics Path
 * @param anSVGPath something like 'M33 11 H22 L 100 100 a 20 40 0 1 1 12 14 Z'
 * @param aTransform an affine transform to apply to the result at the time of creation
 */
 +(nullable CGPathRef) newCGPathFromSVGPath:(NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform CF_RETURNS_RETAINED;
 
+/*! @brief parse many 'd' attributes at once, spreading the work across all the cores. Useful for warming up a big document.
+* @param svgPaths the 'd' attributes to parse
+* @param transforms nil, or an NSValue wrapped CGAffineTransform for each path (as made by valueWithBytes:objCType:)
+* @return the CGPathRefs, in the same order as svgPaths
+*/
++(NSArray*) newCGPathsFromSVGPaths:(NSArray<NSString*>*)svgPaths whileApplyingTransforms:(nullable NSArray<NSValue*>*)transforms;
+
+/*! @brief given a 'points' attribute from an SVG polyline or polygon entity, create a Core Graphics Path
+* @param svgPoints something like '0,0 10,0 10 10'
+* @param closed YES for a polygon
+* @param aTransform an affine transform to apply to the result at the time of creation
+*/
++(nullable CGPathRef) newCGPathFromSVGPoints:(NSString*)svgPoints closed:(BOOL)closed whileApplyingTransform:(CGAffineTransform)aTransform CF_RETURNS_RETAINED;
+
 /*! @brief given a SVG path in text form, return a bounding box (includes control points)
 * @param anSVGPath a string from a path entity's 'd' attribute
 * @return a rectangle which encapulates all the points on the path and any control points
 */
 +(CGRect)  maxBoundingBoxForSVGPath:(NSString*)anSVGPath;
 
+/*! @brief given a SVG path in text form, return the tight bounding box of the curve itself, solving for the extrema of Béziers and arcs rather than including their control points. Doesn't build a CGPath.
+* @param anSVGPath a string from a path entity's 'd' attribute
+* @param aTransform applied to the path before it is measured
+* @return the smallest rectangle containing every point on the path, CGRectNull for an empty path
+*/
++(CGRect)  tightBoundingBoxForSVGPath:(NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform;
+
 /*! @brief validate the provided SVG path string
 * @param anSVGPath a string from a path entity's 'd' attribute
 * @return an object which should be checked for errors in parsing the path
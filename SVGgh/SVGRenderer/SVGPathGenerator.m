@@ -29,6 +29,9 @@
 #import "SVGPathGenerator.h"
 #import "SVGUtilities.h"
 #import "GHPathUtilities.h"
+#import "SVGPathBuffer.h"
+#import "SVGPathWriter.h"
+#import "GHPathCache.h"
 
 @interface NSMutableAttributedString (GH)
 - (void)setAttributes:(NSDictionary *)attrs forCharactersInSet:(NSCharacterSet*)aSet;
@@ -1060,6 +1063,26 @@ int ParameterCountForOperator(unichar anOperator)
 }
 
 
++(CGRect)  tightBoundingBoxForSVGPath:(NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform
+{
+    CGRect result = CGRectNull;
+    const char* pathString = [anSVGPath UTF8String];
+    if(pathString != NULL)
+    {
+        SVGPathBuffer pathBuffer;
+        SVGPathBufferInit(&pathBuffer);
+        SVGPathBufferAppendSVGPath(&pathBuffer, pathString, strlen(pathString));
+        const double affine[6] = {aTransform.a, aTransform.b, aTransform.c, aTransform.d, aTransform.tx, aTransform.ty};
+        SVGPathBounds bounds;
+        if(SVGPathBufferGetBounds(&pathBuffer, CGAffineTransformIsIdentity(aTransform) ? NULL : affine, &bounds))
+        {
+            result = CGRectMake(bounds.minX, bounds.minY, bounds.maxX-bounds.minX, bounds.maxY-bounds.minY);
+        }
+        SVGPathBufferFree(&pathBuffer);
+    }
+    return result;
+}
+
 +(CGRect)  maxBoundingBoxForSVGPath:(NSString*)anSVGPath
 {
     CGRect result = CGRectNull;
@@ -1465,417 +1488,79 @@ int ParameterCountForOperator(unichar anOperator)
 
 +(CGPathRef) newCGPathFromSVGPath:(NSString*)anSVGPath whileApplyingTransform:(CGAffineTransform)aTransform
 {
-    NSString* pathToRender = [anSVGPath stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-	CGMutablePathRef	mutableResult = CGPathCreateMutable();
-	if([pathToRender length])
-	{
-        CGPathMoveToPoint(mutableResult, NULL, 0.0, 0.0);
-		NSData* asciiData = [pathToRender dataUsingEncoding:NSASCIIStringEncoding];
-		NSUInteger	dataLength = [asciiData length];
-		const char*		rawData = (const char*)[asciiData bytes];
-		NSUInteger	index = 0;
-		char	activeOperator = 'M';
-		BOOL	errorState = NO;
-		CGFloat	lastCubicControlX = CGFLOAT_MAX;
-		CGFloat	lastCubicControlY = CGFLOAT_MAX;
-		
-		CGFloat	lastQuadraticControlX = CGFLOAT_MAX;
-		CGFloat	lastQuadraticControlY = CGFLOAT_MAX;
-        BOOL failed = NO;
-		
-		while(index < dataLength && !errorState && !failed)
-		{
-			char anOperator = rawData[index];
-			if((anOperator >= 'a' && anOperator <= 'z') || (anOperator >= 'A' && anOperator <= 'Z'))
-			{ // is there a new activeOperator, or should we continue to treat numbers like they had gotten the previous activeOperator
-				activeOperator = rawData[index++]; // new activeOperator
-			}
-			switch(activeOperator)
-			{
-				case 'M': // absolute moveto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-                    if(!failed) CGPathMoveToPoint(mutableResult,NULL, xCoord, yCoord);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-					activeOperator = 'L'; // subsequent implied operations will be absolute line to's
-				}
-                break;
-                    
-				case 'm': // relative moveto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					
-					if(!CGPathIsEmpty(mutableResult))
-					{
-						CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-						xCoord += curPoint.x;
-						yCoord += curPoint.y;
-					}
-					if(!failed) CGPathMoveToPoint(mutableResult,NULL, xCoord, yCoord);
-					
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-					activeOperator = 'l'; // subsequent implied operations will be relative line tos
-				}
-                break;
-                    
-				case 'Z':
-				case 'z': // close path
-				{
-					CGPathCloseSubpath(mutableResult);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-					
-					if(index < (dataLength-1))
-					{
-						char nextOperator = rawData[index];
-						if(nextOperator != 'z' &&
-                           ((nextOperator >= 'a' && nextOperator <= 'z') ||
-                            (nextOperator >= 'A' && nextOperator <= 'Z')))
-						{
-							
-						}
-						else {
-							index++;
-						}
-					}
-					else
-					{
-						index++;
-					}
-				}
-                break;
-                    
-				case 'L': // absolute lineto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, xCoord, yCoord);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-                    
-				}
-                break;
-                    
-				case 'l': // relative lineto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					if(!CGPathIsEmpty(mutableResult))
-					{
-						CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-						xCoord += curPoint.x;
-						yCoord += curPoint.y;
-					}
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, xCoord, yCoord);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'H':// absolute horizontal lineto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, xCoord, curPoint.y);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'h':// relative horizontal lineto
-				{
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					xCoord += curPoint.x;
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, xCoord, curPoint.y);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'V': // absolute vertical lineto
-				{
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, curPoint.x, yCoord);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'v': // relative vertical lineto
-				{
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					yCoord += curPoint.y;
-					if(!failed) CGPathAddLineToPoint(mutableResult,NULL, curPoint.x, yCoord);
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'C': // absolute Cubic Bezier curve
-				{
-					CGFloat	xControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					
-					
-					if(!failed) CGPathAddCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-										  xControl2, yControl2, xCoord, yCoord);
-					
-					lastCubicControlX = xControl2;
-					lastCubicControlY = yControl2;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-				
-                case 'c': // relative Cubic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					CGFloat	xControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					
-					
-					if(!failed) CGPathAddCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-										  xControl2, yControl2, xCoord, yCoord);
-					
-					lastCubicControlX = xControl2;
-					lastCubicControlY = yControl2;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'S': // absolute shorthand Cubic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xControl1 = curPoint.x;
-					CGFloat yControl1 = curPoint.y;
-					
-					if(lastCubicControlX != CGFLOAT_MAX)
-					{
-						xControl1 -= (lastCubicControlX-xControl1);
-						yControl1 -= (lastCubicControlY-yControl1);
-					}
-					
-					
-					if(!failed) CGPathAddCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-										  xControl2, yControl2, xCoord, yCoord);
-					lastCubicControlX = xControl2;
-					lastCubicControlY = yControl2;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 's': // relative shorthand  Cubic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yControl2 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					CGFloat	xControl1 = curPoint.x;
-					CGFloat yControl1 = curPoint.y;
-					
-					if(lastCubicControlX != CGFLOAT_MAX)
-					{
-						xControl1 -= (lastCubicControlX-xControl1);
-						yControl1 -= (lastCubicControlY-yControl1);
-					}
-					
-					
-					if(!failed) CGPathAddCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-										  xControl2, yControl2, xCoord, yCoord);
-					lastCubicControlX = xControl2;
-					lastCubicControlY = yControl2;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-				case 'Q': // absolute quadratic Bezier curve
-				{
-					CGFloat	xControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					
-					if(!failed) CGPathAddQuadCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-                                              xCoord, yCoord);
-					
-					lastQuadraticControlX = xControl1;
-					lastQuadraticControlY = yControl1;
-					lastCubicControlX = CGFLOAT_MAX;
-				}
-                break;
-				case 'q': // relative quadratic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yControl1 = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					
-					
-					if(!failed) CGPathAddQuadCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-											  xCoord, yCoord);
-					
-					lastQuadraticControlX = xControl1;
-					lastQuadraticControlY = yControl1;
-					lastCubicControlX = CGFLOAT_MAX;
-				}
-                break;
-				case 'T': // absolute shorthand quadratic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xControl1 = curPoint.x;
-					CGFloat yControl1 = curPoint.y;
-					
-					if(lastQuadraticControlX != CGFLOAT_MAX)
-					{
-						xControl1 -= (lastQuadraticControlX-xControl1);
-						yControl1 -= (lastQuadraticControlY-yControl1);
-					}
-					
-					
-					if(!failed) CGPathAddQuadCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-											  xCoord, yCoord);
-					
-					
-					lastQuadraticControlX = xControl1;
-					lastQuadraticControlY = yControl1;
-					lastCubicControlX = CGFLOAT_MAX;
-				}
-                break;
-				case 't': // relative shorthand  quadratic Bezier curve
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					
-					CGFloat	xControl1 = curPoint.x;
-					CGFloat yControl1 = curPoint.y;
-					
-					if(lastQuadraticControlX != CGFLOAT_MAX)
-					{
-						xControl1 -= (lastQuadraticControlX-xControl1);
-						yControl1 -= (lastQuadraticControlY-yControl1);
-					}
-					if(!failed) CGPathAddQuadCurveToPoint(mutableResult,NULL, xControl1, yControl1,
-											  xCoord, yCoord);
-					
-					
-					
-					lastQuadraticControlX = xControl1;
-					lastQuadraticControlY = yControl1;
-					lastCubicControlX = CGFLOAT_MAX;
-				}
-                break;
-					
-				case 'A': // absolute elliptical Arc segment
-				{
-					CGFloat	xRadius = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yRadius = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xAxisRotationDegrees = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					BOOL	largeArcFlag = (GetNextCoordinate(rawData, &index, dataLength, &failed) == 0.0)?NO:YES;
-					BOOL	sweepFlag = (GetNextCoordinate(rawData, &index, dataLength, &failed) == 0.0)?NO:YES;
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					
-					if(!failed) AddSVGArcToPath(mutableResult, xRadius, yRadius, xAxisRotationDegrees,
-									largeArcFlag, sweepFlag, xCoord, yCoord);
-					
-                    
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				case 'a': // relative elliptical arc Seqment
-				{
-					CGPoint curPoint = CGPathGetCurrentPoint(mutableResult);
-					CGFloat	xRadius = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	yRadius = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					CGFloat	xAxisRotationDegrees = GetNextCoordinate(rawData, &index, dataLength, &failed);
-					BOOL	largeArcFlag = (GetNextCoordinate(rawData, &index, dataLength, &failed) == 0.0)?NO:YES;
-					BOOL	sweepFlag = (GetNextCoordinate(rawData, &index, dataLength, &failed) == 0.0)?NO:YES;
-					CGFloat	xCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.x;
-					CGFloat	yCoord = GetNextCoordinate(rawData, &index, dataLength, &failed)+curPoint.y;
-					
-					if(!failed) AddSVGArcToPath(mutableResult, xRadius, yRadius, xAxisRotationDegrees,
-									largeArcFlag, sweepFlag, xCoord, yCoord);
-					
-					lastCubicControlX = CGFLOAT_MAX;
-					lastQuadraticControlX = CGFLOAT_MAX;
-				}
-                break;
-                    
-				default:
-				{
-					errorState = YES; // don't know where I am bail
-					NSLog(@"Unknown path operand: %c", activeOperator);
-				}
-                break;
-			}
-		}
-        
-		if(index < dataLength)
-		{
-			char nextChar = rawData[index];
-			while((nextChar == ' ' || nextChar == '\n' || nextChar == '\r') && index < dataLength)
-			{
-				nextChar = rawData[++index];
-			}
-			if((nextChar >= 'a' && nextChar <= 'z')
-			   ||(nextChar >= 'A' && nextChar <= 'Z'))
-			{
-				activeOperator = nextChar;
-				index++;
-				if(index >= dataLength &&
-				   (activeOperator == 'z' || activeOperator == 'Z')) // handle terminating close path
-				{
-					CGPathCloseSubpath(mutableResult);
-				}
-			}
-		}
-	}
-    CGPathRef result = 0;
-    if(!CGAffineTransformIsIdentity(aTransform))
-    {
-        result = CGPathCreateCopyByTransformingPath(mutableResult, &aTransform);
+    const char* pathString = [anSVGPath UTF8String];
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    if(pathString != NULL)
+    {// a malformed path keeps what was drawn before the error
+        SVGPathBufferAppendSVGPath(&pathBuffer, pathString, strlen(pathString));
     }
-    else
+    CGPathRef result = SVGPathBufferCreateCGPath(&pathBuffer, CGAffineTransformIsIdentity(aTransform) ? NULL : &aTransform);
+    SVGPathBufferFree(&pathBuffer);
+	return result;
+}
+
++(NSArray*) newCGPathsFromSVGPaths:(NSArray<NSString*>*)svgPaths whileApplyingTransforms:(NSArray<NSValue*>*)transforms
+{
+    NSUInteger count = svgPaths.count;
+    NSAssert(transforms == nil || transforms.count == count, @"Need a transform for every path");
+    if(count == 0)
     {
-        result = CGPathCreateCopy(mutableResult);
+        return @[];
     }
-   
     
-	CGPathRelease(mutableResult);
-	return result;
+    const char** pathStrings = malloc(count*sizeof(const char*));
+    size_t* lengths = malloc(count*sizeof(size_t));
+    CGAffineTransform* transformList = (transforms != nil) ? malloc(count*sizeof(CGAffineTransform)) : NULL;
+    CGPathRef* results = calloc(count, sizeof(CGPathRef));
+    
+    NSUInteger index = 0;
+    for(NSString* anSVGPath in svgPaths)
+    {// the UTF8 buffers belong to the strings, which svgPaths keeps alive until we are done
+        pathStrings[index] = [anSVGPath UTF8String];
+        lengths[index] = (pathStrings[index] != NULL) ? strlen(pathStrings[index]) : 0;
+        if(transformList != NULL)
+        {
+            [transforms[index] getValue:&transformList[index]];
+        }
+        index++;
+    }
+    
+    SVGPathBufferCreateCGPathsConcurrently(pathStrings, lengths, count, transformList, results);
+    
+    NSMutableArray* mutableResult = [[NSMutableArray alloc] initWithCapacity:count];
+    for(index = 0; index < count; index++)
+    {
+        [mutableResult addObject:(__bridge_transfer id)results[index]];
+    }
+    free(pathStrings);
+    free(lengths);
+    free(transformList);
+    free(results);
+    return [mutableResult copy];
+}
+
++(CGPathRef) newCGPathFromSVGPoints:(NSString*)svgPoints closed:(BOOL)closed whileApplyingTransform:(CGAffineTransform)aTransform
+{
+    const char* pointsString = [svgPoints UTF8String];
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    if(pointsString != NULL)
+    {// like a path, an odd coordinate or garbage ends the shape but keeps what came before
+        SVGPathBufferAppendSVGPoints(&pathBuffer, pointsString, strlen(pointsString), closed);
+    }
+    CGPathRef result = SVGPathBufferCreateCGPath(&pathBuffer, CGAffineTransformIsIdentity(aTransform) ? NULL : &aTransform);
+    SVGPathBufferFree(&pathBuffer);
+    return result;
 }
 
 
 +(NSString*) svgPathFromCGPath:(CGPathRef)aPath
-{
+{// the absolute, one decimal format this has always written, svgPathFromCGPath:precision:minify: is for smaller output
     __block NSMutableString* mutableResult = [[NSMutableString alloc] initWithCapacity:512];
     
     __block  CGPoint currentPoint = CGPointZero;
-    __block CGPathElementType lastOperation = kCGPathElementCloseSubpath;
+    __block  CGPoint subpathStart = CGPointZero;
     __block pathVisitor_t   callback =  ^(const CGPathElement* aPathElement)
     {
         switch (aPathElement->type)
@@ -1884,6 +1569,7 @@ int ParameterCountForOperator(unichar anOperator)
             {
                 CGPoint newPoint = aPathElement->points[0];
                 currentPoint = newPoint;
+                subpathStart = newPoint;
                 [mutableResult appendFormat:@"M%.1lf %.1lf", currentPoint.x, currentPoint.y];
             }
             break;
@@ -1931,6 +1617,7 @@ int ParameterCountForOperator(unichar anOperator)
             case kCGPathElementCloseSubpath:
             {
                 [mutableResult appendString:@"Z"];
+                currentPoint = subpathStart; // so a following H or V is measured from where a reader would be
             }
             break;
             default:
@@ -1938,16 +1625,39 @@ int ParameterCountForOperator(unichar anOperator)
             }
             break;
         }
-        lastOperation = aPathElement->type;
     };
     
     CGPathApply(aPath, (__bridge void *)callback, CGPathApplyCallbackFunction);
     return [mutableResult copy];
 }
+
++(NSString*) svgPathFromCGPath:(CGPathRef)aPath precision:(NSInteger)precision minify:(BOOL)minify
+{
+    NSString* result = nil;
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    SVGPathBufferAppendCGPath(&pathBuffer, aPath);
+    
+    SVGPathWriterOptions options;
+    options.precision = (precision < 0) ? -1 : (int)MIN(precision, FLT_DIG); // the buffer holds floats, more digits would only be noise
+    options.minify = minify;
+    size_t length = 0;
+    char* pathString = SVGPathBufferCopySVGPath(&pathBuffer, &options, &length);
+    if(pathString != NULL)
+    {
+        result = [[NSString alloc] initWithBytesNoCopy:pathString length:length encoding:NSUTF8StringEncoding freeWhenDone:YES];
+        if(result == nil)
+        {
+            free(pathString);
+        }
+    }
+    SVGPathBufferFree(&pathBuffer);
+    return result;
+}
 @end
 
 CGPathRef CreatePathFromSVGPathString(NSString* dAttribute, CGAffineTransform transformToApply) CF_RETURNS_RETAINED
 {
-    CGPathRef result = [SVGPathGenerator newCGPathFromSVGPath:dAttribute whileApplyingTransform:transformToApply];
+    CGPathRef result = [[GHPathCache sharedPathCache] newPathFromSVGPath:dAttribute whileApplyingTransform:transformToApply];
     return result;
 }
@@ -0,0 +1,427 @@
+//
+//  SVGPathWriter.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+#include "SVGPathWriter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kMaxWriterPrecision 9
+#define kMaxExactScaled 9.0e15 // below 2^53, so the scaled integer and the value read back are both exact
+#define kMaxNumberLength 32
+#define kMaxSegmentLength (1+6*(kMaxNumberLength+1))
+
+static const double kWriterPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+static const unsigned long long kWriterIntegerPowersOfTen[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL};
+
+typedef struct CharBuffer
+{
+    char*   bytes;
+    size_t  length;
+    size_t  capacity;
+    int     failed;
+} CharBuffer;
+
+static void AppendBytes(CharBuffer* buffer, const char* bytes, size_t length)
+{
+    if(buffer->failed)
+    {
+        return;
+    }
+    if(buffer->length+length+1 > buffer->capacity)
+    {
+        size_t newCapacity = buffer->capacity ? buffer->capacity*2 : 256;
+        while(newCapacity < buffer->length+length+1)
+        {
+            newCapacity *= 2;
+        }
+        char* newBytes = (char*)realloc(buffer->bytes, newCapacity);
+        if(newBytes == NULL)
+        {
+            buffer->failed = 1;
+            return;
+        }
+        buffer->bytes = newBytes;
+        buffer->capacity = newCapacity;
+    }
+    memcpy(buffer->bytes+buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+static char* WriteUnsigned(unsigned long long value, char* cursor)
+{
+    char reversed[24];
+    size_t count = 0;
+    do
+    {
+        reversed[count++] = (char)('0'+(value % 10));
+        value /= 10;
+    } while(value != 0);
+    while(count > 0)
+    {
+        *cursor++ = reversed[--count];
+    }
+    return cursor;
+}
+
+static size_t WriteScaledInteger(long long scaled, int decimals, int dropLeadingZero, char* destination)
+{// scaled/10^decimals, with trailing zeros in the fraction trimmed
+    char* cursor = destination;
+    if(scaled == 0)
+    {
+        *cursor = '0';
+        return 1;
+    }
+    if(scaled < 0)
+    {
+        *cursor++ = '-';
+        scaled = -scaled;
+    }
+    unsigned long long whole = (unsigned long long)scaled/kWriterIntegerPowersOfTen[decimals];
+    unsigned long long fraction = (unsigned long long)scaled%kWriterIntegerPowersOfTen[decimals];
+    int fractionDigits = decimals;
+    while(fractionDigits > 0 && fraction%10 == 0)
+    {
+        fraction /= 10;
+        fractionDigits--;
+    }
+    if(whole != 0 || fractionDigits == 0 || !dropLeadingZero)
+    {
+        cursor = WriteUnsigned(whole, cursor);
+    }
+    if(fractionDigits > 0)
+    {
+        *cursor++ = '.';
+        for(int digit = fractionDigits-1; digit >= 0; digit--)
+        {
+            cursor[digit] = (char)('0'+(fraction % 10));
+            fraction /= 10;
+        }
+        cursor += fractionDigits;
+    }
+    return (size_t)(cursor-destination);
+}
+
+// write target-base, choosing the text so that a reader adding what it parses to base lands on target.
+// readBack gets the value the reader will parse.
+static size_t FormatOffset(double target, double base, int precision, int dropLeadingZero, char* destination, double* readBack)
+{
+    double value = target-base;
+    if(precision >= 0)
+    {
+        if(precision > kMaxWriterPrecision)
+        {
+            precision = kMaxWriterPrecision;
+        }
+        double scaledValue = value*kWriterPowersOfTen[precision];
+        if(fabs(scaledValue) < kMaxExactScaled)
+        {
+            long long scaled = llround(scaledValue);
+            *readBack = (double)scaled/kWriterPowersOfTen[precision];
+            return WriteScaledInteger(scaled, precision, dropLeadingZero, destination);
+        }
+    }
+    else
+    {// shortest: coordinates are floats, so find the fewest decimals that come back as the same float
+        float targetFloat = (float)target;
+        for(int decimals = 0; decimals <= kMaxWriterPrecision; decimals++)
+        {
+            double scaledValue = value*kWriterPowersOfTen[decimals];
+            if(fabs(scaledValue) >= kMaxExactScaled)
+            {
+                break;
+            }
+            long long scaled = llround(scaledValue);
+            double candidate = (double)scaled/kWriterPowersOfTen[decimals];
+            if((float)(base+candidate) == targetFloat)
+            {
+                *readBack = candidate;
+                return WriteScaledInteger(scaled, decimals, dropLeadingZero, destination);
+            }
+        }
+    }
+    // huge or tiny, let the C library write it, a float never needs more than 9 significant digits
+    int length = 0;
+    for(int digits = (precision < 0) ? 1 : 17; digits <= 17; digits++)
+    {
+        length = snprintf(destination, kMaxNumberLength, "%.*g", digits, value);
+        *readBack = strtod(destination, NULL);
+        if(precision >= 0 || (float)(base+*readBack) == (float)target)
+        {
+            break;
+        }
+    }
+    return (length > 0) ? (size_t)length : 0;
+}
+
+size_t SVGPathWriterFormatNumber(double value, int precision, int dropLeadingZero, char* destination)
+{
+    double readBack;
+    return FormatOffset(value, 0.0, precision, dropLeadingZero, destination, &readBack);
+}
+
+// what a parser reading the output so far would believe
+typedef struct WriterState
+{
+    double  readerX, readerY;
+    double  startX, startY;
+    double  lastControlX, lastControlY;
+    char    lastCurve;          // 'C' or 'Q' if the last segment leaves a control point to reflect
+    char    implicitCommand;    // the command a bare list of numbers would continue
+    int     afterNumber;
+    int     afterDecimal;       // the last number had a '.' or an exponent, so a following '.5' needs no separator
+} WriterState;
+
+typedef struct Candidate
+{
+    char        text[kMaxSegmentLength];
+    size_t      length;
+    WriterState state;
+} Candidate;
+
+typedef struct Writer
+{
+    CharBuffer          output;
+    WriterState         state;
+    SVGPathWriterOptions options;
+} Writer;
+
+static void BeginCandidate(Candidate* candidate, const Writer* writer, char command)
+{
+    candidate->state = writer->state;
+    candidate->length = 0;
+    if(!writer->options.minify || command != writer->state.implicitCommand)
+    {
+        candidate->text[candidate->length++] = command;
+        candidate->state.afterNumber = 0;
+    }
+    candidate->state.implicitCommand = (command == 'M') ? 'L' : ((command == 'm') ? 'l' : command);
+}
+
+static double AddNumber(Candidate* candidate, const Writer* writer, double target, double base)
+{
+    char number[kMaxNumberLength];
+    double readBack = 0.0;
+    int minify = writer->options.minify;
+    size_t numberLength = FormatOffset(target, base, writer->options.precision, minify, number, &readBack);
+    if(candidate->state.afterNumber
+       && !(minify && (number[0] == '-' || (number[0] == '.' && candidate->state.afterDecimal))))
+    {
+        candidate->text[candidate->length++] = ' ';
+    }
+    memcpy(candidate->text+candidate->length, number, numberLength);
+    candidate->length += numberLength;
+    candidate->state.afterNumber = 1;
+    candidate->state.afterDecimal = (memchr(number, '.', numberLength) != NULL) || (memchr(number, 'e', numberLength) != NULL);
+    return base+readBack;
+}
+
+static int Matches(const Writer* writer, double readerValue, double target)
+{// would the reader's value do in place of the target
+    if(writer->options.precision < 0)
+    {
+        return (float)readerValue == (float)target;
+    }
+    int precision = (writer->options.precision > kMaxWriterPrecision) ? kMaxWriterPrecision : writer->options.precision;
+    return fabs(readerValue-target) <= 0.5/kWriterPowersOfTen[precision];
+}
+
+static void KeepIfShorter(Candidate* best, const Candidate* candidate, int* haveBest)
+{
+    if(!*haveBest || candidate->length < best->length)
+    {
+        *best = *candidate;
+        *haveBest = 1;
+    }
+}
+
+static void WriteSegment(Writer* writer, SVGPathVerb verb, const float* points)
+{
+    Candidate best, candidate;
+    int haveBest = 0;
+    int relativeChoices = writer->options.minify ? 2 : 1;
+    const WriterState* state = &writer->state;
+    
+    for(int relative = 0; relative < relativeChoices; relative++)
+    {
+        double baseX = relative ? state->readerX : 0.0;
+        double baseY = relative ? state->readerY : 0.0;
+        switch(verb)
+        {
+            case kSVGPathVerbMove:
+            {
+                BeginCandidate(&candidate, writer, relative ? 'm' : 'M');
+                double x = AddNumber(&candidate, writer, points[0], baseX);
+                double y = AddNumber(&candidate, writer, points[1], baseY);
+                candidate.state.readerX = candidate.state.startX = (float)x;
+                candidate.state.readerY = candidate.state.startY = (float)y;
+                candidate.state.lastCurve = 0;
+                KeepIfShorter(&best, &candidate, &haveBest);
+            }
+            break;
+            case kSVGPathVerbLine:
+            {
+                BeginCandidate(&candidate, writer, relative ? 'l' : 'L');
+                double x = AddNumber(&candidate, writer, points[0], baseX);
+                double y = AddNumber(&candidate, writer, points[1], baseY);
+                candidate.state.readerX = (float)x;
+                candidate.state.readerY = (float)y;
+                candidate.state.lastCurve = 0;
+                KeepIfShorter(&best, &candidate, &haveBest);
+                
+                if(writer->options.minify && Matches(writer, state->readerY, points[1]))
+                {
+                    BeginCandidate(&candidate, writer, relative ? 'h' : 'H');
+                    candidate.state.readerX = (float)AddNumber(&candidate, writer, points[0], baseX);
+                    candidate.state.lastCurve = 0;
+                    KeepIfShorter(&best, &candidate, &haveBest);
+                }
+                if(writer->options.minify && Matches(writer, state->readerX, points[0]))
+                {
+                    BeginCandidate(&candidate, writer, relative ? 'v' : 'V');
+                    candidate.state.readerY = (float)AddNumber(&candidate, writer, points[1], baseY);
+                    candidate.state.lastCurve = 0;
+                    KeepIfShorter(&best, &candidate, &haveBest);
+                }
+            }
+            break;
+            case kSVGPathVerbQuad:
+            {
+                BeginCandidate(&candidate, writer, relative ? 'q' : 'Q');
+                candidate.state.lastControlX = AddNumber(&candidate, writer, points[0], baseX);
+                candidate.state.lastControlY = AddNumber(&candidate, writer, points[1], baseY);
+                candidate.state.readerX = (float)AddNumber(&candidate, writer, points[2], baseX);
+                candidate.state.readerY = (float)AddNumber(&candidate, writer, points[3], baseY);
+                candidate.state.lastCurve = 'Q';
+                KeepIfShorter(&best, &candidate, &haveBest);
+                
+                double reflectedX = state->readerX, reflectedY = state->readerY;
+                if(state->lastCurve == 'Q')
+                {// same arithmetic as the parser
+                    reflectedX -= (state->lastControlX-reflectedX);
+                    reflectedY -= (state->lastControlY-reflectedY);
+                }
+                if(writer->options.minify && Matches(writer, reflectedX, points[0]) && Matches(writer, reflectedY, points[1]))
+                {
+                    BeginCandidate(&candidate, writer, relative ? 't' : 'T');
+                    candidate.state.lastControlX = reflectedX;
+                    candidate.state.lastControlY = reflectedY;
+                    candidate.state.readerX = (float)AddNumber(&candidate, writer, points[2], baseX);
+                    candidate.state.readerY = (float)AddNumber(&candidate, writer, points[3], baseY);
+                    candidate.state.lastCurve = 'Q';
+                    KeepIfShorter(&best, &candidate, &haveBest);
+                }
+            }
+            break;
+            case kSVGPathVerbCubic:
+            {
+                BeginCandidate(&candidate, writer, relative ? 'c' : 'C');
+                AddNumber(&candidate, writer, points[0], baseX);
+                AddNumber(&candidate, writer, points[1], baseY);
+                candidate.state.lastControlX = AddNumber(&candidate, writer, points[2], baseX);
+                candidate.state.lastControlY = AddNumber(&candidate, writer, points[3], baseY);
+                candidate.state.readerX = (float)AddNumber(&candidate, writer, points[4], baseX);
+                candidate.state.readerY = (float)AddNumber(&candidate, writer, points[5], baseY);
+                candidate.state.lastCurve = 'C';
+                KeepIfShorter(&best, &candidate, &haveBest);
+                
+                double reflectedX = state->readerX, reflectedY = state->readerY;
+                if(state->lastCurve == 'C')
+                {
+                    reflectedX -= (state->lastControlX-reflectedX);
+                    reflectedY -= (state->lastControlY-reflectedY);
+                }
+                if(writer->options.minify && Matches(writer, reflectedX, points[0]) && Matches(writer, reflectedY, points[1]))
+                {
+                    BeginCandidate(&candidate, writer, relative ? 's' : 'S');
+                    candidate.state.lastControlX = AddNumber(&candidate, writer, points[2], baseX);
+                    candidate.state.lastControlY = AddNumber(&candidate, writer, points[3], baseY);
+                    candidate.state.readerX = (float)AddNumber(&candidate, writer, points[4], baseX);
+                    candidate.state.readerY = (float)AddNumber(&candidate, writer, points[5], baseY);
+                    candidate.state.lastCurve = 'C';
+                    KeepIfShorter(&best, &candidate, &haveBest);
+                }
+            }
+            break;
+            case kSVGPathVerbClose:
+            {
+                BeginCandidate(&candidate, writer, writer->options.minify ? 'z' : 'Z');
+                candidate.state.readerX = state->startX;
+                candidate.state.readerY = state->startY;
+                candidate.state.lastCurve = 0;
+                candidate.state.implicitCommand = 0;
+                KeepIfShorter(&best, &candidate, &haveBest);
+                relative = relativeChoices; // only the one way to write it
+            }
+            break;
+        }
+    }
+    if(haveBest)
+    {
+        AppendBytes(&writer->output, best.text, best.length);
+        writer->state = best.state;
+    }
+}
+
+char* SVGPathBufferCopySVGPath(const SVGPathBuffer* buffer, const SVGPathWriterOptions* optionsOrNULL, size_t* lengthOut)
+{
+    Writer writer;
+    memset(&writer, 0, sizeof(writer));
+    if(optionsOrNULL != NULL)
+    {
+        writer.options = *optionsOrNULL;
+    }
+    else
+    {
+        writer.options.precision = -1;
+        writer.options.minify = 1;
+    }
+    
+    const float* points = buffer->coordinates;
+    for(size_t index = 0; index < buffer->verbCount; index++)
+    {
+        SVGPathVerb verb = (SVGPathVerb)buffer->verbs[index];
+        WriteSegment(&writer, verb, points);
+        points += 2*SVGPathVerbPointCount(verb);
+    }
+    
+    AppendBytes(&writer.output, "", 0); // make sure there is room for the NUL even for an empty path
+    if(writer.output.failed)
+    {
+        free(writer.output.bytes);
+        return NULL;
+    }
+    writer.output.bytes[writer.output.length] = 0;
+    if(lengthOut != NULL)
+    {
+        *lengthOut = writer.output.length;
+    }
+    return writer.output.bytes;
+}
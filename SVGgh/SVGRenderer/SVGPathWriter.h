@@ -0,0 +1,69 @@
+//
+//  SVGPathWriter.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGPathWriter_h
+#define SVGPathWriter_h
+
+#include <stddef.h>
+#include "SVGPathBuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief how a path buffer should be written out as a 'd' attribute
+*/
+typedef struct SVGPathWriterOptions
+{
+    int precision;  // most digits kept after the decimal point (0-9), or negative for the shortest text that reads back as exactly the same float
+    int minify;     // non-zero to pick, per segment, whichever of absolute, relative, implicit, H/V and S/T takes the fewest bytes and to drop separators and leading zeros where SVG allows
+} SVGPathWriterOptions;
+
+/*! @brief serialize a path buffer into SVG path data, without going through Foundation
+* @param buffer the path to write
+* @param optionsOrNULL how to write it, NULL for the shortest exact numbers, minified
+* @param lengthOut optional, receives the length of the result not counting the NUL
+* @return a NUL terminated string the caller must free(), or NULL if memory ran out
+*/
+char* SVGPathBufferCopySVGPath(const SVGPathBuffer* buffer, const SVGPathWriterOptions* optionsOrNULL, size_t* lengthOut);
+
+/*! @brief write a number as it would appear in SVG path data
+* @param value the number
+* @param precision as in SVGPathWriterOptions, when negative value is treated as a float and written with as few digits as will read back as that float
+* @param dropLeadingZero non-zero to write 0.5 as .5
+* @param destination at least 32 bytes, not NUL terminated
+* @return number of bytes written
+*/
+size_t SVGPathWriterFormatNumber(double value, int precision, int dropLeadingZero, char* destination);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGPathWriter_h */
@@ -0,0 +1,1690 @@
+//
+//  SVGRasterizer.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#include "SVGRasterizer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI // not ISO C, strict -std=c11 leaves it out of math.h
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define SVG_RASTER_VECTORS 1
+// two pixels at a time, 16 byte vectors are passed in registers everywhere, 32 byte ones change the ABI without AVX
+typedef uint8_t RasterU8x8 __attribute__((vector_size(8)));
+typedef uint16_t RasterU16x8 __attribute__((vector_size(16)));
+#else
+#define SVG_RASTER_VECTORS 0
+#endif
+
+#define kRasterTolerance 0.25 // how far, in pixels, a flattened curve may stray
+#define kRasterLUTSize 256
+
+/*! @brief a gradient's colors sampled once, premultiplied, shared between the saved copies of a paint
+*/
+typedef struct RasterColorTable
+{
+    size_t  refCount;
+    uint8_t colors[kRasterLUTSize][4];
+} RasterColorTable;
+
+typedef struct RasterPaint
+{
+    SVGDrawingPaintType type;
+    uint8_t             color[4]; // premultiplied
+    RasterColorTable*   table;
+    double              start[2];
+    double              end[2];
+    double              startRadius;
+    double              endRadius;
+    int                 extendStart;
+    int                 extendEnd;
+    double              transform[6];
+} RasterPaint;
+
+/*! @brief coverage of the clip for every pixel of the bitmap, shared between saved states until it is clipped again
+*/
+typedef struct RasterMask
+{
+    size_t  refCount;
+    uint8_t coverage[];
+} RasterMask;
+
+typedef struct RasterState
+{
+    double          transform[6];   // user space to pixels, y down
+    double          alpha;
+    RasterPaint     fill;
+    RasterPaint     stroke;
+    double          lineWidth;
+    SVGDrawingLineCap   lineCap;
+    SVGDrawingLineJoin  lineJoin;
+    double          miterLimit;
+    double*         dashes;
+    size_t          dashCount;
+    double          dashPhase;
+    RasterMask*     clip;           // NULL if nothing but clipBounds clips
+    int             clipBounds[4];  // left, top, right, bottom in pixels
+} RasterState;
+
+typedef struct RasterLayer
+{
+    uint8_t*    pixels;
+    double      alpha;
+    RasterMask* clip;
+    int         clipBounds[4];
+} RasterLayer;
+
+struct SVGRasterContext
+{
+    size_t          width;
+    size_t          height;
+    size_t          bytesPerRow;
+    uint8_t*        pixels;
+    RasterState*    states;
+    size_t          stateDepth;     // states[stateDepth] is current
+    size_t          stateCapacity;
+    RasterLayer*    layers;
+    size_t          layerCount;
+    size_t          layerCapacity;
+};
+
+/*! @brief line segments in pixel space, the outline a fill or a stroke reduces to
+*/
+typedef struct RasterEdges
+{
+    float*  lines; // x0, y0, x1, y1
+    size_t  count;
+    size_t  capacity;
+    int     failed;
+    double  minX, minY, maxX, maxY;
+} RasterEdges;
+
+static void TransformPoint(const double affine[6], double x, double y, double* resultX, double* resultY)
+{
+    *resultX = affine[0]*x + affine[2]*y + affine[4];
+    *resultY = affine[1]*x + affine[3]*y + affine[5];
+}
+
+static double TransformScale(const double affine[6])
+{// the larger stretch of the transform, so flattening in user space stays within tolerance in pixels
+    double xScale = sqrt(affine[0]*affine[0] + affine[1]*affine[1]);
+    double yScale = sqrt(affine[2]*affine[2] + affine[3]*affine[3]);
+    double result = (xScale > yScale) ? xScale : yScale;
+    return (result > 0.0) ? result : 1.0;
+}
+
+static void EdgesInit(RasterEdges* edges)
+{
+    memset(edges, 0, sizeof(*edges));
+    edges->minX = edges->minY = HUGE_VAL;
+    edges->maxX = edges->maxY = -HUGE_VAL;
+}
+
+static void EdgesFree(RasterEdges* edges)
+{
+    free(edges->lines);
+    EdgesInit(edges);
+}
+
+static void EdgesAdd(RasterEdges* edges, double x0, double y0, double x1, double y1)
+{
+    if(y0 == y1 || edges->failed
+       || !isfinite(x0) || !isfinite(y0) || !isfinite(x1) || !isfinite(y1))
+    {// horizontal lines add no coverage
+        return;
+    }
+    if(edges->count == edges->capacity)
+    {
+        size_t newCapacity = (edges->capacity > 0) ? 2*edges->capacity : 64;
+        float* lines = realloc(edges->lines, newCapacity*4*sizeof(float));
+        if(lines == NULL)
+        {
+            edges->failed = 1;
+            return;
+        }
+        edges->lines = lines;
+        edges->capacity = newCapacity;
+    }
+    float* line = edges->lines+4*edges->count++;
+    line[0] = (float)x0; line[1] = (float)y0; line[2] = (float)x1; line[3] = (float)y1;
+    edges->minX = fmin(edges->minX, fmin(x0, x1));
+    edges->maxX = fmax(edges->maxX, fmax(x0, x1));
+    edges->minY = fmin(edges->minY, fmin(y0, y1));
+    edges->maxY = fmax(edges->maxY, fmax(y0, y1));
+}
+
+static size_t SegmentCount(double secondDifference, double degreeFactor)
+{// Wang's formula
+    double count = ceil(sqrt(degreeFactor*secondDifference/kRasterTolerance));
+    if(!(count >= 1.0))
+    {
+        count = 1.0;
+    }
+    else if(count > 512.0)
+    {
+        count = 512.0;
+    }
+    return (size_t)count;
+}
+
+/*! @brief receives the points of a flattened path, one subpath at a time
+*/
+typedef struct PolylineSink
+{
+    void (*begin)(void* info, double x, double y);
+    void (*lineTo)(void* info, double x, double y);
+    void (*end)(void* info, int closed);
+    void* info;
+} PolylineSink;
+
+/*! @brief reduce a path to straight lines, after transforming it by affine
+* @param tolerance the greatest distance a line may be from its curve, in the transformed space
+*/
+static void FlattenPath(const SVGPathBuffer* path, const double affine[6], double tolerance, const PolylineSink* sink)
+{
+    const float* coordinates = path->coordinates;
+    double currentX = 0.0, currentY = 0.0;
+    double startX = 0.0, startY = 0.0;
+    int open = 0;
+    double scale = kRasterTolerance/tolerance;
+    for(size_t verbIndex = 0; verbIndex < path->verbCount; verbIndex++)
+    {
+        SVGPathVerb verb = (SVGPathVerb)path->verbs[verbIndex];
+        double points[6];
+        size_t pointCount = SVGPathVerbPointCount(verb);
+        for(size_t pointIndex = 0; pointIndex < pointCount; pointIndex++)
+        {
+            TransformPoint(affine, coordinates[2*pointIndex], coordinates[2*pointIndex+1], &points[2*pointIndex], &points[2*pointIndex+1]);
+        }
+        coordinates += 2*pointCount;
+        if(verb != kSVGPathVerbMove && verb != kSVGPathVerbClose && !open)
+        {
+            sink->begin(sink->info, currentX, currentY);
+            startX = currentX; startY = currentY;
+            open = 1;
+        }
+        switch(verb)
+        {
+            case kSVGPathVerbMove:
+                if(open)
+                {
+                    sink->end(sink->info, 0);
+                }
+                currentX = startX = points[0];
+                currentY = startY = points[1];
+                sink->begin(sink->info, currentX, currentY);
+                open = 1;
+            break;
+            case kSVGPathVerbLine:
+                sink->lineTo(sink->info, points[0], points[1]);
+                currentX = points[0]; currentY = points[1];
+            break;
+            case kSVGPathVerbQuad:
+            {
+                double differenceX = currentX-2.0*points[0]+points[2];
+                double differenceY = currentY-2.0*points[1]+points[3];
+                size_t count = SegmentCount(scale*hypot(differenceX, differenceY), 0.25);
+                for(size_t index = 1; index <= count; index++)
+                {
+                    double t = (double)index/count;
+                    double mt = 1.0-t;
+                    sink->lineTo(sink->info, mt*mt*currentX + 2.0*mt*t*points[0] + t*t*points[2],
+                                 mt*mt*currentY + 2.0*mt*t*points[1] + t*t*points[3]);
+                }
+                currentX = points[2]; currentY = points[3];
+            }
+            break;
+            case kSVGPathVerbCubic:
+            {
+                double difference1 = hypot(currentX-2.0*points[0]+points[2], currentY-2.0*points[1]+points[3]);
+                double difference2 = hypot(points[0]-2.0*points[2]+points[4], points[1]-2.0*points[3]+points[5]);
+                size_t count = SegmentCount(scale*fmax(difference1, difference2), 0.75);
+                for(size_t index = 1; index <= count; index++)
+                {
+                    double t = (double)index/count;
+                    double mt = 1.0-t;
+                    double a = mt*mt*mt, b = 3.0*mt*mt*t, c = 3.0*mt*t*t, d = t*t*t;
+                    sink->lineTo(sink->info, a*currentX + b*points[0] + c*points[2] + d*points[4],
+                                 a*currentY + b*points[1] + c*points[3] + d*points[5]);
+                }
+                currentX = points[4]; currentY = points[5];
+            }
+            break;
+            case kSVGPathVerbClose:
+                if(open)
+                {
+                    sink->end(sink->info, 1);
+                    open = 0;
+                }
+                currentX = startX; currentY = startY;
+            break;
+        }
+    }
+    if(open)
+    {
+        sink->end(sink->info, 0);
+    }
+}
+
+typedef struct FillSinkInfo
+{
+    RasterEdges*    edges;
+    double          startX, startY;
+    double          lastX, lastY;
+} FillSinkInfo;
+
+static void FillSinkBegin(void* info, double x, double y)
+{
+    FillSinkInfo* fillInfo = info;
+    fillInfo->startX = fillInfo->lastX = x;
+    fillInfo->startY = fillInfo->lastY = y;
+}
+
+static void FillSinkLineTo(void* info, double x, double y)
+{
+    FillSinkInfo* fillInfo = info;
+    EdgesAdd(fillInfo->edges, fillInfo->lastX, fillInfo->lastY, x, y);
+    fillInfo->lastX = x;
+    fillInfo->lastY = y;
+}
+
+static void FillSinkEnd(void* info, int closed)
+{// every subpath of a fill is closed
+    FillSinkInfo* fillInfo = info;
+    (void)closed;
+    FillSinkLineTo(info, fillInfo->startX, fillInfo->startY);
+}
+
+static void EdgesAddPath(RasterEdges* edges, const SVGPathBuffer* path, const double transform[6])
+{
+    FillSinkInfo info = {edges, 0.0, 0.0, 0.0, 0.0};
+    PolylineSink sink = {FillSinkBegin, FillSinkLineTo, FillSinkEnd, &info};
+    FlattenPath(path, transform, kRasterTolerance, &sink);
+}
+
+/*! @brief a polyline of a stroke's path, in user space
+*/
+typedef struct Polyline
+{
+    double* points;
+    size_t  count;
+    size_t  capacity;
+    int     failed;
+} Polyline;
+
+static void PolylineAdd(Polyline* polyline, double x, double y)
+{
+    if(polyline->count > 0 && polyline->points[2*polyline->count-2] == x && polyline->points[2*polyline->count-1] == y)
+    {// repeated points have no direction
+        return;
+    }
+    if(polyline->count == polyline->capacity)
+    {
+        size_t newCapacity = (polyline->capacity > 0) ? 2*polyline->capacity : 32;
+        double* points = realloc(polyline->points, newCapacity*2*sizeof(double));
+        if(points == NULL)
+        {
+            polyline->failed = 1;
+            return;
+        }
+        polyline->points = points;
+        polyline->capacity = newCapacity;
+    }
+    polyline->points[2*polyline->count] = x;
+    polyline->points[2*polyline->count+1] = y;
+    polyline->count++;
+}
+
+typedef struct StrokeBuilder
+{
+    RasterEdges*        edges;
+    const RasterState*  state;
+    double              halfWidth;
+    size_t              circleSegments;
+    Polyline            polyline;
+    Polyline            dashPiece;
+} StrokeBuilder;
+
+/*! @brief add a closed polygon given in user space. Every polygon is turned the same way so their union fills with the nonzero rule.
+*/
+static void StrokeAddPolygon(StrokeBuilder* builder, const double* points, size_t count)
+{
+    double area = 0.0;
+    for(size_t index = 0; index < count; index++)
+    {
+        size_t next = (index+1) % count;
+        area += points[2*index]*points[2*next+1] - points[2*next]*points[2*index+1];
+    }
+    const double* transform = builder->state->transform;
+    double determinant = transform[0]*transform[3] - transform[1]*transform[2];
+    int reverse = (area*determinant) < 0.0;
+    for(size_t index = 0; index < count; index++)
+    {
+        size_t from = reverse ? count-1-index : index;
+        size_t to = reverse ? (from+count-1) % count : (from+1) % count;
+        double x0, y0, x1, y1;
+        TransformPoint(transform, points[2*from], points[2*from+1], &x0, &y0);
+        TransformPoint(transform, points[2*to], points[2*to+1], &x1, &y1);
+        EdgesAdd(builder->edges, x0, y0, x1, y1);
+    }
+}
+
+static void StrokeAddCircle(StrokeBuilder* builder, double x, double y)
+{
+    double points[2*256];
+    size_t count = builder->circleSegments;
+    for(size_t index = 0; index < count; index++)
+    {
+        double angle = 2.0*M_PI*index/count;
+        points[2*index] = x + builder->halfWidth*cos(angle);
+        points[2*index+1] = y + builder->halfWidth*sin(angle);
+    }
+    StrokeAddPolygon(builder, points, count);
+}
+
+static void StrokeAddJoin(StrokeBuilder* builder, const double* previous, const double* vertex, const double* next)
+{
+    double halfWidth = builder->halfWidth;
+    double in[2] = {vertex[0]-previous[0], vertex[1]-previous[1]};
+    double out[2] = {next[0]-vertex[0], next[1]-vertex[1]};
+    double inLength = hypot(in[0], in[1]);
+    double outLength = hypot(out[0], out[1]);
+    in[0] /= inLength; in[1] /= inLength;
+    out[0] /= outLength; out[1] /= outLength;
+    double cross = in[0]*out[1] - in[1]*out[0];
+    double dot = in[0]*out[0] + in[1]*out[1];
+    if(fabs(cross) < 1e-9 && dot > 0.0)
+    {// straight on, the segments already meet
+        return;
+    }
+    if(builder->state->lineJoin == kSVGDrawingJoinRound)
+    {
+        StrokeAddCircle(builder, vertex[0], vertex[1]);
+        return;
+    }
+    double side = (cross > 0.0) ? -1.0 : 1.0; // the outside of the turn
+    double inOffset[2] = {-in[1]*halfWidth*side, in[0]*halfWidth*side};
+    double outOffset[2] = {-out[1]*halfWidth*side, out[0]*halfWidth*side};
+    double sinHalfAngle = sqrt((1.0+dot)*0.5); // of the angle between the segments
+    if(builder->state->lineJoin == kSVGDrawingJoinMiter && sinHalfAngle > 1e-9
+       && 1.0/sinHalfAngle <= builder->state->miterLimit)
+    {
+        double bisector[2] = {inOffset[0]+outOffset[0], inOffset[1]+outOffset[1]};
+        double bisectorLength = hypot(bisector[0], bisector[1]);
+        double reach = halfWidth/sinHalfAngle;
+        double points[8] = {vertex[0], vertex[1],
+            vertex[0]+inOffset[0], vertex[1]+inOffset[1],
+            vertex[0]+bisector[0]*reach/bisectorLength, vertex[1]+bisector[1]*reach/bisectorLength,
+            vertex[0]+outOffset[0], vertex[1]+outOffset[1]};
+        StrokeAddPolygon(builder, points, 4);
+    }
+    else
+    {
+        double points[6] = {vertex[0], vertex[1],
+            vertex[0]+inOffset[0], vertex[1]+inOffset[1],
+            vertex[0]+outOffset[0], vertex[1]+outOffset[1]};
+        StrokeAddPolygon(builder, points, 3);
+    }
+}
+
+static void StrokeAddCap(StrokeBuilder* builder, const double* end, const double* inside)
+{
+    double halfWidth = builder->halfWidth;
+    switch(builder->state->lineCap)
+    {
+        case kSVGDrawingCapRound:
+            StrokeAddCircle(builder, end[0], end[1]);
+        break;
+        case kSVGDrawingCapSquare:
+        {
+            double direction[2] = {end[0]-inside[0], end[1]-inside[1]};
+            double length = hypot(direction[0], direction[1]);
+            direction[0] *= halfWidth/length; direction[1] *= halfWidth/length;
+            double normal[2] = {-direction[1], direction[0]};
+            double points[8] = {end[0]+normal[0], end[1]+normal[1],
+                end[0]+normal[0]+direction[0], end[1]+normal[1]+direction[1],
+                end[0]-normal[0]+direction[0], end[1]-normal[1]+direction[1],
+                end[0]-normal[0], end[1]-normal[1]};
+            StrokeAddPolygon(builder, points, 4);
+        }
+        break;
+        default:
+        break;
+    }
+}
+
+static void StrokeAddDot(StrokeBuilder* builder, const double* point)
+{// a zero length subpath is drawn only by its caps
+    if(builder->state->lineCap == kSVGDrawingCapRound)
+    {
+        StrokeAddCircle(builder, point[0], point[1]);
+    }
+    else if(builder->state->lineCap == kSVGDrawingCapSquare)
+    {
+        double halfWidth = builder->halfWidth;
+        double points[8] = {point[0]-halfWidth, point[1]-halfWidth, point[0]+halfWidth, point[1]-halfWidth,
+            point[0]+halfWidth, point[1]+halfWidth, point[0]-halfWidth, point[1]+halfWidth};
+        StrokeAddPolygon(builder, points, 4);
+    }
+}
+
+static void StrokePolyline(StrokeBuilder* builder, const double* points, size_t count, int closed)
+{
+    if(count == 1)
+    {
+        StrokeAddDot(builder, points);
+        return;
+    }
+    if(closed && count < 3)
+    {
+        closed = 0;
+    }
+    size_t segmentCount = closed ? count : count-1;
+    double halfWidth = builder->halfWidth;
+    for(size_t index = 0; index < segmentCount; index++)
+    {
+        const double* from = points+2*index;
+        const double* to = points+2*((index+1) % count);
+        double direction[2] = {to[0]-from[0], to[1]-from[1]};
+        double length = hypot(direction[0], direction[1]);
+        double normal[2] = {-direction[1]*halfWidth/length, direction[0]*halfWidth/length};
+        double quad[8] = {from[0]+normal[0], from[1]+normal[1], to[0]+normal[0], to[1]+normal[1],
+            to[0]-normal[0], to[1]-normal[1], from[0]-normal[0], from[1]-normal[1]};
+        StrokeAddPolygon(builder, quad, 4);
+    }
+    size_t firstJoin = closed ? 0 : 1;
+    size_t lastJoin = closed ? count : count-1;
+    for(size_t index = firstJoin; index < lastJoin; index++)
+    {
+        StrokeAddJoin(builder, points+2*((index+count-1) % count), points+2*index, points+2*((index+1) % count));
+    }
+    if(!closed)
+    {
+        StrokeAddCap(builder, points, points+2);
+        StrokeAddCap(builder, points+2*(count-1), points+2*(count-2));
+    }
+}
+
+static void StrokeDashedPolyline(StrokeBuilder* builder, const double* points, size_t count, int closed)
+{
+    const RasterState* state = builder->state;
+    size_t dashCount = state->dashCount;
+    double patternLength = 0.0;
+    for(size_t index = 0; index < dashCount; index++)
+    {
+        patternLength += state->dashes[index];
+    }
+    size_t dashIndex = 0;
+    double remaining = fmod(state->dashPhase, patternLength);
+    if(remaining < 0.0)
+    {
+        remaining += patternLength;
+    }
+    while(remaining >= state->dashes[dashIndex])
+    {// the dash the phase lands in
+        remaining -= state->dashes[dashIndex];
+        dashIndex = (dashIndex+1) % dashCount;
+    }
+    remaining = state->dashes[dashIndex]-remaining;
+    int on = (dashIndex % 2) == 0;
+    Polyline* piece = &builder->dashPiece;
+    piece->count = 0;
+    if(on)
+    {
+        PolylineAdd(piece, points[0], points[1]);
+    }
+    size_t segmentCount = closed ? count : count-1;
+    for(size_t index = 0; index < segmentCount; index++)
+    {
+        const double* from = points+2*index;
+        const double* to = points+2*((index+1) % count);
+        double length = hypot(to[0]-from[0], to[1]-from[1]);
+        double travelled = 0.0;
+        while(length-travelled > remaining)
+        {
+            travelled += remaining;
+            double t = travelled/length;
+            double x = from[0]+t*(to[0]-from[0]);
+            double y = from[1]+t*(to[1]-from[1]);
+            if(on)
+            {
+                PolylineAdd(piece, x, y);
+                StrokePolyline(builder, piece->points, piece->count, 0);
+                piece->count = 0;
+            }
+            else
+            {
+                PolylineAdd(piece, x, y);
+            }
+            on = !on;
+            dashIndex = (dashIndex+1) % dashCount;
+            remaining = state->dashes[dashIndex];
+        }
+        remaining -= length-travelled;
+        if(on)
+        {
+            PolylineAdd(piece, to[0], to[1]);
+        }
+    }
+    if(on && piece->count > 0)
+    {
+        StrokePolyline(builder, piece->points, piece->count, 0);
+    }
+}
+
+static void StrokeSinkBegin(void* info, double x, double y)
+{
+    StrokeBuilder* builder = info;
+    builder->polyline.count = 0;
+    PolylineAdd(&builder->polyline, x, y);
+}
+
+static void StrokeSinkLineTo(void* info, double x, double y)
+{
+    StrokeBuilder* builder = info;
+    PolylineAdd(&builder->polyline, x, y);
+}
+
+static void StrokeSinkEnd(void* info, int closed)
+{
+    StrokeBuilder* builder = info;
+    Polyline* polyline = &builder->polyline;
+    if(closed && polyline->count > 1 && polyline->points[0] == polyline->points[2*polyline->count-2]
+       && polyline->points[1] == polyline->points[2*polyline->count-1])
+    {// the closing point is the first one
+        polyline->count--;
+    }
+    if(polyline->failed || polyline->count == 0)
+    {
+        return;
+    }
+    if(builder->state->dashCount > 0 && polyline->count > 1)
+    {
+        StrokeDashedPolyline(builder, polyline->points, polyline->count, closed);
+    }
+    else
+    {
+        StrokePolyline(builder, polyline->points, polyline->count, closed);
+    }
+}
+
+static void EdgesAddStroke(RasterEdges* edges, const SVGPathBuffer* path, const RasterState* state)
+{
+    double scale = TransformScale(state->transform);
+    StrokeBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.edges = edges;
+    builder.state = state;
+    builder.halfWidth = state->lineWidth*0.5;
+    double deviceRadius = builder.halfWidth*scale;
+    double segments = (deviceRadius > kRasterTolerance) ? ceil(M_PI/acos(1.0-kRasterTolerance/deviceRadius)) : 8.0;
+    builder.circleSegments = (segments < 8.0) ? 8 : (segments > 256.0) ? 256 : (size_t)segments;
+    static const double kIdentity[6] = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    PolylineSink sink = {StrokeSinkBegin, StrokeSinkLineTo, StrokeSinkEnd, &builder};
+    FlattenPath(path, kIdentity, kRasterTolerance/scale, &sink);
+    if(builder.polyline.failed || builder.dashPiece.failed)
+    {
+        edges->failed = 1;
+    }
+    free(builder.polyline.points);
+    free(builder.dashPiece.points);
+}
+
+/*! @brief accumulate the signed area a line covers in each cell, summed across a row this gives the winding, antialiased
+*/
+static void AccumulateLine(float* accumulator, size_t stride, size_t height, double x0, double y0, double x1, double y1)
+{
+    double direction = 1.0;
+    if(y0 > y1)
+    {
+        double swap = x0; x0 = x1; x1 = swap;
+        swap = y0; y0 = y1; y1 = swap;
+        direction = -1.0;
+    }
+    if(y1 <= 0.0 || y0 >= (double)height)
+    {
+        return;
+    }
+    double slope = (x1-x0)/(y1-y0);
+    if(y0 < 0.0)
+    {
+        x0 -= slope*y0;
+        y0 = 0.0;
+    }
+    if(y1 > (double)height)
+    {
+        y1 = (double)height;
+    }
+    double maxX = (double)(stride-2);
+    double x = x0;
+    size_t lastRow = (size_t)ceil(y1);
+    for(size_t row = (size_t)y0; row < lastRow; row++)
+    {
+        float* line = accumulator+row*stride;
+        double dy = fmin((double)row+1.0, y1) - fmax((double)row, y0);
+        double xNext = x + slope*dy;
+        double d = dy*direction;
+        double left = fmin(fmax(fmin(x, xNext), 0.0), maxX);
+        double right = fmin(fmax(fmax(x, xNext), 0.0), maxX);
+        double leftFloor = floor(left);
+        size_t leftIndex = (size_t)leftFloor;
+        double rightCeiling = ceil(right);
+        size_t rightIndex = (size_t)rightCeiling;
+        if(rightIndex <= leftIndex+1)
+        {
+            double middle = 0.5*(left+right) - leftFloor;
+            line[leftIndex] += (float)(d - d*middle);
+            line[leftIndex+1] += (float)(d*middle);
+        }
+        else
+        {
+            double inverseWidth = 1.0/(right-left);
+            double leftFraction = left-leftFloor;
+            double leftArea = 0.5*inverseWidth*(1.0-leftFraction)*(1.0-leftFraction);
+            double rightFraction = right-rightCeiling+1.0;
+            double rightArea = 0.5*inverseWidth*rightFraction*rightFraction;
+            line[leftIndex] += (float)(d*leftArea);
+            if(rightIndex == leftIndex+2)
+            {
+                line[leftIndex+1] += (float)(d*(1.0-leftArea-rightArea));
+            }
+            else
+            {
+                double area = inverseWidth*(1.5-leftFraction);
+                line[leftIndex+1] += (float)(d*(area-leftArea));
+                for(size_t index = leftIndex+2; index < rightIndex-1; index++)
+                {
+                    line[index] += (float)(d*inverseWidth);
+                }
+                area += (double)(rightIndex-leftIndex-3)*inverseWidth;
+                line[rightIndex-1] += (float)(d*(1.0-area-rightArea));
+            }
+            line[rightIndex] += (float)(d*rightArea);
+        }
+        x = xNext;
+    }
+}
+
+/*! @brief add an edge clipped to the accumulator's columns. What lies to the left is moved onto the left side, where it still winds everything to its right, what lies to the right can't affect any pixel.
+*/
+static void AccumulateEdge(float* accumulator, size_t stride, size_t height, double x0, double y0, double x1, double y1)
+{
+    double width = (double)(stride-2);
+    double ts[4] = {0.0, 0.0, 0.0, 1.0};
+    size_t tCount = 1;
+    if(x0 != x1)
+    {
+        double leftT = (0.0-x0)/(x1-x0);
+        double rightT = (width-x0)/(x1-x0);
+        if(leftT > 0.0 && leftT < 1.0) ts[tCount++] = leftT;
+        if(rightT > 0.0 && rightT < 1.0) ts[tCount++] = rightT;
+        if(tCount == 3 && ts[1] > ts[2])
+        {
+            double swap = ts[1]; ts[1] = ts[2]; ts[2] = swap;
+        }
+    }
+    ts[tCount++] = 1.0;
+    for(size_t index = 0; index+1 < tCount; index++)
+    {
+        double startX = x0+(x1-x0)*ts[index], startY = y0+(y1-y0)*ts[index];
+        double endX = x0+(x1-x0)*ts[index+1], endY = y0+(y1-y0)*ts[index+1];
+        double middleX = 0.5*(startX+endX);
+        if(middleX >= width)
+        {
+            continue;
+        }
+        if(middleX <= 0.0)
+        {
+            startX = endX = 0.0;
+        }
+        AccumulateLine(accumulator, stride, height, startX, startY, endX, endY);
+    }
+}
+
+static inline uint8_t ClampComponent(double value)
+{
+    return (value <= 0.0) ? 0 : (value >= 255.0) ? 255 : (uint8_t)(value+0.5);
+}
+
+static RasterColorTable* NewColorTable(const SVGDrawingGradientStop* stops, size_t stopCount)
+{
+    RasterColorTable* result = malloc(sizeof(RasterColorTable));
+    if(result != NULL)
+    {
+        result->refCount = 1;
+        size_t stopIndex = 0;
+        for(size_t index = 0; index < kRasterLUTSize; index++)
+        {
+            double offset = (double)index/(kRasterLUTSize-1);
+            while(stopIndex+1 < stopCount && stops[stopIndex+1].offset < offset)
+            {
+                stopIndex++;
+            }
+            const SVGDrawingGradientStop* before = &stops[stopIndex];
+            const SVGDrawingGradientStop* after = (stopIndex+1 < stopCount) ? &stops[stopIndex+1] : before;
+            double fraction = 0.0;
+            if(offset <= before->offset)
+            {
+                after = before;
+            }
+            else if(after->offset > before->offset)
+            {
+                fraction = (offset-before->offset)/(after->offset-before->offset);
+                fraction = (fraction > 1.0) ? 1.0 : fraction;
+            }
+            double alpha = before->alpha + (after->alpha-before->alpha)*fraction;
+            result->colors[index][0] = ClampComponent(255.0*alpha*(before->red + (after->red-before->red)*fraction));
+            result->colors[index][1] = ClampComponent(255.0*alpha*(before->green + (after->green-before->green)*fraction));
+            result->colors[index][2] = ClampComponent(255.0*alpha*(before->blue + (after->blue-before->blue)*fraction));
+            result->colors[index][3] = ClampComponent(255.0*alpha);
+        }
+    }
+    return result;
+}
+
+static void ReleaseColorTable(RasterColorTable* table)
+{
+    if(table != NULL && --table->refCount == 0)
+    {
+        free(table);
+    }
+}
+
+static void SetPaint(RasterPaint* paint, const SVGDrawingPaint* description)
+{
+    ReleaseColorTable(paint->table);
+    memset(paint, 0, sizeof(*paint));
+    paint->type = description->type;
+    if(description->type == kSVGDrawingPaintSolid)
+    {
+        double alpha = description->color[3];
+        paint->color[0] = ClampComponent(255.0*alpha*description->color[0]);
+        paint->color[1] = ClampComponent(255.0*alpha*description->color[1]);
+        paint->color[2] = ClampComponent(255.0*alpha*description->color[2]);
+        paint->color[3] = ClampComponent(255.0*alpha);
+    }
+    else if(description->type == kSVGDrawingPaintLinearGradient || description->type == kSVGDrawingPaintRadialGradient)
+    {
+        paint->table = (description->stopCount > 0) ? NewColorTable(description->stops, description->stopCount) : NULL;
+        if(paint->table == NULL)
+        {
+            paint->type = kSVGDrawingPaintNone;
+            return;
+        }
+        memcpy(paint->start, description->start, sizeof(paint->start));
+        memcpy(paint->end, description->end, sizeof(paint->end));
+        paint->startRadius = description->startRadius;
+        paint->endRadius = description->endRadius;
+        paint->extendStart = description->extendStart;
+        paint->extendEnd = description->extendEnd;
+        memcpy(paint->transform, description->transform, sizeof(paint->transform));
+    }
+}
+
+/*! @brief a paint ready to be sampled at pixels
+*/
+typedef struct RasterShader
+{
+    const RasterPaint*      paint;
+    const SVGDrawingImage*  image;
+    double                  inverse[6]; // pixels to gradient or image space
+} RasterShader;
+
+static int GradientParameter(const RasterPaint* paint, double x, double y, double* parameter)
+{
+    double t = 0.0;
+    double deltaX = paint->end[0]-paint->start[0];
+    double deltaY = paint->end[1]-paint->start[1];
+    double pointX = x-paint->start[0];
+    double pointY = y-paint->start[1];
+    if(paint->type == kSVGDrawingPaintLinearGradient)
+    {
+        double lengthSquared = deltaX*deltaX + deltaY*deltaY;
+        if(lengthSquared == 0.0)
+        {
+            return 0;
+        }
+        t = (pointX*deltaX + pointY*deltaY)/lengthSquared;
+    }
+    else
+    {// the largest t where the point is on the circle interpolated between the two, with a radius that isn't negative
+        double deltaRadius = paint->endRadius-paint->startRadius;
+        double a = deltaX*deltaX + deltaY*deltaY - deltaRadius*deltaRadius;
+        double b = pointX*deltaX + pointY*deltaY + paint->startRadius*deltaRadius;
+        double c = pointX*pointX + pointY*pointY - paint->startRadius*paint->startRadius;
+        double roots[2];
+        size_t rootCount = 0;
+        if(fabs(a) < 1e-12)
+        {
+            if(b == 0.0)
+            {
+                return 0;
+            }
+            roots[rootCount++] = c/(2.0*b);
+        }
+        else
+        {
+            double discriminant = b*b - a*c;
+            if(discriminant < 0.0)
+            {
+                return 0;
+            }
+            double root = sqrt(discriminant);
+            double first = (b+root)/a, second = (b-root)/a;
+            roots[rootCount++] = fmax(first, second);
+            roots[rootCount++] = fmin(first, second);
+        }
+        size_t index = 0;
+        for(; index < rootCount; index++)
+        {
+            double candidate = roots[index];
+            if(paint->startRadius + candidate*deltaRadius >= 0.0
+               && (candidate >= 0.0 || paint->extendStart) && (candidate <= 1.0 || paint->extendEnd))
+            {
+                t = candidate;
+                break;
+            }
+        }
+        if(index == rootCount)
+        {
+            return 0;
+        }
+    }
+    if((t < 0.0 && !paint->extendStart) || (t > 1.0 && !paint->extendEnd))
+    {
+        return 0;
+    }
+    *parameter = (t < 0.0) ? 0.0 : (t > 1.0) ? 1.0 : t;
+    return 1;
+}
+
+static void SampleImage(const SVGDrawingImage* image, double u, double v, uint8_t* result)
+{// bilinear, clamped to the edges
+    u -= 0.5; v -= 0.5;
+    double maxU = (double)image->width-1.0, maxV = (double)image->height-1.0;
+    u = (u < 0.0) ? 0.0 : (u > maxU) ? maxU : u;
+    v = (v < 0.0) ? 0.0 : (v > maxV) ? maxV : v;
+    size_t left = (size_t)u, top = (size_t)v;
+    size_t right = (left+1 < image->width) ? left+1 : left;
+    size_t bottom = (top+1 < image->height) ? top+1 : top;
+    double fractionU = u-(double)left, fractionV = v-(double)top;
+    const uint8_t* topRow = image->pixels+top*image->bytesPerRow;
+    const uint8_t* bottomRow = image->pixels+bottom*image->bytesPerRow;
+    for(size_t component = 0; component < 4; component++)
+    {
+        double upper = topRow[4*left+component] + (topRow[4*right+component]-topRow[4*left+component])*fractionU;
+        double lower = bottomRow[4*left+component] + (bottomRow[4*right+component]-bottomRow[4*left+component])*fractionU;
+        result[component] = ClampComponent(upper + (lower-upper)*fractionV);
+    }
+}
+
+static void ShadeSpan(const RasterShader* shader, size_t x, size_t y, size_t count, uint8_t* result)
+{
+    const RasterPaint* paint = shader->paint;
+    if(shader->image == NULL && paint->type == kSVGDrawingPaintSolid)
+    {
+        for(size_t index = 0; index < count; index++)
+        {
+            memcpy(result+4*index, paint->color, 4);
+        }
+        return;
+    }
+    const double* inverse = shader->inverse;
+    double centerY = (double)y+0.5;
+    for(size_t index = 0; index < count; index++)
+    {
+        double centerX = (double)(x+index)+0.5;
+        double localX, localY, t;
+        TransformPoint(inverse, centerX, centerY, &localX, &localY);
+        if(shader->image != NULL)
+        {
+            SampleImage(shader->image, localX, localY, result+4*index);
+        }
+        else if(GradientParameter(paint, localX, localY, &t))
+        {
+            memcpy(result+4*index, paint->table->colors[(size_t)(t*(kRasterLUTSize-1)+0.5)], 4);
+        }
+        else
+        {
+            memset(result+4*index, 0, 4);
+        }
+    }
+}
+
+#if SVG_RASTER_VECTORS
+static inline RasterU16x8 Divide255(RasterU16x8 value)
+{// exact rounded division by 255 for products of two bytes
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+#endif
+
+static inline uint32_t Divide255Scalar(uint32_t value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+/*! @brief source over destination, the source scaled by coverage, two pixels at a time where the compiler has vector extensions
+*/
+static void CompositeSpan(uint8_t* destination, const uint8_t* source, const uint8_t* coverage, size_t count)
+{
+    size_t index = 0;
+#if SVG_RASTER_VECTORS
+    for(; index+2 <= count; index += 2)
+    {
+        const uint8_t* cover = coverage+index;
+        if((cover[0] | cover[1]) == 0)
+        {
+            continue;
+        }
+        RasterU8x8 sourceBytes, destinationBytes;
+        memcpy(&sourceBytes, source+4*index, 8);
+        memcpy(&destinationBytes, destination+4*index, 8);
+        RasterU16x8 coverageWide = {cover[0], cover[0], cover[0], cover[0], cover[1], cover[1], cover[1], cover[1]};
+        RasterU16x8 sourceWide = Divide255(__builtin_convertvector(sourceBytes, RasterU16x8)*coverageWide);
+        RasterU16x8 inverseAlpha = {sourceWide[3], sourceWide[3], sourceWide[3], sourceWide[3],
+            sourceWide[7], sourceWide[7], sourceWide[7], sourceWide[7]};
+        inverseAlpha = 255-inverseAlpha;
+        RasterU16x8 result = sourceWide + Divide255(__builtin_convertvector(destinationBytes, RasterU16x8)*inverseAlpha);
+        destinationBytes = __builtin_convertvector(result, RasterU8x8);
+        memcpy(destination+4*index, &destinationBytes, 8);
+    }
+#endif
+    for(; index < count; index++)
+    {
+        uint32_t cover = coverage[index];
+        if(cover == 0)
+        {
+            continue;
+        }
+        const uint8_t* sourcePixel = source+4*index;
+        uint8_t* destinationPixel = destination+4*index;
+        uint32_t alpha = Divide255Scalar(sourcePixel[3]*cover);
+        for(size_t component = 0; component < 4; component++)
+        {
+            destinationPixel[component] = (uint8_t)(Divide255Scalar(sourcePixel[component]*cover)
+                                                    + Divide255Scalar(destinationPixel[component]*(255-alpha)));
+        }
+    }
+}
+
+SVGRasterContext* SVGRasterContextCreate(size_t width, size_t height)
+{
+    if(width == 0 || height == 0 || width > 32768 || height > 32768)
+    {
+        return NULL;
+    }
+    SVGRasterContext* result = calloc(1, sizeof(SVGRasterContext));
+    if(result != NULL)
+    {
+        result->width = width;
+        result->height = height;
+        result->bytesPerRow = 4*width;
+        result->pixels = calloc(height, result->bytesPerRow);
+        result->stateCapacity = 8;
+        result->states = calloc(result->stateCapacity, sizeof(RasterState));
+        if(result->pixels == NULL || result->states == NULL)
+        {
+            free(result->pixels);
+            free(result->states);
+            free(result);
+            return NULL;
+        }
+        RasterState* state = result->states;
+        double flip[6] = {1.0, 0.0, 0.0, -1.0, 0.0, (double)height}; // user space is y up, like Core Graphics
+        memcpy(state->transform, flip, sizeof(flip));
+        state->alpha = 1.0;
+        state->fill.type = kSVGDrawingPaintSolid;
+        state->fill.color[3] = 255;
+        state->stroke = state->fill;
+        state->lineWidth = 1.0;
+        state->miterLimit = 10.0;
+        state->clipBounds[2] = (int)width;
+        state->clipBounds[3] = (int)height;
+    }
+    return result;
+}
+
+static void ReleaseMask(RasterMask* mask)
+{
+    if(mask != NULL && --mask->refCount == 0)
+    {
+        free(mask);
+    }
+}
+
+static void ClearState(RasterState* state)
+{
+    ReleaseColorTable(state->fill.table);
+    ReleaseColorTable(state->stroke.table);
+    ReleaseMask(state->clip);
+    free(state->dashes);
+}
+
+void SVGRasterContextFree(SVGRasterContext* context)
+{
+    if(context != NULL)
+    {
+        for(size_t index = 0; index <= context->stateDepth; index++)
+        {
+            ClearState(&context->states[index]);
+        }
+        for(size_t index = 0; index < context->layerCount; index++)
+        {
+            free(context->layers[index].pixels);
+            ReleaseMask(context->layers[index].clip);
+        }
+        free(context->layers);
+        free(context->states);
+        free(context->pixels);
+        free(context);
+    }
+}
+
+const uint8_t* SVGRasterContextGetPixels(const SVGRasterContext* context)
+{
+    return context->pixels;
+}
+
+size_t SVGRasterContextGetBytesPerRow(const SVGRasterContext* context)
+{
+    return context->bytesPerRow;
+}
+
+size_t SVGRasterContextGetWidth(const SVGRasterContext* context)
+{
+    return context->width;
+}
+
+size_t SVGRasterContextGetHeight(const SVGRasterContext* context)
+{
+    return context->height;
+}
+
+static inline RasterState* CurrentState(SVGRasterContext* context)
+{
+    return &context->states[context->stateDepth];
+}
+
+static inline uint8_t* CurrentPixels(SVGRasterContext* context)
+{
+    return (context->layerCount > 0) ? context->layers[context->layerCount-1].pixels : context->pixels;
+}
+
+/*! @brief find the pixels the edges could touch, within the clip
+* @return 0 if there are none
+*/
+static int EdgeBounds(const RasterState* state, const RasterEdges* edges, int* bounds)
+{
+    if(edges->count == 0 || edges->failed)
+    {
+        return 0;
+    }
+    bounds[0] = (edges->minX < (double)state->clipBounds[0]) ? state->clipBounds[0] : (int)floor(edges->minX);
+    bounds[1] = (edges->minY < (double)state->clipBounds[1]) ? state->clipBounds[1] : (int)floor(edges->minY);
+    bounds[2] = (edges->maxX > (double)state->clipBounds[2]) ? state->clipBounds[2] : (int)ceil(edges->maxX);
+    bounds[3] = (edges->maxY > (double)state->clipBounds[3]) ? state->clipBounds[3] : (int)ceil(edges->maxY);
+    return bounds[0] < bounds[2] && bounds[1] < bounds[3];
+}
+
+/*! @brief compute the coverage of edges, row by row, within bounds
+* @param rowHandler called with each row's coverage, already reduced by the fill rule
+*/
+static int RasterizeEdges(const RasterEdges* edges, const int* bounds, int evenOdd,
+                          void (*rowHandler)(void* info, size_t x, size_t y, size_t count, float* coverage), void* info)
+{
+    size_t width = (size_t)(bounds[2]-bounds[0]);
+    size_t height = (size_t)(bounds[3]-bounds[1]);
+    size_t stride = width+2;
+    float* accumulator = calloc(stride*height, sizeof(float));
+    if(accumulator == NULL)
+    {
+        return 0;
+    }
+    for(size_t index = 0; index < edges->count; index++)
+    {
+        const float* line = edges->lines+4*index;
+        AccumulateEdge(accumulator, stride, height, line[0]-bounds[0], line[1]-bounds[1], line[2]-bounds[0], line[3]-bounds[1]);
+    }
+    for(size_t row = 0; row < height; row++)
+    {
+        float* coverage = accumulator+row*stride;
+        float sum = 0.0f;
+        for(size_t column = 0; column < width; column++)
+        {
+            sum += coverage[column];
+            float value = fabsf(sum);
+            if(evenOdd)
+            {
+                value = fmodf(value, 2.0f);
+                value = (value > 1.0f) ? 2.0f-value : value;
+            }
+            coverage[column] = (value > 1.0f) ? 1.0f : value;
+        }
+        rowHandler(info, (size_t)bounds[0], (size_t)bounds[1]+row, width, coverage);
+    }
+    free(accumulator);
+    return 1;
+}
+
+typedef struct PaintRowInfo
+{
+    SVGRasterContext*   context;
+    const RasterState*  state;
+    const RasterShader* shader;
+    uint8_t*            coverage;
+    uint8_t*            colors;
+} PaintRowInfo;
+
+static void PaintRow(void* info, size_t x, size_t y, size_t count, float* coverage)
+{
+    PaintRowInfo* rowInfo = info;
+    const RasterState* state = rowInfo->state;
+    const uint8_t* clip = (state->clip != NULL) ? state->clip->coverage+y*rowInfo->context->width+x : NULL;
+    float scale = (float)(255.0*state->alpha);
+    size_t first = count, last = 0;
+    for(size_t index = 0; index < count; index++)
+    {
+        uint32_t value = (uint32_t)(coverage[index]*scale+0.5f);
+        if(clip != NULL)
+        {
+            value = Divide255Scalar(value*clip[index]);
+        }
+        rowInfo->coverage[index] = (uint8_t)value;
+        if(value != 0)
+        {
+            first = (index < first) ? index : first;
+            last = index;
+        }
+    }
+    if(first <= last)
+    {
+        size_t spanCount = last-first+1;
+        ShadeSpan(rowInfo->shader, x+first, y, spanCount, rowInfo->colors);
+        uint8_t* destination = CurrentPixels(rowInfo->context)+y*rowInfo->context->bytesPerRow+4*(x+first);
+        CompositeSpan(destination, rowInfo->colors, rowInfo->coverage+first, spanCount);
+    }
+}
+
+static void FillEdges(SVGRasterContext* context, const RasterEdges* edges, int evenOdd, const RasterShader* shader)
+{
+    const RasterState* state = CurrentState(context);
+    int bounds[4];
+    if(!EdgeBounds(state, edges, bounds) || state->alpha <= 0.0)
+    {
+        return;
+    }
+    size_t width = (size_t)(bounds[2]-bounds[0]);
+    PaintRowInfo info = {context, state, shader, malloc(width), malloc(4*width)};
+    if(info.coverage != NULL && info.colors != NULL)
+    {
+        RasterizeEdges(edges, bounds, evenOdd, PaintRow, &info);
+    }
+    free(info.coverage);
+    free(info.colors);
+}
+
+static int PrepareShader(const RasterState* state, const RasterPaint* paint, RasterShader* shader)
+{
+    shader->paint = paint;
+    shader->image = NULL;
+    if(paint->type == kSVGDrawingPaintNone)
+    {
+        return 0;
+    }
+    if(paint->type != kSVGDrawingPaintSolid)
+    {
+        double gradientToPixels[6];
+        SVGDrawingConcatAffine(paint->transform, state->transform, gradientToPixels);
+        return SVGDrawingInvertAffine(gradientToPixels, shader->inverse);
+    }
+    return 1;
+}
+
+typedef struct ClipRowInfo
+{
+    const RasterMask*   previous;
+    RasterMask*         mask;
+    size_t              width;
+} ClipRowInfo;
+
+static void ClipRow(void* info, size_t x, size_t y, size_t count, float* coverage)
+{
+    ClipRowInfo* rowInfo = info;
+    uint8_t* destination = rowInfo->mask->coverage+y*rowInfo->width+x;
+    const uint8_t* previous = (rowInfo->previous != NULL) ? rowInfo->previous->coverage+y*rowInfo->width+x : NULL;
+    for(size_t index = 0; index < count; index++)
+    {
+        uint32_t value = (uint32_t)(coverage[index]*255.0f+0.5f);
+        destination[index] = (uint8_t)((previous != NULL) ? Divide255Scalar(value*previous[index]) : value);
+    }
+}
+
+static RasterMask* NewMask(const SVGRasterContext* context)
+{
+    RasterMask* result = calloc(1, sizeof(RasterMask)+context->width*context->height);
+    if(result != NULL)
+    {
+        result->refCount = 1;
+    }
+    return result;
+}
+
+static void ClipToEdges(SVGRasterContext* context, const RasterEdges* edges, int evenOdd)
+{
+    RasterState* state = CurrentState(context);
+    int bounds[4];
+    if(!EdgeBounds(state, edges, bounds))
+    {// nothing is left
+        state->clipBounds[2] = state->clipBounds[0];
+        return;
+    }
+    RasterMask* mask = NewMask(context);
+    if(mask == NULL)
+    {
+        return;
+    }
+    ClipRowInfo info = {state->clip, mask, context->width};
+    if(RasterizeEdges(edges, bounds, evenOdd, ClipRow, &info))
+    {
+        ReleaseMask(state->clip);
+        state->clip = mask;
+        memcpy(state->clipBounds, bounds, sizeof(bounds));
+    }
+    else
+    {
+        ReleaseMask(mask);
+    }
+}
+
+static void RasterSaveState(void* context)
+{
+    SVGRasterContext* raster = context;
+    if(raster->stateDepth+1 == raster->stateCapacity)
+    {
+        RasterState* states = realloc(raster->states, 2*raster->stateCapacity*sizeof(RasterState));
+        if(states == NULL)
+        {
+            return;
+        }
+        raster->states = states;
+        raster->stateCapacity *= 2;
+    }
+    RasterState* previous = &raster->states[raster->stateDepth];
+    RasterState* state = previous+1;
+    *state = *previous;
+    if(state->dashCount > 0)
+    {
+        state->dashes = malloc(state->dashCount*sizeof(double));
+        if(state->dashes == NULL)
+        {
+            state->dashCount = 0;
+        }
+        else
+        {
+            memcpy(state->dashes, previous->dashes, state->dashCount*sizeof(double));
+        }
+    }
+    if(state->fill.table != NULL) state->fill.table->refCount++;
+    if(state->stroke.table != NULL) state->stroke.table->refCount++;
+    if(state->clip != NULL) state->clip->refCount++;
+    raster->stateDepth++;
+}
+
+static void RasterRestoreState(void* context)
+{
+    SVGRasterContext* raster = context;
+    if(raster->stateDepth > 0)
+    {
+        ClearState(CurrentState(raster));
+        raster->stateDepth--;
+    }
+}
+
+static void RasterConcatTransform(void* context, const double affine[6])
+{
+    RasterState* state = CurrentState(context);
+    SVGDrawingConcatAffine(affine, state->transform, state->transform);
+}
+
+static void RasterGetTransform(void* context, double affine[6])
+{// undo the flip to pixel rows
+    SVGRasterContext* raster = context;
+    double flip[6] = {1.0, 0.0, 0.0, -1.0, 0.0, (double)raster->height};
+    SVGDrawingConcatAffine(CurrentState(raster)->transform, flip, affine);
+}
+
+static void RasterGetClipBounds(void* context, double bounds[4])
+{
+    SVGRasterContext* raster = context;
+    const int* clipBounds = CurrentState(raster)->clipBounds;
+    bounds[0] = clipBounds[0];
+    bounds[1] = (double)raster->height-clipBounds[3];
+    bounds[2] = (clipBounds[2] > clipBounds[0]) ? clipBounds[2]-clipBounds[0] : 0;
+    bounds[3] = (clipBounds[3] > clipBounds[1]) ? clipBounds[3]-clipBounds[1] : 0;
+}
+
+static void RasterSetAlpha(void* context, double alpha)
+{
+    CurrentState(context)->alpha = (alpha < 0.0) ? 0.0 : (alpha > 1.0) ? 1.0 : alpha;
+}
+
+static void RasterSetFillPaint(void* context, const SVGDrawingPaint* paint)
+{
+    SetPaint(&CurrentState(context)->fill, paint);
+}
+
+static void RasterSetStrokePaint(void* context, const SVGDrawingPaint* paint)
+{
+    SetPaint(&CurrentState(context)->stroke, paint);
+}
+
+static void RasterSetLineWidth(void* context, double width)
+{
+    CurrentState(context)->lineWidth = width;
+}
+
+static void RasterSetLineCap(void* context, SVGDrawingLineCap cap)
+{
+    CurrentState(context)->lineCap = cap;
+}
+
+static void RasterSetLineJoin(void* context, SVGDrawingLineJoin join)
+{
+    CurrentState(context)->lineJoin = join;
+}
+
+static void RasterSetMiterLimit(void* context, double limit)
+{
+    CurrentState(context)->miterLimit = limit;
+}
+
+static void RasterSetLineDash(void* context, double phase, const double* lengths, size_t count)
+{
+    RasterState* state = CurrentState(context);
+    free(state->dashes);
+    state->dashes = NULL;
+    state->dashCount = 0;
+    double total = 0.0;
+    for(size_t index = 0; index < count; index++)
+    {
+        if(!(lengths[index] >= 0.0))
+        {// not a valid pattern, draw solid
+            return;
+        }
+        total += lengths[index];
+    }
+    if(count == 0 || !(total > 0.0))
+    {
+        return;
+    }
+    size_t dashCount = (count % 2 == 1) ? 2*count : count; // an odd list is repeated
+    state->dashes = malloc(dashCount*sizeof(double));
+    if(state->dashes != NULL)
+    {
+        for(size_t index = 0; index < dashCount; index++)
+        {
+            state->dashes[index] = lengths[index % count];
+        }
+        state->dashCount = dashCount;
+        state->dashPhase = phase;
+    }
+}
+
+static void RasterDrawPath(void* context, const SVGPathBuffer* path, SVGDrawingMode mode)
+{
+    SVGRasterContext* raster = context;
+    RasterState* state = CurrentState(raster);
+    RasterShader shader;
+    if(mode != kSVGDrawingStroke && PrepareShader(state, &state->fill, &shader))
+    {
+        RasterEdges edges;
+        EdgesInit(&edges);
+        EdgesAddPath(&edges, path, state->transform);
+        FillEdges(raster, &edges, mode == kSVGDrawingEOFill || mode == kSVGDrawingEOFillStroke, &shader);
+        EdgesFree(&edges);
+    }
+    if(mode >= kSVGDrawingStroke && state->lineWidth > 0.0 && PrepareShader(state, &state->stroke, &shader))
+    {
+        RasterEdges edges;
+        EdgesInit(&edges);
+        EdgesAddStroke(&edges, path, state);
+        FillEdges(raster, &edges, 0, &shader);
+        EdgesFree(&edges);
+    }
+}
+
+static void EdgesAddRect(RasterEdges* edges, const double transform[6], double x, double y, double width, double height)
+{
+    double corners[8];
+    TransformPoint(transform, x, y, &corners[0], &corners[1]);
+    TransformPoint(transform, x+width, y, &corners[2], &corners[3]);
+    TransformPoint(transform, x+width, y+height, &corners[4], &corners[5]);
+    TransformPoint(transform, x, y+height, &corners[6], &corners[7]);
+    for(size_t index = 0; index < 4; index++)
+    {
+        size_t next = (index+1) % 4;
+        EdgesAdd(edges, corners[2*index], corners[2*index+1], corners[2*next], corners[2*next+1]);
+    }
+}
+
+/*! @brief the transform from an image's pixels, first row at the top, to the bitmap's pixels
+*/
+static int ImageToPixels(const RasterState* state, const SVGDrawingImage* image, double x, double y, double width, double height, double* result)
+{
+    if(image->width == 0 || image->height == 0)
+    {
+        return 0;
+    }
+    double imageToUser[6] = {width/image->width, 0.0, 0.0, -height/image->height, x, y+height};
+    SVGDrawingConcatAffine(imageToUser, state->transform, result);
+    return 1;
+}
+
+static void RasterDrawImage(void* context, const SVGDrawingImage* image, double x, double y, double width, double height)
+{
+    SVGRasterContext* raster = context;
+    RasterState* state = CurrentState(raster);
+    double imageToPixels[6];
+    RasterShader shader = {&state->fill, image, {0}};
+    if(ImageToPixels(state, image, x, y, width, height, imageToPixels)
+       && SVGDrawingInvertAffine(imageToPixels, shader.inverse))
+    {
+        RasterEdges edges;
+        EdgesInit(&edges);
+        EdgesAddRect(&edges, state->transform, x, y, width, height);
+        FillEdges(raster, &edges, 0, &shader);
+        EdgesFree(&edges);
+    }
+}
+
+static void RasterClipToPath(void* context, const SVGPathBuffer* path, SVGDrawingFillRule rule)
+{
+    SVGRasterContext* raster = context;
+    RasterEdges edges;
+    EdgesInit(&edges);
+    EdgesAddPath(&edges, path, CurrentState(raster)->transform);
+    ClipToEdges(raster, &edges, rule == kSVGDrawingEvenOdd);
+    EdgesFree(&edges);
+}
+
+static void RasterClipToRect(void* context, double x, double y, double width, double height)
+{
+    SVGRasterContext* raster = context;
+    RasterEdges edges;
+    EdgesInit(&edges);
+    EdgesAddRect(&edges, CurrentState(raster)->transform, x, y, width, height);
+    ClipToEdges(raster, &edges, 0);
+    EdgesFree(&edges);
+}
+
+typedef struct MaskRowInfo
+{
+    const RasterMask*       previous;
+    RasterMask*             mask;
+    size_t                  width;
+    const SVGDrawingImage*  image;
+    const double*           inverse;
+} MaskRowInfo;
+
+static void MaskRow(void* info, size_t x, size_t y, size_t count, float* coverage)
+{
+    MaskRowInfo* rowInfo = info;
+    uint8_t* destination = rowInfo->mask->coverage+y*rowInfo->width+x;
+    const uint8_t* previous = (rowInfo->previous != NULL) ? rowInfo->previous->coverage+y*rowInfo->width+x : NULL;
+    for(size_t index = 0; index < count; index++)
+    {
+        uint32_t value = (uint32_t)(coverage[index]*255.0f+0.5f);
+        if(value != 0)
+        {
+            double u, v;
+            uint8_t sample[4];
+            TransformPoint(rowInfo->inverse, (double)(x+index)+0.5, (double)y+0.5, &u, &v);
+            SampleImage(rowInfo->image, u, v, sample);
+            value = Divide255Scalar(value*sample[3]);
+        }
+        destination[index] = (uint8_t)((previous != NULL) ? Divide255Scalar(value*previous[index]) : value);
+    }
+}
+
+static void RasterClipToMask(void* context, const SVGDrawingImage* image, double x, double y, double width, double height)
+{
+    SVGRasterContext* raster = context;
+    RasterState* state = CurrentState(raster);
+    double imageToPixels[6], inverse[6];
+    RasterEdges edges;
+    EdgesInit(&edges);
+    int bounds[4];
+    if(!ImageToPixels(state, image, x, y, width, height, imageToPixels) || !SVGDrawingInvertAffine(imageToPixels, inverse))
+    {
+        state->clipBounds[2] = state->clipBounds[0];
+        return;
+    }
+    EdgesAddRect(&edges, state->transform, x, y, width, height);
+    if(!EdgeBounds(state, &edges, bounds))
+    {
+        state->clipBounds[2] = state->clipBounds[0];
+    }
+    else
+    {
+        RasterMask* mask = NewMask(raster);
+        MaskRowInfo info = {state->clip, mask, raster->width, image, inverse};
+        if(mask != NULL && RasterizeEdges(&edges, bounds, 0, MaskRow, &info))
+        {
+            ReleaseMask(state->clip);
+            state->clip = mask;
+            memcpy(state->clipBounds, bounds, sizeof(bounds));
+        }
+        else
+        {
+            ReleaseMask(mask);
+        }
+    }
+    EdgesFree(&edges);
+}
+
+static void RasterBeginLayer(void* context)
+{
+    SVGRasterContext* raster = context;
+    if(raster->layerCount == raster->layerCapacity)
+    {
+        size_t newCapacity = (raster->layerCapacity > 0) ? 2*raster->layerCapacity : 4;
+        RasterLayer* layers = realloc(raster->layers, newCapacity*sizeof(RasterLayer));
+        if(layers == NULL)
+        {
+            return;
+        }
+        raster->layers = layers;
+        raster->layerCapacity = newCapacity;
+    }
+    uint8_t* pixels = calloc(raster->height, raster->bytesPerRow);
+    if(pixels == NULL)
+    {
+        return;
+    }
+    RasterState* state = CurrentState(raster);
+    RasterLayer* layer = &raster->layers[raster->layerCount++];
+    layer->pixels = pixels;
+    layer->alpha = state->alpha;
+    layer->clip = state->clip;
+    memcpy(layer->clipBounds, state->clipBounds, sizeof(layer->clipBounds));
+    if(layer->clip != NULL)
+    {
+        layer->clip->refCount++;
+    }
+    RasterSaveState(raster);
+    state = CurrentState(raster);
+    state->alpha = 1.0; // the layer as a whole gets the alpha and the clip when it is composited
+    ReleaseMask(state->clip);
+    state->clip = NULL;
+}
+
+static void RasterEndLayer(void* context)
+{
+    SVGRasterContext* raster = context;
+    if(raster->layerCount == 0)
+    {
+        return;
+    }
+    RasterRestoreState(raster);
+    RasterLayer* layer = &raster->layers[--raster->layerCount];
+    const int* bounds = layer->clipBounds;
+    uint8_t alpha = ClampComponent(255.0*layer->alpha);
+    uint8_t* destination = CurrentPixels(raster);
+    size_t width = (bounds[2] > bounds[0]) ? (size_t)(bounds[2]-bounds[0]) : 0;
+    uint8_t* coverage = malloc(width > 0 ? width : 1);
+    for(int row = bounds[1]; coverage != NULL && width > 0 && row < bounds[3]; row++)
+    {
+        size_t offset = (size_t)row*raster->width+(size_t)bounds[0];
+        for(size_t index = 0; index < width; index++)
+        {
+            coverage[index] = (layer->clip != NULL) ? (uint8_t)Divide255Scalar(alpha*layer->clip->coverage[offset+index]) : alpha;
+        }
+        CompositeSpan(destination+4*offset, layer->pixels+4*offset, coverage, width);
+    }
+    free(coverage);
+    free(layer->pixels);
+    ReleaseMask(layer->clip);
+}
+
+const SVGDrawingBackend* SVGRasterDrawingBackend(void)
+{
+    static const SVGDrawingBackend sBackend = {
+        RasterSaveState, RasterRestoreState, RasterConcatTransform, RasterGetTransform, RasterGetClipBounds,
+        RasterSetAlpha, RasterSetFillPaint, RasterSetStrokePaint,
+        RasterSetLineWidth, RasterSetLineCap, RasterSetLineJoin, RasterSetMiterLimit, RasterSetLineDash,
+        RasterDrawPath, RasterDrawImage, RasterClipToPath, RasterClipToRect, RasterClipToMask,
+        RasterBeginLayer, RasterEndLayer
+    };
+    return &sBackend;
+}
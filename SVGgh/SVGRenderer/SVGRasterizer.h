@@ -0,0 +1,68 @@
+//
+//  SVGRasterizer.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#ifndef SVGRasterizer_h
+#define SVGRasterizer_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SVGDrawingBackend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief a software drawing target, a bitmap of premultiplied RGBA with 8 bits a component which SVGRasterDrawingBackend draws into. It needs nothing but the C library, so documents can be rendered where there is no Core Graphics.
+*/
+typedef struct SVGRasterContext SVGRasterContext;
+
+/*! @brief make a transparent bitmap to draw into. Its user space starts out as its device space: origin at the bottom left, one unit a pixel.
+* @param width in pixels
+* @param height in pixels
+* @return NULL if the bitmap could not be allocated
+*/
+SVGRasterContext* SVGRasterContextCreate(size_t width, size_t height);
+void SVGRasterContextFree(SVGRasterContext* context);
+
+/*! @brief the finished pixels, premultiplied RGBA, the first row is the top of the image
+*/
+const uint8_t* SVGRasterContextGetPixels(const SVGRasterContext* context);
+size_t SVGRasterContextGetBytesPerRow(const SVGRasterContext* context);
+size_t SVGRasterContextGetWidth(const SVGRasterContext* context);
+size_t SVGRasterContextGetHeight(const SVGRasterContext* context);
+
+/*! @brief the scanline implementation, its context is an SVGRasterContext. Paths are filled with analytic antialiasing, curves are flattened to within a quarter pixel. Blend modes other than normal are not supported.
+*/
+const SVGDrawingBackend* SVGRasterDrawingBackend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVGRasterizer_h */
@@ -0,0 +1,61 @@
+//
+//  SVGRenderer+DisplayList.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+
+#import "SVGRenderer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class GHDisplayList;
+
+/*! @brief what GHRasterCache needs to record a document on one thread and rasterize it on another, kept out of the public headers as GHDisplayList is internal
+*/
+@interface SVGRenderer (DisplayList)
+
+/*! @brief record the document as it is styled now, matching the style sheet on the calling thread
+ * @param currentColor the value of 'currentColor' to record with
+ * @return a display list for newImageWithSize:scale:currentColor:displayList:
+ */
+-(GHDisplayList*) newDisplayListWithCurrentColor:(nullable UIColor*)currentColor;
+
+/*! @brief as newImageWithSize:scale:currentColor: but replaying an already recorded display list, so later changes to the document's style don't reach it
+ * @param displayList made by newDisplayListWithCurrentColor: with the same currentColor
+ */
+-(nullable CGImageRef) newImageWithSize:(CGSize)maximumSize scale:(CGFloat)scale currentColor:(nullable UIColor*)currentColor displayList:(GHDisplayList*)displayList CF_RETURNS_RETAINED;
+
+/*! @brief make a bitmap of exactly a given size with the document fitted and centered in it, as GHButton draws its artwork, so a button's cached artwork lands where its vectors would
+ * @param size the size in points, the bitmap is this times scale rounded up
+ * @param scale pixels per point
+ * @param currentColor the value of 'currentColor' to render with
+ * @return a bitmap whose first row is the top, to be released by the caller, NULL if the size was empty
+ */
+-(nullable CGImageRef) newImageCenteredInSize:(CGSize)size scale:(CGFloat)scale currentColor:(nullable UIColor*)currentColor CF_RETURNS_RETAINED;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -42,6 +42,28 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+struct SVGDrawingBackend;
+
+/*! @brief how long one tile of asTiledImageWithSize:andScale:tileSize:tileTimings: took to draw
+*/
+@interface SVGRenderTileTiming : NSObject
+
+/*! @property pixelRect
+* @brief the tile's rect in the image's pixels, with the origin at the top left
+*/
+@property(nonatomic, readonly) CGRect           pixelRect;
+
+/*! @property duration
+* @brief the time spent drawing the tile
+*/
+@property(nonatomic, readonly) NSTimeInterval   duration;
+
+/*! @property culledOperationCount
+* @brief how many draw operations were skipped as lying wholly outside the tile
+*/
+@property(nonatomic, readonly) NSUInteger       culledOperationCount;
+@end
+
 /*! @brief a class capable of rendering itself into a core graphics context
 */
 @interface SVGRenderer : SVGParser<SVGContext, GHRenderable>
@@ -62,10 +84,15 @@ NS_ASSUME_NONNULL_BEGIN
 +(NSOperationQueue*) rendererQueue;
 
 /*! @brief init method which takes a URL reference to a .svg file
- * @param url a reference to a standard .svg or .svgz file
+ * @param url a reference to a standard .svg or .svgz file, or a precompiled .svgb file
  */
 -(instancetype)initWithContentsOfURL:(NSURL *)url;
 
+/*! @brief init method which takes a precompiled .svgb document
+ * @param binaryData the precompiled document as written by SVGBinaryDocument
+ */
+-(instancetype)initWithBinaryData:(NSData*)binaryData;
+
 /*! @brief init method which takes a input stream from a SVG source
  * @param inputStream a reference to a standard .svg or .svgz file
  */
@@ -94,17 +121,39 @@ NS_ASSUME_NONNULL_BEGIN
  */
 -(instancetype) init __attribute__((unavailable("init not available")));
 
+/*! @brief build the Core Graphics path of every shape in the document ahead of time, spread across all the cores, rather than one at a time as each is first drawn
+* @note call before the renderer is first drawn or hit tested, it is not safe to run alongside either
+*/
+-(void) preparePathsConcurrently;
+
 /*! @brief draw the SVG
 * @param quartzContext context into which to draw, could be a CALayer, a PDF, an offscreen bitmap, whatever
 */
 -(void)renderIntoContext:(CGContextRef)quartzContext;
 
+/*! @brief draw the SVG through a drawing backend instead of a CGContext, such as the software rasterizer in SVGRasterizer.h
+* @param backend the table of drawing functions
+* @param context the backend's own context, already set up with whatever transform the document should be drawn with
+*/
+-(void)renderWithDrawingBackend:(const struct SVGDrawingBackend*)backend context:(void*)context;
+
 /*! @brief try to locate an object that's been tapped
 * @param testPoint a point in the coordinate system of this renderer
 * @return an object which implements the GHRenderable protocol
 */
 -(nullable id<GHRenderable>) findRenderableObject:(CGPoint)testPoint;
 
+/*! @brief where an object of this document draws, as when only it needs redrawing after its style has changed
+* @param anObject a shape, image or group in this document, such as one returned by findRenderableObject:
+* @return the bounds in the coordinate system of this renderer with strokes included, CGRectNull if the object isn't part of the document or draws nothing, CGRectInfinite if it can't be worked out (text, for instance)
+*/
+-(CGRect) drawnBoundsOfObject:(id<GHRenderable>)anObject;
+
+/*! @brief forget what was compiled from the object tree, so the next render or hit test walks it again
+* @note setting an object's transform or fillColor does this for you, call it after changing anything else about the document's objects
+*/
+-(void) invalidateDisplayList;
+
 /*! @brief make a scaled image from the renderer
  * @param maximumSize the maximum dimension in points to render into.
  * @param scale same as a UIWindow's scale
@@ -115,6 +164,30 @@ NS_ASSUME_NONNULL_BEGIN
 #else
 -(UIImage*)asImageWithSize:(CGSize)maximumSize andScale:(CGFloat)scale;
 #endif
+
+/*! @brief make the same image as asImageWithSize:andScale: by splitting it into tiles and drawing them concurrently, each tile only drawing what falls inside it
+ * @param maximumSize the maximum dimension in points to render into.
+ * @param scale same as a UIWindow's scale
+ * @param tileSize the width and height of a tile in pixels, 0 for a default of 512
+ * @param tileTimings if not NULL, set to an SVGRenderTileTiming for each tile, in row order from the top left
+ * @return a UIImage or NSImage depending on platform, nil if the bitmap couldn't be made
+ * @note worth it for large images of complex documents, the compiled document is shared by all the tiles but each has its own context and currentColor
+ */
+#if TARGET_OS_OSX
+-(nullable NSImage*) asTiledImageWithSize:(CGSize)maximumSize andScale:(CGFloat)scale tileSize:(NSUInteger)tileSize tileTimings:(NSArray<SVGRenderTileTiming*>* __nullable * __nullable)tileTimings;
+#else
+-(nullable UIImage*) asTiledImageWithSize:(CGSize)maximumSize andScale:(CGFloat)scale tileSize:(NSUInteger)tileSize tileTimings:(NSArray<SVGRenderTileTiming*>* __nullable * __nullable)tileTimings;
+#endif
+
+/*! @brief make a bitmap of the document for a given currentColor, leaving the renderer's own currentColor alone, so it can be done away from the main thread
+ * @param maximumSize the maximum dimension in points to render into.
+ * @param scale pixels per point
+ * @param currentColor the value of 'currentColor' to render with
+ * @return a bitmap whose first row is the top of the document, to be released by the caller, NULL if the size was empty
+ * @note this matches the style sheet on the calling thread, for a renderer which is also being drawn elsewhere use GHRasterCache, which records the document on the calling thread and only rasterizes in the background
+ */
+-(nullable CGImageRef) newImageWithSize:(CGSize)maximumSize scale:(CGFloat)scale currentColor:(nullable UIColor*)currentColor CF_RETURNS_RETAINED;
+
 @end
 
 NS_ASSUME_NONNULL_END
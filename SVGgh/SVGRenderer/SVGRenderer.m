@@ -26,18 +26,25 @@
 //  Created by Glenn Howes on 1/12/11.
 
 #import "SVGRenderer.h"
+#import "SVGRenderer+DisplayList.h"
 #import "GHText.h"
 #import "GHGradient.h"
 #import "SVGPathGenerator.h"
 #import "SVGUtilities.h"
+#import "GHColorTable.h"
+#import "GHCSSStyleSheet.h"
+#import "GHAttributeTable.h"
 #import "SVGTextUtilities.h"
+#import "GHDisplayList.h"
+#import "SVGBoundsTree.h"
+#import "GHComputedStyle.h"
+#include <stdatomic.h>
 
 @class GHShapeGroup;
 @interface SVGRenderer()
 
-@property (strong, nonatomic)	NSMutableDictionary*	colorMap;
 @property (copy, nonatomic)   NSDictionary*   namedObjects;
-@property (copy, nonatomic)   GHStyle*        cssStyle;
+@property (strong, nonatomic)   GHCSSStyleSheet* styleSheet;
 @property (assign)              BOOL            styleChecked;
 @property (copy, nonatomic)   UIColor* currentColor;
 @property (assign, nonatomic)   CGFloat opacity;
@@ -47,10 +54,287 @@
 @end
 
 
+@interface SVGRenderTileTiming()
+-(instancetype) initWithPixelRect:(CGRect)pixelRect duration:(NSTimeInterval)duration culledOperationCount:(NSUInteger)culledOperationCount;
+@end
+
+/*! @brief what one tile of a tiled render is drawn with, so the tiles don't fight over the renderer's currentColor and opacity as they replay objects which couldn't be compiled
+*/
+@interface GHTileSVGContext : NSObject<SVGContext>
+@property (strong, nonatomic, readonly) SVGRenderer* renderer;
+@property (copy, nonatomic, nullable)   UIColor* currentColor;
+@property (assign, nonatomic)   CGFloat opacity;
+-(instancetype) initWithRenderer:(SVGRenderer*)renderer currentColor:(nullable UIColor*)currentColor;
+@end
+
+/*! @brief the document's hit testable objects, flattened out of their groups and indexed by their bounds in the document's coordinates, so finding what's under a point only tests the few objects whose bounds contain it
+*/
+@interface GHHitTestIndex : NSObject
+-(instancetype) initWithContents:(GHShapeGroup*)contents svgContext:(id<SVGContext>)svgContext;
+-(nullable id<GHRenderable>) findRenderableObject:(CGPoint)testPoint withSVGContext:(id<SVGContext>)svgContext;
+@end
+
+typedef struct GHTileRecord
+{
+    CGRect          pixelRect;
+    NSTimeInterval  duration;
+    NSUInteger      culledOperationCount;
+} GHTileRecord;
+
+static NSUInteger NewStyleGeneration(void)
+{// unique across renderers, so an object's computed style can't be mistaken for one from another context
+    static atomic_ulong sLastGeneration = 0;
+    return (NSUInteger)atomic_fetch_add(&sLastGeneration, 1)+1;
+}
+
+@implementation SVGRenderTileTiming
+
+-(instancetype) initWithPixelRect:(CGRect)pixelRect duration:(NSTimeInterval)duration culledOperationCount:(NSUInteger)culledOperationCount
+{
+    if(nil != (self = [super init]))
+    {
+        _pixelRect = pixelRect;
+        _duration = duration;
+        _culledOperationCount = culledOperationCount;
+    }
+    return self;
+}
+
+-(NSString*) description
+{
+    return [NSString stringWithFormat:@"%@ %@ %.3fms %lu culled", [super description], NSStringFromCGRect(self.pixelRect),
+            self.duration*1000.0, (unsigned long)self.culledOperationCount];
+}
+@end
+
+@implementation GHTileSVGContext
+
+-(instancetype) initWithRenderer:(SVGRenderer*)renderer currentColor:(UIColor*)currentColor
+{
+    if(nil != (self = [super init]))
+    {
+        _renderer = renderer;
+        _currentColor = currentColor;
+        _opacity = 1.0;
+    }
+    return self;
+}
+
+-(UIColor*) colorForSVGColorString:(NSString*)svgColorString
+{
+    UIColor* result = nil;
+    if([svgColorString isEqualToString:@"currentColor"])
+    {
+        result = self.currentColor;
+    }
+    else
+    {
+        result = [self.renderer colorForSVGColorString:svgColorString];
+    }
+    return result;
+}
+
+-(NSURL*) relativeURL:(NSString*)subPath
+{
+    return [self.renderer relativeURL:subPath];
+}
+
+-(NSURL*) absoluteURL:(NSString*)absolutePath
+{
+    return [self.renderer absoluteURL:absolutePath];
+}
+
+-(id) objectNamed:(NSString*)objectName
+{
+    return [self.renderer objectNamed:objectName];
+}
+
+-(id) objectAtURL:(NSString*)aLocation
+{
+    return [self.renderer objectAtURL:aLocation];
+}
+
+-(NSString*) isoLanguage
+{
+    return self.renderer.isoLanguage;
+}
+
+-(CGFloat) explicitLineScaling
+{
+    return self.renderer.explicitLineScaling;
+}
+
+-(BOOL) hasCSSAttributes
+{
+    return self.renderer.hasCSSAttributes;
+}
+
+-(NSString*) attributeNamed:(NSString*)attributeName classes:(NSArray<NSString*>*)listOfClasses entityName:(NSString*)entityName
+{
+    return [self.renderer attributeNamed:attributeName classes:listOfClasses entityName:entityName];
+}
+
+-(NSUInteger) styleGeneration
+{
+    return self.renderer.styleGeneration;
+}
+@end
+
+typedef struct GHHitCandidates
+{
+    size_t*     indices;
+    size_t      count;
+    size_t      capacity;
+} GHHitCandidates;
+
+static int AddHitCandidate(void* info, size_t index)
+{
+    GHHitCandidates* candidates = (GHHitCandidates*)info;
+    if(candidates->count == candidates->capacity)
+    {
+        candidates->capacity = (candidates->capacity == 0) ? 32 : candidates->capacity*2;
+        candidates->indices = realloc(candidates->indices, candidates->capacity*sizeof(size_t));
+    }
+    candidates->indices[candidates->count++] = index;
+    return 0;
+}
+
+static int CompareIndicesDescending(const void* first, const void* second)
+{
+    size_t firstIndex = *(const size_t*)first;
+    size_t secondIndex = *(const size_t*)second;
+    return (firstIndex < secondIndex) ? 1 : ((firstIndex > secondIndex) ? -1 : 0);
+}
+
+@implementation GHHitTestIndex
+{
+    NSMutableArray*     _objects; // in document order, the last hit is the one on top
+    NSMutableData*      _inverseTransforms; // for each object, from the document's coordinates to its parent's
+    NSMutableData*      _boxes;
+    NSMutableIndexSet*  _unbounded; // objects with no bounds, always tested
+    SVGBoundsTree*      _tree;
+}
+
+-(instancetype) initWithContents:(GHShapeGroup*)contents svgContext:(id<SVGContext>)svgContext
+{
+    if(nil != (self = [super init]))
+    {
+        _objects = [[NSMutableArray alloc] init];
+        _inverseTransforms = [[NSMutableData alloc] init];
+        _boxes = [[NSMutableData alloc] init];
+        _unbounded = [[NSMutableIndexSet alloc] init];
+        [self addChildrenOfGroup:contents toDocument:CGAffineTransformIdentity withSVGContext:svgContext];
+        _tree = SVGBoundsTreeCreate(_boxes.bytes, _objects.count);
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    SVGBoundsTreeFree(_tree);
+}
+
+-(void) addChildrenOfGroup:(GHShapeGroup*)aGroup toDocument:(CGAffineTransform)groupToDocument withSVGContext:(id<SVGContext>)svgContext
+{// mirrors -[GHShapeGroup findRenderableObject:withSVGContext:], descending into the groups which use it
+    static IMP sGroupFind = NULL;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sGroupFind = [GHShapeGroup instanceMethodForSelector:@selector(findRenderableObject:withSVGContext:)];
+    });
+    CGAffineTransform childrenToDocument = CGAffineTransformConcat(aGroup.transform, groupToDocument);
+    CGAffineTransform documentToChildren = CGAffineTransformInvert(childrenToDocument);
+    for(id aChild in aGroup.children)
+    {
+        if(![aChild environmentOKWithSVGContext:svgContext])
+        {
+            continue;
+        }
+        if([aChild isKindOfClass:[GHShapeGroup class]] && [aChild methodForSelector:@selector(findRenderableObject:withSVGContext:)] == sGroupFind)
+        {
+            [self addChildrenOfGroup:aChild toDocument:childrenToDocument withSVGContext:svgContext];
+            continue;
+        }
+        
+        CGRect childBox = CGRectNull;
+        BOOL bounded = YES;
+        if([aChild isKindOfClass:[GHShape class]])
+        {// the hit test is of the fill, which lies within the transformed path
+            childBox = [aChild getBoundingBoxWithSVGContext:svgContext];
+        }
+        else if([aChild isKindOfClass:[GHImage class]])
+        {
+            childBox = CGRectApplyAffineTransform([aChild getBoundingBoxWithSVGContext:svgContext], [(GHImage*)aChild transform]);
+        }
+        else
+        {// text, use elements and the like
+            bounded = NO;
+            [_unbounded addIndex:_objects.count];
+        }
+        
+        SVGPathBounds box;
+        SVGPathBoundsInit(&box); // left out of the tree
+        if(bounded && !CGRectIsNull(childBox))
+        {
+            CGRect documentBox = CGRectApplyAffineTransform(childBox, childrenToDocument);
+            CGFloat slop = 1e-6*MAX(MAX(fabs(CGRectGetMinX(documentBox)), fabs(CGRectGetMaxX(documentBox))),
+                                    MAX(fabs(CGRectGetMinY(documentBox)), fabs(CGRectGetMaxY(documentBox))))+1e-9; // for rounding in the transforms
+            box.minX = CGRectGetMinX(documentBox)-slop;
+            box.minY = CGRectGetMinY(documentBox)-slop;
+            box.maxX = CGRectGetMaxX(documentBox)+slop;
+            box.maxY = CGRectGetMaxY(documentBox)+slop;
+        }
+        [_objects addObject:aChild];
+        [_inverseTransforms appendBytes:&documentToChildren length:sizeof(documentToChildren)];
+        [_boxes appendBytes:&box length:sizeof(box)];
+    }
+}
+
+-(id<GHRenderable>) findRenderableObject:(CGPoint)testPoint withSVGContext:(id<SVGContext>)svgContext
+{
+    id<GHRenderable> result = nil;
+    GHHitCandidates candidates = {NULL, 0, 0};
+    if(_tree != NULL)
+    {
+        SVGBoundsTreeVisitPoint(_tree, testPoint.x, testPoint.y, AddHitCandidate, &candidates);
+    }
+    [_unbounded enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        AddHitCandidate(&candidates, index);
+    }];
+    if(candidates.count > 1)
+    {
+        qsort(candidates.indices, candidates.count, sizeof(size_t), CompareIndicesDescending);
+    }
+    const CGAffineTransform* inverseTransforms = _inverseTransforms.bytes;
+    for(size_t index = 0; index < candidates.count && result == nil; index++)
+    {// topmost first
+        size_t objectIndex = candidates.indices[index];
+        CGPoint relativePoint = CGPointApplyAffineTransform(testPoint, inverseTransforms[objectIndex]);
+        result = [_objects[objectIndex] findRenderableObject:relativePoint withSVGContext:svgContext];
+    }
+    free(candidates.indices);
+    return result;
+}
+@end
+
 @implementation SVGRenderer
+{
+    atomic_ulong    _styleGeneration;
+    atomic_ulong    _cascadeGeneration; // the styleGeneration the style sheet was last matched for
+    GHDisplayList*  _displayList;
+    NSUInteger      _displayListGeneration;
+    NSUInteger      _displayListMutation; // the GHRenderableObjectMutationGeneration the display list was compiled at
+    UIColor*        _displayListColor; // the currentColor the display list was compiled with
+    GHHitTestIndex* _hitTestIndex;
+    NSUInteger      _hitTestIndexMutation; // the GHRenderableObjectMutationGeneration the index was built at
+}
 @synthesize	transform=_transform;
 @synthesize contents=_contents;
 
++(BOOL) buildsObjectTree
+{// the renderer only ever needs the object tree, so skip the intermediate dictionary form
+    return YES;
+}
+
 +(NSOperationQueue*) rendererQueue
 {
     static  NSOperationQueue* sResult = nil;
@@ -68,17 +352,20 @@
 	return result;
 }
 
+-(void) commonInit
+{// shared by every init path
+    CFArrayRef langs = CFLocaleCopyPreferredLanguages();
+    CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
+    _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
+    CFRelease(langs);
+    self.opacity = 1.0;
+}
+
 -(instancetype) initWithString:(NSString *)utf8String
 {
     if(nil != (self = [super initWithString:utf8String]))
     {
-		_colorMap = [[NSMutableDictionary alloc] init];
-        
-        CFArrayRef langs = CFLocaleCopyPreferredLanguages();
-        CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
-        _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
-        CFRelease(langs);
-        self.opacity = 1.0;
+        [self commonInit];
 	}
 	return self;
 }
@@ -87,28 +374,25 @@
 {
 	if(nil != (self = [super initWithContentsOfURL:url]))
     {
-		_colorMap = [[NSMutableDictionary alloc] init];
-        
-        CFArrayRef langs = CFLocaleCopyPreferredLanguages();
-        CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
-        _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
-        CFRelease(langs);
-        self.opacity = 1.0;
+        [self commonInit];
 	}
 	return self;
 }
 
+-(instancetype) initWithBinaryData:(NSData*)binaryData
+{
+    if(nil != (self = [super initWithBinaryData:binaryData]))
+    {
+        [self commonInit];
+    }
+    return self;
+}
+
 - (instancetype)initWithInputStream:(NSInputStream *)inputStream
 {
     if(nil != (self = [super initWithInputStream:inputStream]))
     {
-        _colorMap = [[NSMutableDictionary alloc] init];
-        
-        CFArrayRef langs = CFLocaleCopyPreferredLanguages();
-        CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
-        _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
-        CFRelease(langs);
-        self.opacity = 1.0;
+        [self commonInit];
     }
     return self;
 }
@@ -117,13 +401,7 @@
 {
     if(nil != (self = [super initWithResourceName:resourceName inBundle:bundle]))
     {
-        _colorMap = [[NSMutableDictionary alloc] init];
-        
-        CFArrayRef langs = CFLocaleCopyPreferredLanguages();
-        CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
-        _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
-        CFRelease(langs);
-        self.opacity = 1.0;
+        [self commonInit];
     }
     return self;
 }
@@ -132,13 +410,7 @@
 {
     if(nil != (self = [super initWithDataAssetNamed:assetName withBundle:bundle]))
     {
-        _colorMap = [[NSMutableDictionary alloc] init];
-        
-        CFArrayRef langs = CFLocaleCopyPreferredLanguages();
-        CFStringRef langCode = CFArrayGetValueAtIndex (langs, 0);
-        _isoLanguage = [[NSString stringWithString:(__bridge NSString*)langCode] substringToIndex:2];
-        CFRelease(langs);
-        self.opacity = 1.0;
+        [self commonInit];
     }
     return self;
 }
@@ -165,7 +437,11 @@
 {
 	if(_contents == nil && self.parserError == nil)
 	{
-		_contents = [[GHShapeGroup alloc] initWithDictionary:self.root];
+        _contents = self.rootObject;
+        if(_contents == nil)
+        {
+            _contents = [[GHShapeGroup alloc] initWithDictionary:self.root];
+        }
 	}
 	return _contents;
 }
@@ -185,53 +461,191 @@
     return _namedObjects;
 }
 
--(GHStyle*) cssStyle
+static void CollectStyleSheets(GHShapeGroup* aGroup, NSMutableArray<GHCSSStyleSheet*>* styleSheets)
+{// every <style> in the document, in document order
+    for(id aChild in aGroup.children)
+    {
+        if([aChild isKindOfClass:[GHStyle class]])
+        {
+            GHStyle* aStyle = aChild;
+            if(aStyle.styleType == kStyleTypeCSS && aStyle.styleSheet.ruleCount > 0)
+            {
+                [styleSheets addObject:aStyle.styleSheet];
+            }
+        }
+        else if([aChild isKindOfClass:[GHShapeGroup class]])
+        {
+            CollectStyleSheets(aChild, styleSheets);
+        }
+    }
+}
+
+-(GHCSSStyleSheet*) styleSheet
 {
-    if(_cssStyle == nil && !self.styleChecked)
+    if(_styleSheet == nil && !self.styleChecked)
     {
         self.styleChecked = YES;
-        GHShapeGroup* contents = self.contents;
-        NSArray* firstLevelChildren = contents.children;
-        for(id aChild in firstLevelChildren)
+        NSMutableArray<GHCSSStyleSheet*>* styleSheets = [[NSMutableArray alloc] init];
+        CollectStyleSheets(self.contents, styleSheets);
+        if(styleSheets.count == 1)
+        {
+            _styleSheet = styleSheets[0];
+        }
+        else if(styleSheets.count > 1)
+        {
+            _styleSheet = [[GHCSSStyleSheet alloc] initWithStyleSheets:styleSheets];
+        }
+    }
+    return _styleSheet;
+}
+
+-(BOOL) hasCSSAttributes
+{
+    return self.styleSheet.ruleCount > 0;
+}
+
+-(NSString*) attributeNamed:(NSString*)attributeName classes:(nullable NSArray<NSString*>*)listOfClasses entityName:(NSString*)entityName
+{// for callers outside the document tree, who can't say where the element sits, so only selectors without ancestors will match
+    NSString* result = nil;
+    GHCSSStyleSheet* styleSheet = self.styleSheet;
+    if(styleSheet != nil)
+    {
+        GHCSSElementDescription* element = [[GHCSSElementDescription alloc] initWithElementName:entityName ?: @"" elementID:nil classNames:listOfClasses parent:nil];
+        result = [[styleSheet declarationsForElement:element pseudoClass:self.cssPseudoClass] objectForKey:attributeName];
+    }
+    return result;
+}
+
+static NSArray<NSString*>* InheritedCSSProperties(void)
+{
+    static NSArray<NSString*>* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sResult = @[@"fill", @"fill-opacity", @"fill-rule", @"stroke", @"stroke-width", @"stroke-opacity",
+                    @"stroke-linecap", @"stroke-linejoin", @"stroke-miterlimit", @"stroke-dasharray", @"stroke-dashoffset",
+                    @"color", @"visibility", @"clip-rule", @"font-family", @"font-size", @"font-weight", @"font-style", @"text-anchor"];
+    });
+    return sResult;
+}
+
+static NSDictionary* EmptyCascade(void)
+{// marks an object the style sheet was matched against, without anything to say about it
+    static NSDictionary* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sResult = [GHAttributeTable attributeTableWithDictionary:@{}];
+    });
+    return sResult;
+}
+
+static GHCSSElementDescription* NewElementDescription(GHAttributedObject* anObject, NSString* elementName, GHCSSElementDescription* parent)
+{
+    NSDictionary* attributes = anObject.attributes;
+    NSString* elementID = [attributes objectForAtom:kGHAttributeID] ?: [attributes objectForAtom:kGHAttributeXMLID];
+    GHCSSElementDescription* result = [[GHCSSElementDescription alloc] initWithElementName:elementName ?: @""
+                                                                                 elementID:[elementID isKindOfClass:[NSString class]] ? elementID : nil
+                                                                                classNames:[attributes cssClassNames]
+                                                                                    parent:parent];
+    return result;
+}
+
+static void CascadeStyleSheet(GHCSSStyleSheet* styleSheet, CSSPseudoClassFlags pseudoClassFlags, GHAttributedObject* anObject, GHCSSElementDescription* element,
+                              NSDictionary<NSString*, NSString*>* inheritedValues)
+{// match each element once, leaving the result on the element for its style lookups
+    NSDictionary* attributes = anObject.attributes;
+    NSMutableDictionary<NSString*, NSString*>* cascade = nil;
+    for(NSString* aName in inheritedValues)
+    {// a value the parent got from the style sheet passes down unless this element sets its own, what it inherits from the parent's presentation attributes doesn't count
+        if([attributes styleValueForName:aName] == nil && [attributes ownObjectForKey:aName] == nil)
+        {
+            if(cascade == nil)
+            {
+                cascade = [[NSMutableDictionary alloc] initWithCapacity:inheritedValues.count];
+            }
+            [cascade setObject:[inheritedValues objectForKey:aName] forKey:aName];
+        }
+    }
+    NSDictionary<NSString*, NSString*>* important = nil;
+    NSDictionary<NSString*, NSString*>* matched = [styleSheet declarationsForElement:element pseudoClass:pseudoClassFlags importantDeclarations:&important];
+    if(matched.count)
+    {
+        if(cascade == nil)
+        {
+            cascade = [[NSMutableDictionary alloc] initWithCapacity:matched.count];
+        }
+        [cascade addEntriesFromDictionary:matched];
+    }
+    anObject.cascadedStyle = cascade.count ? [GHAttributeTable attributeTableWithDictionary:cascade] : EmptyCascade();
+    anObject.importantStyle = important.count ? [GHAttributeTable attributeTableWithDictionary:important] : nil;
+    
+    if([anObject isKindOfClass:[GHShapeGroup class]])
+    {
+        NSMutableDictionary<NSString*, NSString*>* childrensInheritedValues = nil;
+        for(NSString* aName in InheritedCSSProperties())
+        {
+            NSString* aValue = [cascade objectForKey:aName];
+            if(aValue != nil && ![aValue isEqualToString:@"inherit"] && ([attributes styleValueForName:aName] == nil || [important objectForKey:aName] != nil))
+            {// an inline style was already copied into the children as a presentation attribute, unless an !important rule overrode it
+                if(childrensInheritedValues == nil)
+                {
+                    childrensInheritedValues = [[NSMutableDictionary alloc] init];
+                }
+                [childrensInheritedValues setObject:aValue forKey:aName];
+            }
+        }
+        for(id aChild in ((GHShapeGroup*)anObject).children)
         {
-            if([aChild isKindOfClass:[GHDefinitionGroup class]])
+            if([aChild isKindOfClass:[GHAttributedObject class]])
+            {
+                NSString* elementName = [aChild isKindOfClass:[GHText class]] ? @"text" : [(GHAttributedObject*)aChild entityName];
+                GHCSSElementDescription* childElement = NewElementDescription(aChild, elementName, element);
+                CascadeStyleSheet(styleSheet, pseudoClassFlags, aChild, childElement, childrensInheritedValues);
+            }
+        }
+    }
+}
+
+-(void) applyStyleSheetIfNeeded
+{
+    NSUInteger generation = self.styleGeneration;
+    if(atomic_load(&_cascadeGeneration) != generation)
+    {
+        @synchronized(self)
+        {// several threads may start rendering at once, only one of them matches
+            unsigned long previousGeneration = atomic_load(&_cascadeGeneration);
+            if(previousGeneration != generation)
             {
-                NSArray* definitions = ((GHDefinitionGroup*)aChild).children;
-                for(id aDefinition in definitions)
+                GHCSSStyleSheet* styleSheet = self.styleSheet;
+                if(styleSheet != nil && (previousGeneration == 0 || styleSheet.usesPseudoClasses))
                 {
-                    if([aDefinition isKindOfClass:[GHStyle class]])
-                    {
-                        GHStyle* aStyle = aDefinition;
-                        if(aStyle.styleType == kStyleTypeCSS)
-                        {
-                            if(aStyle.classes.count > 0)
-                            {
-                                _cssStyle = aStyle;
-                                return _cssStyle;
-                            }
-                        }
-                    }
+                    GHShapeGroup* contents = self.contents;
+                    GHCSSElementDescription* root = NewElementDescription(contents, @"svg", nil);
+                    CascadeStyleSheet(styleSheet, self.cssPseudoClass, contents, root, nil);
                 }
+                atomic_store(&_cascadeGeneration, generation);
             }
         }
     }
-    return _cssStyle;
 }
 
--(BOOL) hasCSSAttributes
+-(NSUInteger) styleGeneration
 {
-    return self.cssStyle.classes.count > 0;
+    unsigned long result = atomic_load(&_styleGeneration);
+    if(result == 0)
+    {
+        unsigned long newGeneration = NewStyleGeneration();
+        result = atomic_compare_exchange_strong(&_styleGeneration, &result, newGeneration) ? newGeneration : result;
+    }
+    return (NSUInteger)result;
 }
 
--(NSString*) attributeNamed:(NSString*)attributeName classes:(nullable NSArray<NSString*>*)listOfClasses entityName:(NSString*)entityName
+-(void) setCssPseudoClass:(CSSPseudoClassFlags)cssPseudoClass
 {
-    NSString* result = nil;
-    NSDictionary<NSString*, GHCSSStyle*>* classes = self.cssStyle.classes;
-    if(classes.count > 0)
+    if(cssPseudoClass != _cssPseudoClass)
     {
-        result = [GHCSSStyle attributeNamed:attributeName classes:listOfClasses entityName:entityName  pseudoClass:self.cssPseudoClass forStyles:self.cssStyle.classes];
+        _cssPseudoClass = cssPseudoClass;
+        atomic_store(&_styleGeneration, NewStyleGeneration());
     }
-    return result;
 }
 
 -(void) setCurrentColor:(UIColor *)currentColor
@@ -247,17 +661,8 @@
         result = self.currentColor;
     }
     else
-    {
-        result = [self.colorMap objectForKey:colorString];
-        if(result == nil)
-        {
-            result = UIColorFromSVGColorString (colorString);
-            
-            if(result != nil)
-            {
-                [self.colorMap setObject:result forKey:colorString];
-            }
-        }
+    {// shared between all renderers and safe to use from any of their threads
+        result = [[GHColorTable sharedColorTable] colorForSVGColorString:colorString];
     }
 	return result;
 }
@@ -380,6 +785,203 @@
     
 }
 #endif // ios, tvos
+
+/*! @brief draw the document into one shared bitmap, a tile at a time across GCD's worker threads
+* @param pixelWidth width of the bitmap
+* @param pixelHeight height of the bitmap
+* @param documentTransform maps the document's coordinates to the bitmap's device space
+* @param displayList the compiled document
+* @param currentColor what the displayList was compiled with
+* @param tileSize the size of a tile in pixels
+* @param tileTimings optionally receives an SVGRenderTileTiming for each tile
+* @return an image to be released by the caller, or 0
+*/
+-(CGImageRef) newTiledImageWithPixelWidth:(size_t)pixelWidth height:(size_t)pixelHeight documentTransform:(CGAffineTransform)documentTransform
+                                displayList:(GHDisplayList*)displayList currentColor:(UIColor*)currentColor
+                                   tileSize:(NSUInteger)tileSize tileTimings:(NSArray<SVGRenderTileTiming*>* __nullable * __nullable)tileTimings CF_RETURNS_RETAINED
+{
+    CGImageRef result = 0;
+    size_t bytesPerRow = 4*pixelWidth;
+    uint8_t* pixels = (pixelWidth > 0 && pixelHeight > 0) ? calloc(pixelHeight, bytesPerRow) : NULL;
+    if(pixels == NULL)
+    {
+        return result;
+    }
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    const CGBitmapInfo bitmapInfo = (CGBitmapInfo)kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big;
+    
+    size_t columns = (pixelWidth+tileSize-1)/tileSize;
+    size_t rows = (pixelHeight+tileSize-1)/tileSize;
+    size_t tileCount = columns*rows;
+    GHTileRecord* records = calloc(tileCount, sizeof(GHTileRecord));
+    
+    dispatch_apply(tileCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t tileIndex) {
+        @autoreleasepool
+        {// tiles never share a pixel, so each can write straight into the one bitmap
+            size_t x = (tileIndex%columns)*tileSize;
+            size_t y = (tileIndex/columns)*tileSize;
+            size_t width = MIN((size_t)tileSize, pixelWidth-x);
+            size_t height = MIN((size_t)tileSize, pixelHeight-y);
+            GHTileRecord* aRecord = records+tileIndex;
+            aRecord->pixelRect = CGRectMake(x, y, width, height);
+            
+            CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+            CGContextRef tileContext = CGBitmapContextCreate(pixels+y*bytesPerRow+4*x, width, height, 8, bytesPerRow, colorSpace, bitmapInfo);
+            if(tileContext != 0)
+            {// device space is y up, and the bitmap's first row is its top
+                CGContextTranslateCTM(tileContext, -(CGFloat)x, -(CGFloat)(pixelHeight-y-height));
+                CGContextConcatCTM(tileContext, documentTransform);
+                CGContextSetRenderingIntent(tileContext, kColoringRenderingIntent);
+                CGContextSetInterpolationQuality(tileContext, kCGInterpolationHigh);
+                
+                GHTileSVGContext* tileSVGContext = [[GHTileSVGContext alloc] initWithRenderer:self currentColor:currentColor];
+                aRecord->culledOperationCount = [displayList replayIntoContext:tileContext withSVGContext:tileSVGContext
+                                                                cullingToRect:CGContextGetClipBoundingBox(tileContext)];
+                CGContextRelease(tileContext);
+            }
+            aRecord->duration = CFAbsoluteTimeGetCurrent()-startTime;
+        }
+    });
+    
+    CGContextRef imageContext = CGBitmapContextCreate(pixels, pixelWidth, pixelHeight, 8, bytesPerRow, colorSpace, bitmapInfo);
+    if(imageContext != 0)
+    {
+        result = CGBitmapContextCreateImage(imageContext);
+        CGContextRelease(imageContext);
+    }
+    if(tileTimings != NULL)
+    {
+        NSMutableArray<SVGRenderTileTiming*>* timings = [[NSMutableArray alloc] initWithCapacity:tileCount];
+        for(size_t index = 0; index < tileCount; index++)
+        {
+            [timings addObject:[[SVGRenderTileTiming alloc] initWithPixelRect:records[index].pixelRect duration:records[index].duration
+                                                         culledOperationCount:records[index].culledOperationCount]];
+        }
+        *tileTimings = [timings copy];
+    }
+    free(records);
+    CGColorSpaceRelease(colorSpace);
+    free(pixels);
+    return result;
+}
+
+static CGFloat FittedScaling(CGSize maximumSize, CGSize documentSize)
+{
+    CGFloat interiorAspectRatio = maximumSize.width/maximumSize.height;
+    CGFloat rendererAspectRatio = documentSize.width/documentSize.height;
+    CGFloat result;
+    if(interiorAspectRatio >= rendererAspectRatio)
+    {
+        result = maximumSize.height/documentSize.height;
+    }
+    else
+    {
+        result = maximumSize.width/documentSize.width;
+    }
+    return isfinite(result) ? result : 0.0; // an empty document or size gives an empty image
+}
+
+/*! @brief the document transform asImageWithSize:andScale: draws with, so the tiled and cached images match it
+* @param baseTransform maps the fitted points to the bitmap's device space
+*/
+static CGAffineTransform FittedDocumentTransform(CGAffineTransform baseTransform, CGFloat fittedScaling, CGPoint documentOrigin)
+{
+    CGAffineTransform result = CGAffineTransformScale(baseTransform, fittedScaling, fittedScaling);
+    return CGAffineTransformTranslate(result, -documentOrigin.x*fittedScaling, -documentOrigin.y*fittedScaling);
+}
+
+static const NSUInteger kDefaultTileSize = 512;
+
+#if TARGET_OS_OSX
+-(NSImage*) asTiledImageWithSize:(CGSize)maximumSize andScale:(CGFloat)scale tileSize:(NSUInteger)tileSize tileTimings:(NSArray<SVGRenderTileTiming*>**)tileTimings
+{
+    CGSize documentSize = self.viewRect.size;
+    CGFloat fittedScaling = FittedScaling(maximumSize, documentSize);
+    size_t pixelWidth = (size_t)MAX(floor(documentSize.width*fittedScaling), 0.0);
+    size_t pixelHeight = (size_t)MAX(floor(documentSize.height*fittedScaling), 0.0);
+    
+    NSImage* result = nil;
+    CGImageRef bitmap = [self newTiledImageWithPixelWidth:pixelWidth height:pixelHeight
+                                        documentTransform:FittedDocumentTransform(CGAffineTransformIdentity, fittedScaling, self.viewRect.origin)
+                                              displayList:[self compiledDisplayList] currentColor:self.currentColor
+                                                 tileSize:(tileSize == 0) ? kDefaultTileSize : tileSize tileTimings:tileTimings];
+    if(bitmap != 0)
+    {
+        result =  [[NSImage alloc] initWithCGImage:bitmap size:NSSizeFromCGSize(maximumSize)];
+        CGImageRelease(bitmap);
+    }
+    return result;
+}
+#else
+-(UIImage*) asTiledImageWithSize:(CGSize)maximumSize andScale:(CGFloat)scale tileSize:(NSUInteger)tileSize tileTimings:(NSArray<SVGRenderTileTiming*>**)tileTimings
+{
+    CGSize documentSize = self.viewRect.size;
+    CGFloat fittedScaling = FittedScaling(maximumSize, documentSize);
+    CGFloat scaledWidth = floor(documentSize.width*fittedScaling);
+    CGFloat scaleHeight = floor(documentSize.height*fittedScaling);
+    size_t pixelWidth = (size_t)MAX(round(scaledWidth*scale), 0.0);
+    size_t pixelHeight = (size_t)MAX(round(scaleHeight*scale), 0.0);
+    
+    UIImage* result = nil;
+    CGAffineTransform flipped = CGAffineTransformMake(scale, 0.0, 0.0, -scale, 0.0, pixelHeight); // as UIKit sets up an image context
+    CGImageRef bitmap = [self newTiledImageWithPixelWidth:pixelWidth height:pixelHeight
+                                        documentTransform:FittedDocumentTransform(flipped, fittedScaling, self.viewRect.origin)
+                                              displayList:[self compiledDisplayList] currentColor:self.currentColor
+                                                 tileSize:(tileSize == 0) ? kDefaultTileSize : tileSize tileTimings:tileTimings];
+    if(bitmap != 0)
+    {
+        result = [UIImage imageWithCGImage:bitmap scale:scale orientation:UIImageOrientationUp];
+        CGImageRelease(bitmap);
+    }
+    return result;
+}
+#endif
+
+-(GHDisplayList*) newDisplayListWithCurrentColor:(UIColor*)currentColor
+{
+    [self applyStyleSheetIfNeeded];
+    GHDisplayList* result = [[GHDisplayList alloc] init];
+    GHTileSVGContext* svgContext = [[GHTileSVGContext alloc] initWithRenderer:self currentColor:currentColor];
+    [GHRenderableObject compileSetupWithAttributes:[SVGRenderer defaultAttributes] intoDisplayList:result withSVGContext:svgContext];
+    [result addRenderable:self.contents withSVGContext:svgContext];
+    return result;
+}
+
+-(CGImageRef) newImageWithSize:(CGSize)maximumSize scale:(CGFloat)scale currentColor:(UIColor*)currentColor
+{
+    return [self newImageWithSize:maximumSize scale:scale currentColor:currentColor displayList:[self newDisplayListWithCurrentColor:currentColor]];
+}
+
+-(CGImageRef) newImageWithSize:(CGSize)maximumSize scale:(CGFloat)scale currentColor:(UIColor*)currentColor displayList:(GHDisplayList*)displayList
+{
+    CGSize documentSize = self.viewRect.size;
+    CGFloat fittedScaling = FittedScaling(maximumSize, documentSize);
+    size_t pixelWidth = (size_t)MAX(round(floor(documentSize.width*fittedScaling)*scale), 0.0);
+    size_t pixelHeight = (size_t)MAX(round(floor(documentSize.height*fittedScaling)*scale), 0.0);
+    
+    CGAffineTransform flipped = CGAffineTransformMake(scale, 0.0, 0.0, -scale, 0.0, pixelHeight); // first row at the top
+    return [self newTiledImageWithPixelWidth:pixelWidth height:pixelHeight
+                           documentTransform:FittedDocumentTransform(flipped, fittedScaling, self.viewRect.origin)
+                                 displayList:displayList currentColor:currentColor
+                                    tileSize:MAX(MAX(pixelWidth, pixelHeight), (size_t)1) tileTimings:NULL];
+}
+
+-(CGImageRef) newImageCenteredInSize:(CGSize)size scale:(CGFloat)scale currentColor:(UIColor*)currentColor
+{// as GHButton's drawArtWithRenderer: has always drawn: not rounded down, and not offset by the viewBox's origin
+    CGSize documentSize = self.viewRect.size;
+    CGFloat fittedScaling = FittedScaling(size, documentSize);
+    size_t pixelWidth = (size_t)MAX(ceil(size.width*scale), 0.0);
+    size_t pixelHeight = (size_t)MAX(ceil(size.height*scale), 0.0);
+    
+    CGAffineTransform documentTransform = CGAffineTransformMake(scale, 0.0, 0.0, -scale, 0.0, pixelHeight); // first row at the top
+    documentTransform = CGAffineTransformTranslate(documentTransform, (size.width-documentSize.width*fittedScaling)/2.0,
+                                                   (size.height-documentSize.height*fittedScaling)/2.0);
+    documentTransform = CGAffineTransformScale(documentTransform, fittedScaling, fittedScaling);
+    return [self newTiledImageWithPixelWidth:pixelWidth height:pixelHeight documentTransform:documentTransform
+                                 displayList:[self newDisplayListWithCurrentColor:currentColor] currentColor:currentColor
+                                    tileSize:MAX(MAX(pixelWidth, pixelHeight), (size_t)1) tileTimings:NULL];
+}
+
 - (id)debugQuickLookObject // select an SVGRenderer in Xcode debugger and hit the eye button
 {
     return [self asImageWithSize:CGSizeMake(512, 512) andScale:1.0];
@@ -388,9 +990,9 @@
 -(CGRect) viewRect
 {
 	CGRect	result = CGRectZero;
-	NSString*	viewBoxString = [self.attributes objectForKey:@"viewBox"];
-	NSString* viewWidth = [self.attributes objectForKey:@"width"];
-	NSString* viewHeight = [self.attributes objectForKey:@"height"];
+	NSString*	viewBoxString = [self.attributes objectForAtom:kGHAttributeViewBox];
+	NSString* viewWidth = [self.attributes objectForAtom:kGHAttributeWidth];
+	NSString* viewHeight = [self.attributes objectForAtom:kGHAttributeHeight];
 	if(([viewWidth length] > 0 && [viewWidth doubleValue] <= 0)
 	   || ([viewHeight length] > 0 && [viewHeight doubleValue] <= 0))
 	{
@@ -430,6 +1032,42 @@
     return result;
 }
 
+static void CollectShapes(GHShapeGroup* aGroup, NSMutableArray<GHShape*>* shapes)
+{
+    for(id aChild in aGroup.children)
+    {
+        if([aChild isKindOfClass:[GHShape class]])
+        {
+            [shapes addObject:aChild];
+        }
+        else if([aChild isKindOfClass:[GHShapeGroup class]])
+        {
+            CollectShapes(aChild, shapes);
+        }
+    }
+}
+
+-(void) preparePathsConcurrently
+{
+    NSMutableArray<GHShape*>* shapes = [[NSMutableArray alloc] init];
+    CollectShapes(self.contents, shapes);
+    NSUInteger shapeCount = shapes.count;
+    const NSUInteger shapesPerBatch = 32;
+    NSUInteger batchCount = (shapeCount+shapesPerBatch-1)/shapesPerBatch;
+    dispatch_apply(batchCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^(size_t batchIndex) {
+        @autoreleasepool
+        {// each shape belongs to exactly one batch, so its lazily built path is only ever touched by one thread
+            NSUInteger end = MIN((batchIndex+1)*shapesPerBatch, shapeCount);
+            for(NSUInteger index = batchIndex*shapesPerBatch; index < end; index++)
+            {
+                GHShape* aShape = shapes[index];
+                (void)aShape.quartzPath;
+                (void)aShape.pathBoundingBox;
+            }
+        }
+    });
+}
+
 -(void) renderIntoContext:(CGContextRef)quartzContext
 {
 	CGContextSetRenderingIntent(quartzContext, kColoringRenderingIntent);
@@ -437,22 +1075,180 @@
     [self renderIntoContext:quartzContext withSVGContext:self];
 }
 
+-(void) renderWithDrawingBackend:(const struct SVGDrawingBackend*)backend context:(void*)context
+{
+    [[self compiledDisplayList] replayWithDrawingBackend:backend context:context withSVGContext:self];
+}
+
 -(id<GHRenderable>) findRenderableObject:(CGPoint)testPoint
 {
-	id<GHRenderable> result = [self.contents findRenderableObject:testPoint withSVGContext:self];
+    [self applyStyleSheetIfNeeded];
+    NSUInteger mutation = GHRenderableObjectMutationGeneration();
+    GHHitTestIndex* hitTestIndex = nil;
+    @synchronized(self)
+    {// rebuilt along with the display list, when an object has moved or invalidateDisplayList was called
+        if(_hitTestIndex == nil || _hitTestIndexMutation != mutation)
+        {
+            _hitTestIndex = [[GHHitTestIndex alloc] initWithContents:self.contents svgContext:self];
+            _hitTestIndexMutation = mutation;
+        }
+        hitTestIndex = _hitTestIndex;
+    }
+	id<GHRenderable> result = [hitTestIndex findRenderableObject:testPoint withSVGContext:self];
 	return result;
 }
 
--(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
+/*! @brief where an object draws in its parent's coordinates, strokes included
+* @return CGRectNull if it draws nothing, CGRectInfinite if that can't be worked out
+*/
+static CGRect DrawnBoundsOfObject(id anObject, id<SVGContext> svgContext)
 {
-	NSDictionary* defaultAttributes = [SVGRenderer defaultAttributes];
-	[GHRenderableObject	setupContext:quartzContext withAttributes:defaultAttributes  withSVGContext:svgContext];
-	
-	[self.contents renderIntoContext:quartzContext  withSVGContext:self];
+    CGRect result = CGRectInfinite;
+    if([anObject isKindOfClass:[GHShape class]])
+    {
+        GHShape* aShape = anObject;
+        const GHResolvedStyle* style = [aShape computedStyleWithSVGContext:svgContext].resolvedStyle;
+        CGRect pathBox = aShape.pathBoundingBox;
+        if(style->stroke.type == kGHPaintNone || CGRectIsNull(pathBox))
+        {
+            result = [aShape getBoundingBoxWithSVGContext:svgContext];
+        }
+        else if((style->flags & kGHStyleNonScalingStroke) == 0)
+        {// as the display list bounds a stroke, far enough out for square caps and miters up to the limit
+            CGFloat halfWidth = fabs((style->flags & kGHStyleHasStrokeWidth) ? style->strokeWidth : 1.0)/2.0;
+            CGFloat outset = halfWidth*M_SQRT2;
+            if(((style->flags & kGHStyleHasLineJoin) == 0) || style->lineJoin == kCGLineJoinMiter)
+            {
+                outset = MAX(outset, halfWidth*((style->flags & kGHStyleHasMiterLimit) ? style->miterLimit : 10.0));
+            }
+            result = CGRectApplyAffineTransform(CGRectInset(pathBox, -outset, -outset), aShape.transform);
+        }
+    }
+    else if([anObject isKindOfClass:[GHImage class]])
+    {
+        result = CGRectApplyAffineTransform([anObject getBoundingBoxWithSVGContext:svgContext], [(GHImage*)anObject transform]);
+    }
+    else if([anObject isKindOfClass:[GHDefinitionGroup class]] || [anObject isKindOfClass:[GHClipGroup class]])
+    {// only ever drawn by reference
+        result = CGRectNull;
+    }
+    else if([anObject isKindOfClass:[GHShapeGroup class]])
+    {
+        GHShapeGroup* aGroup = anObject;
+        result = CGRectNull;
+        for(id aChild in aGroup.children)
+        {
+            if([aChild environmentOKWithSVGContext:svgContext])
+            {
+                CGRect childBounds = DrawnBoundsOfObject(aChild, svgContext);
+                if(CGRectIsInfinite(childBounds))
+                {
+                    return CGRectInfinite;
+                }
+                result = CGRectUnion(result, childBounds);
+            }
+        }
+        if(!CGRectIsNull(result))
+        {
+            result = CGRectApplyAffineTransform(result, aGroup.transform);
+        }
+    }
+    return result;
+}
+
+/*! @brief find an object under a group, and the transform from its parent's coordinates to the group's parent's
+*/
+static BOOL FindObjectInGroup(id anObject, GHShapeGroup* aGroup, CGAffineTransform* parentTransform)
+{
+    BOOL result = NO;
+    for(id aChild in aGroup.children)
+    {
+        if(aChild == anObject)
+        {
+            result = YES;
+        }
+        else if([aChild isKindOfClass:[GHShapeGroup class]])
+        {
+            result = FindObjectInGroup(anObject, aChild, parentTransform);
+        }
+        if(result)
+        {
+            *parentTransform = CGAffineTransformConcat(*parentTransform, aGroup.transform);
+            break;
+        }
+    }
+    return result;
+}
+
+-(CGRect) drawnBoundsOfObject:(id<GHRenderable>)anObject
+{
+    [self applyStyleSheetIfNeeded];
+    CGRect result = CGRectNull;
+    GHShapeGroup* contents = self.contents;
+    if(anObject == (id<GHRenderable>)contents)
+    {
+        result = DrawnBoundsOfObject(contents, self);
+    }
+    else
+    {
+        CGAffineTransform parentTransform = CGAffineTransformIdentity;
+        if(contents != nil && FindObjectInGroup(anObject, contents, &parentTransform))
+        {
+            result = DrawnBoundsOfObject(anObject, self);
+            if(!CGRectIsNull(result) && !CGRectIsInfinite(result))
+            {
+                result = CGRectApplyAffineTransform(result, parentTransform);
+            }
+        }
+    }
+    return result;
+}
+
+-(GHDisplayList*) compiledDisplayList
+{
+    [self applyStyleSheetIfNeeded];
+    NSUInteger generation = self.styleGeneration;
+    NSUInteger mutation = GHRenderableObjectMutationGeneration();
+    UIColor* currentColor = self.currentColor;
+    GHDisplayList* result = nil;
+    @synchronized(self)
+    {// the tree is walked once per style generation, object mutation and currentColor, every render after that just replays
+        result = _displayList;
+        if(result == nil || _displayListGeneration != generation || _displayListMutation != mutation
+           || !(_displayListColor == currentColor || [_displayListColor isEqual:currentColor]))
+        {
+            result = [[GHDisplayList alloc] init];
+            CGFloat savedOpacity = self.opacity;
+            [GHRenderableObject compileSetupWithAttributes:[SVGRenderer defaultAttributes] intoDisplayList:result withSVGContext:self];
+            [result addRenderable:self.contents withSVGContext:self];
+            self.opacity = savedOpacity;
+            self.currentColor = currentColor;
+            _displayList = result;
+            _displayListGeneration = generation;
+            _displayListMutation = mutation;
+            _displayListColor = currentColor;
+        }
+    }
+    return result;
+}
+
+-(void) invalidateDisplayList
+{
+    @synchronized(self)
+    {
+        _displayList = nil;
+        _hitTestIndex = nil;
+    }
+}
+
+-(void) renderIntoContext:(CGContextRef)quartzContext withSVGContext:(id<SVGContext>)svgContext
+{// only what falls inside the clip, often a small dirty rect, is drawn
+    [[self compiledDisplayList] replayIntoContext:quartzContext withSVGContext:self cullingToRect:CGContextGetClipBoundingBox(quartzContext)];
 }
 
 -(id<GHRenderable>) findRenderableObject:(CGPoint)testPoint withSVGContext:(id<SVGContext>)svgContext
 {
+    [self applyStyleSheetIfNeeded];
 	id<GHRenderable> result = [self.contents findRenderableObject:testPoint withSVGContext:svgContext];
 	return result;
 }
@@ -31,13 +31,18 @@
 #endif
 
 #import <SVGgh/GHImageCache.h>
+#import <SVGgh/GHRasterCache.h>
 #import <SVGgh/GHRenderable.h>
 #import <SVGgh/SVGRendererLayer.h>
 #import <SVGgh/SVGParser.h>
+#import <SVGgh/SVGBinaryDocument.h>
 #import <SVGgh/SVGRenderer.h>
+#import <SVGgh/SVGDrawingBackend.h>
+#import <SVGgh/SVGRasterizer.h>
 #import <SVGgh/SVGPrinter.h>
 #import <SVGgh/SVGtoPDFConverter.h>
 #import <SVGgh/SVGPathGenerator.h>
+#import <SVGgh/GHPathCache.h>
 #if TARGET_OS_OSX
 #else
 #import <SVGgh/SVGDocumentView.h>
@@ -48,7 +53,8 @@
 #import <SVGgh/SVGTabBarItem.h>
 #endif
 #import <SVGgh/SVGghLoader.h>
-#import <SVGgh/GHCSSStyle.h> // not yet implemented, somebody want to implement a CSS parser?
+#import <SVGgh/GHCSSStyle.h>
+#import <SVGgh/GHCSSStyleSheet.h>
 
 /*! \brief Because views and buttons are dynamically instantiated from Storyboards and Nibs, code for their classes might not link in from a static library. Thus this method to make sure the class gets called at least once from code.
 */
@@ -0,0 +1,158 @@
+//
+//  GHRasterCache.h
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+    @import Foundation;
+    @import UIKit;
+#else
+    #import <Foundation/Foundation.h>
+    #import <UIKit/UIKit.h>
+#endif
+
+#import <SVGgh/GHCSSStyle.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SVGRenderer;
+
+/*! @brief called on the main queue once a requested image is in the cache, or could not be rendered
+* @param anImage the image just cached, so a view can simply redraw itself and hit. NULL if rendering failed, the key is then not rendered again for a few seconds, or until its document's images are removed. NULL too if the document's images were removed while it rendered
+*/
+typedef void (^handleRasterCached_t)(CGImageRef __nullable anImage);
+
+/*! @brief a shared cache of rendered SVG documents, so widgets drawing the same artwork at the same size and color only render it once. Least recently used images are evicted to stay within a budget of bytes.
+* @note images are keyed by document and its bundle, pixel size, scale, currentColor and CSS pseudo class. Misses are rendered on SVGRenderer's rendererQueue, not on the calling thread, so a view should draw its vectors directly on a miss and hit the cache on later draws.
+* @see SVGRenderer
+*/
+@interface GHRasterCache : NSObject
+
+/*! @brief the cache the views in this library share
+* @return a singleton, with a 32MB budget
+*/
++(GHRasterCache*) sharedCache;
+
+/*! @brief a cache of one's own
+* @param byteBudget how many bytes of bitmap to keep before evicting
+*/
+-(instancetype) initWithByteBudget:(NSUInteger)byteBudget NS_DESIGNATED_INITIALIZER;
+
+/*! @property byteBudget
+* @brief how many bytes of bitmap to keep, lowering it evicts right away
+*/
+@property(atomic, assign) NSUInteger  byteBudget;
+
+/*! @property totalBytes
+* @brief the bytes of bitmap now held
+*/
+@property(atomic, readonly) NSUInteger  totalBytes;
+
+/*! @property hitCount
+* @brief how many requests were answered from the cache since the statistics were last reset
+*/
+@property(atomic, readonly) NSUInteger  hitCount;
+
+/*! @property missCount
+* @brief how many requests had to be rendered since the statistics were last reset
+*/
+@property(atomic, readonly) NSUInteger  missCount;
+
+/*! @property hitRate
+* @brief hitCount over all requests, 0 if there were none
+*/
+@property(atomic, readonly) double  hitRate;
+
+/*! @brief start counting hits and misses from 0
+*/
+-(void) resetStatistics;
+
+/*! @brief throw away every image, as on a memory warning, and forget which renders failed
+*/
+-(void) removeAllImages;
+
+/*! @brief throw away the images of a renderer whose document has been changed in place
+* @param renderer a renderer previously passed to copyImageForRenderer:...
+* @note images of the renderer still being rendered are dropped rather than cached when they finish
+*/
+-(void) removeImagesForRenderer:(SVGRenderer*)renderer;
+
+/*! @brief whether an image of this size could ever fit in the budget, if not a view should draw directly instead
+* @param pixelSize the size of the bitmap in pixels
+* @return YES if it would be cached
+*/
+-(BOOL) canCacheImageWithPixelSize:(CGSize)pixelSize;
+
+/*! @brief find the image of an already loaded renderer. On a miss the document is recorded, and its style sheet matched, on the calling thread, only the rasterizing is done on the rendererQueue, so the renderer can be drawn on the main thread meanwhile
+* @param renderer the document, the renderer's cssPseudoClass is part of the key
+* @param maximumSize the size in points the document is fitted into
+* @param scale pixels per point
+* @param currentColor the value of 'currentColor' to render with
+* @param whenCached on a miss, called after the image has been rendered and cached
+* @return on a hit, an image whose first row is the top of the document, to be released by the caller. NULL on a miss
+*/
+-(nullable CGImageRef) copyImageForRenderer:(SVGRenderer*)renderer fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                               currentColor:(nullable UIColor*)currentColor whenCached:(nullable handleRasterCached_t)whenCached CF_RETURNS_RETAINED;
+
+/*! @brief find the image of a document by its artwork path, on a miss it will be loaded through the SVGghLoaderManager's loader away from the main thread
+* @param artworkPath identifier of the document as given to the SVGghLoader
+* @param bundle the bundle the loader looks in, nil for the main bundle. Part of the key
+* @param maximumSize the size in points the document is fitted into
+* @param scale pixels per point
+* @param currentColor the value of 'currentColor' to render with
+* @param pseudoClass the cssPseudoClass to render with
+* @param whenCached on a miss, called after the image has been rendered and cached
+* @return on a hit, an image whose first row is the top of the document, to be released by the caller. NULL on a miss
+*/
+-(nullable CGImageRef) copyImageForArtworkPath:(NSString*)artworkPath inBundle:(nullable NSBundle*)bundle fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                                  currentColor:(nullable UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass
+                                    whenCached:(nullable handleRasterCached_t)whenCached CF_RETURNS_RETAINED;
+
+/*! @brief as copyImageForArtworkPath:inBundle:fittingSize:... but the image is exactly the given size, with the document fitted and centered in it and not offset by its viewBox's origin, the way GHButton draws its artwork
+* @param artworkPath identifier of the document as given to the SVGghLoader
+* @param bundle the bundle the loader looks in, nil for the main bundle. Part of the key
+* @param size the size in points of the image, draw it into a rect of this size where the vectors would have been fitted
+* @param scale pixels per point
+* @param currentColor the value of 'currentColor' to render with
+* @param pseudoClass the cssPseudoClass to render with
+* @param whenCached on a miss, called after the image has been rendered and cached
+* @return on a hit, an image whose first row is the top, to be released by the caller. NULL on a miss
+*/
+-(nullable CGImageRef) copyImageForArtworkPath:(NSString*)artworkPath inBundle:(nullable NSBundle*)bundle centeredInSize:(CGSize)size scale:(CGFloat)scale
+                                  currentColor:(nullable UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass
+                                    whenCached:(nullable handleRasterCached_t)whenCached CF_RETURNS_RETAINED;
+
+/*! @brief draw an image from the cache into a context set up like a UIKit or SVGRenderer context, with the y axis pointing down
+* @param anImage an image returned by this cache
+* @param aRect where in the context's coordinates to draw it
+* @param quartzContext where to draw
+*/
++(void) drawImage:(CGImageRef)anImage inRect:(CGRect)aRect intoContext:(CGContextRef)quartzContext;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,559 @@
+//
+//  GHRasterCache.m
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+#if defined(__has_feature) && __has_feature(modules)
+@import Foundation;
+@import UIKit;
+#else
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+#endif
+
+#import "GHRasterCache.h"
+#import "SVGRenderer+DisplayList.h"
+#import "SVGghLoader.h"
+
+static const NSUInteger kDefaultByteBudget = 32*1024*1024;
+static const NSTimeInterval kFailedRenderRetryInterval = 10.0; // as artwork missing now may be downloaded later
+
+typedef CGImageRef __nullable (^GHRasterRender_t)(void); // run on the rendererQueue, returns a retained image or NULL on failure
+
+/*! @brief what an image in the cache was rendered for
+*/
+@interface GHRasterCacheKey : NSObject<NSCopying>
+@property(nonatomic, readonly) NSString*            document;
+@property(nonatomic, readonly, nullable) NSString*  bundlePath; // where an artwork path was looked up, nil for the main bundle and for renderers
+@property(nonatomic, readonly) NSUInteger           pixelWidth;
+@property(nonatomic, readonly) NSUInteger           pixelHeight;
+@property(nonatomic, readonly) CGFloat              scale;
+@property(nonatomic, readonly, nullable) UIColor*   currentColor;
+@property(nonatomic, readonly) CSSPseudoClassFlags  pseudoClass;
+@property(nonatomic, readonly) BOOL                 centered; // drawn as by newImageCenteredInSize: rather than fitted as by newImageWithSize:
+-(instancetype) initWithDocument:(NSString*)document bundle:(nullable NSBundle*)bundle fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                    currentColor:(nullable UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass centered:(BOOL)centered;
+@end
+
+/*! @brief a cached image, linked into the cache's list from most to least recently used
+*/
+@interface GHRasterCacheEntry : NSObject
+@property(nonatomic, readonly) GHRasterCacheKey*        key;
+@property(nonatomic, readonly) CGImageRef               image;
+@property(nonatomic, readonly) NSUInteger               cost;
+@property(nonatomic, strong, nullable) GHRasterCacheEntry*  next;
+@property(nonatomic, weak, nullable) GHRasterCacheEntry*    previous;
+-(instancetype) initWithKey:(GHRasterCacheKey*)key image:(CGImageRef)image;
+@end
+
+@interface GHRasterCache ()
+{
+    NSMutableDictionary<GHRasterCacheKey*, GHRasterCacheEntry*>*            _entries;
+    NSMutableDictionary<GHRasterCacheKey*, NSMutableArray<handleRasterCached_t>*>* _pending; // being rendered, and who is waiting
+    NSMutableDictionary<GHRasterCacheKey*, NSDate*>*  _failed; // rendered to nothing and when, not tried again for a while or until their document's images are removed
+    NSMapTable<SVGRenderer*, NSString*>*    _rendererIdentities;
+    NSMutableDictionary<NSString*, NSNumber*>*  _documentGenerations; // bumped as a document's images are removed, so renders already under way are dropped
+    GHRasterCacheEntry*                     _mostRecent;
+    __weak GHRasterCacheEntry*              _leastRecent;
+    NSUInteger                              _byteBudget;
+    NSUInteger                              _totalBytes;
+    NSUInteger                              _hitCount;
+    NSUInteger                              _missCount;
+}
+@end
+
+@implementation GHRasterCacheKey
+
+-(instancetype) initWithDocument:(NSString*)document bundle:(NSBundle*)bundle fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                    currentColor:(UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass centered:(BOOL)centered
+{
+    if(nil != (self = [super init]))
+    {
+        _document = [document copy];
+        _bundlePath = (bundle == nil || bundle == [NSBundle mainBundle]) ? nil : [bundle.bundlePath copy];
+        _pixelWidth = (NSUInteger)MAX(ceil(maximumSize.width*scale), 0.0);
+        _pixelHeight = (NSUInteger)MAX(ceil(maximumSize.height*scale), 0.0);
+        _scale = scale;
+        _currentColor = currentColor;
+        _pseudoClass = pseudoClass;
+        _centered = centered;
+    }
+    return self;
+}
+
+-(id) copyWithZone:(NSZone *)zone
+{// immutable
+    return self;
+}
+
+-(NSUInteger) hash
+{
+    NSUInteger result = self.document.hash;
+    result = 31*result+self.pixelWidth;
+    result = 31*result+self.pixelHeight;
+    result = 31*result+(NSUInteger)(self.scale*100.0);
+    result = 31*result+self.currentColor.hash;
+    result = 31*result+self.pseudoClass;
+    result = 31*result+self.centered;
+    result = 31*result+self.bundlePath.hash;
+    return result;
+}
+
+-(BOOL) isEqual:(id)object
+{
+    BOOL result = NO;
+    if(object == self)
+    {
+        result = YES;
+    }
+    else if([object isKindOfClass:[GHRasterCacheKey class]])
+    {
+        GHRasterCacheKey* other = (GHRasterCacheKey*)object;
+        result = other.pixelWidth == self.pixelWidth && other.pixelHeight == self.pixelHeight
+                    && other.scale == self.scale && other.pseudoClass == self.pseudoClass && other.centered == self.centered
+                    && [other.document isEqualToString:self.document]
+                    && (other.bundlePath == self.bundlePath || [other.bundlePath isEqualToString:self.bundlePath])
+                    && (other.currentColor == self.currentColor || [other.currentColor isEqual:self.currentColor]);
+    }
+    return result;
+}
+
+@end
+
+@implementation GHRasterCacheEntry
+
+-(instancetype) initWithKey:(GHRasterCacheKey*)key image:(CGImageRef)image
+{
+    if(nil != (self = [super init]))
+    {
+        _key = key;
+        _image = CGImageRetain(image);
+        _cost = CGImageGetBytesPerRow(image)*CGImageGetHeight(image);
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    CGImageRelease(_image);
+}
+
+@end
+
+@implementation GHRasterCache
+
++(GHRasterCache*) sharedCache
+{
+    static GHRasterCache* sResult = nil;
+    static dispatch_once_t  done;
+    dispatch_once(&done, ^{
+        sResult = [[GHRasterCache alloc] initWithByteBudget:kDefaultByteBudget];
+    });
+    return sResult;
+}
+
++(void) drawImage:(CGImageRef)anImage inRect:(CGRect)aRect intoContext:(CGContextRef)quartzContext
+{
+    CGContextSaveGState(quartzContext);
+    CGContextTranslateCTM(quartzContext, aRect.origin.x, CGRectGetMaxY(aRect));
+    CGContextScaleCTM(quartzContext, 1.0, -1.0); // Quartz draws images bottom up
+    CGContextDrawImage(quartzContext, CGRectMake(0.0, 0.0, aRect.size.width, aRect.size.height), anImage);
+    CGContextRestoreGState(quartzContext);
+}
+
+-(instancetype) init
+{
+    return [self initWithByteBudget:kDefaultByteBudget];
+}
+
+-(instancetype) initWithByteBudget:(NSUInteger)byteBudget
+{
+    if(nil != (self = [super init]))
+    {
+        _byteBudget = byteBudget;
+        _entries = [[NSMutableDictionary alloc] init];
+        _pending = [[NSMutableDictionary alloc] init];
+        _failed = [[NSMutableDictionary alloc] init];
+        _rendererIdentities = [NSMapTable weakToStrongObjectsMapTable];
+        _documentGenerations = [[NSMutableDictionary alloc] init];
+#if !TARGET_OS_OSX
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(removeAllImages)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+#endif
+    }
+    return self;
+}
+
+-(NSUInteger) byteBudget
+{
+    @synchronized(self)
+    {
+        return _byteBudget;
+    }
+}
+
+-(void) setByteBudget:(NSUInteger)byteBudget
+{
+    @synchronized(self)
+    {
+        _byteBudget = byteBudget;
+        [self evictToBudget];
+    }
+}
+
+-(NSUInteger) totalBytes
+{
+    @synchronized(self)
+    {
+        return _totalBytes;
+    }
+}
+
+-(NSUInteger) hitCount
+{
+    @synchronized(self)
+    {
+        return _hitCount;
+    }
+}
+
+-(NSUInteger) missCount
+{
+    @synchronized(self)
+    {
+        return _missCount;
+    }
+}
+
+-(double) hitRate
+{
+    double result = 0.0;
+    @synchronized(self)
+    {
+        NSUInteger requestCount = _hitCount+_missCount;
+        if(requestCount > 0)
+        {
+            result = (double)_hitCount/(double)requestCount;
+        }
+    }
+    return result;
+}
+
+-(void) resetStatistics
+{
+    @synchronized(self)
+    {
+        _hitCount = 0;
+        _missCount = 0;
+    }
+}
+
+-(void) removeAllImages
+{
+    @synchronized(self)
+    {
+        while(_mostRecent != nil)
+        {
+            [self removeEntry:_mostRecent];
+        }
+        [_failed removeAllObjects];
+    }
+}
+
+-(void) removeImagesForRenderer:(SVGRenderer*)renderer
+{
+    @synchronized(self)
+    {
+        NSString* document = [_rendererIdentities objectForKey:renderer];
+        if(document != nil)
+        {
+            _documentGenerations[document] = @(_documentGenerations[document].unsignedIntegerValue+1);
+            for(GHRasterCacheKey* aKey in _pending.allKeys)
+            {// whatever is being rendered was recorded from the old document, the next request starts afresh
+                if([aKey.document isEqualToString:document])
+                {
+                    [_pending removeObjectForKey:aKey];
+                }
+            }
+            for(GHRasterCacheKey* aKey in _entries.allKeys)
+            {
+                if([aKey.document isEqualToString:document])
+                {
+                    [self removeEntry:_entries[aKey]];
+                }
+            }
+            for(GHRasterCacheKey* aKey in _failed.allKeys)
+            {// the changed document might render now
+                if([aKey.document isEqualToString:document])
+                {
+                    [_failed removeObjectForKey:aKey];
+                }
+            }
+        }
+    }
+}
+
+-(BOOL) canCacheImageWithPixelSize:(CGSize)pixelSize
+{
+    double cost = 4.0*ceil(pixelSize.width)*ceil(pixelSize.height);
+    return cost > 0.0 && cost <= self.byteBudget;
+}
+
+#pragma mark recently used list, call only while synchronized
+
+-(void) unlinkEntry:(GHRasterCacheEntry*)anEntry
+{
+    GHRasterCacheEntry* previous = anEntry.previous;
+    GHRasterCacheEntry* next = anEntry.next;
+    if(previous == nil)
+    {
+        _mostRecent = next;
+    }
+    else
+    {
+        previous.next = next;
+    }
+    if(next == nil)
+    {
+        _leastRecent = previous;
+    }
+    else
+    {
+        next.previous = previous;
+    }
+    anEntry.next = nil;
+    anEntry.previous = nil;
+}
+
+-(void) linkEntryAsMostRecent:(GHRasterCacheEntry*)anEntry
+{
+    anEntry.next = _mostRecent;
+    _mostRecent.previous = anEntry;
+    _mostRecent = anEntry;
+    if(_leastRecent == nil)
+    {
+        _leastRecent = anEntry;
+    }
+}
+
+-(void) removeEntry:(GHRasterCacheEntry*)anEntry
+{
+    [self unlinkEntry:anEntry];
+    [_entries removeObjectForKey:anEntry.key];
+    _totalBytes -= anEntry.cost;
+}
+
+-(void) evictToBudget
+{
+    while(_totalBytes > _byteBudget && _leastRecent != nil)
+    {
+        [self removeEntry:_leastRecent];
+    }
+}
+
+-(void) removeExpiredFailures
+{// otherwise failures for keys never asked for again would pile up
+    for(GHRasterCacheKey* aKey in _failed.allKeys)
+    {
+        if(-_failed[aKey].timeIntervalSinceNow >= kFailedRenderRetryInterval)
+        {
+            [_failed removeObjectForKey:aKey];
+        }
+    }
+}
+
+-(void) addImage:(CGImageRef)image forKey:(GHRasterCacheKey*)key
+{
+    GHRasterCacheEntry* oldEntry = _entries[key];
+    if(oldEntry != nil)
+    {
+        [self removeEntry:oldEntry];
+    }
+    GHRasterCacheEntry* newEntry = [[GHRasterCacheEntry alloc] initWithKey:key image:image];
+    if(newEntry.cost <= _byteBudget)
+    {
+        _entries[key] = newEntry;
+        [self linkEntryAsMostRecent:newEntry];
+        _totalBytes += newEntry.cost;
+        [self evictToBudget];
+    }
+}
+
+#pragma mark lookups
+
+/*! @brief answer from the cache, or start rendering
+* @param key what to look for
+* @param whenCached callback for a miss
+* @param prepareBlock called on the calling thread only if rendering has to start, returns what will make the image on the rendererQueue
+* @return a retained image on a hit, NULL otherwise
+*/
+-(CGImageRef) copyImageForKey:(GHRasterCacheKey*)key whenCached:(handleRasterCached_t)whenCached
+                    preparing:(GHRasterRender_t (^)(void))prepareBlock CF_RETURNS_RETAINED
+{
+    CGImageRef result = NULL;
+    BOOL startRendering = NO;
+    NSMutableArray<handleRasterCached_t>* waiting = nil;
+    NSUInteger documentGeneration = 0;
+    @synchronized(self)
+    {
+        GHRasterCacheEntry* anEntry = _entries[key];
+        if(anEntry != nil)
+        {
+            _hitCount++;
+            [self unlinkEntry:anEntry];
+            [self linkEntryAsMostRecent:anEntry];
+            result = CGImageRetain(anEntry.image);
+        }
+        else if(_failed[key] != nil && -_failed[key].timeIntervalSinceNow < kFailedRenderRetryInterval)
+        {// trying again so soon would only fail again
+            _missCount++;
+        }
+        else
+        {
+            _missCount++;
+            [_failed removeObjectForKey:key];
+            waiting = _pending[key];
+            if(waiting == nil)
+            {// nobody is rendering this yet
+                waiting = [[NSMutableArray alloc] init];
+                _pending[key] = waiting;
+                documentGeneration = _documentGenerations[key.document].unsignedIntegerValue; // taken before the document is recorded
+                startRendering = YES;
+            }
+            if(whenCached != nil)
+            {
+                [waiting addObject:[whenCached copy]];
+            }
+        }
+    }
+    
+    if(startRendering)
+    {
+        GHRasterRender_t renderBlock = prepareBlock();
+        [[SVGRenderer rendererQueue] addOperationWithBlock:^{
+            CGImageRef image = renderBlock();
+            NSArray<handleRasterCached_t>* callbacks = nil;
+            @synchronized(self)
+            {
+                callbacks = [waiting copy];
+                if(self->_pending[key] == waiting)
+                {
+                    [self->_pending removeObjectForKey:key];
+                }
+                if(self->_documentGenerations[key.document].unsignedIntegerValue != documentGeneration)
+                {// the document changed while this was rendering, don't cache or hand out what it looked like before
+                    CGImageRelease(image);
+                    image = NULL;
+                }
+                else if(image != NULL)
+                {
+                    [self addImage:image forKey:key];
+                }
+                else
+                {
+                    [self removeExpiredFailures];
+                    self->_failed[key] = [NSDate date];
+                }
+            }
+            id imageObject = (__bridge_transfer id)image;
+            if(callbacks.count)
+            {// waiters hear about failures too, so none is left waiting
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    for(handleRasterCached_t aCallback in callbacks)
+                    {
+                        aCallback((__bridge CGImageRef)imageObject);
+                    }
+                });
+            }
+        }];
+    }
+    return result;
+}
+
+-(NSString*) documentIdentityOfRenderer:(SVGRenderer*)renderer
+{
+    NSString* result = nil;
+    @synchronized(self)
+    {// renderers have no name of their own, and may be made from a string
+        result = [_rendererIdentities objectForKey:renderer];
+        if(result == nil)
+        {
+            result = [NSString stringWithFormat:@"<renderer %@>", [NSUUID UUID].UUIDString];
+            [_rendererIdentities setObject:result forKey:renderer];
+        }
+    }
+    return result;
+}
+
+-(CGImageRef) copyImageForRenderer:(SVGRenderer*)renderer fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                      currentColor:(UIColor*)currentColor whenCached:(handleRasterCached_t)whenCached
+{
+    CSSPseudoClassFlags pseudoClass = renderer.cssPseudoClass;
+    GHRasterCacheKey* key = [[GHRasterCacheKey alloc] initWithDocument:[self documentIdentityOfRenderer:renderer] bundle:nil fittingSize:maximumSize scale:scale
+                                                          currentColor:currentColor pseudoClass:pseudoClass centered:NO];
+    return [self copyImageForKey:key whenCached:whenCached preparing:^GHRasterRender_t{
+        // recorded here, so the style sheet is matched on this thread and later changes to the renderer can't reach the image
+        GHDisplayList* displayList = [renderer newDisplayListWithCurrentColor:currentColor];
+        return ^CGImageRef{
+            return [renderer newImageWithSize:maximumSize scale:scale currentColor:currentColor displayList:displayList];
+        };
+    }];
+}
+
+-(CGImageRef) copyImageForArtworkPath:(NSString*)artworkPath inBundle:(NSBundle*)bundle size:(CGSize)size scale:(CGFloat)scale
+                         currentColor:(UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass centered:(BOOL)centered
+                           whenCached:(handleRasterCached_t)whenCached
+{// the same path may name different artwork in different bundles
+    GHRasterCacheKey* key = [[GHRasterCacheKey alloc] initWithDocument:artworkPath bundle:bundle fittingSize:size scale:scale
+                                                          currentColor:currentColor pseudoClass:pseudoClass centered:centered];
+    return [self copyImageForKey:key whenCached:whenCached preparing:^GHRasterRender_t{
+        return ^CGImageRef{// a renderer of its own, nothing else can be drawing it
+            SVGRenderer* renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:artworkPath inBundle:bundle];
+            renderer.cssPseudoClass = pseudoClass;
+            return centered ? [renderer newImageCenteredInSize:size scale:scale currentColor:currentColor]
+                            : [renderer newImageWithSize:size scale:scale currentColor:currentColor];
+        };
+    }];
+}
+
+-(CGImageRef) copyImageForArtworkPath:(NSString*)artworkPath inBundle:(NSBundle*)bundle fittingSize:(CGSize)maximumSize scale:(CGFloat)scale
+                         currentColor:(UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass
+                           whenCached:(handleRasterCached_t)whenCached
+{
+    return [self copyImageForArtworkPath:artworkPath inBundle:bundle size:maximumSize scale:scale
+                            currentColor:currentColor pseudoClass:pseudoClass centered:NO whenCached:whenCached];
+}
+
+-(CGImageRef) copyImageForArtworkPath:(NSString*)artworkPath inBundle:(NSBundle*)bundle centeredInSize:(CGSize)size scale:(CGFloat)scale
+                         currentColor:(UIColor*)currentColor pseudoClass:(CSSPseudoClassFlags)pseudoClass
+                           whenCached:(handleRasterCached_t)whenCached
+{
+    return [self copyImageForArtworkPath:artworkPath inBundle:bundle size:size scale:scale
+                            currentColor:currentColor pseudoClass:pseudoClass centered:YES whenCached:whenCached];
+}
+
+@end
@@ -23,7 +23,8 @@ typedef NS_ENUM(NSInteger, SVGghLoaderType)
 {
     SVGghLoaderTypeDefault,
     SVGghLoaderTypePath,
-    SVGghLoaderTypeDataXCAsset // only available on iOS 9 or above
+    SVGghLoaderTypeDataXCAsset, // only available on iOS 9 or above
+    SVGghLoaderTypeBinary // looks for a precompiled .svgb resource first, then falls back to the .svg
 };
 
 
@@ -19,6 +19,10 @@ static id<SVGghLoader> gLoader = nil;
 
 @end
 
+@interface SVGghBinaryLoader : NSObject<SVGghLoader>
+
+@end
+
 @implementation SVGghLoaderManager
 
 
@@ -76,6 +80,9 @@ static id<SVGghLoader> gLoader = nil;
             }
         }
         break;
+        case SVGghLoaderTypeBinary:
+            [self setLoader:[SVGghBinaryLoader new]];
+        break;
     }
 }
 
@@ -99,3 +106,27 @@ static id<SVGghLoader> gLoader = nil;
 }
 
 @end
+
+@implementation SVGghBinaryLoader
+
+-(nullable SVGRenderer*) loadRenderForSVGIdentifier:(NSString*)identifier inBundle:(NSBundle*)bundle
+{
+    SVGRenderer* result = nil;
+    NSBundle* bundleToUse = (bundle == nil)? [NSBundle mainBundle] : bundle;
+    NSURL* binaryURL = [bundleToUse URLForResource:identifier.stringByDeletingPathExtension withExtension:@"svgb"];
+    if(binaryURL != nil)
+    {
+        result = [[SVGRenderer alloc] initWithContentsOfURL:binaryURL];
+        if(result.parserError != nil)
+        {
+            result = nil;
+        }
+    }
+    if(result == nil)
+    {
+        result = [[SVGRenderer alloc] initWithResourceName:identifier inBundle:bundle];
+    }
+    return result;
+}
+
+@end
@@ -31,6 +31,7 @@
 #import "GHControlFactory.h"
 #import "SVGRenderer.h"
 #import "SVGghLoader.h"
+#import "GHRasterCache.h"
 
 
 @interface KeyboardPressedPopup : UIView
@@ -57,6 +58,18 @@
 
 @end
 
+/*! @brief draw artwork from the raster cache, rendered centered in the interior rect just as drawArtWithRenderer: fits the document into it
+*/
+static void DrawCachedArtwork(CGImageRef artwork, CGRect interiorRect, CGFloat scale, CGContextRef quartzContext)
+{
+    CGRect artworkRect = CGRectMake(interiorRect.origin.x, interiorRect.origin.y,
+                                    CGImageGetWidth(artwork)/scale, CGImageGetHeight(artwork)/scale); // the bitmap was rounded up to whole pixels
+    CGContextSaveGState(quartzContext);
+    CGContextClipToRect(quartzContext, interiorRect);
+    [GHRasterCache drawImage:artwork inRect:artworkRect intoContext:quartzContext];
+    CGContextRestoreGState(quartzContext);
+}
+
 @implementation GHButtonLayer
 
 -(void) layoutSublayers
@@ -574,61 +587,70 @@
     CGContextRestoreGState(quartzContext);
 }
 
--(void) drawArtWithRenderer:(SVGRenderer*)renderer  intoContext:(CGContextRef)quartzContext bounds:(CGRect)bounds
+-(UIColor*) artworkCurrentColor
 {
-    if(renderer != nil)
+    BOOL    inNormalMode = !(self.isSelected || self.isHighlighted);
+    
+    UIColor* result = nil;
+    
+    if(inNormalMode)
     {
-        CGContextSaveGState(quartzContext);
-        
-        BOOL    inNormalMode = !(self.isSelected || self.isHighlighted);
-        
-        UIColor* currentColor = nil;
-        
-        if(inNormalMode)
+        result = self.textColor;
+    }
+    else
+    {
+        result = self.textColorPressed;
+    }
+    
+    if(!self.enabled)
+    {
+        result = self.textColorDisabled;
+    }
+    return result;
+}
+
+-(CGRect) artworkInteriorRectForBounds:(CGRect)bounds
+{
+    CGFloat inset = self.artInsetFraction*bounds.size.height;
+    CGRect result = CGRectZero;
+    if(inset == 0)
+    {
+        inset = kRingThickness;
+        if(self.drawsChrome)
         {
-            currentColor = self.textColor;
+            inset += 5;
         }
-        else
+        if(self.useRadialGradient || !self.drawsChrome)
         {
-            currentColor = self.textColorPressed;
+            result = bounds;
         }
-        
-        if(!self.enabled)
+        else if(self.textLabel.text)
         {
-            currentColor = self.textColorDisabled;
-        }
-        
-        renderer.currentColor = currentColor;
-        
-        CGFloat inset = self.artInsetFraction*bounds.size.height;
-        CGRect interiorRect = CGRectZero;
-        if(inset == 0)
-        {
-            inset = kRingThickness;
-            if(self.drawsChrome)
-            {
-                inset += 5;
-            }
-            if(self.useRadialGradient || !self.drawsChrome)
-            {
-                interiorRect = bounds;
-            }
-            else if(self.textLabel.text)
-            {
-                interiorRect = CGRectMake(bounds.origin.x+inset, bounds.origin.y+inset, bounds.size.width-2*inset, bounds.size.height-inset);
-            }
-            else
-            {
-                interiorRect = CGRectInset(bounds, inset, inset);
-            }
-            
+            result = CGRectMake(bounds.origin.x+inset, bounds.origin.y+inset, bounds.size.width-2*inset, bounds.size.height-inset);
         }
         else
         {
-            inset = floor(inset);
-            interiorRect = CGRectInset(bounds, inset, inset);
+            result = CGRectInset(bounds, inset, inset);
         }
         
+    }
+    else
+    {
+        inset = floor(inset);
+        result = CGRectInset(bounds, inset, inset);
+    }
+    return result;
+}
+
+-(void) drawArtWithRenderer:(SVGRenderer*)renderer  intoContext:(CGContextRef)quartzContext bounds:(CGRect)bounds
+{
+    if(renderer != nil)
+    {
+        CGContextSaveGState(quartzContext);
+        
+        renderer.currentColor = [self artworkCurrentColor];
+        
+        CGRect interiorRect = [self artworkInteriorRectForBounds:bounds];
         
         CGContextClipToRect(quartzContext, interiorRect);
         
@@ -682,7 +704,30 @@
     SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:[GHButton placeHolderSVG]];
     
 #else
-    SVGRenderer* renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+    CGRect interiorRect = [self artworkInteriorRectForBounds:bounds];
+    CALayer* contentLayer = (self.contentLayer != nil) ? self.contentLayer : self.layer;
+    CGFloat scale = contentLayer.contentsScale;
+    GHRasterCache* rasterCache = [GHRasterCache sharedCache];
+    SVGRenderer* renderer = nil;
+    if([rasterCache canCacheImageWithPixelSize:CGSizeMake(interiorRect.size.width*scale, interiorRect.size.height*scale)])
+    {// the same artwork is typically on many buttons, or redrawn as this one is pressed and released
+        CGImageRef artwork = [rasterCache copyImageForArtworkPath:theArtworkPath inBundle:nil centeredInSize:interiorRect.size scale:scale
+                                                     currentColor:[self artworkCurrentColor] pseudoClass:kPseudoClassNone
+                                                       whenCached:nil];
+        if(artwork != NULL)
+        {
+            DrawCachedArtwork(artwork, interiorRect, scale, quartzContext);
+            CGImageRelease(artwork);
+        }
+        else
+        {// drawn directly this time, the cache has it for the next draw
+            renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+        }
+    }
+    else
+    {
+        renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+    }
 #endif
 
     
@@ -1043,7 +1088,35 @@
 
 -(void)drawArtworkAtPath:(NSString*)theArtworkPath intoContext:(CGContextRef)quartzContext
 {
-    SVGRenderer* renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+    CGRect parentRect = [self convertRect:self.parent.bounds fromView:self.parent];
+    CGRect contentRect = self.bounds;
+    contentRect.size.height = parentRect.origin.y;
+    // make room for the chrome
+    CGRect interiorRect = self.parent.useRadialGradient?contentRect:CGRectInset(contentRect, kRingThickness, kRingThickness);
+    interiorRect = CGRectInset(interiorRect, 5, 5);
+    
+    CGFloat scale = self.contentScaleFactor;
+    GHRasterCache* rasterCache = [GHRasterCache sharedCache];
+    SVGRenderer* renderer = nil;
+    if([rasterCache canCacheImageWithPixelSize:CGSizeMake(interiorRect.size.width*scale, interiorRect.size.height*scale)])
+    {
+        CGImageRef artwork = [rasterCache copyImageForArtworkPath:theArtworkPath inBundle:nil centeredInSize:interiorRect.size scale:scale
+                                                     currentColor:self.parent.textColor pseudoClass:kPseudoClassNone
+                                                       whenCached:nil];
+        if(artwork != NULL)
+        {
+            DrawCachedArtwork(artwork, interiorRect, scale, quartzContext);
+            CGImageRelease(artwork);
+        }
+        else
+        {// the popup is only up briefly, so draw it directly rather than wait
+            renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+        }
+    }
+    else
+    {
+        renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:theArtworkPath inBundle:nil];
+    }
     
     if(renderer != nil)
     {
@@ -1051,12 +1124,6 @@
         
         renderer.currentColor = self.parent.textColor;
         
-        CGRect parentRect = [self convertRect:self.parent.bounds fromView:self.parent];
-        CGRect contentRect = self.bounds;
-        contentRect.size.height = parentRect.origin.y;
-        // make room for the chrome
-        CGRect interiorRect = self.parent.useRadialGradient?contentRect:CGRectInset(contentRect, kRingThickness, kRingThickness);
-        interiorRect = CGRectInset(interiorRect, 5, 5);
         CGContextClipToRect(quartzContext, interiorRect);
         CGRect viewRect = renderer.viewRect;
         CGFloat interiorAspectRatio = interiorRect.size.width/interiorRect.size.height;
@@ -124,6 +124,7 @@ typedef enum GHSegmentType
             contentLayer.renderer = segmentView.segmentDefinition.renderer;
             contentLayer.contentsGravity = kCAGravityResizeAspect;
             contentLayer.defaultColor = segmentView.currentColor;
+            contentLayer.drawsFromRasterCache = YES; // segments are redrawn in a handful of colors as they're pressed and selected
             [self addSublayer:contentLayer];
             self.contentLayer = contentLayer;
         }
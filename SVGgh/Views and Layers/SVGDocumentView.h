@@ -87,11 +87,23 @@ IB_DESIGNABLE // Cocapods users should add the use_frameworks! directive if this
  */
 @property(nonatomic, assign) IBInspectable   BOOL beTransparent;
 
+/*! @property drawsFromRasterCache
+ * @brief draw a cached bitmap of the document rather than rendering it each time, for artwork that doesn't change in place
+ * @see GHRasterCache
+ */
+@property(nonatomic, assign) IBInspectable   BOOL drawsFromRasterCache;
+
 /*! @brief method that tries to locate an object located at the given point inside the coordinate system of the view
 * @param testPoint a point in the coordinate system of the view
 * @return an object hit by the point
 */
 -(nullable id<GHRenderable>) findRenderableObject:(CGPoint)testPoint;
+
+/*! @brief redraw only the part of the view an object covers, as after highlighting a tapped object
+* @param anObject an object in the renderer's document
+* @note where the object was when found by findRenderableObject: is redrawn too, for an object found some other way call this before changing it as well as after
+*/
+-(void) setNeedsDisplayForObject:(id<GHRenderable>)anObject;
 +(void)makeSureLoaded;
 @end
 
@@ -58,6 +58,11 @@
 	return result;
 }
 
+-(void) setNeedsDisplayForObject:(id<GHRenderable>)anObject
+{
+    [[self renderingLayer] setNeedsDisplayForObject:anObject];
+}
+
 -(void) setDefaultColor:(UIColor *)defaultColor
 {
     _defaultColor = defaultColor;
@@ -84,6 +89,16 @@
     return [self renderingLayer].beTransparent;
 }
 
+-(void) setDrawsFromRasterCache:(BOOL)drawsFromRasterCache
+{
+    [self renderingLayer].drawsFromRasterCache = drawsFromRasterCache;
+}
+
+-(BOOL) drawsFromRasterCache
+{
+    return [self renderingLayer].drawsFromRasterCache;
+}
+
 -(void) setArtworkPath:(NSString *)artworkPath
 {
     [self setArtworkPath:artworkPath fromBundle:nil];
@@ -61,11 +61,25 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, assign) BOOL   beTransparent;
 
+/*! @property drawsFromRasterCache
+ * @brief draw from GHRasterCache's sharedCache, rendering on the rendererQueue when the image isn't there yet. For artwork that isn't changed in place, such as icons
+ * @note changes to the document should go through setNeedsDisplayForObject: which evicts the renderer's images
+ */
+@property(nonatomic, assign) BOOL   drawsFromRasterCache;
+
 /*! @brief method that tries to locate an object located at the given point inside the coordinate system of the layer
  * @param testPoint point in the coordinate system of the layer
  * @return an object hit by the point
  */
 -(nullable id<GHRenderable>) findRenderableObject:(CGPoint)testPoint;
+
+/*! @brief redraw just the part of the layer an object covers, as after highlighting it by changing its style. The draw only replays what falls inside the dirty rect
+ * @param anObject an object in the renderer's document, such as one returned by findRenderableObject:
+ * @note the layer remembers an object's bounds from findRenderableObject: and from the last call here, and redraws those too, so an object that moved or shrank is cleared from where it was. For an object that came from anywhere else, call this once before changing it as well as after
+ * @note falls back to redrawing the whole layer if the object's bounds can't be worked out
+ * @note also invalidates the renderer's display list and hit testing, so changes beyond an object's transform and fillColor are picked up
+ */
+-(void) setNeedsDisplayForObject:(id<GHRenderable>)anObject;
 @end
 
 @interface CALayer(GH_Utilities)
@@ -27,9 +27,17 @@
 
 #import "SVGRendererLayer.h"
 #import "SVGUtilities.h"
+#import "GHRasterCache.h"
+
+@interface SVGRendererLayer ()
+// document bounds of objects as they were when last hit or invalidated, so moving one also clears where it was
+@property(nonatomic, strong) NSMapTable<id<GHRenderable>, NSValue*>* knownObjectBounds;
+@end
 
 @interface SVGRendererLayer (Private)
 -(CGRect) makeDrawingRect;
+-(CGAffineTransform) makeDocumentTransform;
+-(CGRect) rememberBoundsOfObject:(id<GHRenderable>)anObject;
 @end
 
 @implementation SVGRendererLayer(Private)
@@ -102,6 +110,42 @@
 	return result;
 }
 
+-(CGAffineTransform) makeDocumentTransform
+{// from the renderer's coordinates to the layer's, as drawInContext: sets up
+    CGRect drawRect = [self makeDrawingRect];
+    CGRect	preferredRect = self.renderer.viewRect;
+    if(CGRectIsEmpty(preferredRect))
+    {
+        preferredRect = drawRect;
+    }
+    CGAffineTransform result = CGAffineTransformMakeTranslation(drawRect.origin.x, drawRect.origin.y);
+    result = CGAffineTransformScale(result, drawRect.size.width/preferredRect.size.width, drawRect.size.height/preferredRect.size.height);
+    result = CGAffineTransformTranslate(result, -preferredRect.origin.x, -preferredRect.origin.y);
+    return result;
+}
+
+-(CGRect) rememberBoundsOfObject:(id<GHRenderable>)anObject
+{// returns the union of where the object was last seen and where it is now
+    CGRect result = [self.renderer drawnBoundsOfObject:anObject];
+    NSMapTable<id<GHRenderable>, NSValue*>* knownObjectBounds = self.knownObjectBounds;
+    NSValue* previousValue = [knownObjectBounds objectForKey:anObject];
+    if(CGRectIsNull(result) || CGRectIsInfinite(result))
+    {
+        [knownObjectBounds removeObjectForKey:anObject];
+    }
+    else
+    {
+        [knownObjectBounds setObject:[NSValue valueWithBytes:&result objCType:@encode(CGRect)] forKey:anObject];
+        if(previousValue != nil)
+        {
+            CGRect previousBounds = CGRectNull;
+            [previousValue getValue:&previousBounds];
+            result = CGRectUnion(result, previousBounds);
+        }
+    }
+    return result;
+}
+
 @end
 
 @implementation CALayer(GH_Utilities)
@@ -170,14 +214,48 @@
 	CGPoint transformedPoint = CGPointApplyAffineTransform(testPoint,pointTransformer);
 	
 	id<GHRenderable> result = [self.renderer findRenderableObject:transformedPoint];
+    if(result != nil)
+    {// likely about to be changed, note where it is now
+        [self rememberBoundsOfObject:result];
+    }
 	return result;
 }
 
+-(NSMapTable<id<GHRenderable>, NSValue*>*) knownObjectBounds
+{
+    if(_knownObjectBounds == nil)
+    {
+        _knownObjectBounds = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return _knownObjectBounds;
+}
+
+-(void) setNeedsDisplayForObject:(id<GHRenderable>)anObject
+{
+    [self.renderer invalidateDisplayList]; // whatever changed, the next draw and hit test walk the document again
+    if(self.drawsFromRasterCache && self.renderer != nil)
+    {// the cached image no longer matches the document
+        [[GHRasterCache sharedCache] removeImagesForRenderer:self.renderer];
+    }
+    CGRect documentBounds = [self rememberBoundsOfObject:anObject];
+    if(CGRectIsNull(documentBounds) || CGRectIsInfinite(documentBounds))
+    {// a clone made for a use element, text or the like
+        [self setNeedsDisplay];
+    }
+    else
+    {
+        CGRect dirtyRect = CGRectApplyAffineTransform(documentBounds, [self makeDocumentTransform]);
+        dirtyRect = CGRectIntegral(CGRectInset(dirtyRect, -1.0, -1.0)); // antialiased edges
+        [self setNeedsDisplayInRect:dirtyRect];
+    }
+}
+
 -(void) setRenderer:(SVGRenderer *) newRenderer
 {
 	if(newRenderer != _renderer)
 	{
 		_renderer = newRenderer;
+        self.knownObjectBounds = nil;
 		[self setNeedsDisplay];
 	}
 }
@@ -297,13 +375,33 @@
 			}
 		}
         UIColor* startColor = self.renderer.currentColor;
-        if(self.defaultColor != nil)
-        {
-            self.renderer.currentColor = self.defaultColor;
+        CGFloat scale = self.contentsScale;
+        GHRasterCache* rasterCache = [GHRasterCache sharedCache];
+        BOOL drawnFromCache = NO;
+        if(self.drawsFromRasterCache && self.renderer != nil
+           && CGRectContainsRect(CGContextGetClipBoundingBox(quartzContext), preferredRect)
+           && [rasterCache canCacheImageWithPixelSize:CGSizeMake(drawRect.size.width*scale, drawRect.size.height*scale)])
+        {// a whole redraw, the partial ones of setNeedsDisplayForObject: are left to the renderer
+            CGImageRef bitmap = [rasterCache copyImageForRenderer:self.renderer fittingSize:drawRect.size scale:scale
+                                                     currentColor:(self.defaultColor != nil) ? self.defaultColor : startColor
+                                                       whenCached:nil];
+            if(bitmap != NULL)
+            {
+                [GHRasterCache drawImage:bitmap inRect:preferredRect intoContext:quartzContext];
+                CGImageRelease(bitmap);
+                drawnFromCache = YES;
+            }
+        }
+        if(!drawnFromCache)
+        {// on a miss too, the cache has the image for the next draw
+            if(self.defaultColor != nil)
+            {
+                self.renderer.currentColor = self.defaultColor;
+            }
+            
+            [self.renderer renderIntoContext:quartzContext];
+            self.renderer.currentColor = startColor;
         }
-        
-		[self.renderer renderIntoContext:quartzContext];
-        self.renderer.currentColor = startColor;
 		CGContextRestoreGState(quartzContext);
 	}
 }
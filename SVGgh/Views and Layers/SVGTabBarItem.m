@@ -10,10 +10,36 @@
 
 #import "SVGRenderer.h"
 #import "SVGghLoader.h"
+#import "GHRasterCache.h"
 
 
 @implementation SVGTabBarItem
 
+-(UIImage*) imageOfArtworkPath:(NSString*)artworkPath withSize:(CGSize)imageSize scale:(CGFloat)scale
+                  currentColor:(UIColor*)currentColor
+{
+    UIImage* result = nil;
+    GHRasterCache* rasterCache = [GHRasterCache sharedCache];
+    if([rasterCache canCacheImageWithPixelSize:CGSizeMake(imageSize.width*scale, imageSize.height*scale)])
+    {// tab bars tend to show the same few icons over and over
+        CGImageRef bitmap = [rasterCache copyImageForArtworkPath:artworkPath inBundle:nil fittingSize:imageSize scale:scale
+                                                    currentColor:currentColor pseudoClass:kPseudoClassNone
+                                                      whenCached:nil];
+        if(bitmap != NULL)
+        {
+            result = [UIImage imageWithCGImage:bitmap scale:scale orientation:UIImageOrientationUp];
+            CGImageRelease(bitmap);
+        }
+    }
+    if(result == nil)
+    {// not cached yet, or too big to be, a tab bar item needs its image now
+        SVGRenderer* renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:artworkPath inBundle:nil];
+        renderer.currentColor = currentColor;
+        result = [renderer asImageWithSize:imageSize andScale:scale];
+    }
+    return result;
+}
+
 -(void) updateImagesForcingImage:(BOOL)forceNewImage forcingSelectedImage:(BOOL) forceNewSelectedImage
 {
     CGFloat scale =  [[UIScreen mainScreen] scale];
@@ -29,12 +55,10 @@
     
     if((startingImage == nil || forceNewImage) && self.artworkPath.length)
     {
-        SVGRenderer* renderer = [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:self.artworkPath inBundle:nil];
-        
-        if(renderer != nil)
+        UIImage* image = [self imageOfArtworkPath:self.artworkPath withSize:imageSize scale:scale
+                                     currentColor:self.nominalBaseColor];
+        if(image != nil)
         {// draw my SVG
-            renderer.currentColor = self.nominalBaseColor;
-            UIImage* image = [renderer asImageWithSize:imageSize andScale:scale];
             if(self.nominalBaseColor != nil)
             {
                 image = [image imageWithRenderingMode:UIImageRenderingModeAlwaysOriginal];
@@ -54,11 +78,10 @@
         }
         if(artworkPathToUse.length)
         {
-            SVGRenderer* renderer =  [[SVGghLoaderManager loader] loadRenderForSVGIdentifier:artworkPathToUse inBundle:nil];
-            if(renderer != nil)
+            UIImage* image = [self imageOfArtworkPath:artworkPathToUse withSize:imageSize scale:scale
+                                         currentColor:selectedColor];
+            if(image != nil)
             {
-                renderer.currentColor = selectedColor;
-                UIImage* image = [renderer asImageWithSize:imageSize andScale:scale];
                 if(selectedColor != nil)
                 {
                     image = [image imageWithRenderingMode:UIImageRenderingModeAlwaysOriginal];
@@ -0,0 +1,184 @@
+//
+//  SVGRasterizerTests.c
+//  SVGgh
+// The MIT License (MIT)
+
+//  Copyright (c) 2026 Glenn R. Howes
+
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//  Created by Glenn Howes on 10/17/26.
+
+
+
+
+// The software rasterizer needs only the C library, so it is tested here outside of Xcode as well,
+// with nothing but a C compiler: cmake -S SVGghTests/RasterTests -B build && cmake --build build && ctest --test-dir build
+
+#include "SVGRasterizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int sFailures = 0;
+
+#define CHECK(condition, message) do { if(!(condition)) { fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, message); sFailures++; } } while(0)
+
+static const uint8_t* PixelAt(const SVGRasterContext* context, size_t x, size_t y)
+{// y counts down from the top, as the pixels are stored
+    return SVGRasterContextGetPixels(context)+y*SVGRasterContextGetBytesPerRow(context)+4*x;
+}
+
+static SVGRasterContext* NewFlippedContext(size_t width, size_t height)
+{// drawn with y down, as SVG and UIKit expect
+    SVGRasterContext* result = SVGRasterContextCreate(width, height);
+    const double flip[6] = {1.0, 0.0, 0.0, -1.0, 0.0, (double)height};
+    SVGRasterDrawingBackend()->concatTransform(result, flip);
+    return result;
+}
+
+static void SetSolidFill(SVGRasterContext* context, float red, float green, float blue, float alpha)
+{
+    SVGDrawingPaint paint;
+    memset(&paint, 0, sizeof(paint));
+    paint.type = kSVGDrawingPaintSolid;
+    paint.color[0] = red; paint.color[1] = green; paint.color[2] = blue; paint.color[3] = alpha;
+    SVGRasterDrawingBackend()->setFillPaint(context, &paint);
+}
+
+static void DrawSVGPath(SVGRasterContext* context, const char* pathString, SVGDrawingMode mode)
+{
+    SVGPathBuffer path;
+    SVGPathBufferInit(&path);
+    SVGPathBufferAppendSVGPath(&path, pathString, strlen(pathString));
+    SVGRasterDrawingBackend()->drawPath(context, &path, mode);
+    SVGPathBufferFree(&path);
+}
+
+static void TestFills(void)
+{
+    SVGRasterContext* context = NewFlippedContext(20, 20);
+    CHECK(context != NULL, "context");
+    CHECK(SVGRasterContextGetWidth(context) == 20 && SVGRasterContextGetHeight(context) == 20, "size");
+    CHECK(PixelAt(context, 10, 10)[3] == 0, "starts transparent");
+    
+    SetSolidFill(context, 1.0f, 0.0f, 0.0f, 1.0f);
+    DrawSVGPath(context, "M1 1H9V9H1ZM3 3V7H7V3Z", kSVGDrawingEOFill);
+    CHECK(PixelAt(context, 1, 1)[0] == 255 && PixelAt(context, 1, 1)[3] == 255, "filled");
+    CHECK(PixelAt(context, 5, 5)[3] == 0, "the even-odd hole");
+    CHECK(PixelAt(context, 0, 0)[3] == 0 && PixelAt(context, 9, 9)[3] == 0, "nothing outside");
+    
+    DrawSVGPath(context, "M11 1H19V9H11ZM13 3H17V7H13Z", kSVGDrawingFill);
+    CHECK(PixelAt(context, 15, 5)[3] == 255, "nonzero fills the same winding inner square");
+    
+    DrawSVGPath(context, "M1 11H2.5V12H1Z", kSVGDrawingFill);
+    const uint8_t* half = PixelAt(context, 2, 11);
+    CHECK(half[3] >= 126 && half[3] <= 129, "half a pixel covered is half opaque");
+    CHECK(half[0] == half[3], "premultiplied");
+    SVGRasterContextFree(context);
+}
+
+static void TestCompositing(void)
+{// odd widths so spans end with pixels the vector loop leaves to the scalar one
+    for(size_t width = 1; width <= 9; width++)
+    {
+        SVGRasterContext* context = NewFlippedContext(width, 1);
+        char pathString[64];
+        snprintf(pathString, sizeof(pathString), "M0 0H%zuV1H0Z", width);
+        SetSolidFill(context, 0.0f, 0.0f, 1.0f, 1.0f);
+        DrawSVGPath(context, pathString, kSVGDrawingFill);
+        SetSolidFill(context, 1.0f, 0.0f, 0.0f, 0.5f);
+        DrawSVGPath(context, pathString, kSVGDrawingFill);
+        for(size_t x = 0; x < width; x++)
+        {
+            const uint8_t* pixel = PixelAt(context, x, 0);
+            CHECK(pixel[0] >= 127 && pixel[0] <= 128, "half red over");
+            CHECK(pixel[2] >= 127 && pixel[2] <= 128, "half the blue beneath");
+            CHECK(pixel[3] == 255, "opaque");
+            CHECK(memcmp(pixel, PixelAt(context, 0, 0), 4) == 0, "every pixel of a span blends alike");
+        }
+        SVGRasterContextFree(context);
+    }
+}
+
+static void TestStrokeAndClip(void)
+{
+    const SVGDrawingBackend* backend = SVGRasterDrawingBackend();
+    SVGRasterContext* context = NewFlippedContext(20, 20);
+    SVGDrawingPaint paint;
+    memset(&paint, 0, sizeof(paint));
+    paint.type = kSVGDrawingPaintSolid;
+    paint.color[1] = 1.0f; paint.color[3] = 1.0f;
+    backend->setStrokePaint(context, &paint);
+    backend->setLineWidth(context, 2.0);
+    DrawSVGPath(context, "M0 5H20", kSVGDrawingStroke);
+    CHECK(PixelAt(context, 10, 4)[1] == 255 && PixelAt(context, 10, 5)[1] == 255, "a 2 wide stroke centered on a pixel boundary covers both rows");
+    CHECK(PixelAt(context, 10, 3)[3] == 0 && PixelAt(context, 10, 6)[3] == 0, "and no more");
+    
+    backend->saveState(context);
+    backend->clipToRect(context, 0.0, 10.0, 10.0, 10.0);
+    SetSolidFill(context, 0.0f, 0.0f, 1.0f, 1.0f);
+    DrawSVGPath(context, "M0 10H20V20H0Z", kSVGDrawingFill);
+    backend->restoreState(context);
+    CHECK(PixelAt(context, 5, 15)[2] == 255, "inside the clip");
+    CHECK(PixelAt(context, 15, 15)[3] == 0, "outside the clip");
+    
+    backend->setAlpha(context, 0.5);
+    backend->beginLayer(context);
+    SetSolidFill(context, 1.0f, 0.0f, 0.0f, 1.0f);
+    DrawSVGPath(context, "M10 10H20V20H10Z", kSVGDrawingFill);
+    DrawSVGPath(context, "M10 10H20V20H10Z", kSVGDrawingFill);
+    backend->endLayer(context);
+    const uint8_t* layered = PixelAt(context, 15, 15);
+    CHECK(layered[3] >= 127 && layered[3] <= 128, "a layer is composited once, with the alpha in effect when it began");
+    SVGRasterContextFree(context);
+}
+
+static void TestGradient(void)
+{
+    SVGRasterContext* context = NewFlippedContext(20, 4);
+    SVGDrawingGradientStop stops[2] = {{0.0f, 0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f}};
+    SVGDrawingPaint paint;
+    memset(&paint, 0, sizeof(paint));
+    paint.type = kSVGDrawingPaintLinearGradient;
+    paint.stops = stops;
+    paint.stopCount = 2;
+    paint.end[0] = 20.0;
+    paint.extendStart = paint.extendEnd = 1;
+    paint.transform[0] = paint.transform[3] = 1.0;
+    SVGRasterDrawingBackend()->setFillPaint(context, &paint);
+    DrawSVGPath(context, "M0 0H20V4H0Z", kSVGDrawingFill);
+    CHECK(PixelAt(context, 1, 2)[0] < 40, "dark at the gradient's start");
+    CHECK(PixelAt(context, 18, 2)[0] > 215, "light at its end");
+    CHECK(PixelAt(context, 10, 2)[3] == 255, "opaque throughout");
+    SVGRasterContextFree(context);
+}
+
+int main(void)
+{
+    TestFills();
+    TestCompositing();
+    TestStrokeAndClip();
+    TestGradient();
+    if(sFailures)
+    {
+        fprintf(stderr, "%d failed\n", sFailures);
+    }
+    return sFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+//
+//  SVGNumberScannerBenchmark.m
+//  SVGgh
+//
+//  Created by Glenn Howes on 10/17/26.
+//  Copyright © 2026 Generally Helpful. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "SVGNumberScanner.h"
+
+// throughput of the number scanner on its own, compared against the strtod loop it replaced.
+// the text is the sort of thing an illustration program exports, 2 decimals, a few integers, the odd exponent
+@interface SVGNumberScannerBenchmark : XCTestCase
+@property(nonatomic, strong) NSData* numberText;
+@property(nonatomic, assign) NSUInteger numberCount;
+@end
+
+@implementation SVGNumberScannerBenchmark
+
+- (void)setUp {
+    [super setUp];
+    NSMutableData* mutableText = [[NSMutableData alloc] initWithCapacity:4*1024*1024];
+    const NSUInteger numberCount = 400000;
+    srand48(42);
+    for(NSUInteger index = 0; index < numberCount; index++)
+    {
+        char aNumber[32];
+        int numberLength = 0;
+        switch(index % 8)
+        {
+            case 0:
+                numberLength = snprintf(aNumber, sizeof(aNumber), "%ld ", lrand48()%1000);
+            break;
+            case 7:
+                numberLength = snprintf(aNumber, sizeof(aNumber), "%.6e,", drand48());
+            break;
+            default:
+                numberLength = snprintf(aNumber, sizeof(aNumber), "%.2f%c", drand48()*2000.0-1000.0, (index & 1) ? ',' : ' ');
+            break;
+        }
+        [mutableText appendBytes:aNumber length:(NSUInteger)numberLength];
+    }
+    self.numberText = mutableText;
+    self.numberCount = numberCount;
+}
+
+-(void) logThroughputForSeconds:(NSTimeInterval)seconds label:(NSString*)label
+{
+    NSLog(@"%@: %.1f MB/s, %.1f million numbers/s", label, self.numberText.length/seconds/1.0e6, self.numberCount/seconds/1.0e6);
+}
+
+- (void)testScannerThroughput {
+    const char* text = self.numberText.bytes;
+    const char* end = text+self.numberText.length;
+    __block double checksum = 0.0;
+    __block NSUInteger scannedCount = 0;
+    [self measureBlock:^{
+        const char* cursor = text;
+        double values[64];
+        size_t scanned;
+        NSDate* startTime = [NSDate date];
+        scannedCount = 0;
+        while((scanned = SVGScanNumbers(&cursor, end, values, 64)) > 0)
+        {
+            for(size_t index = 0; index < scanned; index++)
+            {
+                checksum += values[index];
+            }
+            scannedCount += scanned;
+        }
+        [self logThroughputForSeconds:-[startTime timeIntervalSinceNow] label:@"SVGScanNumbers"];
+    }];
+    XCTAssertEqual(scannedCount, self.numberCount);
+}
+
+- (void)testStrtodThroughput {
+    // baseline, as GetNextCoordinate used to work: copy each number out and hand it to the C library
+    const char* text = self.numberText.bytes;
+    const char* end = text+self.numberText.length;
+    __block double checksum = 0.0;
+    __block NSUInteger scannedCount = 0;
+    [self measureBlock:^{
+        const char* cursor = text;
+        NSDate* startTime = [NSDate date];
+        scannedCount = 0;
+        while(cursor < end)
+        {
+            while(cursor < end && (*cursor == ' ' || *cursor == ','))
+            {
+                cursor++;
+            }
+            const char* numberStart = cursor;
+            while(cursor < end && *cursor != ' ' && *cursor != ',')
+            {
+                cursor++;
+            }
+            if(cursor > numberStart)
+            {
+                char numberBuffer[100];
+                size_t numberLength = MIN((size_t)(cursor-numberStart), sizeof(numberBuffer)-1);
+                memcpy(numberBuffer, numberStart, numberLength);
+                numberBuffer[numberLength] = 0;
+                checksum += strtod(numberBuffer, NULL);
+                scannedCount++;
+            }
+        }
+        [self logThroughputForSeconds:-[startTime timeIntervalSinceNow] label:@"strtod"];
+    }];
+    XCTAssertEqual(scannedCount, self.numberCount);
+}
+
+@end
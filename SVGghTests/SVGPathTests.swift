@@ -45,7 +45,7 @@ class SVGPathTests: XCTestCase {
         
         let asString = cgPath.asString()
         XCTAssert(!asString.isEmpty)
-        XCTAssertEqual(asString, "M (170.00, 207.00)\nC (139.00, 183.00, 40.00, 199.00, 41.00, 109.00)\nL (41.00, 109.00)\nC (31.61, 104.86, 27.36, 93.89, 31.50, 84.50)\nC (35.64, 75.11, 46.61, 70.86, 56.00, 75.00)\nC (56.00, 75.00, 56.00, 75.00, 56.00, 75.00)\n")
+        XCTAssertEqual(asString, "M (170.00, 207.00)\nC (139.00, 183.00, 40.00, 199.00, 41.00, 109.00)\nL (41.00, 109.00)\nC (31.61, 104.86, 27.36, 93.89, 31.50, 84.50)\nC (35.64, 75.11, 46.61, 70.86, 56.00, 75.00)\n")
         
     }
     
@@ -29,12 +29,43 @@
 #import <XCTest/XCTest.h>
 #import <SVGgh/SVGgh.h>
 #import "SVGUtilities.h"
+#import "SVGAttributedObject.h"
+#import "GHXMLTokenizer.h"
+#import "GHAttributeTable.h"
+#import "SVGPathBuffer.h"
+#import "SVGNumberScanner.h"
+#import "SVGPathWriter.h"
+#import "GHPathUtilities.h"
+#import "SVGColorParser.h"
+#import "GHColorTable.h"
+#import "GHComputedStyle.h"
+#import "GHGradient.h"
+#import "GHCSSStyleSheet.h"
+#import "GHDisplayList.h"
+#import "SVGRasterizer.h"
 
 
 @interface SVGghTests : XCTestCase
 
 @end
 
+@interface GHButton (Testing)
+-(void)drawArtworkAtPath:(NSString*)theArtworkPath intoContext:(CGContextRef)quartzContext bounds:(CGRect)bounds;
+@end
+
+/*! @brief hands out the same document whatever it is asked for
+*/
+@interface GHTestArtworkLoader : NSObject<SVGghLoader>
+@property(nonatomic, copy) NSString* documentString;
+@end
+
+@implementation GHTestArtworkLoader
+-(SVGRenderer*) loadRenderForSVGIdentifier:(NSString*)identifier inBundle:(NSBundle*)bundle
+{
+    return [[SVGRenderer alloc] initWithString:self.documentString];
+}
+@end
+
 @implementation SVGghTests
 
 - (void)setUp
@@ -58,7 +89,20 @@
         CGAffineTransform canonicalVersion = SVGTransformToCGAffineTransformSlow(aTransformString);
         CGAffineTransform fastVersion =SVGTransformToCGAffineTransform(aTransformString);
         XCTAssertTrue(CGAffineTransformEqualToTransform(canonicalVersion, fastVersion), @"Divergent results with: %@", aTransformString);
+        XCTAssertTrue(CGAffineTransformEqualToTransform(fastVersion, SVGTransformToCGAffineTransform(aTransformString)), @"Cached result differs with: %@", aTransformString);
+    }
+    
+    XCTAssertTrue(CGAffineTransformEqualToTransform(SVGTransformToCGAffineTransform(@"scale(2)"), CGAffineTransformMakeScale(2, 2)), @"Short transforms are parsed too");
+    XCTAssertTrue(CGAffineTransformEqualToTransform(SVGTransformToCGAffineTransform(@"rotate(30 10)"), CGAffineTransformIdentity), @"rotate takes 1 or 3 arguments");
+    XCTAssertTrue(CGAffineTransformEqualToTransform(SVGTransformToCGAffineTransform(@"translate(5) bogus(1) scale(2)"), CGAffineTransformMakeTranslation(5, 0)), @"An error keeps what came before");
+    
+    NSMutableString* longTransform = [[NSMutableString alloc] init];
+    for(NSUInteger index = 0; index < 100; index++)
+    {
+        [longTransform appendString:@"translate(1, 2) "];
     }
+    CGAffineTransform longResult = SVGTransformToCGAffineTransform(longTransform);
+    XCTAssertTrue(CGAffineTransformEqualToTransform(longResult, CGAffineTransformMakeTranslation(100, 200)), @"No limit on the length of a transform");
 }
 
 - (UIColor*)pixelColorInImage:(UIImage*)image atX:(int)x atY:(int)y { // from StackOverflow http://stackoverflow.com/questions/3284185/get-pixel-color-of-uiimage
@@ -212,6 +256,8 @@
     XCTAssertNotNil(UIColorFromSVGColorString(@"coral"));
     XCTAssertNotNil(UIColorFromSVGColorString(@"lemonCHIFFON"));
     XCTAssertNil(UIColorFromSVGColorString(@"cherry"));
+    XCTAssertNotNil(UIColorFromSVGColorString(@"ActiveBorder"));
+    XCTAssertNotNil(UIColorFromSVGColorString(@"rgb(10%, 20%, 30%)"));
 }
 
 -(void) testStyleMerge
@@ -251,4 +297,977 @@
 }
 
 
+-(void) testObjectTreeBuilder
+{
+    NSString* testDocument = @"<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 100 100\"><title>Builder</title>"
+    "<defs><linearGradient id=\"grad\"><stop offset=\"0\" stop-color=\"red\"/><stop offset=\"1\" stop-color=\"blue\"/></linearGradient></defs>"
+    "<g fill=\"green\" stroke=\"black\" font-size=\"12\"><rect x=\"1\" y=\"1\" width=\"10\" height=\"10\"/>"
+    "<g transform=\"translate(10,10)\"><path d=\"M0 0L10 10\" fill=\"inherit\"/><desc>skipped</desc></g>"
+    "<text x=\"5\" y=\"50\">Hello <tspan fill=\"red\">World</tspan></text></g></svg>";
+    
+    SVGParser* dictionaryParser = [[SVGParser alloc] initWithString:testDocument];
+    XCTAssertNil(dictionaryParser.rootObject, @"SVGParser should still build the dictionary form");
+    GHShapeGroup* fromDictionary = [[GHShapeGroup alloc] initWithDictionary:dictionaryParser.root];
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:testDocument];
+    GHShapeGroup* fromBuilder = renderer.rootObject;
+    XCTAssertNotNil(fromBuilder, @"Expected the renderer to build its object tree while parsing");
+    XCTAssertEqualObjects(fromBuilder, fromDictionary, @"Building directly should give the same tree as the dictionary form");
+    XCTAssertTrue(CGRectEqualToRect(renderer.viewRect, CGRectMake(0, 0, 100, 100)), @"Root attributes should be kept");
+}
+
+-(void) testXMLTokenizer
+{
+    const char* testXML = "<?xml version=\"1.0\"?><!DOCTYPE svg [ <!ENTITY a \"b>\"> ]><!-- a > comment -->"
+    "<svg a='1&amp;2' b=\"x\ny\"><path d=\"M0 0\"/>A &lt; B<![CDATA[.c{fill:red}]]></svg>";
+    GHXMLTokenizer tokenizer;
+    GHXMLToken token;
+    GHXMLTokenizerInit(&tokenizer, testXML, strlen(testXML));
+    
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenStartElement);
+    XCTAssertEqual(token.attributeCount, 2u);
+    char decoded[32];
+    size_t decodedLength = GHXMLDecodeSpan(token.attributes[0].value, 1, decoded);
+    XCTAssertEqualObjects([[NSString alloc] initWithBytes:decoded length:decodedLength encoding:NSUTF8StringEncoding], @"1&2");
+    decodedLength = GHXMLDecodeSpan(token.attributes[1].value, 1, decoded);
+    XCTAssertEqualObjects([[NSString alloc] initWithBytes:decoded length:decodedLength encoding:NSUTF8StringEncoding], @"x y", @"Attribute line breaks become spaces");
+    
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenStartElement);
+    XCTAssertTrue(token.isEmptyElement);
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenEndElement, @"Empty elements should end themselves");
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenText);
+    decodedLength = GHXMLDecodeSpan(token.text, 0, decoded);
+    XCTAssertEqualObjects([[NSString alloc] initWithBytes:decoded length:decodedLength encoding:NSUTF8StringEncoding], @"A < B");
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenCDATA);
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenEndElement);
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenEndOfDocument);
+    GHXMLTokenizerFinish(&tokenizer);
+    
+    const char* unterminated = "<svg><path d=\"M0 0</svg>";
+    GHXMLTokenizerInit(&tokenizer, unterminated, strlen(unterminated));
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenStartElement);
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenError);
+    GHXMLTokenizerFinish(&tokenizer);
+    
+    // Illustrator declares its namespaces as entities in the internal subset
+    NSMutableString* illustratorSVG = [NSMutableString stringWithString:@"<?xml version=\"1.0\"?><!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+                                       "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\" [<!ENTITY ns_svg \"http://www.w3.org/2000/svg\">]>"
+                                       "<svg xmlns=\"&ns_svg;\" width=\"10\" height=\"10\"><rect id=\"r\" width=\"10\" height=\"10\""];
+    for(NSUInteger index = 0; index < 300; index++)
+    {
+        [illustratorSVG appendFormat:@" data-a%lu=\"%lu\"", (unsigned long)index, (unsigned long)index];
+    }
+    [illustratorSVG appendString:@"/></svg>"];
+    const char* illustratorBytes = illustratorSVG.UTF8String;
+    GHXMLTokenizerInit(&tokenizer, illustratorBytes, strlen(illustratorBytes));
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenStartElement);
+    decodedLength = GHXMLTokenizerDecodeSpan(&tokenizer, token.attributes[0].value, 1, decoded, sizeof(decoded));
+    XCTAssertEqualObjects([[NSString alloc] initWithBytes:decoded length:decodedLength encoding:NSUTF8StringEncoding], @"http://www.w3.org/2000/svg",
+                          @"Internal entities are expanded");
+    XCTAssertEqual(GHXMLTokenizerNext(&tokenizer, &token), kGHXMLTokenStartElement);
+    XCTAssertEqual(token.attributeCount, 303u, @"No limit on the number of attributes");
+    GHXMLTokenizerFinish(&tokenizer);
+    
+    SVGRenderer* illustrated = [[SVGRenderer alloc] initWithString:illustratorSVG];
+    XCTAssertNil(illustrated.parserError);
+    XCTAssertNotNil(illustrated.rootObject);
+    XCTAssertNotNil([illustrated objectNamed:@"r"]);
+    
+    SVGRenderer* broken = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\"><path d=\"M0 0\">"];
+    XCTAssertNotNil(broken.parserError, @"Malformed documents should still report an error");
+}
+
+-(void) testAttributeTable
+{
+    NSDictionary* attributes = @{@"stroke-width":@"2", @"fill":@"red", @"data-custom":@"42", @"style":@"fill-opacity:0.5"};
+    NSDictionary* table = [GHAttributeTable attributeTableWithDictionary:attributes];
+    XCTAssertTrue([table isKindOfClass:[GHAttributeTable class]]);
+    XCTAssertEqualObjects(table, attributes, @"A table should still be an equivalent dictionary");
+    XCTAssertEqual(table.count, attributes.count);
+    XCTAssertEqualObjects([table objectForAtom:kGHAttributeStrokeWidth], @"2");
+    XCTAssertEqualObjects([table objectForKey:@"fill"], @"red");
+    XCTAssertEqualObjects([table objectForKey:@"data-custom"], @"42", @"Unknown attributes go into the side dictionary");
+    XCTAssertNil([table objectForAtom:kGHAttributeStroke]);
+    XCTAssertEqualObjects([attributes objectForAtom:kGHAttributeFill], @"red", @"Plain dictionaries are looked up by name");
+    XCTAssertEqualObjects([SVGToQuartz valueForStyleAtom:kGHAttributeFillOpacity fromDefinition:table], @"0.5");
+    XCTAssertEqual(GHAttributeAtomForName(GHAttributeNameForAtom(kGHAttributeStrokeDashArray)), kGHAttributeStrokeDashArray);
+    
+    GHRectangle* rectangle = [[GHRectangle alloc] initWithAttributes:attributes];
+    XCTAssertTrue([rectangle.attributes isKindOfClass:[GHAttributeTable class]], @"Attributes should be indexed as the object is made");
+}
+
+-(void) testRootDictionaryTree
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                             "<g id=\"g\"><rect width=\"1\" height=\"1\"/></g></svg>"];
+    XCTAssertNotNil(renderer.rootObject, @"Built without the dictionary tree");
+    NSDictionary* root = renderer.root;
+    XCTAssertEqualObjects([root objectForKey:kElementName], @"svg");
+    NSArray* contents = [root objectForKey:kContentsElementName];
+    XCTAssertEqual(contents.count, 1UL, @"The whole tree, not just the svg element");
+    XCTAssertEqual([[contents.firstObject objectForKey:kContentsElementName] count], 1UL);
+}
+
+-(void) testRasterCache
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                             "<rect width=\"10\" height=\"5\" fill=\"currentColor\"/></svg>"];
+    GHRasterCache* rasterCache = [[GHRasterCache alloc] initWithByteBudget:1024*1024];
+    CGSize size = CGSizeMake(10, 10);
+
+    XCTestExpectation* cached = [self expectationWithDescription:@"rendered on the rendererQueue"];
+    CGImageRef image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:1.0 currentColor:[UIColor redColor]
+                                              whenCached:^(CGImageRef anImage) {
+                                                  XCTAssertEqual(CGImageGetWidth(anImage), 10UL);
+                                                  [cached fulfill];
+                                              }];
+    XCTAssertTrue(image == NULL, @"A miss");
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:1.0 currentColor:[UIColor redColor] whenCached:nil];
+    XCTAssertTrue(image != NULL, @"A hit");
+    CFDataRef pixelData = CGDataProviderCopyData(CGImageGetDataProvider(image));
+    const uint8_t* pixels = CFDataGetBytePtr(pixelData);
+    XCTAssertEqual(pixels[0], (uint8_t)255, @"The first row is the top of the document, drawn in currentColor");
+    XCTAssertEqual(pixels[3], (uint8_t)255);
+    CFRelease(pixelData);
+    XCTAssertEqual(rasterCache.totalBytes, CGImageGetBytesPerRow(image)*CGImageGetHeight(image));
+    CGImageRelease(image);
+    XCTAssertEqual(rasterCache.hitCount, 1UL);
+    XCTAssertEqual(rasterCache.missCount, 1UL);
+    XCTAssertEqualWithAccuracy(rasterCache.hitRate, 0.5, 1e-9);
+
+    cached = [self expectationWithDescription:@"another currentColor"];
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:1.0 currentColor:[UIColor blueColor]
+                                   whenCached:^(CGImageRef anImage) {
+                                       [cached fulfill];
+                                   }];
+    XCTAssertTrue(image == NULL, @"currentColor is part of the key");
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+
+    rasterCache.byteBudget = rasterCache.totalBytes/2;
+    XCTAssertTrue(rasterCache.totalBytes <= rasterCache.byteBudget);
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:1.0 currentColor:[UIColor blueColor] whenCached:nil];
+    XCTAssertTrue(image != NULL);
+    CGImageRelease(image);
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:1.0 currentColor:[UIColor redColor] whenCached:nil];
+    XCTAssertTrue(image == NULL, @"The least recently used image was evicted");
+    
+    [SVGRenderer rendererQueue].suspended = YES; // so the removal lands while the render is under way
+    cached = [self expectationWithDescription:@"a render outdated by removeImagesForRenderer:"];
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:2.0 currentColor:nil
+                                   whenCached:^(CGImageRef anImage) {
+                                       XCTAssertTrue(anImage == NULL, @"Not handed out");
+                                       [cached fulfill];
+                                   }];
+    [rasterCache removeImagesForRenderer:renderer];
+    [SVGRenderer rendererQueue].suspended = NO;
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    image = [rasterCache copyImageForRenderer:renderer fittingSize:size scale:2.0 currentColor:nil whenCached:nil];
+    XCTAssertTrue(image == NULL, @"Nor cached");
+
+    [rasterCache resetStatistics];
+    XCTAssertEqual(rasterCache.hitRate, 0.0);
+    
+    SVGRenderer* emptyRenderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"0\" height=\"10\"/>"];
+    cached = [self expectationWithDescription:@"waiters hear about a failed render"];
+    image = [rasterCache copyImageForRenderer:emptyRenderer fittingSize:size scale:1.0 currentColor:nil
+                                   whenCached:^(CGImageRef anImage) {
+                                       XCTAssertTrue(anImage == NULL);
+                                       [cached fulfill];
+                                   }];
+    XCTAssertTrue(image == NULL);
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    image = [rasterCache copyImageForRenderer:emptyRenderer fittingSize:size scale:1.0 currentColor:nil
+                                   whenCached:^(CGImageRef anImage) {
+                                       XCTFail(@"A failure isn't rendered again right away");
+                                   }];
+    XCTAssertTrue(image == NULL);
+    XCTAssertEqual(rasterCache.missCount, 2UL);
+    [rasterCache removeImagesForRenderer:emptyRenderer];
+    cached = [self expectationWithDescription:@"a changed document is tried again"];
+    image = [rasterCache copyImageForRenderer:emptyRenderer fittingSize:size scale:1.0 currentColor:nil
+                                   whenCached:^(CGImageRef anImage) {
+                                       [cached fulfill];
+                                   }];
+    XCTAssertTrue(image == NULL);
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    
+    SVGRenderer* styledRenderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\">"
+                                   "<style>rect { fill: #00FF00 } rect:active { fill: #FF0000 }</style><rect width=\"10\" height=\"10\"/></svg>"];
+    cached = [self expectationWithDescription:@"recorded before the pseudo class changed"];
+    image = [rasterCache copyImageForRenderer:styledRenderer fittingSize:size scale:1.0 currentColor:nil
+                                   whenCached:^(CGImageRef anImage) {
+                                       CFDataRef greenData = CGDataProviderCopyData(CGImageGetDataProvider(anImage));
+                                       XCTAssertEqual(CFDataGetBytePtr(greenData)[1], (uint8_t)255, @"Styled as it was when requested");
+                                       CFRelease(greenData);
+                                       [cached fulfill];
+                                   }];
+    styledRenderer.cssPseudoClass = kPseudoClassActive;
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+}
+
+-(void) testButtonArtworkFromRasterCache
+{
+    GHTestArtworkLoader* loader = [[GHTestArtworkLoader alloc] init];
+    loader.documentString = @"<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"10 10 40 20\">"
+                            "<rect x=\"10\" y=\"10\" width=\"20\" height=\"20\" fill=\"#FF0000\"/><rect x=\"30\" y=\"10\" width=\"20\" height=\"20\" fill=\"#0000FF\"/></svg>";
+    [SVGghLoaderManager setLoader:loader];
+    NSString* artworkPath = [NSUUID UUID].UUIDString; // nothing cached for it yet
+    GHButton* button = [[GHButton alloc] initWithFrame:CGRectMake(0, 0, 60, 40)];
+    button.drawsChrome = NO;
+    button.layer.contentsScale = 1.0;
+    
+    uint32_t missPixels[60*40];
+    uint32_t hitPixels[60*40];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    uint32_t* drawnPixels[2] = {missPixels, hitPixels};
+    GHRasterCache* rasterCache = [GHRasterCache sharedCache];
+    for(int drawIndex = 0; drawIndex < 2; drawIndex++)
+    {
+        memset(drawnPixels[drawIndex], 0, sizeof(missPixels));
+        CGContextRef bitmapContext = CGBitmapContextCreate(drawnPixels[drawIndex], 60, 40, 8, 240, colorSpace, kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big);
+        CGContextTranslateCTM(bitmapContext, 0.0, 40.0);
+        CGContextScaleCTM(bitmapContext, 1.0, -1.0); // as UIKit sets up a view's context
+        NSUInteger hitCount = rasterCache.hitCount;
+        [button drawArtworkAtPath:artworkPath intoContext:bitmapContext bounds:button.bounds];
+        XCTAssertEqual(rasterCache.hitCount, hitCount+drawIndex, @"Drawn directly the first time, from the cache the second");
+        CGContextRelease(bitmapContext);
+        [[SVGRenderer rendererQueue] waitUntilAllOperationsAreFinished];
+    }
+    CGColorSpaceRelease(colorSpace);
+    [SVGghLoaderManager setLoader:nil];
+    
+    const uint8_t* missBytes = (const uint8_t*)missPixels;
+    const uint8_t* hitBytes = (const uint8_t*)hitPixels;
+    XCTAssertEqual(missBytes[4*(30*60+20)], (uint8_t)255, @"The red square, fitted as drawArtWithRenderer: fits it");
+    NSUInteger differingCount = 0;
+    for(size_t byteIndex = 0; byteIndex < sizeof(missPixels); byteIndex++)
+    {
+        if(abs((int)missBytes[byteIndex]-(int)hitBytes[byteIndex]) > 2)
+        {
+            differingCount++;
+        }
+    }
+    XCTAssertEqual(differingCount, 0UL, @"A hit draws just what a miss drew");
+}
+
+-(void) testDrawnBounds
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<g id=\"g\" transform=\"translate(10,20)\"><rect id=\"stroked\" width=\"10\" height=\"10\" fill=\"none\" stroke=\"#000000\" stroke-width=\"2\" stroke-linejoin=\"round\"/>"
+                             "<rect id=\"filled\" x=\"40\" width=\"5\" height=\"5\" fill=\"#FF0000\"/></g>"
+                             "<text id=\"t\" x=\"0\" y=\"90\">Text</text></svg>"];
+    CGRect strokedBounds = [renderer drawnBoundsOfObject:[renderer objectNamed:@"stroked"]];
+    XCTAssertTrue(CGRectContainsRect(strokedBounds, CGRectMake(9, 19, 12, 12)), @"Stroke included");
+    XCTAssertTrue(CGRectContainsRect(CGRectMake(8, 18, 14, 14), strokedBounds));
+    XCTAssertTrue(CGRectEqualToRect([renderer drawnBoundsOfObject:[renderer objectNamed:@"filled"]], CGRectMake(50, 20, 5, 5)));
+    XCTAssertTrue(CGRectContainsRect([renderer drawnBoundsOfObject:[renderer objectNamed:@"g"]], CGRectMake(9, 19, 46, 12)));
+    XCTAssertTrue(CGRectIsInfinite([renderer drawnBoundsOfObject:[renderer objectNamed:@"t"]]), @"Text bounds aren't known");
+    
+    SVGRenderer* otherRenderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\"><rect id=\"r\" width=\"1\" height=\"1\"/></svg>"];
+    XCTAssertTrue(CGRectIsNull([renderer drawnBoundsOfObject:[otherRenderer objectNamed:@"r"]]), @"Not in the document");
+}
+
+-(void) testHitTestIndex
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<g id=\"g\" transform=\"translate(50,50)\"><rect id=\"a\" width=\"10\" height=\"10\" fill=\"#FF0000\"/>"
+                             "<g transform=\"scale(2)\"><rect id=\"b\" x=\"5\" y=\"5\" width=\"10\" height=\"10\" fill=\"#00FF00\"/></g></g>"
+                             "<rect id=\"c\" width=\"20\" height=\"20\" fill=\"#0000FF\"/>"
+                             "<rect id=\"d\" x=\"55\" y=\"55\" width=\"2\" height=\"2\" fill=\"#000000\"/></svg>"];
+    XCTAssertEqual([renderer findRenderableObject:CGPointMake(52, 52)], [renderer objectNamed:@"a"]);
+    XCTAssertEqual([renderer findRenderableObject:CGPointMake(56, 56)], [renderer objectNamed:@"d"], @"The topmost of two");
+    XCTAssertEqual([renderer findRenderableObject:CGPointMake(70, 70)], [renderer objectNamed:@"b"], @"Through both groups' transforms");
+    XCTAssertEqual([renderer findRenderableObject:CGPointMake(5, 5)], [renderer objectNamed:@"c"]);
+    XCTAssertNil([renderer findRenderableObject:CGPointMake(95, 5)]);
+    
+    GHRectangle* movedRectangle = [renderer objectNamed:@"c"];
+    movedRectangle.transform = CGAffineTransformMakeTranslation(75, 0);
+    XCTAssertEqual([renderer findRenderableObject:CGPointMake(85, 5)], movedRectangle, @"The index is rebuilt once an object moves");
+    XCTAssertNil([renderer findRenderableObject:CGPointMake(5, 5)]);
+    movedRectangle.transform = CGAffineTransformIdentity;
+    
+    GHDisplayList* displayList = [[GHDisplayList alloc] init];
+    [displayList addRenderable:[renderer objectNamed:@"g"] withSVGContext:renderer];
+    uint32_t pixels[100*100];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef bitmapContext = CGBitmapContextCreate(pixels, 100, 100, 8, 400, colorSpace, kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big);
+    NSUInteger culledCount = [displayList replayIntoContext:bitmapContext withSVGContext:renderer cullingToRect:CGRectMake(0, 0, 30, 30)];
+    XCTAssertEqual(culledCount, 2UL, @"The whole group is skipped");
+    culledCount = [displayList replayIntoContext:bitmapContext withSVGContext:renderer cullingToRect:CGRectMake(0, 0, 55, 55)];
+    XCTAssertEqual(culledCount, 1UL, @"Only the scaled rect is skipped");
+    CGContextRelease(bitmapContext);
+    CGColorSpaceRelease(colorSpace);
+}
+
+-(void) testLayerRedrawsChangedObject
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<rect id=\"c\" width=\"20\" height=\"100\" fill=\"#0000FF\"/></svg>"];
+    SVGRendererLayer* layer = [[SVGRendererLayer alloc] init];
+    layer.bounds = CGRectMake(0, 0, 100, 100);
+    layer.beTransparent = YES;
+    layer.renderer = renderer;
+    GHRectangle* rectangle = [renderer objectNamed:@"c"];
+    XCTAssertEqual([layer findRenderableObject:CGPointMake(5, 50)], rectangle);
+    
+    uint32_t pixels[100*100];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef bitmapContext = CGBitmapContextCreate(pixels, 100, 100, 8, 400, colorSpace, kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big);
+    const uint8_t* middleRow = (const uint8_t*)(pixels+50*100);
+    memset(pixels, 0, sizeof(pixels));
+    [layer drawInContext:bitmapContext];
+    XCTAssertEqual(middleRow[4*5+2], (uint8_t)255);
+    
+    rectangle.transform = CGAffineTransformMakeTranslation(75, 0);
+    [layer setNeedsDisplayForObject:rectangle];
+    memset(pixels, 0, sizeof(pixels));
+    [layer drawInContext:bitmapContext];
+    XCTAssertEqual(middleRow[4*5+3], (uint8_t)0, @"Not drawn where it was");
+    XCTAssertEqual(middleRow[4*85+2], (uint8_t)255, @"Drawn where it is now");
+    XCTAssertEqual([layer findRenderableObject:CGPointMake(85, 50)], rectangle, @"Hit tested where it is now");
+    XCTAssertNil([layer findRenderableObject:CGPointMake(5, 50)]);
+    CGContextRelease(bitmapContext);
+    CGColorSpaceRelease(colorSpace);
+}
+
+-(void) testTiledImage
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"32\">"
+                             "<rect width=\"8\" height=\"8\" fill=\"#FF0000\"/>"
+                             "<rect x=\"24\" y=\"24\" width=\"8\" height=\"8\" fill=\"#0000FF\"/></svg>"];
+    NSArray<SVGRenderTileTiming*>* tileTimings = nil;
+    UIImage* image = [renderer asTiledImageWithSize:CGSizeMake(32, 32) andScale:1.0 tileSize:16 tileTimings:&tileTimings];
+    XCTAssertNotNil(image);
+    XCTAssertEqual(tileTimings.count, 4UL, @"2 by 2 tiles");
+    XCTAssertTrue(CGRectEqualToRect(tileTimings.firstObject.pixelRect, CGRectMake(0, 0, 16, 16)));
+    XCTAssertGreaterThan(tileTimings.firstObject.culledOperationCount, 0UL, @"The top left tile has no need to draw the blue square");
+    
+    XCTAssertEqualObjects([self pixelColorInImage:image atX:1 atY:1], UIColorFromSVGColorString(@"#FF0000"), @"Top left, not flipped");
+    XCTAssertEqualObjects([self pixelColorInImage:image atX:30 atY:30], UIColorFromSVGColorString(@"#0000FF"));
+    CGFloat red, green, blue, alpha = 1.0;
+    [[self pixelColorInImage:image atX:16 atY:16] getRed:&red green:&green blue:&blue alpha:&alpha];
+    XCTAssertEqual(alpha, 0.0, @"Nothing drawn in the middle");
+}
+
+-(void) testRasterBackend
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"20\" height=\"20\">"
+                             "<defs><linearGradient id=\"g\"><stop offset=\"0\" stop-color=\"#000000\"/><stop offset=\"1\" stop-color=\"#FFFFFF\"/></linearGradient></defs>"
+                             "<path fill-rule=\"evenodd\" fill=\"#FF0000\" d=\"M0,0H10V10H0Z M3,3H7V7H3Z\"/>"
+                             "<line x1=\"12\" y1=\"2\" x2=\"18\" y2=\"2\" stroke=\"#0000FF\" stroke-width=\"2\"/>"
+                             "<rect x=\"0\" y=\"12\" width=\"20\" height=\"8\" fill=\"url(#g)\"/></svg>"];
+    SVGRasterContext* rasterContext = SVGRasterContextCreate(20, 20);
+    const SVGDrawingBackend* backend = SVGRasterDrawingBackend();
+    const double flip[6] = {1.0, 0.0, 0.0, -1.0, 0.0, 20.0}; // as a UIKit context is set up
+    backend->concatTransform(rasterContext, flip);
+    [renderer renderWithDrawingBackend:backend context:rasterContext];
+    
+    const uint8_t* pixels = SVGRasterContextGetPixels(rasterContext);
+    size_t bytesPerRow = SVGRasterContextGetBytesPerRow(rasterContext);
+    const uint8_t* ring = pixels+bytesPerRow+4;
+    XCTAssertEqual(ring[0], 255);
+    XCTAssertEqual(ring[3], 255);
+    XCTAssertEqual(pixels[5*bytesPerRow+4*5+3], 0, @"The even-odd hole");
+    const uint8_t* line = pixels+bytesPerRow+4*15;
+    XCTAssertEqual(line[2], 255, @"A 2 wide stroke centered on a pixel boundary covers both rows");
+    XCTAssertEqual(line[bytesPerRow+2], 255);
+    XCTAssertEqual(pixels[5*bytesPerRow+4*15+3], 0);
+    const uint8_t* gradientRow = pixels+15*bytesPerRow;
+    XCTAssertLessThan(gradientRow[4*1], 40, @"Dark at the gradient's start");
+    XCTAssertGreaterThan(gradientRow[4*18], 215, @"Light at its end");
+    XCTAssertEqual(gradientRow[4*10+3], 255);
+    SVGRasterContextFree(rasterContext);
+}
+
+-(void) testDisplayList
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"4\" height=\"4\">"
+                             "<g opacity=\"0.5\"><rect id=\"r\" width=\"4\" height=\"4\" fill=\"#00FF00\"/></g>"
+                             "<text x=\"0\" y=\"4\" font-size=\"1\">.</text></svg>"];
+    GHRectangle* rectangle = [renderer objectNamed:@"r"];
+    GHDisplayList* displayList = [[GHDisplayList alloc] init];
+    [displayList addRenderable:rectangle withSVGContext:renderer];
+    XCTAssertEqual(displayList.opCount, 4UL, @"save, fill color, draw path, restore");
+    
+    uint32_t pixels[16];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef bitmapContext = CGBitmapContextCreate(pixels, 4, 4, 8, 16, colorSpace, kCGImageAlphaPremultipliedLast|kCGBitmapByteOrder32Big);
+    memset(pixels, 0, sizeof(pixels));
+    [displayList replayIntoContext:bitmapContext withSVGContext:renderer];
+    const uint8_t* lastPixel = (const uint8_t*)(pixels+15); // well away from the text
+    XCTAssertEqual(lastPixel[1], 255, @"The rectangle's green, replayed without its group's opacity");
+    
+    memset(pixels, 0, sizeof(pixels));
+    [renderer renderIntoContext:bitmapContext];
+    uint32_t firstRender[16];
+    memcpy(firstRender, pixels, sizeof(pixels));
+    XCTAssertEqualWithAccuracy(lastPixel[1], 128, 2, @"The group's opacity is recorded as a layer");
+    memset(pixels, 0, sizeof(pixels));
+    [renderer renderIntoContext:bitmapContext];
+    XCTAssertEqual(memcmp(firstRender, pixels, sizeof(pixels)), 0, @"Replaying the cached list draws what compiling it drew");
+    XCTAssertEqualObjects(renderer.currentColor, nil, @"Replay leaves the renderer's state alone");
+    
+    rectangle.fillColor = UIColorFromSVGColorString(@"#FF0000");
+    rectangle.transform = CGAffineTransformMakeTranslation(2.0, 0.0);
+    memset(pixels, 0, sizeof(pixels));
+    [renderer renderIntoContext:bitmapContext];
+    XCTAssertEqualWithAccuracy(lastPixel[0], 128, 2, @"Setting fillColor recompiles the list");
+    XCTAssertEqual(lastPixel[1], 0);
+    XCTAssertEqual(((const uint8_t*)(pixels+12))[3], 0, @"Setting the transform recompiles the list");
+    CGContextRelease(bitmapContext);
+    CGColorSpaceRelease(colorSpace);
+}
+
+-(void) testInheritedAttributes
+{
+    NSDictionary* groupsAttributes = [GHAttributeTable attributeTableWithDictionary:@{@"fill":@"red", @"stroke":@"blue"}];
+    NSDictionary* childsAttributes = [GHAttributeTable attributeTableWithDictionary:@{@"stroke":@"green", @"fill":@"inherit", @"font-size":@"3"}
+                                                               inheritedAttributes:groupsAttributes];
+    XCTAssertEqualObjects([childsAttributes objectForAtom:kGHAttributeFill], @"red", @"'inherit' finds the group's value");
+    XCTAssertEqualObjects([childsAttributes objectForKey:@"stroke"], @"green", @"The child's own value wins");
+    XCTAssertNil([childsAttributes ownObjectForKey:@"fill"]);
+    XCTAssertEqual(childsAttributes.count, 3UL);
+    XCTAssertTrue([childsAttributes inheritedAttributes] == groupsAttributes, @"Shared, not copied");
+    XCTAssertEqualObjects([childsAttributes copy], (@{@"fill":@"red", @"stroke":@"green", @"font-size":@"3"}));
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<g fill=\"red\" stroke-opacity=\"0.5\"><g id=\"middle\"><g><rect id=\"r\" width=\"10\" height=\"10\"/></g></g>"
+                             "<g id=\"blue\" fill=\"blue\"><rect id=\"b\" width=\"10\" height=\"10\"/></g></g></svg>"];
+    GHShapeGroup* middle = [renderer objectNamed:@"middle"];
+    GHRectangle* deepRectangle = [renderer objectNamed:@"r"];
+    GHRectangle* blueRectangle = [renderer objectNamed:@"b"];
+    XCTAssertEqualObjects([deepRectangle.attributes objectForAtom:kGHAttributeFill], @"red");
+    XCTAssertEqualObjects([deepRectangle.attributes objectForAtom:kGHAttributeStrokeOpacity], @"0.5");
+    XCTAssertNil([deepRectangle.attributes ownObjectForKey:@"fill"]);
+    XCTAssertTrue([deepRectangle.attributes inheritedAttributes] == [middle.attributes inheritedAttributes], @"Groups which set nothing pass their inheritance on untouched");
+    XCTAssertEqualObjects([blueRectangle.attributes objectForAtom:kGHAttributeFill], @"blue");
+    XCTAssertEqualObjects([blueRectangle.attributes objectForAtom:kGHAttributeStrokeOpacity], @"0.5");
+    XCTAssertNotNil([renderer asImageWithSize:CGSizeMake(100, 100) andScale:1.0]);
+}
+
+-(void) testCSSCascade
+{
+    GHCSSStyleSheet* styleSheet = [[GHCSSStyleSheet alloc] initWithString:@"/* comment */ rect { fill: red } .warn { fill: orange; stroke: black !important }"
+                                   " g.legend > rect.warn { fill: yellow; stroke: white } #key { fill: green } rect:hover { fill: blue }"
+                                   " @media print { rect { fill: gray } } rect[x] { fill: purple } circle, ellipse { stroke-width: 2 }"];
+    XCTAssertEqual(styleSheet.ruleCount, 8UL, @"Attribute selectors and at-rules are dropped, selector lists split");
+    XCTAssertTrue(styleSheet.usesPseudoClasses);
+    
+    GHCSSElementDescription* root = [[GHCSSElementDescription alloc] initWithElementName:@"svg" elementID:nil classNames:nil parent:nil];
+    GHCSSElementDescription* legend = [[GHCSSElementDescription alloc] initWithElementName:@"g" elementID:nil classNames:@[@"legend"] parent:root];
+    GHCSSElementDescription* inner = [[GHCSSElementDescription alloc] initWithElementName:@"g" elementID:nil classNames:nil parent:legend];
+    GHCSSElementDescription* legendRect = [[GHCSSElementDescription alloc] initWithElementName:@"rect" elementID:nil classNames:@[@"warn"] parent:legend];
+    GHCSSElementDescription* innerRect = [[GHCSSElementDescription alloc] initWithElementName:@"rect" elementID:nil classNames:@[@"warn"] parent:inner];
+    GHCSSElementDescription* keyRect = [[GHCSSElementDescription alloc] initWithElementName:@"rect" elementID:@"key" classNames:@[@"warn"] parent:legend];
+    GHCSSElementDescription* plainRect = [[GHCSSElementDescription alloc] initWithElementName:@"rect" elementID:nil classNames:nil parent:root];
+    
+    NSDictionary* declarations = [styleSheet declarationsForElement:legendRect pseudoClass:kPseudoClassNone];
+    XCTAssertEqualObjects(declarations[@"fill"], @"yellow", @"The more specific selector wins");
+    XCTAssertEqualObjects(declarations[@"stroke"], @"black", @"!important beats specificity");
+    NSDictionary* important = nil;
+    [styleSheet declarationsForElement:legendRect pseudoClass:kPseudoClassNone importantDeclarations:&important];
+    XCTAssertEqualObjects(important, @{@"stroke":@"black"});
+    XCTAssertEqualObjects([styleSheet declarationsForElement:innerRect pseudoClass:kPseudoClassNone][@"fill"], @"orange", @"> only looks at the parent");
+    XCTAssertEqualObjects([styleSheet declarationsForElement:keyRect pseudoClass:kPseudoClassNone][@"fill"], @"green");
+    XCTAssertEqualObjects([styleSheet declarationsForElement:plainRect pseudoClass:kPseudoClassNone][@"fill"], @"red");
+    XCTAssertEqualObjects([styleSheet declarationsForElement:plainRect pseudoClass:kPseudoClassHovering][@"fill"], @"blue");
+    XCTAssertNil([styleSheet declarationsForElement:root pseudoClass:kPseudoClassNone]);
+    
+    NSDictionary<NSString*, GHCSSStyle*>* styles = [GHCSSStyle stylesForString:@"rect {fill:red} rect.warn {stroke:blue} .warn {fill:orange}"];
+    XCTAssertEqualObjects(styles[@"rect"].attributes[@"fill"], @"red");
+    XCTAssertEqualObjects(styles[@"rect"].subClasses[@"warn"].attributes[@"stroke"], @"blue");
+    XCTAssertEqualObjects([GHCSSStyle attributeNamed:@"fill" classes:@[@"warn"] entityName:@"rect" pseudoClass:kPseudoClassNone forStyles:styles], @"orange");
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<style><![CDATA[ g.legend { stroke: purple } g.legend > rect { fill: green } rect.inline { fill: green } g.legend rect:active { fill: red }"
+                             " #c { fill: green !important; stroke: red } ]]></style>"
+                             "<g class=\"legend\" stroke=\"blue\"><rect id=\"a\" width=\"10\" height=\"10\" fill=\"black\"/>"
+                             "<rect id=\"b\" class=\"inline\" width=\"10\" height=\"10\" style=\"fill:blue\"/>"
+                             "<rect id=\"c\" width=\"10\" height=\"10\" style=\"fill:blue;stroke:blue\"/></g></svg>"];
+    XCTAssertTrue(renderer.hasCSSAttributes);
+    XCTAssertNotNil([renderer asImageWithSize:CGSizeMake(100, 100) andScale:1.0]);
+    GHRectangle* rectangleA = [renderer objectNamed:@"a"];
+    GHRectangle* rectangleB = [renderer objectNamed:@"b"];
+    XCTAssertEqualObjects([rectangleA valueForStyleAtom:kGHAttributeFill withSVGContext:renderer], @"green", @"The style sheet beats a presentation attribute");
+    XCTAssertEqualObjects([rectangleA valueForStyleAtom:kGHAttributeStroke withSVGContext:renderer], @"purple", @"Inherited from the group's rule, not its attribute");
+    XCTAssertEqualObjects([rectangleB valueForStyleAtom:kGHAttributeFill withSVGContext:renderer], @"blue", @"An inline style beats the style sheet");
+    GHRectangle* rectangleC = [renderer objectNamed:@"c"];
+    XCTAssertEqualObjects([rectangleC valueForStyleAtom:kGHAttributeFill withSVGContext:renderer], @"green", @"!important beats an inline style");
+    XCTAssertEqualObjects([rectangleC valueForStyleAttribute:@"fill" withSVGContext:renderer], @"green");
+    XCTAssertEqualObjects([rectangleC valueForStyleAtom:kGHAttributeStroke withSVGContext:renderer], @"blue", @"Only the !important declaration does");
+    
+    renderer.cssPseudoClass = kPseudoClassActive;
+    XCTAssertNotNil([renderer findRenderableObject:CGPointMake(5, 5)]);
+    XCTAssertEqualObjects([rectangleA valueForStyleAtom:kGHAttributeFill withSVGContext:renderer], @"red", @"Matched again when the pseudo class changes");
+}
+
+-(void) testComputedStyle
+{
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<defs><linearGradient id=\"fade\"><stop offset=\"0\" stop-color=\"red\"/><stop offset=\"1\" stop-color=\"blue\"/></linearGradient></defs>"
+                             "<rect width=\"50\" height=\"50\" fill=\"url(#fade)\" stroke=\"none\"/></svg>"];
+    NSDictionary* attributes = @{@"x":@"10", @"y":@"10", @"width":@"20", @"height":@"20", @"fill":@"#FF0000", @"fill-opacity":@"0.5",
+                                 @"stroke":@"currentColor", @"stroke-dasharray":@"4 2,1", @"fill-rule":@"evenodd", @"style":@"stroke-linejoin:round;stroke-width:3"};
+    GHRectangle* rectangle = [[GHRectangle alloc] initWithAttributes:attributes];
+    GHComputedStyle* computedStyle = [rectangle computedStyleWithSVGContext:renderer];
+    const GHResolvedStyle* style = computedStyle.resolvedStyle;
+    XCTAssertEqual(style->fill.type, kGHPaintColor);
+    CGFloat red = 0, green = 0, blue = 0, alpha = 0;
+    [(UIColor*)style->fill.object getRed:&red green:&green blue:&blue alpha:&alpha];
+    XCTAssertEqualWithAccuracy(red, 1.0, 1e-6);
+    XCTAssertEqualWithAccuracy(alpha, 0.5, 1e-6, @"fill-opacity is applied once, ahead of time");
+    XCTAssertEqual(style->stroke.type, kGHPaintCurrentColor, @"currentColor is looked up as it's drawn");
+    XCTAssertEqual(style->dashCount, 6UL, @"An odd dash array is repeated");
+    XCTAssertEqual(style->dashes[3], 4.0);
+    XCTAssertTrue(style->flags & kGHStyleEvenOddFill);
+    XCTAssertFalse(style->flags & kGHStyleEvenOddClip);
+    XCTAssertTrue((style->flags & kGHStyleHasLineJoin) && style->lineJoin == kCGLineJoinRound);
+    XCTAssertEqual(style->strokeWidth, 3.0);
+    
+    XCTAssertTrue([rectangle computedStyleWithSVGContext:renderer] == computedStyle, @"Resolved once");
+    renderer.cssPseudoClass = kPseudoClassFocused;
+    XCTAssertFalse([rectangle computedStyleWithSVGContext:renderer] == computedStyle, @"A new pseudo class means a new style");
+    
+    GHRectangle* gradientRectangle = [[GHRectangle alloc] initWithAttributes:@{@"width":@"50", @"height":@"50", @"fill":@"url(#fade)", @"stroke":@"none"}];
+    style = [gradientRectangle computedStyleWithSVGContext:renderer].resolvedStyle;
+    XCTAssertEqual(style->fill.type, kGHPaintGradient);
+    XCTAssertTrue([style->fill.object isKindOfClass:[GHGradient class]]);
+    XCTAssertEqual(style->stroke.type, kGHPaintNone);
+    XCTAssertNotNil([renderer asImageWithSize:CGSizeMake(100, 100) andScale:1.0]);
+}
+
+-(void) testStyleSplitting
+{
+    NSDictionary* attributes = @{@"fill":@"red", @"stroke":@"black", @"stop-color":@"blue",
+                                 @"style":@" fill: blue ;stroke-width:3;fill:green; data-extra : 7 ;broken;stop-color:inherit;:orphan"};
+    NSDictionary* table = [GHAttributeTable attributeTableWithDictionary:attributes];
+    for(NSDictionary* aDefinition in @[table, attributes])
+    {// the split table and a plain dictionary agree
+        XCTAssertEqualObjects([aDefinition styleValueForAtom:kGHAttributeFill], @"green", @"The last declaration wins");
+        XCTAssertEqualObjects([aDefinition styleValueForName:@"data-extra"], @"7");
+        XCTAssertNil([aDefinition styleValueForAtom:kGHAttributeStroke]);
+        XCTAssertEqualObjects([SVGToQuartz valueForStyleAtom:kGHAttributeFill fromDefinition:aDefinition], @"green", @"style beats a presentation attribute");
+        XCTAssertEqualObjects([SVGToQuartz valueForStyleAttribute:@"stroke-width" fromDefinition:aDefinition], @"3");
+        XCTAssertEqualObjects([SVGToQuartz valueForStyleAtom:kGHAttributeStroke fromDefinition:aDefinition], @"black");
+        XCTAssertEqualObjects([SVGToQuartz valueForStyleAtom:kGHAttributeStopColor fromDefinition:aDefinition], @"blue", @"An inherited value stands in for 'inherit'");
+    }
+    XCTAssertEqualObjects(table, attributes, @"Splitting the style leaves the dictionary as it was");
+    
+    NSDictionary* shared = [GHShapeGroup attributesSharedWithChildrenOfGroupWithAttributes:[GHAttributeTable attributeTableWithDictionary:@{@"style":@"fill:#00FF00;stroke:none"}]];
+    XCTAssertEqualObjects(shared[@"fill"], @"#00FF00", @"A group's style is inherited by its children");
+    XCTAssertEqualObjects(shared[@"stroke"], @"none");
+}
+
+-(void) testColorTable
+{
+    GHColorTable* sharedTable = [GHColorTable sharedColorTable];
+    UIColor* gray = UIColorFromSVGColorString(@"#333");
+    XCTAssertTrue(gray == UIColorFromSVGColorString(@"rgb(51, 51, 51)"), @"The same RGBA should give the same object");
+    XCTAssertTrue(gray == [sharedTable colorForPackedRGBA:0x333333FF]);
+    XCTAssertTrue(gray.CGColor == [sharedTable CGColorForPackedRGBA:GHPackColorComponents(0.2, 0.2, 0.2, 1.0)]);
+    XCTAssertNil([sharedTable colorForSVGColorString:@"currentColor"]);
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\"/>"];
+    SVGRenderer* otherRenderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"10\"/>"];
+    XCTAssertTrue([renderer colorForSVGColorString:@"coral"] == [otherRenderer colorForSVGColorString:@"CORAL"], @"Renderers share their colors");
+    renderer.currentColor = [UIColor blueColor];
+    XCTAssertEqualObjects([renderer colorForSVGColorString:@"currentColor"], [UIColor blueColor]);
+    
+    GHColorTable* smallTable = [[GHColorTable alloc] initWithCapacity:3];
+    XCTAssertEqual(smallTable.capacity, 4UL);
+    const size_t colorCount = 64;
+    const size_t lookupCount = colorCount*16;
+    uint32_t* found = calloc(lookupCount, sizeof(uint32_t));
+    dispatch_apply(lookupCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        uint32_t packed = (uint32_t)(iteration % colorCount)*0x01020300u | 0xFF;
+        CGFloat red = 0, green = 0, blue = 0, alpha = 0;
+        [[smallTable colorForPackedRGBA:packed] getRed:&red green:&green blue:&blue alpha:&alpha];
+        found[iteration] = GHPackColorComponents(red, green, blue, alpha);
+    });
+    for(size_t iteration = 0; iteration < lookupCount; iteration++)
+    {
+        XCTAssertEqual(found[iteration], (uint32_t)(iteration % colorCount)*0x01020300u | 0xFF, @"A full table should still hand out the right colors");
+    }
+    free(found);
+    XCTAssertEqual(smallTable.count, 4UL);
+}
+
+-(void) testColorParsing
+{
+    SVGColorRGBA color;
+    const char* hex = " #FF77C080 ";
+    XCTAssertEqual(SVGParseColor(hex, strlen(hex), &color), kSVGColorParseRGBA);
+    XCTAssertEqualWithAccuracy(color.green, 0x77/255.0, 1e-6);
+    XCTAssertEqualWithAccuracy(color.alpha, 0x80/255.0, 1e-6);
+    
+    const char* shortHex = "#A7A";
+    XCTAssertEqual(SVGParseColor(shortHex, strlen(shortHex), &color), kSVGColorParseRGBA);
+    XCTAssertEqualWithAccuracy(color.red, 0xAA/255.0, 1e-6);
+    XCTAssertEqualWithAccuracy(color.green, 0x77/255.0, 1e-6);
+    
+    const char* percentages = "RGBA(0, 100%, 50%, 0.25)";
+    XCTAssertEqual(SVGParseColor(percentages, strlen(percentages), &color), kSVGColorParseRGBA);
+    XCTAssertEqualWithAccuracy(color.green, 1.0, 1e-6);
+    XCTAssertEqualWithAccuracy(color.blue, 0.5, 1e-6);
+    XCTAssertEqualWithAccuracy(color.alpha, 0.25, 1e-6);
+    
+    const char* spaced = "rgb(0 255 127 / 50%)";
+    XCTAssertEqual(SVGParseColor(spaced, strlen(spaced), &color), kSVGColorParseRGBA);
+    XCTAssertEqualWithAccuracy(color.blue, 127/255.0, 1e-6);
+    XCTAssertEqualWithAccuracy(color.alpha, 0.5, 1e-6);
+    
+    XCTAssertEqual(SVGParseColor("Transparent", 11, &color), kSVGColorParseNone);
+    XCTAssertEqual(SVGParseColor("currentColor", 12, &color), kSVGColorParseInvalid);
+    
+    uint32_t rgb = 0;
+    XCTAssertTrue(SVGLookupNamedColor("LightGoldenrodYellow", 20, &rgb));
+    XCTAssertEqual(rgb, 0xfafad2u);
+    XCTAssertTrue(SVGLookupNamedColor("ThreeDFace", 10, &rgb));
+    XCTAssertEqual(rgb, 0xaaaaaau);
+    XCTAssertFalse(SVGLookupNamedColor("redd", 4, &rgb));
+    XCTAssertFalse(SVGLookupNamedColor("re", 2, &rgb));
+    
+    CGFloat red = 0, green = 0, blue = 0, alpha = 0;
+    [UIColorFromSVGColorString(@"rgba(255,0,0,0.5)") getRed:&red green:&green blue:&blue alpha:&alpha];
+    XCTAssertEqualWithAccuracy(red, 1.0, 1e-6);
+    XCTAssertEqualWithAccuracy(alpha, 0.5, 0.5/255.0, @"Shared colors are kept to 8 bits a channel");
+    XCTAssertEqualObjects(UIColorFromSVGColorString(@"none"), [UIColor clearColor]);
+}
+
+-(void) testGlyphPlacementSweep
+{
+    CGMutablePathRef wave = CGPathCreateMutable();
+    CGPathMoveToPoint(wave, NULL, 0, 0);
+    CGPathAddCurveToPoint(wave, NULL, 50, 100, 100, -100, 150, 0);
+    CGPathMoveToPoint(wave, NULL, 200, 0);
+    CGPathAddQuadCurveToPoint(wave, NULL, 250, 50, 300, 0);
+    GHPathMeasure* measure = [[GHPathMeasure alloc] initWithCGPath:wave tolerance:0.0];
+    CGPathRelease(wave);
+    
+    const NSUInteger count = 100;
+    CGFloat distances[count];
+    for(NSUInteger index = 0; index < count; index++)
+    {// mostly increasing, as glyph midpoints are, with the odd step back and a few off the ends
+        distances[index] = (index % 10 == 9) ? measure.length*0.25 : (CGFloat)index*measure.length*1.1/count-5.0;
+    }
+    CGPoint points[count], tangents[count];
+    BOOL onPath[count];
+    NSUInteger placed = [measure getPoints:points tangents:tangents onPath:onPath atDistances:distances count:count];
+    NSUInteger expectedPlaced = 0;
+    for(NSUInteger index = 0; index < count; index++)
+    {
+        CGPoint point, tangent;
+        BOOL expectedOnPath = [measure getPoint:&point tangent:&tangent atDistance:distances[index]];
+        XCTAssertEqual(onPath[index], expectedOnPath);
+        XCTAssertTrue(CGPointEqualToPoint(points[index], point) && CGPointEqualToPoint(tangents[index], tangent), @"Sweep and search disagree at %lu", (unsigned long)index);
+        expectedPlaced += expectedOnPath;
+    }
+    XCTAssertEqual(placed, expectedPlaced);
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"300\" height=\"100\">"
+                             "<defs><path id=\"curve\" d=\"M10 80 Q150 0 290 80\"/></defs>"
+                             "<text font-size=\"20\"><textPath xlink:href=\"#curve\">Text along a curve, laid out once</textPath></text></svg>"];
+    XCTAssertNotNil([renderer asImageWithSize:CGSizeMake(300, 100) andScale:1.0]);
+    XCTAssertNotNil([renderer asImageWithSize:CGSizeMake(300, 100) andScale:1.0], @"A second render reuses the placed glyphs");
+    
+    GHPath* curve = [[GHPath alloc] initWithDictionary:@{kElementName:@"path", kAttributesElementName:@{@"d":@"M10 80 Q150 0 290 80"}}];
+    XCTAssertNotNil(curve.pathMeasure);
+    XCTAssertEqual(curve.pathMeasure, curve.pathMeasure, @"The shape keeps its measure");
+    XCTAssertEqualWithAccuracy(curve.pathMeasure.length, [GHPathUtilities totalLengthOfCGPath:curve.quartzPath], 1e-9);
+}
+
+-(void) testPathMeasure
+{
+    CGMutablePathRef circle = CGPathCreateMutable();
+    CGPathAddEllipseInRect(circle, NULL, CGRectMake(-100, -100, 200, 200));
+    GHPathMeasure* measure = [GHPathMeasure pathMeasureForCGPath:circle];
+    XCTAssertEqualWithAccuracy(measure.length, 2.0*M_PI*100.0, 0.5);
+    XCTAssertEqualWithAccuracy([GHPathMeasure pathMeasureForCGPath:circle].length, measure.length, 1e-9);
+    XCTAssertEqualWithAccuracy([GHPathUtilities totalLengthOfCGPath:circle], measure.length, 1e-9);
+    
+    for(NSUInteger step = 0; step <= 64; step++)
+    {
+        CGPoint point, tangent;
+        XCTAssertTrue([measure getPoint:&point tangent:&tangent atDistance:measure.length*step/64.0]);
+        XCTAssertEqualWithAccuracy(hypot(point.x, point.y), 100.0, 0.1);
+        XCTAssertEqualWithAccuracy(point.x*tangent.x+point.y*tangent.y, 0.0, 2.0, @"Tangent to the circle");
+    }
+    CGPathRelease(circle);
+    
+    CGMutablePathRef twoLines = CGPathCreateMutable();
+    CGPathMoveToPoint(twoLines, NULL, 0, 0);
+    CGPathAddLineToPoint(twoLines, NULL, 10, 0);
+    CGPathMoveToPoint(twoLines, NULL, 20, 0);
+    CGPathAddLineToPoint(twoLines, NULL, 20, 10);
+    XCTAssertEqualWithAccuracy([GHPathUtilities totalLengthOfCGPath:twoLines], 20.0, 1e-9, @"The jump doesn't count");
+    [GHPathUtilities findPointAndVectorAtDistance:15 intoPath:twoLines intoCallback:^(CGPoint point, CGPoint vector) {
+        XCTAssertTrue(CGPointEqualToPoint(point, CGPointMake(20, 5)));
+        XCTAssertTrue(CGPointEqualToPoint(vector, CGPointMake(-1, 0)));
+    }];
+    [GHPathUtilities findPointAndVectorAtDistance:25 intoPath:twoLines intoCallback:^(CGPoint point, CGPoint vector) {
+        XCTAssertTrue(CGPointEqualToPoint(point, CGPointZero), @"Off the end");
+    }];
+    CGPathAddLineToPoint(twoLines, NULL, 30, 10);
+    XCTAssertEqualWithAccuracy([GHPathUtilities totalLengthOfCGPath:twoLines], 30.0, 1e-9, @"A changed path is measured again");
+    CGPathRelease(twoLines);
+}
+
+-(void) testPathWriter
+{
+    char number[32];
+    XCTAssertEqual(strncmp(number, ".5", SVGPathWriterFormatNumber(0.5, -1, 1, number)), 0);
+    XCTAssertEqual(strncmp(number, "-0.1", SVGPathWriterFormatNumber(-0.1f, -1, 0, number)), 0);
+    XCTAssertEqual(strncmp(number, "3.14", SVGPathWriterFormatNumber(3.14159, 2, 1, number)), 0);
+    XCTAssertEqual(strncmp(number, "12", SVGPathWriterFormatNumber(12.0004, 3, 1, number)), 0);
+    
+    CGPathRef aPath = [SVGPathGenerator newCGPathFromSVGPath:@"M10 20 L30 20 L30 80.25 C40 90 50 90 60 80.25 S80 70 90 80.25 Q100 90 110 80.25 T130 80.25 Z M0.5 0.5 l0.25 0.25"
+                                      whileApplyingTransform:CGAffineTransformIdentity];
+    NSString* minified = [SVGPathGenerator svgPathFromCGPath:aPath precision:-1 minify:YES];
+    XCTAssertEqualObjects(minified, @"M10 20H30V80.25C40 90 50 90 60 80.25s20-10.25 30 0q10 9.75 20 0t20 0zM.5.5.75.75");
+    NSString* verbose = [SVGPathGenerator svgPathFromCGPath:aPath precision:-1 minify:NO];
+    XCTAssertTrue(verbose.length > minified.length);
+    for(NSString* written in @[minified, verbose])
+    {
+        CGPathRef readBack = [SVGPathGenerator newCGPathFromSVGPath:written whileApplyingTransform:CGAffineTransformIdentity];
+        XCTAssertTrue(CGPathEqualToPath(aPath, readBack), @"%@ should read back as the same path", written);
+        CGPathRelease(readBack);
+    }
+    CGPathRelease(aPath);
+    
+    aPath = [SVGPathGenerator newCGPathFromSVGPath:@"M10 20 L30 20 L30 80.5 Z" whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertEqualObjects([SVGPathGenerator svgPathFromCGPath:aPath], @"M10.0 20.0H30.0V80.5Z", @"The plain call keeps its original format");
+    CGPathRelease(aPath);
+    
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    SVGPathBufferMoveTo(&pathBuffer, 1.0/3.0, 2.0/3.0);
+    SVGPathBufferLineTo(&pathBuffer, 100.0/3.0, 200.0/3.0);
+    SVGPathWriterOptions options = {2, 1};
+    size_t length = 0;
+    char* pathString = SVGPathBufferCopySVGPath(&pathBuffer, &options, &length);
+    XCTAssertEqual(strcmp(pathString, "M.33.67l33 66"), 0, @"Relative and rounded is shorter, and still within the precision");
+    XCTAssertEqual(length, strlen(pathString));
+    free(pathString);
+    SVGPathBufferFree(&pathBuffer);
+}
+
+-(void) testConcurrentPathParsing
+{
+    NSMutableArray<NSString*>* svgPaths = [[NSMutableArray alloc] init];
+    NSMutableArray<NSValue*>* transforms = [[NSMutableArray alloc] init];
+    for(NSUInteger index = 0; index < 1000; index++)
+    {
+        [svgPaths addObject:[NSString stringWithFormat:@"M%lu 0 L10 %lu q5 5 10 0 a5 5 0 0 1 10 10z", (unsigned long)index, (unsigned long)(index % 17)]];
+        CGAffineTransform aTransform = CGAffineTransformMakeScale(1.0+index % 3, 1.0);
+        [transforms addObject:[NSValue valueWithBytes:&aTransform objCType:@encode(CGAffineTransform)]];
+    }
+    [svgPaths addObject:@""];
+    CGAffineTransform identity = CGAffineTransformIdentity;
+    [transforms addObject:[NSValue valueWithBytes:&identity objCType:@encode(CGAffineTransform)]];
+    
+    NSArray* quartzPaths = [SVGPathGenerator newCGPathsFromSVGPaths:svgPaths whileApplyingTransforms:transforms];
+    XCTAssertEqual(quartzPaths.count, svgPaths.count);
+    for(NSUInteger index = 0; index < svgPaths.count; index++)
+    {
+        CGAffineTransform aTransform;
+        [transforms[index] getValue:&aTransform];
+        CGPathRef serialPath = [SVGPathGenerator newCGPathFromSVGPath:svgPaths[index] whileApplyingTransform:aTransform];
+        XCTAssertTrue(CGPathEqualToPath(serialPath, (__bridge CGPathRef)quartzPaths[index]), @"Path %lu differs", (unsigned long)index);
+        CGPathRelease(serialPath);
+    }
+    XCTAssertEqual([SVGPathGenerator newCGPathsFromSVGPaths:svgPaths whileApplyingTransforms:nil].count, svgPaths.count);
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:@"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                             "<g><path d=\"M0 0L10 10\"/><polygon points=\"0,0 10,0 10,10\"/></g><rect width=\"5\" height=\"5\"/></svg>"];
+    [renderer preparePathsConcurrently];
+    GHShape* firstShape = ((GHShapeGroup*)renderer.rootObject.children.firstObject).children.firstObject;
+    XCTAssertTrue(CGRectEqualToRect(firstShape.pathBoundingBox, CGRectMake(0, 0, 10, 10)));
+}
+
+-(void) testTightBoundingBox
+{
+    NSString* curve = @"M0 0 C100 100 -50 100 50 0";
+    CGRect tightBox = [SVGPathGenerator tightBoundingBoxForSVGPath:curve whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertEqualWithAccuracy(tightBox.origin.x, 0.0, 1e-9);
+    XCTAssertEqualWithAccuracy(tightBox.origin.y, 0.0, 1e-9);
+    XCTAssertEqualWithAccuracy(tightBox.size.width, 50.0, 1e-9);
+    XCTAssertEqualWithAccuracy(tightBox.size.height, 75.0, 1e-9, @"The peak of the curve, not its control points");
+    CGRect looseBox = [SVGPathGenerator maxBoundingBoxForSVGPath:curve];
+    XCTAssertTrue(CGRectContainsRect(looseBox, tightBox));
+    
+    NSString* arc = @"M50 50 A40 20 30 1 1 120 80 z";
+    CGAffineTransform rotation = CGAffineTransformMakeRotation(0.5);
+    CGPathRef arcPath = [SVGPathGenerator newCGPathFromSVGPath:arc whileApplyingTransform:rotation];
+    CGRect quartzBox = CGPathGetPathBoundingBox(arcPath);
+    CGRect analyticBox = [SVGPathGenerator tightBoundingBoxForSVGPath:arc whileApplyingTransform:rotation];
+    CGRect walkedBox = SVGPathBoundsOfCGPath(arcPath, NULL);
+    XCTAssertEqualWithAccuracy(quartzBox.origin.x, analyticBox.origin.x, 1e-3);
+    XCTAssertEqualWithAccuracy(quartzBox.origin.y, analyticBox.origin.y, 1e-3);
+    XCTAssertEqualWithAccuracy(quartzBox.size.width, analyticBox.size.width, 1e-3);
+    XCTAssertEqualWithAccuracy(quartzBox.size.height, analyticBox.size.height, 1e-3);
+    XCTAssertEqualWithAccuracy(analyticBox.origin.x, walkedBox.origin.x, 1e-4);
+    XCTAssertEqualWithAccuracy(analyticBox.size.height, walkedBox.size.height, 1e-4);
+    CGPathRelease(arcPath);
+    
+    XCTAssertTrue(CGRectIsNull([SVGPathGenerator tightBoundingBoxForSVGPath:@"" whileApplyingTransform:CGAffineTransformIdentity]));
+}
+
+-(void) testPathCache
+{
+    GHPathCache* pathCache = [[GHPathCache alloc] initWithByteLimit:1024*1024];
+    NSString* dAttribute = @"M10 10 L20 20 Q30 10 40 20 Z";
+    CGPathRef firstPath = [pathCache newPathFromSVGPath:dAttribute whileApplyingTransform:CGAffineTransformIdentity];
+    CGPathRef secondPath = [pathCache newPathFromSVGPath:[dAttribute mutableCopy] whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertTrue(firstPath == secondPath, @"An identical path should come from the cache");
+    XCTAssertEqual(pathCache.hitCount, 1u);
+    XCTAssertEqual(pathCache.missCount, 1u);
+    
+    CGPathRef uncachedPath = [SVGPathGenerator newCGPathFromSVGPath:dAttribute whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertTrue(CGPathEqualToPath(firstPath, uncachedPath));
+    CGPathRelease(uncachedPath);
+    
+    CGPathRef translatedPath = [pathCache newPathFromSVGPath:dAttribute whileApplyingTransform:CGAffineTransformMakeTranslation(5, 5)];
+    XCTAssertTrue(translatedPath != firstPath, @"The transform is part of the key");
+    XCTAssertEqual(CGPathGetBoundingBox(translatedPath).origin.x, 15.0);
+    
+    CGPathRef polylinePath = [pathCache newPathFromSVGPoints:@"10 10 20 20" closed:NO whileApplyingTransform:CGAffineTransformIdentity];
+    CGPathRef polygonPath = [pathCache newPathFromSVGPoints:@"10 10 20 20" closed:YES whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertTrue(polylinePath != polygonPath, @"A polygon isn't the same shape as a polyline with the same points");
+    XCTAssertEqual(pathCache.missCount, 4u);
+    
+    [pathCache removeAllPaths];
+    [pathCache resetStatistics];
+    CGPathRef reparsedPath = [pathCache newPathFromSVGPath:dAttribute whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertEqual(pathCache.hitCount, 0u);
+    XCTAssertEqual(pathCache.missCount, 1u);
+    
+    CGPathRelease(firstPath);
+    CGPathRelease(secondPath);
+    CGPathRelease(translatedPath);
+    CGPathRelease(polylinePath);
+    CGPathRelease(polygonPath);
+    CGPathRelease(reparsedPath);
+}
+
+-(void) testNumberScanner
+{
+    const char* numbers[] = {"12", "-.5", "+3.25e2", "0.1", "1e-7", "123456789.123456789", "98765432109876543210", "1.7976931348623157e308", "4e-320"};
+    for(size_t index = 0; index < sizeof(numbers)/sizeof(numbers[0]); index++)
+    {
+        const char* aNumber = numbers[index];
+        double value = 0.0;
+        const char* numberEnd = SVGScanNumber(aNumber, aNumber+strlen(aNumber), &value);
+        XCTAssertTrue(numberEnd == aNumber+strlen(aNumber), @"Should have consumed all of %s", aNumber);
+        XCTAssertEqual(value, strtod(aNumber, NULL), @"%s should convert exactly as strtod would", aNumber);
+    }
+    
+    double value = 0.0;
+    const char* notNumbers[] = {"-", ".", "e5", "x1"};
+    for(size_t index = 0; index < sizeof(notNumbers)/sizeof(notNumbers[0]); index++)
+    {
+        XCTAssertTrue(SVGScanNumber(notNumbers[index], notNumbers[index]+strlen(notNumbers[index]), &value) == NULL);
+    }
+    const char* withUnit = "1em";
+    XCTAssertTrue(SVGScanNumber(withUnit, withUnit+3, &value) == withUnit+1, @"An e without digits isn't an exponent");
+    
+    const char* aRun = " 10,20 30 ,40-50.5.5z";
+    const char* cursor = aRun;
+    double values[8];
+    XCTAssertEqual(SVGScanNumbers(&cursor, aRun+strlen(aRun), values, 8), 6u);
+    XCTAssertEqual(*cursor, 'z');
+    XCTAssertEqual(values[4], -50.5);
+    XCTAssertEqual(values[5], 0.5);
+    
+    XCTAssertTrue(CGRectEqualToRect(SVGStringToRect(@"0 -10.5,200 1e2"), CGRectMake(0, -10.5, 200, 100)));
+    XCTAssertTrue(CGRectEqualToRect(SVGStringToRect(@"0 0 100"), CGRectZero), @"A viewBox needs 4 numbers");
+    
+    CGAffineTransform expectedTransform = CGAffineTransformScale(CGAffineTransformMakeTranslation(10, -20), 2, 0.5);
+    XCTAssertTrue(CGAffineTransformEqualToTransform(SVGTransformToCGAffineTransform(@"translate(10,-20) scale( 2 .5 )"), expectedTransform));
+    XCTAssertTrue(CGAffineTransformIsIdentity(SVGTransformToCGAffineTransform(@"translate(10 20 30)")), @"Too many parameters");
+    
+    const char* points = "0,0 10,0 10 10";
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    XCTAssertTrue(SVGPathBufferAppendSVGPoints(&pathBuffer, points, strlen(points), 1));
+    const uint8_t expectedVerbs[] = {kSVGPathVerbMove, kSVGPathVerbLine, kSVGPathVerbLine, kSVGPathVerbClose};
+    XCTAssertEqual(pathBuffer.verbCount, sizeof(expectedVerbs));
+    XCTAssertEqual(memcmp(pathBuffer.verbs, expectedVerbs, sizeof(expectedVerbs)), 0);
+    SVGPathBufferReset(&pathBuffer);
+    const char* oddPoints = "0,0 10,0 10";
+    XCTAssertFalse(SVGPathBufferAppendSVGPoints(&pathBuffer, oddPoints, strlen(oddPoints), 0));
+    XCTAssertEqual(pathBuffer.verbCount, 2u, @"The complete pairs should be kept");
+    SVGPathBufferFree(&pathBuffer);
+}
+
+-(void) testPathBuffer
+{
+    const char* pathString = "m10,10 l5 5 h10 v-10 z c1 1 2 2 3 3 s4 4 5 5 A5 5 0 1 1 40 40";
+    SVGPathBuffer pathBuffer;
+    SVGPathBufferInit(&pathBuffer);
+    XCTAssertTrue(SVGPathBufferAppendSVGPath(&pathBuffer, pathString, strlen(pathString)));
+    
+    const uint8_t expectedVerbs[] = {kSVGPathVerbMove, kSVGPathVerbLine, kSVGPathVerbLine, kSVGPathVerbLine, kSVGPathVerbClose,
+        kSVGPathVerbMove, kSVGPathVerbCubic, kSVGPathVerbCubic, kSVGPathVerbLine};
+    XCTAssertTrue(pathBuffer.verbCount > sizeof(expectedVerbs), @"Arc should have been expanded into cubics");
+    XCTAssertEqual(memcmp(pathBuffer.verbs, expectedVerbs, sizeof(expectedVerbs)), 0);
+    for(size_t index = sizeof(expectedVerbs); index < pathBuffer.verbCount; index++)
+    {
+        XCTAssertEqual(pathBuffer.verbs[index], kSVGPathVerbCubic, @"Arcs should only produce cubics");
+    }
+    const float expectedStart[] = {10, 10, 15, 15, 25, 15, 25, 5, 10, 10, 11, 11, 12, 12, 13, 13};
+    XCTAssertEqual(memcmp(pathBuffer.coordinates, expectedStart, sizeof(expectedStart)), 0, @"Relative coordinates should be resolved");
+    XCTAssertEqualWithAccuracy(pathBuffer.coordinates[pathBuffer.coordinateCount-2], 40.0f, 0.01);
+    XCTAssertEqualWithAccuracy(pathBuffer.coordinates[pathBuffer.coordinateCount-1], 40.0f, 0.01);
+    
+    CGPathRef quartzPath = SVGPathBufferCreateCGPath(&pathBuffer, NULL);
+    CGPathRef generatedPath = [SVGPathGenerator newCGPathFromSVGPath:@(pathString) whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertTrue(CGPathEqualToPath(quartzPath, generatedPath));
+    CGPathRelease(quartzPath);
+    CGPathRelease(generatedPath);
+    
+    SVGPathBufferReset(&pathBuffer);
+    const char* brokenString = "M0 0 L10 10 L20 x";
+    XCTAssertFalse(SVGPathBufferAppendSVGPath(&pathBuffer, brokenString, strlen(brokenString)));
+    XCTAssertEqual(pathBuffer.verbCount, 2u, @"What came before the error should be kept");
+    SVGPathBufferFree(&pathBuffer);
+}
+
+-(void) testBinaryDocumentRoundTrip
+{
+    NSString* testDocument = @"<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 100 100\">"
+    "<g fill=\"green\" transform=\"translate(10,20) scale(2)\"><path d=\"M0 0L10 10Q20 0 30 10z\"/><polygon points=\"0,0 10,0 10,10\"/></g>"
+    "<text x=\"5\" y=\"50\">Hello <tspan fill=\"red\">World</tspan></text></svg>";
+    
+    SVGParser* parser = [[SVGParser alloc] initWithString:testDocument];
+    NSData* binaryData = [SVGBinaryDocument binaryDataFromParser:parser];
+    XCTAssertNotNil(binaryData, @"Expected a precompiled document");
+    XCTAssertTrue([SVGBinaryDocument isBinaryDocumentData:binaryData]);
+    
+    SVGRenderer* fromBinary = [[SVGRenderer alloc] initWithBinaryData:binaryData];
+    XCTAssertNil(fromBinary.parserError);
+    GHShapeGroup* fromDictionary = [[GHShapeGroup alloc] initWithDictionary:parser.root];
+    XCTAssertEqualObjects(fromBinary.rootObject, fromDictionary, @"Precompiled document should give the same tree");
+    
+    GHShapeGroup* group = fromBinary.rootObject.children.firstObject;
+    XCTAssertTrue(CGAffineTransformEqualToTransform(group.transform, SVGTransformToCGAffineTransform(@"translate(10,20) scale(2)")));
+    GHPath* path = group.children.firstObject;
+    CGPathRef expectedPath = [SVGPathGenerator newCGPathFromSVGPath:@"M0 0L10 10Q20 0 30 10z" whileApplyingTransform:CGAffineTransformIdentity];
+    XCTAssertTrue(CGPathEqualToPath(path.quartzPath, expectedPath), @"Path should have been loaded already parsed");
+    CGPathRelease(expectedPath);
+    
+    SVGRenderer* renderer = [[SVGRenderer alloc] initWithString:testDocument];
+    NSData* rendererData = [SVGBinaryDocument binaryDataFromParser:renderer];
+    XCTAssertNotNil(rendererData, @"A renderer should precompile from its retained source");
+    SVGRenderer* fromRendererData = [[SVGRenderer alloc] initWithBinaryData:rendererData];
+    XCTAssertNil(fromRendererData.parserError);
+    XCTAssertEqualObjects(fromRendererData.rootObject, renderer.rootObject, @"Precompiled renderer should give the same tree");
+    XCTAssertNil([SVGBinaryDocument binaryDataFromParser:fromBinary], @"Documents loaded from binary only keep the svg element's attributes in root");
+    
+    NSMutableData* truncated = [[binaryData subdataWithRange:NSMakeRange(0, binaryData.length/2)] mutableCopy];
+    SVGRenderer* broken = [[SVGRenderer alloc] initWithBinaryData:truncated];
+    XCTAssertNotNil(broken.parserError, @"Truncated documents should be rejected");
+}
+
 @end